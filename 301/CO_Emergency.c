@@ -279,19 +279,31 @@ static void
 CO_EM_receive(void* object, void* msg) {
     CO_EM_t* em = (CO_EM_t*)object;
 
-    if ((em != NULL) && (em->pFunctSignalRx != NULL)) {
-        uint16_t ident = CO_CANrxMsg_readIdent(msg);
-
-        /* ignore sync messages (necessary if sync object is not used) */
-        if (ident != 0x80U) {
-            const uint8_t* data = CO_CANrxMsg_readData(msg);
-            uint16_t errorCode;
-            uint32_t infoCode;
-
-            (void)memcpy((void*)(&errorCode), (const void*)(&data[0]), sizeof(errorCode));
-            (void)memcpy((void*)(&infoCode), (const void*)(&data[4]), sizeof(infoCode));
-            em->pFunctSignalRx(ident, CO_SWAP_16(errorCode), data[2], data[3], CO_SWAP_32(infoCode));
-        }
+    if (em == NULL) {
+        return;
+    }
+    uint16_t ident = CO_CANrxMsg_readIdent(msg);
+
+    /* ignore sync messages (necessary if sync object is not used) */
+    if (ident == 0x80U) {
+        return;
+    }
+    const uint8_t* data = CO_CANrxMsg_readData(msg);
+
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+    CO_netState_rxEMCY(em->netState, (uint8_t)(ident & 0x7FU), data[2]);
+#endif
+    uint16_t errorCode;
+    uint32_t infoCode;
+
+    (void)memcpy((void*)(&errorCode), (const void*)(&data[0]), sizeof(errorCode));
+    (void)memcpy((void*)(&infoCode), (const void*)(&data[4]), sizeof(infoCode));
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+    (void)CO_EMcons_push(em->EMcons, (uint8_t)(ident & 0x7FU), CO_SWAP_16(errorCode), data[2], data[3],
+                         CO_SWAP_32(infoCode));
+#endif
+    if (em->pFunctSignalRx != NULL) {
+        em->pFunctSignalRx(ident, CO_SWAP_16(errorCode), data[2], data[3], CO_SWAP_32(infoCode));
     }
 }
 #endif
@@ -473,6 +485,24 @@ CO_EM_initCallbackRx(CO_EM_t* em,
 }
 #endif
 
+#if (((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0) && (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0)
+void
+CO_EM_setNetState(CO_EM_t* em, CO_netState_t* netState) {
+    if (em != NULL) {
+        em->netState = netState;
+    }
+}
+#endif
+
+#if (((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0) && (((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0)
+void
+CO_EM_setEMcons(CO_EM_t* em, CO_EMcons_t* EMcons) {
+    if (em != NULL) {
+        em->EMcons = EMcons;
+    }
+}
+#endif
+
 #if ((CO_CONFIG_EM)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
 void
 CO_EM_initCallbackPre(CO_EM_t* em, void* object, void (*pFunctSignal)(void* object)) {
@@ -583,6 +613,10 @@ CO_EM_process(CO_EM_t* em, bool_t NMTisPreOrOperational, uint32_t timeDifference
 
 #if ((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0
             /* report also own emergency messages */
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+            (void)CO_EMcons_push(em->EMcons, 0, CO_SWAP_16((uint16_t)em->fifo[fifoPpPtr].msg), errorRegister,
+                                 (uint8_t)(em->fifo[fifoPpPtr].msg >> 24), CO_SWAP_32(em->fifo[fifoPpPtr].info));
+#endif
             if (em->pFunctSignalRx != NULL) {
                 uint32_t errMsg = em->fifo[fifoPpPtr].msg;
                 em->pFunctSignalRx(0, CO_SWAP_16((uint16_t)errMsg), errorRegister, (uint8_t)(errMsg >> 24),
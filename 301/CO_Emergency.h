@@ -23,6 +23,8 @@
 
 #include "301/CO_driver.h"
 #include "301/CO_ODinterface.h"
+#include "extra/CO_netState.h"
+#include "extra/CO_EMcons.h"
 
 /* default configuration, see CO_config.h */
 #ifndef CO_CONFIG_EM
@@ -307,6 +309,16 @@ typedef struct {
                            const uint8_t errorBit, const uint32_t infoCode); /**< From CO_EM_initCallbackRx() or NULL */
 #endif
 
+#if ((((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0) && (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0))      \
+    || defined CO_DOXYGEN
+    CO_netState_t* netState; /**< From CO_EM_setNetState() or NULL */
+#endif
+
+#if ((((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0) && (((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0))          \
+    || defined CO_DOXYGEN
+    CO_EMcons_t* EMcons; /**< From CO_EM_setEMcons() or NULL */
+#endif
+
 #if (((CO_CONFIG_EM)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0) || defined CO_DOXYGEN
     void (*pFunctSignalPre)(void* object); /**< From CO_EM_initCallbackPre() or NULL */
     void* functSignalObjectPre;            /**< From CO_EM_initCallbackPre() or NULL */
@@ -398,6 +410,33 @@ void CO_EM_initCallbackRx(CO_EM_t* em, void (*pFunctSignalRx)(const uint16_t ide
                                                               const uint32_t infoCode));
 #endif
 
+#if ((((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0) && (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0))      \
+    || defined CO_DOXYGEN
+/**
+ * Attach network state table, see @ref CO_netState.
+ *
+ * Error register from each received emergency message is reported to the table.
+ *
+ * @param em This object.
+ * @param netState Initialized network state or NULL to detach.
+ */
+void CO_EM_setNetState(CO_EM_t* em, CO_netState_t* netState);
+#endif
+
+#if ((((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0) && (((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0))          \
+    || defined CO_DOXYGEN
+/**
+ * Attach Emergency consumer, see @ref CO_EMcons.
+ *
+ * Received emergency messages and own emergency messages (with node-id 0) are pushed into its queue. Callback from
+ * CO_EM_initCallbackRx() is still called from the receive path, if set.
+ *
+ * @param em This object.
+ * @param EMcons Initialized Emergency consumer or NULL to detach.
+ */
+void CO_EM_setEMcons(CO_EM_t* em, CO_EMcons_t* EMcons);
+#endif
+
 /**
  * Process Error control and Emergency object.
  *
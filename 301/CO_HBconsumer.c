@@ -44,6 +44,12 @@ CO_HBcons_receive(void* object, void* msg) {
         /* copy data and set 'new message' flag. */
         HBconsNode->NMTstate = (CO_NMT_internalState_t)data[0];
         CO_FLAG_SET(HBconsNode->CANrxNew);
+#if CO_NODE_TIMERS > 0
+        CO_nodeTimers_event(HBconsNode->timers, HBconsNode->idx);
+#endif
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+        CO_netState_rxNMT(HBconsNode->netState, HBconsNode->nodeId, data[0]);
+#endif
 #if ((CO_CONFIG_HB_CONS)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
         /* Optional signal to RTOS, which can resume task, which handles HBcons. */
         if (HBconsNode->pFunctSignalPre != NULL) {
@@ -53,6 +59,61 @@ CO_HBcons_receive(void* object, void* msg) {
     }
 }
 
+#if (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_CHANGE) != 0)                                                     \
+    || (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_MULTI) != 0)
+/* Verify, if NMT state of monitored node changed and signal it */
+static void
+CO_HBcons_verifyNmtChanged(CO_HBconsumer_t* HBcons, CO_HBconsNode_t* monitoredNode, uint8_t idx) {
+    if (monitoredNode->NMTstate != monitoredNode->NMTstatePrev) {
+#if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_CHANGE) != 0
+        if (HBcons->pFunctSignalNmtChanged != NULL) {
+            HBcons->pFunctSignalNmtChanged(monitoredNode->nodeId, idx, monitoredNode->NMTstate,
+                                           HBcons->pFunctSignalObjectNmtChanged);
+#else
+        (void)HBcons;
+        if (monitoredNode->pFunctSignalNmtChanged != NULL) {
+            monitoredNode->pFunctSignalNmtChanged(monitoredNode->nodeId, idx, monitoredNode->NMTstate,
+                                                  monitoredNode->pFunctSignalObjectNmtChanged);
+#endif
+        }
+        monitoredNode->NMTstatePrev = monitoredNode->NMTstate;
+    }
+}
+#endif
+
+#if CO_NODE_TIMERS > 0
+/*
+ * Add the node to (or remove it from) the counts of configured, active and operational nodes
+ *
+ * Call it with add=false before HBstate or NMTstate of the node is changed by CO_HBconsumer_process() or by
+ * CO_HBconsumer_initEntry() and with add=true after that.
+ */
+static void
+CO_HBcons_count(CO_HBconsumer_t* HBcons, CO_HBconsNode_t* monitoredNode, bool_t add) {
+    if (monitoredNode->HBstate == CO_HBconsumer_UNCONFIGURED) {
+        return;
+    }
+    if (add) {
+        monitoredNode->operationalCounted = monitoredNode->NMTstate == CO_NMT_OPERATIONAL;
+        HBcons->configuredCount++;
+        if (monitoredNode->HBstate == CO_HBconsumer_ACTIVE) {
+            HBcons->activeCount++;
+        }
+        if (monitoredNode->operationalCounted) {
+            HBcons->operationalCount++;
+        }
+    } else {
+        HBcons->configuredCount--;
+        if (monitoredNode->HBstate == CO_HBconsumer_ACTIVE) {
+            HBcons->activeCount--;
+        }
+        if (monitoredNode->operationalCounted) {
+            HBcons->operationalCount--;
+        }
+    }
+}
+#endif
+
 /*
  * Initialize one Heartbeat consumer entry
  *
@@ -124,6 +185,18 @@ CO_HBconsumer_init(CO_HBconsumer_t* HBcons, CO_EM_t* em, CO_HBconsNode_t* monito
                                          ? (OD_1016_HBcons->subEntriesCount - 1U)
                                          : monitoredNodesCount;
 
+#if CO_NODE_TIMERS > 0
+    if (HBcons->numberOfMonitoredNodes > CO_NODE_TIMERS_SIZE) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    CO_nodeTimers_init(&HBcons->timers);
+    for (uint8_t i = 0; i < HBcons->numberOfMonitoredNodes; i++) {
+        HBcons->monitoredNodes[i].timers = &HBcons->timers;
+        HBcons->monitoredNodes[i].idx = i;
+        HBcons->monitoredNodes[i].HBstate = CO_HBconsumer_UNCONFIGURED;
+    }
+#endif
+
     for (uint8_t i = 0; i < HBcons->numberOfMonitoredNodes; i++) {
         uint32_t val;
         odRet = OD_get_u32(OD_1016_HBcons, i + 1U, &val, true);
@@ -189,6 +262,16 @@ CO_HBconsumer_initEntry(CO_HBconsumer_t* HBcons, uint8_t idx, uint8_t nodeId, ui
         uint16_t COB_ID;
 
         CO_HBconsNode_t* monitoredNode = &HBcons->monitoredNodes[idx];
+#if CO_NODE_TIMERS > 0
+        CO_HBcons_count(HBcons, monitoredNode, false);
+        CO_nodeTimers_stop(&HBcons->timers, idx);
+#endif
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+        if (monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED) {
+            CO_netState_monitor(HBcons->netState, monitoredNode->nodeId, false);
+        }
+        monitoredNode->netState = HBcons->netState;
+#endif
         monitoredNode->nodeId = nodeId;
         monitoredNode->time_us = (uint32_t)consumerTime_ms * 1000U;
         monitoredNode->NMTstate = CO_NMT_UNKNOWN;
@@ -207,6 +290,14 @@ CO_HBconsumer_initEntry(CO_HBconsumer_t* HBcons, uint8_t idx, uint8_t nodeId, ui
             monitoredNode->time_us = 0;
             monitoredNode->HBstate = CO_HBconsumer_UNCONFIGURED;
         }
+#if CO_NODE_TIMERS > 0
+        CO_HBcons_count(HBcons, monitoredNode, true);
+#endif
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+        if (monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED) {
+            CO_netState_monitor(HBcons->netState, monitoredNode->nodeId, true);
+        }
+#endif
 
         /* configure Heartbeat consumer (or disable) CAN reception */
         ret = CO_CANrxBufferInit(HBcons->CANdevRx, HBcons->CANdevRxIdxStart + idx, COB_ID, 0x7FF, false,
@@ -215,6 +306,32 @@ CO_HBconsumer_initEntry(CO_HBconsumer_t* HBcons, uint8_t idx, uint8_t nodeId, ui
     return ret;
 }
 
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+void
+CO_HBconsumer_setSDOcache(CO_HBconsumer_t* HBcons, CO_SDOcache_t* cache) {
+    if (HBcons != NULL) {
+        HBcons->SDOcache = cache;
+    }
+}
+#endif
+
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+void
+CO_HBconsumer_setNetState(CO_HBconsumer_t* HBcons, CO_netState_t* netState) {
+    if (HBcons == NULL) {
+        return;
+    }
+    HBcons->netState = netState;
+    for (uint8_t i = 0; i < HBcons->numberOfMonitoredNodes; i++) {
+        CO_HBconsNode_t* const monitoredNode = &HBcons->monitoredNodes[i];
+        monitoredNode->netState = netState;
+        if (monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED) {
+            CO_netState_monitor(netState, monitoredNode->nodeId, true);
+        }
+    }
+}
+#endif
+
 #if ((CO_CONFIG_HB_CONS)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
 void
 CO_HBconsumer_initCallbackPre(CO_HBconsumer_t* HBcons, void* object, void (*pFunctSignal)(void* object)) {
@@ -309,6 +426,92 @@ CO_HBconsumer_process(CO_HBconsumer_t* HBcons, bool_t NMTisPreOrOperational, uin
     bool_t allMonitoredOperationalCurrent = true;
 
     if (NMTisPreOrOperational && HBcons->NMTisPreOrOperationalPrev) {
+#if CO_NODE_TIMERS > 0
+        CO_nodeTimers_t* timers = &HBcons->timers;
+        int16_t slot;
+
+        CO_nodeTimers_advance(timers, timeDifference_us);
+
+        /* Nodes with received message, heartbeat or bootup */
+        CO_nodeTimers_takeEvents(timers);
+        for (slot = CO_nodeTimers_nextEvent(timers); slot >= 0; slot = CO_nodeTimers_nextEvent(timers)) {
+            uint8_t i = (uint8_t)slot;
+            CO_HBconsNode_t* const monitoredNode = &HBcons->monitoredNodes[i];
+
+            if ((monitoredNode->HBstate == CO_HBconsumer_UNCONFIGURED) || !CO_FLAG_READ(monitoredNode->CANrxNew)) {
+                continue;
+            }
+            CO_HBcons_count(HBcons, monitoredNode, false);
+            if (monitoredNode->NMTstate == CO_NMT_INITIALIZING) {
+                /* bootup message */
+#if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_MULTI) != 0
+                if (monitoredNode->pFunctSignalRemoteReset != NULL) {
+                    monitoredNode->pFunctSignalRemoteReset(monitoredNode->nodeId, i,
+                                                           monitoredNode->functSignalObjectRemoteReset);
+                }
+#endif
+                if (monitoredNode->HBstate == CO_HBconsumer_ACTIVE) {
+                    CO_errorReport(HBcons->em, CO_EM_HB_CONSUMER_REMOTE_RESET, CO_EMC_HEARTBEAT, i);
+                }
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+                CO_SDOcache_invalidate(HBcons->SDOcache, monitoredNode->nodeId);
+#endif
+                monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
+                CO_nodeTimers_stop(timers, i);
+            } else {
+                /* heartbeat message */
+#if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_MULTI) != 0
+                if (monitoredNode->HBstate != CO_HBconsumer_ACTIVE && monitoredNode->pFunctSignalHbStarted != NULL) {
+                    monitoredNode->pFunctSignalHbStarted(monitoredNode->nodeId, i,
+                                                         monitoredNode->functSignalObjectHbStarted);
+                }
+#endif
+                monitoredNode->HBstate = CO_HBconsumer_ACTIVE;
+                /* re-arm the deadline */
+                CO_nodeTimers_start(timers, i, monitoredNode->time_us);
+            }
+            CO_FLAG_CLEAR(monitoredNode->CANrxNew);
+            CO_HBcons_count(HBcons, monitoredNode, true);
+#if (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_CHANGE) != 0)                                                     \
+    || (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_MULTI) != 0)
+            CO_HBcons_verifyNmtChanged(HBcons, monitoredNode, i);
+#endif
+        }
+
+        /* Active nodes with expired deadline */
+        for (slot = CO_nodeTimers_nextExpired(timers); slot >= 0; slot = CO_nodeTimers_nextExpired(timers)) {
+            uint8_t i = (uint8_t)slot;
+            CO_HBconsNode_t* const monitoredNode = &HBcons->monitoredNodes[i];
+
+            CO_HBcons_count(HBcons, monitoredNode, false);
+#if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_MULTI) != 0
+            if (monitoredNode->pFunctSignalTimeout != NULL) {
+                monitoredNode->pFunctSignalTimeout(monitoredNode->nodeId, i, monitoredNode->functSignalObjectTimeout);
+            }
+#endif
+            CO_errorReport(HBcons->em, CO_EM_HEARTBEAT_CONSUMER, CO_EMC_HEARTBEAT, i);
+            monitoredNode->NMTstate = CO_NMT_UNKNOWN;
+            monitoredNode->HBstate = CO_HBconsumer_TIMEOUT;
+            CO_nodeTimers_stop(timers, i);
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+            CO_netState_lost(HBcons->netState, monitoredNode->nodeId, true);
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+            CO_SDOcache_invalidate(HBcons->SDOcache, monitoredNode->nodeId);
+#endif
+            CO_HBcons_count(HBcons, monitoredNode, true);
+#if (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_CHANGE) != 0)                                                     \
+    || (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_MULTI) != 0)
+            CO_HBcons_verifyNmtChanged(HBcons, monitoredNode, i);
+#endif
+        }
+
+#if ((CO_CONFIG_HB_CONS)&CO_CONFIG_FLAG_TIMERNEXT) != 0
+        CO_nodeTimers_timerNext(timers, timerNext_us);
+#endif
+        allMonitoredActiveCurrent = HBcons->activeCount == HBcons->configuredCount;
+        allMonitoredOperationalCurrent = HBcons->operationalCount == HBcons->configuredCount;
+#else
         for (uint8_t i = 0; i < HBcons->numberOfMonitoredNodes; i++) {
             uint32_t timeDifference_us_copy = timeDifference_us;
             CO_HBconsNode_t* const monitoredNode = &HBcons->monitoredNodes[i];
@@ -330,6 +533,9 @@ CO_HBconsumer_process(CO_HBconsumer_t* HBcons, bool_t NMTisPreOrOperational, uin
                     if (monitoredNode->HBstate == CO_HBconsumer_ACTIVE) {
                         CO_errorReport(HBcons->em, CO_EM_HB_CONSUMER_REMOTE_RESET, CO_EMC_HEARTBEAT, i);
                     }
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+                    CO_SDOcache_invalidate(HBcons->SDOcache, monitoredNode->nodeId);
+#endif
                     monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
 
                 } else {
@@ -364,6 +570,12 @@ CO_HBconsumer_process(CO_HBconsumer_t* HBcons, bool_t NMTisPreOrOperational, uin
                     CO_errorReport(HBcons->em, CO_EM_HEARTBEAT_CONSUMER, CO_EMC_HEARTBEAT, i);
                     monitoredNode->NMTstate = CO_NMT_UNKNOWN;
                     monitoredNode->HBstate = CO_HBconsumer_TIMEOUT;
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+                    CO_netState_lost(HBcons->netState, monitoredNode->nodeId, true);
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+                    CO_SDOcache_invalidate(HBcons->SDOcache, monitoredNode->nodeId);
+#endif
                 }
 
 #if ((CO_CONFIG_HB_CONS)&CO_CONFIG_FLAG_TIMERNEXT) != 0
@@ -385,22 +597,10 @@ CO_HBconsumer_process(CO_HBconsumer_t* HBcons, bool_t NMTisPreOrOperational, uin
             }
 #if (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_CHANGE) != 0)                                                     \
     || (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_MULTI) != 0)
-            /* Verify, if NMT state of monitored node changed */
-            if (monitoredNode->NMTstate != monitoredNode->NMTstatePrev) {
-#if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_CHANGE) != 0
-                if (HBcons->pFunctSignalNmtChanged != NULL) {
-                    HBcons->pFunctSignalNmtChanged(monitoredNode->nodeId, i, monitoredNode->NMTstate,
-                                                   HBcons->pFunctSignalObjectNmtChanged);
-#else
-                if (monitoredNode->pFunctSignalNmtChanged != NULL) {
-                    monitoredNode->pFunctSignalNmtChanged(monitoredNode->nodeId, i, monitoredNode->NMTstate,
-                                                          monitoredNode->pFunctSignalObjectNmtChanged);
-#endif
-                }
-                monitoredNode->NMTstatePrev = monitoredNode->NMTstate;
-            }
+            CO_HBcons_verifyNmtChanged(HBcons, monitoredNode, i);
 #endif
         }
+#endif /* CO_NODE_TIMERS > 0 */
     } else if (NMTisPreOrOperational || HBcons->NMTisPreOrOperationalPrev) {
         /* (pre)operational state changed, clear variables */
         for (uint8_t i = 0; i < HBcons->numberOfMonitoredNodes; i++) {
@@ -413,8 +613,19 @@ CO_HBconsumer_process(CO_HBconsumer_t* HBcons, bool_t NMTisPreOrOperational, uin
             CO_FLAG_CLEAR(monitoredNode->CANrxNew);
             if (monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED) {
                 monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+                CO_netState_lost(HBcons->netState, monitoredNode->nodeId, false);
+#endif
             }
+#if CO_NODE_TIMERS > 0
+            monitoredNode->operationalCounted = false;
+#endif
         }
+#if CO_NODE_TIMERS > 0
+        CO_nodeTimers_clear(&HBcons->timers);
+        HBcons->activeCount = 0;
+        HBcons->operationalCount = 0;
+#endif
         allMonitoredActiveCurrent = false;
         allMonitoredOperationalCurrent = false;
     } else { /* MISRA C 2004 14.10 */
@@ -25,6 +25,9 @@
 #include "301/CO_ODinterface.h"
 #include "301/CO_NMT_Heartbeat.h"
 #include "301/CO_Emergency.h"
+#include "301/CO_nodeTimers.h"
+#include "extra/CO_netState.h"
+#include "extra/CO_SDOcache.h"
 
 /* default configuration, see CO_config.h */
 #ifndef CO_CONFIG_HB_CONS
@@ -73,9 +76,17 @@ typedef struct {
     uint8_t nodeId;                  /**< Node Id of the monitored node */
     CO_NMT_internalState_t NMTstate; /**< NMT state of the remote node (Heartbeat payload) */
     CO_HBconsumer_state_t HBstate;   /**< Current heartbeat monitoring state of the remote node */
-    uint32_t timeoutTimer;           /**< Time since last heartbeat received */
+    uint32_t timeoutTimer;           /**< Time since last heartbeat received, not used with CO_NODE_TIMERS */
     uint32_t time_us;                /**< Consumer heartbeat time from OD */
     volatile void* CANrxNew;         /**< Indication if new Heartbeat message received from the CAN bus */
+#if (CO_NODE_TIMERS > 0) || defined CO_DOXYGEN
+    CO_nodeTimers_t* timers;         /**< Timers of CO_HBconsumer_t, receive callback marks the node there */
+    uint8_t idx;                     /**< Index of the node in CO_HBconsumer_t, slot in timers */
+    bool_t operationalCounted;       /**< Node is counted in CO_HBconsumer_t operationalCount */
+#endif
+#if (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0) || defined CO_DOXYGEN
+    CO_netState_t* netState;         /**< From CO_HBconsumer_setNetState() or NULL */
+#endif
 #if (((CO_CONFIG_HB_CONS)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0) || defined CO_DOXYGEN
     void (*pFunctSignalPre)(void* object); /**< From CO_HBconsumer_initCallbackPre() or NULL */
     void* functSignalObjectPre;            /**< From CO_HBconsumer_initCallbackPre() or NULL */
@@ -121,6 +132,18 @@ typedef struct {
 #if (((CO_CONFIG_HB_CONS)&CO_CONFIG_FLAG_OD_DYNAMIC) != 0) || defined CO_DOXYGEN
     OD_extension_t OD_1016_extension; /**< Extension for OD object */
 #endif
+#if (CO_NODE_TIMERS > 0) || defined CO_DOXYGEN
+    CO_nodeTimers_t timers;   /**< Heartbeat deadlines of active nodes and nodes with received message */
+    uint8_t configuredCount;  /**< Number of monitored nodes, which are not CO_HBconsumer_UNCONFIGURED */
+    uint8_t activeCount;      /**< Number of CO_HBconsumer_ACTIVE nodes */
+    uint8_t operationalCount; /**< Number of configured nodes in CO_NMT_OPERATIONAL state */
+#endif
+#if (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0) || defined CO_DOXYGEN
+    CO_netState_t* netState; /**< From CO_HBconsumer_setNetState() or NULL */
+#endif
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0) || defined CO_DOXYGEN
+    CO_SDOcache_t* SDOcache; /**< From CO_HBconsumer_setSDOcache() or NULL */
+#endif
 #if (((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_CALLBACK_CHANGE) != 0) || defined CO_DOXYGEN
     /** Callback for remote NMT changed event.  From CO_HBconsumer_initCallbackNmtChanged() or NULL. */
     void (*pFunctSignalNmtChanged)(uint8_t nodeId, uint8_t idx, CO_NMT_internalState_t NMTstate, void* object);
@@ -151,6 +174,33 @@ CO_ReturnError_t CO_HBconsumer_init(CO_HBconsumer_t* HBcons, CO_EM_t* em, CO_HBc
                                     uint8_t monitoredNodesCount, OD_entry_t* OD_1016_HBcons, CO_CANmodule_t* CANdevRx,
                                     uint16_t CANdevRxIdxStart, uint32_t* errInfo);
 
+#if (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0) || defined CO_DOXYGEN
+/**
+ * Attach network state table, see @ref CO_netState.
+ *
+ * Configured nodes are marked as monitored. Received heartbeats and boot-ups, heartbeat timeouts and changes of
+ * monitored nodes are then reported to the table.
+ *
+ * @param HBcons This object.
+ * @param netState Initialized network state or NULL to detach.
+ */
+void CO_HBconsumer_setNetState(CO_HBconsumer_t* HBcons, CO_netState_t* netState);
+#endif
+
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0) || defined CO_DOXYGEN
+/**
+ * Attach SDO cache, see @ref CO_SDOcache.
+ *
+ * Cached objects of the monitored node are invalidated on its boot-up and on heartbeat timeout, because the node may
+ * be reset or replaced. Invalidation is independent of the NMT changed callbacks, which stay free for the
+ * application.
+ *
+ * @param HBcons This object.
+ * @param cache Initialized SDO cache or NULL to detach.
+ */
+void CO_HBconsumer_setSDOcache(CO_HBconsumer_t* HBcons, CO_SDOcache_t* cache);
+#endif
+
 #if (((CO_CONFIG_HB_CONS)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0) || defined CO_DOXYGEN
 /**
  * Initialize Heartbeat consumer callback function.
@@ -247,6 +247,23 @@ CO_ngm_receive(void* object, void* msg) {
     uint8_t DLC = CO_CANrxMsg_readDLC(msg);
     const uint8_t* data = CO_CANrxMsg_readData(msg);
     uint16_t ident = CO_CANrxMsg_readIdent(msg);
+#if CO_NODE_TIMERS > 0
+    uint8_t slot = ngm->nodeSlot[ident & 0x7FU];
+
+    if (DLC == 1 && slot != 0U) {
+        CO_nodeGuardingMasterNode_t* node = &ngm->nodes[slot - 1U];
+        uint8_t toggle = data[0] & 0x80;
+        if (toggle == node->toggle) {
+            node->responseRecived = true;
+            node->NMTstate = (CO_NMT_internalState_t)(data[0] & 0x7F);
+            node->toggle = (toggle != 0) ? 0x00 : 0x80;
+            CO_nodeTimers_event(&ngm->timers, slot - 1U);
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+            CO_netState_rxNMT(ngm->netState, (uint8_t)(ident & 0x7FU), data[0] & 0x7FU);
+#endif
+        }
+    }
+#else
     CO_nodeGuardingMasterNode_t* node = &ngm->nodes[0];
 
     if (DLC == 1) {
@@ -257,13 +274,51 @@ CO_ngm_receive(void* object, void* msg) {
                     node->responseRecived = true;
                     node->NMTstate = (CO_NMT_internalState_t)(data[0] & 0x7F);
                     node->toggle = (toggle != 0) ? 0x00 : 0x80;
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+                    CO_netState_rxNMT(ngm->netState, (uint8_t)(ident & 0x7FU), data[0] & 0x7FU);
+#endif
                 }
                 break;
             }
             node++;
         }
     }
+#endif
+}
+
+#if CO_NODE_TIMERS > 0
+/*
+ * Add the node to (or remove it from) the counts of enabled, active and operational nodes
+ *
+ * Call it with add=false before the node is changed by CO_nodeGuardingMaster_process() or by
+ * CO_nodeGuardingMaster_initNode() and with add=true after that.
+ */
+static void
+CO_ngm_count(CO_nodeGuardingMaster_t* ngm, CO_nodeGuardingMasterNode_t* node, bool_t add) {
+    if (add) {
+        node->counted = node->guardTime_us > 0 && node->ident > CO_CAN_ID_HEARTBEAT;
+        node->operationalCounted = node->counted && node->monitoringActive && node->NMTstate == CO_NMT_OPERATIONAL;
+        if (node->counted) {
+            ngm->enabledCount++;
+            if (node->monitoringActive) {
+                ngm->activeCount++;
+            }
+            if (node->operationalCounted) {
+                ngm->operationalCount++;
+            }
+        }
+    } else if (node->counted) {
+        ngm->enabledCount--;
+        if (node->monitoringActive) {
+            ngm->activeCount--;
+        }
+        if (node->operationalCounted) {
+            ngm->operationalCount--;
+        }
+    } else { /* MISRA C 2004 14.10 */
+    }
 }
+#endif
 
 CO_ReturnError_t
 CO_nodeGuardingMaster_init(CO_nodeGuardingMaster_t* ngm, CO_EM_t* em, CO_CANmodule_t* CANdevRx, uint16_t CANdevRxIdx,
@@ -306,6 +361,14 @@ CO_nodeGuardingMaster_initNode(CO_nodeGuardingMaster_t* ngm, uint8_t index, uint
 
     CO_nodeGuardingMasterNode_t* node = &ngm->nodes[index];
 
+#if CO_NODE_TIMERS > 0
+    CO_ngm_count(ngm, node, false);
+#endif
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+    if (node->guardTime_us > 0 && node->ident > CO_CAN_ID_HEARTBEAT) {
+        CO_netState_monitor(ngm->netState, (uint8_t)(node->ident & 0x7FU), false);
+    }
+#endif
     node->guardTime_us = (uint32_t)guardTime_ms * 1000;
     node->guardTimer = 0;
     node->ident = CO_CAN_ID_HEARTBEAT + nodeId;
@@ -314,6 +377,26 @@ CO_nodeGuardingMaster_initNode(CO_nodeGuardingMaster_t* ngm, uint8_t index, uint
     node->responseRecived = true; /* for the first time */
     node->CANtxWasBusy = false;
     node->monitoringActive = false;
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+    CO_netState_monitor(ngm->netState, nodeId, node->guardTime_us > 0);
+#endif
+
+#if CO_NODE_TIMERS > 0
+    CO_ngm_count(ngm, node, true);
+    if (node->counted) {
+        /* send the first rtr in the next processing */
+        CO_nodeTimers_start(&ngm->timers, index, 0);
+    } else {
+        CO_nodeTimers_stop(&ngm->timers, index);
+    }
+    /* receive callback finds the first node with the Node Id */
+    (void)memset(ngm->nodeSlot, 0, sizeof(ngm->nodeSlot));
+    for (uint8_t i = CO_CONFIG_NODE_GUARDING_MASTER_COUNT; i > 0U; i--) {
+        if (ngm->nodes[i - 1U].ident > CO_CAN_ID_HEARTBEAT) {
+            ngm->nodeSlot[ngm->nodes[i - 1U].ident & 0x7FU] = i;
+        }
+    }
+#endif
 
 #if CO_CONFIG_NODE_GUARDING_MASTER_COUNT == 1
     ngm->CANtxBuff = CO_CANtxBufferInit(ngm->CANdevTx, ngm->CANdevTxIdx, node->ident, true, 1, 0);
@@ -322,11 +405,88 @@ CO_nodeGuardingMaster_initNode(CO_nodeGuardingMaster_t* ngm, uint8_t index, uint
     return CO_ERROR_NO;
 }
 
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+void
+CO_nodeGuardingMaster_setNetState(CO_nodeGuardingMaster_t* ngm, CO_netState_t* netState) {
+    if (ngm == NULL) {
+        return;
+    }
+    ngm->netState = netState;
+    for (uint8_t i = 0; i < CO_CONFIG_NODE_GUARDING_MASTER_COUNT; i++) {
+        const CO_nodeGuardingMasterNode_t* node = &ngm->nodes[i];
+        if (node->guardTime_us > 0 && node->ident > CO_CAN_ID_HEARTBEAT) {
+            CO_netState_monitor(netState, (uint8_t)(node->ident & 0x7FU), true);
+        }
+    }
+}
+#endif
+
 void
 CO_nodeGuardingMaster_process(CO_nodeGuardingMaster_t* ngm, uint32_t timeDifference_us, uint32_t* timerNext_us) {
     (void)timerNext_us; /* may be unused */
     bool_t allMonitoredActiveCurrent = true;
     bool_t allMonitoredOperationalCurrent = true;
+#if CO_NODE_TIMERS > 0
+    CO_nodeTimers_t* timers = &ngm->timers;
+    bool_t CANtxBusy = false;
+    int16_t slot;
+
+    CO_nodeTimers_advance(timers, timeDifference_us);
+
+    /* Nodes with received response, NMT state may be changed */
+    CO_nodeTimers_takeEvents(timers);
+    for (slot = CO_nodeTimers_nextEvent(timers); slot >= 0; slot = CO_nodeTimers_nextEvent(timers)) {
+        CO_ngm_count(ngm, &ngm->nodes[slot], false);
+        CO_ngm_count(ngm, &ngm->nodes[slot], true);
+    }
+
+    /* Nodes with expired guard time */
+    for (slot = CO_nodeTimers_nextExpired(timers); slot >= 0; slot = CO_nodeTimers_nextExpired(timers)) {
+        CO_nodeGuardingMasterNode_t* node = &ngm->nodes[slot];
+
+        CO_ngm_count(ngm, node, false);
+        /* it is time to send new rtr, but first verify last response */
+        if (!node->CANtxWasBusy) {
+            if (!node->responseRecived) {
+                node->monitoringActive = false;
+                /* error bit is shared with HB consumer */
+                CO_errorReport(ngm->em, CO_EM_HEARTBEAT_CONSUMER, CO_EMC_HEARTBEAT, node->ident & 0x7F);
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+                CO_netState_lost(ngm->netState, (uint8_t)(node->ident & 0x7FU), true);
+#endif
+            } else if (node->NMTstate != CO_NMT_UNKNOWN) {
+                node->monitoringActive = true;
+                CO_errorReset(ngm->em, CO_EM_HEARTBEAT_CONSUMER, node->ident & 0x7F);
+            }
+        }
+
+        if (ngm->CANtxBuff->bufferFull) {
+            /* node stays expired, retry in the next processing */
+            node->CANtxWasBusy = true;
+            CANtxBusy = true;
+        } else {
+#if CO_CONFIG_NODE_GUARDING_MASTER_COUNT > 1
+            ngm->CANtxBuff = CO_CANtxBufferInit(ngm->CANdevTx, ngm->CANdevTxIdx, node->ident, true, 1, 0);
+#endif
+            (void)CO_CANsend(ngm->CANdevTx, ngm->CANtxBuff);
+            node->CANtxWasBusy = false;
+            node->responseRecived = false;
+            CO_nodeTimers_start(timers, (uint8_t)slot, node->guardTime_us);
+        }
+        CO_ngm_count(ngm, node, true);
+        if (CANtxBusy) {
+            break;
+        }
+    }
+
+#if ((CO_CONFIG_NMT)&CO_CONFIG_FLAG_TIMERNEXT) != 0
+    if (!CANtxBusy) {
+        CO_nodeTimers_timerNext(timers, timerNext_us);
+    }
+#endif
+    allMonitoredActiveCurrent = ngm->activeCount == ngm->enabledCount;
+    allMonitoredOperationalCurrent = allMonitoredActiveCurrent && (ngm->operationalCount == ngm->activeCount);
+#else
     CO_nodeGuardingMasterNode_t* node = &ngm->nodes[0];
 
     for (uint8_t i = 0; i < CO_CONFIG_NODE_GUARDING_MASTER_COUNT; i++) {
@@ -346,6 +506,9 @@ CO_nodeGuardingMaster_process(CO_nodeGuardingMaster_t* ngm, uint32_t timeDiffere
                         node->monitoringActive = false;
                         /* error bit is shared with HB consumer */
                         CO_errorReport(ngm->em, CO_EM_HEARTBEAT_CONSUMER, CO_EMC_HEARTBEAT, node->ident & 0x7F);
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+                        CO_netState_lost(ngm->netState, (uint8_t)(node->ident & 0x7FU), true);
+#endif
                     } else if (node->NMTstate != CO_NMT_UNKNOWN) {
                         node->monitoringActive = true;
                         CO_errorReset(ngm->em, CO_EM_HEARTBEAT_CONSUMER, node->ident & 0x7F);
@@ -380,6 +543,7 @@ CO_nodeGuardingMaster_process(CO_nodeGuardingMaster_t* ngm, uint32_t timeDiffere
 
         node++;
     } /* for */
+#endif /* CO_NODE_TIMERS > 0 */
 
     ngm->allMonitoredActive = allMonitoredActiveCurrent;
     ngm->allMonitoredOperational = allMonitoredOperationalCurrent;
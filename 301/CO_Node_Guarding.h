@@ -25,6 +25,8 @@
 #include "301/CO_ODinterface.h"
 #include "301/CO_Emergency.h"
 #include "301/CO_NMT_Heartbeat.h"
+#include "301/CO_nodeTimers.h"
+#include "extra/CO_netState.h"
 
 /* default configuration, see CO_config.h */
 #ifndef CO_CONFIG_NODE_GUARDING
@@ -166,13 +168,17 @@ extern "C" {
  */
 typedef struct {
     uint32_t guardTime_us;           /**< Guard time in microseconds */
-    uint32_t guardTimer;             /**< Guard timer in microseconds, counting down */
+    uint32_t guardTimer;             /**< Guard timer in microseconds, counting down, not used with CO_NODE_TIMERS */
     uint16_t ident;                  /**< CAN identifier (CO_CAN_ID_HEARTBEAT + Node Id) */
     CO_NMT_internalState_t NMTstate; /**< NMT operating state */
     uint8_t toggle;                  /**< toggle bit7, expected from the next received message */
     bool_t responseRecived;          /**< True, if response was received since last rtr message */
     bool_t CANtxWasBusy;             /**< True, if CANtxBuff was busy since last processing */
     bool_t monitoringActive;         /**< True, if monitoring is active (response within time). */
+#if (CO_NODE_TIMERS > 0) || defined CO_DOXYGEN
+    bool_t counted;                  /**< Node is counted in CO_nodeGuardingMaster_t enabledCount */
+    bool_t operationalCounted;       /**< Node is counted in CO_nodeGuardingMaster_t operationalCount */
+#endif
 } CO_nodeGuardingMasterNode_t;
 
 /**
@@ -188,6 +194,16 @@ typedef struct {
     bool_t allMonitoredOperational; /**< True, if all monitored nodes are NMT operational or no node is monitored. Can
                                        be read by the application */
     CO_nodeGuardingMasterNode_t nodes[CO_CONFIG_NODE_GUARDING_MASTER_COUNT]; /**< Array of monitored nodes */
+#if (CO_NODE_TIMERS > 0) || defined CO_DOXYGEN
+    CO_nodeTimers_t timers;   /**< Guard time deadlines of enabled nodes and nodes with received response */
+    uint8_t nodeSlot[128];    /**< Index + 1 of the first node with the Node Id, 0 if none, for the receive callback */
+    uint8_t enabledCount;     /**< Number of nodes with guard time and Node Id */
+    uint8_t activeCount;      /**< Number of enabled nodes with monitoringActive */
+    uint8_t operationalCount; /**< Number of active nodes in CO_NMT_OPERATIONAL state */
+#endif
+#if (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0) || defined CO_DOXYGEN
+    CO_netState_t* netState; /**< From CO_nodeGuardingMaster_setNetState() or NULL */
+#endif
 } CO_nodeGuardingMaster_t;
 
 /**
@@ -222,6 +238,19 @@ CO_ReturnError_t CO_nodeGuardingMaster_init(CO_nodeGuardingMaster_t* ngm, CO_EM_
 CO_ReturnError_t CO_nodeGuardingMaster_initNode(CO_nodeGuardingMaster_t* ngm, uint8_t index, uint8_t nodeId,
                                                 uint16_t guardTime_ms);
 
+#if (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0) || defined CO_DOXYGEN
+/**
+ * Attach network state table, see @ref CO_netState.
+ *
+ * Enabled nodes are marked as monitored. Guarding responses, missing responses and changes of monitored nodes are then
+ * reported to the table.
+ *
+ * @param ngm This object.
+ * @param netState Initialized network state or NULL to detach.
+ */
+void CO_nodeGuardingMaster_setNetState(CO_nodeGuardingMaster_t* ngm, CO_netState_t* netState);
+#endif
+
 /**
  * Process Node Guarding master.
  *
@@ -116,6 +116,25 @@ OD_writeOriginal(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_
     return returnCode;
 }
 
+#if OD_IO_VIEW > 0
+ODR_t
+OD_viewOriginal(OD_stream_t* stream, const void** data, OD_size_t* count) {
+    if ((stream == NULL) || (data == NULL) || (count == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+    if ((stream->dataOrig == NULL) || (stream->dataLength == 0U) || ((stream->attribute & (OD_attr_t)ODA_STR) != 0U)) {
+        return ODR_UNSUPP_ACCESS;
+    }
+    if (stream->dataOffset >= stream->dataLength) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    *data = (const uint8_t*)stream->dataOrig + stream->dataOffset;
+    *count = stream->dataLength - stream->dataOffset;
+    return ODR_OK;
+}
+#endif
+
 /* Read value from variable from Object Dictionary disabled, see OD_IO_t */
 static ODR_t
 OD_readDisabled(OD_stream_t* stream, void* buf, OD_size_t count, OD_size_t* countRead) {
@@ -142,6 +161,17 @@ OD_find(OD_t* od, uint16_t index) {
         return NULL;
     }
 
+#if OD_HASH > 0
+    if (od->hash != NULL) {
+        const OD_hash_t* hash = od->hash;
+        uint16_t pos = hash->table[((uint32_t)index * hash->multiplier) >> hash->shift];
+        if ((pos < od->size) && (od->list[pos].index == index)) {
+            return &od->list[pos];
+        }
+        return NULL;
+    }
+#endif
+
     uint16_t min = 0;
     uint16_t max = od->size - 1U;
 
@@ -173,6 +203,110 @@ OD_find(OD_t* od, uint16_t index) {
     return NULL; /* entry does not exist in OD */
 }
 
+#if OD_HASH > 0
+/* Number of multipliers tried for each number of slots by OD_hashBuild() */
+#ifndef OD_HASH_TRIES
+#define OD_HASH_TRIES 4096U
+#endif
+
+/* Verify, that OD list is ordered by index without duplicates */
+static bool_t
+OD_isOrdered(const OD_t* od) {
+    for (uint16_t i = 1; i < od->size; i++) {
+        if (od->list[i - 1U].index >= od->list[i].index) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ODR_t
+OD_hashBuild(const OD_t* od, OD_hash_t* hash, uint16_t* table, uint32_t tableSize) {
+    if ((od == NULL) || (hash == NULL) || (table == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+    if (!OD_isOrdered(od)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    /* start with the smallest power of two, which is larger or equal to the number of entries */
+    uint8_t bits = 1;
+    while ((bits < 16U) && ((1UL << bits) < od->size)) {
+        bits++;
+    }
+
+    for (; (bits <= 16U) && ((1UL << bits) <= tableSize); bits++) {
+        uint32_t slots = 1UL << bits;
+        uint8_t shift = (uint8_t)(32U - bits);
+        uint32_t multiplier = 0x9E3779B1U;
+
+        for (uint32_t t = 0; t < OD_HASH_TRIES; t++) {
+            bool_t collision = false;
+
+            for (uint32_t s = 0; s < slots; s++) {
+                table[s] = OD_HASH_EMPTY;
+            }
+            for (uint16_t i = 0; i < od->size; i++) {
+                uint32_t slot = ((uint32_t)od->list[i].index * multiplier) >> shift;
+                if (table[slot] != OD_HASH_EMPTY) {
+                    collision = true;
+                    break;
+                }
+                table[slot] = i;
+            }
+            if (!collision) {
+                hash->multiplier = multiplier;
+                hash->shift = shift;
+                hash->table = table;
+                return ODR_OK;
+            }
+
+            /* next odd multiplier from linear congruential sequence */
+            multiplier = (multiplier * 1664525U + 1013904223U) | 1U;
+        }
+    }
+
+    return ODR_OUT_OF_MEM;
+}
+
+ODR_t
+OD_initHash(OD_t* od, const OD_hash_t* hash) {
+    if (od == NULL) {
+        return ODR_DEV_INCOMPAT;
+    }
+    od->hash = NULL;
+    if (!OD_isOrdered(od)) {
+        return ODR_DEV_INCOMPAT;
+    }
+    if (hash == NULL) {
+        return ODR_OK;
+    }
+    if ((hash->table == NULL) || (hash->shift < 16U) || (hash->shift > 31U)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    /* each entry must be found in own slot and each used slot must point to own entry */
+    uint32_t slots = 1UL << (32U - hash->shift);
+    uint32_t used = 0;
+    for (uint32_t s = 0; s < slots; s++) {
+        uint16_t pos = hash->table[s];
+        if (pos == OD_HASH_EMPTY) {
+            continue;
+        }
+        if ((pos >= od->size) || ((((uint32_t)od->list[pos].index * hash->multiplier) >> hash->shift) != s)) {
+            return ODR_DEV_INCOMPAT;
+        }
+        used++;
+    }
+    if (used != od->size) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    od->hash = hash;
+    return ODR_OK;
+}
+#endif /* OD_HASH > 0 */
+
 ODR_t
 OD_getSub(const OD_entry_t* entry, uint8_t subIndex, OD_IO_t* io, bool_t odOrig) {
     if ((entry == NULL) || (entry->odObject == NULL)) {
@@ -248,12 +382,18 @@ OD_getSub(const OD_entry_t* entry, uint8_t subIndex, OD_IO_t* io, bool_t odOrig)
         if ((entry->extension == NULL) || odOrig) {
             io->read = OD_readOriginal;
             io->write = OD_writeOriginal;
+#if OD_IO_VIEW > 0
+            io->view = OD_viewOriginal;
+#endif
             stream->object = NULL;
         }
         /* Access data from extension specified by application */
         else {
             io->read = (entry->extension->read != NULL) ? entry->extension->read : OD_readDisabled;
             io->write = (entry->extension->write != NULL) ? entry->extension->write : OD_writeDisabled;
+#if OD_IO_VIEW > 0
+            io->view = (entry->extension->read != NULL) ? entry->extension->view : NULL;
+#endif
             stream->object = entry->extension->object;
         }
 
@@ -369,3 +509,122 @@ OD_getPtr(const OD_entry_t* entry, uint8_t subIndex, OD_size_t len, ODR_t* err)
 
     return (errCopy == ODR_OK) ? stream->dataOrig : NULL;
 }
+
+#if OD_HANDLES > 0
+ODR_t
+OD_handle_init(OD_handle_t* handle, OD_t* od, uint16_t index, uint8_t subIndex, bool_t odOrig) {
+    if ((handle == NULL) || (od == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    /* handle may be initialized again, don't link it twice */
+    bool_t linked = false;
+    for (const OD_handle_t* h = od->handles; h != NULL; h = h->next) {
+        if (h == handle) {
+            linked = true;
+            break;
+        }
+    }
+
+    OD_handle_t* next = linked ? handle->next : od->handles;
+    (void)memset(handle, 0, sizeof(OD_handle_t));
+    handle->od = od;
+    handle->index = index;
+    handle->subIndex = subIndex;
+    handle->odOrig = odOrig;
+    handle->next = next;
+    if (!linked) {
+        od->handles = handle;
+    }
+
+    return OD_handle_bind(handle);
+}
+
+ODR_t
+OD_handle_bind(OD_handle_t* handle) {
+    if ((handle == NULL) || (handle->od == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    handle->data = NULL;
+    handle->entry = OD_find(handle->od, handle->index);
+    handle->status = OD_getSub(handle->entry, handle->subIndex, &handle->io, handle->odOrig);
+    if (handle->status != ODR_OK) {
+        handle->io.read = NULL;
+        handle->io.write = NULL;
+        return handle->status;
+    }
+
+    /* variables without IO extension are accessed directly */
+    OD_stream_t* stream = &handle->io.stream;
+    if ((handle->io.read == OD_readOriginal) && (handle->io.write == OD_writeOriginal) && (stream->dataOrig != NULL)
+        && (stream->dataLength > 0U)) {
+        handle->data = stream->dataOrig;
+    }
+    return ODR_OK;
+}
+
+void
+OD_handle_remove(OD_handle_t* handle) {
+    if ((handle == NULL) || (handle->od == NULL)) {
+        return;
+    }
+
+    OD_handle_t** pp = &handle->od->handles;
+    while (*pp != NULL) {
+        if (*pp == handle) {
+            *pp = handle->next;
+            break;
+        }
+        pp = &(*pp)->next;
+    }
+    handle->next = NULL;
+    handle->od = NULL;
+    handle->data = NULL;
+    handle->status = ODR_DEV_INCOMPAT;
+}
+
+void
+OD_rebindHandles(OD_t* od) {
+    if (od == NULL) {
+        return;
+    }
+    for (OD_handle_t* handle = od->handles; handle != NULL; handle = handle->next) {
+        (void)OD_handle_bind(handle);
+    }
+}
+
+ODR_t
+OD_handle_read(OD_handle_t* handle, void* val, OD_size_t len) {
+    if ((handle == NULL) || (val == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+    if (handle->status != ODR_OK) {
+        return handle->status;
+    }
+    if (handle->io.stream.dataLength != len) {
+        return ODR_TYPE_MISMATCH;
+    }
+
+    OD_size_t countRd = 0;
+    handle->io.stream.dataOffset = 0;
+    return handle->io.read(&handle->io.stream, val, len, &countRd);
+}
+
+ODR_t
+OD_handle_write(OD_handle_t* handle, const void* val, OD_size_t len) {
+    if ((handle == NULL) || (val == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+    if (handle->status != ODR_OK) {
+        return handle->status;
+    }
+    if (handle->io.stream.dataLength != len) {
+        return ODR_TYPE_MISMATCH;
+    }
+
+    OD_size_t countWritten = 0;
+    handle->io.stream.dataOffset = 0;
+    return handle->io.write(&handle->io.stream, val, len, &countWritten);
+}
+#endif /* OD_HANDLES > 0 */
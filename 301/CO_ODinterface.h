@@ -45,6 +45,24 @@ typedef uint8_t OD_attr_t;  /**< Type (and size) of Object Dictionary attribute
 #define OD_FLAGS_PDO_SIZE 4U /**< Size of of flagsPDO variable inside @ref OD_extension_t, from 0 to 32. */
 #endif
 
+#ifndef OD_TPDO_PENDING_WORDS
+#define OD_TPDO_PENDING_WORDS 0 /**< Size of the bitmap of TPDOs with pending request in 32-bit words, 0 to disable,
+                                   see @ref OD_requestTPDO */
+#endif
+#if (OD_TPDO_PENDING_WORDS > 0) && (OD_FLAGS_PDO_SIZE == 0)
+#error OD_TPDO_PENDING_WORDS requires OD_FLAGS_PDO_SIZE
+#endif
+
+#ifndef OD_IO_VIEW
+#define OD_IO_VIEW 0 /**< If 1, @ref OD_IO_t and @ref OD_extension_t contain "view" function for zero-copy read */
+#endif
+#ifndef OD_HASH
+#define OD_HASH 0 /**< If 1, @ref OD_t contains optional hash index for one probe @ref OD_find(), see @ref OD_hash_t */
+#endif
+#ifndef OD_HANDLES
+#define OD_HANDLES 0 /**< If 1, @ref OD_t contains list of @ref OD_handle_t, resolved OD sub-entries for fast access */
+#endif
+
 #ifndef CO_PROGMEM
 /** Modifier for OD objects. This is large amount of data and is specified in Object Dictionary (OD.c file usually) */
 #define CO_PROGMEM const
@@ -236,6 +254,26 @@ typedef struct {
      * @return Value from @ref ODR_t, "ODR_OK" in case of success.
      */
     ODR_t (*write)(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_t* countWritten);
+#if (OD_IO_VIEW > 0) || defined CO_DOXYGEN
+    /**
+     * Function pointer for zero-copy reading of OD variable, which is stored in contiguous memory, or NULL. It is
+     * optional alternative to "read" for large variables, for example DOMAIN with trace buffer or diagnostic dump.
+     *
+     * Function returns pointer to all data of the variable, starting at stream->dataOffset, and does not change
+     * the stream. Caller (SDO server) transmits data directly from that memory, without copying it into own buffer, so
+     * data must stay valid and unchanged until the transfer ends. If the function returns a value other than "ODR_OK",
+     * caller uses "read" function instead.
+     *
+     * @warning Do not use @ref CO_LOCK_OD() and @ref CO_UNLOCK_OD() macros inside the view() function.
+     *
+     * @param stream Object Dictionary stream object.
+     * @param [out] data Pointer to data.
+     * @param [out] count Number of data bytes.
+     *
+     * @return Value from @ref ODR_t, "ODR_OK" in case of success.
+     */
+    ODR_t (*view)(OD_stream_t* stream, const void** data, OD_size_t* count);
+#endif
 } OD_IO_t;
 
 /**
@@ -251,6 +289,11 @@ typedef struct {
     /** Application specified write function pointer. If NULL, then write will be disabled. @ref OD_writeOriginal can be
      * used here to keep the original write function. For function description see @ref OD_IO_t. */
     ODR_t (*write)(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_t* countWritten);
+#if (OD_IO_VIEW > 0) || defined CO_DOXYGEN
+    /** Application specified view function pointer or NULL, if data are not in contiguous memory. @ref OD_viewOriginal
+     * can be used here, if data are in the original OD location. For function description see @ref OD_IO_t. */
+    ODR_t (*view)(OD_stream_t* stream, const void** data, OD_size_t* count);
+#endif
 #if OD_FLAGS_PDO_SIZE > 0
     /** PDO flags bit-field provides one bit for each OD variable, which exist inside OD object at specific sub index.
      * If application clears that bit, and OD variable is mapped to an event driven TPDO, then TPDO will be sent.
@@ -260,6 +303,13 @@ typedef struct {
      * requesting functionality. See also @ref OD_requestTPDO and @ref OD_TPDOtransmitted. */
     uint8_t flagsPDO[OD_FLAGS_PDO_SIZE];
 #endif
+#if (OD_TPDO_PENDING_WORDS > 0) || defined CO_DOXYGEN
+    /** Bitmap of TPDOs with pending request inside CO_TPDO_pending_t, set by the TPDO, which maps the object. Must be
+     * initialized to NULL. */
+    volatile uint32_t* TPDOpending;
+    /** Bits of the TPDOs, which map the object. Bits of TPDOs, which were re-mapped later, may also remain. */
+    uint32_t TPDOmask[OD_TPDO_PENDING_WORDS];
+#endif
 } OD_extension_t;
 
 /**
@@ -278,12 +328,36 @@ typedef struct {
     OD_extension_t* extension; /**< Extension to OD, specified by application */
 } OD_entry_t;
 
+#if (OD_HASH > 0) || defined CO_DOXYGEN
+/** Value of the empty slot in @ref OD_hash_t table */
+#define OD_HASH_EMPTY 0xFFFFU
+
+/**
+ * Perfect hash index of the Object Dictionary
+ *
+ * Each OD index has own slot: slot = (index * multiplier) >> shift, calculated with uint32_t. Slot contains position of
+ * the entry in the OD list, so @ref OD_find() needs a single probe. Index is generated at build time by od_hashgen
+ * from example/OD.c (OD_hash.c) or at run time by @ref OD_hashBuild(). It is verified and enabled by @ref OD_initHash().
+ */
+typedef struct {
+    uint32_t multiplier;   /**< Odd multiplier of the OD index */
+    uint8_t shift;         /**< Right shift of the product, 32 - log2(number of slots), from 16 to 31 */
+    const uint16_t* table; /**< Position in the OD list for each slot or @ref OD_HASH_EMPTY */
+} OD_hash_t;
+#endif
+
 /**
  * Object Dictionary
  */
 typedef struct {
     uint16_t size;    /**< Number of elements in the list, without last element, which is blank */
     OD_entry_t* list; /**< List OD entries (table of contents), ordered by index */
+#if (OD_HASH > 0) || defined CO_DOXYGEN
+    const OD_hash_t* hash; /**< Hash index, set by @ref OD_initHash(). If NULL, @ref OD_find() uses binary search */
+#endif
+#if (OD_HANDLES > 0) || defined CO_DOXYGEN
+    struct OD_handle* handles; /**< List of handles, see @ref OD_handle_init() and @ref OD_rebindHandles() */
+#endif
 } OD_t;
 
 /**
@@ -304,6 +378,17 @@ ODR_t OD_readOriginal(OD_stream_t* stream, void* buf, OD_size_t count, OD_size_t
  */
 ODR_t OD_writeOriginal(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_t* countWritten);
 
+#if (OD_IO_VIEW > 0) || defined CO_DOXYGEN
+/**
+ * View of value in original OD location
+ *
+ * Zero-copy alternative to @ref OD_readOriginal(), see view in @ref OD_IO_t. If no IO extension is used on OD entry,
+ * then io->view returned by @ref OD_getSub() equals to this function. Strings and variables without own memory or
+ * with unknown length are not viewed, ODR_UNSUPP_ACCESS is returned for them.
+ */
+ODR_t OD_viewOriginal(OD_stream_t* stream, const void** data, OD_size_t* count);
+#endif
+
 /**
  * Find OD entry in Object Dictionary
  *
@@ -314,6 +399,38 @@ ODR_t OD_writeOriginal(OD_stream_t* stream, const void* buf, OD_size_t count, OD
  */
 OD_entry_t* OD_find(OD_t* od, uint16_t index);
 
+#if (OD_HASH > 0) || defined CO_DOXYGEN
+/**
+ * Calculate perfect hash index for the Object Dictionary
+ *
+ * Function searches for the smallest number of slots and a multiplier, which place all OD indexes into different
+ * slots. It is used by od_hashgen at build time and by applications, which assemble Object Dictionary at run time.
+ * Hash must be enabled with @ref OD_initHash() afterwards.
+ *
+ * @param od Object Dictionary, ordered by index
+ * @param [out] hash Hash index to be initialized, its table points to table argument
+ * @param [out] table Memory for slots, owned by application
+ * @param tableSize Number of elements in table. Up to 65536 slots are used, number of slots is power of two.
+ *
+ * @return ODR_OK, ODR_DEV_INCOMPAT if OD is not ordered by index, ODR_OUT_OF_MEM if hash does not fit into table.
+ */
+ODR_t OD_hashBuild(const OD_t* od, OD_hash_t* hash, uint16_t* table, uint32_t tableSize);
+
+/**
+ * Verify the Object Dictionary and enable its hash index for @ref OD_find()
+ *
+ * Should be called at init, before OD is used by CANopen objects. Function verifies, that OD list is ordered by
+ * index without duplicates, and that each OD entry is located in own slot of the hash. Unordered Object Dictionary
+ * is reported here instead of silent failure of OD_find().
+ *
+ * @param od Object Dictionary
+ * @param hash Hash index generated for this OD or NULL to verify OD order only and use binary search
+ *
+ * @return ODR_OK or ODR_DEV_INCOMPAT, if OD is not ordered or hash does not match it. In case of error hash is not used.
+ */
+ODR_t OD_initHash(OD_t* od, const OD_hash_t* hash);
+#endif
+
 /**
  * Find sub-object with specified sub-index on OD entry returned by OD_find. Function populates io structure with
  * sub-object data.
@@ -385,6 +502,10 @@ OD_rwRestart(OD_stream_t* stream) {
  * TPDO event driven transmission is enabled, if TPDO communication parameter, transmission type is set to 0, 254
  * or 255. For other transmission types (synchronous) flagPDO bit is ignored.
  *
+ * With @ref OD_TPDO_PENDING_WORDS the function also marks the TPDOs, which map the object, in the bitmap of pending
+ * TPDOs, so CO_process_TPDO() skips idle event driven TPDOs without requests. If called from other thread than
+ * CO_process_TPDO(), it must be protected by CO_LOCK_OD().
+ *
  * @param entry Object Dictionary entry.
  * @param subIndex subIndex of the OD variable.
  */
@@ -395,6 +516,15 @@ OD_requestTPDO(OD_entry_t* entry, uint8_t subIndex) {
         /* clear subIndex-th bit */
         uint8_t mask = ~(1U << (subIndex & 0x07U));
         entry->extension->flagsPDO[subIndex >> 3] &= mask;
+#if OD_TPDO_PENDING_WORDS > 0
+        /* mark TPDOs, which map the object, so CO_process_TPDO() visits them */
+        volatile uint32_t* TPDOpending = entry->extension->TPDOpending;
+        if (TPDOpending != NULL) {
+            for (uint8_t i = 0; i < OD_TPDO_PENDING_WORDS; i++) {
+                TPDOpending[i] |= entry->extension->TPDOmask[i];
+            }
+        }
+#endif
     }
 #endif
 }
@@ -641,6 +771,263 @@ OD_set_f64(const OD_entry_t* entry, uint8_t subIndex, float64_t val, bool_t odOr
 void* OD_getPtr(const OD_entry_t* entry, uint8_t subIndex, OD_size_t len, ODR_t* err);
 /** @} */ /* CO_ODgetSetters */
 
+#if (OD_HANDLES > 0) || defined CO_DOXYGEN
+/**
+ * @defgroup CO_ODhandles Handles
+ * @{
+ *
+ * Resolved OD sub-entries for frequently accessed variables
+ *
+ * @ref OD_get_value() and @ref OD_set_value() search the OD entry, fill the stream and call read or write function on
+ * each access. Handle does @ref OD_find() and @ref OD_getSub() once and keeps the @ref OD_IO_t. If sub-entry has no IO
+ * extension, handle also keeps direct pointer to the variable, so typed accessors are a memcpy of the variable.
+ *
+ * Handles are linked into @ref OD_t. IO extensions are (re)initialized by CANopen objects on communication reset, so
+ * @ref CO_CANopenInit() and @ref CO_CANopenInitPDO() call @ref OD_rebindHandles() after objects are initialized.
+ *
+ * Handle accessors don't lock the OD, use @ref CO_LOCK_OD() like with other getters and setters, if necessary.
+ */
+
+/**
+ * Handle of OD sub-entry, see @ref CO_ODhandles
+ */
+typedef struct OD_handle {
+    OD_IO_t io;             /**< IO of the sub-entry, from @ref OD_getSub() */
+    void* data;             /**< Pointer to the variable, if it has no IO extension, NULL otherwise */
+    OD_t* od;               /**< Object Dictionary, from @ref OD_handle_init() */
+    OD_entry_t* entry;      /**< OD entry, from the last bind */
+    struct OD_handle* next; /**< Next handle in the list of od */
+    uint16_t index;         /**< OD index, from @ref OD_handle_init() */
+    uint8_t subIndex;       /**< OD sub-index, from @ref OD_handle_init() */
+    bool_t odOrig;          /**< Access original OD location, see @ref OD_getSub() */
+    ODR_t status;           /**< Result of the last bind, ODR_OK if handle is usable */
+} OD_handle_t;
+
+/**
+ * Initialize handle, link it into Object Dictionary and bind it to the sub-entry
+ *
+ * Handle may be initialized before the OD sub-entry becomes accessible, @ref OD_handle_t.status then holds the error
+ * and handle is bound again by @ref OD_rebindHandles(). Handle, which is already linked into the same od, may be
+ * initialized again. Before it is used on other od, it must be removed with @ref OD_handle_remove().
+ *
+ * @param handle Handle, owned by application, must stay valid until @ref OD_handle_remove()
+ * @param od Object Dictionary
+ * @param index OD index
+ * @param subIndex OD sub-index
+ * @param odOrig If true, then potential IO extension on entry will be ignored and access to data entry in the original
+ * OD location will be returned
+ *
+ * @return Value from @ref OD_getSub() or ODR_DEV_INCOMPAT in case of wrong arguments.
+ */
+ODR_t OD_handle_init(OD_handle_t* handle, OD_t* od, uint16_t index, uint8_t subIndex, bool_t odOrig);
+
+/**
+ * Bind handle to the current state of the OD sub-entry again
+ *
+ * @param handle Initialized handle
+ *
+ * @return Value from @ref OD_getSub(), also stored into @ref OD_handle_t.status
+ */
+ODR_t OD_handle_bind(OD_handle_t* handle);
+
+/**
+ * Unlink handle from the Object Dictionary
+ *
+ * @param handle Initialized handle
+ */
+void OD_handle_remove(OD_handle_t* handle);
+
+/**
+ * Bind all handles of the Object Dictionary again, called after OD extensions are initialized
+ *
+ * @param od Object Dictionary
+ */
+void OD_rebindHandles(OD_t* od);
+
+/**
+ * Read variable through IO of the handle, used by @ref OD_handle_get_value() for variables with IO extension
+ */
+ODR_t OD_handle_read(OD_handle_t* handle, void* val, OD_size_t len);
+
+/**
+ * Write variable through IO of the handle, used by @ref OD_handle_set_value() for variables with IO extension
+ */
+ODR_t OD_handle_write(OD_handle_t* handle, const void* val, OD_size_t len);
+
+/**
+ * Get variable through handle
+ *
+ * Same as @ref OD_get_value(), but without search of OD entry. Variables without IO extension are copied directly.
+ *
+ * @param handle Initialized handle
+ * @param [out] val Value will be written here
+ * @param len Size of value to retrieve, must match length of the variable
+ *
+ * @return Value from @ref ODR_t, "ODR_OK" in case of success, "ODR_TYPE_MISMATCH" if variable has different length.
+ */
+static inline ODR_t
+OD_handle_get_value(OD_handle_t* handle, void* val, OD_size_t len) {
+    if ((handle->data != NULL) && (handle->io.stream.dataLength == len)) {
+        (void)memcpy(val, handle->data, len);
+        return ODR_OK;
+    }
+    return OD_handle_read(handle, val, len);
+}
+
+/**
+ * Set variable through handle
+ *
+ * Same as @ref OD_set_value(), but without search of OD entry. Variables without IO extension are copied directly.
+ *
+ * @param handle Initialized handle
+ * @param val Pointer to value to write
+ * @param len Size of value to write, must match length of the variable
+ *
+ * @return Value from @ref ODR_t, "ODR_OK" in case of success, "ODR_TYPE_MISMATCH" if variable has different length.
+ */
+static inline ODR_t
+OD_handle_set_value(OD_handle_t* handle, const void* val, OD_size_t len) {
+    if ((handle->data != NULL) && (handle->io.stream.dataLength == len)) {
+        (void)memcpy(handle->data, val, len);
+        return ODR_OK;
+    }
+    return OD_handle_write(handle, val, len);
+}
+
+/** Get int8_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_i8(OD_handle_t* handle, int8_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get int16_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_i16(OD_handle_t* handle, int16_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get int32_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_i32(OD_handle_t* handle, int32_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get int64_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_i64(OD_handle_t* handle, int64_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get uint8_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_u8(OD_handle_t* handle, uint8_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get uint16_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_u16(OD_handle_t* handle, uint16_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get uint32_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_u32(OD_handle_t* handle, uint32_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get uint64_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_u64(OD_handle_t* handle, uint64_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get float32_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_f32(OD_handle_t* handle, float32_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Get float64_t variable through handle, see @ref OD_handle_get_value */
+static inline ODR_t
+OD_handle_get_f64(OD_handle_t* handle, float64_t* val) {
+    return OD_handle_get_value(handle, val, sizeof(*val));
+}
+
+/** Set int8_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_i8(OD_handle_t* handle, int8_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set int16_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_i16(OD_handle_t* handle, int16_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set int32_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_i32(OD_handle_t* handle, int32_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set int64_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_i64(OD_handle_t* handle, int64_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set uint8_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_u8(OD_handle_t* handle, uint8_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set uint16_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_u16(OD_handle_t* handle, uint16_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set uint32_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_u32(OD_handle_t* handle, uint32_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set uint64_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_u64(OD_handle_t* handle, uint64_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set float32_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_f32(OD_handle_t* handle, float32_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/** Set float64_t variable through handle, see @ref OD_handle_set_value */
+static inline ODR_t
+OD_handle_set_f64(OD_handle_t* handle, float64_t val) {
+    return OD_handle_set_value(handle, &val, sizeof(val));
+}
+
+/**
+ * Request TPDO, to which variable of the handle is mapped, see @ref OD_requestTPDO
+ *
+ * @param handle Handle.
+ */
+static inline void
+OD_handle_requestTPDO(OD_handle_t* handle) {
+    if ((handle != NULL) && (handle->status == ODR_OK)) {
+        OD_requestTPDO(handle->entry, handle->subIndex);
+    }
+}
+/** @} */ /* CO_ODhandles */
+#endif /* OD_HANDLES > 0 */
+
 #if defined OD_DEFINITION || defined CO_DOXYGEN
 /**
  * @defgroup CO_ODdefinition OD definition objects
@@ -30,6 +30,44 @@
 #endif
 #endif
 
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) == 0
+#error PDO copy plan is not possible without CO_CONFIG_PDO_OD_IO_ACCESS
+#endif
+#endif
+
+#if CO_RPDO_READY_WORDS > 0
+#if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_ENABLE) == 0
+#error Bitmap of received RPDOs is not possible without CO_CONFIG_RPDO_ENABLE
+#endif
+#if !defined CO_FLAG_BITS_SET || !defined CO_FLAG_BITS_TAKE
+#error Bitmap of received RPDOs requires CO_FLAG_BITS_SET() and CO_FLAG_BITS_TAKE() from CO_driver_target.h
+#endif
+#endif
+
+#if OD_TPDO_PENDING_WORDS > 0
+#if (((CO_CONFIG_PDO)&CO_CONFIG_TPDO_ENABLE) == 0) || (((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) == 0)
+#error Bitmap of pending TPDOs is not possible without CO_CONFIG_TPDO_ENABLE and CO_CONFIG_PDO_OD_IO_ACCESS
+#endif
+#endif
+
+#if OD_TPDO_PENDING_WORDS > 0
+/*
+ * Store extension of the OD entry mapped to the TPDO and register the TPDO in it
+ *
+ * Registration is not removed, if object is unmapped later. OD_requestTPDO() on such object then only causes one
+ * unnecessary visit of the TPDO.
+ */
+static void
+TPDO_mapExtension(CO_TPDO_t* TPDO, uint8_t mapIndex, OD_extension_t* extension) {
+    TPDO->mappedExt[mapIndex] = extension;
+    if ((extension != NULL) && (TPDO->pending != NULL) && (TPDO->pendingIndex < (OD_TPDO_PENDING_WORDS * 32U))) {
+        extension->TPDOpending = &TPDO->pending->pending[0];
+        extension->TPDOmask[TPDO->pendingIndex >> 5] |= 1UL << (TPDO->pendingIndex & 0x1FU);
+    }
+}
+#endif
+
 #if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0
 /*
  * Custom function for write dummy OD object. Will be used only from RPDO.
@@ -99,6 +137,12 @@ PDOconfigMap(CO_PDO_common_t* PDO, uint32_t map, uint8_t mapIndex, bool_t isRPDO
         stream->dataOffset = mappedLength;
         OD_IO->read = OD_read_dummy;
         OD_IO->write = OD_write_dummy;
+#if OD_TPDO_PENDING_WORDS > 0
+        if (!isRPDO) {
+            /* PDO_common is the first element of CO_TPDO_t */
+            TPDO_mapExtension((CO_TPDO_t*)PDO, mapIndex, NULL);
+        }
+#endif
         return ODR_OK;
     }
 
@@ -130,12 +174,61 @@ PDOconfigMap(CO_PDO_common_t* PDO, uint32_t map, uint8_t mapIndex, bool_t isRPDO
         } else {
             PDO->flagPDObyte[mapIndex] = NULL;
         }
+#if OD_TPDO_PENDING_WORDS > 0
+        TPDO_mapExtension((CO_TPDO_t*)PDO, mapIndex, entry->extension);
+#endif
     }
 #endif
 
     return ODR_OK;
 }
 
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0
+/*
+ * Build copy plan from mapped entries
+ *
+ * Mapped OD variables with original read/write functions, which are mapped whole, are copied directly from/to their
+ * memory. Adjacent variables, which follow each other in the PDO and in the memory, are merged into one step.
+ *
+ * @param PDO This object, mapping must be valid.
+ * @param isRPDO True for RPDO and false for TPDO.
+ */
+static void
+PDO_initCopyPlan(CO_PDO_common_t* PDO, bool_t isRPDO) {
+    CO_PDO_size_t offset = 0;
+
+    PDO->copyCount = 0;
+    for (uint8_t i = 0; i < PDO->mappedObjectsCount; i++) {
+        const OD_IO_t* OD_IO = &PDO->OD_IO[i];
+        const OD_stream_t* stream = &OD_IO->stream;
+        CO_PDO_size_t mappedLength = (CO_PDO_size_t)stream->dataOffset;
+        uint8_t* dataOD = NULL;
+
+        bool_t original = isRPDO ? (OD_IO->write == OD_writeOriginal) : (OD_IO->read == OD_readOriginal);
+        if (original && (stream->dataOrig != NULL) && (stream->dataLength == (OD_size_t)mappedLength)
+#ifdef CO_BIG_ENDIAN
+            && ((stream->attribute & ODA_MB) == 0U)
+#endif
+        ) {
+            dataOD = (uint8_t*)stream->dataOrig;
+        }
+
+        CO_PDO_copy_t* last = (PDO->copyCount > 0U) ? &PDO->copyPlan[PDO->copyCount - 1U] : NULL;
+        if ((dataOD != NULL) && (last != NULL) && (last->dataOD != NULL) && ((last->dataOD + last->length) == dataOD)) {
+            last->length += mappedLength;
+        } else {
+            CO_PDO_copy_t* copy = &PDO->copyPlan[PDO->copyCount];
+            copy->dataOD = dataOD;
+            copy->offset = offset;
+            copy->length = mappedLength;
+            copy->mapIndex = i;
+            PDO->copyCount++;
+        }
+        offset += mappedLength;
+    }
+}
+#endif /* (CO_CONFIG_PDO) & CO_CONFIG_PDO_COPY_PLAN */
+
 /*
  * Initialize PDO mapping parameters
  *
@@ -202,6 +295,9 @@ PDO_initMapping(CO_PDO_common_t* PDO, OD_t* OD, OD_entry_t* OD_PDOMapPar, bool_t
     if (*erroneousMap == 0U) {
         PDO->dataLength = (CO_PDO_size_t)pdoDataLength;
         PDO->mappedObjectsCount = mappedObjectsCount;
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0
+        PDO_initCopyPlan(PDO, isRPDO);
+#endif
     }
 
     return CO_ERROR_NO;
@@ -259,6 +355,9 @@ OD_write_PDO_mapping(OD_stream_t* stream, const void* buf, OD_size_t count, OD_s
         /* success, update PDO */
         PDO->dataLength = (CO_PDO_size_t)pdoDataLength;
         PDO->mappedObjectsCount = mappedObjectsCount;
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0
+        PDO_initCopyPlan(PDO, PDO->isRPDO);
+#endif
     } else {
         uint32_t val = CO_getUint32(buf);
         ODR_t odRet = PDOconfigMap(PDO, val, stream->subIndex - 1U, PDO->isRPDO, PDO->OD);
@@ -422,6 +521,16 @@ OD_read_PDO_commParam(OD_stream_t* stream, void* buf, OD_size_t count, OD_size_t
 
 /* @} */ /* CO_PDO_receiveErrors_t */
 
+#if CO_RPDO_READY_WORDS > 0
+/* Set bit of the RPDO in bitmap from CO_RPDO_ready_t, called from CAN receive */
+static void
+RPDO_setReady(CO_RPDO_t* RPDO, volatile uint32_t* bitmap) {
+    if (RPDO->readyIndex < (CO_RPDO_READY_WORDS * 32U)) {
+        CO_FLAG_BITS_SET(bitmap[RPDO->readyIndex >> 5], 1UL << (RPDO->readyIndex & 0x1FU));
+    }
+}
+#endif
+
 /*
  * Read received message from CAN module.
  *
@@ -440,8 +549,8 @@ CO_PDO_receive(void* object, void* msg) {
 
     if (PDO->valid) {
         if (DLC >= PDO->dataLength) {
-            /* indicate errors in PDO length */
-            if (DLC == PDO->dataLength) {
+            /* indicate errors in PDO length, CAN FD message may be padded */
+            if (DLC == CO_CAN_PADDED_LENGTH(PDO->dataLength)) {
                 if (err == CO_RPDO_RX_ACK_ERROR) {
                     err = CO_RPDO_RX_OK;
                 }
@@ -461,7 +570,19 @@ CO_PDO_receive(void* object, void* msg) {
 
             /* copy data into appropriate buffer and set 'new message' flag */
             (void)memcpy(RPDO->CANrxData[bufNo], data, CO_PDO_MAX_SIZE);
+#if ((CO_CONFIG_PDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+            RPDO->CANrxTimestamp_us[bufNo] = CO_CANrxMsg_readTimestamp(msg);
+#endif
             CO_FLAG_SET(RPDO->CANrxNew[bufNo]);
+#if CO_RPDO_READY_WORDS > 0
+            if (RPDO->ready != NULL) {
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_SYNC_ENABLE) != 0
+                RPDO_setReady(RPDO, RPDO->synchronous ? RPDO->ready->readySync[bufNo] : RPDO->ready->readyAsync);
+#else
+                RPDO_setReady(RPDO, RPDO->ready->readyAsync);
+#endif
+            }
+#endif
 
 #if ((CO_CONFIG_PDO)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
             /* Optional signal to RTOS, which can resume task, which handles the RPDO. */
@@ -475,7 +596,20 @@ CO_PDO_receive(void* object, void* msg) {
         }
     }
 
+#if CO_RPDO_READY_WORDS > 0
+    /* new length error must be reported by the processing */
+    bool_t errChanged = err != RPDO->receiveError;
     RPDO->receiveError = err;
+    if (errChanged && (RPDO->ready != NULL)) {
+        RPDO_setReady(RPDO, RPDO->ready->readyAsync);
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_SYNC_ENABLE) != 0
+        RPDO_setReady(RPDO, RPDO->ready->readySync[0]);
+        RPDO_setReady(RPDO, RPDO->ready->readySync[1]);
+#endif
+    }
+#else
+    RPDO->receiveError = err;
+#endif
 }
 
 #if ((CO_CONFIG_PDO)&CO_CONFIG_FLAG_OD_DYNAMIC) != 0
@@ -575,7 +709,14 @@ OD_write_14xx(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_t*
     }
 
     /* write value to the original location in the Object Dictionary */
-    return OD_writeOriginal(stream, bufCopy, count, countWritten);
+    ODR_t odRet = OD_writeOriginal(stream, bufCopy, count, countWritten);
+#if CO_RPDO_READY_WORDS > 0
+    /* visit RPDO with the new configuration */
+    if ((odRet == ODR_OK) && (RPDO->ready != NULL)) {
+        RPDO_setReady(RPDO, RPDO->ready->readyAsync);
+    }
+#endif
+    return odRet;
 }
 #endif /* (CO_CONFIG_PDO) & CO_CONFIG_FLAG_OD_DYNAMIC */
 
@@ -678,6 +819,8 @@ CO_RPDO_init(CO_RPDO_t* RPDO, OD_t* OD, CO_EM_t* em,
     PDO->CANdevIdx = CANdevRxIdx;
     PDO->preDefinedCanId = preDefinedCanId;
     PDO->configuredCanId = CAN_ID;
+    PDO->OD_communicationParam = OD_14xx_RPDOCommPar;
+    PDO->OD_mappingParam = OD_16xx_RPDOMapPar;
     PDO->OD_communicationParam_ext.object = RPDO;
     PDO->OD_communicationParam_ext.read = OD_read_PDO_commParam;
     PDO->OD_communicationParam_ext.write = OD_write_14xx;
@@ -701,6 +844,57 @@ CO_RPDO_initCallbackPre(CO_RPDO_t* RPDO, void* object, void (*pFunctSignalPre)(v
 }
 #endif
 
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0
+/*
+ * Write part of the received RPDO into mapped OD variable with OD_IO.write()
+ *
+ * @param OD_IO Object dictionary interface of the mapped entry.
+ * @param dataRPDO Received data of the entry, may be modified.
+ * @param mappedLength Number of bytes of the entry in RPDO.
+ */
+static void
+CO_RPDO_writeOD(OD_IO_t* OD_IO, uint8_t* dataRPDO, uint8_t mappedLength) {
+    OD_size_t* dataOffset = &OD_IO->stream.dataOffset;
+
+    /* length of OD variable may be larger than mappedLength */
+    OD_size_t ODdataLength = OD_IO->stream.dataLength;
+    if (ODdataLength > CO_PDO_MAX_SIZE) {
+        ODdataLength = CO_PDO_MAX_SIZE;
+    }
+    /* Prepare data for writing into OD variable. If mappedLength
+     * is smaller than ODdataLength, then use auxiliary buffer */
+    uint8_t buf[CO_PDO_MAX_SIZE];
+    uint8_t* dataOD;
+    if (ODdataLength > mappedLength) {
+        (void)memset(buf, 0, sizeof(buf));
+        (void)memcpy(buf, dataRPDO, mappedLength);
+        dataOD = buf;
+    } else {
+        dataOD = dataRPDO;
+    }
+
+    /* swap multibyte data if big-endian */
+#ifdef CO_BIG_ENDIAN
+    if ((OD_IO->stream.attribute & ODA_MB) != 0) {
+        uint8_t* lo = dataOD;
+        uint8_t* hi = dataOD + ODdataLength - 1;
+        while (lo < hi) {
+            uint8_t swap = *lo;
+            *lo++ = *hi;
+            *hi-- = swap;
+        }
+    }
+#endif
+
+    /* Set stream.dataOffset to zero, perform OD_IO.write()
+     * and store mappedLength back to stream.dataOffset */
+    *dataOffset = 0;
+    OD_size_t countWritten;
+    OD_IO->write(&OD_IO->stream, dataOD, ODdataLength, &countWritten);
+    *dataOffset = mappedLength;
+}
+#endif /* (CO_CONFIG_PDO) & CO_CONFIG_PDO_OD_IO_ACCESS */
+
 void
 CO_RPDO_process(CO_RPDO_t* RPDO,
 #if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_TIMERS_ENABLE) != 0
@@ -745,58 +939,41 @@ CO_RPDO_process(CO_RPDO_t* RPDO,
             /* Clear the flag. If between the copy operation CANrxNew is set
              * by receive thread, then copy the latest data again. */
             CO_FLAG_CLEAR(RPDO->CANrxNew[bufNo]);
+#if ((CO_CONFIG_PDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+            RPDO->timestamp_us = RPDO->CANrxTimestamp_us[bufNo];
+#endif
 
-#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0
-            for (uint8_t i = 0; i < PDO->mappedObjectsCount; i++) {
-                OD_IO_t* OD_IO = &PDO->OD_IO[i];
-
-                /* get mappedLength from temporary storage */
-                OD_size_t* dataOffset = &OD_IO->stream.dataOffset;
-                uint8_t mappedLength = (uint8_t)(*dataOffset);
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0
+            for (uint8_t i = 0; i < PDO->copyCount; i++) {
+                const CO_PDO_copy_t* copy = &PDO->copyPlan[i];
 
                 /* additional safety check. */
-                verifyLength += (OD_size_t)mappedLength;
+                verifyLength += (OD_size_t)copy->length;
                 if (verifyLength > CO_PDO_MAX_SIZE) {
                     break;
                 }
 
-                /* length of OD variable may be larger than mappedLength */
-                OD_size_t ODdataLength = OD_IO->stream.dataLength;
-                if (ODdataLength > CO_PDO_MAX_SIZE) {
-                    ODdataLength = CO_PDO_MAX_SIZE;
-                }
-                /* Prepare data for writing into OD variable. If mappedLength
-                 * is smaller than ODdataLength, then use auxiliary buffer */
-                uint8_t buf[CO_PDO_MAX_SIZE];
-                uint8_t* dataOD;
-                if (ODdataLength > mappedLength) {
-                    (void)memset(buf, 0, sizeof(buf));
-                    (void)memcpy(buf, dataRPDO, mappedLength);
-                    dataOD = buf;
+                if (copy->dataOD != NULL) {
+                    (void)memcpy(copy->dataOD, &dataRPDO[copy->offset], copy->length);
                 } else {
-                    dataOD = dataRPDO;
+                    CO_RPDO_writeOD(&PDO->OD_IO[copy->mapIndex], &dataRPDO[copy->offset], copy->length);
                 }
+            }
 
-                /* swap multibyte data if big-endian */
-#ifdef CO_BIG_ENDIAN
-                if ((OD_IO->stream.attribute & ODA_MB) != 0) {
-                    uint8_t* lo = dataOD;
-                    uint8_t* hi = dataOD + ODdataLength - 1;
-                    while (lo < hi) {
-                        uint8_t swap = *lo;
-                        *lo++ = *hi;
-                        *hi-- = swap;
-                    }
-                }
-#endif
+#elif ((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0
+            for (uint8_t i = 0; i < PDO->mappedObjectsCount; i++) {
+                OD_IO_t* OD_IO = &PDO->OD_IO[i];
+
+                /* get mappedLength from temporary storage */
+                uint8_t mappedLength = (uint8_t)OD_IO->stream.dataOffset;
 
-                /* Set stream.dataOffset to zero, perform OD_IO.write()
-                 * and store mappedLength back to stream.dataOffset */
-                *dataOffset = 0;
-                OD_size_t countWritten;
-                OD_IO->write(&OD_IO->stream, dataOD, ODdataLength, &countWritten);
-                *dataOffset = mappedLength;
+                /* additional safety check. */
+                verifyLength += (OD_size_t)mappedLength;
+                if (verifyLength > CO_PDO_MAX_SIZE) {
+                    break;
+                }
 
+                CO_RPDO_writeOD(OD_IO, dataRPDO, mappedLength);
                 dataRPDO += mappedLength;
             }
 
@@ -824,6 +1001,13 @@ CO_RPDO_process(CO_RPDO_t* RPDO,
                 }
                 /* enable monitoring */
                 RPDO->timeoutTimer = 1;
+#if ((CO_CONFIG_PDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+                /* measure timeout from reception of RPDO */
+                uint32_t age = CO_CANtimestampAge(RPDO->timestamp_us, CO_CANtimestampNow());
+                if (age < RPDO->timeoutTime_us) {
+                    RPDO->timeoutTimer += age;
+                }
+#endif
             } else if ((RPDO->timeoutTimer > 0U) && (RPDO->timeoutTimer < RPDO->timeoutTime_us)) {
                 RPDO->timeoutTimer += timeDifference_us;
 
@@ -860,7 +1044,38 @@ CO_RPDO_process(CO_RPDO_t* RPDO,
 #endif
 #endif
     }
+
+#if CO_RPDO_READY_WORDS > 0
+    /* RPDO is idle, if it has nothing to do until next reception */
+    if ((RPDO->ready != NULL) && (RPDO->readyIndex < (CO_RPDO_READY_WORDS * 32U))) {
+        bool_t idle = RPDO->receiveError <= CO_RPDO_RX_ACK;
+#if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_TIMERS_ENABLE) != 0
+        if ((RPDO->timeoutTime_us > 0U) && (RPDO->timeoutTimer > 0U) && (RPDO->timeoutTimer < RPDO->timeoutTime_us)) {
+            idle = false; /* timeout monitoring runs */
+        }
+#endif
+        uint32_t* active = &RPDO->ready->active[RPDO->readyIndex >> 5];
+        uint32_t mask = 1UL << (RPDO->readyIndex & 0x1FU);
+        *active = idle ? (*active & ~mask) : (*active | mask);
+    }
+#endif
+}
+
+#if CO_RPDO_READY_WORDS > 0
+void
+CO_RPDO_initReady(CO_RPDO_t* RPDO, CO_RPDO_ready_t* ready, uint16_t index) {
+    if (RPDO == NULL) {
+        return;
+    }
+
+    RPDO->readyIndex = index;
+    RPDO->ready = ready;
+    if ((ready != NULL) && (index < (CO_RPDO_READY_WORDS * 32U))) {
+        /* first CO_process_RPDO() decides, if RPDO is idle */
+        ready->active[index >> 5] |= 1UL << (index & 0x1FU);
+    }
 }
+#endif
 #endif /* (CO_CONFIG_PDO) & CO_CONFIG_RPDO_ENABLE */
 
 /*******************************************************************************
@@ -981,7 +1196,14 @@ OD_write_18xx(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_t*
     }
 
     /* write value to the original location in the Object Dictionary */
-    return OD_writeOriginal(stream, bufCopy, count, countWritten);
+    ODR_t odRet = OD_writeOriginal(stream, bufCopy, count, countWritten);
+#if OD_TPDO_PENDING_WORDS > 0
+    /* TPDO may become active */
+    if (odRet == ODR_OK) {
+        CO_TPDO_setPending(TPDO);
+    }
+#endif
+    return odRet;
 }
 #endif /* (CO_CONFIG_PDO) & CO_CONFIG_FLAG_OD_DYNAMIC */
 
@@ -1100,6 +1322,8 @@ CO_TPDO_init(CO_TPDO_t* TPDO, OD_t* OD, CO_EM_t* em,
     PDO->CANdevIdx = CANdevTxIdx;
     PDO->preDefinedCanId = preDefinedCanId;
     PDO->configuredCanId = CAN_ID;
+    PDO->OD_communicationParam = OD_18xx_TPDOCommPar;
+    PDO->OD_mappingParam = OD_1Axx_TPDOMapPar;
     PDO->OD_communicationParam_ext.object = TPDO;
     PDO->OD_communicationParam_ext.read = OD_read_PDO_commParam;
     PDO->OD_communicationParam_ext.write = OD_write_18xx;
@@ -1113,6 +1337,59 @@ CO_TPDO_init(CO_TPDO_t* TPDO, OD_t* OD, CO_EM_t* em,
     return CO_ERROR_NO;
 }
 
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0
+/*
+ * Read mapped OD variable with OD_IO.read() into part of the TPDO
+ *
+ * @param OD_IO Object dictionary interface of the mapped entry.
+ * @param dataTPDO TPDO data of the entry.
+ * @param mappedLength Number of bytes of the entry in TPDO.
+ */
+static void
+CO_TPDO_readOD(OD_IO_t* OD_IO, uint8_t* dataTPDO, uint8_t mappedLength) {
+    OD_stream_t* stream = &OD_IO->stream;
+
+    /* length of OD variable may be larger than mappedLength */
+    OD_size_t ODdataLength = stream->dataLength;
+    if (ODdataLength > CO_PDO_MAX_SIZE) {
+        ODdataLength = CO_PDO_MAX_SIZE;
+    }
+    /* If mappedLength is smaller than ODdataLength, use auxiliary buffer */
+    uint8_t buf[CO_PDO_MAX_SIZE];
+    uint8_t* dataTPDOCopy;
+    if (ODdataLength > mappedLength) {
+        (void)memset(buf, 0, sizeof(buf));
+        dataTPDOCopy = buf;
+    } else {
+        dataTPDOCopy = dataTPDO;
+    }
+
+    /* Set stream.dataOffset to zero, perform OD_IO.read() and store mappedLength back to stream.dataOffset */
+    stream->dataOffset = 0;
+    OD_size_t countRd;
+    OD_IO->read(stream, dataTPDOCopy, ODdataLength, &countRd);
+    stream->dataOffset = mappedLength;
+
+    /* swap multibyte data if big-endian */
+#ifdef CO_BIG_ENDIAN
+    if ((stream->attribute & ODA_MB) != 0) {
+        uint8_t* lo = dataTPDOCopy;
+        uint8_t* hi = dataTPDOCopy + ODdataLength - 1;
+        while (lo < hi) {
+            uint8_t swap = *lo;
+            *lo++ = *hi;
+            *hi-- = swap;
+        }
+    }
+#endif
+
+    /* If auxiliary buffer, copy it to the TPDO */
+    if (ODdataLength > mappedLength) {
+        (void)memcpy(dataTPDO, buf, mappedLength);
+    }
+}
+#endif /* (CO_CONFIG_PDO) & CO_CONFIG_PDO_OD_IO_ACCESS */
+
 /*
  * Send TPDO message.
  *
@@ -1134,59 +1411,49 @@ CO_TPDOsend(CO_TPDO_t* TPDO) {
                           || (TPDO->transmissionType >= (uint8_t)CO_PDO_TRANSM_TYPE_SYNC_EVENT_LO));
 #endif
 
-#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0
-    for (uint8_t i = 0; i < PDO->mappedObjectsCount; i++) {
-        OD_IO_t* OD_IO = &PDO->OD_IO[i];
-        OD_stream_t* stream = &OD_IO->stream;
-
-        /* get mappedLength from temporary storage */
-        uint8_t mappedLength = (uint8_t)stream->dataOffset;
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0
+    for (uint8_t i = 0; i < PDO->copyCount; i++) {
+        const CO_PDO_copy_t* copy = &PDO->copyPlan[i];
 
         /* additional safety check */
-        verifyLength += (OD_size_t)mappedLength;
+        verifyLength += (OD_size_t)copy->length;
         if (verifyLength > CO_PDO_MAX_SIZE) {
             break;
         }
 
-        /* length of OD variable may be larger than mappedLength */
-        OD_size_t ODdataLength = stream->dataLength;
-        if (ODdataLength > CO_PDO_MAX_SIZE) {
-            ODdataLength = CO_PDO_MAX_SIZE;
-        }
-        /* If mappedLength is smaller than ODdataLength, use auxiliary buffer */
-        uint8_t buf[CO_PDO_MAX_SIZE];
-        uint8_t* dataTPDOCopy;
-        if (ODdataLength > mappedLength) {
-            (void)memset(buf, 0, sizeof(buf));
-            dataTPDOCopy = buf;
+        if (copy->dataOD != NULL) {
+            (void)memcpy(&dataTPDO[copy->offset], copy->dataOD, copy->length);
         } else {
-            dataTPDOCopy = dataTPDO;
+            CO_TPDO_readOD(&PDO->OD_IO[copy->mapIndex], &dataTPDO[copy->offset], copy->length);
         }
+    }
 
-        /* Set stream.dataOffset to zero, perform OD_IO.read() and store mappedLength back to stream.dataOffset */
-        stream->dataOffset = 0;
-        OD_size_t countRd;
-        OD_IO->read(stream, dataTPDOCopy, ODdataLength, &countRd);
-        stream->dataOffset = mappedLength;
-
-        /* swap multibyte data if big-endian */
-#ifdef CO_BIG_ENDIAN
-        if ((stream->attribute & ODA_MB) != 0) {
-            uint8_t* lo = dataTPDOCopy;
-            uint8_t* hi = dataTPDOCopy + ODdataLength - 1;
-            while (lo < hi) {
-                uint8_t swap = *lo;
-                *lo++ = *hi;
-                *hi-- = swap;
+    /* In event driven TPDO indicate transmission of OD variables */
+#if OD_FLAGS_PDO_SIZE > 0
+    if (eventDriven) {
+        for (uint8_t i = 0; i < PDO->mappedObjectsCount; i++) {
+            uint8_t* flagPDObyte = PDO->flagPDObyte[i];
+            if (flagPDObyte != NULL) {
+                *flagPDObyte |= PDO->flagPDObitmask[i];
             }
         }
+    }
 #endif
+#elif ((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0
+    for (uint8_t i = 0; i < PDO->mappedObjectsCount; i++) {
+        OD_IO_t* OD_IO = &PDO->OD_IO[i];
 
-        /* If auxiliary buffer, copy it to the TPDO */
-        if (ODdataLength > mappedLength) {
-            (void)memcpy(dataTPDO, buf, mappedLength);
+        /* get mappedLength from temporary storage */
+        uint8_t mappedLength = (uint8_t)OD_IO->stream.dataOffset;
+
+        /* additional safety check */
+        verifyLength += (OD_size_t)mappedLength;
+        if (verifyLength > CO_PDO_MAX_SIZE) {
+            break;
         }
 
+        CO_TPDO_readOD(OD_IO, dataTPDO, mappedLength);
+
         /* In event driven TPDO indicate transmission of OD variable */
 #if OD_FLAGS_PDO_SIZE > 0
         uint8_t* flagPDObyte = PDO->flagPDObyte[i];
@@ -1351,6 +1618,202 @@ CO_TPDO_process(CO_TPDO_t* TPDO,
         TPDO->syncCounter = 255;
 #endif
     }
+
+#if OD_TPDO_PENDING_WORDS > 0
+    /* Is TPDO idle, with nothing to do until it is marked pending? */
+    if ((TPDO->pending != NULL) && (TPDO->pendingIndex < (OD_TPDO_PENDING_WORDS * 32U))) {
+        bool_t idle = !(PDO->valid && NMTisOperational);
+        if (!idle && !TPDO->sendRequest
+            && ((TPDO->transmissionType == (uint8_t)CO_PDO_TRANSM_TYPE_SYNC_ACYCLIC)
+                || (TPDO->transmissionType >= (uint8_t)CO_PDO_TRANSM_TYPE_SYNC_EVENT_LO))) {
+            idle = true;
+#if ((CO_CONFIG_PDO)&CO_CONFIG_TPDO_TIMERS_ENABLE) != 0
+            idle = (TPDO->eventTime_us == 0U) && (TPDO->inhibitTimer == 0U);
+#endif
+        }
+        uint32_t* active = &TPDO->pending->active[TPDO->pendingIndex >> 5];
+        uint32_t mask = 1UL << (TPDO->pendingIndex & 0x1FU);
+        *active = idle ? (*active & ~mask) : (*active | mask);
+    }
+#endif
+}
+
+#if OD_TPDO_PENDING_WORDS > 0
+void
+CO_TPDO_initPending(CO_TPDO_t* TPDO, CO_TPDO_pending_t* pending, uint16_t index) {
+    if (TPDO == NULL) {
+        return;
+    }
+
+    TPDO->pending = pending;
+    TPDO->pendingIndex = index;
+    for (uint8_t i = 0; i < TPDO->PDO_common.mappedObjectsCount; i++) {
+        TPDO_mapExtension(TPDO, i, TPDO->mappedExt[i]);
+    }
+    if ((pending != NULL) && (index < (OD_TPDO_PENDING_WORDS * 32U))) {
+        /* first CO_process_TPDO() decides, if TPDO is idle */
+        pending->active[index >> 5] |= 1UL << (index & 0x1FU);
+        CO_TPDO_setPending(TPDO);
+    }
 }
+#endif
 #endif /* (CO_CONFIG_PDO) & CO_CONFIG_TPDO_ENABLE */
+
+#if ((CO_CONFIG_PDO)&CO_CONFIG_FLAG_OD_DYNAMIC) != 0
+ODR_t
+CO_PDO_getConfig(CO_PDO_common_t* PDO, CO_PDO_config_t* config) {
+    if ((PDO == NULL) || (config == NULL) || (PDO->OD_communicationParam == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    OD_entry_t* commPar = PDO->OD_communicationParam;
+    OD_entry_t* mapPar = PDO->OD_mappingParam;
+    (void)memset(config, 0, sizeof(CO_PDO_config_t));
+
+    /* COB-ID through the extension, which adds node-id and bit 31 */
+    ODR_t odRet = OD_get_u32(commPar, 1, &config->COB_ID, false);
+    if (odRet == ODR_OK) {
+        odRet = OD_get_u8(commPar, 2, &config->transmissionType, true);
+    }
+    if (odRet == ODR_OK) {
+        odRet = OD_get_u8(mapPar, 0, &config->mappedObjectsCount, true);
+    }
+    if ((odRet == ODR_OK) && (config->mappedObjectsCount > CO_PDO_MAX_MAPPED_ENTRIES)) {
+        odRet = ODR_MAP_LEN;
+    }
+    for (uint8_t i = 0; (odRet == ODR_OK) && (i < config->mappedObjectsCount); i++) {
+        odRet = OD_get_u32(mapPar, i + 1U, &config->map[i], true);
+    }
+
+    /* optional parameters */
+    if (!PDO->isRPDO) {
+        (void)OD_get_u16(commPar, 3, &config->inhibitTime, true);
+        (void)OD_get_u8(commPar, 6, &config->syncStartValue, true);
+    }
+    (void)OD_get_u16(commPar, 5, &config->eventTimer, true);
+
+    return odRet;
+}
+
+/*
+ * Write one PDO parameter through the OD extension
+ *
+ * @param entry OD entry of the communication or mapping parameter.
+ * @param subIndex Sub-index.
+ * @param value Value.
+ * @param size Size of the OD variable, 1, 2 or 4.
+ * @param [out] errInfo Index and sub-index in case of error, may be NULL.
+ *
+ * @return ODR_OK on success, otherwise error reason.
+ */
+static ODR_t
+PDO_writeParam(OD_entry_t* entry, uint8_t subIndex, uint32_t value, uint8_t size, uint32_t* errInfo) {
+    ODR_t odRet;
+
+    if (size == 1U) {
+        odRet = OD_set_u8(entry, subIndex, (uint8_t)value, false);
+    } else if (size == 2U) {
+        odRet = OD_set_u16(entry, subIndex, (uint16_t)value, false);
+    } else {
+        odRet = OD_set_u32(entry, subIndex, value, false);
+    }
+
+    if ((odRet != ODR_OK) && (errInfo != NULL)) {
+        *errInfo = (((uint32_t)OD_getIndex(entry)) << 8) | subIndex;
+    }
+    return odRet;
+}
+
+/*
+ * Write complete PDO configuration, see CO_PDO_configure()
+ *
+ * @param PDO This object.
+ * @param config New configuration.
+ * @param [out] errInfo Index and sub-index in case of error, may be NULL.
+ *
+ * @return ODR_OK on success, otherwise error reason.
+ */
+static ODR_t
+PDO_writeConfig(CO_PDO_common_t* PDO, const CO_PDO_config_t* config, uint32_t* errInfo) {
+    OD_entry_t* commPar = PDO->OD_communicationParam;
+    OD_entry_t* mapPar = PDO->OD_mappingParam;
+    CO_PDO_config_t current;
+
+    (void)CO_PDO_getConfig(PDO, &current);
+
+    /* Disable the PDO without changing its CAN buffer, it is configured once, when COB-ID is written at the end. */
+    PDO->valid = false;
+
+    ODR_t odRet = PDO_writeParam(mapPar, 0, 0, 1, errInfo);
+    for (uint8_t i = 0; (odRet == ODR_OK) && (i < config->mappedObjectsCount); i++) {
+        odRet = PDO_writeParam(mapPar, i + 1U, config->map[i], 4, errInfo);
+    }
+    if (odRet == ODR_OK) {
+        odRet = PDO_writeParam(mapPar, 0, config->mappedObjectsCount, 1, errInfo);
+    }
+
+    /* write only changed communication parameters, writes reset timers and SYNC counter */
+    if ((odRet == ODR_OK) && (config->transmissionType != current.transmissionType)) {
+        odRet = PDO_writeParam(commPar, 2, config->transmissionType, 1, errInfo);
+    }
+    if ((odRet == ODR_OK) && !PDO->isRPDO && (config->inhibitTime != current.inhibitTime)) {
+        odRet = PDO_writeParam(commPar, 3, config->inhibitTime, 2, errInfo);
+    }
+    if ((odRet == ODR_OK) && (config->eventTimer != current.eventTimer)) {
+        odRet = PDO_writeParam(commPar, 5, config->eventTimer, 2, errInfo);
+    }
+    if ((odRet == ODR_OK) && !PDO->isRPDO && (config->syncStartValue != current.syncStartValue)) {
+        odRet = PDO_writeParam(commPar, 6, config->syncStartValue, 1, errInfo);
+    }
+
+    if (odRet == ODR_OK) {
+        odRet = PDO_writeParam(commPar, 1, config->COB_ID, 4, errInfo);
+    }
+    return odRet;
+}
+
+ODR_t
+CO_PDO_configure(CO_PDO_common_t* PDO, const CO_PDO_config_t* config, uint32_t* errInfo) {
+    if ((PDO == NULL) || (config == NULL) || (PDO->OD_communicationParam == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+    if (config->mappedObjectsCount > CO_PDO_MAX_MAPPED_ENTRIES) {
+        return ODR_MAP_LEN;
+    }
+
+    CO_PDO_config_t previous;
+
+    CO_LOCK_OD(PDO->CANdev);
+    ODR_t odRet = CO_PDO_getConfig(PDO, &previous);
+    bool_t remapped = true;
+    if (odRet == ODR_OK) {
+        remapped = (config->COB_ID != previous.COB_ID) || (config->mappedObjectsCount != previous.mappedObjectsCount)
+                   || (memcmp(config->map, previous.map, sizeof(config->map[0]) * config->mappedObjectsCount) != 0);
+        odRet = PDO_writeConfig(PDO, config, errInfo);
+        if (odRet != ODR_OK) {
+            /* restore previous configuration, PDO stays disabled, if that is not possible */
+            remapped = true;
+            if (PDO_writeConfig(PDO, &previous, NULL) != ODR_OK) {
+                PDO->valid = false;
+            }
+        }
+    }
+
+#if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_ENABLE) != 0
+    /* data of the received RPDO belong to the previous configuration */
+    if (PDO->isRPDO && remapped) {
+        CO_RPDO_t* RPDO = (CO_RPDO_t*)PDO;
+        CO_FLAG_CLEAR(RPDO->CANrxNew[0]);
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_SYNC_ENABLE) != 0
+        CO_FLAG_CLEAR(RPDO->CANrxNew[1]);
+#endif
+    }
+#else
+    (void)remapped;
+#endif
+    CO_UNLOCK_OD(PDO->CANdev);
+
+    return odRet;
+}
+#endif /* (CO_CONFIG_PDO) & CO_CONFIG_FLAG_OD_DYNAMIC */
 #endif /* (CO_CONFIG_PDO) & (CO_CONFIG_RPDO_ENABLE | CO_CONFIG_TPDO_ENABLE) */
@@ -30,7 +30,7 @@
 #define CO_CONFIG_PDO                                                                                                  \
     (CO_CONFIG_RPDO_ENABLE | CO_CONFIG_TPDO_ENABLE | CO_CONFIG_RPDO_TIMERS_ENABLE | CO_CONFIG_TPDO_TIMERS_ENABLE       \
      | CO_CONFIG_PDO_SYNC_ENABLE | CO_CONFIG_PDO_OD_IO_ACCESS | CO_CONFIG_GLOBAL_RT_FLAG_CALLBACK_PRE                  \
-     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC | CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP)
 #endif
 
 #if (((CO_CONFIG_PDO) & (CO_CONFIG_RPDO_ENABLE | CO_CONFIG_TPDO_ENABLE)) != 0) || defined CO_DOXYGEN
@@ -101,9 +101,14 @@ extern "C" {
  * - Configure mapping
  * - Enable mapping by setting PDO mapping param, sub 0 to number of mapped objects
  * - Enable the PDO by setting bit-31 to 0 in PDO communication parameter, COB-ID
+ *
+ * With CO_CONFIG_FLAG_OD_DYNAMIC the application may also switch the complete configuration of own PDO at once with
+ * CO_PDO_configure(), for example when changing the operating mode of the drive. The same procedure is used there, but
+ * inside one CO_LOCK_OD() section and without releasing the CAN buffer, so PDO processing never sees partial
+ * configuration. For remote devices, see @ref CO_PDOremap.
  */
 
-/** Maximum size of PDO message, 8 for standard CAN */
+/** Maximum size of PDO message, 8 for standard CAN, up to 64 for CAN FD */
 #ifndef CO_PDO_MAX_SIZE
 #define CO_PDO_MAX_SIZE 8U
 #endif
@@ -129,6 +134,13 @@ extern "C" {
 #define CO_TPDO_DEFAULT_CANID_COUNT 4U
 #endif
 
+/** Size of the bitmaps of received RPDOs in 32-bit words, 0 to disable. If enabled, CO_process_RPDO() visits only
+ * RPDOs, which received a message or need timeout monitoring, see @ref CO_RPDO_ready_t. RPDOs above 32 *
+ * CO_RPDO_READY_WORDS are visited on each call. Driver must provide CO_FLAG_BITS_SET() and CO_FLAG_BITS_TAKE(). */
+#ifndef CO_RPDO_READY_WORDS
+#define CO_RPDO_READY_WORDS 0
+#endif
+
 #ifndef CO_PDO_OWN_TYPES
 /** Variable of type CO_PDO_size_t contains data length in bytes of PDO */
 typedef uint8_t CO_PDO_size_t;
@@ -146,6 +158,36 @@ typedef enum {
                                                  specific) */
 } CO_PDO_transmissionTypes_t;
 
+/**
+ * Complete PDO configuration, communication and mapping parameters, used by CO_PDO_configure() and @ref CO_PDOremap.
+ */
+typedef struct {
+    uint32_t COB_ID; /**< Communication parameter, sub 1. Bit 31 set disables the PDO. Pre-defined CAN-ID includes
+                        node-id, see @ref CO_PDO_CAN_ID. */
+    uint8_t transmissionType;                /**< Communication parameter, sub 2 */
+    uint16_t inhibitTime;                    /**< Communication parameter, sub 3, TPDO only, in 100 µs */
+    uint16_t eventTimer;                     /**< Communication parameter, sub 5, in ms */
+    uint8_t syncStartValue;                  /**< Communication parameter, sub 6, TPDO only */
+    uint8_t mappedObjectsCount;              /**< Mapping parameter, sub 0 */
+    uint32_t map[CO_PDO_MAX_MAPPED_ENTRIES]; /**< Mapping parameter, sub 1 to mappedObjectsCount */
+} CO_PDO_config_t;
+
+#if (((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0) || defined CO_DOXYGEN
+/**
+ * One step of the PDO copy plan, see CO_CONFIG_PDO_COPY_PLAN in @ref CO_STACK_CONFIG_SYNC_PDO.
+ *
+ * Step copies length bytes between PDO data at offset and OD variables in memory at dataOD. Mapped variables, which
+ * are adjacent in the PDO and in the memory, share one step. If dataOD is NULL, step is one mapped entry, accessed
+ * with read() or write() of OD_IO[mapIndex].
+ */
+typedef struct {
+    uint8_t* dataOD;      /**< Memory of OD variables or NULL for OD_IO access */
+    CO_PDO_size_t offset; /**< Position in the PDO data */
+    CO_PDO_size_t length; /**< Number of bytes */
+    uint8_t mapIndex;     /**< First mapped entry of the step */
+} CO_PDO_copy_t;
+#endif
+
 /**
  * PDO object, common properties
  */
@@ -168,6 +210,11 @@ typedef struct {
                                                           OD_extension_t */
     uint8_t flagPDObitmask[CO_PDO_MAX_MAPPED_ENTRIES]; /**< Bitmask for the flagPDObyte */
 #endif
+#if (((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0) || defined CO_DOXYGEN
+    CO_PDO_copy_t copyPlan[CO_PDO_MAX_MAPPED_ENTRIES]; /**< Copy plan, built from the mapping, when mapping is
+                                                          initialized or changed */
+    uint8_t copyCount;                                 /**< Number of steps in copyPlan */
+#endif
 #else
     /* Pointers to data objects inside OD, where PDO will be copied */
     uint8_t* mapPointer[CO_PDO_MAX_SIZE];
@@ -182,11 +229,49 @@ typedef struct {
     uint16_t CANdevIdx;                       /**< From CO_xPDO_init() */
     uint16_t preDefinedCanId;                 /**< From CO_xPDO_init() */
     uint16_t configuredCanId;                 /**< Currently configured CAN identifier */
+    OD_entry_t* OD_communicationParam;        /**< From CO_xPDO_init() */
+    OD_entry_t* OD_mappingParam;              /**< From CO_xPDO_init() */
     OD_extension_t OD_communicationParam_ext; /**< Extension for OD object */
     OD_extension_t OD_mappingParam_extension; /**< Extension for OD object */
 #endif
 } CO_PDO_common_t;
 
+#if (((CO_CONFIG_PDO)&CO_CONFIG_FLAG_OD_DYNAMIC) != 0) || defined CO_DOXYGEN
+/**
+ * Read current configuration of the PDO.
+ *
+ * @param PDO RPDO or TPDO object, PDO_common member.
+ * @param [out] config Configuration. COB-ID includes node-id and bit 31, if PDO is not valid. Unused map entries and
+ * parameters, which don't exist in the Object Dictionary, are zero.
+ *
+ * @return ODR_OK on success, otherwise error reason.
+ */
+ODR_t CO_PDO_getConfig(CO_PDO_common_t* PDO, CO_PDO_config_t* config);
+
+/**
+ * Switch complete configuration of the PDO in one step.
+ *
+ * Communication and mapping parameters are written to the Object Dictionary through the same checks as by SDO
+ * writes, in the order required for dynamic PDO configuration. Everything is done inside CO_LOCK_OD(), so
+ * CO_RPDO_process() and CO_TPDO_process() see either the previous or the new configuration. CAN buffer of the PDO is
+ * re-initialized only once, at the end. Communication parameters, which are not changed, are not written, so SYNC
+ * counter and timers of the TPDO continue, if only the mapping is changed. Received, but not yet processed RPDO is
+ * discarded, if the mapping or COB-ID is changed.
+ *
+ * If any parameter is rejected, previous configuration is restored. If that is not possible, PDO stays disabled.
+ *
+ * Function must not be called inside CO_LOCK_OD(). Configuration is not stored to non-volatile memory.
+ *
+ * @param PDO RPDO or TPDO object, PDO_common member.
+ * @param config New configuration. inhibitTime and syncStartValue are ignored for RPDO.
+ * @param [out] errInfo In case of error, index and sub-index of the rejected parameter, (index << 8) | subIndex.
+ * May be NULL.
+ *
+ * @return ODR_OK on success, otherwise error reason, which may be converted to SDO abort code with OD_getSDOabCode().
+ */
+ODR_t CO_PDO_configure(CO_PDO_common_t* PDO, const CO_PDO_config_t* config, uint32_t* errInfo);
+#endif /* (CO_CONFIG_PDO) & CO_CONFIG_FLAG_OD_DYNAMIC */
+
 /*******************************************************************************
  *      R P D O
  ******************************************************************************/
@@ -200,6 +285,23 @@ typedef struct {
 #define CO_RPDO_CAN_BUFFERS_COUNT 1
 #endif
 
+#if (CO_RPDO_READY_WORDS > 0) || defined CO_DOXYGEN
+/**
+ * Bitmaps of RPDOs of one CANopen device, which CO_process_RPDO() has to visit, see @ref CO_RPDO_READY_WORDS.
+ *
+ * Bit number i % 32 in word i / 32 belongs to RPDO with index i. CO_PDO_receive() sets the bit in the same CAN receive
+ * buffer, to which the message was copied, with CO_FLAG_BITS_SET(). Processing takes the bitmaps with
+ * CO_FLAG_BITS_TAKE(). Synchronous RPDOs have own bitmap for each of the two SYNC buffers, it is taken after the SYNC,
+ * which makes the buffer relevant.
+ */
+typedef struct {
+    volatile uint32_t readyAsync[CO_RPDO_READY_WORDS];   /**< Received event driven RPDOs */
+    volatile uint32_t readySync[2][CO_RPDO_READY_WORDS]; /**< Received synchronous RPDOs, for each SYNC buffer */
+    uint32_t active[CO_RPDO_READY_WORDS]; /**< RPDOs, which were not idle after last processing, timeout monitoring */
+    bool_t NMTisOperational; /**< NMT state from last CO_process_RPDO(), all RPDOs are visited on change */
+} CO_RPDO_ready_t;
+#endif
+
 /**
  * RPDO object.
  */
@@ -209,6 +311,11 @@ typedef struct {
     uint8_t CANrxData[CO_RPDO_CAN_BUFFERS_COUNT][CO_PDO_MAX_SIZE]; /**< CO_PDO_MAX_SIZE data bytes of the received
                                                                       message. */
     uint8_t receiveError; /**< Indication of RPDO length errors, use with CO_PDO_receiveErrors_t */
+#if (((CO_CONFIG_PDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0) || defined CO_DOXYGEN
+    uint64_t CANrxTimestamp_us[CO_RPDO_CAN_BUFFERS_COUNT]; /**< Receive timestamps of messages in CANrxData */
+    uint64_t timestamp_us; /**< Receive timestamp of the RPDO, which was last written into OD variables, from
+                              CO_CANrxMsg_readTimestamp(). 0 if not available. */
+#endif
 #if (((CO_CONFIG_PDO)&CO_CONFIG_PDO_SYNC_ENABLE) != 0) || defined CO_DOXYGEN
     CO_SYNC_t* SYNC;    /**< From CO_RPDO_init() */
     bool_t synchronous; /**< True if transmissionType <= 240 */
@@ -222,6 +329,10 @@ typedef struct {
     void (*pFunctSignalPre)(void* object); /**< From CO_RPDO_initCallbackPre() or NULL */
     void* functSignalObjectPre;            /**< From CO_RPDO_initCallbackPre() or NULL */
 #endif
+#if (CO_RPDO_READY_WORDS > 0) || defined CO_DOXYGEN
+    CO_RPDO_ready_t* ready; /**< From CO_RPDO_initReady() or NULL */
+    uint16_t readyIndex;    /**< From CO_RPDO_initReady() */
+#endif
 } CO_RPDO_t;
 
 /**
@@ -265,6 +376,19 @@ CO_ReturnError_t CO_RPDO_init(CO_RPDO_t* RPDO, OD_t* OD, CO_EM_t* em,
 void CO_RPDO_initCallbackPre(CO_RPDO_t* RPDO, void* object, void (*pFunctSignalPre)(void* object));
 #endif
 
+#if (CO_RPDO_READY_WORDS > 0) || defined CO_DOXYGEN
+/**
+ * Link RPDO with the bitmaps of received RPDOs.
+ *
+ * Function must be called after CO_RPDO_init(), before CAN reception starts.
+ *
+ * @param RPDO This object.
+ * @param ready Bitmaps of received RPDOs of the CANopen device, may be NULL to unlink the RPDO.
+ * @param index Index of the RPDO in the device, 0 for the first RPDO.
+ */
+void CO_RPDO_initReady(CO_RPDO_t* RPDO, CO_RPDO_ready_t* ready, uint16_t index);
+#endif
+
 /**
  * Process received PDO messages.
  *
@@ -289,6 +413,22 @@ void CO_RPDO_process(CO_RPDO_t* RPDO,
  *      T P D O
  ******************************************************************************/
 #if (((CO_CONFIG_PDO)&CO_CONFIG_TPDO_ENABLE) != 0) || defined CO_DOXYGEN
+#if (OD_TPDO_PENDING_WORDS > 0) || defined CO_DOXYGEN
+/**
+ * Bitmaps of TPDOs of one CANopen device, which CO_process_TPDO() has to visit, see @ref OD_TPDO_PENDING_WORDS.
+ *
+ * Bit number i % 32 in word i / 32 belongs to TPDO with index i. Event driven TPDO without request, event timer and
+ * inhibit time running is idle. It is visited only, when OD_requestTPDO() on its mapped object, CO_TPDOsendRequest()
+ * or write to its communication parameter sets its pending bit. Other TPDOs are active and are visited on each call.
+ * TPDOs with index above the bitmap are always visited.
+ */
+typedef struct {
+    volatile uint32_t pending[OD_TPDO_PENDING_WORDS]; /**< TPDOs with request since last CO_process_TPDO() */
+    uint32_t active[OD_TPDO_PENDING_WORDS];           /**< TPDOs, which were not idle after last processing */
+    bool_t NMTisOperational; /**< NMT state from last CO_process_TPDO(), all TPDOs are visited on change */
+} CO_TPDO_pending_t;
+#endif
+
 /**
  * TPDO object.
  */
@@ -309,6 +449,11 @@ typedef struct {
     uint32_t inhibitTimer;   /**< Inhibit timer variable in microseconds */
     uint32_t eventTimer;     /**< Event timer variable in microseconds */
 #endif
+#if (OD_TPDO_PENDING_WORDS > 0) || defined CO_DOXYGEN
+    CO_TPDO_pending_t* pending;                         /**< From CO_TPDO_initPending() or NULL */
+    uint16_t pendingIndex;                              /**< From CO_TPDO_initPending() */
+    OD_extension_t* mappedExt[CO_PDO_MAX_MAPPED_ENTRIES]; /**< Extensions of the mapped objects with flagsPDO */
+#endif
 } CO_TPDO_t;
 
 /**
@@ -338,6 +483,32 @@ CO_ReturnError_t CO_TPDO_init(CO_TPDO_t* TPDO, OD_t* OD, CO_EM_t* em,
                               uint16_t preDefinedCanId, OD_entry_t* OD_18xx_TPDOCommPar, OD_entry_t* OD_1Axx_TPDOMapPar,
                               CO_CANmodule_t* CANdevTx, uint16_t CANdevTxIdx, uint32_t* errInfo);
 
+#if (OD_TPDO_PENDING_WORDS > 0) || defined CO_DOXYGEN
+/**
+ * Link TPDO with the bitmaps of pending TPDOs.
+ *
+ * Function must be called after CO_TPDO_init(). It registers the TPDO in the extensions of already mapped objects,
+ * objects mapped later are registered by the mapping itself.
+ *
+ * @param TPDO This object.
+ * @param pending Bitmaps of pending TPDOs of the CANopen device, may be NULL to unlink the TPDO.
+ * @param index Index of the TPDO in the device, 0 for the first TPDO.
+ */
+void CO_TPDO_initPending(CO_TPDO_t* TPDO, CO_TPDO_pending_t* pending, uint16_t index);
+
+/**
+ * Mark TPDO to be visited by the next CO_process_TPDO().
+ *
+ * @param TPDO TPDO object.
+ */
+static inline void
+CO_TPDO_setPending(CO_TPDO_t* TPDO) {
+    if ((TPDO->pending != NULL) && (TPDO->pendingIndex < (OD_TPDO_PENDING_WORDS * 32U))) {
+        TPDO->pending->pending[TPDO->pendingIndex >> 5] |= 1UL << (TPDO->pendingIndex & 0x1FU);
+    }
+}
+#endif
+
 /**
  * Request transmission of TPDO message.
  *
@@ -350,6 +521,9 @@ static inline void
 CO_TPDOsendRequest(CO_TPDO_t* TPDO) {
     if (TPDO != NULL) {
         TPDO->sendRequest = true;
+#if OD_TPDO_PENDING_WORDS > 0
+        CO_TPDO_setPending(TPDO);
+#endif
     }
 }
 
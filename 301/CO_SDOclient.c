@@ -240,6 +240,18 @@ CO_SDOclient_init(CO_SDOclient_t* SDO_C, OD_t* OD, OD_entry_t* OD_1280_SDOcliPar
 
     /* prepare circular fifo buffer */
     CO_fifo_init(&SDO_C->bufFifo, SDO_C->buf, CO_CONFIG_SDO_CLI_BUFFER_SIZE + 1U);
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_BLOCK) != 0
+    SDO_C->block_blksizeMax = 127;
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+    SDO_C->cache = NULL;
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+    SDO_C->rtt = NULL;
+    SDO_C->rttRetries = 0;
+    SDO_C->rttRetryable = false;
+    SDO_C->rttStale = false;
+#endif
 
     /* Get parameters from Object Dictionary (initial values) */
     uint8_t maxSubIndex, nodeIDOfTheSDOServer;
@@ -260,6 +272,9 @@ CO_SDOclient_init(CO_SDOclient_t* SDO_C, OD_t* OD, OD_entry_t* OD_1280_SDOcliPar
     SDO_C->OD_1280_extension.object = SDO_C;
     SDO_C->OD_1280_extension.read = OD_readOriginal;
     SDO_C->OD_1280_extension.write = OD_write_1280;
+#if OD_IO_VIEW > 0
+    SDO_C->OD_1280_extension.view = NULL;
+#endif
     ODR_t odRetE = OD_extension_init(OD_1280_SDOcliPar, &SDO_C->OD_1280_extension);
     if (odRetE != ODR_OK) {
         if (errInfo != NULL) {
@@ -293,6 +308,120 @@ CO_SDOclient_initCallbackPre(CO_SDOclient_t* SDOclient, void* object, void (*pFu
 }
 #endif
 
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_BLOCK) != 0
+void
+CO_SDOclient_setBlockSize(CO_SDOclient_t* SDO_C, uint8_t blksize) {
+    if (SDO_C != NULL) {
+        SDO_C->block_blksizeMax = ((blksize >= 1U) && (blksize <= 127U)) ? blksize : 127U;
+    }
+}
+#endif
+
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+void
+CO_SDOclient_setCache(CO_SDOclient_t* SDO_C, CO_SDOcache_t* cache) {
+    if (SDO_C != NULL) {
+        SDO_C->cache = cache;
+    }
+}
+#endif
+
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+void
+CO_SDOclient_setRtt(CO_SDOclient_t* SDO_C, CO_SDOrtt_t* rtt) {
+    if (SDO_C != NULL) {
+        SDO_C->rtt = rtt;
+    }
+}
+
+/* Initiate request was just sent from SDO_C->CANtxBuff, prepare its retransmission */
+static void
+CO_SDOclient_rttSent(CO_SDOclient_t* SDO_C, bool_t retryable) {
+    SDO_C->rttRetries = 0;
+    SDO_C->rttSent = 0;
+    SDO_C->rttRetryable = retryable && (SDO_C->rtt != NULL) && (SDO_C->rtt->maxRetries > 0U);
+    if (SDO_C->rttRetryable) {
+        (void)memcpy((void*)&SDO_C->rttRequest[0], (const void*)&SDO_C->CANtxBuff->data[0], 8);
+        SDO_C->rttTimeout_us = CO_SDOrtt_retryTimeout_us(SDO_C->rtt, SDO_C->nodeIDOfTheSDOServer,
+                                                         SDO_C->SDOtimeoutTime_us);
+    }
+}
+
+/* Return true, if received message is late duplicate response to the retransmitted initiate request of the previous
+ * transfer. It has other index or subindex than the current request. */
+static bool_t
+CO_SDOclient_rttStale(CO_SDOclient_t* SDO_C) {
+    bool_t stale = false;
+    bool_t initiate = (SDO_C->state == CO_SDO_ST_DOWNLOAD_INITIATE_RSP)
+                      || (SDO_C->state == CO_SDO_ST_UPLOAD_INITIATE_RSP);
+
+    if (SDO_C->rttStale && initiate && (SDO_C->CANrxData[0] != 0x80U)) {
+        uint16_t index = ((uint16_t)SDO_C->CANrxData[2]) << 8;
+        index |= SDO_C->CANrxData[1];
+        stale = (index != SDO_C->index) || (SDO_C->CANrxData[3] != SDO_C->subIndex);
+    }
+    return stale;
+}
+
+/* Response was received, measure round trip time, if request was sent only once */
+static void
+CO_SDOclient_rttReceived(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us) {
+    switch (SDO_C->state) {
+        case CO_SDO_ST_DOWNLOAD_INITIATE_RSP:
+        case CO_SDO_ST_DOWNLOAD_SEGMENT_RSP:
+        case CO_SDO_ST_DOWNLOAD_BLK_INITIATE_RSP:
+        case CO_SDO_ST_DOWNLOAD_BLK_END_RSP:
+        case CO_SDO_ST_UPLOAD_INITIATE_RSP:
+        case CO_SDO_ST_UPLOAD_SEGMENT_RSP:
+        case CO_SDO_ST_UPLOAD_BLK_INITIATE_RSP: {
+            if (SDO_C->rttRetries == 0U) {
+                CO_SDOrtt_sample(SDO_C->rtt, SDO_C->nodeIDOfTheSDOServer, SDO_C->timeoutTimer + timeDifference_us);
+                SDO_C->rttStale = false;
+            }
+            break;
+        }
+        default: { /* MISRA C 2004 14.10 */
+            break;
+        }
+    }
+    SDO_C->rttRetries = 0;
+    SDO_C->rttRetryable = false;
+}
+
+/* Retransmit initiate request, if its retransmission timeout expired */
+static void
+CO_SDOclient_rttRetransmit(CO_SDOclient_t* SDO_C, uint32_t* timerNext_us) {
+    bool_t waiting = (SDO_C->state == CO_SDO_ST_DOWNLOAD_INITIATE_RSP)
+                     || (SDO_C->state == CO_SDO_ST_UPLOAD_INITIATE_RSP);
+
+    if (!SDO_C->rttRetryable || !waiting || (SDO_C->rttRetries >= SDO_C->rtt->maxRetries)
+        || (SDO_C->timeoutTimer >= SDO_C->SDOtimeoutTime_us)) {
+        return;
+    }
+
+    uint32_t elapsed = SDO_C->timeoutTimer - SDO_C->rttSent;
+    if ((elapsed >= SDO_C->rttTimeout_us) && !SDO_C->CANtxBuff->bufferFull) {
+        (void)memcpy((void*)&SDO_C->CANtxBuff->data[0], (const void*)&SDO_C->rttRequest[0], 8);
+        (void)CO_CANsend(SDO_C->CANdevTx, SDO_C->CANtxBuff);
+        CO_SDOrtt_retry(SDO_C->rtt, SDO_C->nodeIDOfTheSDOServer);
+        SDO_C->rttRetries++;
+        SDO_C->rttSent = SDO_C->timeoutTimer;
+        SDO_C->rttTimeout_us = (SDO_C->rttTimeout_us < (UINT32_MAX / 2U)) ? (SDO_C->rttTimeout_us * 2U) : UINT32_MAX;
+        SDO_C->rttStale = true;
+        elapsed = 0;
+    }
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_FLAG_TIMERNEXT) != 0
+    /* check again, when retransmission timeout expires */
+    if ((timerNext_us != NULL) && (elapsed < SDO_C->rttTimeout_us)
+        && (*timerNext_us > (SDO_C->rttTimeout_us - elapsed))) {
+        *timerNext_us = SDO_C->rttTimeout_us - elapsed;
+    }
+#else
+    (void)timerNext_us;
+#endif
+}
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_RTT */
+
 #if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_LOCAL) != 0) && defined CO_BIG_ENDIAN
 static inline void
 reverseBytes(void* start, OD_size_t size) {
@@ -375,6 +504,9 @@ CO_SDOclientDownloadInitiate(CO_SDOclient_t* SDO_C, uint16_t index, uint8_t subI
     SDO_C->sizeTran = 0;
     SDO_C->finished = false;
     SDO_C->SDOtimeoutTime_us = (uint32_t)SDOtimeoutTime_ms * 1000U;
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+    SDO_C->SDOtimeoutTime_us = CO_SDOrtt_timeout_us(SDO_C->rtt, SDO_C->nodeIDOfTheSDOServer, SDO_C->SDOtimeoutTime_us);
+#endif
     SDO_C->timeoutTimer = 0;
     CO_fifo_reset(&SDO_C->bufFifo);
 
@@ -570,8 +702,17 @@ CO_SDOclientDownload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t s
 #endif
     }
 #endif /* CO_CONFIG_SDO_CLI_LOCAL */
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+    /* ignore late duplicate response, timeout timer continues */
+    else if (CO_FLAG_READ(SDO_C->CANrxNew) && CO_SDOclient_rttStale(SDO_C)) {
+        CO_FLAG_CLEAR(SDO_C->CANrxNew);
+    }
+#endif
     /* CAN data received */
     else if (CO_FLAG_READ(SDO_C->CANrxNew)) {
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+        CO_SDOclient_rttReceived(SDO_C, timeDifference_us);
+#endif
         /* is SDO abort */
         if (SDO_C->CANrxData[0] == 0x80U) {
             uint32_t code;
@@ -775,9 +916,15 @@ CO_SDOclientDownload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t s
         if (SDO_C->timeoutTimer < SDO_C->SDOtimeoutTime_us) {
             SDO_C->timeoutTimer += timeDifference_us;
         }
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+        CO_SDOclient_rttRetransmit(SDO_C, timerNext_us);
+#endif
         if (SDO_C->timeoutTimer >= SDO_C->SDOtimeoutTime_us) {
             abortCode = CO_SDO_AB_TIMEOUT;
             SDO_C->state = CO_SDO_ST_ABORT;
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+            CO_SDOrtt_timeout(SDO_C->rtt, SDO_C->nodeIDOfTheSDOServer);
+#endif
         }
 #if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_FLAG_TIMERNEXT) != 0
         else if (timerNext_us != NULL) {
@@ -847,6 +994,10 @@ CO_SDOclientDownload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t s
                 /* reset timeout timer and send message */
                 SDO_C->timeoutTimer = 0;
                 (void)CO_CANsend(SDO_C->CANdevTx, SDO_C->CANtxBuff);
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+                /* expedited download may be repeated, server is idle after response */
+                CO_SDOclient_rttSent(SDO_C, SDO_C->finished);
+#endif
                 SDO_C->state = CO_SDO_ST_DOWNLOAD_INITIATE_RSP;
                 break;
             }
@@ -1056,11 +1207,32 @@ CO_SDOclientUploadInitiate(CO_SDOclient_t* SDO_C, uint16_t index, uint8_t subInd
     SDO_C->finished = false;
     CO_fifo_reset(&SDO_C->bufFifo);
     SDO_C->SDOtimeoutTime_us = (uint32_t)SDOtimeoutTime_ms * 1000U;
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+    SDO_C->SDOtimeoutTime_us = CO_SDOrtt_timeout_us(SDO_C->rtt, SDO_C->nodeIDOfTheSDOServer, SDO_C->SDOtimeoutTime_us);
+#endif
     SDO_C->timeoutTimer = 0;
 #if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_BLOCK) != 0
     SDO_C->block_SDOtimeoutTime_us = (uint32_t)SDOtimeoutTime_ms * 700U;
 #endif
 
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+    /* static object of the remote node may be in the cache, then upload is finished without communication */
+    if (SDO_C->cache != NULL) {
+        uint8_t buf[CO_SDO_CACHE_DATA_SIZE];
+        size_t count = 0;
+
+        if (CO_SDOcache_get(SDO_C->cache, SDO_C->nodeIDOfTheSDOServer, index, subIndex, buf,
+                            CO_fifo_getSpace(&SDO_C->bufFifo), &count)) {
+            (void)CO_fifo_write(&SDO_C->bufFifo, buf, count, NULL);
+            SDO_C->sizeInd = count;
+            SDO_C->sizeTran = count;
+            SDO_C->finished = true;
+            SDO_C->state = CO_SDO_ST_IDLE;
+            return CO_SDO_RT_ok_communicationEnd;
+        }
+    }
+#endif
+
 #if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_LOCAL) != 0
     /* if node-ID of the SDO server is the same as node-ID of this node, then transfer data within this node */
     if (((SDO_C->OD != NULL) && (SDO_C->nodeId != 0U)) && (SDO_C->nodeIDOfTheSDOServer == SDO_C->nodeId)) {
@@ -1090,6 +1262,9 @@ CO_SDOclientUpload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t sen
 
     CO_SDO_return_t ret = CO_SDO_RT_waitingResponse;
     CO_SDO_abortCode_t abortCode = CO_SDO_AB_NONE;
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+    bool_t remoteTransfer = false;
+#endif
 
     if ((SDO_C == NULL) || !SDO_C->valid) {
         abortCode = CO_SDO_AB_DEVICE_INCOMPAT;
@@ -1200,8 +1375,20 @@ CO_SDOclientUpload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t sen
 #endif
     }
 #endif /* CO_CONFIG_SDO_CLI_LOCAL */
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+    /* ignore late duplicate response, timeout timer continues */
+    else if (CO_FLAG_READ(SDO_C->CANrxNew) && CO_SDOclient_rttStale(SDO_C)) {
+        CO_FLAG_CLEAR(SDO_C->CANrxNew);
+    }
+#endif
     /* CAN data received */
     else if (CO_FLAG_READ(SDO_C->CANrxNew)) {
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+        CO_SDOclient_rttReceived(SDO_C, timeDifference_us);
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+        remoteTransfer = true;
+#endif
         /* is SDO abort */
         if (SDO_C->CANrxData[0] == 0x80U) {
             uint32_t code;
@@ -1478,6 +1665,9 @@ CO_SDOclientUpload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t sen
         if (SDO_C->timeoutTimer < SDO_C->SDOtimeoutTime_us) {
             SDO_C->timeoutTimer += timeDifference_us;
         }
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+        CO_SDOclient_rttRetransmit(SDO_C, timerNext_us);
+#endif
         if (SDO_C->timeoutTimer >= SDO_C->SDOtimeoutTime_us) {
             bool_t state_upload_seg_req = (SDO_C->state == CO_SDO_ST_UPLOAD_SEGMENT_REQ);
             bool_t state_upload_blk_sublock_crsp = (SDO_C->state == CO_SDO_ST_UPLOAD_BLK_SUBBLOCK_CRSP);
@@ -1486,6 +1676,9 @@ CO_SDOclientUpload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t sen
                 abortCode = CO_SDO_AB_GENERAL;
             } else {
                 abortCode = CO_SDO_AB_TIMEOUT;
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+                CO_SDOrtt_timeout(SDO_C->rtt, SDO_C->nodeIDOfTheSDOServer);
+#endif
             }
             SDO_C->state = CO_SDO_ST_ABORT;
         }
@@ -1547,6 +1740,9 @@ CO_SDOclientUpload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t sen
                 /* reset timeout timer and send message */
                 SDO_C->timeoutTimer = 0;
                 (void)CO_CANsend(SDO_C->CANdevTx, SDO_C->CANtxBuff);
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+                CO_SDOclient_rttSent(SDO_C, true);
+#endif
                 SDO_C->state = CO_SDO_ST_UPLOAD_INITIATE_RSP;
                 break;
             }
@@ -1577,8 +1773,8 @@ CO_SDOclientUpload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t sen
 
                 /* calculate number of block segments from free buffer space */
                 count = CO_fifo_getSpace(&SDO_C->bufFifo) / 7U;
-                if (count > 127U) {
-                    count = 127;
+                if (count > SDO_C->block_blksizeMax) {
+                    count = SDO_C->block_blksizeMax;
                 } else if (count == 0U) {
                     abortCode = CO_SDO_AB_OUT_OF_MEM;
                     SDO_C->state = CO_SDO_ST_ABORT;
@@ -1633,8 +1829,8 @@ CO_SDOclientUpload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t sen
 
                     /* calculate number of block segments from free buffer space */
                     count = CO_fifo_getSpace(&SDO_C->bufFifo) / 7U;
-                    if (count >= 127U) {
-                        count = 127;
+                    if (count >= SDO_C->block_blksizeMax) {
+                        count = SDO_C->block_blksizeMax;
                     } else if (CO_fifo_getOccupied(&SDO_C->bufFifo) > 0U) {
                         /* application must empty data buffer first */
                         ret = CO_SDO_RT_uploadDataBufferFull;
@@ -1745,6 +1941,19 @@ CO_SDOclientUpload(CO_SDOclient_t* SDO_C, uint32_t timeDifference_us, bool_t sen
 #endif
     }
 
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+    /* store static object into the cache, if all data are still in the buffer */
+    if (remoteTransfer && (ret == CO_SDO_RT_ok_communicationEnd) && (SDO_C->cache != NULL)
+        && (SDO_C->sizeTran <= CO_SDO_CACHE_DATA_SIZE) && (CO_fifo_getOccupied(&SDO_C->bufFifo) == SDO_C->sizeTran)) {
+        uint8_t buf[CO_SDO_CACHE_DATA_SIZE];
+        size_t count;
+
+        (void)CO_fifo_altBegin(&SDO_C->bufFifo, 0);
+        count = CO_fifo_altRead(&SDO_C->bufFifo, buf, sizeof(buf));
+        CO_SDOcache_put(SDO_C->cache, SDO_C->nodeIDOfTheSDOServer, SDO_C->index, SDO_C->subIndex, buf, count);
+    }
+#endif
+
     if (sizeIndicated != NULL) {
         *sizeIndicated = SDO_C->sizeInd;
     }
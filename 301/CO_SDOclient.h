@@ -26,6 +26,10 @@
 #include "301/CO_ODinterface.h"
 #include "301/CO_SDOserver.h"
 #include "301/CO_fifo.h"
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0) || defined CO_DOXYGEN
+#include "extra/CO_SDOcache.h"
+#include "extra/CO_SDOrtt.h"
+#endif
 
 /* default configuration, see CO_config.h */
 #ifndef CO_CONFIG_SDO_CLI
@@ -197,11 +201,25 @@ typedef struct {
     uint32_t block_timeoutTimer;      /**< Timeout timer for SDO sub-block upload */
     uint8_t block_seqno;              /**< Sequence number of segment in block, 1..127 */
     uint8_t block_blksize;            /**< Number of segments per block, 1..127 */
+    uint8_t block_blksizeMax;         /**< Maximum number of segments per block at block upload, see
+                                           CO_SDOclient_setBlockSize() */
     uint8_t block_noData;             /**< Number of bytes in last segment that do not contain data */
     bool_t block_crcEnabled;          /**< Server CRC support in block transfer */
     uint8_t block_dataUploadLast[7];  /**< Last 7 bytes of data at block upload */
     uint16_t block_crc;               /**< Calculated CRC checksum */
 #endif
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0) || defined CO_DOXYGEN
+    CO_SDOcache_t* cache; /**< From CO_SDOclient_setCache() or NULL */
+#endif
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0) || defined CO_DOXYGEN
+    CO_SDOrtt_t* rtt;       /**< From CO_SDOclient_setRtt() or NULL */
+    uint32_t rttTimeout_us; /**< Retransmission timeout of the initiate request, doubled after each retry */
+    uint32_t rttSent;       /**< Value of #timeoutTimer, when initiate request was last retransmitted */
+    uint8_t rttRetries;     /**< Number of retransmissions of the current request */
+    bool_t rttRetryable;    /**< Current request may be retransmitted, it is stored in rttRequest */
+    bool_t rttStale;        /**< Request was retransmitted, late duplicate response may still arrive */
+    uint8_t rttRequest[8];  /**< Copy of the initiate request */
+#endif
 } CO_SDOclient_t;
 
 /**
@@ -262,6 +280,49 @@ void CO_SDOclient_initCallbackPre(CO_SDOclient_t* SDOclient, void* object, void
 CO_SDO_return_t CO_SDOclient_setup(CO_SDOclient_t* SDO_C, uint32_t COB_IDClientToServer, uint32_t COB_IDServerToClient,
                                    uint8_t nodeIDOfTheSDOServer);
 
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_BLOCK) != 0) || defined CO_DOXYGEN
+/**
+ * Set maximum block size for SDO block upload.
+ *
+ * At block upload client proposes the number of segments per block, limited by this value and by the free space in
+ * the internal fifo buffer. Smaller blocks mean less data to repeat after a lost segment, larger blocks mean less
+ * confirmations from the client. At block download block size is proposed by the server. Default is 127.
+ *
+ * @param SDO_C This object.
+ * @param blksize Maximum number of segments per block, 1..127. Other values set the default.
+ */
+void CO_SDOclient_setBlockSize(CO_SDOclient_t* SDO_C, uint8_t blksize);
+#endif
+
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0) || defined CO_DOXYGEN
+/**
+ * Attach cache for static objects of remote nodes, see @ref CO_SDOcache.
+ *
+ * CO_SDOclientUploadInitiate() serves static objects from the cache, if they are there. Such upload finishes with the
+ * first call to CO_SDOclientUpload(), data are in the buffer as usual. Successful uploads of static objects are
+ * stored into the cache. Same cache may be attached to several SDO clients.
+ *
+ * @param SDO_C This object.
+ * @param cache Initialized cache or NULL to disable caching.
+ */
+void CO_SDOclient_setCache(CO_SDOclient_t* SDO_C, CO_SDOcache_t* cache);
+#endif
+
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0) || defined CO_DOXYGEN
+/**
+ * Attach round trip time estimator of remote nodes, see @ref CO_SDOrtt.
+ *
+ * Response time of each request is measured. SDO timeout of slow nodes is extended and initiate request of expedited
+ * download or of upload is retransmitted, if response does not arrive within the retransmission timeout of the node.
+ * Late duplicate response to the retransmitted request, which arrives during the next initiate, is ignored. Same
+ * estimator may be attached to several SDO clients.
+ *
+ * @param SDO_C This object.
+ * @param rtt Initialized estimator or NULL to disable.
+ */
+void CO_SDOclient_setRtt(CO_SDOclient_t* SDO_C, CO_SDOrtt_t* rtt);
+#endif
+
 /**
  * Initiate SDO download communication.
  *
@@ -513,6 +513,39 @@ readFromOd(CO_SDOserver_t* SDO, CO_SDO_abortCode_t* abortCode, OD_size_t countMi
 #endif
     OD_size_t countRemain = SDO->bufOffsetWr - SDO->bufOffsetRd;
 
+#if OD_IO_VIEW > 0
+    /* If OD variable provides direct access to its data, transfer them without copying into the buffer. Strings are
+     * shortened to null termination, multi-byte variables on big endian must be swapped, so they are copied. */
+#ifdef CO_BIG_ENDIAN
+    OD_attr_t attrNoView = (OD_attr_t)ODA_STR | (OD_attr_t)ODA_MB;
+#else
+    OD_attr_t attrNoView = (OD_attr_t)ODA_STR;
+#endif
+    if (!SDO->finished && (SDO->bufOffsetWr == 0U) && (SDO->OD_IO.stream.dataOffset == 0U)
+        && (SDO->OD_IO.view != NULL) && ((SDO->OD_IO.stream.attribute & attrNoView) == 0U)) {
+        const void* data = NULL;
+        OD_size_t count = 0;
+        ODR_t odRet;
+
+        CO_LOCK_OD(SDO->CANdevTx);
+        odRet = SDO->OD_IO.view(&SDO->OD_IO.stream, &data, &count);
+        CO_UNLOCK_OD(SDO->CANdevTx);
+
+        if ((odRet == ODR_OK) && (data != NULL) && (count > 0U)) {
+            SDO->bufPtr = (const uint8_t*)data;
+            SDO->bufOffsetRd = 0;
+            SDO->bufOffsetWr = count;
+            SDO->finished = true;
+#if ((CO_CONFIG_SDO_SRV)&CO_CONFIG_SDO_SRV_BLOCK) != 0
+            if (calculateCrc && SDO->block_crcEnabled) {
+                SDO->block_crc = crc16_ccitt(SDO->bufPtr, count, SDO->block_crc);
+            }
+#endif
+            return true;
+        }
+    }
+#endif
+
     if (!SDO->finished && (countRemain < countMinimum)) {
         /* first move remaining data to the start of the buffer */
         (void)memmove(SDO->buf, SDO->buf + SDO->bufOffsetRd, countRemain);
@@ -664,6 +697,7 @@ CO_SDOserver_process(CO_SDOserver_t* SDO, bool_t NMTisPreOrOperational, uint32_t
 #if ((CO_CONFIG_SDO_SRV)&CO_CONFIG_SDO_SRV_SEGMENTED) != 0
             /* load data from object dictionary, if upload and no error */
             if (upload && (abortCode == CO_SDO_AB_NONE)) {
+                SDO->bufPtr = SDO->buf;
                 SDO->bufOffsetRd = 0;
                 SDO->bufOffsetWr = 0;
                 SDO->sizeTran = 0;
@@ -944,7 +978,7 @@ CO_SDOserver_process(CO_SDOserver_t* SDO, bool_t NMTisPreOrOperational, uint32_t
                         /* data were already loaded from OD variable, verify crc */
                         if ((SDO->CANrxData[0] & 0x04) != 0) {
                             SDO->block_crcEnabled = true;
-                            SDO->block_crc = crc16_ccitt(SDO->buf, SDO->bufOffsetWr, 0);
+                            SDO->block_crc = crc16_ccitt(SDO->bufPtr, SDO->bufOffsetWr, 0);
                         } else {
                             SDO->block_crcEnabled = false;
                         }
@@ -1176,7 +1210,7 @@ CO_SDOserver_process(CO_SDOserver_t* SDO, bool_t NMTisPreOrOperational, uint32_t
                 if ((SDO->sizeInd > 0U) && (SDO->sizeInd <= 4U)) {
                     /* expedited transfer */
                     SDO->CANtxBuff->data[0] = (uint8_t)(0x43U | ((4U - SDO->sizeInd) << 2U));
-                    (void)memcpy((void*)(&SDO->CANtxBuff->data[4]), (const void*)(&SDO->buf[0]), SDO->sizeInd);
+                    (void)memcpy((void*)(&SDO->CANtxBuff->data[4]), (const void*)SDO->bufPtr, SDO->sizeInd);
                     SDO->state = CO_SDO_ST_IDLE;
                     ret = CO_SDO_RT_ok_communicationEnd;
                 } else {
@@ -1259,7 +1293,7 @@ CO_SDOserver_process(CO_SDOserver_t* SDO, bool_t NMTisPreOrOperational, uint32_t
                 }
 
                 /* copy data segment to CAN message */
-                (void)memcpy(&SDO->CANtxBuff->data[1], SDO->buf + SDO->bufOffsetRd, count);
+                (void)memcpy(&SDO->CANtxBuff->data[1], SDO->bufPtr + SDO->bufOffsetRd, count);
                 SDO->bufOffsetRd += count;
                 SDO->sizeTran += count;
 
@@ -1410,7 +1444,7 @@ CO_SDOserver_process(CO_SDOserver_t* SDO, bool_t NMTisPreOrOperational, uint32_t
                 }
 
                 /* copy data segment to CAN message */
-                (void)memcpy(&SDO->CANtxBuff->data[1], SDO->buf + SDO->bufOffsetRd, count);
+                (void)memcpy(&SDO->CANtxBuff->data[1], SDO->bufPtr + SDO->bufOffsetRd, count);
                 SDO->bufOffsetRd += count;
                 SDO->block_noData = (uint8_t)(7 - count);
                 SDO->sizeTran += count;
@@ -393,6 +393,7 @@ typedef struct {
                                                         block transfer + byte for '\0' */
     OD_size_t bufOffsetWr; /**< Offset of next free data byte available for write in the buffer. */
     OD_size_t bufOffsetRd; /**< Offset of first data available for read in the buffer */
+    const uint8_t* bufPtr; /**< Data for upload, #buf or data of the OD variable, see @ref OD_IO_VIEW */
 #endif
 #if (((CO_CONFIG_SDO_SRV)&CO_CONFIG_SDO_SRV_BLOCK) != 0) || defined CO_DOXYGEN
     uint32_t block_SDOtimeoutTime_us; /**< Timeout time for SDO sub-block download, half of #SDOtimeoutTime_us */
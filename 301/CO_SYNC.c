@@ -53,6 +53,9 @@ CO_SYNC_receive(void* object, void* msg) {
     if (syncReceived) {
         /* toggle PDO receive buffer */
         SYNC->CANrxToggle = SYNC->CANrxToggle ? false : true;
+#if ((CO_CONFIG_SYNC)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+        SYNC->rxTimestamp_us = CO_CANrxMsg_readTimestamp(msg);
+#endif
 
         CO_FLAG_SET(SYNC->CANrxNew);
 
@@ -309,6 +312,29 @@ CO_SYNC_initCallbackPre(CO_SYNC_t* SYNC, void* object, void (*pFunctSignalPre)(v
 }
 #endif
 
+#if ((CO_CONFIG_SYNC)&CO_CONFIG_SYNC_PRODUCER) != 0
+void
+CO_SYNC_signalExternal(CO_SYNC_t* SYNC, uint8_t counter) {
+    if (SYNC == NULL) {
+        return;
+    }
+    SYNC->counter = counter;
+    /* toggle PDO receive buffer */
+    SYNC->CANrxToggle = SYNC->CANrxToggle ? false : true;
+#if ((CO_CONFIG_SYNC)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+    SYNC->rxTimestamp_us = CO_CANtimestampNow();
+#endif
+
+    CO_FLAG_SET(SYNC->CANrxNew);
+
+#if ((CO_CONFIG_SYNC)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
+    if (SYNC->pFunctSignalPre != NULL) {
+        SYNC->pFunctSignalPre(SYNC->functSignalObjectPre);
+    }
+#endif
+}
+#endif
+
 CO_SYNC_status_t
 CO_SYNC_process(CO_SYNC_t* SYNC, bool_t NMTisPreOrOperational, uint32_t timeDifference_us, uint32_t* timerNext_us) {
     (void)timerNext_us; /* may be unused */
@@ -324,7 +350,12 @@ CO_SYNC_process(CO_SYNC_t* SYNC, bool_t NMTisPreOrOperational, uint32_t timeDiff
 
         /* was SYNC just received */
         if (CO_FLAG_READ(SYNC->CANrxNew)) {
+#if ((CO_CONFIG_SYNC)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+            /* SYNC timer starts at reception, not at processing of SYNC message */
+            SYNC->timer = CO_CANtimestampAge(SYNC->rxTimestamp_us, CO_CANtimestampNow());
+#else
             SYNC->timer = 0;
+#endif
             syncStatus = CO_SYNC_RX_TX;
             CO_FLAG_CLEAR(SYNC->CANrxNew);
         }
@@ -334,19 +365,22 @@ CO_SYNC_process(CO_SYNC_t* SYNC, bool_t NMTisPreOrOperational, uint32_t timeDiff
         if (OD_1006_period > 0U) {
 #if ((CO_CONFIG_SYNC)&CO_CONFIG_SYNC_PRODUCER) != 0
             if (SYNC->isProducer) {
-                if (SYNC->timer >= OD_1006_period) {
-                    syncStatus = CO_SYNC_RX_TX;
-                    (void)CO_SYNCsend(SYNC);
-                }
+                /* external producer reports its transmissions as received SYNC */
+                if (!SYNC->isExternal) {
+                    if (SYNC->timer >= OD_1006_period) {
+                        syncStatus = CO_SYNC_RX_TX;
+                        (void)CO_SYNCsend(SYNC);
+                    }
 #if ((CO_CONFIG_SYNC)&CO_CONFIG_FLAG_TIMERNEXT) != 0
-                /* Calculate when next SYNC needs to be sent */
-                if (timerNext_us != NULL) {
-                    uint32_t diff = OD_1006_period - SYNC->timer;
-                    if (*timerNext_us > diff) {
-                        *timerNext_us = diff;
+                    /* Calculate when next SYNC needs to be sent */
+                    if (timerNext_us != NULL) {
+                        uint32_t diff = OD_1006_period - SYNC->timer;
+                        if (*timerNext_us > diff) {
+                            *timerNext_us = diff;
+                        }
                     }
-                }
 #endif
+                }
             } else
 #endif /* (CO_CONFIG_SYNC) & CO_CONFIG_SYNC_PRODUCER */
 
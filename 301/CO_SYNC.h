@@ -29,7 +29,7 @@
 #ifndef CO_CONFIG_SYNC
 #define CO_CONFIG_SYNC                                                                                                 \
     (CO_CONFIG_SYNC_ENABLE | CO_CONFIG_SYNC_PRODUCER | CO_CONFIG_GLOBAL_RT_FLAG_CALLBACK_PRE                           \
-     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC | CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP)
 #endif
 
 #if (((CO_CONFIG_SYNC)&CO_CONFIG_SYNC_ENABLE) != 0) || defined CO_DOXYGEN
@@ -78,12 +78,16 @@ typedef struct {
                                      transmitted SYNC message */
     uint32_t* OD_1006_period;     /**< Pointer to variable in OD, "Communication cycle period" in microseconds */
     uint32_t* OD_1007_window;     /**< Pointer to variable in OD, "Synchronous window length" in microseconds */
+#if (((CO_CONFIG_SYNC)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0) || defined CO_DOXYGEN
+    uint64_t rxTimestamp_us; /**< Receive timestamp of the last SYNC message, from CO_CANrxMsg_readTimestamp() */
+#endif
 
 #if (((CO_CONFIG_SYNC)&CO_CONFIG_SYNC_PRODUCER) != 0) || defined CO_DOXYGEN
     bool_t isProducer;        /**< True, if device is SYNC producer. Calculated from _COB ID SYNC Message_ variable
                                  from Object dictionary(index 0x1005).*/
     CO_CANmodule_t* CANdevTx; /**< From CO_SYNC_init() */
     CO_CANtx_t* CANtxBuff;    /**< CAN transmit buffer inside CANdevTx */
+    bool_t isExternal;        /**< True, if SYNC is transmitted by external producer, see CO_SYNC_setExternal() */
 #endif
 
 #if ((CO_CONFIG_SYNC)&CO_CONFIG_FLAG_OD_DYNAMIC) || defined CO_DOXYGEN
@@ -177,6 +181,47 @@ CO_SYNCsend(CO_SYNC_t* SYNC) {
     SYNC->CANtxBuff->data[0] = SYNC->counter;
     return CO_CANsend(SYNC->CANdevTx, SYNC->CANtxBuff);
 }
+
+/**
+ * Configure external SYNC producer.
+ *
+ * External producer, for example a high priority thread with absolute deadlines, transmits SYNC message by itself and
+ * reports each transmission with CO_SYNC_signalExternal(). CO_SYNC_process() then doesn't transmit SYNC from its own
+ * timer, but processes reported transmissions like received SYNC messages. Setting is cleared by CO_SYNC_init().
+ *
+ * @param SYNC SYNC object.
+ * @param external True to enable external producer, false for SYNC transmission from CO_SYNC_process().
+ */
+static inline void
+CO_SYNC_setExternal(CO_SYNC_t* SYNC, bool_t external) {
+    SYNC->isExternal = external;
+}
+
+/**
+ * Get counter for the next SYNC message from external producer.
+ *
+ * @param SYNC SYNC object.
+ *
+ * @return Value of the counter in the next SYNC message or 0, if SYNC message has no data.
+ */
+static inline uint8_t
+CO_SYNC_nextCounter(const CO_SYNC_t* SYNC) {
+    if (SYNC->counterOverflowValue == 0U) {
+        return 0;
+    }
+    return (SYNC->counter >= SYNC->counterOverflowValue) ? 1U : (uint8_t)(SYNC->counter + 1U);
+}
+
+/**
+ * Report SYNC message, transmitted by external producer.
+ *
+ * Function may be called from other thread, like SYNC receive callback. It toggles synchronous RPDO buffers, signals
+ * CO_SYNC_process() and calls callback from CO_SYNC_initCallbackPre().
+ *
+ * @param SYNC SYNC object.
+ * @param counter Counter from the transmitted message, from CO_SYNC_nextCounter().
+ */
+void CO_SYNC_signalExternal(CO_SYNC_t* SYNC, uint8_t counter);
 #endif
 
 /**
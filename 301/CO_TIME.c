@@ -38,6 +38,9 @@ CO_TIME_receive(void* object, void* msg) {
 
     if (DLC == CO_TIME_MSG_LENGTH) {
         (void)memcpy(TIME->timeStamp, data, sizeof(TIME->timeStamp));
+#if ((CO_CONFIG_TIME)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+        TIME->rxTimestamp_us = CO_CANrxMsg_readTimestamp(msg);
+#endif
         CO_FLAG_SET(TIME->CANrxNew);
 
 #if ((CO_CONFIG_TIME)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
@@ -49,6 +52,61 @@ CO_TIME_receive(void* object, void* msg) {
     }
 }
 
+#if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_PRECISE) != 0
+/*
+ * Update offset and drift estimation with received network time and its local receive timestamp.
+ */
+static void
+CO_TIME_discipline(CO_TIME_t* TIME, uint64_t network_us, uint64_t local_us) {
+    int64_t sample = (int64_t)(network_us - local_us);
+    int64_t error = 0;
+
+    if (TIME->synchronized) {
+        int64_t dt = (int64_t)(local_us - TIME->lastLocal_us);
+        int64_t predicted = TIME->offset_us + ((dt * TIME->drift_ppb) / 1000000000);
+        error = sample - predicted;
+        if ((dt <= 0) || (error > CO_TIME_STEP_US) || (error < -CO_TIME_STEP_US)) {
+            /* clock step on either side, start again */
+            TIME->synchronized = false;
+        } else {
+            int64_t drift = TIME->drift_ppb + (((error * 1000000000) / dt) / ((int64_t)1 << CO_TIME_DRIFT_SHIFT));
+            if (drift > CO_TIME_DRIFT_MAX_PPB) {
+                drift = CO_TIME_DRIFT_MAX_PPB;
+            } else if (drift < -CO_TIME_DRIFT_MAX_PPB) {
+                drift = -CO_TIME_DRIFT_MAX_PPB;
+            } else { /* MISRA C 2004 14.10 */
+            }
+            TIME->offset_us = predicted + (error / ((int64_t)1 << CO_TIME_OFFSET_SHIFT));
+            TIME->drift_ppb = (int32_t)drift;
+        }
+    }
+    if (!TIME->synchronized) {
+        TIME->offset_us = sample;
+        TIME->drift_ppb = 0;
+        TIME->samples = 0;
+        TIME->synchronized = true;
+    }
+    TIME->lastLocal_us = local_us;
+    TIME->lastError_us = (int32_t)error;
+    TIME->samples++;
+}
+
+uint64_t
+CO_TIME_toNetwork_us(const CO_TIME_t* TIME, uint64_t local_us) {
+    if ((TIME == NULL) || (local_us == 0U)) {
+        return 0;
+    }
+    if (TIME->isProducer && !TIME->isConsumer) {
+        return CO_CANtimestampToUnix_us(local_us);
+    }
+    if (!TIME->synchronized) {
+        return 0;
+    }
+    int64_t dt = (int64_t)(local_us - TIME->lastLocal_us);
+    return (uint64_t)((int64_t)local_us + TIME->offset_us + ((dt * TIME->drift_ppb) / 1000000000));
+}
+#endif
+
 #if ((CO_CONFIG_TIME)&CO_CONFIG_FLAG_OD_DYNAMIC) != 0
 /*
  * Custom function for writing OD object "COB-ID time stamp"
@@ -164,6 +222,22 @@ CO_TIME_process(CO_TIME_t* TIME, bool_t NMTisPreOrOperational, uint32_t timeDiff
             TIME->days = CO_SWAP_16(days_swapped);
             TIME->residual_us = 0;
             timestampReceived = true;
+#if ((CO_CONFIG_TIME)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+            /* received time was valid at reception, add time, which passed since then */
+            timeDifference_us = CO_CANtimestampAge(TIME->rxTimestamp_us, CO_CANtimestampNow());
+#else
+            timeDifference_us = 0;
+#endif
+#if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_PRECISE) != 0
+            uint64_t local_us = 0;
+#if ((CO_CONFIG_TIME)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+            local_us = TIME->rxTimestamp_us;
+#endif
+            if (local_us == 0U) {
+                local_us = CO_CANtimestampNow();
+            }
+            CO_TIME_discipline(TIME, CO_TIME_toUnix_us(TIME->ms, TIME->days), local_us);
+#endif
 
             CO_FLAG_CLEAR(TIME->CANrxNew);
         }
@@ -173,7 +247,7 @@ CO_TIME_process(CO_TIME_t* TIME, bool_t NMTisPreOrOperational, uint32_t timeDiff
 
     /* Update time */
     uint32_t ms = 0;
-    if (!timestampReceived && (timeDifference_us > 0U)) {
+    if (timeDifference_us > 0U) {
         uint32_t us = timeDifference_us + TIME->residual_us;
         ms = us / 1000U;
         TIME->residual_us = (uint16_t)(us % 1000U);
@@ -184,6 +258,14 @@ CO_TIME_process(CO_TIME_t* TIME, bool_t NMTisPreOrOperational, uint32_t timeDiff
         }
     }
 
+#if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_PRECISE) != 0
+    /* Time from the clock, residual_us is still used for the producer interval */
+    uint64_t network_us = CO_TIME_toNetwork_us(TIME, CO_CANtimestampNow());
+    if (network_us != 0U) {
+        CO_TIME_fromUnix_us(network_us, &TIME->ms, &TIME->days);
+    }
+#endif
+
 #if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_PRODUCER) != 0
     if (NMTisPreOrOperational && TIME->isProducer && TIME->producerInterval_ms > 0) {
         if (TIME->producerTimer_ms >= TIME->producerInterval_ms) {
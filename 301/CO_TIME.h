@@ -27,7 +27,9 @@
 
 /* default configuration, see CO_config.h */
 #ifndef CO_CONFIG_TIME
-#define CO_CONFIG_TIME (CO_CONFIG_TIME_ENABLE | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+#define CO_CONFIG_TIME                                                                                                 \
+    (CO_CONFIG_TIME_ENABLE | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC                     \
+     | CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP)
 #endif
 
 #if (((CO_CONFIG_TIME)&CO_CONFIG_TIME_ENABLE) != 0) || defined CO_DOXYGEN
@@ -57,10 +59,48 @@ extern "C" {
  *
  * Current time can be set with @ref CO_TIME_set() function, which is necessary at least once, if time producer. If
  * configured, time stamp message is send from @ref CO_TIME_process() in intervals specified by @ref CO_TIME_set()
+ *
+ * With @ref CO_CONFIG_TIME_PRECISE time is not advanced by timeDifference_us, so it does not drift with the timing of
+ * the processing loop. Producer takes the time from CO_CANtimestampToUnix_us() (CLOCK_REALTIME, which may be
+ * disciplined by PTP or NTP) in each CO_TIME_process() and sends it rounded to millisecond, time from CO_TIME_set() is
+ * not used.
+ * Consumer pairs each received time with the receive timestamp of the TIME message and estimates offset and drift of
+ * the network time against its own clock with a second order (alpha-beta) filter, which also averages out
+ * millisecond resolution of the message. Offset jumps
+ * larger than @ref CO_TIME_STEP_US restart the estimation. CO_TIME_toNetwork_us() then converts any local timestamp,
+ * for example SYNC receive timestamp (CO_SYNC_t::rxTimestamp_us), RPDO receive timestamp or the time of
+ * CO_process_TPDO(), into absolute network time. Logs from different controllers on the same network are so in the
+ * same time base and can be merged directly.
+ *
+ * @code{.c}
+ * // after CO_process_SYNC() returned CO_SYNC_RX_TX
+ * uint64_t syncTime_us = CO_TIME_toNetwork_us(co->TIME, co->SYNC->rxTimestamp_us);
+ * // sample of the synchronous TPDO, taken in CO_process_TPDO()
+ * uint64_t tpdoTime_us = CO_TIME_toNetwork_us(co->TIME, CO_CANtimestampNow());
+ * @endcode
  */
 
 #define CO_TIME_MSG_LENGTH 6U /**< Length of the TIME message */
 
+#if (((CO_CONFIG_TIME)&CO_CONFIG_TIME_PRECISE) != 0) || defined CO_DOXYGEN
+/** Days from January 1, 1970 (CO_CANtimestampToUnix_us() epoch) to January 1, 1984 (TIME epoch) */
+#define CO_TIME_EPOCH_DAYS 5113U
+/** Offset error above which estimation restarts from the received time, in microseconds */
+#ifndef CO_TIME_STEP_US
+#define CO_TIME_STEP_US 100000
+#endif
+/** Offset correction per TIME message is 1 / 2^CO_TIME_OFFSET_SHIFT of the error */
+#ifndef CO_TIME_OFFSET_SHIFT
+#define CO_TIME_OFFSET_SHIFT 4
+#endif
+/** Drift correction per TIME message is 1 / 2^CO_TIME_DRIFT_SHIFT of the error divided by the interval */
+#ifndef CO_TIME_DRIFT_SHIFT
+#define CO_TIME_DRIFT_SHIFT 10
+#endif
+/** Limit of the estimated drift, in parts per billion */
+#define CO_TIME_DRIFT_MAX_PPB 500000
+#endif
+
 /**
  * TIME producer and consumer object.
  */
@@ -74,12 +114,23 @@ typedef struct {
     bool_t isProducer;                     /**< True, if device is TIME producer. Calculated from _COB ID TIME Message_
                                               variable from Object dictionary (index 0x1012). */
     volatile void* CANrxNew;               /**< Variable indicates, if new TIME message received from CAN bus */
+#if (((CO_CONFIG_TIME)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0) || defined CO_DOXYGEN
+    uint64_t rxTimestamp_us; /**< Receive timestamp of the last TIME message, from CO_CANrxMsg_readTimestamp() */
+#endif
 #if (((CO_CONFIG_TIME)&CO_CONFIG_TIME_PRODUCER) != 0) || defined CO_DOXYGEN
     uint32_t producerInterval_ms; /**< Interval for time producer in milli seconds */
     uint32_t producerTimer_ms;    /**< Sync producer timer */
     CO_CANmodule_t* CANdevTx;     /**< From CO_TIME_init() */
     CO_CANtx_t* CANtxBuff;        /**< CAN transmit buffer */
 #endif
+#if (((CO_CONFIG_TIME)&CO_CONFIG_TIME_PRECISE) != 0) || defined CO_DOXYGEN
+    int64_t offset_us;     /**< Network time minus local time at lastLocal_us, consumer */
+    int32_t drift_ppb;     /**< Rate of network clock against local clock minus one, parts per billion */
+    uint64_t lastLocal_us; /**< Local receive timestamp of the last TIME message */
+    int32_t lastError_us;  /**< Received minus predicted network time of the last TIME message */
+    uint32_t samples;      /**< TIME messages since the estimation (re)started */
+    bool_t synchronized;   /**< True, if offset is estimated, CO_TIME_toNetwork_us() is valid */
+#endif
 #if (((CO_CONFIG_TIME)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0) || defined CO_DOXYGEN
     void (*pFunctSignalPre)(void* object); /**< From CO_TIME_initCallbackPre() or NULL */
     void* functSignalObjectPre;            /**< From CO_TIME_initCallbackPre() or NULL */
@@ -161,6 +212,50 @@ CO_TIME_set(CO_TIME_t* TIME, uint32_t ms, uint16_t days, uint32_t producerInterv
  */
 bool_t CO_TIME_process(CO_TIME_t* TIME, bool_t NMTisPreOrOperational, uint32_t timeDifference_us);
 
+#if (((CO_CONFIG_TIME)&CO_CONFIG_TIME_PRECISE) != 0) || defined CO_DOXYGEN
+/**
+ * Convert local timestamp into network time
+ *
+ * Producer is the time reference, for it network time is the local time, converted with CO_CANtimestampToUnix_us().
+ * Consumer adds estimated offset and drift.
+ *
+ * @param TIME This object.
+ * @param local_us Local time in the time base of CO_CANtimestampNow(), for example receive timestamp.
+ *
+ * @return Network time in microseconds since January 1, 1970 or 0, if local_us is 0 or consumer is not synchronized
+ * yet.
+ */
+uint64_t CO_TIME_toNetwork_us(const CO_TIME_t* TIME, uint64_t local_us);
+
+/**
+ * Convert time in microseconds since January 1, 1970 into TIME message values
+ *
+ * @param time_us Time, rounded to millisecond.
+ * @param [out] ms Milliseconds after midnight.
+ * @param [out] days Number of days since January 1, 1984.
+ */
+static inline void
+CO_TIME_fromUnix_us(uint64_t time_us, uint32_t* ms, uint16_t* days) {
+    uint64_t t_ms = (time_us + 500U) / 1000U;
+    uint64_t d = t_ms / ((uint64_t)1000U * 60U * 60U * 24U);
+    *ms = (uint32_t)(t_ms - (d * ((uint64_t)1000U * 60U * 60U * 24U)));
+    *days = (uint16_t)(d - CO_TIME_EPOCH_DAYS);
+}
+
+/**
+ * Convert TIME message values into microseconds since January 1, 1970
+ *
+ * @param ms Milliseconds after midnight.
+ * @param days Number of days since January 1, 1984.
+ *
+ * @return Time in microseconds.
+ */
+static inline uint64_t
+CO_TIME_toUnix_us(uint32_t ms, uint16_t days) {
+    return ((((uint64_t)days + CO_TIME_EPOCH_DAYS) * ((uint64_t)1000U * 60U * 60U * 24U)) + ms) * 1000U;
+}
+#endif
+
 /** @} */ /* CO_TIME */
 
 #ifdef __cplusplus
@@ -93,6 +93,17 @@ extern "C" {
  */
 #define CO_CONFIG_FLAG_OD_DYNAMIC   0x4000
 
+/**
+ * Use receive timestamps of CAN messages
+ *
+ * CANrx_callback() stores the receive timestamp from CO_CANrxMsg_readTimestamp() and processing function corrects its
+ * timers for the time, which message spent in the receive queue. Driver must provide CO_CANrxMsg_readTimestamp() and
+ * CO_CANtimestampNow(), see @ref CO_driver.
+ *
+ * This flag is common to multiple configuration macros.
+ */
+#define CO_CONFIG_FLAG_RX_TIMESTAMP 0x8000
+
 /** This flag may be set globally for mainline objects to
  * @ref CO_CONFIG_FLAG_CALLBACK_PRE */
 #ifdef CO_DOXYGEN
@@ -114,6 +125,11 @@ extern "C" {
 #ifdef CO_DOXYGEN
 #define CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC CO_CONFIG_FLAG_OD_DYNAMIC
 #endif
+
+/** This flag may be set globally for SYNC, PDO and TIME to @ref CO_CONFIG_FLAG_RX_TIMESTAMP */
+#ifdef CO_DOXYGEN
+#define CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP (0)
+#endif
 /** @} */ /* CO_STACK_CONFIG_COMMON */
 
 /**
@@ -383,6 +399,19 @@ extern "C" {
  * - CO_CONFIG_SDO_CLI_LOCAL - Enable local transfer, if Node-ID of the SDO
  *   server is the same as node-ID of the SDO client. (SDO client is the same
  *   device as SDO server.) Transfer data directly without communication on CAN.
+ * - CO_CONFIG_SDO_CLI_POOL - Use SDO clients from the Object Dictionary
+ *   (0x1280..0x12FF) as a pool of parallel SDO channels, @ref CO_SDOengine.
+ *   Pool is created by CO_new(), processed by CO_process() and transfers are
+ *   submitted with CO_SDOengine_submit(co->SDOpool, ...). At most one transfer
+ *   per node is active, different nodes are served in parallel. If gateway
+ *   with SDO is used, first SDO client is left for the gateway.
+ * - CO_CONFIG_SDO_CLI_CACHE - Enable read-through cache for uploads of static
+ *   objects of remote nodes, @ref CO_SDOcache. Cache is attached to the SDO
+ *   client with CO_SDOclient_setCache(). CO_CONFIG_FIFO_ALT_READ must also be
+ *   set.
+ * - CO_CONFIG_SDO_CLI_RTT - Enable round trip time estimation of remote nodes,
+ *   adaptive SDO timeouts and fast retries of initiate requests, @ref CO_SDOrtt.
+ *   Estimator is attached to the SDO client with CO_SDOclient_setRtt().
  * - #CO_CONFIG_FLAG_CALLBACK_PRE - Enable custom callback after preprocessing
  *   received SDO CAN message.
  *   Callback is configured by CO_SDOclient_initCallbackPre().
@@ -399,6 +428,9 @@ extern "C" {
 #define CO_CONFIG_SDO_CLI_SEGMENTED 0x02
 #define CO_CONFIG_SDO_CLI_BLOCK     0x04
 #define CO_CONFIG_SDO_CLI_LOCAL     0x08
+#define CO_CONFIG_SDO_CLI_POOL      0x10
+#define CO_CONFIG_SDO_CLI_CACHE     0x20
+#define CO_CONFIG_SDO_CLI_RTT       0x40
 
 /**
  * Size of the internal data buffer for the SDO client.
@@ -432,12 +464,21 @@ extern "C" {
  *   Callback is configured by CO_TIME_initCallbackPre().
  * - #CO_CONFIG_FLAG_OD_DYNAMIC - Enable dynamic configuration - writing to
  *   object 0x1012 enables / disables time producer or consumer.
+ * - #CO_CONFIG_FLAG_RX_TIMESTAMP - Add the time between reception and
+ *   processing of TIME message to the received time.
+ * - CO_CONFIG_TIME_PRECISE - Clock disciplined time: producer sends the time of
+ *   CO_CANtimestampNow(), consumer estimates offset and drift of its clock
+ *   from receive timestamps of TIME messages, see CO_TIME_toNetwork_us().
+ *   Driver must provide CO_CANtimestampToUnix_us().
  */
 #ifdef CO_DOXYGEN
-#define CO_CONFIG_TIME (CO_CONFIG_TIME_ENABLE | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+#define CO_CONFIG_TIME                                                                                                 \
+    (CO_CONFIG_TIME_ENABLE | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC                     \
+     | CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP)
 #endif
 #define CO_CONFIG_TIME_ENABLE   0x01
 #define CO_CONFIG_TIME_PRODUCER 0x02
+#define CO_CONFIG_TIME_PRECISE  0x04
 /** @} */ /* CO_STACK_CONFIG_TIME */
 
 /**
@@ -457,11 +498,14 @@ extern "C" {
  * - #CO_CONFIG_FLAG_TIMERNEXT - Enable calculation of timerNext_us variable
  *   inside CO_SYNC_process().
  * - #CO_CONFIG_FLAG_OD_DYNAMIC - Enable dynamic configuration of SYNC.
+ * - #CO_CONFIG_FLAG_RX_TIMESTAMP - Start SYNC timer from the receive timestamp
+ *   of SYNC message, so SYNC timeout and synchronous window are measured from
+ *   the actual reception.
  */
 #ifdef CO_DOXYGEN
 #define CO_CONFIG_SYNC                                                                                                 \
     (CO_CONFIG_SYNC_ENABLE | CO_CONFIG_SYNC_PRODUCER | CO_CONFIG_GLOBAL_RT_FLAG_CALLBACK_PRE                           \
-     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC | CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP)
 #endif
 #define CO_CONFIG_SYNC_ENABLE   0x01
 #define CO_CONFIG_SYNC_PRODUCER 0x02
@@ -482,18 +526,27 @@ extern "C" {
  *   flexibility for application program, but consumes some additional memory
  *   and processor resources. If this option is not enabled, then data from OD
  *   variables are fetched directly from memory allocated by Object dictionary.
+ * - CO_CONFIG_PDO_COPY_PLAN - Together with CO_CONFIG_PDO_OD_IO_ACCESS: when
+ *   PDO mapping is initialized or changed, mapped OD variables without
+ *   application specified read/write functions are converted into a short
+ *   list of memory copies, adjacent variables merged, see CO_PDO_copy_t. Only
+ *   variables with an OD extension (and dummy entries) are accessed with
+ *   @ref OD_IO_t read()/write(). Whole variable must be mapped, on big-endian
+ *   targets multibyte variables are still accessed with read()/write().
  * - #CO_CONFIG_FLAG_CALLBACK_PRE - Enable custom callback after preprocessing
  *   received RPDO CAN message.
  *   Callback is configured by CO_RPDO_initCallbackPre().
  * - #CO_CONFIG_FLAG_TIMERNEXT - Enable calculation of timerNext_us variable
  *   inside CO_TPDO_process().
  * - #CO_CONFIG_FLAG_OD_DYNAMIC - Enable dynamic configuration of PDO.
+ * - #CO_CONFIG_FLAG_RX_TIMESTAMP - Store receive timestamp of RPDO data, which
+ *   were written into OD, and measure RPDO timeout from the actual reception.
  */
 #ifdef CO_DOXYGEN
 #define CO_CONFIG_PDO                                                                                                  \
     (CO_CONFIG_RPDO_ENABLE | CO_CONFIG_TPDO_ENABLE | CO_CONFIG_RPDO_TIMERS_ENABLE | CO_CONFIG_TPDO_TIMERS_ENABLE       \
      | CO_CONFIG_PDO_SYNC_ENABLE | CO_CONFIG_PDO_OD_IO_ACCESS | CO_CONFIG_GLOBAL_RT_FLAG_CALLBACK_PRE                  \
-     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC | CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP)
 #endif
 #define CO_CONFIG_RPDO_ENABLE        0x01
 #define CO_CONFIG_TPDO_ENABLE        0x02
@@ -501,6 +554,7 @@ extern "C" {
 #define CO_CONFIG_TPDO_TIMERS_ENABLE 0x08
 #define CO_CONFIG_PDO_SYNC_ENABLE    0x10
 #define CO_CONFIG_PDO_OD_IO_ACCESS   0x20
+#define CO_CONFIG_PDO_COPY_PLAN      0x40
 /** @} */ /* CO_STACK_CONFIG_SYNC_PDO */
 
 /**
@@ -513,11 +567,28 @@ extern "C" {
  *
  * Possible flags, can be ORed:
  * - CO_CONFIG_STORAGE_ENABLE - Enable data storage
+ * - CO_CONFIG_STORAGE_EEPROM_PAGES - @ref CO_storage_eeprom writes only changed pages of the entry on store. Requires
+ *   addrShadow in CO_storage_entry_t, see @ref CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE.
+ * - CO_CONFIG_STORAGE_EEPROM_ASYNC - @ref CO_storage_eeprom store command takes a snapshot of the entry and responds
+ *   immediately, data is written page by page by CO_storageEeprom_async_process(). Requires addrSnapshot, storeOffset
+ *   and storePending in CO_storage_entry_t.
  */
 #ifdef CO_DOXYGEN
 #define CO_CONFIG_STORAGE (CO_CONFIG_STORAGE_ENABLE)
 #endif
-#define CO_CONFIG_STORAGE_ENABLE 0x01
+#define CO_CONFIG_STORAGE_ENABLE       0x01
+#define CO_CONFIG_STORAGE_EEPROM_PAGES 0x02
+#define CO_CONFIG_STORAGE_EEPROM_ASYNC 0x04
+
+/**
+ * Size of the page in bytes, unit of change detection with CO_CONFIG_STORAGE_EEPROM_PAGES and unit of write with
+ * CO_CONFIG_STORAGE_EEPROM_ASYNC
+ *
+ * Usually equal to the write page of the eeprom chip (64 for 25LC256), so each changed page costs one page write.
+ */
+#ifdef CO_DOXYGEN
+#define CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE 64
+#endif
 /** @} */ /* CO_STACK_CONFIG_STORAGE */
 
 /**
@@ -565,17 +636,31 @@ extern "C" {
  * Possible flags, can be ORed:
  * - CO_CONFIG_SRDO_ENABLE - Enable the SRDO object.
  * - CO_CONFIG_SRDO_CHECK_TX - Enable checking data before sending.
+ * - CO_CONFIG_SRDO_COPY_PLAN - When SRDO is configured, mapped OD variables
+ *   without application specified read/write functions are converted into a
+ *   short list of memory copies for the normal and for the inverted frame,
+ *   adjacent variables merged, same as CO_CONFIG_PDO_COPY_PLAN, see
+ *   CO_SRDO_copy_t.
+ * - CO_CONFIG_SRDO_TX_INVERT - Inverted frame of Tx SRDO is generated from the
+ *   normal frame by bitwise inversion, word by word. Inverted mapped OD
+ *   variables are not read, so second channel of the application data is not
+ *   transmitted. Use only, if safety concept of the device does not require it.
  * - #CO_CONFIG_FLAG_CALLBACK_PRE - Enable custom callback after preprocessing
  *   received RSRDO CAN message.
  *   Callback is configured by CO_SRDO_initCallbackPre().
  * - #CO_CONFIG_FLAG_TIMERNEXT - Enable calculation of timerNext_us variable
  *   inside CO_SRDO_process() (Tx SRDO only).
+ * - #CO_CONFIG_FLAG_RX_TIMESTAMP - Measure SCT and SRVT of Rx SRDO from the
+ *   receive timestamps of the normal and inverted messages, instead of from
+ *   the time of processing.
  */
 #ifdef CO_DOXYGEN
 #define CO_CONFIG_SRDO (0)
 #endif
-#define CO_CONFIG_SRDO_ENABLE   0x01
-#define CO_CONFIG_SRDO_CHECK_TX 0x02
+#define CO_CONFIG_SRDO_ENABLE    0x01
+#define CO_CONFIG_SRDO_CHECK_TX  0x02
+#define CO_CONFIG_SRDO_COPY_PLAN 0x04
+#define CO_CONFIG_SRDO_TX_INVERT 0x08
 
 /**
  * SRDO Tx time delay
@@ -601,6 +686,7 @@ extern "C" {
  * - CO_CONFIG_LSS_SLAVE_FASTSCAN_DIRECT_RESPOND - Send LSS fastscan respond
  *   directly from CO_LSSslave_receive() function.
  * - CO_CONFIG_LSS_MASTER - Enable LSS master
+ * - CO_CONFIG_LSS_MASTER_BULK - Enable bulk node-ID assignment with LSS master, see CO_LSSmaster_bulkCommission().
  * - #CO_CONFIG_FLAG_CALLBACK_PRE - Enable custom callback after preprocessing
  *   received CAN message.
  *   Callback is configured by CO_LSSmaster_initCallbackPre().
@@ -611,6 +697,7 @@ extern "C" {
 #define CO_CONFIG_LSS_SLAVE                         0x01
 #define CO_CONFIG_LSS_SLAVE_FASTSCAN_DIRECT_RESPOND 0x02
 #define CO_CONFIG_LSS_MASTER                        0x10
+#define CO_CONFIG_LSS_MASTER_BULK                   0x20
 /** @} */ /* CO_STACK_CONFIG_LSS */
 
 /**
@@ -641,6 +728,9 @@ extern "C" {
  *   help usage.
  * - CO_CONFIG_GTW_ASCII_PRINT_LEDS - Display "red" and "green" CANopen status
  *   LED diodes on terminal.
+ * - CO_CONFIG_GTW_BINARY - Enable gateway device with binary length-prefixed
+ *   frames, @ref CO_CANopen_309_bin. It uses own SDO clients, see
+ *   CO_CONFIG_GTWB_SDO_CHANNELS, and NMT master and LSS master, if enabled.
  */
 #ifdef CO_DOXYGEN
 #define CO_CONFIG_GTW (0)
@@ -654,6 +744,7 @@ extern "C" {
 #define CO_CONFIG_GTW_ASCII_ERROR_DESC 0x40
 #define CO_CONFIG_GTW_ASCII_PRINT_HELP 0x80
 #define CO_CONFIG_GTW_ASCII_PRINT_LEDS 0x100
+#define CO_CONFIG_GTW_BINARY           0x200
 
 /**
  * Number of loops of #CO_SDOclientDownload() in case of block download
@@ -682,6 +773,25 @@ extern "C" {
 #ifdef CO_DOXYGEN
 #define CO_CONFIG_GTWA_LOG_BUF_SIZE 2000
 #endif
+
+/**
+ * Number of SDO client channels in binary gateway object.
+ *
+ * Requests to different nodes are processed in parallel on these channels.
+ * Each channel uses one CAN receive and one CAN transmit buffer.
+ */
+#ifdef CO_DOXYGEN
+#define CO_CONFIG_GTWB_SDO_CHANNELS 4
+#endif
+
+/**
+ * Number of outstanding requests in binary gateway object.
+ *
+ * Host may send that many requests without waiting for responses.
+ */
+#ifdef CO_DOXYGEN
+#define CO_CONFIG_GTWB_SLOTS 8
+#endif
 /** @} */ /* CO_STACK_CONFIG_GATEWAY */
 
 /**
@@ -695,12 +805,15 @@ extern "C" {
  * Possible flags, can be ORed:
  * - CO_CONFIG_CRC16_ENABLE - Enable CRC16 calculation
  * - CO_CONFIG_CRC16_EXTERNAL - CRC functions are defined externally
+ * - CO_CONFIG_CRC16_SLICING - crc16_ccitt() processes 8 bytes per step (slicing-by-8). Uses additional 3584 bytes of
+ *   constant tables, useful for SDO block transfer of large data.
  */
 #ifdef CO_DOXYGEN
 #define CO_CONFIG_CRC16 (0)
 #endif
 #define CO_CONFIG_CRC16_ENABLE   0x01
 #define CO_CONFIG_CRC16_EXTERNAL 0x02
+#define CO_CONFIG_CRC16_SLICING  0x04
 /** @} */ /* CO_STACK_CONFIG_CRC16 */
 
 /**
@@ -759,6 +872,61 @@ extern "C" {
 #define CO_CONFIG_TRACE_OWN_INTTYPES 0x02
 /** @} */ /* CO_STACK_CONFIG_TRACE */
 
+/**
+ * @defgroup CO_STACK_CONFIG_NET_STATE Network state
+ * Non standard object
+ * @{
+ */
+/**
+ * Configuration of @ref CO_netState, table of NMT and health states of remote nodes.
+ *
+ * Possible flags, can be ORed:
+ * - CO_CONFIG_NET_STATE_ENABLE - Enable network state table. It is filled by Heartbeat consumer, Node Guarding master
+ *   and Emergency consumer of the CANopen object.
+ */
+#ifdef CO_DOXYGEN
+#define CO_CONFIG_NET_STATE (0)
+#endif
+#define CO_CONFIG_NET_STATE_ENABLE 0x01
+/** @} */ /* CO_STACK_CONFIG_NET_STATE */
+
+/**
+ * @defgroup CO_STACK_CONFIG_EM_CONS Emergency consumer
+ * Non standard object
+ * @{
+ */
+/**
+ * Configuration of @ref CO_EMcons, queue and history of received emergency messages.
+ *
+ * Possible flags, can be ORed:
+ * - CO_CONFIG_EM_CONS_ENABLE - Enable Emergency consumer. It is filled by the Emergency object of the CANopen object,
+ *   which must have CO_CONFIG_EM_CONSUMER enabled.
+ */
+#ifdef CO_DOXYGEN
+#define CO_CONFIG_EM_CONS (0)
+#endif
+#define CO_CONFIG_EM_CONS_ENABLE 0x01
+/** @} */ /* CO_STACK_CONFIG_EM_CONS */
+
+/**
+ * @defgroup CO_STACK_CONFIG_PROF Hot-path profiling
+ * Non standard object
+ * @{
+ */
+/**
+ * Configuration of @ref CO_prof, execution time statistics of each step of CO_process(), CO_process_SYNC(),
+ * CO_process_RPDO(), CO_process_TPDO() and CO_process_SRDO().
+ *
+ * Possible flags, can be ORed:
+ * - CO_CONFIG_PROF_ENABLE - Enable profiling of the CANopen object. Target must provide CO_PROF_TIME_NS(), free running
+ *   clock in nanoseconds as uint32_t. Each step then costs one read of the clock.
+ */
+#ifdef CO_DOXYGEN
+#define CO_CONFIG_PROF (0)
+#endif
+#define CO_CONFIG_PROF_ENABLE 0x01
+/** @} */ /* CO_STACK_CONFIG_PROF */
+
 /**
  * @defgroup CO_STACK_CONFIG_DEBUG Debug messages
  * Messages from different parts of the stack.
@@ -43,6 +43,13 @@ extern "C" {
 #ifndef CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC
 #define CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC CO_CONFIG_FLAG_OD_DYNAMIC
 #endif
+#ifndef CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP
+#define CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP (0)
+#endif
+/* Length of CAN message on the bus, which carries len data bytes. CAN FD driver rounds it up to valid CAN FD length. */
+#ifndef CO_CAN_PADDED_LENGTH
+#define CO_CAN_PADDED_LENGTH(len) (len)
+#endif
 #ifdef CO_DEBUG_COMMON
 #if (CO_CONFIG_DEBUG) & CO_CONFIG_DEBUG_SDO_CLIENT
 #define CO_DEBUG_SDO_CLIENT(msg) CO_DEBUG_COMMON(msg)
@@ -207,6 +214,50 @@ CO_CANrxMsg_readData(void* rxMsg) {
     return NULL;
 }
 
+/**
+ * CANrx_callback() can read receive timestamp of CAN message
+ *
+ * Must be defined in the **CO_driver_target.h** file, if @ref CO_CONFIG_FLAG_RX_TIMESTAMP is used by any object.
+ * Timestamp should be taken as close to the CAN controller as possible, for example by the CAN controller hardware or
+ * by the receive interrupt. It is used together with CO_CANtimestampNow().
+ *
+ * @param rxMsg Pointer to received message
+ * @return Receive time in microseconds or 0, if timestamp is not available.
+ */
+static inline uint64_t
+CO_CANrxMsg_readTimestamp(void* rxMsg) {
+    return 0;
+}
+
+/**
+ * Current time in the same time base as CO_CANrxMsg_readTimestamp()
+ *
+ * Must be defined in the **CO_driver_target.h** file, if @ref CO_CONFIG_FLAG_RX_TIMESTAMP is used by any object.
+ * Clock must be monotonic, SYNC, RPDO and SRDO timeouts are ages calculated from it. A step of the system time would
+ * otherwise hide a missing message or report a timeout, which did not happen.
+ *
+ * @return Current time in microseconds.
+ */
+static inline uint64_t
+CO_CANtimestampNow(void) {
+    return 0;
+}
+
+/**
+ * Convert time from CO_CANtimestampNow() into wall clock time
+ *
+ * Must be defined in the **CO_driver_target.h** file, if @ref CO_CONFIG_TIME_PRECISE is used. It is used by TIME
+ * producer only.
+ *
+ * @param timestamp_us Time from CO_CANtimestampNow() or CO_CANrxMsg_readTimestamp().
+ *
+ * @return Time in microseconds since January 1, 1970 or 0, if timestamp_us is 0.
+ */
+static inline uint64_t
+CO_CANtimestampToUnix_us(uint64_t timestamp_us) {
+    return 0;
+}
+
 /**
  * Configuration object for CAN received message for specific \ref CO_obj "CANopenNode Object".
  *
@@ -309,6 +360,13 @@ typedef struct {
                                    CO_storage_eeprom. */
     size_t eepromAddr; /**< Address of data inside eeprom, set by init, required with @ref CO_storage_eeprom. */
     size_t offset; /**< Offset of next byte being updated by automatic storage, required with @ref CO_storage_eeprom. */
+    void* addrShadow; /**< Copy of the data as it is in eeprom, len bytes, maintained by @ref CO_storage_eeprom. If not
+                         NULL, only changed pages are written. Required with CO_CONFIG_STORAGE_EEPROM_PAGES. */
+    void* addrSnapshot;  /**< Buffer of len bytes for the snapshot of the data. If not NULL, store command only takes
+                            the snapshot, which is then written by @ref CO_storageEeprom_async_process(). Required
+                            with CO_CONFIG_STORAGE_EEPROM_ASYNC. */
+    size_t storeOffset;  /**< Offset of the next page of the snapshot, required with CO_CONFIG_STORAGE_EEPROM_ASYNC. */
+    bool_t storePending; /**< True, if snapshot is not yet stored, required with CO_CONFIG_STORAGE_EEPROM_ASYNC. */
     void* additionalParameters; /**< Additional target specific parameters, optional. */
 } CO_storage_entry_t;
 
@@ -376,6 +434,10 @@ typedef struct {
         __sync_synchronize();                                                                                          \
         rxNew = NULL;                                                                                                  \
     }
+/** Atomically set mask bits in uint32_t bitmap, after received data are stored. Optional, see @ref CO_RPDO_ready_t */
+#define CO_FLAG_BITS_SET(bits, mask)   (void)__sync_fetch_and_or(&(bits), (mask))
+/** Atomically read uint32_t bitmap and clear it, before data are processed. Optional. */
+#define CO_FLAG_BITS_TAKE(bits)        __sync_fetch_and_and(&(bits), 0U)
 
 /** @} */
 #endif /* CO_DOXYGEN */
@@ -410,6 +472,23 @@ typedef struct {
 
 /** @} */ /* CO_Default_CAN_ID_t */
 
+/**
+ * Time in microseconds, which passed since receive timestamp.
+ *
+ * @param timestamp_us Timestamp from CO_CANrxMsg_readTimestamp(). If 0, timestamp is not available.
+ * @param now_us Current time from CO_CANtimestampNow().
+ *
+ * @return Time since reception, limited to UINT32_MAX, or 0, if timestamp is not available or is in the future.
+ */
+static inline uint32_t
+CO_CANtimestampAge(uint64_t timestamp_us, uint64_t now_us) {
+    uint64_t age = 0U;
+    if ((timestamp_us != 0U) && (now_us > timestamp_us)) {
+        age = now_us - timestamp_us;
+    }
+    return (age > UINT32_MAX) ? UINT32_MAX : (uint32_t)age;
+}
+
 /**
  * Restricted CAN-IDs
  *
@@ -77,49 +77,53 @@ CO_fifo_init(CO_fifo_t* fifo, uint8_t* buf, size_t bufSize) {
  ******************************************************************************/
 size_t
 CO_fifo_write(CO_fifo_t* fifo, const uint8_t* buf, size_t count, uint16_t* crc) {
-    size_t i;
-    uint8_t* bufDest;
+    size_t countWritten = 0;
 
     if ((fifo == NULL) || (fifo->buf == NULL) || (buf == NULL)) {
         return 0;
     }
 
-    bufDest = &fifo->buf[fifo->writePtr];
-    for (i = count; i > 0U; i--) {
-        size_t writePtrNext = fifo->writePtr + 1U;
+    /* copy in at most two contiguous chunks: up to the end of the buffer and from its start. One byte before readPtr
+     * stays free. writePtr is updated after the data are copied. */
+    while (countWritten < count) {
+        size_t readPtr = fifo->readPtr;
+        size_t writeEnd;
 
-        /* is circular buffer full */
-        if ((writePtrNext == fifo->readPtr) || ((writePtrNext == fifo->bufSize) && (fifo->readPtr == 0U))) {
-            break;
+        if (readPtr > fifo->writePtr) {
+            writeEnd = readPtr - 1U;
+        } else if (readPtr == 0U) {
+            writeEnd = fifo->bufSize - 1U;
+        } else {
+            writeEnd = fifo->bufSize;
         }
 
-        *bufDest = *buf;
-
-#if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_CRC16_CCITT) != 0
-        if (crc != NULL) {
-            crc16_ccitt_single(crc, *buf);
+        size_t chunk = writeEnd - fifo->writePtr;
+        if (chunk > (count - countWritten)) {
+            chunk = count - countWritten;
         }
-#endif
-
-        /* increment variables */
-        if (writePtrNext == fifo->bufSize) {
-            fifo->writePtr = 0;
-            bufDest = &fifo->buf[0];
-        } else {
-            fifo->writePtr++;
-            bufDest++;
+        if (chunk == 0U) {
+            break; /* circular buffer is full */
         }
-        buf++;
+
+        (void)memcpy(&fifo->buf[fifo->writePtr], &buf[countWritten], chunk);
+        countWritten += chunk;
+        fifo->writePtr = ((fifo->writePtr + chunk) == fifo->bufSize) ? 0U : (fifo->writePtr + chunk);
+    }
+
+#if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_CRC16_CCITT) != 0
+    /* written data are contiguous in the source buffer */
+    if (crc != NULL) {
+        *crc = crc16_ccitt(buf, countWritten, *crc);
     }
+#endif
 
-    return count - i;
+    return countWritten;
 }
 
 size_t
 CO_fifo_read(CO_fifo_t* fifo, uint8_t* buf, size_t count, bool_t* eof) {
-    size_t i;
-    const uint8_t* bufSrc;
-    bool_t alive_cycle = true;
+    size_t countRead = 0;
+    bool_t delimiter = false;
 
     if (eof != NULL) {
         *eof = false;
@@ -128,37 +132,38 @@ CO_fifo_read(CO_fifo_t* fifo, uint8_t* buf, size_t count, bool_t* eof) {
         return 0;
     }
 
-    bufSrc = &fifo->buf[fifo->readPtr];
-    for (i = count; (i > 0U) && alive_cycle;) {
-        const uint8_t c = *bufSrc;
-
-        /* is circular buffer empty */
-        if (fifo->readPtr == fifo->writePtr) {
-            alive_cycle = false;
-        } else {
-            *buf = c;
-            buf++;
+    /* copy in at most two contiguous chunks, readPtr is updated after the data are copied */
+    while ((countRead < count) && !delimiter) {
+        size_t writePtr = fifo->writePtr;
+        size_t readEnd = (writePtr >= fifo->readPtr) ? writePtr : fifo->bufSize;
+        const uint8_t* bufSrc = &fifo->buf[fifo->readPtr];
 
-            /* increment variables */
-            if (++fifo->readPtr == fifo->bufSize) {
-                fifo->readPtr = 0;
-                bufSrc = &fifo->buf[0];
-            } else {
-                bufSrc++;
-            }
-            i--;
+        size_t chunk = readEnd - fifo->readPtr;
+        if (chunk > (count - countRead)) {
+            chunk = count - countRead;
+        }
+        if (chunk == 0U) {
+            break; /* circular buffer is empty */
+        }
 
 #if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_ASCII_COMMANDS) != 0
-            /* is delimiter? */
-            if ((eof != NULL) && (c == DELIM_COMMAND)) {
+        /* stop after delimiter */
+        if (eof != NULL) {
+            const uint8_t* delim = (const uint8_t*)memchr((const void*)bufSrc, (int32_t)DELIM_COMMAND, chunk);
+            if (delim != NULL) {
+                chunk = (size_t)(delim - bufSrc) + 1U;
+                delimiter = true;
                 *eof = true;
-                alive_cycle = false;
             }
-#endif
         }
+#endif
+
+        (void)memcpy(&buf[countRead], bufSrc, chunk);
+        countRead += chunk;
+        fifo->readPtr = ((fifo->readPtr + chunk) == fifo->bufSize) ? 0U : (fifo->readPtr + chunk);
     }
 
-    return count - i;
+    return countRead;
 }
 
 #if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_ALT_READ) != 0
@@ -196,49 +201,41 @@ CO_fifo_altFinish(CO_fifo_t* fifo, uint16_t* crc) {
     if (crc == NULL) {
         fifo->readPtr = fifo->altReadPtr;
     } else {
-        const uint8_t* bufSrc = &fifo->buf[fifo->readPtr];
-        while (fifo->readPtr != fifo->altReadPtr) {
 #if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_CRC16_CCITT) != 0
-            crc16_ccitt_single(crc, *bufSrc);
-#endif
-            /* increment variable */
-            if (++fifo->readPtr == fifo->bufSize) {
-                fifo->readPtr = 0;
-                bufSrc = &fifo->buf[0];
-            } else {
-                bufSrc++;
-            }
+        /* data are in one or two contiguous runs, split at the end of the buffer */
+        if (fifo->altReadPtr < fifo->readPtr) {
+            *crc = crc16_ccitt(&fifo->buf[fifo->readPtr], fifo->bufSize - fifo->readPtr, *crc);
+            fifo->readPtr = 0;
         }
+        *crc = crc16_ccitt(&fifo->buf[fifo->readPtr], fifo->altReadPtr - fifo->readPtr, *crc);
+#endif
+        fifo->readPtr = fifo->altReadPtr;
     }
 }
 
 size_t
 CO_fifo_altRead(CO_fifo_t* fifo, uint8_t* buf, size_t count) {
-    size_t i;
-    const uint8_t* bufSrc;
+    size_t countRead = 0;
 
-    bufSrc = &fifo->buf[fifo->altReadPtr];
-    for (i = count; i > 0U; i--) {
-        const uint8_t c = *bufSrc;
+    /* copy in at most two contiguous chunks */
+    while (countRead < count) {
+        size_t writePtr = fifo->writePtr;
+        size_t readEnd = (writePtr >= fifo->altReadPtr) ? writePtr : fifo->bufSize;
 
-        /* is there no more data */
-        if (fifo->altReadPtr == fifo->writePtr) {
-            break;
+        size_t chunk = readEnd - fifo->altReadPtr;
+        if (chunk > (count - countRead)) {
+            chunk = count - countRead;
         }
-
-        *buf = c;
-        buf++;
-
-        /* increment variables */
-        if (++fifo->altReadPtr == fifo->bufSize) {
-            fifo->altReadPtr = 0;
-            bufSrc = &fifo->buf[0];
-        } else {
-            bufSrc++;
+        if (chunk == 0U) {
+            break; /* no more data */
         }
+
+        (void)memcpy(&buf[countRead], &fifo->buf[fifo->altReadPtr], chunk);
+        countRead += chunk;
+        fifo->altReadPtr = ((fifo->altReadPtr + chunk) == fifo->bufSize) ? 0U : (fifo->altReadPtr + chunk);
     }
 
-    return count - i;
+    return countRead;
 }
 #endif /* (CO_CONFIG_FIFO) & CO_CONFIG_FIFO_ALT_READ */
 
@@ -0,0 +1,171 @@
+/*
+ * CANopen timers and receive events of monitored nodes, for Heartbeat consumer and Node Guarding master.
+ *
+ * @file        CO_nodeTimers.c
+ * @ingroup     CO_nodeTimers
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "301/CO_nodeTimers.h"
+
+#if CO_NODE_TIMERS > 0
+
+#if !defined CO_FLAG_BITS_SET || !defined CO_FLAG_BITS_TAKE
+#error CO_NODE_TIMERS requires CO_FLAG_BITS_SET() and CO_FLAG_BITS_TAKE() in CO_driver_target.h
+#endif
+
+/* True, if deadline a is before deadline b, modulo 2^32 */
+static inline bool_t
+CO_nodeTimers_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+/* Put slot to heap position pos and remember the position */
+static inline void
+CO_nodeTimers_place(CO_nodeTimers_t* timers, uint8_t pos, uint8_t slot) {
+    timers->heap[pos] = slot;
+    timers->heapPos[slot] = pos + 1U;
+}
+
+/* Restore heap order for the slot at position pos, which deadline has changed */
+static void
+CO_nodeTimers_sift(CO_nodeTimers_t* timers, uint8_t pos) {
+    uint8_t slot = timers->heap[pos];
+    uint32_t deadline = timers->deadline_us[slot];
+
+    /* up */
+    while (pos > 0U) {
+        uint8_t parent = (pos - 1U) / 2U;
+        if (!CO_nodeTimers_before(deadline, timers->deadline_us[timers->heap[parent]])) {
+            break;
+        }
+        CO_nodeTimers_place(timers, pos, timers->heap[parent]);
+        pos = parent;
+    }
+
+    /* down */
+    for (;;) {
+        uint16_t child = ((uint16_t)pos * 2U) + 1U;
+        if (child >= timers->count) {
+            break;
+        }
+        if (((child + 1U) < timers->count)
+            && CO_nodeTimers_before(timers->deadline_us[timers->heap[child + 1U]],
+                                    timers->deadline_us[timers->heap[child]])) {
+            child++;
+        }
+        if (!CO_nodeTimers_before(timers->deadline_us[timers->heap[child]], deadline)) {
+            break;
+        }
+        CO_nodeTimers_place(timers, pos, timers->heap[child]);
+        pos = (uint8_t)child;
+    }
+    CO_nodeTimers_place(timers, pos, slot);
+}
+
+void
+CO_nodeTimers_init(CO_nodeTimers_t* timers) {
+    (void)memset(timers, 0, sizeof(CO_nodeTimers_t));
+}
+
+void
+CO_nodeTimers_clear(CO_nodeTimers_t* timers) {
+    for (uint8_t i = 0; i < timers->count; i++) {
+        timers->heapPos[timers->heap[i]] = 0;
+    }
+    timers->count = 0;
+    for (uint8_t w = 0; w < CO_NODE_TIMERS_WORDS; w++) {
+        (void)CO_FLAG_BITS_TAKE(timers->events[w]);
+        timers->eventsTaken[w] = 0;
+    }
+}
+
+void
+CO_nodeTimers_start(CO_nodeTimers_t* timers, uint8_t slot, uint32_t delay_us) {
+    if (slot >= CO_NODE_TIMERS_SIZE) {
+        return;
+    }
+    timers->deadline_us[slot] = timers->now_us + delay_us;
+    if (timers->heapPos[slot] == 0U) {
+        CO_nodeTimers_place(timers, timers->count, slot);
+        timers->count++;
+    }
+    CO_nodeTimers_sift(timers, timers->heapPos[slot] - 1U);
+}
+
+void
+CO_nodeTimers_stop(CO_nodeTimers_t* timers, uint8_t slot) {
+    if ((slot >= CO_NODE_TIMERS_SIZE) || (timers->heapPos[slot] == 0U)) {
+        return;
+    }
+    uint8_t pos = timers->heapPos[slot] - 1U;
+
+    timers->heapPos[slot] = 0;
+    timers->count--;
+    if (pos < timers->count) {
+        /* move the last slot into the gap */
+        CO_nodeTimers_place(timers, pos, timers->heap[timers->count]);
+        CO_nodeTimers_sift(timers, pos);
+    }
+}
+
+void
+CO_nodeTimers_takeEvents(CO_nodeTimers_t* timers) {
+    for (uint8_t w = 0; w < CO_NODE_TIMERS_WORDS; w++) {
+        timers->eventsTaken[w] |= CO_FLAG_BITS_TAKE(timers->events[w]);
+    }
+}
+
+int16_t
+CO_nodeTimers_nextEvent(CO_nodeTimers_t* timers) {
+    for (uint8_t w = 0; w < CO_NODE_TIMERS_WORDS; w++) {
+        uint32_t bits = timers->eventsTaken[w];
+        if (bits != 0U) {
+            uint8_t bit = 0;
+#if defined __GNUC__
+            bit = (uint8_t)__builtin_ctz(bits);
+#else
+            while ((bits & (1UL << bit)) == 0U) {
+                bit++;
+            }
+#endif
+            timers->eventsTaken[w] = bits & (bits - 1U);
+            return (int16_t)((w * 32U) + bit);
+        }
+    }
+    return -1;
+}
+
+int16_t
+CO_nodeTimers_nextExpired(const CO_nodeTimers_t* timers) {
+    if ((timers->count == 0U) || CO_nodeTimers_before(timers->now_us, timers->deadline_us[timers->heap[0]])) {
+        return -1;
+    }
+    return (int16_t)timers->heap[0];
+}
+
+void
+CO_nodeTimers_timerNext(const CO_nodeTimers_t* timers, uint32_t* timerNext_us) {
+    if ((timerNext_us != NULL) && (timers->count > 0U)) {
+        uint32_t diff = timers->deadline_us[timers->heap[0]] - timers->now_us;
+        if (CO_nodeTimers_before(timers->deadline_us[timers->heap[0]], timers->now_us)) {
+            diff = 0;
+        }
+        if (*timerNext_us > diff) {
+            *timerNext_us = diff;
+        }
+    }
+}
+
+#endif /* CO_NODE_TIMERS > 0 */
@@ -0,0 +1,173 @@
+/**
+ * CANopen timers and receive events of monitored nodes, for Heartbeat consumer and Node Guarding master.
+ *
+ * @file        CO_nodeTimers.h
+ * @ingroup     CO_nodeTimers
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_NODE_TIMERS_H
+#define CO_NODE_TIMERS_H
+
+#include "301/CO_driver.h"
+
+/**
+ * Enable timers of monitored nodes inside Heartbeat consumer and Node Guarding master.
+ *
+ * If set to 1, CO_HBconsumer_process() and CO_nodeGuardingMaster_process() don't walk all monitored nodes on each
+ * call. Received messages mark their node in a bitmap and the deadlines of all nodes are kept in a binary min-heap,
+ * so processing touches only nodes with received messages and nodes with expired deadline, and timerNext_us is the
+ * nearest deadline. Requires CO_FLAG_BITS_SET() and CO_FLAG_BITS_TAKE() from CO_driver_target.h.
+ */
+#ifndef CO_NODE_TIMERS
+#define CO_NODE_TIMERS 0
+#endif
+
+#if (CO_NODE_TIMERS > 0) || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_nodeTimers Node timers
+ * Deadlines and receive events of up to 127 monitored nodes.
+ *
+ * @ingroup CO_CANopen_301
+ * @{
+ * Owner (Heartbeat consumer or Node Guarding master) identifies nodes by slot, index in its own array. Receive
+ * callback calls CO_nodeTimers_event() for the slot. Process function calls CO_nodeTimers_advance() with the time
+ * difference, then CO_nodeTimers_takeEvents() and CO_nodeTimers_nextEvent() for received messages and
+ * CO_nodeTimers_nextExpired() for expired deadlines. Deadline of the slot is set by CO_nodeTimers_start().
+ *
+ * Time is kept as uint32_t microseconds and compared modulo 2^32, so deadlines must not be more than 35 minutes
+ * ahead. Heartbeat and guard times are at most 65,535 seconds.
+ *
+ * Except CO_nodeTimers_event(), all functions must be called from the thread, which processes the owner.
+ */
+
+/** Maximum number of slots, monitored nodes */
+#define CO_NODE_TIMERS_SIZE 127U
+
+/** Number of uint32_t words of the event bitmap */
+#define CO_NODE_TIMERS_WORDS ((CO_NODE_TIMERS_SIZE + 31U) / 32U)
+
+/** Node timers object */
+typedef struct {
+    uint32_t now_us;                                /**< Current time, from CO_nodeTimers_advance() */
+    uint32_t deadline_us[CO_NODE_TIMERS_SIZE];      /**< Deadline of each slot, valid if slot is in the heap */
+    uint8_t heap[CO_NODE_TIMERS_SIZE];              /**< Slots ordered as binary min-heap by deadline */
+    uint8_t heapPos[CO_NODE_TIMERS_SIZE];           /**< Position of the slot in the heap + 1, 0 if not started */
+    uint8_t count;                                  /**< Number of slots in the heap */
+    volatile uint32_t events[CO_NODE_TIMERS_WORDS]; /**< Slots with received message, set from receive callback */
+    uint32_t eventsTaken[CO_NODE_TIMERS_WORDS];     /**< Events of the current processing, see takeEvents() */
+} CO_nodeTimers_t;
+
+/**
+ * Initialize node timers, all stopped and without events
+ *
+ * @param timers This object.
+ */
+void CO_nodeTimers_init(CO_nodeTimers_t* timers);
+
+/**
+ * Stop all timers and discard events, for example if (pre)operational state of this node changed
+ *
+ * @param timers This object.
+ */
+void CO_nodeTimers_clear(CO_nodeTimers_t* timers);
+
+/**
+ * Mark slot with received message, may be called from the receive callback
+ *
+ * @param timers This object.
+ * @param slot Slot, < CO_NODE_TIMERS_SIZE.
+ */
+static inline void
+CO_nodeTimers_event(CO_nodeTimers_t* timers, uint8_t slot) {
+    CO_FLAG_BITS_SET(timers->events[slot >> 5], 1UL << (slot & 0x1FU));
+}
+
+/**
+ * Advance time
+ *
+ * @param timers This object.
+ * @param timeDifference_us Time difference from previous call.
+ */
+static inline void
+CO_nodeTimers_advance(CO_nodeTimers_t* timers, uint32_t timeDifference_us) {
+    timers->now_us += timeDifference_us;
+}
+
+/**
+ * Start or restart the timer of the slot
+ *
+ * @param timers This object.
+ * @param slot Slot, < CO_NODE_TIMERS_SIZE.
+ * @param delay_us Deadline is current time + delay_us. If 0, slot expires in the current processing.
+ */
+void CO_nodeTimers_start(CO_nodeTimers_t* timers, uint8_t slot, uint32_t delay_us);
+
+/**
+ * Stop the timer of the slot, if it is started
+ *
+ * @param timers This object.
+ * @param slot Slot, < CO_NODE_TIMERS_SIZE.
+ */
+void CO_nodeTimers_stop(CO_nodeTimers_t* timers, uint8_t slot);
+
+/**
+ * Take received events for processing with CO_nodeTimers_nextEvent()
+ *
+ * Events, received later, are processed in the next processing.
+ *
+ * @param timers This object.
+ */
+void CO_nodeTimers_takeEvents(CO_nodeTimers_t* timers);
+
+/**
+ * Get next slot with event from CO_nodeTimers_takeEvents()
+ *
+ * @param timers This object.
+ *
+ * @return Slot, lowest first, or -1, if there are no more events.
+ */
+int16_t CO_nodeTimers_nextEvent(CO_nodeTimers_t* timers);
+
+/**
+ * Get slot with the nearest deadline, if it is expired
+ *
+ * Slot stays in the heap. Caller must restart or stop it, before calling the function again.
+ *
+ * @param timers This object.
+ *
+ * @return Slot or -1, if no deadline is expired.
+ */
+int16_t CO_nodeTimers_nextExpired(const CO_nodeTimers_t* timers);
+
+/**
+ * Lower timerNext_us to the time until the nearest deadline
+ *
+ * @param timers This object.
+ * @param [in,out] timerNext_us info to OS - see CO_process(), may be NULL.
+ */
+void CO_nodeTimers_timerNext(const CO_nodeTimers_t* timers, uint32_t* timerNext_us);
+
+/** @} */ /* CO_nodeTimers */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CO_NODE_TIMERS > 0 */
+
+#endif /* CO_NODE_TIMERS_H */
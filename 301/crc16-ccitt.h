@@ -60,6 +60,8 @@ void crc16_ccitt_single(uint16_t* crc, const uint8_t chr);
 /**
  * Calculate CRC sum on block of data.
  *
+ * With CO_CONFIG_CRC16_SLICING data are processed 8 bytes per step with additional tables, otherwise byte by byte.
+ *
  * @param block Pointer to block of data.
  * @param blockLength Length of data in bytes;
  * @param crc Initial value (zero for xmodem). If block is split into multiple segments, previous CRC is used as
@@ -53,6 +53,9 @@ CO_SRDO_receive_normal(void* object, void* msg) {
     if ((SRDO->informationDirection == CO_SRDO_RX) && (DLC >= SRDO->dataLength) && !CO_FLAG_READ(SRDO->CANrxNew[1])) {
         /* copy data into appropriate buffer and set 'new message' flag */
         (void)memcpy(SRDO->CANrxData[0], data, sizeof(SRDO->CANrxData[0]));
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+        SRDO->CANrxTimestamp_us[0] = CO_CANrxMsg_readTimestamp(msg);
+#endif
         CO_FLAG_SET(SRDO->CANrxNew[0]);
 
 #if ((CO_CONFIG_SRDO)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
@@ -76,6 +79,9 @@ CO_SRDO_receive_inverted(void* object, void* msg) {
     if ((SRDO->informationDirection == CO_SRDO_RX) && (DLC >= SRDO->dataLength) && CO_FLAG_READ(SRDO->CANrxNew[0])) {
         /* copy data into appropriate buffer and set 'new message' flag */
         (void)memcpy(SRDO->CANrxData[1], data, sizeof(SRDO->CANrxData[1]));
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+        SRDO->CANrxTimestamp_us[1] = CO_CANrxMsg_readTimestamp(msg);
+#endif
         CO_FLAG_SET(SRDO->CANrxNew[1]);
 
 #if ((CO_CONFIG_SRDO)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
@@ -414,6 +420,227 @@ CO_SRDOGuard_init(CO_SRDOGuard_t* SRDOGuard, OD_entry_t* OD_13FE_configurationVa
     return CO_ERROR_NO;
 }
 
+/*
+ * Verify, if SRDO data are bitwise inverted
+ *
+ * Data are compared word by word and all words are always compared, so execution time depends only on length.
+ *
+ * @param normal Data of the normal message.
+ * @param inverted Data of the inverted message.
+ * @param length Number of bytes to compare.
+ *
+ * @return True, if each bit of inverted is inverse of the bit in normal.
+ */
+static bool_t
+SRDO_isInverted(const uint8_t* normal, const uint8_t* inverted, CO_SRDO_size_t length) {
+    uint32_t diff = 0;
+    CO_SRDO_size_t i = 0;
+
+    for (; (i + 4U) <= length; i += 4U) {
+        uint32_t wordNormal, wordInverted;
+        (void)memcpy(&wordNormal, &normal[i], sizeof(wordNormal));
+        (void)memcpy(&wordInverted, &inverted[i], sizeof(wordInverted));
+        diff |= ~(wordNormal ^ wordInverted);
+    }
+    for (; i < length; i++) {
+        diff |= (uint8_t)(~(normal[i] ^ inverted[i]));
+    }
+
+    return diff == 0U;
+}
+
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_TX_INVERT) != 0
+/*
+ * Generate inverted SRDO data from normal data, word by word
+ *
+ * @param inverted Data of the inverted message, will be written.
+ * @param normal Data of the normal message.
+ * @param length Number of bytes.
+ */
+static void
+SRDO_invert(uint8_t* inverted, const uint8_t* normal, CO_SRDO_size_t length) {
+    CO_SRDO_size_t i = 0;
+
+    for (; (i + 4U) <= length; i += 4U) {
+        uint32_t word;
+        (void)memcpy(&word, &normal[i], sizeof(word));
+        word ^= 0xFFFFFFFFU;
+        (void)memcpy(&inverted[i], &word, sizeof(word));
+    }
+    for (; i < length; i++) {
+        inverted[i] = (uint8_t)(~normal[i]);
+    }
+}
+#endif
+
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+/*
+ * Remaining time of SRDO timer, which was started at reception of the message
+ *
+ * @param time_us Time of the timer.
+ * @param timestamp_us Receive timestamp of the message, 0 if not available.
+ * @param now_us Current time from CO_CANtimestampNow().
+ *
+ * @return Remaining time, time_us if timestamp is not available, 0 if timer already expired.
+ */
+static uint32_t
+SRDO_timerFromRx(uint32_t time_us, uint64_t timestamp_us, uint64_t now_us) {
+    uint32_t age = CO_CANtimestampAge(timestamp_us, now_us);
+    return (age < time_us) ? (time_us - age) : 0U;
+}
+#endif
+
+/*
+ * Read mapped OD variable with OD_IO.read() into part of the SRDO
+ *
+ * @param OD_IO Object dictionary interface of the mapped entry.
+ * @param dataSRDO Data of the entry in SRDO.
+ * @param mappedLength Number of bytes of the entry in SRDO.
+ */
+static void
+SRDO_readOD(OD_IO_t* OD_IO, uint8_t* dataSRDO, uint8_t mappedLength) {
+    OD_stream_t* stream = &OD_IO->stream;
+
+    /* length of OD variable may be larger than mappedLength */
+    OD_size_t ODdataLength = stream->dataLength;
+    if (ODdataLength > CO_SRDO_MAX_SIZE) {
+        ODdataLength = CO_SRDO_MAX_SIZE;
+    }
+    /* If mappedLength is smaller than ODdataLength, use auxiliary buffer */
+    uint8_t buf[CO_SRDO_MAX_SIZE];
+    uint8_t* dataSRDOCopy;
+    if (ODdataLength > mappedLength) {
+        (void)memset(buf, 0, sizeof(buf));
+        dataSRDOCopy = buf;
+    } else {
+        dataSRDOCopy = dataSRDO;
+    }
+
+    /* Set stream.dataOffset to zero, perform OD_IO.read() and store mappedLength back to stream.dataOffset */
+    stream->dataOffset = 0;
+    OD_size_t countRd;
+    OD_IO->read(stream, dataSRDOCopy, ODdataLength, &countRd);
+    stream->dataOffset = mappedLength;
+
+    /* swap multibyte data if big-endian */
+#ifdef CO_BIG_ENDIAN
+    if ((stream->attribute & ODA_MB) != 0) {
+        uint8_t* lo = dataSRDOCopy;
+        uint8_t* hi = dataSRDOCopy + ODdataLength - 1;
+        while (lo < hi) {
+            uint8_t swap = *lo;
+            *lo++ = *hi;
+            *hi-- = swap;
+        }
+    }
+#endif
+
+    /* If auxiliary buffer, copy it to the SRDO */
+    if (ODdataLength > mappedLength) {
+        (void)memcpy(dataSRDO, buf, mappedLength);
+    }
+}
+
+/*
+ * Write part of the received SRDO into mapped OD variable with OD_IO.write()
+ *
+ * @param OD_IO Object dictionary interface of the mapped entry.
+ * @param dataSRDO Received data of the entry, may be modified.
+ * @param mappedLength Number of bytes of the entry in SRDO.
+ */
+static void
+SRDO_writeOD(OD_IO_t* OD_IO, uint8_t* dataSRDO, uint8_t mappedLength) {
+    OD_size_t* dataOffset = &OD_IO->stream.dataOffset;
+
+    /* length of OD variable may be larger than mappedLength */
+    OD_size_t ODdataLength = OD_IO->stream.dataLength;
+    if (ODdataLength > CO_SRDO_MAX_SIZE) {
+        ODdataLength = CO_SRDO_MAX_SIZE;
+    }
+    /* Prepare data for writing into OD variable. If mappedLength
+     * is smaller than ODdataLength, then use auxiliary buffer */
+    uint8_t buf[CO_SRDO_MAX_SIZE];
+    uint8_t* dataOD;
+    if (ODdataLength > mappedLength) {
+        (void)memset(buf, 0, sizeof(buf));
+        (void)memcpy(buf, dataSRDO, mappedLength);
+        dataOD = buf;
+    } else {
+        dataOD = dataSRDO;
+    }
+
+    /* swap multibyte data if big-endian */
+#ifdef CO_BIG_ENDIAN
+    if ((OD_IO->stream.attribute & ODA_MB) != 0) {
+        uint8_t* lo = dataOD;
+        uint8_t* hi = dataOD + ODdataLength - 1;
+        while (lo < hi) {
+            uint8_t swap = *lo;
+            *lo++ = *hi;
+            *hi-- = swap;
+        }
+    }
+#endif
+
+    /* Set stream.dataOffset to zero, perform OD_IO.write()
+     * and store mappedLength back to stream.dataOffset */
+    *dataOffset = 0;
+    OD_size_t countWritten;
+    OD_IO->write(&OD_IO->stream, dataOD, ODdataLength, &countWritten);
+    *dataOffset = mappedLength;
+}
+
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_COPY_PLAN) != 0
+/*
+ * Build copy plan from mapped entries
+ *
+ * Same as copy plan of the PDO: mapped OD variables with original read/write functions, which are mapped whole, are
+ * copied directly from/to their memory. Adjacent variables, which follow each other in the frame and in the memory,
+ * are merged into one step. Even entries go to the plan of the normal frame, odd entries to the inverted frame.
+ *
+ * @param SRDO This object, mapping must be valid.
+ * @param isRSRDO True for Rx SRDO and false for Tx SRDO.
+ */
+static void
+SRDO_initCopyPlan(CO_SRDO_t* SRDO, bool_t isRSRDO) {
+    CO_SRDO_size_t offset[2] = {0, 0};
+
+    SRDO->copyCount[0] = 0;
+    SRDO->copyCount[1] = 0;
+    for (uint8_t i = 0; i < SRDO->mappedObjectsCount; i++) {
+        uint8_t plain_inverted = i % 2U;
+        const OD_IO_t* OD_IO = &SRDO->OD_IO[i];
+        const OD_stream_t* stream = &OD_IO->stream;
+        CO_SRDO_size_t mappedLength = (CO_SRDO_size_t)stream->dataOffset;
+        uint8_t* dataOD = NULL;
+
+        bool_t original = isRSRDO ? (OD_IO->write == OD_writeOriginal) : (OD_IO->read == OD_readOriginal);
+        if (original && (stream->dataOrig != NULL) && (stream->dataLength == (OD_size_t)mappedLength)
+#ifdef CO_BIG_ENDIAN
+            && ((stream->attribute & ODA_MB) == 0U)
+#endif
+        ) {
+            dataOD = (uint8_t*)stream->dataOrig;
+        }
+
+        CO_SRDO_copy_t* plan = SRDO->copyPlan[plain_inverted];
+        uint8_t count = SRDO->copyCount[plain_inverted];
+        CO_SRDO_copy_t* last = (count > 0U) ? &plan[count - 1U] : NULL;
+        if ((dataOD != NULL) && (last != NULL) && (last->dataOD != NULL) && ((last->dataOD + last->length) == dataOD)) {
+            last->length += mappedLength;
+        } else {
+            CO_SRDO_copy_t* copy = &plan[count];
+            copy->dataOD = dataOD;
+            copy->offset = offset[plain_inverted];
+            copy->length = mappedLength;
+            copy->mapIndex = i;
+            SRDO->copyCount[plain_inverted] = count + 1U;
+        }
+        offset[plain_inverted] += mappedLength;
+    }
+}
+#endif /* (CO_CONFIG_SRDO) & CO_CONFIG_SRDO_COPY_PLAN */
+
 CO_ReturnError_t
 CO_SRDO_config(CO_SRDO_t* SRDO, uint8_t SRDO_Index, CO_SRDOGuard_t* SRDOGuard, uint32_t* errInfo) {
     CO_ReturnError_t ret = CO_ERROR_NO;
@@ -594,6 +821,9 @@ CO_SRDO_config(CO_SRDO_t* SRDO, uint8_t SRDO_Index, CO_SRDOGuard_t* SRDOGuard, u
             } else {
                 SRDO->dataLength = srdoDataLength[0];
                 SRDO->mappedObjectsCount = mappedObjectsCount;
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_COPY_PLAN) != 0
+                SRDO_initCopyPlan(SRDO, informationDirection == CO_SRDO_RX);
+#endif
             }
         }
     }
@@ -760,15 +990,43 @@ CO_SRDO_process(CO_SRDO_t* SRDO, uint32_t timeDifference_us, uint32_t* timerNext
                 if (SRDO->cycleTimer == 0U) {
                     uint8_t* dataSRDO[2] = {&SRDO->CANtxBuff[0]->data[0], &SRDO->CANtxBuff[1]->data[0]};
                     size_t verifyLength[2] = {0, 0};
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_TX_INVERT) != 0
+                    const uint8_t framesFromOD = 1; /* inverted frame is generated from the normal */
+#else
+                    const uint8_t framesFromOD = 2;
+#endif
 
                     /* copy mapped data from Object Dictionary into CAN buffers */
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_COPY_PLAN) != 0
+                    for (uint8_t plain_inverted = 0; plain_inverted < framesFromOD; plain_inverted++) {
+                        for (uint8_t i = 0; i < SRDO->copyCount[plain_inverted]; i++) {
+                            const CO_SRDO_copy_t* copy = &SRDO->copyPlan[plain_inverted][i];
+
+                            /* additional safety check */
+                            verifyLength[plain_inverted] += copy->length;
+                            if (verifyLength[plain_inverted] > CO_SRDO_MAX_SIZE) {
+                                break;
+                            }
+
+                            if (copy->dataOD != NULL) {
+                                (void)memcpy(&dataSRDO[plain_inverted][copy->offset], copy->dataOD, copy->length);
+                            } else {
+                                SRDO_readOD(&SRDO->OD_IO[copy->mapIndex], &dataSRDO[plain_inverted][copy->offset],
+                                            copy->length);
+                            }
+                        }
+                    }
+#else
                     for (uint8_t i = 0; i < SRDO->mappedObjectsCount; i++) {
                         uint8_t plain_inverted = i % 2U;
                         OD_IO_t* OD_IO = &SRDO->OD_IO[i];
-                        OD_stream_t* stream = &OD_IO->stream;
+
+                        if (plain_inverted >= framesFromOD) {
+                            continue;
+                        }
 
                         /* get mappedLength from temporary storage */
-                        uint8_t mappedLength = (uint8_t)stream->dataOffset;
+                        uint8_t mappedLength = (uint8_t)OD_IO->stream.dataOffset;
 
                         /* additional safety check */
                         verifyLength[plain_inverted] += mappedLength;
@@ -776,48 +1034,18 @@ CO_SRDO_process(CO_SRDO_t* SRDO, uint32_t timeDifference_us, uint32_t* timerNext
                             break;
                         }
 
-                        /* length of OD variable may be larger than mappedLength */
-                        OD_size_t ODdataLength = stream->dataLength;
-                        if (ODdataLength > CO_SRDO_MAX_SIZE) {
-                            ODdataLength = CO_SRDO_MAX_SIZE;
-                        }
-                        /* If mappedLength is smaller than ODdataLength, use auxiliary buffer */
-                        uint8_t buf[CO_SRDO_MAX_SIZE];
-                        uint8_t* dataSRDOCopy;
-                        if (ODdataLength > mappedLength) {
-                            (void)memset(buf, 0, sizeof(buf));
-                            dataSRDOCopy = buf;
-                        } else {
-                            dataSRDOCopy = dataSRDO[plain_inverted];
-                        }
-
-                        /* Set stream.dataOffset to zero, perform OD_IO.read()
-                         * and store mappedLength back to stream.dataOffset */
-                        stream->dataOffset = 0;
-                        OD_size_t countRd;
-                        OD_IO->read(stream, dataSRDOCopy, ODdataLength, &countRd);
-                        stream->dataOffset = mappedLength;
-
-                        /* swap multibyte data if big-endian */
-#ifdef CO_BIG_ENDIAN
-                        if ((stream->attribute & ODA_MB) != 0) {
-                            uint8_t* lo = dataSRDOCopy;
-                            uint8_t* hi = dataSRDOCopy + ODdataLength - 1;
-                            while (lo < hi) {
-                                uint8_t swap = *lo;
-                                *lo++ = *hi;
-                                *hi-- = swap;
-                            }
-                        }
-#endif
-
-                        /* If auxiliary buffer, copy it to the SRDO */
-                        if (ODdataLength > mappedLength) {
-                            (void)memcpy(dataSRDO[plain_inverted], buf, mappedLength);
-                        }
-
+                        SRDO_readOD(OD_IO, dataSRDO[plain_inverted], mappedLength);
                         dataSRDO[plain_inverted] += mappedLength;
                     }
+#endif /* (CO_CONFIG_SRDO) & CO_CONFIG_SRDO_COPY_PLAN */
+
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_TX_INVERT) != 0
+                    if (verifyLength[0] <= CO_SRDO_MAX_SIZE) {
+                        SRDO_invert(&SRDO->CANtxBuff[1]->data[0], &SRDO->CANtxBuff[0]->data[0],
+                                    (CO_SRDO_size_t)verifyLength[0]);
+                        verifyLength[1] = verifyLength[0];
+                    }
+#endif
 
                     if ((verifyLength[0] != verifyLength[1]) || (verifyLength[0] > CO_SRDO_MAX_SIZE)
                         || (verifyLength[0] != SRDO->dataLength)) {
@@ -826,12 +1054,10 @@ CO_SRDO_process(CO_SRDO_t* SRDO, uint32_t timeDifference_us, uint32_t* timerNext
                         bool_t data_ok = true;
 #if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_CHECK_TX) != 0
                         /* check data before sending (optional) */
-                        for (uint8_t i = 0; i < SRDO->dataLength; i++) {
-                            if ((uint8_t)(~SRDO->CANtxBuff[0]->data[i]) != SRDO->CANtxBuff[1]->data[i]) {
-                                SRDO->internalState = CO_SRDO_state_error_txNotInverted;
-                                data_ok = false;
-                                break;
-                            }
+                        if (!SRDO_isInverted(&SRDO->CANtxBuff[0]->data[0], &SRDO->CANtxBuff[1]->data[0],
+                                             SRDO->dataLength)) {
+                            SRDO->internalState = CO_SRDO_state_error_txNotInverted;
+                            data_ok = false;
                         }
 #endif
                         if (data_ok) {
@@ -872,11 +1098,16 @@ CO_SRDO_process(CO_SRDO_t* SRDO, uint32_t timeDifference_us, uint32_t* timerNext
             } else if (CO_FLAG_READ(SRDO->CANrxNew[SRDO->nextIsNormal ? 0 : 1])) {
                 /* normal message received ? */
                 if (SRDO->nextIsNormal) {
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+                    SRDO->validationTimer = SRDO_timerFromRx(SRDO->validationTime_us, SRDO->CANrxTimestamp_us[0],
+                                                             CO_CANtimestampNow());
+#else
                     SRDO->validationTimer = SRDO->validationTime_us;
+#endif
                     SRDO->nextIsNormal = false;
                 }
-                /* inverted message received */
-                else {
+                /* inverted message received, may be processed together with the normal */
+                if (!SRDO->nextIsNormal && CO_FLAG_READ(SRDO->CANrxNew[1])) {
                     SRDO->cycleTimer = SRDO->cycleTime_us;
                     SRDO->validationTimer = SRDO->cycleTime_us;
                     SRDO->nextIsNormal = true;
@@ -884,26 +1115,55 @@ CO_SRDO_process(CO_SRDO_t* SRDO, uint32_t timeDifference_us, uint32_t* timerNext
                     uint8_t* dataSRDO[2] = {&SRDO->CANrxData[0][0], &SRDO->CANrxData[1][0]};
                     bool_t data_ok = true;
 
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+                    /* measure timers from the reception of the messages */
+                    uint64_t now_us = CO_CANtimestampNow();
+                    SRDO->cycleTimer = SRDO_timerFromRx(SRDO->cycleTime_us, SRDO->CANrxTimestamp_us[1], now_us);
+                    SRDO->validationTimer = SRDO->cycleTimer;
+                    if ((SRDO->CANrxTimestamp_us[0] != 0U)
+                        && (CO_CANtimestampAge(SRDO->CANrxTimestamp_us[0], SRDO->CANrxTimestamp_us[1])
+                            > SRDO->validationTime_us)) {
+                        data_ok = false;
+                        SRDO->internalState = CO_SRDO_state_error_rxTimeoutSRVT;
+                    }
+#endif
+
                     /* Verify, if normal and inverted data matches properly */
-                    for (uint8_t i = 0; i < SRDO->dataLength; i++) {
-                        if ((uint8_t)(~dataSRDO[0][i]) != dataSRDO[1][i]) {
-                            data_ok = false;
-                            SRDO->internalState = CO_SRDO_state_error_rxNotInverted;
-                            break;
-                        }
+                    if (data_ok && !SRDO_isInverted(dataSRDO[0], dataSRDO[1], SRDO->dataLength)) {
+                        data_ok = false;
+                        SRDO->internalState = CO_SRDO_state_error_rxNotInverted;
                     }
 
                     /* copy data from CAN messages into mapped data from Object Dictionary */
                     if (data_ok) {
                         size_t verifyLength[2] = {0, 0};
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_COPY_PLAN) != 0
+                        for (uint8_t plain_inverted = 0; plain_inverted < 2U; plain_inverted++) {
+                            for (uint8_t i = 0; i < SRDO->copyCount[plain_inverted]; i++) {
+                                const CO_SRDO_copy_t* copy = &SRDO->copyPlan[plain_inverted][i];
+
+                                /* additional safety check */
+                                verifyLength[plain_inverted] += copy->length;
+                                if (verifyLength[plain_inverted] > CO_SRDO_MAX_SIZE) {
+                                    break;
+                                }
+
+                                if (copy->dataOD != NULL) {
+                                    (void)memcpy(copy->dataOD, &dataSRDO[plain_inverted][copy->offset],
+                                                 copy->length);
+                                } else {
+                                    SRDO_writeOD(&SRDO->OD_IO[copy->mapIndex], &dataSRDO[plain_inverted][copy->offset],
+                                                 copy->length);
+                                }
+                            }
+                        }
+#else
                         for (uint8_t i = 0; i < SRDO->mappedObjectsCount; i++) {
                             uint8_t plain_inverted = i % 2U;
                             OD_IO_t* OD_IO = &SRDO->OD_IO[i];
-                            OD_stream_t* stream = &OD_IO->stream;
 
                             /* get mappedLength from temporary storage */
-                            OD_size_t* dataOffset = &stream->dataOffset;
-                            uint8_t mappedLength = (uint8_t)(*dataOffset);
+                            uint8_t mappedLength = (uint8_t)OD_IO->stream.dataOffset;
 
                             /* additional safety check */
                             verifyLength[plain_inverted] += mappedLength;
@@ -911,45 +1171,10 @@ CO_SRDO_process(CO_SRDO_t* SRDO, uint32_t timeDifference_us, uint32_t* timerNext
                                 break;
                             }
 
-                            /* length of OD variable may be larger than mappedLength */
-                            OD_size_t ODdataLength = stream->dataLength;
-                            if (ODdataLength > CO_SRDO_MAX_SIZE) {
-                                ODdataLength = CO_SRDO_MAX_SIZE;
-                            }
-                            /* Prepare data for writing into OD variable. If mappedLength
-                             * is smaller than ODdataLength, then use auxiliary buffer */
-                            uint8_t buf[CO_SRDO_MAX_SIZE];
-                            uint8_t* dataOD;
-                            if (ODdataLength > mappedLength) {
-                                (void)memset(buf, 0, sizeof(buf));
-                                (void)memcpy(buf, dataSRDO[plain_inverted], mappedLength);
-                                dataOD = buf;
-                            } else {
-                                dataOD = dataSRDO[plain_inverted];
-                            }
-
-                            /* swap multibyte data if big-endian */
-#ifdef CO_BIG_ENDIAN
-                            if ((stream->attribute & ODA_MB) != 0) {
-                                uint8_t* lo = dataOD;
-                                uint8_t* hi = dataOD + ODdataLength - 1;
-                                while (lo < hi) {
-                                    uint8_t swap = *lo;
-                                    *lo++ = *hi;
-                                    *hi-- = swap;
-                                }
-                            }
-#endif
-
-                            /* Set stream.dataOffset to zero, perform OD_IO.write()
-                             * and store mappedLength back to stream.dataOffset */
-                            *dataOffset = 0;
-                            OD_size_t countWritten;
-                            OD_IO->write(&OD_IO->stream, dataOD, ODdataLength, &countWritten);
-                            *dataOffset = mappedLength;
-
+                            SRDO_writeOD(OD_IO, dataSRDO[plain_inverted], mappedLength);
                             dataSRDO[plain_inverted] += mappedLength;
                         } /* for (uint8_t i = 0; i < SRDO->mappedObjectsCount; i++) */
+#endif /* (CO_CONFIG_SRDO) & CO_CONFIG_SRDO_COPY_PLAN */
 
                         /* safety check, this should not happen */
                         if ((verifyLength[0] != verifyLength[1]) || (verifyLength[0] > CO_SRDO_MAX_SIZE)
@@ -113,6 +113,24 @@ CO_LSSmaster_check_timeout(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference_us
     return ret;
 }
 
+/*
+ * Check LSS fastscan timeout.
+ *
+ * Nodes acknowledge fastscan request and "no" is signaled by silence, so the response is evaluated after the timeout.
+ * If fsAckTime_us is set, wait with received response finishes after that time.
+ */
+static inline CO_LSSmaster_return_t
+CO_LSSmaster_fs_check_timeout(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference_us) {
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0
+    if ((LSSmaster->fsAckTime_us != 0U) && CO_FLAG_READ(LSSmaster->CANrxNew)
+        && ((LSSmaster->timeoutTimer + timeDifference_us) >= LSSmaster->fsAckTime_us)) {
+        LSSmaster->timeoutTimer = 0;
+        return CO_LSSmaster_TIMEOUT;
+    }
+#endif
+    return CO_LSSmaster_check_timeout(LSSmaster, timeDifference_us);
+}
+
 CO_ReturnError_t
 CO_LSSmaster_init(CO_LSSmaster_t* LSSmaster, uint16_t timeout_ms, CO_CANmodule_t* CANdevRx, uint16_t CANdevRxIdx,
                   uint16_t CANidLssSlave, CO_CANmodule_t* CANdevTx, uint16_t CANdevTxIdx, uint16_t CANidLssMaster) {
@@ -129,6 +147,9 @@ CO_LSSmaster_init(CO_LSSmaster_t* LSSmaster, uint16_t timeout_ms, CO_CANmodule_t
     LSSmaster->timeoutTimer = 0;
     CO_FLAG_CLEAR(LSSmaster->CANrxNew);
     (void)memset(LSSmaster->CANrxData, 0, sizeof(LSSmaster->CANrxData));
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0
+    LSSmaster->fsAckTime_us = 0;
+#endif
 #if ((CO_CONFIG_LSS)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
     LSSmaster->pFunctSignal = NULL;
     LSSmaster->functSignalObject = NULL;
@@ -661,7 +682,7 @@ static CO_LSSmaster_return_t
 CO_LSSmaster_FsCheckWait(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference_us) {
     CO_LSSmaster_return_t ret;
 
-    ret = CO_LSSmaster_check_timeout(LSSmaster, timeDifference_us);
+    ret = CO_LSSmaster_fs_check_timeout(LSSmaster, timeDifference_us);
     if (ret == CO_LSSmaster_TIMEOUT) {
         ret = CO_LSSmaster_SCAN_NOACK;
 
@@ -726,7 +747,7 @@ CO_LSSmaster_FsScanWait(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference_us, C
         default: return CO_LSSmaster_SCAN_FAILED; break;
     }
 
-    ret = CO_LSSmaster_check_timeout(LSSmaster, timeDifference_us);
+    ret = CO_LSSmaster_fs_check_timeout(LSSmaster, timeDifference_us);
     if (ret == CO_LSSmaster_TIMEOUT) {
 
         ret = CO_LSSmaster_WAIT_SLAVE;
@@ -798,7 +819,7 @@ CO_LSSmaster_FsVerifyWait(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference_us,
         return CO_LSSmaster_SCAN_FAILED;
     }
 
-    ret = CO_LSSmaster_check_timeout(LSSmaster, timeDifference_us);
+    ret = CO_LSSmaster_fs_check_timeout(LSSmaster, timeDifference_us);
     if (ret == CO_LSSmaster_TIMEOUT) {
 
         *idNumberRet = 0;
@@ -962,4 +983,248 @@ CO_LSSmaster_IdentifyFastscan(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference
     return ret;
 }
 
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0
+/*
+ * @defgroup CO_LSSmaster_bulk_state_t LSS master bulk commissioning state machine
+ * @{
+ */
+#define CO_LSSmaster_BULK_STATE_START          0x00U
+#define CO_LSSmaster_BULK_STATE_RTT            0x01U
+#define CO_LSSmaster_BULK_STATE_SCAN           0x02U
+#define CO_LSSmaster_BULK_STATE_NODE_ID        0x03U
+#define CO_LSSmaster_BULK_STATE_STORE          0x04U
+/* @} */ /* CO_LSSmaster_bulk_state_t */
+
+void
+CO_LSSmaster_bulkInit(CO_LSSmaster_bulk_t* bulk, uint32_t vendorID, uint32_t productCode, uint8_t nodeIdFirst,
+                      uint8_t nodeIdLast, bool_t store, CO_LSSmaster_bulkNode_t* nodes, uint8_t nodesSize) {
+    if (bulk == NULL) {
+        return;
+    }
+    (void)memset(bulk, 0, sizeof(CO_LSSmaster_bulk_t));
+
+    bulk->fastscan.scan[CO_LSS_FASTSCAN_VENDOR_ID] = (vendorID != 0U) ? CO_LSSmaster_FS_MATCH : CO_LSSmaster_FS_SCAN;
+    bulk->fastscan.match.identity.vendorID = vendorID;
+    if (productCode != 0U) {
+        bulk->fastscan.scan[CO_LSS_FASTSCAN_PRODUCT] = CO_LSSmaster_FS_MATCH;
+        bulk->fastscan.match.identity.productCode = productCode;
+        bulk->fastscan.scan[CO_LSS_FASTSCAN_REV] = CO_LSSmaster_FS_SKIP;
+    } else {
+        bulk->fastscan.scan[CO_LSS_FASTSCAN_PRODUCT] = CO_LSSmaster_FS_SCAN;
+        bulk->fastscan.scan[CO_LSS_FASTSCAN_REV] = CO_LSSmaster_FS_SCAN;
+    }
+    bulk->fastscan.scan[CO_LSS_FASTSCAN_SERIAL] = CO_LSSmaster_FS_SCAN;
+
+    bulk->nodes = nodes;
+    bulk->nodesSize = (nodes != NULL) ? nodesSize : 0U;
+    bulk->nodeIdNext = nodeIdFirst;
+    bulk->nodeIdLast = nodeIdLast;
+    bulk->store = store;
+}
+
+/*
+ * Helper function - finish bulk commissioning, deselect nodes and restore LSS master timeout
+ */
+static CO_LSSmaster_return_t
+CO_LSSmaster_bulkFinish(CO_LSSmaster_t* LSSmaster, CO_LSSmaster_bulk_t* bulk, CO_LSSmaster_return_t ret) {
+    (void)CO_LSSmaster_swStateDeselect(LSSmaster);
+    LSSmaster->fsAckTime_us = 0;
+    LSSmaster->timeout_us = bulk->timeoutOrig_us;
+    bulk->state = CO_LSSmaster_BULK_STATE_START;
+
+    return ret;
+}
+
+/*
+ * Helper function - send fastscan confirmation, which is answered by all unconfigured nodes, and measure round trip time
+ */
+static void
+CO_LSSmaster_bulkMeasure(CO_LSSmaster_t* LSSmaster, CO_LSSmaster_bulk_t* bulk) {
+    bulk->responses = 0;
+    LSSmaster->timeout_us = bulk->timeoutOrig_us;
+    LSSmaster->fsAckTime_us = 0;
+    LSSmaster->command = CO_LSSmaster_COMMAND_IDENTIFY_FASTSCAN;
+    CO_LSSmaster_FsSendMsg(LSSmaster, 0, CO_LSS_FASTSCAN_CONFIRM, 0, 0);
+    bulk->state = CO_LSSmaster_BULK_STATE_RTT;
+}
+
+/*
+ * Helper function - node-ID is configured, record the node and deselect it, so next node can be scanned
+ */
+static void
+CO_LSSmaster_bulkNodeDone(CO_LSSmaster_t* LSSmaster, CO_LSSmaster_bulk_t* bulk) {
+    if (bulk->nodesCount < bulk->nodesSize) {
+        CO_LSSmaster_bulkNode_t* node = &bulk->nodes[bulk->nodesCount];
+
+        node->address = bulk->fastscan.found;
+        node->time_us = bulk->elapsed_us - bulk->nodeStart_us;
+        node->nodeId = bulk->nodeIdNext;
+    }
+    bulk->nodesCount++;
+    bulk->nodeIdNext++;
+    bulk->retries = 0;
+    bulk->recheck = false;
+    bulk->nodeStart_us = bulk->elapsed_us;
+
+    /* configured node does not respond to fastscan any more */
+    (void)CO_LSSmaster_swStateDeselect(LSSmaster);
+    bulk->state = CO_LSSmaster_BULK_STATE_SCAN;
+}
+
+CO_LSSmaster_return_t
+CO_LSSmaster_bulkCommission(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference_us, CO_LSSmaster_bulk_t* bulk,
+                            uint32_t* timerNext_us) {
+    CO_LSSmaster_return_t ret = CO_LSSmaster_WAIT_SLAVE;
+    uint32_t dt = timeDifference_us;
+    bool_t again;
+
+    if ((LSSmaster == NULL) || (bulk == NULL)) {
+        return CO_LSSmaster_ILLEGAL_ARGUMENT;
+    }
+
+    if (bulk->state == CO_LSSmaster_BULK_STATE_START) {
+        if ((bulk->nodeIdNext < 1U) || (bulk->nodeIdNext > bulk->nodeIdLast) || (bulk->nodeIdLast > 0x7FU)) {
+            return CO_LSSmaster_ILLEGAL_ARGUMENT;
+        }
+        if ((LSSmaster->state != CO_LSSmaster_STATE_WAITING) || (LSSmaster->command != CO_LSSmaster_COMMAND_WAITING)) {
+            return CO_LSSmaster_INVALID_STATE;
+        }
+        bulk->timeoutOrig_us = LSSmaster->timeout_us;
+        bulk->nodesCount = 0;
+        bulk->allScanned = false;
+        bulk->retries = 0;
+        bulk->recheck = false;
+        bulk->elapsed_us = 0;
+        bulk->nodeStart_us = 0;
+        CO_LSSmaster_bulkMeasure(LSSmaster, bulk);
+        dt = 0;
+    }
+    bulk->elapsed_us += dt;
+
+    if (bulk->state == CO_LSSmaster_BULK_STATE_RTT) {
+        uint32_t timeout_us;
+
+        LSSmaster->timeoutTimer += dt;
+        if (CO_FLAG_READ(LSSmaster->CANrxNew)) {
+            uint8_t cs = LSSmaster->CANrxData[0];
+            uint32_t rtt_us = (LSSmaster->timeoutTimer > 0U) ? LSSmaster->timeoutTimer : 1U;
+            CO_FLAG_CLEAR(LSSmaster->CANrxNew);
+
+            if (cs != CO_LSS_IDENT_SLAVE) {
+                return CO_LSSmaster_bulkFinish(LSSmaster, bulk, CO_LSSmaster_SCAN_FAILED);
+            }
+            if (bulk->responses == 0U) {
+                bulk->rtt_us = rtt_us;
+            }
+            bulk->rttMax_us = rtt_us;
+            if (bulk->responses < 0xFFU) {
+                bulk->responses++;
+            }
+        }
+
+        if (LSSmaster->timeoutTimer >= LSSmaster->timeout_us) {
+            /* responses of all nodes are collected for the time of the original timeout */
+            LSSmaster->command = CO_LSSmaster_COMMAND_WAITING;
+            if (bulk->responses == 0U) {
+                /* no unconfigured nodes */
+                bulk->allScanned = true;
+                return CO_LSSmaster_bulkFinish(LSSmaster, bulk, CO_LSSmaster_OK);
+            }
+            timeout_us = bulk->rttMax_us * CO_LSSmaster_BULK_RTT_FACTOR;
+            if (timeout_us < CO_LSSmaster_BULK_TIMEOUT_MIN_US) {
+                timeout_us = CO_LSSmaster_BULK_TIMEOUT_MIN_US;
+            }
+            bulk->timeoutScan_us = (timeout_us < bulk->timeoutOrig_us) ? timeout_us : bulk->timeoutOrig_us;
+            bulk->state = CO_LSSmaster_BULK_STATE_SCAN;
+            dt = 0;
+        }
+    }
+
+    /* evaluate scan, configure and store for each node, next step is started immediately after the previous one */
+    do {
+        CO_LSSmaster_return_t r;
+        again = false;
+
+        switch (bulk->state) {
+            case CO_LSSmaster_BULK_STATE_SCAN:
+                if (bulk->nodeIdNext > bulk->nodeIdLast) {
+                    /* no more node-IDs, nodes may remain unconfigured */
+                    ret = CO_LSSmaster_bulkFinish(LSSmaster, bulk, CO_LSSmaster_OK);
+                    break;
+                }
+                LSSmaster->timeout_us = bulk->timeoutScan_us;
+                LSSmaster->fsAckTime_us = (bulk->retries == 0U) ? (bulk->rttMax_us * CO_LSSmaster_BULK_ACK_FACTOR) : 0U;
+                r = CO_LSSmaster_IdentifyFastscan(LSSmaster, dt, &bulk->fastscan);
+                if (r == CO_LSSmaster_SCAN_FINISHED) {
+                    /* one node is selected */
+                    LSSmaster->timeout_us = bulk->timeoutOrig_us;
+                    LSSmaster->fsAckTime_us = 0;
+                    bulk->state = CO_LSSmaster_BULK_STATE_NODE_ID;
+                    again = true;
+                } else if ((r == CO_LSSmaster_SCAN_NOACK) && !bulk->recheck) {
+                    /* Verify with the original timeout, that there are no more nodes. Remaining nodes may be slower
+                     * than the measured ones, measure again. */
+                    bulk->recheck = true;
+                    CO_LSSmaster_bulkMeasure(LSSmaster, bulk);
+                } else if (r == CO_LSSmaster_SCAN_NOACK) {
+                    /* nodes respond to the fastscan confirmation, but can not be scanned */
+                    ret = CO_LSSmaster_bulkFinish(LSSmaster, bulk, CO_LSSmaster_SCAN_FAILED);
+                } else if ((r == CO_LSSmaster_SCAN_FAILED) && (bulk->retries == 0U)) {
+                    /* probably late response, scan the node again with full wait for each step */
+                    bulk->retries++;
+                    again = true;
+                } else if (r != CO_LSSmaster_WAIT_SLAVE) {
+                    ret = CO_LSSmaster_bulkFinish(LSSmaster, bulk, r);
+                } else { /* MISRA C 2004 14.10 */
+                }
+                break;
+            case CO_LSSmaster_BULK_STATE_NODE_ID:
+                r = CO_LSSmaster_configureNodeId(LSSmaster, dt, bulk->nodeIdNext);
+                if (r == CO_LSSmaster_OK) {
+                    if (bulk->store) {
+                        bulk->state = CO_LSSmaster_BULK_STATE_STORE;
+                    } else {
+                        CO_LSSmaster_bulkNodeDone(LSSmaster, bulk);
+                    }
+                    again = true;
+                } else if (r != CO_LSSmaster_WAIT_SLAVE) {
+                    ret = CO_LSSmaster_bulkFinish(LSSmaster, bulk, r);
+                } else { /* MISRA C 2004 14.10 */
+                }
+                break;
+            case CO_LSSmaster_BULK_STATE_STORE:
+                r = CO_LSSmaster_configureStore(LSSmaster, dt);
+                if (r == CO_LSSmaster_OK) {
+                    CO_LSSmaster_bulkNodeDone(LSSmaster, bulk);
+                    again = true;
+                } else if (r != CO_LSSmaster_WAIT_SLAVE) {
+                    ret = CO_LSSmaster_bulkFinish(LSSmaster, bulk, r);
+                } else { /* MISRA C 2004 14.10 */
+                }
+                break;
+            default:
+                /* CO_LSSmaster_BULK_STATE_RTT, waiting for response */
+                break;
+        }
+        dt = 0;
+    } while (again);
+
+    if ((ret == CO_LSSmaster_WAIT_SLAVE) && (timerNext_us != NULL)) {
+        uint32_t wait_us = LSSmaster->timeout_us;
+        uint32_t diff = 0;
+        if ((LSSmaster->fsAckTime_us != 0U) && CO_FLAG_READ(LSSmaster->CANrxNew)) {
+            wait_us = LSSmaster->fsAckTime_us;
+        }
+        if (LSSmaster->timeoutTimer < wait_us) {
+            diff = wait_us - LSSmaster->timeoutTimer;
+        }
+        if (*timerNext_us > diff) {
+            *timerNext_us = diff;
+        }
+    }
+
+    return ret;
+}
+#endif /* (CO_CONFIG_LSS) & CO_CONFIG_LSS_MASTER_BULK */
+
 #endif /* (CO_CONFIG_LSS) & CO_CONFIG_LSS_MASTER */
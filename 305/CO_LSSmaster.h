@@ -104,6 +104,9 @@ typedef struct {
     volatile void* CANrxNew; /**< Indication if new LSS message is received from CAN bus. It needs to be cleared when
                                 received message is completely processed. */
     uint8_t CANrxData[8];    /**< 8 data bytes of the received message */
+#if (((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0) || defined CO_DOXYGEN
+    uint32_t fsAckTime_us; /**< If nonzero, fastscan step with response finishes after this time, before timeout */
+#endif
 #if (((CO_CONFIG_LSS)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0) || defined CO_DOXYGEN
     void (*pFunctSignal)(void* object); /**< From CO_LSSmaster_initCallbackPre() or NULL */
     void* functSignalObject;            /**< Pointer to object */
@@ -378,6 +381,118 @@ fastscan.scan[CO_LSS_FASTSCAN_SERIAL] = CO_LSSmaster_FS_SCAN;
 CO_LSSmaster_return_t CO_LSSmaster_IdentifyFastscan(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference_us,
                                                     CO_LSSmaster_fastscan_t* fastscan);
 
+#if (((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0) || defined CO_DOXYGEN
+/**
+ * Timeout of fastscan steps in bulk commissioning is measured round trip time multiplied by this factor.
+ */
+#ifndef CO_LSSmaster_BULK_RTT_FACTOR
+#define CO_LSSmaster_BULK_RTT_FACTOR 4U
+#endif
+
+/**
+ * Minimum timeout of fastscan steps in bulk commissioning in microseconds.
+ */
+#ifndef CO_LSSmaster_BULK_TIMEOUT_MIN_US
+#define CO_LSSmaster_BULK_TIMEOUT_MIN_US 2000U
+#endif
+
+/**
+ * Fastscan step with response in bulk commissioning finishes after the slowest measured round trip time multiplied by
+ * this factor, so responses of all nodes are received before the next request.
+ */
+#ifndef CO_LSSmaster_BULK_ACK_FACTOR
+#define CO_LSSmaster_BULK_ACK_FACTOR 2U
+#endif
+
+/**
+ * Node configured by #CO_LSSmaster_bulkCommission
+ */
+typedef struct {
+    CO_LSS_address_t address; /**< LSS address found by fastscan */
+    uint32_t time_us;         /**< Time from start of the scan to the stored node-ID */
+    uint8_t nodeId;           /**< Assigned node-ID */
+} CO_LSSmaster_bulkNode_t;
+
+/**
+ * Bulk commissioning object, see #CO_LSSmaster_bulkCommission
+ */
+typedef struct {
+    CO_LSSmaster_fastscan_t fastscan; /**< Fastscan request, prepared by CO_LSSmaster_bulkInit() */
+    CO_LSSmaster_bulkNode_t* nodes;   /**< From CO_LSSmaster_bulkInit(), may be NULL */
+    uint8_t nodesSize;                /**< Size of nodes array */
+    uint8_t nodesCount;               /**< Number of configured nodes, may be larger than nodesSize */
+    uint8_t nodeIdNext;               /**< Node-ID for the next node */
+    uint8_t nodeIdLast;               /**< Last node-ID, which may be assigned */
+    bool_t store;                     /**< If true, node-ID is stored in the node with LSS store configuration */
+    bool_t allScanned;                /**< True after scan, which did not find any more nodes */
+    uint8_t state;                    /**< Internal state */
+    uint8_t retries;                  /**< Number of repeated scans after #CO_LSSmaster_SCAN_FAILED */
+    bool_t recheck;                   /**< True, if round trip time is measured again after #CO_LSSmaster_SCAN_NOACK */
+    uint8_t responses;                /**< Number of responses to the last fastscan confirmation request */
+    uint32_t rtt_us;                  /**< Measured LSS round trip time of the fastest node */
+    uint32_t rttMax_us;               /**< Measured LSS round trip time of the slowest node */
+    uint32_t timeoutScan_us;          /**< Timeout of the fastscan steps, derived from rttMax_us */
+    uint32_t timeoutOrig_us;          /**< LSS master timeout before commissioning, restored at the end */
+    uint32_t elapsed_us;              /**< Duration of commissioning */
+    uint32_t nodeStart_us;            /**< Start of the current node */
+} CO_LSSmaster_bulk_t;
+
+/**
+ * Prepare bulk commissioning
+ *
+ * Fields of the LSS address, which are known in advance, are only verified by fastscan, not scanned bit by bit. For a
+ * cell of identical drives, vendor-ID and product code are known from the EDS, revision number is skipped and only
+ * serial number is scanned. This takes 2 + 33 fastscan steps per node instead of 4 * 33. Fastscan request may be
+ * further modified in bulk->fastscan before CO_LSSmaster_bulkCommission() is started.
+ *
+ * @param bulk This object will be initialized.
+ * @param vendorID Known vendor-ID or 0, if it must be scanned.
+ * @param productCode Known product code or 0, if it must be scanned. If known, revision number is skipped.
+ * @param nodeIdFirst Node-ID for the first node found.
+ * @param nodeIdLast Last node-ID which may be assigned, up to 127.
+ * @param store If true, node-ID is stored in each node with LSS store configuration.
+ * @param nodes Array for the result, may be NULL.
+ * @param nodesSize Size of the nodes array.
+ */
+void CO_LSSmaster_bulkInit(CO_LSSmaster_bulk_t* bulk, uint32_t vendorID, uint32_t productCode, uint8_t nodeIdFirst,
+                           uint8_t nodeIdLast, bool_t store, CO_LSSmaster_bulkNode_t* nodes, uint8_t nodesSize);
+
+/**
+ * Assign node-IDs to all unconfigured nodes
+ *
+ * Function runs #CO_LSSmaster_IdentifyFastscan, #CO_LSSmaster_configureNodeId, #CO_LSSmaster_configureStore and
+ * #CO_LSSmaster_swStateDeselect in a loop, until fastscan finds no more unconfigured nodes or node-IDs up to
+ * nodeIdLast are used. Next step is started in the same call, in which the previous step finishes.
+ *
+ * On LSS fastscan "no" is signaled by silence, so each step normally lasts the whole LSS timeout. Bulk commissioning
+ * first sends fastscan confirmation request, which is answered by all unconfigured nodes, and measures round trip time
+ * of the fastest and of the slowest node. Timeout of the fastscan steps is then set to #CO_LSSmaster_BULK_RTT_FACTOR
+ * times the slowest round trip time, but not less than #CO_LSSmaster_BULK_TIMEOUT_MIN_US. Step with response does not
+ * wait for the timeout, it finishes after #CO_LSSmaster_BULK_ACK_FACTOR times the slowest round trip time, when
+ * responses of all nodes are received. If late response of a slower node still breaks the scan, scan of that node is
+ * repeated once with full timeout for each step. When fastscan finds no more nodes, round trip time is measured again
+ * with the original LSS master timeout. If slower nodes respond, commissioning continues with the new timeout.
+ * Configure commands use the original LSS master timeout, which is restored at the end.
+ *
+ * Total duration is available in bulk->elapsed_us and duration for each node in bulk->nodes. Measured round trip time
+ * and timeout depend on the resolution of timeDifference_us, so LSS master should be processed on reception with
+ * callback from CO_LSSmaster_initCallbackPre() and timerNext_us should be used.
+ *
+ * This function needs that no node is selected when starting.
+ *
+ * Function must be called cyclically until it returns != #CO_LSSmaster_WAIT_SLAVE. Function is non-blocking.
+ *
+ * @param LSSmaster This object.
+ * @param timeDifference_us Time difference from previous function call in [microseconds]. Zero when request is started.
+ * @param bulk Object prepared with CO_LSSmaster_bulkInit().
+ * @param [out] timerNext_us info to OS, time to the end of the current wait, may be NULL.
+ * @return #CO_LSSmaster_ILLEGAL_ARGUMENT, #CO_LSSmaster_INVALID_STATE, #CO_LSSmaster_WAIT_SLAVE, #CO_LSSmaster_OK,
+ * #CO_LSSmaster_TIMEOUT, #CO_LSSmaster_SCAN_FAILED, #CO_LSSmaster_OK_MANUFACTURER, #CO_LSSmaster_OK_ILLEGAL_ARGUMENT
+ */
+CO_LSSmaster_return_t CO_LSSmaster_bulkCommission(CO_LSSmaster_t* LSSmaster, uint32_t timeDifference_us,
+                                                  CO_LSSmaster_bulk_t* bulk, uint32_t* timerNext_us);
+#endif /* (CO_CONFIG_LSS) & CO_CONFIG_LSS_MASTER_BULK */
+
 /** @} */ /* @defgroup CO_LSSmaster */
 
 #ifdef __cplusplus
@@ -203,6 +203,9 @@ static const char CO_GTWA_helpStringLss[] =
     "                [<scanType0> <vendorId> <scanType1> <productCode>\\\n"
     "                 <scanType2> <revisionNo> <scanType3> <serialNo>]]]\n"
     "                                       # Node-ID configuration of all nodes.\n"
+    "_lss_bulk [<nodeStart=1..127> <nodeEnd=1..127> <store=0|1>\\\n"
+    "          [<vendorId> <productCode>]]  # Node-ID configuration of all nodes\n"
+    "                                       # with known identity, non-standard.\n"
     "\n"
     "* All LSS commands start with '\"[\"<sequence>\"]\" [<net>]'.\n"
     "* <table_index>: 0=1000 kbit/s, 1=800 kbit/s, 2=500 kbit/s, 3=250 kbit/s,\n"
@@ -722,6 +725,9 @@ CO_GTWA_process(CO_GTWA_t* gtwa, bool_t enable, uint32_t timeDifference_us, uint
         bool_t tok_is_lss_get_node = strcmp(tok, "lss_get_node") == 0;
         bool_t tok_is__lss_fastscan = strcmp(tok, "_lss_fastscan") == 0;
         bool_t tok_is_lss_allnodes = strcmp(tok, "lss_allnodes") == 0;
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0
+        bool_t tok_is__lss_bulk = strcmp(tok, "_lss_bulk") == 0;
+#endif
 #endif
 #if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII_LOG) != 0
         bool_t tok_is_log = strcmp(tok, "log") == 0;
@@ -1086,6 +1092,12 @@ CO_GTWA_process(CO_GTWA_t* gtwa, bool_t enable, uint32_t timeDifference_us, uint
             }
 
             ret = CO_NMT_sendCommand(gtwa->NMT, command2, gtwa->node);
+#if (((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII_SDO) != 0) && (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0)
+            if ((ret == CO_ERROR_NO) && (gtwa->SDO_C != NULL)) {
+                /* static objects of the reset node (all nodes, if node is 0) are read again */
+                CO_SDOcache_invalidate(gtwa->SDO_C->cache, gtwa->node);
+            }
+#endif
 
             if (ret == CO_ERROR_NO) {
                 responseWithOK(gtwa);
@@ -1472,6 +1484,66 @@ CO_GTWA_process(CO_GTWA_t* gtwa, bool_t enable, uint32_t timeDifference_us, uint
             /* continue with state machine */
             gtwa->state = CO_GTWA_ST_LSS_ALLNODES;
         }
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0
+        /* LSS bulk commissioning, non-standard - '_lss_bulk [<nodeStart=1..127> <nodeEnd=1..127> <store=0|1>
+         * [<vendorId> <productCode>]]'. Known vendor-ID and product code are only verified by fastscan. */
+        else if (tok_is__lss_bulk) {
+            bool_t NodeErr = checkNet(gtwa, net, &respErrorCode);
+            uint8_t nodeStart = 2;
+            uint8_t nodeEnd = 127;
+            bool_t store = true;
+            uint32_t vendorID = 0;
+            uint32_t productCode = 0;
+
+            if (NodeErr) {
+                err = true;
+                break;
+            }
+
+            if (closed == 0U) {
+                (void)CO_fifo_readToken(&gtwa->commFifo, tok, sizeof(tok), &closed, &err);
+                nodeStart = (uint8_t)getU32(tok, 1, 127, &err);
+                if (err) {
+                    break;
+                }
+
+                (void)CO_fifo_readToken(&gtwa->commFifo, tok, sizeof(tok), &closed, &err);
+                nodeEnd = (uint8_t)getU32(tok, nodeStart, 127, &err);
+                if (err) {
+                    break;
+                }
+
+                closed = 0xFFU;
+                (void)CO_fifo_readToken(&gtwa->commFifo, tok, sizeof(tok), &closed, &err);
+                store = (bool_t)getU32(tok, 0, 1, &err);
+                if (err) {
+                    break;
+                }
+            }
+            if (closed == 0U) {
+                (void)CO_fifo_readToken(&gtwa->commFifo, tok, sizeof(tok), &closed, &err);
+                vendorID = getU32(tok, 0, 0xFFFFFFFFU, &err);
+                if (err) {
+                    break;
+                }
+
+                closed = 1U;
+                (void)CO_fifo_readToken(&gtwa->commFifo, tok, sizeof(tok), &closed, &err);
+                productCode = getU32(tok, 0, 0xFFFFFFFFU, &err);
+                if (err) {
+                    break;
+                }
+            }
+
+            /* round trip time is measured within 100ms, fastscan uses shorter timeout derived from it */
+            CO_LSSmaster_changeTimeout(gtwa->LSSmaster, 100);
+            CO_LSSmaster_bulkInit(&gtwa->lssBulk, vendorID, productCode, nodeStart, nodeEnd, store, NULL, 0);
+            gtwa->lssNodeCount = 0;
+
+            /* continue with state machine */
+            gtwa->state = CO_GTWA_ST__LSS_BULK;
+        }
+#endif
 #endif /* (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII_LSS */
 
 #if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII_LOG) != 0
@@ -1917,6 +1989,48 @@ CO_GTWA_process(CO_GTWA_t* gtwa, bool_t enable, uint32_t timeDifference_us, uint
                 }
                 break;
             } /* CO_GTWA_ST_LSS_ALLNODES */
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0
+            case CO_GTWA_ST__LSS_BULK: {
+                CO_LSSmaster_bulk_t* bulk = &gtwa->lssBulk;
+                CO_LSSmaster_return_t ret;
+                size_t count = 0;
+
+                ret = CO_LSSmaster_bulkCommission(gtwa->LSSmaster, timeDifference_us, bulk, timerNext_us);
+                if (bulk->nodesCount != gtwa->lssNodeCount) {
+                    /* node configured, at most one in each call */
+                    gtwa->lssNodeCount = bulk->nodesCount;
+                    count = (size_t)snprintf(gtwa->respBuf, CO_GTWA_RESP_BUF_SIZE,
+                                             "# Node-ID %d assigned to: 0x%08" PRIX32 " 0x%08" PRIX32 " 0x%08" PRIX32
+                                             " 0x%08" PRIX32 "\n",
+                                             bulk->nodeIdNext - 1U, bulk->fastscan.found.identity.vendorID,
+                                             bulk->fastscan.found.identity.productCode,
+                                             bulk->fastscan.found.identity.revisionNumber,
+                                             bulk->fastscan.found.identity.serialNumber);
+                }
+                if (ret == CO_LSSmaster_OK) {
+                    count += (size_t)snprintf(&gtwa->respBuf[count], CO_GTWA_RESP_BUF_SIZE - count,
+                                              "# Found %d nodes in %" PRIu32 " ms, LSS round trip %" PRIu32
+                                              " us%s.\n[%" PRId32 "] OK\r\n",
+                                              bulk->nodesCount, bulk->elapsed_us / 1000U, bulk->rtt_us,
+                                              bulk->allScanned ? "" : ", not all nodes scanned",
+                                              (int32_t)gtwa->sequence);
+                    gtwa->state = CO_GTWA_ST_IDLE;
+                }
+                if (count > 0U) {
+                    gtwa->respBufCount = count;
+                    (void)respBufTransfer(gtwa);
+                }
+                if ((ret != CO_LSSmaster_OK) && (ret != CO_LSSmaster_WAIT_SLAVE)) {
+                    /* error occurred */
+                    responseLSS(gtwa, ret);
+                    gtwa->state = CO_GTWA_ST_IDLE;
+                }
+                if (ret != CO_LSSmaster_WAIT_SLAVE) {
+                    CO_LSSmaster_changeTimeout(gtwa->LSSmaster, CO_LSSmaster_DEFAULT_TIMEOUT);
+                }
+                break;
+            } /* CO_GTWA_ST__LSS_BULK */
+#endif
 #endif        /* (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII_LSS */
 
 #if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII_LOG) != 0
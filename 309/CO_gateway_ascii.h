@@ -125,6 +125,9 @@ lss_allnodes [<timeout_ms> [<nodeStart=1..127> <store=0|1>\\
                 [<scanType0> <vendorId> <scanType1> <productCode>\\
                  <scanType2> <revisionNo> <scanType3> <serialNo>]]]
                                        # Node-ID configuration of all nodes.
+_lss_bulk [<nodeStart=1..127> <nodeEnd=1..127> <store=0|1>\\
+          [<vendorId> <productCode>]]  # Node-ID configuration of all nodes
+                                       # with known identity, non-standard.
 
 * All LSS commands start with '\"[\"<sequence>\"]\" [<net>]'.
 * <table_index>: 0=1000 kbit/s, 1=800 kbit/s, 2=500 kbit/s, 3=250 kbit/s,
@@ -200,6 +203,7 @@ typedef enum {
     CO_GTWA_ST_LSS_INQUIRE_ADDR_ALL = 0x26U, /**< LSS 'lss_inquire_addr', all parameters */
     CO_GTWA_ST__LSS_FASTSCAN = 0x30U,        /**< LSS '_lss_fastscan' */
     CO_GTWA_ST_LSS_ALLNODES = 0x31U,         /**< LSS 'lss_allnodes' */
+    CO_GTWA_ST__LSS_BULK = 0x32U,            /**< LSS '_lss_bulk' */
     CO_GTWA_ST_LOG = 0x80U,                  /**< print message 'log' */
     CO_GTWA_ST_HELP = 0x81U,                 /**< print 'help' text */
     CO_GTWA_ST_LED = 0x82U                   /**< print 'status' of the node */
@@ -280,6 +284,9 @@ typedef struct {
     uint8_t lssNodeCount;                /**< LSS allnodes node count parameter */
     bool_t lssStore;                     /**< LSS allnodes store parameter */
     uint16_t lssTimeout_ms;              /**< LSS allnodes timeout parameter */
+#if (((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER_BULK) != 0) || defined CO_DOXYGEN
+    CO_LSSmaster_bulk_t lssBulk; /**< LSS bulk commissioning parameter */
+#endif
 #endif
 #if (((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII_LOG) != 0) || defined CO_DOXYGEN
     uint8_t logBuf[CO_CONFIG_GTWA_LOG_BUF_SIZE + 1]; /**< Message log buffer of usable size
@@ -0,0 +1,508 @@
+/*
+ * CANopen access from other networks - binary mapping.
+ *
+ * @file        CO_gateway_binary.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "309/CO_gateway_binary.h"
+
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+
+static inline uint16_t
+CO_GTWB_getU16(const uint8_t* buf) {
+    return (uint16_t)buf[0] | (uint16_t)((uint16_t)buf[1] << 8);
+}
+
+static inline uint32_t
+CO_GTWB_getU32(const uint8_t* buf) {
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static inline void
+CO_GTWB_setU16(uint8_t* buf, uint16_t value) {
+    buf[0] = (uint8_t)value;
+    buf[1] = (uint8_t)(value >> 8);
+}
+
+static inline void
+CO_GTWB_setU32(uint8_t* buf, uint32_t value) {
+    buf[0] = (uint8_t)value;
+    buf[1] = (uint8_t)(value >> 8);
+    buf[2] = (uint8_t)(value >> 16);
+    buf[3] = (uint8_t)(value >> 24);
+}
+
+CO_ReturnError_t
+CO_GTWB_init(CO_GTWB_t* gtwb, CO_CANmodule_t* CANdevRx, uint16_t CANdevRxIdx, CO_CANmodule_t* CANdevTx,
+             uint16_t CANdevTxIdx, uint16_t SDOclientTimeoutTime_ms,
+#if ((CO_CONFIG_NMT)&CO_CONFIG_NMT_MASTER) != 0
+             CO_NMT_t* NMT,
+#endif
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
+             CO_LSSmaster_t* LSSmaster,
+#endif
+             uint8_t dummy) {
+    (void)dummy;
+
+    /* verify arguments */
+    if (gtwb == NULL) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* clear the object */
+    (void)memset(gtwb, 0, sizeof(CO_GTWB_t));
+
+    CO_ReturnError_t ret = CO_SDOengine_init(&gtwb->SDOengine, gtwb->SDOclients, CO_CONFIG_GTWB_SDO_CHANNELS, CANdevRx,
+                                             CANdevRxIdx, CANdevTx, CANdevTxIdx, SDOclientTimeoutTime_ms);
+    if (ret != CO_ERROR_NO) {
+        return ret;
+    }
+#if ((CO_CONFIG_NMT)&CO_CONFIG_NMT_MASTER) != 0
+    gtwb->NMT = NMT;
+#endif
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
+    gtwb->LSSmaster = LSSmaster;
+#endif
+    for (uint8_t i = 0; i < CO_CONFIG_GTWB_SLOTS; i++) {
+        gtwb->slots[i].gtwb = gtwb;
+        gtwb->slots[i].batch.xfers = gtwb->slots[i].xfers;
+        gtwb->slots[i].batch.object = &gtwb->slots[i];
+    }
+
+    return CO_ERROR_NO;
+}
+
+void
+CO_GTWB_initRead(CO_GTWB_t* gtwb,
+                 size_t (*readCallback)(void* object, const char* buf, size_t count, uint8_t* connectionOK),
+                 void* readCallbackObject) {
+    if (gtwb != NULL) {
+        gtwb->readCallback = readCallback;
+        gtwb->readCallbackObject = readCallbackObject;
+    }
+}
+
+size_t
+CO_GTWB_write(CO_GTWB_t* gtwb, const char* buf, size_t count) {
+    size_t n = 0;
+
+    if ((gtwb == NULL) || (buf == NULL)) {
+        return 0;
+    }
+
+    /* rest of too long frame is discarded */
+    if (gtwb->rxSkip > 0U) {
+        n = (count < gtwb->rxSkip) ? count : gtwb->rxSkip;
+        gtwb->rxSkip -= (uint16_t)n;
+    }
+
+    size_t space = sizeof(gtwb->rxBuf) - gtwb->rxCount;
+    size_t copy = count - n;
+    if (copy > space) {
+        copy = space;
+    }
+    (void)memcpy(&gtwb->rxBuf[gtwb->rxCount], &buf[n], copy);
+    gtwb->rxCount += (uint16_t)copy;
+
+    return n + copy;
+}
+
+/* Request slot is finished, response will be sent */
+static void
+CO_GTWB_slotDone(CO_GTWB_slot_t* slot, uint8_t status) {
+    CO_GTWB_t* gtwb = slot->gtwb;
+
+    slot->status = status;
+    slot->doneOrder = gtwb->doneCounter;
+    gtwb->doneCounter++;
+    slot->state = CO_GTWB_SLOT_DONE;
+}
+
+/* All SDO transfers of the request are finished, called from CO_SDOengine_process() */
+static void
+CO_GTWB_batchDone(void* object, CO_SDOengine_batch_t* batch) {
+    CO_GTWB_slot_t* slot = (CO_GTWB_slot_t*)object;
+    uint8_t status = CO_GTWB_ST_OK;
+
+    if (batch->failed > 0U) {
+        status = (slot->command == (uint8_t)CO_GTWB_CMD_MULTI_READ) ? (uint8_t)CO_GTWB_ST_PARTIAL
+                                                                     : (uint8_t)CO_GTWB_ST_SDO_ABORT;
+    }
+    CO_GTWB_slotDone(slot, status);
+}
+
+/* Prepare SDO transfer from node, index, sub-index in the request */
+static bool_t
+CO_GTWB_setXfer(CO_SDOengine_xfer_t* xfer, const uint8_t* req, bool_t upload) {
+    (void)memset(xfer, 0, sizeof(CO_SDOengine_xfer_t));
+    xfer->nodeId = req[0];
+    xfer->index = CO_GTWB_getU16(&req[1]);
+    xfer->subIndex = req[3];
+    xfer->upload = upload;
+    return (xfer->nodeId >= 1U) && (xfer->nodeId <= 127U);
+}
+
+/* Start processing of the request in the free slot. Returns status, if request is finished immediately, or
+ * CO_GTWB_ST_OK with slot state set. */
+static uint8_t
+CO_GTWB_dispatch(CO_GTWB_t* gtwb, CO_GTWB_slot_t* slot, const uint8_t* payload, uint16_t len) {
+    bool_t valid = true;
+
+    switch (slot->command) {
+        case CO_GTWB_CMD_READ:
+        case CO_GTWB_CMD_WRITE:
+        case CO_GTWB_CMD_MULTI_READ: {
+            uint16_t count = 1;
+
+            if (slot->command == (uint8_t)CO_GTWB_CMD_READ) {
+                valid = (len == 4U) && CO_GTWB_setXfer(&slot->xfers[0], payload, true);
+            } else if (slot->command == (uint8_t)CO_GTWB_CMD_WRITE) {
+                valid = (len > 4U) && (len <= (4U + CO_SDO_ENGINE_DATA_SIZE))
+                        && CO_GTWB_setXfer(&slot->xfers[0], payload, false);
+                if (valid) {
+                    slot->xfers[0].size = (size_t)len - 4U;
+                    (void)memcpy(slot->xfers[0].data, &payload[4], slot->xfers[0].size);
+                }
+            } else {
+                count = (len > 0U) ? payload[0] : 0U;
+                valid = (count >= 1U) && (count <= CO_GTWB_MULTI_MAX) && (len == (1U + (4U * count)));
+                for (uint16_t i = 0; valid && (i < count); i++) {
+                    valid = CO_GTWB_setXfer(&slot->xfers[i], &payload[1U + (4U * i)], true);
+                }
+            }
+            if (!valid) {
+                return CO_GTWB_ST_MALFORMED;
+            }
+            slot->batch.count = count;
+            slot->batch.pFunctItem = NULL;
+            slot->batch.pFunctDone = CO_GTWB_batchDone;
+            slot->state = CO_GTWB_SLOT_SDO;
+            if (CO_SDOengine_submitBatch(&gtwb->SDOengine, &slot->batch) != CO_ERROR_NO) {
+                return CO_GTWB_ST_FAILED;
+            }
+            return CO_GTWB_ST_OK;
+        }
+
+        case CO_GTWB_CMD_NMT: {
+#if ((CO_CONFIG_NMT)&CO_CONFIG_NMT_MASTER) != 0
+            if (gtwb->NMT == NULL) {
+                return CO_GTWB_ST_UNSUPPORTED;
+            }
+            if (len != 2U) {
+                return CO_GTWB_ST_MALFORMED;
+            }
+            if (CO_NMT_sendCommand(gtwb->NMT, (CO_NMT_command_t)payload[0], payload[1]) != CO_ERROR_NO) {
+                return CO_GTWB_ST_MALFORMED;
+            }
+            CO_GTWB_slotDone(slot, CO_GTWB_ST_OK);
+            return CO_GTWB_ST_OK;
+#else
+            return CO_GTWB_ST_UNSUPPORTED;
+#endif
+        }
+
+        case CO_GTWB_CMD_LSS_SELECT:
+        case CO_GTWB_CMD_LSS_DESELECT:
+        case CO_GTWB_CMD_LSS_NODE_ID:
+        case CO_GTWB_CMD_LSS_STORE: {
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
+            if (gtwb->LSSmaster == NULL) {
+                return CO_GTWB_ST_UNSUPPORTED;
+            }
+            slot->lssNodeId = 0;
+            if (slot->command == (uint8_t)CO_GTWB_CMD_LSS_SELECT) {
+                valid = (len == 0U) || (len == 16U);
+                if (len == 16U) {
+                    slot->lssAddress.identity.vendorID = CO_GTWB_getU32(&payload[0]);
+                    slot->lssAddress.identity.productCode = CO_GTWB_getU32(&payload[4]);
+                    slot->lssAddress.identity.revisionNumber = CO_GTWB_getU32(&payload[8]);
+                    slot->lssAddress.identity.serialNumber = CO_GTWB_getU32(&payload[12]);
+                    slot->lssNodeId = 1;
+                }
+            } else if (slot->command == (uint8_t)CO_GTWB_CMD_LSS_NODE_ID) {
+                valid = (len == 1U);
+                if (valid) {
+                    slot->lssNodeId = payload[0];
+                }
+            } else {
+                valid = (len == 0U);
+            }
+            if (!valid) {
+                return CO_GTWB_ST_MALFORMED;
+            }
+            /* LSS requests are processed one after another in order of arrival */
+            slot->doneOrder = gtwb->doneCounter;
+            gtwb->doneCounter++;
+            slot->state = CO_GTWB_SLOT_LSS;
+            return CO_GTWB_ST_OK;
+#else
+            return CO_GTWB_ST_UNSUPPORTED;
+#endif
+        }
+
+        default: return CO_GTWB_ST_UNSUPPORTED;
+    }
+}
+
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
+/* Process LSS requests with LSS master */
+static void
+CO_GTWB_processLSS(CO_GTWB_t* gtwb, uint32_t timeDifference_us) {
+    if (gtwb->lssSlot == NULL) {
+        /* oldest waiting LSS request */
+        for (uint8_t i = 0; i < CO_CONFIG_GTWB_SLOTS; i++) {
+            CO_GTWB_slot_t* slot = &gtwb->slots[i];
+            if ((slot->state == (uint8_t)CO_GTWB_SLOT_LSS)
+                && ((gtwb->lssSlot == NULL) || ((int32_t)(slot->doneOrder - gtwb->lssSlot->doneOrder) < 0))) {
+                gtwb->lssSlot = slot;
+            }
+        }
+        if (gtwb->lssSlot == NULL) {
+            return;
+        }
+        gtwb->lssStarted = false;
+    }
+
+    CO_GTWB_slot_t* slot = gtwb->lssSlot;
+    uint32_t dt = gtwb->lssStarted ? timeDifference_us : 0U;
+    CO_LSSmaster_return_t ret;
+
+    switch (slot->command) {
+        case CO_GTWB_CMD_LSS_SELECT:
+            ret = CO_LSSmaster_swStateSelect(gtwb->LSSmaster, dt, (slot->lssNodeId != 0U) ? &slot->lssAddress : NULL);
+            break;
+        case CO_GTWB_CMD_LSS_DESELECT: ret = CO_LSSmaster_swStateDeselect(gtwb->LSSmaster); break;
+        case CO_GTWB_CMD_LSS_NODE_ID: ret = CO_LSSmaster_configureNodeId(gtwb->LSSmaster, dt, slot->lssNodeId); break;
+        default: ret = CO_LSSmaster_configureStore(gtwb->LSSmaster, dt); break;
+    }
+    gtwb->lssStarted = true;
+
+    if (ret != CO_LSSmaster_WAIT_SLAVE) {
+        uint8_t status = CO_GTWB_ST_FAILED;
+        if (ret == CO_LSSmaster_OK) {
+            status = CO_GTWB_ST_OK;
+        } else if (ret == CO_LSSmaster_TIMEOUT) {
+            status = CO_GTWB_ST_TIMEOUT;
+        } else if (ret == CO_LSSmaster_ILLEGAL_ARGUMENT) {
+            status = CO_GTWB_ST_MALFORMED;
+        } else { /* MISRA C 2004 14.10 */
+        }
+        CO_GTWB_slotDone(slot, status);
+        gtwb->lssSlot = NULL;
+    }
+}
+#endif
+
+/* Take complete frames from rxBuf, while there are free slots */
+static void
+CO_GTWB_receive(CO_GTWB_t* gtwb) {
+    while ((gtwb->rejectStatus == 0U) && (gtwb->rxCount >= 2U)) {
+        uint16_t len = CO_GTWB_getU16(&gtwb->rxBuf[0]);
+        uint16_t frameSize = len + 2U;
+
+        if ((len < 4U) || (frameSize > CO_GTWB_FRAME_MAX)) {
+            /* frame without tag or too long frame, respond with error and discard it */
+            if (len < 4U) {
+                if (gtwb->rxCount < frameSize) {
+                    break;
+                }
+                gtwb->rejectCommand = 0;
+                gtwb->rejectTag = 0;
+            } else {
+                if (gtwb->rxCount < CO_GTWB_HEADER_SIZE) {
+                    break;
+                }
+                gtwb->rejectCommand = gtwb->rxBuf[2];
+                gtwb->rejectTag = CO_GTWB_getU16(&gtwb->rxBuf[4]);
+                /* buffer holds less than one frame, so all bytes belong to this frame */
+                gtwb->rxSkip = frameSize - gtwb->rxCount;
+                frameSize = gtwb->rxCount;
+            }
+            gtwb->rejectStatus = CO_GTWB_ST_MALFORMED;
+        } else {
+            if (gtwb->rxCount < frameSize) {
+                break;
+            }
+
+            CO_GTWB_slot_t* slot = NULL;
+            for (uint8_t i = 0; i < CO_CONFIG_GTWB_SLOTS; i++) {
+                if (gtwb->slots[i].state == (uint8_t)CO_GTWB_SLOT_FREE) {
+                    slot = &gtwb->slots[i];
+                    break;
+                }
+            }
+            if (slot == NULL) {
+                /* all slots busy, frame will be taken later */
+                break;
+            }
+
+            slot->command = gtwb->rxBuf[2];
+            slot->tag = CO_GTWB_getU16(&gtwb->rxBuf[4]);
+            uint8_t status = CO_GTWB_dispatch(gtwb, slot, &gtwb->rxBuf[CO_GTWB_HEADER_SIZE], len - 4U);
+            if (status != (uint8_t)CO_GTWB_ST_OK) {
+                CO_GTWB_slotDone(slot, status);
+            }
+        }
+
+        /* remove the frame from the buffer */
+        gtwb->rxCount -= frameSize;
+        (void)memmove(&gtwb->rxBuf[0], &gtwb->rxBuf[frameSize], gtwb->rxCount);
+    }
+}
+
+/* Build response of the finished request or, if slot is NULL, of the rejected frame into txBuf, return its size */
+static uint16_t
+CO_GTWB_buildResponse(CO_GTWB_t* gtwb, const CO_GTWB_slot_t* slot) {
+    uint8_t* buf = gtwb->txBuf;
+    uint16_t n = CO_GTWB_HEADER_SIZE;
+
+    if (slot != NULL) {
+        const CO_SDOengine_xfer_t* xfer = &slot->xfers[0];
+
+        if (slot->status == (uint8_t)CO_GTWB_ST_SDO_ABORT) {
+            CO_GTWB_setU32(&buf[n], (uint32_t)xfer->abortCode);
+            n += 4U;
+        } else if ((slot->command == (uint8_t)CO_GTWB_CMD_READ) && (slot->status == (uint8_t)CO_GTWB_ST_OK)) {
+            (void)memcpy(&buf[n], xfer->data, xfer->size);
+            n += (uint16_t)xfer->size;
+        } else if ((slot->command == (uint8_t)CO_GTWB_CMD_MULTI_READ)
+                   && ((slot->status == (uint8_t)CO_GTWB_ST_OK) || (slot->status == (uint8_t)CO_GTWB_ST_PARTIAL))) {
+            for (uint16_t i = 0; i < slot->batch.count; i++) {
+                xfer = &slot->xfers[i];
+                bool_t ok = xfer->result >= CO_SDO_RT_ok_communicationEnd;
+                uint8_t size = ok ? (uint8_t)xfer->size : 0U;
+                uint32_t abortCode = ok ? 0U : (uint32_t)xfer->abortCode;
+
+                if (!ok && (abortCode == 0U)) {
+                    abortCode = (uint32_t)CO_SDO_AB_GENERAL;
+                }
+                CO_GTWB_setU32(&buf[n], abortCode);
+                buf[n + 4U] = size;
+                (void)memcpy(&buf[n + 5U], xfer->data, size);
+                n += 5U + (uint16_t)size;
+            }
+        } else { /* MISRA C 2004 14.10 */
+        }
+        buf[2] = slot->command | (uint8_t)CO_GTWB_CMD_RESPONSE;
+        buf[3] = slot->status;
+        CO_GTWB_setU16(&buf[4], slot->tag);
+    } else {
+        /* response to rejected frame */
+        buf[2] = gtwb->rejectCommand | (uint8_t)CO_GTWB_CMD_RESPONSE;
+        buf[3] = gtwb->rejectStatus;
+        CO_GTWB_setU16(&buf[4], gtwb->rejectTag);
+    }
+    CO_GTWB_setU16(&buf[0], n - 2U);
+
+    return n;
+}
+
+/* Pass responses to the application */
+static void
+CO_GTWB_transmit(CO_GTWB_t* gtwb) {
+    for (;;) {
+        if (gtwb->txSent >= gtwb->txCount) {
+            /* next response: rejected frame first, then finished requests in order of completion */
+            if (gtwb->rejectStatus != 0U) {
+                gtwb->txCount = CO_GTWB_buildResponse(gtwb, NULL);
+                gtwb->rejectStatus = 0;
+            } else {
+                CO_GTWB_slot_t* slot = NULL;
+                for (uint8_t i = 0; i < CO_CONFIG_GTWB_SLOTS; i++) {
+                    CO_GTWB_slot_t* s = &gtwb->slots[i];
+                    if ((s->state == (uint8_t)CO_GTWB_SLOT_DONE)
+                        && ((slot == NULL) || ((int32_t)(s->doneOrder - slot->doneOrder) < 0))) {
+                        slot = s;
+                    }
+                }
+                if (slot == NULL) {
+                    gtwb->txCount = 0;
+                    gtwb->txSent = 0;
+                    return;
+                }
+                gtwb->txCount = CO_GTWB_buildResponse(gtwb, slot);
+                slot->state = CO_GTWB_SLOT_FREE;
+            }
+            gtwb->txSent = 0;
+        }
+
+        if (gtwb->readCallback == NULL) {
+            /* no callback registered, just purge the response */
+            gtwb->txSent = gtwb->txCount;
+        } else {
+            uint8_t connectionOK = 1;
+            size_t countRead = gtwb->readCallback(gtwb->readCallbackObject, (const char*)&gtwb->txBuf[gtwb->txSent],
+                                                  (size_t)gtwb->txCount - gtwb->txSent, &connectionOK);
+            gtwb->txSent += (uint16_t)countRead;
+            if (gtwb->txSent < gtwb->txCount) {
+                /* output is full, continue later */
+                return;
+            }
+        }
+    }
+}
+
+void
+CO_GTWB_process(CO_GTWB_t* gtwb, bool_t enable, uint32_t timeDifference_us, uint32_t* timerNext_us) {
+    if (gtwb == NULL) {
+        return;
+    }
+
+    /* SDO transfers finish also while gateway is disabled, their responses are discarded */
+    (void)CO_SDOengine_process(&gtwb->SDOengine, timeDifference_us, timerNext_us);
+
+    if (!enable) {
+        gtwb->rxCount = 0;
+        gtwb->rxSkip = 0;
+        gtwb->rejectStatus = 0;
+        gtwb->txCount = 0;
+        gtwb->txSent = 0;
+        for (uint8_t i = 0; i < CO_CONFIG_GTWB_SLOTS; i++) {
+            if (gtwb->slots[i].state != (uint8_t)CO_GTWB_SLOT_SDO) {
+                gtwb->slots[i].state = CO_GTWB_SLOT_FREE;
+            }
+        }
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
+        gtwb->lssSlot = NULL;
+#endif
+        return;
+    }
+
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
+    CO_GTWB_processLSS(gtwb, timeDifference_us);
+#endif
+
+    CO_GTWB_receive(gtwb);
+
+    /* submitted SDO transfers start on free channels immediately */
+    if (gtwb->SDOengine.queueHead != NULL) {
+        (void)CO_SDOengine_process(&gtwb->SDOengine, 0, timerNext_us);
+    }
+
+    CO_GTWB_transmit(gtwb);
+
+    /* complete frame may be written from the read callback, take it without delay, if slot was freed meanwhile */
+    if ((timerNext_us != NULL) && (gtwb->rxCount >= 2U)
+        && (gtwb->rxCount >= ((uint32_t)CO_GTWB_getU16(&gtwb->rxBuf[0]) + 2U))) {
+        for (uint8_t i = 0; i < CO_CONFIG_GTWB_SLOTS; i++) {
+            if (gtwb->slots[i].state == (uint8_t)CO_GTWB_SLOT_FREE) {
+                *timerNext_us = 0;
+                break;
+            }
+        }
+    }
+}
+
+#endif /* (CO_CONFIG_GTW) & CO_CONFIG_GTW_BINARY */
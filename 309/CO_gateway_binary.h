@@ -0,0 +1,281 @@
+/**
+ * CANopen access from other networks - binary mapping.
+ *
+ * @file        CO_gateway_binary.h
+ * @ingroup     CO_CANopen_309_bin
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_GATEWAY_BINARY_H
+#define CO_GATEWAY_BINARY_H
+
+#include "301/CO_driver.h"
+#include "301/CO_SDOclient.h"
+#include "301/CO_NMT_Heartbeat.h"
+#include "305/CO_LSSmaster.h"
+#include "extra/CO_SDOengine.h"
+
+/* default configuration, see CO_config.h */
+#ifndef CO_CONFIG_GTW
+#define CO_CONFIG_GTW (0)
+#endif
+#ifndef CO_CONFIG_GTWB_SDO_CHANNELS
+#define CO_CONFIG_GTWB_SDO_CHANNELS 4
+#endif
+#ifndef CO_CONFIG_GTWB_SLOTS
+#define CO_CONFIG_GTWB_SLOTS 8
+#endif
+
+#if (((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0) || defined CO_DOXYGEN
+
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) == 0
+#error CO_CONFIG_GTW_BINARY requires CO_CONFIG_SDO_CLI_ENABLE
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_CANopen_309_bin Gateway binary mapping
+ * CANopen access from other networks - binary length-prefixed frames.
+ *
+ * @ingroup CO_CANopen_309
+ * @{
+ * @ref CO_CANopen_309_3 parses each command as text and formats each value as text, one command at a time. For a
+ * host, which polls hundreds of values per second, parsing and round trips limit the throughput. Binary gateway uses
+ * the same backends (SDO client, NMT master, LSS master) with fixed-layout frames. Host may send up to
+ * @ref CO_CONFIG_GTWB_SLOTS requests without waiting for responses, each is identified by its tag. SDO requests run on
+ * own @ref CO_SDOengine with @ref CO_CONFIG_GTWB_SDO_CHANNELS SDO clients, so requests and multi-read items to
+ * different nodes are on the bus at the same time. Responses are sent in order of completion.
+ *
+ * This module is usually initialized and processed in CANopen.c file. Application registers own callback function
+ * for reading the output stream with CO_GTWB_initRead() and writes received bytes with CO_GTWB_write().
+ *
+ * LSS master is shared with @ref CO_CANopen_309_3, commands must not be mixed on both gateways at the same time.
+ */
+
+/**
+ * @defgroup CO_CANopen_309_bin_Syntax Frame syntax
+ * Binary frame layout.
+ *
+ * @{
+ *
+ * All values are little-endian. Each frame, request or response, is:
+ *
+ * | Offset | Size | Content                                                         |
+ * | ------ | ---- | --------------------------------------------------------------- |
+ * | 0      | 2    | Length of the rest of the frame, including the next four bytes |
+ * | 2      | 1    | Command, response has bit 0x80 set                              |
+ * | 3      | 1    | Status, 0 in requests, see @ref CO_GTWB_status_t                |
+ * | 4      | 2    | Tag, chosen by the host, copied into the response               |
+ * | 6      | n    | Payload                                                         |
+ *
+ * Request payload, see @ref CO_GTWB_command_t:
+ * - READ: node (u8), index (u16), sub-index (u8). Response: data.
+ * - WRITE: node (u8), index (u16), sub-index (u8), data (1 to @ref CO_SDO_ENGINE_DATA_SIZE bytes). Response: empty.
+ * - MULTI_READ: count (u8, 1 to @ref CO_GTWB_MULTI_MAX), then node, index, sub-index for each item. Response: for
+ *   each item abort code (u32, 0 on success), size (u8) and data.
+ * - NMT: command (u8, @ref CO_NMT_command_t), node (u8, 0 for all nodes). Response: empty.
+ * - LSS_SELECT: empty for all nodes or vendor-ID, product code, revision, serial number (4 x u32). Response: empty.
+ * - LSS_DESELECT: empty. Response: empty.
+ * - LSS_NODE_ID: node-ID (u8) for the selected node. Response: empty.
+ * - LSS_STORE: empty, stores configuration in the selected node. Response: empty.
+ *
+ * On SDO abort response status is @ref CO_GTWB_ST_SDO_ABORT and payload is abort code (u32). Multi-read has status
+ * @ref CO_GTWB_ST_PARTIAL, if any item failed. Frame longer than @ref CO_GTWB_FRAME_MAX is answered with
+ * @ref CO_GTWB_ST_MALFORMED and skipped.
+ * @}
+ */
+
+/** Maximum number of items in MULTI_READ */
+#ifndef CO_GTWB_MULTI_MAX
+#define CO_GTWB_MULTI_MAX 32U
+#endif
+
+/** Size of the frame header: length, command, status and tag */
+#define CO_GTWB_HEADER_SIZE 6U
+
+/** Maximum size of the request frame, including the length field */
+#define CO_GTWB_FRAME_MAX (CO_GTWB_HEADER_SIZE + 1U + (4U * CO_GTWB_MULTI_MAX))
+
+/** Maximum size of the response frame, including the length field */
+#define CO_GTWB_RESP_MAX (CO_GTWB_HEADER_SIZE + (CO_GTWB_MULTI_MAX * (5U + CO_SDO_ENGINE_DATA_SIZE)))
+
+/** Commands */
+typedef enum {
+    CO_GTWB_CMD_READ = 0x01U,         /**< SDO upload */
+    CO_GTWB_CMD_WRITE = 0x02U,        /**< SDO download */
+    CO_GTWB_CMD_MULTI_READ = 0x03U,   /**< SDO upload of several objects, different nodes in parallel */
+    CO_GTWB_CMD_NMT = 0x10U,          /**< NMT command */
+    CO_GTWB_CMD_LSS_SELECT = 0x20U,   /**< LSS switch state global or selective */
+    CO_GTWB_CMD_LSS_DESELECT = 0x21U, /**< LSS switch state deselect */
+    CO_GTWB_CMD_LSS_NODE_ID = 0x22U,  /**< LSS configure node-ID */
+    CO_GTWB_CMD_LSS_STORE = 0x23U,    /**< LSS store configuration */
+    CO_GTWB_CMD_RESPONSE = 0x80U      /**< Flag in the response */
+} CO_GTWB_command_t;
+
+/** Response status */
+typedef enum {
+    CO_GTWB_ST_OK = 0U,          /**< Success */
+    CO_GTWB_ST_SDO_ABORT = 1U,   /**< SDO transfer aborted, payload is abort code */
+    CO_GTWB_ST_PARTIAL = 2U,     /**< Some items of multi-read failed, see their abort codes */
+    CO_GTWB_ST_MALFORMED = 3U,   /**< Wrong length or arguments */
+    CO_GTWB_ST_UNSUPPORTED = 4U, /**< Unknown command or backend not available */
+    CO_GTWB_ST_TIMEOUT = 5U,     /**< No response from the node */
+    CO_GTWB_ST_FAILED = 6U       /**< Command failed or was rejected by the node */
+} CO_GTWB_status_t;
+
+/** State of the request slot */
+typedef enum {
+    CO_GTWB_SLOT_FREE = 0, /**< Not used */
+    CO_GTWB_SLOT_SDO = 1,  /**< SDO transfers submitted to the engine */
+    CO_GTWB_SLOT_LSS = 2,  /**< Waiting for or processing LSS master */
+    CO_GTWB_SLOT_DONE = 3  /**< Finished, response not sent yet */
+} CO_GTWB_slotState_t;
+
+/** One outstanding request */
+typedef struct {
+    uint8_t state;                                /**< See @ref CO_GTWB_slotState_t */
+    uint8_t command;                              /**< See @ref CO_GTWB_command_t */
+    uint8_t status;                               /**< See @ref CO_GTWB_status_t */
+    uint16_t tag;                                 /**< From the request */
+    uint32_t doneOrder;                           /**< Order of completion, responses are sent in this order */
+    CO_SDOengine_batch_t batch;                   /**< SDO transfers of this request */
+    CO_SDOengine_xfer_t xfers[CO_GTWB_MULTI_MAX]; /**< One for read and write, count for multi-read */
+    CO_LSS_address_t lssAddress;                  /**< LSS address for LSS_SELECT */
+    uint8_t lssNodeId;                            /**< Node-ID for LSS_NODE_ID, 0 for LSS_SELECT of all nodes */
+    struct CO_GTWB* gtwb;                         /**< Owner, for callbacks */
+} CO_GTWB_slot_t;
+
+/**
+ * Gateway binary object
+ */
+typedef struct CO_GTWB {
+    /** Pointer to external function for reading response from gateway object. Pointer is initialized in
+     * CO_GTWB_initRead(). See @ref CO_GTWA_t::readCallback. */
+    size_t (*readCallback)(void* object, const char* buf, size_t count, uint8_t* connectionOK);
+    void* readCallbackObject;                               /**< Object for readCallback, from CO_GTWB_initRead() */
+    CO_SDOengine_t SDOengine;                               /**< Own SDO engine */
+    CO_SDOclient_t SDOclients[CO_CONFIG_GTWB_SDO_CHANNELS]; /**< SDO clients of the engine */
+    CO_GTWB_slot_t slots[CO_CONFIG_GTWB_SLOTS];             /**< Outstanding requests */
+    uint32_t doneCounter;                                   /**< Source of CO_GTWB_slot_t::doneOrder */
+    uint8_t rxBuf[CO_GTWB_FRAME_MAX];                       /**< Received bytes, up to one frame */
+    uint16_t rxCount;                                       /**< Number of bytes in rxBuf */
+    uint16_t rxSkip;                                        /**< Remaining bytes of too long frame, discarded */
+    uint8_t txBuf[CO_GTWB_RESP_MAX];                        /**< Response under transmission */
+    uint16_t txCount;                                       /**< Size of the response in txBuf */
+    uint16_t txSent;                                        /**< Bytes of txBuf already passed to readCallback */
+    uint8_t rejectStatus;                                   /**< Status of response to malformed frame or 0 */
+    uint16_t rejectTag;                                     /**< Tag of response to malformed frame */
+    uint8_t rejectCommand;                                  /**< Command of response to malformed frame */
+#if (((CO_CONFIG_NMT)&CO_CONFIG_NMT_MASTER) != 0) || defined CO_DOXYGEN
+    CO_NMT_t* NMT;                                          /**< NMT object from CO_GTWB_init(), may be NULL */
+#endif
+#if (((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0) || defined CO_DOXYGEN
+    CO_LSSmaster_t* LSSmaster;                              /**< LSS master object from CO_GTWB_init(), may be NULL */
+    CO_GTWB_slot_t* lssSlot;                                /**< Request processed by LSS master or NULL */
+    bool_t lssStarted;                                      /**< True after the first call of the LSS master function */
+#endif
+} CO_GTWB_t;
+
+/**
+ * Initialize Gateway-binary object
+ *
+ * @param gtwb This object will be initialized
+ * @param CANdevRx CAN device for SDO client reception.
+ * @param CANdevRxIdx Index of the first of @ref CO_CONFIG_GTWB_SDO_CHANNELS receive buffers in the above CAN device.
+ * @param CANdevTx CAN device for SDO client transmission.
+ * @param CANdevTxIdx Index of the first of @ref CO_CONFIG_GTWB_SDO_CHANNELS transmit buffers in the above CAN device.
+ * @param SDOclientTimeoutTime_ms Timeout of SDO transfers in milliseconds, 500 typically
+ * @param NMT NMT object, may be NULL. Only if NMT master is enabled.
+ * @param LSSmaster LSS master object, may be NULL. Only if LSS master is enabled.
+ * @param dummy dummy argument, set to 0
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT
+ */
+CO_ReturnError_t CO_GTWB_init(CO_GTWB_t* gtwb, CO_CANmodule_t* CANdevRx, uint16_t CANdevRxIdx,
+                              CO_CANmodule_t* CANdevTx, uint16_t CANdevTxIdx, uint16_t SDOclientTimeoutTime_ms,
+#if (((CO_CONFIG_NMT)&CO_CONFIG_NMT_MASTER) != 0) || defined CO_DOXYGEN
+                              CO_NMT_t* NMT,
+#endif
+#if (((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0) || defined CO_DOXYGEN
+                              CO_LSSmaster_t* LSSmaster,
+#endif
+                              uint8_t dummy);
+
+/**
+ * Initialize read callback in Gateway-binary object
+ *
+ * Callback will be used for transfer data to output stream of the application. It will be called from
+ * CO_GTWB_process() zero or multiple times, depending on the data available. If readCallback is uninitialized or NULL,
+ * then responses are discarded.
+ *
+ * @param gtwb This object
+ * @param readCallback Pointer to external function for reading response from Gateway-binary object. See
+ * @ref CO_GTWA_t::readCallback for parameters.
+ * @param readCallbackObject Pointer to object, which will be used inside readCallback
+ */
+void CO_GTWB_initRead(CO_GTWB_t* gtwb,
+                      size_t (*readCallback)(void* object, const char* buf, size_t count, uint8_t* connectionOK),
+                      void* readCallbackObject);
+
+/**
+ * Get free write buffer space
+ *
+ * Space is zero, while a complete frame waits for a free request slot.
+ *
+ * @param gtwb This object
+ *
+ * @return number of available bytes
+ */
+static inline size_t
+CO_GTWB_write_getSpace(CO_GTWB_t* gtwb) {
+    return (gtwb->rxSkip > 0U) ? CO_GTWB_FRAME_MAX : (sizeof(gtwb->rxBuf) - gtwb->rxCount);
+}
+
+/**
+ * Write received bytes into CO_GTWB_t object.
+ *
+ * Bytes are copied into the internal buffer, complete frames are taken by CO_GTWB_process(). If there is not enough
+ * space in the buffer, not all bytes are copied and the rest can be written later.
+ *
+ * @param gtwb This object
+ * @param buf Buffer which will be copied
+ * @param count Number of bytes in buf
+ *
+ * @return number of bytes actually written.
+ */
+size_t CO_GTWB_write(CO_GTWB_t* gtwb, const char* buf, size_t count);
+
+/**
+ * Process Gateway-binary object
+ *
+ * This is non-blocking function and must be called cyclically
+ *
+ * @param gtwb This object will be initialized.
+ * @param enable If true, gateway operates normally. If false, gateway is completely disabled and no command interaction
+ * is possible. Can be connected to hardware switch, for example.
+ * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param [out] timerNext_us info to OS - see CO_process().
+ */
+void CO_GTWB_process(CO_GTWB_t* gtwb, bool_t enable, uint32_t timeDifference_us, uint32_t* timerNext_us);
+
+/** @} */ /* CO_CANopen_309_bin */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_GTW) & CO_CONFIG_GTW_BINARY */
+
+#endif /* CO_GATEWAY_BINARY_H */
@@ -18,6 +18,8 @@
  * See the License for the specific language governing permissions and limitations under the License.
  */
 
+#include <string.h>
+
 #include "CANopen.h"
 
 /* Get values from CO_config_t or from single default OD.h ********************/
@@ -255,6 +257,14 @@
 #define OD_CNT_GTWA 1
 #endif
 
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+#define OD_CNT_GTWB 1
+#else
+#define OD_CNT_GTWB 0
+#endif
+#define CO_RX_CNT_GTWB (OD_CNT_GTWB * CO_CONFIG_GTWB_SDO_CHANNELS)
+#define CO_TX_CNT_GTWB (OD_CNT_GTWB * CO_CONFIG_GTWB_SDO_CHANNELS)
+
 #if (CO_CONFIG_TRACE) & CO_CONFIG_TRACE_ENABLE
 #if !defined OD_CNT_TRACE
 #define OD_CNT_TRACE 0
@@ -279,7 +289,8 @@
 #define CO_RX_IDX_NG_MST   (CO_RX_IDX_NG_SLV + (uint16_t)CO_RX_CNT_NG_SLV)
 #define CO_RX_IDX_LSS_SLV  (CO_RX_IDX_NG_MST + (uint16_t)CO_RX_CNT_NG_MST)
 #define CO_RX_IDX_LSS_MST  (CO_RX_IDX_LSS_SLV + (uint16_t)CO_RX_CNT_LSS_SLV)
-#define CO_CNT_ALL_RX_MSGS (CO_RX_IDX_LSS_MST + (uint16_t)CO_RX_CNT_LSS_MST)
+#define CO_RX_IDX_GTWB     (CO_RX_IDX_LSS_MST + (uint16_t)CO_RX_CNT_LSS_MST)
+#define CO_CNT_ALL_RX_MSGS (CO_RX_IDX_GTWB + (uint16_t)CO_RX_CNT_GTWB)
 
 #define CO_TX_IDX_NMT_MST  0U
 #define CO_TX_IDX_GFC      (CO_TX_IDX_NMT_MST + (uint16_t)CO_TX_CNT_NMT_MST)
@@ -295,13 +306,74 @@
 #define CO_TX_IDX_NG_MST   (CO_TX_IDX_NG_SLV + (uint16_t)CO_TX_CNT_NG_SLV)
 #define CO_TX_IDX_LSS_SLV  (CO_TX_IDX_NG_MST + (uint16_t)CO_TX_CNT_NG_MST)
 #define CO_TX_IDX_LSS_MST  (CO_TX_IDX_LSS_SLV + (uint16_t)CO_TX_CNT_LSS_SLV)
-#define CO_CNT_ALL_TX_MSGS (CO_TX_IDX_LSS_MST + (uint16_t)CO_TX_CNT_LSS_MST)
+#define CO_TX_IDX_GTWB     (CO_TX_IDX_LSS_MST + (uint16_t)CO_TX_CNT_LSS_MST)
+#define CO_CNT_ALL_TX_MSGS (CO_TX_IDX_GTWB + (uint16_t)CO_TX_CNT_GTWB)
 #endif /* #ifdef #else CO_MULTIPLE_OD */
 
+#if ((CO_CONFIG_SDO_CLI) & (CO_CONFIG_SDO_CLI_ENABLE | CO_CONFIG_SDO_CLI_POOL))                                      \
+    == (CO_CONFIG_SDO_CLI_ENABLE | CO_CONFIG_SDO_CLI_POOL)
+/* First SDO client is used by the gateway, others are in the pool, up to CO_SDO_ENGINE_CHANNELS */
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII_SDO) != 0
+#define CO_SDO_POOL_FIRST(co) CO_GET_CNT(GTWA)
+#else
+#define CO_SDO_POOL_FIRST(co) 0U
+#endif
+
+static uint8_t
+CO_SDOpool_count(const CO_t* co) {
+    uint16_t count = (CO_GET_CNT(SDO_CLI) > CO_SDO_POOL_FIRST(co)) ? (CO_GET_CNT(SDO_CLI) - CO_SDO_POOL_FIRST(co)) : 0U;
+    (void)co; /* may be unused */
+    return (count > CO_SDO_ENGINE_CHANNELS) ? (uint8_t)CO_SDO_ENGINE_CHANNELS : (uint8_t)count;
+}
+#endif
+
 /* Objects from heap **********************************************************/
 #ifndef CO_USE_GLOBALS
 #include <stdlib.h>
 
+/* Objects from arena *********************************************************/
+#ifdef CO_USE_ARENA
+#if defined(CO_alloc) || defined(CO_free)
+#error CO_alloc and CO_free can not be used with CO_USE_ARENA
+#endif
+
+/* Arena, used by CO_new() inside CO_newArena() */
+static struct {
+    uint8_t* base; /* aligned start of the arena, NULL outside CO_newArena() */
+    size_t size;   /* usable size of the arena */
+    size_t used;   /* bytes allocated so far, or required, if arena is too small */
+} CO_arena;
+
+/* Target of the pointers, returned after the arena is full. CO_new() only stores pointers to the objects, it never
+ * accesses them, so allocation may continue and the required size of the arena is calculated. */
+static uint8_t CO_arenaOverflow;
+
+/* Size rounded up to the alignment of the objects */
+#define CO_ARENA_ROUND(len) (((len) + (CO_ARENA_ALIGN - 1U)) & ~(size_t)(CO_ARENA_ALIGN - 1U))
+
+static void*
+CO_arenaAlloc(size_t num, size_t size) {
+    size_t len = CO_ARENA_ROUND(num * size);
+    void* ptr = NULL;
+
+    if (CO_arena.base != NULL) {
+        if ((CO_arena.used <= CO_arena.size) && (len <= (CO_arena.size - CO_arena.used))) {
+            ptr = &CO_arena.base[CO_arena.used];
+            (void)memset(ptr, 0, len);
+        } else {
+            CO_arena.size = 0; /* arena is full, only count */
+            ptr = &CO_arenaOverflow;
+        }
+        CO_arena.used += len;
+    }
+    return ptr;
+}
+
+/* Memory belongs to the application */
+#define CO_alloc(num, size) CO_arenaAlloc((num), (size))
+#define CO_free(ptr)        (void)(ptr)
+#endif /* CO_USE_ARENA */
+
 /* Default allocation strategy ************************************************/
 #if !defined(CO_alloc) || !defined(CO_free)
 #if defined(CO_alloc)
@@ -356,7 +428,8 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
         if (config == NULL || config->CNT_NMT > 1 || config->CNT_HB_CONS > 1 || config->CNT_EM > 1
             || config->CNT_SDO_SRV > 128 || config->CNT_SDO_CLI > 128 || config->CNT_SYNC > 1 || config->CNT_RPDO > 512
             || config->CNT_TPDO > 512 || config->CNT_TIME > 1 || config->CNT_LEDS > 1 || config->CNT_GFC > 1
-            || config->CNT_SRDO > 64 || config->CNT_LSS_SLV > 1 || config->CNT_LSS_MST > 1 || config->CNT_GTWA > 1) {
+            || config->CNT_SRDO > 64 || config->CNT_LSS_SLV > 1 || config->CNT_LSS_MST > 1 || config->CNT_GTWA > 1
+            || config->CNT_GTWB > 1) {
             break;
         }
 #else
@@ -400,6 +473,15 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
 #if ((CO_CONFIG_NODE_GUARDING)&CO_CONFIG_NODE_GUARDING_MASTER_ENABLE) != 0
         CO_alloc_break_on_fail(co->NGmaster, 1, sizeof(*co->NGmaster));
 #endif
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+        CO_alloc_break_on_fail(co->netState, 1, sizeof(*co->netState));
+#endif
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+        CO_alloc_break_on_fail(co->EMcons, 1, sizeof(*co->EMcons));
+#endif
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+        CO_alloc_break_on_fail(co->prof, 1, sizeof(*co->prof));
+#endif
 
         /* Emergency */
         ON_MULTI_OD(uint8_t RX_CNT_EM_CONS = 0);
@@ -437,6 +519,21 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
             ON_MULTI_OD(RX_CNT_SDO_CLI = config->CNT_SDO_CLI);
             ON_MULTI_OD(TX_CNT_SDO_CLI = config->CNT_SDO_CLI);
         }
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_POOL) != 0
+        if (CO_SDOpool_count(co) > 0U) {
+            CO_alloc_break_on_fail(co->SDOpool, 1U, sizeof(*co->SDOpool));
+        }
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+        if (CO_GET_CNT(SDO_CLI) > 0U) {
+            CO_alloc_break_on_fail(co->SDOcache, 1U, sizeof(*co->SDOcache));
+        }
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+        if (CO_GET_CNT(SDO_CLI) > 0U) {
+            CO_alloc_break_on_fail(co->SDOrtt, 1U, sizeof(*co->SDOrtt));
+        }
+#endif
 #endif
 
 #if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_ENABLE) != 0
@@ -463,22 +560,6 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
         }
 #endif
 
-#if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_ENABLE) != 0
-        ON_MULTI_OD(uint16_t RX_CNT_RPDO = 0);
-        if (CO_GET_CNT(RPDO) > 0U) {
-            CO_alloc_break_on_fail(co->RPDO, CO_GET_CNT(RPDO), sizeof(*co->RPDO));
-            ON_MULTI_OD(RX_CNT_RPDO = config->CNT_RPDO);
-        }
-#endif
-
-#if ((CO_CONFIG_PDO)&CO_CONFIG_TPDO_ENABLE) != 0
-        ON_MULTI_OD(uint16_t TX_CNT_TPDO = 0);
-        if (CO_GET_CNT(TPDO) > 0U) {
-            CO_alloc_break_on_fail(co->TPDO, CO_GET_CNT(TPDO), sizeof(*co->TPDO));
-            ON_MULTI_OD(TX_CNT_TPDO = config->CNT_TPDO);
-        }
-#endif
-
 #if ((CO_CONFIG_LEDS)&CO_CONFIG_LEDS_ENABLE) != 0
         if (CO_GET_CNT(LEDS) == 1U) {
             CO_alloc_break_on_fail(co->LEDs, CO_GET_CNT(LEDS), sizeof(*co->LEDs));
@@ -532,12 +613,40 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
         }
 #endif
 
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+        ON_MULTI_OD(uint16_t RX_CNT_GTWB = 0);
+        ON_MULTI_OD(uint16_t TX_CNT_GTWB = 0);
+        if (CO_GET_CNT(GTWB) == 1U) {
+            CO_alloc_break_on_fail(co->gtwb, CO_GET_CNT(GTWB), sizeof(*co->gtwb));
+            ON_MULTI_OD(RX_CNT_GTWB = CO_CONFIG_GTWB_SDO_CHANNELS);
+            ON_MULTI_OD(TX_CNT_GTWB = CO_CONFIG_GTWB_SDO_CHANNELS);
+        }
+#endif
+
 #if (CO_CONFIG_TRACE) & CO_CONFIG_TRACE_ENABLE
         if (CO_GET_CNT(TRACE) > 0) {
             CO_alloc_break_on_fail(co->trace, CO_GET_CNT(TRACE), sizeof(*co->trace));
         }
 #endif
 
+        /* PDO objects are allocated last, just before the CAN objects, so the objects, used on each cycle, stay
+         * together in arena or heap */
+#if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_ENABLE) != 0
+        ON_MULTI_OD(uint16_t RX_CNT_RPDO = 0);
+        if (CO_GET_CNT(RPDO) > 0U) {
+            CO_alloc_break_on_fail(co->RPDO, CO_GET_CNT(RPDO), sizeof(*co->RPDO));
+            ON_MULTI_OD(RX_CNT_RPDO = config->CNT_RPDO);
+        }
+#endif
+
+#if ((CO_CONFIG_PDO)&CO_CONFIG_TPDO_ENABLE) != 0
+        ON_MULTI_OD(uint16_t TX_CNT_TPDO = 0);
+        if (CO_GET_CNT(TPDO) > 0U) {
+            CO_alloc_break_on_fail(co->TPDO, CO_GET_CNT(TPDO), sizeof(*co->TPDO));
+            ON_MULTI_OD(TX_CNT_TPDO = config->CNT_TPDO);
+        }
+#endif
+
 #ifdef CO_MULTIPLE_OD
         /* Indexes of CO_CANrx_t and CO_CANtx_t objects in CO_CANmodule_t and total number of them. Indexes
          * are sorted in a way, that objects with highest priority of the CAN identifier are listed first. */
@@ -591,6 +700,10 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
 #if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
         co->RX_IDX_LSS_MST = idxRx;
         idxRx += RX_CNT_LSS_MST;
+#endif
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+        co->RX_IDX_GTWB = idxRx;
+        idxRx += RX_CNT_GTWB;
 #endif
         co->CNT_ALL_RX_MSGS = idxRx;
 
@@ -642,6 +755,10 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
 #if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
         co->TX_IDX_LSS_MST = idxTx;
         idxTx += TX_CNT_LSS_MST;
+#endif
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+        co->TX_IDX_GTWB = idxTx;
+        idxTx += TX_CNT_GTWB;
 #endif
         co->CNT_ALL_TX_MSGS = idxTx;
 #endif /* #ifdef CO_MULTIPLE_OD */
@@ -686,6 +803,10 @@ CO_delete(CO_t* co) {
     CO_free(co->trace);
 #endif
 
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+    CO_free(co->gtwb);
+#endif
+
 #if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII) != 0
     CO_free(co->gtwa);
 #endif
@@ -728,6 +849,15 @@ CO_delete(CO_t* co) {
 #endif
 
 #if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+    CO_free(co->SDOcache);
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+    CO_free(co->SDOrtt);
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_POOL) != 0
+    CO_free(co->SDOpool);
+#endif
     CO_free(co->SDOclient);
 #endif
 
@@ -746,6 +876,15 @@ CO_delete(CO_t* co) {
 #if ((CO_CONFIG_NODE_GUARDING)&CO_CONFIG_NODE_GUARDING_MASTER_ENABLE) != 0
     CO_free(co->NGmaster);
 #endif
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+    CO_free(co->netState);
+#endif
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+    CO_free(co->EMcons);
+#endif
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+    CO_free(co->prof);
+#endif
 
 #if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_ENABLE) != 0
     CO_free(co->HBconsMonitoredNodes);
@@ -758,6 +897,52 @@ CO_delete(CO_t* co) {
     /* CANopen object */
     CO_free(co);
 }
+
+#ifdef CO_USE_ARENA
+CO_t*
+CO_newArena(CO_config_t* config, void* arena, size_t arenaSize, uint32_t* arenaUsed) {
+    uintptr_t addr = (uintptr_t)arena;
+    size_t pad = (size_t)(((addr + (CO_ARENA_ALIGN - 1U)) & ~(uintptr_t)(CO_ARENA_ALIGN - 1U)) - addr);
+    CO_t* co = NULL;
+
+    if (arena == NULL) {
+        return NULL;
+    }
+    /* CANopen object itself must fit, other objects may overflow for calculation of the required size */
+    if (arenaSize < (pad + CO_ARENA_ROUND(sizeof(CO_t)))) {
+        if (arenaUsed != NULL) {
+            *arenaUsed = (uint32_t)CO_arenaSize(config);
+        }
+        return NULL;
+    }
+
+    CO_arena.base = (uint8_t*)arena + pad;
+    CO_arena.size = arenaSize - pad;
+    CO_arena.used = 0;
+    co = CO_new(config, NULL);
+    if ((co != NULL) && (CO_arena.used > (arenaSize - pad))) {
+        co = NULL; /* arena too small, objects were not allocated, nothing to delete */
+    }
+    if (arenaUsed != NULL) {
+        *arenaUsed = (uint32_t)(CO_arena.used + pad);
+    }
+    CO_arena.base = NULL;
+    return co;
+}
+
+size_t
+CO_arenaSize(CO_config_t* config) {
+    /* Only CO_t is really allocated, space for the alignment is added */
+    union {
+        CO_t co;
+        uint8_t bytes[sizeof(CO_t) + (2U * CO_ARENA_ALIGN)];
+    } scratch;
+    uint32_t arenaUsed = 0;
+
+    (void)CO_newArena(config, &scratch, sizeof(scratch), &arenaUsed);
+    return (size_t)arenaUsed + (CO_ARENA_ALIGN - 1U);
+}
+#endif /* CO_USE_ARENA */
 #endif /* #ifndef CO_USE_GLOBALS */
 
 /* Objects as globals *********************************************************/
@@ -780,6 +965,15 @@ static CO_nodeGuardingSlave_t COO_NGslave;
 #if ((CO_CONFIG_NODE_GUARDING)&CO_CONFIG_NODE_GUARDING_MASTER_ENABLE) != 0
 static CO_nodeGuardingMaster_t COO_NGmaster;
 #endif
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+static CO_netState_t COO_netState;
+#endif
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+static CO_EMcons_t COO_EMcons;
+#endif
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+static CO_prof_t COO_prof;
+#endif
 static CO_EM_t COO_EM;
 #if ((CO_CONFIG_EM) & (CO_CONFIG_EM_PRODUCER | CO_CONFIG_EM_HISTORY)) != 0
 static CO_EM_fifo_t COO_EM_FIFO[CO_GET_CNT(ARR_1003) + 1U];
@@ -787,6 +981,15 @@ static CO_EM_fifo_t COO_EM_FIFO[CO_GET_CNT(ARR_1003) + 1U];
 static CO_SDOserver_t COO_SDOserver[OD_CNT_SDO_SRV];
 #if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0
 static CO_SDOclient_t COO_SDOclient[OD_CNT_SDO_CLI];
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_POOL) != 0
+static CO_SDOengine_t COO_SDOpool;
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+static CO_SDOcache_t COO_SDOcache;
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+static CO_SDOrtt_t COO_SDOrtt;
+#endif
 #endif
 #if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_ENABLE) != 0
 static CO_TIME_t COO_TIME;
@@ -819,6 +1022,9 @@ static CO_LSSmaster_t COO_LSSmaster;
 #if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII) != 0
 static CO_GTWA_t COO_gtwa;
 #endif
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+static CO_GTWB_t COO_gtwb;
+#endif
 #if ((CO_CONFIG_TRACE)&CO_CONFIG_TRACE_ENABLE) != 0
 #ifndef CO_TRACE_BUFFER_SIZE_FIXED
 #define CO_TRACE_BUFFER_SIZE_FIXED 100
@@ -849,6 +1055,15 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
 #endif
 #if ((CO_CONFIG_NODE_GUARDING)&CO_CONFIG_NODE_GUARDING_MASTER_ENABLE) != 0
     co->NGmaster = &COO_NGmaster;
+#endif
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+    co->netState = &COO_netState;
+#endif
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+    co->EMcons = &COO_EMcons;
+#endif
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+    co->prof = &COO_prof;
 #endif
     co->em = &COO_EM;
 #if ((CO_CONFIG_EM) & (CO_CONFIG_EM_PRODUCER | CO_CONFIG_EM_HISTORY)) != 0
@@ -857,6 +1072,21 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
     co->SDOserver = &COO_SDOserver[0];
 #if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0
     co->SDOclient = &COO_SDOclient[0];
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_POOL) != 0
+    if (CO_SDOpool_count(co) > 0U) {
+        co->SDOpool = &COO_SDOpool;
+    }
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+    if (CO_GET_CNT(SDO_CLI) > 0U) {
+        co->SDOcache = &COO_SDOcache;
+    }
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+    if (CO_GET_CNT(SDO_CLI) > 0U) {
+        co->SDOrtt = &COO_SDOrtt;
+    }
+#endif
 #endif
 #if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_ENABLE) != 0
     co->TIME = &COO_TIME;
@@ -889,6 +1119,9 @@ CO_new(CO_config_t* config, uint32_t* heapMemoryUsed) {
 #if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII) != 0
     co->gtwa = &COO_gtwa;
 #endif
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+    co->gtwb = &COO_gtwb;
+#endif
 #if ((CO_CONFIG_TRACE)&CO_CONFIG_TRACE_ENABLE) != 0
     co->trace = &COO_trace[0];
     co->traceTimeBuffers = &COO_traceTimeBuffers[0][0];
@@ -1076,6 +1309,36 @@ CO_CANopenInit(CO_t* co, CO_NMT_t* NMT, CO_EM_t* em, OD_t* od, OD_entry_t* OD_st
     }
 #endif
 
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+    CO_netState_init(co->netState);
+#if ((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0
+    if (CO_GET_CNT(EM) == 1U) {
+        CO_EM_setNetState(co->em, co->netState);
+    }
+#endif
+#if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_ENABLE) != 0
+    if (CO_GET_CNT(HB_CONS) == 1U) {
+        CO_HBconsumer_setNetState(co->HBcons, co->netState);
+    }
+#endif
+#if ((CO_CONFIG_NODE_GUARDING)&CO_CONFIG_NODE_GUARDING_MASTER_ENABLE) != 0
+    CO_nodeGuardingMaster_setNetState(co->NGmaster, co->netState);
+#endif
+#endif
+
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+    CO_EMcons_init(co->EMcons);
+#if ((CO_CONFIG_EM)&CO_CONFIG_EM_CONSUMER) != 0
+    if (CO_GET_CNT(EM) == 1U) {
+        CO_EM_setEMcons(co->em, co->EMcons);
+    }
+#endif
+#endif
+
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+    CO_prof_init(co->prof);
+#endif
+
     /* SDOserver */
     if (CO_GET_CNT(SDO_SRV) > 0U) {
         OD_entry_t* SDOsrvPar = OD_GET(H1200, OD_H1200_SDO_SERVER_1_PARAM);
@@ -1101,9 +1364,40 @@ CO_CANopenInit(CO_t* co, CO_NMT_t* NMT, CO_EM_t* em, OD_t* od, OD_entry_t* OD_st
             if (err != CO_ERROR_NO) {
                 return err;
             }
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+            CO_SDOclient_setCache(&co->SDOclient[i], co->SDOcache);
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+            CO_SDOclient_setRtt(&co->SDOclient[i], co->SDOrtt);
+#endif
+        }
+    }
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0
+    if (co->SDOrtt != NULL) {
+        CO_SDOrtt_init(co->SDOrtt, CO_SDO_RTT_MIN_TIMEOUT_MS, CO_SDO_RTT_MAX_TIMEOUT_MS, CO_SDO_RTT_RETRIES);
+    }
+#endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0
+    if (co->SDOcache != NULL) {
+        CO_SDOcache_init(co->SDOcache, NULL, NULL);
+#if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_ENABLE) != 0
+        /* remote node with boot-up or heartbeat timeout may be reset or replaced, forget its static objects */
+        if (CO_GET_CNT(HB_CONS) == 1U) {
+            CO_HBconsumer_setSDOcache(co->HBcons, co->SDOcache);
         }
+#endif
     }
 #endif
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_POOL) != 0
+    if (co->SDOpool != NULL) {
+        err = CO_SDOengine_initPool(co->SDOpool, &co->SDOclient[CO_SDO_POOL_FIRST(co)], CO_SDOpool_count(co),
+                                    SDOclientTimeoutTime_ms);
+        if (err != CO_ERROR_NO) {
+            return err;
+        }
+    }
+#endif
+#endif
 
 #if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_ENABLE) != 0
     if (CO_GET_CNT(TIME) == 1U) {
@@ -1165,6 +1459,23 @@ CO_CANopenInit(CO_t* co, CO_NMT_t* NMT, CO_EM_t* em, OD_t* od, OD_entry_t* OD_st
     }
 #endif
 
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+    if (CO_GET_CNT(GTWB) == 1U) {
+        err = CO_GTWB_init(co->gtwb, co->CANmodule, CO_GET_CO(RX_IDX_GTWB), co->CANmodule, CO_GET_CO(TX_IDX_GTWB),
+                           SDOclientTimeoutTime_ms,
+#if ((CO_CONFIG_NMT)&CO_CONFIG_NMT_MASTER) != 0
+                           co->NMT,
+#endif
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
+                           co->LSSmaster,
+#endif
+                           0);
+        if (err != CO_ERROR_NO) {
+            return err;
+        }
+    }
+#endif
+
 #if (CO_CONFIG_TRACE) & CO_CONFIG_TRACE_ENABLE
     if (CO_GET_CNT(TRACE) > 0) {
         for (uint16_t i = 0; i < CO_GET_CNT(TRACE); i++) {
@@ -1180,6 +1491,11 @@ CO_CANopenInit(CO_t* co, CO_NMT_t* NMT, CO_EM_t* em, OD_t* od, OD_entry_t* OD_st
     }
 #endif
 
+#if OD_HANDLES > 0
+    /* IO extensions are initialized now, update OD handles of the application */
+    OD_rebindHandles(od);
+#endif
+
     return CO_ERROR_NO;
 }
 
@@ -1196,6 +1512,9 @@ CO_CANopenInitPDO(CO_t* co, CO_EM_t* em, OD_t* od, uint8_t nodeId, uint32_t* err
     if (CO_GET_CNT(RPDO) > 0U) {
         OD_entry_t* RPDOcomm = OD_GET(H1400, OD_H1400_RXPDO_1_PARAM);
         OD_entry_t* RPDOmap = OD_GET(H1600, OD_H1600_RXPDO_1_MAPPING);
+#if CO_RPDO_READY_WORDS > 0
+        (void)memset(&co->RPDOready, 0, sizeof(co->RPDOready));
+#endif
         for (uint16_t i = 0; i < CO_GET_CNT(RPDO); i++) {
             CO_ReturnError_t err;
             uint16_t preDefinedCanId = 0;
@@ -1216,6 +1535,9 @@ CO_CANopenInitPDO(CO_t* co, CO_EM_t* em, OD_t* od, uint8_t nodeId, uint32_t* err
             if (err != CO_ERROR_NO) {
                 return err;
             }
+#if CO_RPDO_READY_WORDS > 0
+            CO_RPDO_initReady(&co->RPDO[i], &co->RPDOready, i);
+#endif
             RPDOcomm++;
             RPDOmap++;
         }
@@ -1226,6 +1548,9 @@ CO_CANopenInitPDO(CO_t* co, CO_EM_t* em, OD_t* od, uint8_t nodeId, uint32_t* err
     if (CO_GET_CNT(TPDO) > 0U) {
         OD_entry_t* TPDOcomm = OD_GET(H1800, OD_H1800_TXPDO_1_PARAM);
         OD_entry_t* TPDOmap = OD_GET(H1A00, OD_H1A00_TXPDO_1_MAPPING);
+#if OD_TPDO_PENDING_WORDS > 0
+        (void)memset(&co->TPDOpending, 0, sizeof(co->TPDOpending));
+#endif
         for (uint16_t i = 0; i < CO_GET_CNT(TPDO); i++) {
             CO_ReturnError_t err;
             uint16_t preDefinedCanId = 0;
@@ -1246,12 +1571,19 @@ CO_CANopenInitPDO(CO_t* co, CO_EM_t* em, OD_t* od, uint8_t nodeId, uint32_t* err
             if (err != CO_ERROR_NO) {
                 return err;
             }
+#if OD_TPDO_PENDING_WORDS > 0
+            CO_TPDO_initPending(&co->TPDO[i], &co->TPDOpending, i);
+#endif
             TPDOcomm++;
             TPDOmap++;
         }
     }
 #endif
 
+#if OD_HANDLES > 0
+    OD_rebindHandles(od);
+#endif
+
     return CO_ERROR_NO;
 }
 
@@ -1279,6 +1611,7 @@ CO_CANopenInitSRDO(CO_t* co, CO_EM_t* em, OD_t* od, uint8_t nodeId, uint32_t* er
 #if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_ENABLE) != 0
     if (CO_GET_CNT(SRDO) > 0U) {
         CO_ReturnError_t err;
+        co->SRDOwasOperational = false;
         err = CO_SRDOGuard_init(co->SRDOGuard, OD_GET(H13FE, OD_H13FE_SRDO_VALID),
                                 OD_GET(H13FF, OD_H13FF_SRDO_CHECKSUM), errInfo);
         if (err != CO_ERROR_NO) {
@@ -1307,31 +1640,82 @@ CO_CANopenInitSRDO(CO_t* co, CO_EM_t* em, OD_t* od, uint8_t nodeId, uint32_t* er
 }
 #endif
 
+/* Objects used by the processing functions. With CO_USE_GLOBALS all counts and addresses are known at compile time,
+ * so objects are accessed directly instead of through the pointers in CO_t. Branches on disabled objects are then
+ * folded away by the compiler and the processing functions are specialized for the fixed configuration. */
+#ifdef CO_USE_GLOBALS
+#define CO_OBJ(obj) (CO_GLOBAL_##obj)
+#define CO_GLOBAL_CANmodule  (&COO_CANmodule)
+#define CO_GLOBAL_NMT        (&COO_NMT)
+#define CO_GLOBAL_HBcons     (&COO_HBcons)
+#define CO_GLOBAL_NGslave    (&COO_NGslave)
+#define CO_GLOBAL_NGmaster   (&COO_NGmaster)
+#define CO_GLOBAL_netState   (&COO_netState)
+#define CO_GLOBAL_EMcons     (&COO_EMcons)
+#define CO_GLOBAL_prof       (&COO_prof)
+#define CO_GLOBAL_em         (&COO_EM)
+#define CO_GLOBAL_SDOserver  (&COO_SDOserver[0])
+#define CO_GLOBAL_SDOpool    (&COO_SDOpool)
+#define CO_GLOBAL_TIME       (&COO_TIME)
+#define CO_GLOBAL_SYNC       (&COO_SYNC)
+#define CO_GLOBAL_RPDO       (&COO_RPDO[0])
+#define CO_GLOBAL_TPDO       (&COO_TPDO[0])
+#define CO_GLOBAL_LEDs       (&COO_LEDs)
+#define CO_GLOBAL_SRDOGuard  (&COO_SRDOGuard)
+#define CO_GLOBAL_SRDO       (&COO_SRDO[0])
+#define CO_GLOBAL_LSSslave   (&COO_LSSslave)
+#define CO_GLOBAL_gtwa       (&COO_gtwa)
+#define CO_GLOBAL_gtwb       (&COO_gtwb)
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_SLAVE) != 0
+#define CO_NODE_ID_UNCONFIGURED(co) ((CO_GET_CNT(LSS_SLV) == 1U) && (co)->nodeIdUnconfigured)
+#else
+#define CO_NODE_ID_UNCONFIGURED(co) false
+#endif
+#else
+#define CO_OBJ(obj)                 (co->obj)
+#define CO_NODE_ID_UNCONFIGURED(co) ((co)->nodeIdUnconfigured)
+#endif
+
+/* Execution time of processing steps, see CO_prof_lap() */
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+#define CO_PROF_START(time)            uint32_t time = CO_PROF_TIME_NS()
+#define CO_PROF_LAP(section, time)     CO_prof_lap(CO_OBJ(prof), (section), &(time))
+#define CO_PROF_END(section, time)     CO_prof_add(CO_OBJ(prof), (section), CO_PROF_TIME_NS() - (time))
+#else
+#define CO_PROF_START(time)
+#define CO_PROF_LAP(section, time)
+#define CO_PROF_END(section, time)
+#endif
+
 CO_NMT_reset_cmd_t
 CO_process(CO_t* co, bool_t enableGateway, uint32_t timeDifference_us, uint32_t* timerNext_us) {
     (void)enableGateway; /* may be unused */
     CO_NMT_reset_cmd_t reset = CO_RESET_NOT;
-    CO_NMT_internalState_t NMTstate = CO_NMT_getInternalState(co->NMT);
+    CO_NMT_internalState_t NMTstate = CO_NMT_getInternalState(CO_OBJ(NMT));
     bool_t NMTisPreOrOperational = ((NMTstate == CO_NMT_PRE_OPERATIONAL) || (NMTstate == CO_NMT_OPERATIONAL));
+    CO_PROF_START(profStart);
+    CO_PROF_START(profTime);
 
     /* CAN module */
-    CO_CANmodule_process(co->CANmodule);
+    CO_CANmodule_process(CO_OBJ(CANmodule));
+    CO_PROF_LAP(CO_PROF_CAN, profTime);
 
 #if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_SLAVE)
     if (CO_GET_CNT(LSS_SLV) == 1U) {
-        if (CO_LSSslave_process(co->LSSslave)) {
+        if (CO_LSSslave_process(CO_OBJ(LSSslave))) {
             reset = CO_RESET_COMM;
         }
+        CO_PROF_LAP(CO_PROF_LSS, profTime);
     }
 #endif
 
 #if ((CO_CONFIG_LEDS)&CO_CONFIG_LEDS_ENABLE) != 0
-    bool_t unc = co->nodeIdUnconfigured;
-    uint16_t CANerrorStatus = co->CANmodule->CANerrorStatus;
+    bool_t unc = CO_NODE_ID_UNCONFIGURED(co);
+    uint16_t CANerrorStatus = CO_OBJ(CANmodule)->CANerrorStatus;
     bool_t LSSslave_configuration = false;
 #if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_SLAVE) != 0
     if (CO_GET_CNT(LSS_SLV) == 1U) {
-        if (CO_LSSslave_getState(co->LSSslave) == CO_LSS_STATE_CONFIGURATION) {
+        if (CO_LSSslave_getState(CO_OBJ(LSSslave)) == CO_LSS_STATE_CONFIGURATION) {
             LSSslave_configuration = true;
         }
     }
@@ -1342,64 +1726,102 @@ CO_process(CO_t* co, bool_t enableGateway, uint32_t timeDifference_us, uint32_t*
 #endif
 
     if (CO_GET_CNT(LEDS) == 1U) {
-        bool_t ErrSync = CO_isError(co->em, CO_EM_SYNC_TIME_OUT);
-        bool_t ErrHbCons = CO_isError(co->em, CO_EM_HEARTBEAT_CONSUMER);
-        bool_t ErrHbConsRemote = CO_isError(co->em, CO_EM_HB_CONSUMER_REMOTE_RESET);
-        CO_LEDs_process(co->LEDs, timeDifference_us, unc ? CO_NMT_INITIALIZING : NMTstate, LSSslave_configuration,
+        bool_t ErrSync = CO_isError(CO_OBJ(em), CO_EM_SYNC_TIME_OUT);
+        bool_t ErrHbCons = CO_isError(CO_OBJ(em), CO_EM_HEARTBEAT_CONSUMER);
+        bool_t ErrHbConsRemote = CO_isError(CO_OBJ(em), CO_EM_HB_CONSUMER_REMOTE_RESET);
+        CO_LEDs_process(CO_OBJ(LEDs), timeDifference_us, unc ? CO_NMT_INITIALIZING : NMTstate, LSSslave_configuration,
                         (CANerrorStatus & CO_CAN_ERRTX_BUS_OFF) != 0U, (CANerrorStatus & CO_CAN_ERR_WARN_PASSIVE) != 0U,
                         false, /* RPDO event timer timeout */
                         unc ? false : ErrSync, unc ? false : (ErrHbCons || ErrHbConsRemote),
-                        CO_getErrorRegister(co->em) != 0U, CO_STATUS_FIRMWARE_DOWNLOAD_IN_PROGRESS, timerNext_us);
+                        CO_getErrorRegister(CO_OBJ(em)) != 0U, CO_STATUS_FIRMWARE_DOWNLOAD_IN_PROGRESS, timerNext_us);
+        CO_PROF_LAP(CO_PROF_LEDS, profTime);
     }
 #endif
 
     /* CANopen Node ID is unconfigured (LSS slave), stop processing here */
-    if (co->nodeIdUnconfigured) {
+    if (CO_NODE_ID_UNCONFIGURED(co)) {
         return reset;
     }
 
     /* Emergency */
     if (CO_GET_CNT(EM) == 1U) {
-        CO_EM_process(co->em, NMTisPreOrOperational, timeDifference_us, timerNext_us);
+        CO_EM_process(CO_OBJ(em), NMTisPreOrOperational, timeDifference_us, timerNext_us);
+        CO_PROF_LAP(CO_PROF_EM, profTime);
     }
 
     /* NMT_Heartbeat */
     if (CO_GET_CNT(NMT) == 1U) {
-        reset = CO_NMT_process(co->NMT, &NMTstate, timeDifference_us, timerNext_us);
+        reset = CO_NMT_process(CO_OBJ(NMT), &NMTstate, timeDifference_us, timerNext_us);
+        CO_PROF_LAP(CO_PROF_NMT, profTime);
     }
     NMTisPreOrOperational = ((NMTstate == CO_NMT_PRE_OPERATIONAL) || (NMTstate == CO_NMT_OPERATIONAL));
 
     /* SDOserver */
     for (uint8_t i = 0; i < CO_GET_CNT(SDO_SRV); i++) {
-        (void)CO_SDOserver_process(&co->SDOserver[i], NMTisPreOrOperational, timeDifference_us, timerNext_us);
+        (void)CO_SDOserver_process(&CO_OBJ(SDOserver)[i], NMTisPreOrOperational, timeDifference_us, timerNext_us);
+    }
+    if (CO_GET_CNT(SDO_SRV) > 0U) {
+        CO_PROF_LAP(CO_PROF_SDO_SRV, profTime);
     }
 
 #if ((CO_CONFIG_HB_CONS)&CO_CONFIG_HB_CONS_ENABLE) != 0
     if (CO_GET_CNT(HB_CONS) == 1U) {
-        CO_HBconsumer_process(co->HBcons, NMTisPreOrOperational, timeDifference_us, timerNext_us);
+        CO_HBconsumer_process(CO_OBJ(HBcons), NMTisPreOrOperational, timeDifference_us, timerNext_us);
+        CO_PROF_LAP(CO_PROF_HB_CONS, profTime);
     }
 #endif
 
 #if ((CO_CONFIG_NODE_GUARDING)&CO_CONFIG_NODE_GUARDING_SLAVE_ENABLE) != 0
-    CO_nodeGuardingSlave_process(co->NGslave, NMTstate, (co->NMT->HBproducerTime_us > 0U), timeDifference_us,
+    CO_nodeGuardingSlave_process(CO_OBJ(NGslave), NMTstate, (CO_OBJ(NMT)->HBproducerTime_us > 0U), timeDifference_us,
                                  timerNext_us);
 #endif
 #if ((CO_CONFIG_NODE_GUARDING)&CO_CONFIG_NODE_GUARDING_MASTER_ENABLE) != 0
-    CO_nodeGuardingMaster_process(co->NGmaster, timeDifference_us, timerNext_us);
+    CO_nodeGuardingMaster_process(CO_OBJ(NGmaster), timeDifference_us, timerNext_us);
+#endif
+#if ((CO_CONFIG_NODE_GUARDING) & (CO_CONFIG_NODE_GUARDING_SLAVE_ENABLE | CO_CONFIG_NODE_GUARDING_MASTER_ENABLE)) != 0
+    CO_PROF_LAP(CO_PROF_NG, profTime);
+#endif
+
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+    CO_netState_process(CO_OBJ(netState), timeDifference_us);
+    CO_PROF_LAP(CO_PROF_NET_STATE, profTime);
+#endif
+
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+    CO_EMcons_process(CO_OBJ(EMcons), timeDifference_us, timerNext_us);
+    CO_PROF_LAP(CO_PROF_EM_CONS, profTime);
 #endif
 
 #if ((CO_CONFIG_TIME)&CO_CONFIG_TIME_ENABLE) != 0
     if (CO_GET_CNT(TIME) == 1U) {
-        (void)CO_TIME_process(co->TIME, NMTisPreOrOperational, timeDifference_us);
+        (void)CO_TIME_process(CO_OBJ(TIME), NMTisPreOrOperational, timeDifference_us);
+        CO_PROF_LAP(CO_PROF_TIME, profTime);
+    }
+#endif
+
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_POOL) != 0
+    /* all SDO clients in the pool, one transfer per node */
+    if (CO_SDOpool_count(co) > 0U) {
+        (void)CO_SDOengine_process(CO_OBJ(SDOpool), timeDifference_us, timerNext_us);
+        CO_PROF_LAP(CO_PROF_SDO_CLI, profTime);
     }
 #endif
 
 #if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII) != 0
     if (CO_GET_CNT(GTWA) == 1U) {
-        CO_GTWA_process(co->gtwa, enableGateway, timeDifference_us, timerNext_us);
+        CO_GTWA_process(CO_OBJ(gtwa), enableGateway, timeDifference_us, timerNext_us);
+        CO_PROF_LAP(CO_PROF_GTWA, profTime);
     }
 #endif
 
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+    if (CO_GET_CNT(GTWB) == 1U) {
+        CO_GTWB_process(CO_OBJ(gtwb), enableGateway, timeDifference_us, timerNext_us);
+        CO_PROF_LAP(CO_PROF_GTWB, profTime);
+    }
+#endif
+
+    CO_PROF_END(CO_PROF_PROCESS, profStart);
     return reset;
 }
 
@@ -1408,45 +1830,106 @@ bool_t
 CO_process_SYNC(CO_t* co, uint32_t timeDifference_us, uint32_t* timerNext_us) {
     bool_t syncWas = false;
 
-    if ((!co->nodeIdUnconfigured) && (CO_GET_CNT(SYNC) == 1U)) {
-        CO_NMT_internalState_t NMTstate = CO_NMT_getInternalState(co->NMT);
+    if (!CO_NODE_ID_UNCONFIGURED(co) && (CO_GET_CNT(SYNC) == 1U)) {
+        CO_PROF_START(profStart);
+        CO_NMT_internalState_t NMTstate = CO_NMT_getInternalState(CO_OBJ(NMT));
         bool_t NMTisPreOrOperational = ((NMTstate == CO_NMT_PRE_OPERATIONAL) || (NMTstate == CO_NMT_OPERATIONAL));
 
-        CO_SYNC_status_t sync_process = CO_SYNC_process(co->SYNC, NMTisPreOrOperational, timeDifference_us,
+        CO_SYNC_status_t sync_process = CO_SYNC_process(CO_OBJ(SYNC), NMTisPreOrOperational, timeDifference_us,
                                                         timerNext_us);
 
         switch (sync_process) {
             case CO_SYNC_NONE: break;
             case CO_SYNC_RX_TX: syncWas = true; break;
-            case CO_SYNC_PASSED_WINDOW: CO_CANclearPendingSyncPDOs(co->CANmodule); break;
+            case CO_SYNC_PASSED_WINDOW: CO_CANclearPendingSyncPDOs(CO_OBJ(CANmodule)); break;
             default:
                 /* MISRA C 2004 15.3 */
                 break;
         }
+        CO_PROF_END(CO_PROF_SYNC, profStart);
     }
 
     return syncWas;
 }
 #endif
 
+#if (OD_TPDO_PENDING_WORDS > 0) || (CO_RPDO_READY_WORDS > 0)
+/* Position of the lowest set bit, bits must not be zero */
+static inline uint8_t
+CO_bitScan(uint32_t bits) {
+#if defined __GNUC__
+    return (uint8_t)__builtin_ctz(bits);
+#else
+    uint8_t pos = 0;
+    while ((bits & 1U) == 0U) {
+        bits >>= 1;
+        pos++;
+    }
+    return pos;
+#endif
+}
+#endif
+
 #if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_ENABLE) != 0
 void
 CO_process_RPDO(CO_t* co, bool_t syncWas, uint32_t timeDifference_us, uint32_t* timerNext_us) {
     (void)timeDifference_us;
     (void)timerNext_us;
-    if (co->nodeIdUnconfigured) {
+    if (CO_NODE_ID_UNCONFIGURED(co)) {
         return;
     }
 
-    bool_t NMTisOperational = CO_NMT_getInternalState(co->NMT) == CO_NMT_OPERATIONAL;
+    CO_PROF_START(profStart);
+    bool_t NMTisOperational = CO_NMT_getInternalState(CO_OBJ(NMT)) == CO_NMT_OPERATIONAL;
 
+#if CO_RPDO_READY_WORDS > 0
+    /* visit only received and active RPDOs, all of them on NMT state change */
+    CO_RPDO_ready_t* ready = &co->RPDOready;
+    bool_t visitAll = ready->NMTisOperational != NMTisOperational;
+    uint16_t bitmapCount = CO_GET_CNT(RPDO);
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_SYNC_ENABLE) != 0
+    /* after SYNC the other buffer than in CO_PDO_receive() is relevant */
+    uint8_t bufNo = ((CO_GET_CNT(SYNC) == 1U) && !CO_OBJ(SYNC)->CANrxToggle) ? 1U : 0U;
+#endif
+
+    ready->NMTisOperational = NMTisOperational;
+    if (bitmapCount > (CO_RPDO_READY_WORDS * 32U)) {
+        bitmapCount = CO_RPDO_READY_WORDS * 32U;
+    }
+    for (uint16_t w = 0; (w * 32U) < bitmapCount; w++) {
+        uint32_t bits = ready->active[w] | CO_FLAG_BITS_TAKE(ready->readyAsync[w]);
+#if ((CO_CONFIG_PDO)&CO_CONFIG_PDO_SYNC_ENABLE) != 0
+        if (syncWas) {
+            bits |= CO_FLAG_BITS_TAKE(ready->readySync[bufNo][w]);
+        }
+#endif
+        if (visitAll) {
+            bits = 0xFFFFFFFFU;
+        }
+        while (bits != 0U) {
+            uint16_t i = (w * 32U) + CO_bitScan(bits);
+            bits &= bits - 1U;
+            if (i >= bitmapCount) {
+                break;
+            }
+            CO_RPDO_process(&CO_OBJ(RPDO)[i],
+#if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_TIMERS_ENABLE) != 0
+                            timeDifference_us, timerNext_us,
+#endif
+                            NMTisOperational, syncWas);
+        }
+    }
+    for (uint16_t i = bitmapCount; i < CO_GET_CNT(RPDO); i++) {
+#else
     for (uint16_t i = 0; i < CO_GET_CNT(RPDO); i++) {
-        CO_RPDO_process(&co->RPDO[i],
+#endif
+        CO_RPDO_process(&CO_OBJ(RPDO)[i],
 #if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_TIMERS_ENABLE) != 0
                         timeDifference_us, timerNext_us,
 #endif
                         NMTisOperational, syncWas);
     }
+    CO_PROF_END(CO_PROF_RPDO, profStart);
 }
 #endif
 
@@ -1455,40 +1938,70 @@ void
 CO_process_TPDO(CO_t* co, bool_t syncWas, uint32_t timeDifference_us, uint32_t* timerNext_us) {
     (void)timeDifference_us;
     (void)timerNext_us;
-    if (co->nodeIdUnconfigured) {
+    if (CO_NODE_ID_UNCONFIGURED(co)) {
         return;
     }
 
-    bool_t NMTisOperational = CO_NMT_getInternalState(co->NMT) == CO_NMT_OPERATIONAL;
+    CO_PROF_START(profStart);
+    bool_t NMTisOperational = CO_NMT_getInternalState(CO_OBJ(NMT)) == CO_NMT_OPERATIONAL;
 
+#if OD_TPDO_PENDING_WORDS > 0
+    /* visit only active and pending TPDOs, all of them on NMT state change */
+    CO_TPDO_pending_t* pending = &co->TPDOpending;
+    bool_t visitAll = pending->NMTisOperational != NMTisOperational;
+    uint16_t bitmapCount = CO_GET_CNT(TPDO);
+
+    pending->NMTisOperational = NMTisOperational;
+    if (bitmapCount > (OD_TPDO_PENDING_WORDS * 32U)) {
+        bitmapCount = OD_TPDO_PENDING_WORDS * 32U;
+    }
+    for (uint16_t w = 0; (w * 32U) < bitmapCount; w++) {
+        uint32_t bits = visitAll ? 0xFFFFFFFFU : (pending->active[w] | pending->pending[w]);
+        pending->pending[w] = 0;
+        while (bits != 0U) {
+            uint16_t i = (w * 32U) + CO_bitScan(bits);
+            bits &= bits - 1U;
+            if (i >= bitmapCount) {
+                break;
+            }
+            CO_TPDO_process(&CO_OBJ(TPDO)[i],
+#if ((CO_CONFIG_PDO)&CO_CONFIG_TPDO_TIMERS_ENABLE) != 0
+                            timeDifference_us, timerNext_us,
+#endif
+                            NMTisOperational, syncWas);
+        }
+    }
+    for (uint16_t i = bitmapCount; i < CO_GET_CNT(TPDO); i++) {
+#else
     for (uint16_t i = 0; i < CO_GET_CNT(TPDO); i++) {
-        CO_TPDO_process(&co->TPDO[i],
+#endif
+        CO_TPDO_process(&CO_OBJ(TPDO)[i],
 #if ((CO_CONFIG_PDO)&CO_CONFIG_TPDO_TIMERS_ENABLE) != 0
                         timeDifference_us, timerNext_us,
 #endif
                         NMTisOperational, syncWas);
     }
+    CO_PROF_END(CO_PROF_TPDO, profStart);
 }
 #endif
 
 #if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_ENABLE) != 0
 CO_SRDO_state_t
 CO_process_SRDO(CO_t* co, uint32_t timeDifference_us, uint32_t* timerNext_us) {
-    static bool_t NMTisOperationalPrevius = false;
     uint8_t i;
     CO_ReturnError_t err;
 
-    if (co->nodeIdUnconfigured) {
+    if (CO_NODE_ID_UNCONFIGURED(co)) {
         return CO_SRDO_state_unknown;
     }
 
-    bool_t NMTisOperational = CO_NMT_getInternalState(co->NMT) == CO_NMT_OPERATIONAL;
+    bool_t NMTisOperational = CO_NMT_getInternalState(CO_OBJ(NMT)) == CO_NMT_OPERATIONAL;
 
-    if (NMTisOperationalPrevius != NMTisOperational) {
-        NMTisOperationalPrevius = NMTisOperational;
+    if (co->SRDOwasOperational != NMTisOperational) {
+        co->SRDOwasOperational = NMTisOperational;
         if (NMTisOperational) {
             for (i = 0; i < CO_GET_CNT(SRDO); i++) {
-                err = CO_SRDO_config(&co->SRDO[i], i, co->SRDOGuard, NULL);
+                err = CO_SRDO_config(&CO_OBJ(SRDO)[i], i, CO_OBJ(SRDOGuard), NULL);
 
                 if (err != CO_ERROR_NO) {
                     return CO_SRDO_state_error_internal;
@@ -1498,13 +2011,15 @@ CO_process_SRDO(CO_t* co, uint32_t timeDifference_us, uint32_t* timerNext_us) {
     }
 
     CO_SRDO_state_t lowestState = CO_SRDO_state_deleted;
+    CO_PROF_START(profStart);
 
     for (i = 0; i < CO_GET_CNT(SRDO); i++) {
-        CO_SRDO_state_t state = CO_SRDO_process(&co->SRDO[i], timeDifference_us, timerNext_us, NMTisOperational);
+        CO_SRDO_state_t state = CO_SRDO_process(&CO_OBJ(SRDO)[i], timeDifference_us, timerNext_us, NMTisOperational);
         if (state < lowestState) {
             lowestState = state;
         }
     }
+    CO_PROF_END(CO_PROF_SRDO, profStart);
 
     return lowestState;
 }
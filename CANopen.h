@@ -39,7 +39,14 @@
 #include "305/CO_LSSslave.h"
 #include "305/CO_LSSmaster.h"
 #include "309/CO_gateway_ascii.h"
+#include "309/CO_gateway_binary.h"
 #include "extra/CO_trace.h"
+#include "extra/CO_SDOengine.h"
+#include "extra/CO_SDOcache.h"
+#include "extra/CO_SDOrtt.h"
+#include "extra/CO_netState.h"
+#include "extra/CO_EMcons.h"
+#include "extra/CO_prof.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -165,11 +172,35 @@ extern "C" {
  * If macro is defined externally, then global variables for CANopen objects
  * will be used instead of heap. This is possible only if CO_MULTIPLE_OD is not
  * defined.
+ *
+ * With globals, all object counts and addresses are compile time constants. @ref CO_process() and the other
+ * processing functions then access objects directly instead of through CO_t pointers, and checks for objects which
+ * are not present in the Object Dictionary (node-id unconfigured without LSS slave, empty SDO client pool, ...) are
+ * removed by the compiler. This gives smaller and faster processing functions specialized for the fixed
+ * configuration. The application still passes the CO_t object, returned by @ref CO_new().
  */
 #ifdef CO_DOXYGEN
 #define CO_USE_GLOBALS
 #endif
 
+/**
+ * If macro is defined externally, then CANopen objects are allocated from arena, supplied by the application with
+ * @ref CO_newArena(), instead of heap. All objects are placed one after another, PDO objects and CAN receive and
+ * transmit arrays at the end, close together. Can not be used together with CO_USE_GLOBALS.
+ */
+#ifdef CO_DOXYGEN
+#define CO_USE_ARENA
+#endif
+
+#if defined CO_USE_ARENA || defined CO_DOXYGEN
+#ifdef CO_USE_GLOBALS
+#error CO_USE_ARENA can not be used with CO_USE_GLOBALS
+#endif
+#ifndef CO_ARENA_ALIGN
+#define CO_ARENA_ALIGN 8U /**< Alignment of objects inside arena, power of two, at least alignment of uint64_t */
+#endif
+#endif
+
 #if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
 /**
  * CANopen configuration, used with @ref CO_new()
@@ -228,6 +259,7 @@ typedef struct {
     uint8_t CNT_LSS_SLV;     /**< Number of LSSslave objects, 0 or 1 (CANrx + CANtx). */
     uint8_t CNT_LSS_MST;     /**< Number of LSSmaster objects, 0 or 1 (CANrx + CANtx). */
     uint8_t CNT_GTWA;        /**< Number of gateway ascii objects, 0 or 1. */
+    uint8_t CNT_GTWB;        /**< Number of gateway binary objects, 0 or 1 (SDO channels * (CANrx + CANtx)). */
     uint16_t CNT_TRACE;      /**< Number of trace objects, 0 or more. */
 } CO_config_t;
 #else
@@ -276,6 +308,18 @@ typedef struct {
     uint16_t RX_IDX_NG_MST; /**< Start index in CANrx. */
     uint16_t TX_IDX_NG_MST; /**< Start index in CANtx. */
 #endif
+#endif
+#if (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0) || defined CO_DOXYGEN
+    CO_netState_t* netState; /**< States of remote nodes, filled by HB consumer, NG master and EMCY consumer,
+                                initialised by @ref CO_netState_init() in CO_CANopenInit() */
+#endif
+#if (((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0) || defined CO_DOXYGEN
+    CO_EMcons_t* EMcons; /**< Queue and history of received emergency messages, initialised by @ref CO_EMcons_init()
+                            in CO_CANopenInit() */
+#endif
+#if (((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0) || defined CO_DOXYGEN
+    CO_prof_t* prof; /**< Execution time of each processing step, initialised by @ref CO_prof_init() in
+                        CO_CANopenInit() */
 #endif
     CO_EM_t* em; /**< Emergency object, initialised by @ref CO_EM_init() */
 #if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
@@ -292,6 +336,17 @@ typedef struct {
 #endif
 #if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0) || defined CO_DOXYGEN
     CO_SDOclient_t* SDOclient; /**< SDO client objects, initialised by @ref CO_SDOclient_init() */
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_POOL) != 0) || defined CO_DOXYGEN
+    CO_SDOengine_t* SDOpool; /**< Pool of SDO clients, initialised by @ref CO_SDOengine_initPool(), NULL if empty */
+#endif
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_CACHE) != 0) || defined CO_DOXYGEN
+    CO_SDOcache_t* SDOcache; /**< Cache for static objects of remote nodes, used by all SDO clients, initialised by
+                                @ref CO_SDOcache_init() in CO_CANopenInit(). Persisted entries may be loaded after. */
+#endif
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_RTT) != 0) || defined CO_DOXYGEN
+    CO_SDOrtt_t* SDOrtt; /**< Round trip time of remote nodes, used by all SDO clients, initialised by
+                            @ref CO_SDOrtt_init() in CO_CANopenInit() */
+#endif
 #if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
     uint16_t RX_IDX_SDO_CLI; /**< Start index in CANrx. */
     uint16_t TX_IDX_SDO_CLI; /**< Start index in CANtx. */
@@ -316,12 +371,18 @@ typedef struct {
 #if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
     uint16_t RX_IDX_RPDO; /**< Start index in CANrx. */
 #endif
+#if (CO_RPDO_READY_WORDS > 0) || defined CO_DOXYGEN
+    CO_RPDO_ready_t RPDOready; /**< Received and active RPDOs, visited by CO_process_RPDO() */
+#endif
 #endif
 #if (((CO_CONFIG_PDO)&CO_CONFIG_TPDO_ENABLE) != 0) || defined CO_DOXYGEN
     CO_TPDO_t* TPDO; /**< TPDO objects, initialised by @ref CO_TPDO_init() */
 #if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
     uint16_t TX_IDX_TPDO; /**< Start index in CANtx. */
 #endif
+#if (OD_TPDO_PENDING_WORDS > 0) || defined CO_DOXYGEN
+    CO_TPDO_pending_t TPDOpending; /**< Pending and active TPDOs, visited by CO_process_TPDO() */
+#endif
 #endif
 #if (((CO_CONFIG_LEDS)&CO_CONFIG_LEDS_ENABLE) != 0) || defined CO_DOXYGEN
     CO_LEDs_t* LEDs; /**< LEDs object, initialised by @ref CO_LEDs_init() */
@@ -337,6 +398,8 @@ typedef struct {
     CO_SRDOGuard_t* SRDOGuard; /**< SRDO guard object, initialised by CO_SRDOGuard_init(), single SRDOGuard object is
                                   included inside all SRDO objects */
     CO_SRDO_t* SRDO;           /**< SRDO objects, initialised by @ref CO_SRDO_init() */
+    bool_t SRDOwasOperational; /**< NMT operational state from previous CO_process_SRDO() call, SRDOs are configured on
+                                  transition to operational */
 #if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
     uint16_t RX_IDX_SRDO; /**< Start index in CANrx. */
     uint16_t TX_IDX_SRDO; /**< Start index in CANtx. */
@@ -361,6 +424,13 @@ typedef struct {
 #if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
 #endif
 #endif
+#if (((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0) || defined CO_DOXYGEN
+    CO_GTWB_t* gtwb; /**< Gateway-binary object, initialised by @ref CO_GTWB_init(). */
+#if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
+    uint16_t RX_IDX_GTWB; /**< Start index in CANrx. */
+    uint16_t TX_IDX_GTWB; /**< Start index in CANtx. */
+#endif
+#endif
 #if ((CO_CONFIG_TRACE)&CO_CONFIG_TRACE_ENABLE) || defined CO_DOXYGEN
     CO_trace_t* trace; /**< Trace object, initialised by @ref CO_trace_init(). */
 #endif
@@ -369,7 +439,8 @@ typedef struct {
 /**
  * Create new CANopen object
  *
- * If CO_USE_GLOBALS is defined, then function uses global static variables for all the CANopenNode objects. Otherwise
+ * If CO_USE_GLOBALS is defined, then function uses global static variables for all the CANopenNode objects. If
+ * CO_USE_ARENA is defined, objects are allocated from arena and @ref CO_newArena() must be used instead. Otherwise
  * it allocates all objects from heap.
  *
  * @remark
@@ -390,6 +461,33 @@ CO_t* CO_new(CO_config_t* config, uint32_t* heapMemoryUsed);
  */
 void CO_delete(CO_t* co);
 
+#if defined CO_USE_ARENA || defined CO_DOXYGEN
+/**
+ * Create new CANopen object inside arena
+ *
+ * Same as @ref CO_new(), but all objects are carved out of the arena, there is no heap usage. Arena is owned by the
+ * application, for example static array of size from @ref CO_arenaSize(). It must stay in memory until CO_delete(),
+ * which doesn't free anything. Function must not be called concurrently from several threads.
+ *
+ * @param config Configuration structure, same as in CO_new().
+ * @param arena Memory for all CANopen objects, alignment is adjusted to CO_ARENA_ALIGN.
+ * @param arenaSize Size of the arena in bytes.
+ * @param [out] arenaUsed Number of bytes of the arena used. If arena is too small, required size. Ignored if NULL.
+ *
+ * @return Successfully allocated and configured CO_t object or NULL, if arena is too small.
+ */
+CO_t* CO_newArena(CO_config_t* config, void* arena, size_t arenaSize, uint32_t* arenaUsed);
+
+/**
+ * Get size of the arena for CO_newArena()
+ *
+ * @param config Configuration structure, same as in CO_new().
+ *
+ * @return Required size in bytes, including space for alignment of the arena.
+ */
+size_t CO_arenaSize(CO_config_t* config);
+#endif
+
 /**
  * Test if LSS slave is enabled
  *
@@ -50,9 +50,12 @@ typedef float float32_t;
 typedef double float64_t;
 
 /* Access to received CAN message */
-#define CO_CANrxMsg_readIdent(msg) ((uint16_t)0)
-#define CO_CANrxMsg_readDLC(msg)   ((uint8_t)0)
-#define CO_CANrxMsg_readData(msg)  ((const uint8_t*)NULL)
+#define CO_CANrxMsg_readIdent(msg)     ((uint16_t)0)
+#define CO_CANrxMsg_readDLC(msg)       ((uint8_t)0)
+#define CO_CANrxMsg_readData(msg)      ((const uint8_t*)NULL)
+#define CO_CANrxMsg_readTimestamp(msg) ((uint64_t)0)
+#define CO_CANtimestampNow()           ((uint64_t)0)
+#define CO_CANtimestampToUnix_us(ts)   ((uint64_t)0)
 
 /* Received message object */
 typedef struct {
@@ -380,6 +380,7 @@ extern OD_ATTR_OD OD_t *OD;
     (config).CNT_LSS_SLV = 0;\
     (config).CNT_LSS_MST = 0;\
     (config).CNT_GTWA = 0;\
+    (config).CNT_GTWB = 0;\
     (config).CNT_TRACE = 0;\
 }
 #endif
@@ -0,0 +1,241 @@
+/*
+ * author: ZeroErr Inc.
+ * Binary event log for the example applications, see app_log.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "app_log.h"
+
+#define APP_LOG_THREADS_MAX 8        // Number of producer threads with own ring
+#define APP_LOG_RING_SIZE 1024       // Events per ring, power of 2
+#define APP_LOG_PERIOD_NS 10000000   // Background thread wakes up every 10 ms
+
+// Single producer, single consumer ring, one per producer thread
+typedef struct {
+    app_log_event_t events[APP_LOG_RING_SIZE];
+    atomic_uint head;                // Next event to write, modified only by the producer
+    atomic_uint tail;                // Next event to read, modified only by the background thread
+    atomic_uint dropped;
+} app_log_ring_t;
+
+atomic_int app_log_level = APP_LOG_INFO;
+
+static app_log_ring_t log_rings[APP_LOG_THREADS_MAX];
+static atomic_uint log_ring_count = 0;      // Rings assigned to threads
+static _Thread_local app_log_ring_t *log_ring = NULL;
+static _Thread_local int log_ring_failed = 0;
+
+static pthread_t log_thread;
+static atomic_int log_running = 0;
+static FILE *log_out = NULL;
+static uint64_t log_start_ns = 0;
+
+static uint64_t log_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/* Ring of the calling thread, assigned on the first event */
+static app_log_ring_t *log_get_ring(void) {
+    if (log_ring == NULL && !log_ring_failed) {
+        unsigned int i = atomic_fetch_add(&log_ring_count, 1);
+        if (i < APP_LOG_THREADS_MAX) {
+            log_ring = &log_rings[i];
+        } else {
+            log_ring_failed = 1;
+        }
+    }
+    return log_ring;
+}
+
+void app_log_event(uint8_t level, uint16_t code, uint32_t cob_id, const uint8_t *data, uint8_t dlc, uint32_t arg) {
+    app_log_ring_t *ring;
+    app_log_event_t *ev;
+    unsigned int head;
+
+    if (!app_log_enabled(level) || (ring = log_get_ring()) == NULL) {
+        return;
+    }
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= APP_LOG_RING_SIZE) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    ev = &ring->events[head & (APP_LOG_RING_SIZE - 1)];
+    ev->timestamp_ns = log_time_ns();
+    ev->cob_id = cob_id;
+    ev->arg = arg;
+    ev->code = code;
+    ev->level = level;
+    ev->dlc = dlc > 8 ? 8 : dlc;
+    memset(ev->data, 0, sizeof(ev->data));
+    if (data != NULL) {
+        memcpy(ev->data, data, ev->dlc);
+    }
+    ev->thread = (uint32_t)(ring - log_rings);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+uint32_t app_log_dropped(void) {
+    uint32_t dropped = 0;
+    for (int i = 0; i < APP_LOG_THREADS_MAX; i++) {
+        dropped += atomic_load_explicit(&log_rings[i].dropped, memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void app_log_set_level(int level) {
+    if (level < APP_LOG_OFF) {
+        level = APP_LOG_OFF;
+    } else if (level > APP_LOG_DEBUG) {
+        level = APP_LOG_DEBUG;
+    }
+    atomic_store_explicit(&app_log_level, level, memory_order_relaxed);
+}
+
+/* Format one event, this is the only place where events are converted to text */
+static void log_print(const app_log_event_t *ev) {
+    uint64_t t_ns = ev->timestamp_ns > log_start_ns ? ev->timestamp_ns - log_start_ns : 0;
+    uint16_t index = ev->data[0] | (ev->data[1] << 8);
+    uint32_t value = ev->data[4] | (ev->data[5] << 8) | (ev->data[6] << 16) | ((uint32_t)ev->data[7] << 24);
+
+    fprintf(log_out, "[%5u.%06u] ", (unsigned int)(t_ns / 1000000000), (unsigned int)(t_ns / 1000 % 1000000));
+    switch (ev->code) {
+        case APP_LOG_EV_SDO_WRITE:
+            fprintf(log_out, "SDO write node %u 0x%04X:%u = 0x%08X (%u bytes)\n", ev->cob_id & 0x7F, index,
+                    ev->data[2], value, ev->data[3]);
+            return;
+        case APP_LOG_EV_SDO_READ:
+            fprintf(log_out, "SDO read  node %u 0x%04X:%u = 0x%08X (%u bytes)\n", ev->cob_id & 0x7F, index,
+                    ev->data[2], value, ev->data[3]);
+            return;
+        case APP_LOG_EV_SDO_ABORT:
+            fprintf(log_out, "SDO %s node %u 0x%04X:%u failed, abort 0x%08X%s\n", ev->data[3] ? "read " : "write",
+                    ev->cob_id & 0x7F, index, ev->data[2], ev->arg, ev->arg == 0x05040000 ? " (timeout)" : "");
+            return;
+        case APP_LOG_EV_STATUS: {
+            uint16_t sw = ev->data[0] | (ev->data[1] << 8);
+            int32_t pos = (int32_t)(ev->data[2] | (ev->data[3] << 8) | (ev->data[4] << 16) |
+                                    ((uint32_t)ev->data[5] << 24));
+            fprintf(log_out, "node %u status word 0x%04X position %d%s%s%s\n", ev->cob_id, sw, pos,
+                    (sw & 0x0008) ? " FAULT" : "", (sw & 0x1000) ? " setpoint-ack" : "",
+                    (sw & 0x0400) ? " target-reached" : "");
+            return;
+        }
+        case APP_LOG_EV_SETPOINT_ACK:
+            fprintf(log_out, "node %u setpoint acknowledged after %.3f ms\n", ev->cob_id, ev->arg / 1000.0);
+            return;
+        case APP_LOG_EV_TARGET_REACHED:
+            fprintf(log_out, "node %u target reached after %.3f ms\n", ev->cob_id, ev->arg / 1000.0);
+            return;
+        case APP_LOG_EV_MARK:
+            fprintf(log_out, "mark %u\n", ev->arg);
+            return;
+        default:
+            break;
+    }
+
+    // Frames
+    const char *dir = ev->code == APP_LOG_EV_CAN_TX ? "TX  " : (ev->code == APP_LOG_EV_EMCY ? "EMCY" : "RX  ");
+    fprintf(log_out, "%s 0x%03X [%u]", dir, ev->cob_id, ev->dlc);
+    for (int i = 0; i < ev->dlc; i++) {
+        fprintf(log_out, " %02X", ev->data[i]);
+    }
+    fprintf(log_out, "\n");
+}
+
+/* Print all recorded events, oldest first. Return number of printed events. */
+static int log_drain(void) {
+    unsigned int count = atomic_load(&log_ring_count);
+    int printed = 0;
+
+    if (count > APP_LOG_THREADS_MAX) {
+        count = APP_LOG_THREADS_MAX;
+    }
+    for (;;) {
+        app_log_ring_t *oldest = NULL;
+        const app_log_event_t *ev_oldest = NULL;
+
+        // Merge rings by timestamp
+        for (unsigned int i = 0; i < count; i++) {
+            app_log_ring_t *ring = &log_rings[i];
+            unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            if (tail != atomic_load_explicit(&ring->head, memory_order_acquire)) {
+                const app_log_event_t *ev = &ring->events[tail & (APP_LOG_RING_SIZE - 1)];
+                if (ev_oldest == NULL || ev->timestamp_ns < ev_oldest->timestamp_ns) {
+                    oldest = ring;
+                    ev_oldest = ev;
+                }
+            }
+        }
+        if (oldest == NULL) {
+            break;
+        }
+        log_print(ev_oldest);
+        atomic_fetch_add_explicit(&oldest->tail, 1, memory_order_release);
+        printed++;
+    }
+    if (printed > 0) {
+        fflush(log_out);
+    }
+    return printed;
+}
+
+static void *log_thread_main(void *arg) {
+    struct timespec period = {.tv_sec = 0, .tv_nsec = APP_LOG_PERIOD_NS};
+    (void)arg;
+
+    while (atomic_load(&log_running)) {
+        log_drain();
+        nanosleep(&period, NULL);
+    }
+    log_drain();
+    return NULL;
+}
+
+int app_log_init(int level) {
+    const char *env_level = getenv("APP_LOG_LEVEL");
+    const char *env_file = getenv("APP_LOG_FILE");
+
+    app_log_set_level(env_level != NULL ? atoi(env_level) : level);
+    log_out = stdout;
+    if (env_file != NULL && env_file[0] != '\0') {
+        log_out = fopen(env_file, "w");
+        if (log_out == NULL) {
+            perror("Open log file failed");
+            log_out = stdout;
+        }
+    }
+    log_start_ns = log_time_ns();
+
+    atomic_store(&log_running, 1);
+    if (pthread_create(&log_thread, NULL, log_thread_main, NULL) != 0) {
+        atomic_store(&log_running, 0);
+        app_log_set_level(APP_LOG_OFF);
+        return -1;
+    }
+    return 0;
+}
+
+void app_log_close(void) {
+    if (!atomic_load(&log_running)) {
+        return;
+    }
+    atomic_store(&log_running, 0);
+    pthread_join(log_thread, NULL);
+    uint32_t dropped = app_log_dropped();
+    if (dropped > 0) {
+        fprintf(log_out, "%u log events dropped\n", dropped);
+    }
+    if (log_out != stdout) {
+        fclose(log_out);
+    }
+    log_out = NULL;
+}
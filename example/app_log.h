@@ -0,0 +1,74 @@
+/*
+ * author: ZeroErr Inc.
+ * Binary event log for the example applications
+ *
+ * Control path records fixed size binary events (timestamp, COB-ID, up to 8 data bytes, event code and one argument)
+ * into a lock-free ring of the calling thread. Nothing is formatted there. A background thread collects events from
+ * all rings in timestamp order, formats them and prints them to stdout or to a log file. If a ring is full, events
+ * are dropped and counted, the control path never waits for the console.
+ *
+ * Log level can be changed at runtime with app_log_set_level(). Initial level and log file are taken from the
+ * environment variables APP_LOG_LEVEL (0..3) and APP_LOG_FILE, if they are set.
+ */
+
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Log levels
+#define APP_LOG_OFF 0
+#define APP_LOG_ERROR 1   // failed transfers, emergency messages
+#define APP_LOG_INFO 2    // SDO transfers
+#define APP_LOG_DEBUG 3   // every PDO and NMT frame
+
+// Event codes, they define the meaning of data[] and arg
+#define APP_LOG_EV_SDO_WRITE 1   // cob_id: SDO request, data: index(2) subindex(1) size(1) value(4)
+#define APP_LOG_EV_SDO_READ 2    // cob_id: SDO request, data: index(2) subindex(1) size(1) value(4)
+#define APP_LOG_EV_SDO_ABORT 3   // cob_id: SDO request, data: index(2) subindex(1) upload(1), arg: abort code
+#define APP_LOG_EV_CAN_TX 4      // transmitted frame, for example RPDO or NMT
+#define APP_LOG_EV_CAN_RX 5      // received frame, for example TPDO
+#define APP_LOG_EV_EMCY 6        // received emergency message
+#define APP_LOG_EV_MARK 7        // application marker, arg: user value
+#define APP_LOG_EV_STATUS 8      // cob_id: node ID, data: statusword(2) position(4), from motion_monitor
+#define APP_LOG_EV_SETPOINT_ACK 9    // cob_id: node ID, arg: command to statusword bit 12 in us
+#define APP_LOG_EV_TARGET_REACHED 10 // cob_id: node ID, arg: command to statusword bit 10 in us
+
+// One event, 32 bytes
+typedef struct {
+    uint64_t timestamp_ns;   // CLOCK_MONOTONIC
+    uint32_t cob_id;
+    uint32_t arg;
+    uint16_t code;           // APP_LOG_EV_xxx
+    uint8_t level;           // APP_LOG_xxx
+    uint8_t dlc;             // Number of valid bytes in data[]
+    uint8_t data[8];
+    uint32_t thread;         // Index of the producer ring
+} app_log_event_t;
+
+// Current level, use app_log_enabled() and app_log_set_level()
+extern atomic_int app_log_level;
+
+/* Start the background thread. level is used, if APP_LOG_LEVEL is not set. Log goes to APP_LOG_FILE or to stdout.
+ * Return 0 on success, -1 on error. */
+int app_log_init(int level);
+
+/* Print remaining events and stop the background thread */
+void app_log_close(void);
+
+/* Change log level at runtime */
+void app_log_set_level(int level);
+
+/* Return nonzero, if events of the level are recorded */
+static inline int app_log_enabled(int level) {
+    return level <= atomic_load_explicit(&app_log_level, memory_order_relaxed);
+}
+
+/* Record one event into the ring of the calling thread, if level is enabled. dlc is limited to 8. */
+void app_log_event(uint8_t level, uint16_t code, uint32_t cob_id, const uint8_t *data, uint8_t dlc, uint32_t arg);
+
+/* Number of events dropped because a ring was full */
+uint32_t app_log_dropped(void);
+
+#endif // APP_LOG_H
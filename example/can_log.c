@@ -0,0 +1,334 @@
+/*
+ * author: ZeroErr Inc.
+ * CAN record and replay tool: records CAN traffic through the socketCAN driver into a memory mapped log (CO_CANlog),
+ * prints it and replays it into a CANopen node
+ *
+ * record: standalone CAN module of the driver with one receive buffer for all 11-bit COB-IDs, so frames are recorded
+ *         by the driver exactly as a CANopen node receives them, with kernel receive timestamps and error frames.
+ * dump:   prints the records of the log, or with -c only the records of one COB-ID, from the COB-ID index. At the
+ *         end a summary of the records of each COB-ID is printed.
+ * replay: eRob node (OD_erob, generated from the EDS) in a CO_network thread. Frames received by the recording node
+ *         are passed to its CANrx_callback functions (CO_CANrxInject()) at the original timing or, with -f, as fast as
+ *         possible in batches, followed by processing. Frames sent by the recording node are skipped. Replay is
+ *         deterministic benchmark and regression input: the same log always gives the same input to the stack.
+ *
+ * Usage: can_log record <file> [-i <interface>] [-d <seconds>] [-c <capacity>]
+ *        can_log dump <file> [-c <COB-ID>]
+ *        can_log replay <file> [-i <interface>] [-n <node-id>] [-f] [-b <batch>]
+ *
+ * Example: ./can_log record can0.colog -i can0 -d 60
+ *          ./can_log dump can0.colog -c 0x182
+ *          ./can_log replay can0.colog -i vcan0 -n 2 -f
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <net/if.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "CANopen.h"
+#include "OD_erob.h"
+#include "CO_network.h"
+#include "CO_CANlog.h"
+
+#define DEFAULT_CAPACITY  1000000U
+#define DEFAULT_NODE_ID   2
+#define DEFAULT_BATCH     64U
+#define NETWORK_INTERVAL  100000
+
+// replay state, used by the network thread
+typedef struct {
+    CO_CANlog_t *log;
+    CO_CANreplay_t replay;
+    bool_t fast;
+    uint32_t batch;
+    bool_t started;
+    uint64_t start_us;
+    uint64_t end_us;
+    volatile bool_t done;
+} replay_app_t;
+
+static volatile sig_atomic_t end_program = 0;
+
+static void sig_handler(int sig) {
+    (void)sig;
+    end_program = 1;
+}
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s record <file> [-i <interface>] [-d <seconds>] [-c <capacity>]\n", prog);
+    printf("       %s dump <file> [-c <COB-ID>]\n", prog);
+    printf("       %s replay <file> [-i <interface>] [-n <node-id>] [-f] [-b <batch>]\n\n", prog);
+    printf("Options:\n");
+    printf("  -i <interface>  CAN interface (default: can0 for record, vcan0 for replay)\n");
+    printf("  -d <seconds>    record time (default: until Ctrl+C)\n");
+    printf("  -c <capacity>   record: maximum number of frames (default: %u)\n", DEFAULT_CAPACITY);
+    printf("  -c <COB-ID>     dump: only records of this 11-bit COB-ID, 0x800 for extended frames\n");
+    printf("  -n <node-id>    replay: node-id of the eRob node (default: %d)\n", DEFAULT_NODE_ID);
+    printf("  -f              replay as fast as possible, not at the original timing\n");
+    printf("  -b <batch>      replay -f: frames per processing pass (default: %u)\n", DEFAULT_BATCH);
+}
+
+// no CANopen objects in the recorder, frames are recorded by the driver before dispatch
+static void record_rx(void *object, void *message) {
+    (void)object;
+    (void)message;
+}
+
+static int record_run(const char *path, const char *ifname, uint32_t duration_s, uint32_t capacity) {
+    static CO_CANmodule_t can_module;
+    static CO_CANrx_t rx_array[1];
+    static CO_CANtx_t tx_array[1];
+    static CO_CANlog_t log;
+    CO_CANptrSocketCan_t can_ptr = {.can_ifindex = (int)if_nametoindex(ifname), .log = &log};
+
+    if (can_ptr.can_ifindex == 0) {
+        fprintf(stderr, "Error: interface %s not found\n", ifname);
+        return EXIT_FAILURE;
+    }
+    CO_ReturnError_t err = CO_CANlog_create(&log, path, capacity, false);
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "Error: log %s can't be created: %s\n", path, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    err = CO_CANmodule_init(&can_module, &can_ptr, rx_array, 1, tx_array, 1, 0);
+    if (err == CO_ERROR_NO) {
+        // ident 0 and mask 0 match all 11-bit COB-IDs
+        err = CO_CANrxBufferInit(&can_module, 0, 0, 0, false, NULL, record_rx);
+    }
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "Error: CAN module on %s can't be initialized (%d)\n", ifname, err);
+        CO_CANmodule_disable(&can_module);
+        CO_CANlog_close(&log);
+        return EXIT_FAILURE;
+    }
+    CO_CANsetNormalMode(&can_module);
+
+    signal(SIGINT, sig_handler);
+    signal(SIGTERM, sig_handler);
+    printf("Recording %s into %s, up to %u frames\n", ifname, path, capacity);
+
+    uint64_t start = CO_CANtimestampNow();
+    struct pollfd pfd = {.fd = can_module.fd, .events = POLLIN};
+    while (!end_program && (duration_s == 0 || CO_CANtimestampNow() - start < (uint64_t)duration_s * 1000000U)) {
+        int ret = poll(&pfd, 1, 100);
+        if (ret < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+        if (ret > 0 && CO_CANinterrupt(&can_module) < 0) {
+            perror("recvmmsg");
+            break;
+        }
+        if (CO_CANlog_count(&log) >= capacity) {
+            break;
+        }
+    }
+
+    uint32_t count = CO_CANlog_count(&log);
+    uint32_t dropped = (uint32_t)atomic_load(&log.header->dropped);
+    CO_CANmodule_disable(&can_module);
+    CO_CANlog_close(&log);
+    printf("%u frames recorded, %u not recorded (log full)\n", count, dropped);
+    return EXIT_SUCCESS;
+}
+
+static void dump_record(const CO_CANlogRecord_t *rec, uint64_t first_us) {
+    printf("%12.6f %s ", (double)(int64_t)(rec->timestamp_us - first_us) / 1e6,
+           (rec->flags & CO_CAN_LOG_TX) != 0U ? "TX" : "RX");
+    if ((rec->can_id & CAN_ERR_FLAG) != 0U) {
+        printf("ERROR %08" PRIX32 "    ", rec->can_id & CAN_ERR_MASK);
+    } else if ((rec->can_id & CAN_EFF_FLAG) != 0U) {
+        printf("%08" PRIX32 "%s ", rec->can_id & CAN_EFF_MASK, (rec->can_id & CAN_RTR_FLAG) != 0U ? " R" : "  ");
+    } else {
+        printf("     %03" PRIX32 "%s ", rec->can_id & CAN_SFF_MASK, (rec->can_id & CAN_RTR_FLAG) != 0U ? " R" : "  ");
+    }
+    printf("[%u]", rec->len);
+    for (uint8_t i = 0; i < rec->len; i++) {
+        printf(" %02X", rec->data[i]);
+    }
+    printf("%s\n", (rec->flags & CO_CAN_LOG_FD) != 0U ? " FD" : "");
+}
+
+static int dump_run(const char *path, long cob_id) {
+    CO_CANlog_t log;
+
+    if (CO_CANlog_open(&log, path) != CO_ERROR_NO) {
+        fprintf(stderr, "Error: %s is not a CAN log or can't be read\n", path);
+        return EXIT_FAILURE;
+    }
+    const CO_CANlogRecord_t *first = CO_CANlog_record(&log, 0);
+    uint64_t first_us = first != NULL ? first->timestamp_us : log.header->start_us;
+
+    if (cob_id >= 0) {
+        for (const CO_CANlogRecord_t *rec = CO_CANlog_first(&log, (uint16_t)cob_id); rec != NULL;
+             rec = CO_CANlog_next(&log, rec)) {
+            dump_record(rec, first_us);
+        }
+    } else {
+        for (uint32_t n = 0; n < CO_CANlog_count(&log); n++) {
+            const CO_CANlogRecord_t *rec = CO_CANlog_record(&log, n);
+            if (rec != NULL) {
+                dump_record(rec, first_us);
+            }
+        }
+    }
+
+    printf("\n%u records, %u not recorded, %u data bytes per record\n", CO_CANlog_count(&log),
+           (uint32_t)atomic_load(&log.header->dropped), log.header->dataSize);
+    printf("COB-ID   records\n");
+    for (uint16_t i = 0; i < CO_CAN_LOG_IDENTS; i++) {
+        uint32_t count = CO_CANlog_identCount(&log, i);
+        if (count > 0U && (cob_id < 0 || cob_id == i)) {
+            if (i == CO_CAN_LOG_EXT) {
+                printf("ext      %u\n", count);
+            } else {
+                printf("%03X      %u\n", i, count);
+            }
+        }
+    }
+    CO_CANlog_close(&log);
+    return EXIT_SUCCESS;
+}
+
+// network thread, after each processing pass
+static void replay_process(CO_network_t *network) {
+    replay_app_t *app = network->config.appObject;
+    uint64_t now = CO_CANtimestampNow();
+
+    if (app->done) {
+        return;
+    }
+    if (!app->started) {
+        // the timing of the first record starts now
+        const CO_CANlogRecord_t *first = CO_CANlog_record(app->log, 0);
+        int64_t offset = first != NULL ? (int64_t)(now - first->timestamp_us) : 0;
+        CO_CANreplay_init(&app->replay, app->log, app->fast ? 0 : offset, CO_CAN_LOG_TX);
+        app->start_us = now;
+        app->started = true;
+    }
+
+    uint32_t replayed;
+    if (app->fast) {
+        replayed = CO_CANreplay_process(&app->replay, network->co->CANmodule, UINT64_MAX, app->batch);
+    } else {
+        replayed = CO_CANreplay_process(&app->replay, network->co->CANmodule, now, UINT32_MAX);
+    }
+
+    uint64_t next = CO_CANreplay_nextTime(&app->replay);
+    if (next == UINT64_MAX) {
+        app->end_us = CO_CANtimestampNow();
+        app->done = true;
+    } else if (app->fast || replayed > 0U) {
+        // process replayed frames and continue immediately
+        network->ep.timerNext_us = 0;
+    } else if (next - now < network->ep.timerNext_us) {
+        network->ep.timerNext_us = (uint32_t)(next - now);
+    }
+}
+
+static int replay_run(const char *path, const char *ifname, uint8_t node_id, bool_t fast, uint32_t batch) {
+    static CO_network_t network;
+    static CO_CANlog_t log;
+    static replay_app_t app;
+
+    if (CO_CANlog_open(&log, path) != CO_ERROR_NO) {
+        fprintf(stderr, "Error: %s is not a CAN log or can't be read\n", path);
+        return EXIT_FAILURE;
+    }
+    app.log = &log;
+    app.fast = fast;
+    app.batch = batch > 0U ? batch : 1U;
+
+    CO_networkConfig_t config = {.ifName = ifname, .nodeId = node_id, .od = OD_erob, .cpu = -1,
+                                 .interval_us = NETWORK_INTERVAL, .appProcess = replay_process, .appObject = &app};
+
+    signal(SIGINT, sig_handler);
+    signal(SIGTERM, sig_handler);
+
+    CO_ReturnError_t err = CO_network_start(&network, &config, 1);
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "Error: network start failed on %s: %d\n", ifname, err);
+        CO_CANlog_close(&log);
+        return EXIT_FAILURE;
+    }
+    printf("Replaying %u records of %s into node %u on %s%s\n", CO_CANlog_count(&log), path, node_id, ifname,
+           fast ? ", as fast as possible" : "");
+
+    CO_networkStatus_t status;
+    do {
+        usleep(10000);
+        CO_network_getStatus(&network, &status);
+    } while (!end_program && !app.done && status.state == CO_NETWORK_RUNNING);
+
+    CO_network_stop(&network, 1);
+
+    if (status.state == CO_NETWORK_ERROR) {
+        fprintf(stderr, "Error: network stopped: %d\n", status.lastError);
+    }
+    double elapsed_s = app.done ? (double)(app.end_us - app.start_us) / 1e6 : 0.0;
+    printf("%u frames replayed, %u skipped, %.3f s", app.replay.replayed, app.replay.skipped, elapsed_s);
+    if (elapsed_s > 0.0) {
+        printf(", %.0f frames/s", (double)app.replay.replayed / elapsed_s);
+    }
+    printf("\n%" PRIu64 " processing passes, NMT state %d, CAN error status 0x%04X\n", status.loopCount,
+           (int)status.NMTstate, status.CANerrorStatus);
+    CO_CANlog_close(&log);
+    return app.done ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char *argv[]) {
+    const char *ifname = NULL;
+    uint32_t duration_s = 0;
+    uint32_t capacity = DEFAULT_CAPACITY;
+    long cob_id = -1;
+    uint8_t node_id = DEFAULT_NODE_ID;
+    bool_t fast = false;
+    uint32_t batch = DEFAULT_BATCH;
+    int opt;
+
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *mode = argv[1];
+    const char *path = argv[2];
+    bool_t dump = strcmp(mode, "dump") == 0;
+
+    optind = 3;
+    while ((opt = getopt(argc, argv, "i:d:c:n:fb:h")) != -1) {
+        switch (opt) {
+            case 'i': ifname = optarg; break;
+            case 'd': duration_s = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c':
+                if (dump) {
+                    cob_id = strtol(optarg, NULL, 0);
+                } else {
+                    capacity = (uint32_t)strtoul(optarg, NULL, 0);
+                }
+                break;
+            case 'n': node_id = (uint8_t)strtoul(optarg, NULL, 0); break;
+            case 'f': fast = true; break;
+            case 'b': batch = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'h': print_usage(argv[0]); return EXIT_SUCCESS;
+            default: print_usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    if (strcmp(mode, "record") == 0 && capacity > 0U) {
+        return record_run(path, ifname != NULL ? ifname : "can0", duration_s, capacity);
+    }
+    if (dump && cob_id < (long)CO_CAN_LOG_IDENTS) {
+        return dump_run(path, cob_id);
+    }
+    if (strcmp(mode, "replay") == 0 && node_id >= 1 && node_id <= 127) {
+        return replay_run(path, ifname != NULL ? ifname : "vcan0", node_id, fast, batch);
+    }
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+}
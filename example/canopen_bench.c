@@ -0,0 +1,939 @@
+/*
+ * author: ZeroErr Inc.
+ * CANopen benchmark suite: a master and N simulated eRob slaves in one process, on vcan or any socketCAN interface
+ *
+ * Each node runs in its own CO_network thread on the same CAN interface (node-ids differ, Linux loops the frames
+ * back to the other sockets). Master (node 1) produces SYNC and runs SDO transfers to the first slave. Slaves use
+ * copies of the eRob Object Dictionary (OD_erob, generated from the EDS), they form a ring: TPDO1 of each slave maps
+ * 0x6064 and is received as RPDO1 into 0x607A of the next slave.
+ *
+ * Measured:
+ * - process:  processing passes (CO_epoll_processRT/Main) per second of each network
+ * - pdo:      RPDOs per second, received by all slaves, and expected rate from SYNC period
+ * - rpdo_rx_to_od_us:    kernel receive timestamp of the RPDO to the write of 0x607A
+ * - pdo_end_to_end_us:   read of 0x6064 for the TPDO at the producer to the write of 0x607A at the consumer
+ * - sync_jitter_us:      |interval between received SYNC messages - SYNC period|, measured by the slaves
+ * - sdo:      expedited (4-byte download to 0x6081), segmented and block download and upload of a large domain
+ * - profile_ns:  execution time of each processing step (CO_prof) of all networks and, uploaded over SDO from the OD
+ *                record 0x2FF1, of the first slave. Master transmits one SRDO (CiA 304, 0x2F10 normal and inverted,
+ *                COB-IDs 0x101/0x102), all slaves receive it, so section "SRDO" is the execution time of
+ *                CO_process_SRDO() for transmission (master) and for reception (slaves). SRDO state of each network
+ *                is in process.networks[].srdo_state, 3 is communication established.
+ *
+ * Result is one JSON object on stdout, progress and errors are on stderr. Latency percentiles come from histograms
+ * with 1 us buckets up to 10 ms, larger values are counted as overflow and shown only in max.
+ *
+ * Usage: canopen_bench [-i <interface>] [-n <slaves>] [-t <seconds>] [-s <SYNC period us>] [-b <SDO bytes>]
+ *                      [-e <expedited transfers>] [-p <priority>]
+ *
+ * Example: sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0 && ./canopen_bench -n 8 -t 10
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+/* OD_obj_var_t for the large SDO domain */
+#define OD_DEFINITION
+
+#include "CANopen.h"
+#include "OD.h"
+#include "OD_hash.h"
+#include "OD_erob.h"
+#include "CO_network.h"
+#include "CO_SDObulk.h"
+#include "301/crc16-ccitt.h"
+
+#define MASTER_NODE_ID 1
+#define MAX_SLAVES     32
+
+// 1 us buckets, last bucket counts values above the range
+#define HIST_BUCKETS 10000
+
+// OD object with large domain in the first slave, target of segmented and block transfers
+#define BIG_INDEX 0x2FF0
+
+// Target of expedited transfers, profile velocity of the first slave
+#define EXPEDITED_INDEX 0x6081
+
+// OD record with execution time statistics of the first slave, see CO_prof_initOD(), uploaded at the end
+#define PROF_INDEX 0x2FF1
+
+// SRDO: mapped variables and parameters, COB-IDs are not the defaults, so they don't depend on the node-id
+#define SRDO_DATA_INDEX  0x2F10
+#define SRDO_COB_ID      0x101
+#define SRDO_SCT_TX_MS   10
+#define SRDO_SCT_RX_MS   50
+#define SRDO_SRVT_MS     20
+#define SRDO_ENTRIES     5
+// values of 0x1301:01 (information direction) and 0x13FE:00 (configuration valid), see CO_SRDO.c
+#define SRDO_DIRECTION_TX 1
+#define SRDO_DIRECTION_RX 2
+#define SRDO_VALID        0xA5
+
+#define WARMUP_S          1
+#define SDO_TIMEOUT_MS    1000
+#define SDO_EXTRA_TIME_S  120
+#define NETWORK_INTERVAL  100000
+
+typedef struct {
+    uint32_t bucket[HIST_BUCKETS + 1];
+    uint64_t count;
+    uint64_t sum;
+    uint32_t max;
+} histogram_t;
+
+typedef struct {
+    CO_network_t *network;
+    OD_t *od_clone;      // from CO_network_cloneOD()
+    OD_t *od;            // od_clone or its copy with the large domain
+    OD_extension_t ext_6064;
+    OD_extension_t ext_607A;
+    OD_obj_var_t big;    // large domain, first slave only
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+    OD_obj_record_t prof[CO_PROF_COUNT + 1]; // statistics record, first slave only
+#endif
+    histogram_t rx_to_od;
+    histogram_t end_to_end;
+    histogram_t sync_jitter;
+    uint64_t rpdo_count;
+    uint64_t sync_last_us;
+} bench_slave_t;
+
+// SRDO objects 0x1301, 0x1381, 0x13FE, 0x13FF and mapped variables 0x2F10 of one network, see srdo_entries()
+typedef struct {
+    uint8_t comm_count;
+    uint8_t direction;
+    uint16_t sct;
+    uint8_t srvt;
+    uint8_t transmission_type;
+    uint32_t cob_id[2];
+    uint8_t map_count;
+    uint32_t map[4];
+    uint8_t valid;
+    uint8_t crc_count;
+    uint16_t crc;
+    uint8_t data_count;
+    uint32_t normal32;
+    uint16_t normal16;
+    uint32_t inverted32;
+    uint16_t inverted16;
+    OD_obj_record_t comm[7];
+    OD_obj_record_t mapping[5];
+    OD_obj_var_t valid_var;
+    OD_obj_record_t checksum[2];
+    OD_obj_record_t data[5];
+} bench_srdo_t;
+
+typedef enum {
+    SDO_WAIT,
+    SDO_EXPEDITED,
+    SDO_SEG_DOWNLOAD,
+    SDO_SEG_UPLOAD,
+    SDO_BLOCK_DOWNLOAD,
+    SDO_BLOCK_UPLOAD,
+    SDO_PROFILE, // upload of the statistics record, not a benchmark
+    SDO_DONE
+} sdo_phase_t;
+
+typedef struct {
+    const char *name;
+    uint64_t transfers;
+    uint64_t bytes;
+    uint64_t errors;
+    uint64_t elapsed_us;
+    uint32_t abort_code; // last abort code
+} sdo_result_t;
+
+typedef struct {
+    sdo_phase_t phase;
+    bool_t active;        // bulk transfer is in progress
+    CO_SDObulk_t bulk;
+    uint8_t server_node;
+    size_t big_size;
+    uint32_t expedited_count;
+    uint32_t expedited_value;
+    size_t pos;           // position in the pattern of source or sink
+    bool_t mismatch;      // uploaded data differs from the pattern
+    uint64_t phase_start_us;
+    uint64_t transfer_start_us;
+    histogram_t expedited_latency;
+    sdo_result_t result[SDO_DONE];
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+    uint8_t prof_sub;     // next sub-index of the statistics record
+    uint8_t prof[CO_PROF_COUNT][CO_PROF_OD_SIZE];
+    size_t prof_received[CO_PROF_COUNT];
+#endif
+} bench_master_t;
+
+static volatile sig_atomic_t end_program = 0;
+static volatile bool_t measuring = false;
+static uint32_t sync_period_us = 1000;
+
+static bench_master_t master;
+static bench_slave_t slaves[MAX_SLAVES];
+static CO_network_t networks[MAX_SLAVES + 1];
+static CO_networkConfig_t configs[MAX_SLAVES + 1];
+static bench_srdo_t srdo[MAX_SLAVES + 1];
+
+static void sig_handler(int sig) {
+    (void)sig;
+    end_program = 1;
+}
+
+static uint64_t time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+/* histogram ******************************************************************/
+static void hist_add(histogram_t *h, uint32_t value) {
+    h->bucket[value < HIST_BUCKETS ? value : HIST_BUCKETS]++;
+    h->count++;
+    h->sum += value;
+    if (value > h->max) {
+        h->max = value;
+    }
+}
+
+static void hist_merge(histogram_t *dst, const histogram_t *src) {
+    for (uint32_t i = 0; i <= HIST_BUCKETS; i++) {
+        dst->bucket[i] += src->bucket[i];
+    }
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->max > dst->max) {
+        dst->max = src->max;
+    }
+}
+
+// smallest value, below or equal to which are permille/1000 of the samples
+static uint32_t hist_percentile(const histogram_t *h, uint32_t permille) {
+    uint64_t target = (h->count * permille + 999U) / 1000U;
+    uint64_t cumulative = 0;
+
+    if (h->count == 0U) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+        cumulative += h->bucket[i];
+        if (cumulative >= target) {
+            return i;
+        }
+    }
+    return h->max;
+}
+
+static void print_hist(const char *name, const histogram_t *h, const char *indent, bool_t last) {
+    printf("%s\"%s\": {\"count\": %llu, \"mean\": %.2f, \"p50\": %u, \"p90\": %u, \"p99\": %u, \"p999\": %u, "
+           "\"max\": %u, \"overflow\": %u}%s\n",
+           indent, name, (unsigned long long)h->count, h->count > 0U ? (double)h->sum / (double)h->count : 0.0,
+           hist_percentile(h, 500), hist_percentile(h, 900), hist_percentile(h, 990), hist_percentile(h, 999),
+           h->max, h->bucket[HIST_BUCKETS], last ? "" : ",");
+}
+
+/* slave **********************************************************************/
+// TPDO reads 0x6064: it carries the time, when the TPDO was built
+static ODR_t read_6064(OD_stream_t *stream, void *buf, OD_size_t count, OD_size_t *countRead) {
+    if (stream->subIndex == 0U && stream->dataOrig != NULL) {
+        CO_setUint32(stream->dataOrig, (uint32_t)CO_CANtimestampNow());
+    }
+    return OD_readOriginal(stream, buf, count, countRead);
+}
+
+// RPDO writes 0x607A: time from the producer and from the receive timestamp
+static ODR_t write_607A(OD_stream_t *stream, const void *buf, OD_size_t count, OD_size_t *countWritten) {
+    bench_slave_t *s = stream->object;
+    uint64_t now = CO_CANtimestampNow();
+    ODR_t ret = OD_writeOriginal(stream, buf, count, countWritten);
+
+    if (ret == ODR_OK && count == sizeof(uint32_t) && measuring) {
+        hist_add(&s->end_to_end, (uint32_t)now - CO_getUint32(buf));
+#if ((CO_CONFIG_PDO)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+        hist_add(&s->rx_to_od, CO_CANtimestampAge(s->network->co->RPDO[0].timestamp_us, now));
+#endif
+        s->rpdo_count++;
+    }
+    return ret;
+}
+
+static void slave_sync(void *object, CO_t *co) {
+    bench_slave_t *s = object;
+#if ((CO_CONFIG_SYNC)&CO_CONFIG_FLAG_RX_TIMESTAMP) != 0
+    uint64_t ts = co->SYNC->rxTimestamp_us;
+#else
+    (void)co;
+    uint64_t ts = CO_CANtimestampNow();
+#endif
+
+    if (ts == 0U || ts == s->sync_last_us) {
+        return;
+    }
+    if (s->sync_last_us != 0U && measuring) {
+        int64_t jitter = (int64_t)(ts - s->sync_last_us) - (int64_t)sync_period_us;
+        uint64_t jitter_abs = (uint64_t)(jitter < 0 ? -jitter : jitter);
+        hist_add(&s->sync_jitter, jitter_abs > UINT32_MAX ? UINT32_MAX : (uint32_t)jitter_abs);
+    }
+    s->sync_last_us = ts;
+}
+
+static void slave_init(CO_network_t *network) {
+    bench_slave_t *s = network->config.appObject;
+    s->sync_last_us = 0;
+    CO_epoll_initCallbackSync(&network->ep, s, slave_sync);
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+    if (s->big.dataOrig != NULL) {
+        (void)CO_prof_initOD(network->co->prof, OD_find(s->od, PROF_INDEX));
+    }
+#endif
+}
+
+// copy of od with additional entries, which must be ordered by index, list stays ordered by index
+static OD_t *od_insert(const OD_t *od, const OD_entry_t *entries, uint16_t count) {
+    OD_t *od_new = malloc(sizeof(OD_t));
+    OD_entry_t *list = calloc((size_t)od->size + count + 1U, sizeof(OD_entry_t));
+    uint16_t j = 0;
+    uint16_t k = 0;
+
+    if (od_new == NULL || list == NULL) {
+        free(od_new);
+        free(list);
+        return NULL;
+    }
+    for (uint16_t i = 0; i < od->size; i++) {
+        while (k < count && entries[k].index < od->list[i].index) {
+            list[j++] = entries[k++];
+        }
+        list[j++] = od->list[i];
+    }
+    while (k < count) {
+        list[j++] = entries[k++];
+    }
+    *od_new = *od;
+    od_new->size = j;
+    od_new->list = list;
+#if OD_HASH > 0
+    // positions changed, OD_find() uses binary search
+    od_new->hash = NULL;
+#endif
+    return od_new;
+}
+
+static bool_t od_set_u32(OD_t *od, uint16_t index, uint8_t sub, uint32_t value) {
+    return OD_set_u32(OD_find(od, index), sub, value, true) == ODR_OK;
+}
+
+static bool_t od_set_u8(OD_t *od, uint16_t index, uint8_t sub, uint8_t value) {
+    return OD_set_u8(OD_find(od, index), sub, value, true) == ODR_OK;
+}
+
+// TPDO1 maps 0x6064 and is sent on each SYNC, RPDO1 receives 0x607A from TPDO1 of the producer node
+static bool_t slave_configure(bench_slave_t *s, uint8_t producer_node) {
+    OD_t *od = s->od;
+    bool_t ok = true;
+
+    ok = ok && od_set_u8(od, 0x1800, 2, 1);
+    ok = ok && od_set_u32(od, 0x1A00, 1, 0x60640020);
+    ok = ok && od_set_u8(od, 0x1A00, 0, 1);
+    ok = ok && od_set_u32(od, 0x1400, 1, CO_CAN_ID_TPDO_1 + producer_node);
+    ok = ok && od_set_u8(od, 0x1400, 2, 0xFE);
+    ok = ok && od_set_u32(od, 0x1600, 1, 0x607A0020);
+    ok = ok && od_set_u8(od, 0x1600, 0, 1);
+    for (uint16_t i = 1; i < 4U && ok; i++) {
+        uint32_t cob_id;
+        ok = OD_get_u32(OD_find(od, 0x1400 + i), 1, &cob_id, true) == ODR_OK
+             && od_set_u32(od, 0x1400 + i, 1, cob_id | 0x80000000U)
+             && OD_get_u32(OD_find(od, 0x1800 + i), 1, &cob_id, true) == ODR_OK
+             && od_set_u32(od, 0x1800 + i, 1, cob_id | 0x80000000U);
+    }
+    // heartbeat is not measured
+    ok = ok && OD_set_u16(OD_find(od, 0x1017), 0, 0, true) == ODR_OK;
+    if (!ok) {
+        return false;
+    }
+
+    s->ext_6064 = (OD_extension_t){.object = s, .read = read_6064, .write = OD_writeOriginal};
+    s->ext_607A = (OD_extension_t){.object = s, .read = OD_readOriginal, .write = write_607A};
+    return OD_extension_init(OD_find(od, 0x6064), &s->ext_6064) == ODR_OK
+           && OD_extension_init(OD_find(od, 0x607A), &s->ext_607A) == ODR_OK;
+}
+
+/* SRDO ***********************************************************************/
+// signature 0x13FF, calculated over the same data as in CO_SRDO_config()
+static uint16_t srdo_crc(const bench_srdo_t *d) {
+    uint16_t crc = 0x0000;
+    uint16_t tmp_u16 = CO_SWAP_16(d->sct);
+    uint32_t tmp_u32;
+
+    crc = crc16_ccitt(&d->direction, 1, crc);
+    crc = crc16_ccitt((const uint8_t *)&tmp_u16, 2, crc);
+    crc = crc16_ccitt(&d->srvt, 1, crc);
+    for (uint8_t i = 0; i < 2U; i++) {
+        tmp_u32 = CO_SWAP_32(d->cob_id[i]);
+        crc = crc16_ccitt((const uint8_t *)&tmp_u32, 4, crc);
+    }
+    crc = crc16_ccitt(&d->map_count, 1, crc);
+    for (uint8_t i = 0; i < d->map_count; i++) {
+        uint8_t sub = i + 1U;
+        crc = crc16_ccitt(&sub, 1, crc);
+        tmp_u32 = CO_SWAP_32(d->map[i]);
+        crc = crc16_ccitt((const uint8_t *)&tmp_u32, 4, crc);
+    }
+    return crc;
+}
+
+// Valid SRDO configuration for transmission or reception, entries ordered by index: 0x1301, 0x1381, 0x13FE, 0x13FF
+// and 0x2F10 with normal u32, inverted u32, normal u16 and inverted u16 in sub-indexes 1 to 4
+static uint16_t srdo_entries(bench_srdo_t *d, bool_t tx, OD_entry_t *entries) {
+    const OD_attr_t rw = ODA_SDO_RW;
+    const OD_attr_t rw_mb = ODA_SDO_RW | ODA_MB;
+    const OD_attr_t mapped = ODA_SDO_RW | ODA_TRSRDO | ODA_MB;
+
+    d->comm_count = 6;
+    d->direction = tx ? SRDO_DIRECTION_TX : SRDO_DIRECTION_RX;
+    d->sct = tx ? SRDO_SCT_TX_MS : SRDO_SCT_RX_MS;
+    d->srvt = SRDO_SRVT_MS;
+    d->transmission_type = 254;
+    d->cob_id[0] = SRDO_COB_ID;
+    d->cob_id[1] = SRDO_COB_ID + 1U;
+    d->map_count = 4;
+    d->map[0] = ((uint32_t)SRDO_DATA_INDEX << 16) | 0x0120U;
+    d->map[1] = ((uint32_t)SRDO_DATA_INDEX << 16) | 0x0220U;
+    d->map[2] = ((uint32_t)SRDO_DATA_INDEX << 16) | 0x0310U;
+    d->map[3] = ((uint32_t)SRDO_DATA_INDEX << 16) | 0x0410U;
+    d->valid = SRDO_VALID;
+    d->crc_count = 1;
+    d->crc = srdo_crc(d);
+    d->data_count = 4;
+    d->normal32 = tx ? 0x12345678U : 0U;
+    d->normal16 = tx ? 0xA55AU : 0U;
+    d->inverted32 = tx ? (uint32_t)~d->normal32 : 0U;
+    d->inverted16 = tx ? (uint16_t)~d->normal16 : 0U;
+
+    d->comm[0] = (OD_obj_record_t){.dataOrig = &d->comm_count, .subIndex = 0, .attribute = ODA_SDO_R, .dataLength = 1};
+    d->comm[1] = (OD_obj_record_t){.dataOrig = &d->direction, .subIndex = 1, .attribute = rw, .dataLength = 1};
+    d->comm[2] = (OD_obj_record_t){.dataOrig = &d->sct, .subIndex = 2, .attribute = rw_mb, .dataLength = 2};
+    d->comm[3] = (OD_obj_record_t){.dataOrig = &d->srvt, .subIndex = 3, .attribute = rw, .dataLength = 1};
+    d->comm[4] = (OD_obj_record_t){.dataOrig = &d->transmission_type, .subIndex = 4, .attribute = rw,
+                                   .dataLength = 1};
+    d->comm[5] = (OD_obj_record_t){.dataOrig = &d->cob_id[0], .subIndex = 5, .attribute = rw_mb, .dataLength = 4};
+    d->comm[6] = (OD_obj_record_t){.dataOrig = &d->cob_id[1], .subIndex = 6, .attribute = rw_mb, .dataLength = 4};
+    d->mapping[0] = (OD_obj_record_t){.dataOrig = &d->map_count, .subIndex = 0, .attribute = rw, .dataLength = 1};
+    for (uint8_t i = 0; i < 4U; i++) {
+        d->mapping[i + 1U] = (OD_obj_record_t){.dataOrig = &d->map[i], .subIndex = i + 1U, .attribute = rw_mb,
+                                               .dataLength = 4};
+    }
+    d->valid_var = (OD_obj_var_t){.dataOrig = &d->valid, .attribute = rw, .dataLength = 1};
+    d->checksum[0] = (OD_obj_record_t){.dataOrig = &d->crc_count, .subIndex = 0, .attribute = ODA_SDO_R,
+                                       .dataLength = 1};
+    d->checksum[1] = (OD_obj_record_t){.dataOrig = &d->crc, .subIndex = 1, .attribute = rw_mb, .dataLength = 2};
+    d->data[0] = (OD_obj_record_t){.dataOrig = &d->data_count, .subIndex = 0, .attribute = ODA_SDO_R,
+                                   .dataLength = 1};
+    d->data[1] = (OD_obj_record_t){.dataOrig = &d->normal32, .subIndex = 1, .attribute = mapped, .dataLength = 4};
+    d->data[2] = (OD_obj_record_t){.dataOrig = &d->inverted32, .subIndex = 2, .attribute = mapped, .dataLength = 4};
+    d->data[3] = (OD_obj_record_t){.dataOrig = &d->normal16, .subIndex = 3, .attribute = mapped, .dataLength = 2};
+    d->data[4] = (OD_obj_record_t){.dataOrig = &d->inverted16, .subIndex = 4, .attribute = mapped, .dataLength = 2};
+
+    entries[0] = (OD_entry_t){.index = OD_H1301_SRDO_1_PARAM, .subEntriesCount = 7, .odObjectType = ODT_REC,
+                              .odObject = d->comm};
+    entries[1] = (OD_entry_t){.index = OD_H1381_SRDO_1_MAPPING, .subEntriesCount = 5, .odObjectType = ODT_REC,
+                              .odObject = d->mapping};
+    entries[2] = (OD_entry_t){.index = OD_H13FE_SRDO_VALID, .subEntriesCount = 1, .odObjectType = ODT_VAR,
+                              .odObject = &d->valid_var};
+    entries[3] = (OD_entry_t){.index = OD_H13FF_SRDO_CHECKSUM, .subEntriesCount = 2, .odObjectType = ODT_REC,
+                              .odObject = d->checksum};
+    entries[4] = (OD_entry_t){.index = SRDO_DATA_INDEX, .subEntriesCount = 5, .odObjectType = ODT_REC,
+                              .odObject = d->data};
+    return SRDO_ENTRIES;
+}
+
+// od has none of the objects from srdo_entries()
+static bool_t srdo_free(OD_t *od) {
+    return OD_find(od, OD_H1301_SRDO_1_PARAM) == NULL && OD_find(od, OD_H1381_SRDO_1_MAPPING) == NULL
+           && OD_find(od, OD_H13FE_SRDO_VALID) == NULL && OD_find(od, OD_H13FF_SRDO_CHECKSUM) == NULL
+           && OD_find(od, SRDO_DATA_INDEX) == NULL;
+}
+
+/* master *********************************************************************/
+static uint8_t pattern(size_t pos) {
+    return (uint8_t)(pos * 131U + (pos >> 8) + 7U);
+}
+
+static size_t pattern_source(void *object, uint8_t *buf, size_t count) {
+    bench_master_t *m = object;
+    size_t n = m->big_size - m->pos;
+
+    if (n > count) {
+        n = count;
+    }
+    for (size_t i = 0; i < n; i++) {
+        buf[i] = pattern(m->pos + i);
+    }
+    m->pos += n;
+    return n;
+}
+
+static bool_t pattern_sink(void *object, const uint8_t *buf, size_t count) {
+    bench_master_t *m = object;
+
+    for (size_t i = 0; i < count; i++) {
+        if (buf[i] != pattern(m->pos + i)) {
+            m->mismatch = true;
+            return false;
+        }
+    }
+    m->pos += count;
+    return true;
+}
+
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+static bool_t prof_sink(void *object, const uint8_t *buf, size_t count) {
+    bench_master_t *m = object;
+    uint8_t section = m->prof_sub - 1U;
+
+    if (m->pos + count > CO_PROF_OD_SIZE) {
+        return false;
+    }
+    memcpy(&m->prof[section][m->pos], buf, count);
+    m->pos += count;
+    m->prof_received[section] = m->pos;
+    return true;
+}
+#endif
+
+static size_t expedited_source(void *object, uint8_t *buf, size_t count) {
+    bench_master_t *m = object;
+
+    if (m->pos > 0U || count < sizeof(uint32_t)) {
+        return 0;
+    }
+    CO_setUint32(buf, m->expedited_value);
+    m->pos = sizeof(uint32_t);
+    return sizeof(uint32_t);
+}
+
+// start next transfer of the current phase, return false if phase is finished
+static bool_t master_start(bench_master_t *m, CO_SDOclient_t *SDO_C) {
+    CO_SDO_return_t ret;
+    sdo_result_t *r = &m->result[m->phase];
+
+    m->pos = 0;
+    m->mismatch = false;
+    switch (m->phase) {
+        case SDO_EXPEDITED:
+            if (r->transfers + r->errors >= m->expedited_count) {
+                return false;
+            }
+            m->expedited_value++;
+            ret = CO_SDObulk_download(&m->bulk, SDO_C, EXPEDITED_INDEX, 0, sizeof(uint32_t), SDO_TIMEOUT_MS, false,
+                                      expedited_source, m);
+            break;
+        case SDO_SEG_DOWNLOAD:
+        case SDO_BLOCK_DOWNLOAD:
+            if (r->transfers + r->errors > 0U) {
+                return false;
+            }
+            ret = CO_SDObulk_download(&m->bulk, SDO_C, BIG_INDEX, 0, m->big_size, SDO_TIMEOUT_MS,
+                                      m->phase == SDO_BLOCK_DOWNLOAD, pattern_source, m);
+            break;
+        case SDO_SEG_UPLOAD:
+        case SDO_BLOCK_UPLOAD:
+            if (r->transfers + r->errors > 0U) {
+                return false;
+            }
+            ret = CO_SDObulk_upload(&m->bulk, SDO_C, BIG_INDEX, 0, SDO_TIMEOUT_MS, m->phase == SDO_BLOCK_UPLOAD,
+                                    pattern_sink, m);
+            break;
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+        case SDO_PROFILE:
+            if (m->prof_sub >= CO_PROF_COUNT || r->errors > 0U) {
+                return false;
+            }
+            m->prof_sub++;
+            ret = CO_SDObulk_upload(&m->bulk, SDO_C, PROF_INDEX, m->prof_sub, SDO_TIMEOUT_MS, false, prof_sink, m);
+            break;
+#endif
+        default: return false;
+    }
+    if (ret < 0) {
+        r->errors++;
+        return r->errors < 3U;
+    }
+    m->active = true;
+    m->transfer_start_us = time_us();
+    return true;
+}
+
+static void master_process(CO_network_t *network) {
+    bench_master_t *m = network->config.appObject;
+    CO_SDOclient_t *SDO_C = network->co->SDOclient;
+
+    if (m->phase == SDO_WAIT) {
+        if (!measuring) {
+            return;
+        }
+        if (CO_SDOclient_setup(SDO_C, CO_CAN_ID_SDO_CLI + m->server_node, CO_CAN_ID_SDO_SRV + m->server_node,
+                               m->server_node)
+            != CO_SDO_RT_ok_communicationEnd) {
+            m->result[SDO_EXPEDITED].errors++;
+            m->phase = SDO_DONE;
+            return;
+        }
+        m->phase = SDO_EXPEDITED;
+        m->phase_start_us = time_us();
+    }
+
+    while (m->phase != SDO_DONE) {
+        if (m->active) {
+            CO_SDO_return_t ret = CO_SDObulk_process(&m->bulk, network->ep.timeDifference_us, end_program != 0,
+                                                     &network->ep.timerNext_us);
+            if (ret > 0) {
+                return;
+            }
+            sdo_result_t *r = &m->result[m->phase];
+            uint64_t now = time_us();
+
+            m->active = false;
+            if (ret == CO_SDO_RT_ok_communicationEnd && !m->mismatch
+                && (m->phase == SDO_EXPEDITED || m->phase == SDO_PROFILE || m->bulk.sizeTransferred == m->big_size)) {
+                r->transfers++;
+                r->bytes += m->bulk.sizeTransferred;
+                if (m->phase == SDO_EXPEDITED) {
+                    uint64_t latency = now - m->transfer_start_us;
+                    hist_add(&m->expedited_latency, latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency);
+                }
+            } else {
+                r->errors++;
+                r->abort_code = (uint32_t)m->bulk.abortCode;
+            }
+            r->elapsed_us = now - m->phase_start_us;
+        }
+        if (end_program != 0 || !master_start(m, SDO_C)) {
+            m->phase = end_program != 0 ? SDO_DONE : (sdo_phase_t)(m->phase + 1);
+            m->phase_start_us = time_us();
+            continue;
+        }
+        // first segment is sent by CO_SDObulk_process() in the next pass
+        network->ep.timerNext_us = 0;
+        return;
+    }
+}
+
+/* output *********************************************************************/
+static void print_sdo(const sdo_result_t *r, bool_t last) {
+    double s = (double)r->elapsed_us / 1e6;
+
+    printf("    \"%s\": {\"transfers\": %llu, \"errors\": %llu, \"abort_code\": \"0x%08X\", \"bytes\": %llu, "
+           "\"elapsed_s\": %.6f, \"transfers_per_s\": %.1f, \"bytes_per_s\": %.1f}%s\n",
+           r->name, (unsigned long long)r->transfers, (unsigned long long)r->errors, r->abort_code,
+           (unsigned long long)r->bytes, s, s > 0 ? (double)r->transfers / s : 0.0,
+           s > 0 ? (double)r->bytes / s : 0.0, last ? "" : ",");
+}
+
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+// snapshot of the statistics of each network, taken before CO_network_stop() deletes CANopen objects
+static CO_prof_t profiles[MAX_SLAVES + 1];
+
+static void print_prof_section(CO_prof_section_t section, bool_t first, uint32_t count, uint32_t min_ns,
+                               uint32_t max_ns, uint32_t mean_ns, const uint32_t *hist) {
+    printf("%s\n        \"%s\": {\"count\": %u, \"min\": %u, \"mean\": %u, \"max\": %u, \"hist\": [",
+           first ? "" : ",", CO_prof_name(section), count, min_ns, mean_ns, max_ns);
+    for (uint8_t b = 0; b < CO_PROF_HIST_BINS; b++) {
+        printf("%s%u", b > 0U ? ", " : "", hist[b]);
+    }
+    printf("]}");
+}
+
+// sections, which were called
+static void print_prof(const CO_prof_t *prof) {
+    bool_t first = true;
+
+    for (uint8_t i = 0; i < CO_PROF_COUNT; i++) {
+        CO_profStats_t st;
+        uint32_t mean_ns;
+
+        CO_prof_get(prof, (CO_prof_section_t)i, &st, &mean_ns);
+        if (st.count > 0U) {
+            print_prof_section((CO_prof_section_t)i, first, st.count, st.min_ns, st.max_ns, mean_ns, st.hist);
+            first = false;
+        }
+    }
+    printf("\n      ");
+}
+
+// sections uploaded from the statistics record of the first slave, layout as in CO_prof_initOD()
+static void print_prof_remote(void) {
+    bool_t first = true;
+
+    for (uint8_t i = 0; i < CO_PROF_COUNT; i++) {
+        const uint8_t *b = master.prof[i];
+        uint32_t hist[CO_PROF_HIST_BINS];
+
+        if (master.prof_received[i] != CO_PROF_OD_SIZE || CO_getUint32(&b[0]) == 0U) {
+            continue;
+        }
+        for (uint8_t h = 0; h < CO_PROF_HIST_BINS; h++) {
+            hist[h] = CO_getUint32(&b[16U + 4U * h]);
+        }
+        print_prof_section((CO_prof_section_t)i, first, CO_getUint32(&b[0]), CO_getUint32(&b[4]),
+                           CO_getUint32(&b[8]), CO_getUint32(&b[12]), hist);
+        first = false;
+    }
+    printf("\n    ");
+}
+#endif
+
+static void print_result(const char *ifname, uint8_t slave_count, double elapsed_s, const uint64_t *loops,
+                         const CO_networkStatus_t *status, const CO_SRDO_state_t *srdo_state) {
+    static histogram_t rx_to_od, end_to_end, sync_jitter;
+    uint64_t rpdo_count = 0;
+    uint64_t loops_total = 0;
+    uint8_t count = slave_count + 1U;
+
+    for (uint8_t i = 0; i < slave_count; i++) {
+        hist_merge(&rx_to_od, &slaves[i].rx_to_od);
+        hist_merge(&end_to_end, &slaves[i].end_to_end);
+        hist_merge(&sync_jitter, &slaves[i].sync_jitter);
+        rpdo_count += slaves[i].rpdo_count;
+    }
+
+    printf("{\n");
+    printf("  \"interface\": \"%s\",\n  \"slaves\": %u,\n  \"sync_period_us\": %u,\n  \"duration_s\": %.3f,\n",
+           ifname, slave_count, sync_period_us, elapsed_s);
+    printf("  \"process\": {\n    \"networks\": [\n");
+    for (uint8_t i = 0; i < count; i++) {
+        loops_total += loops[i];
+        printf("      {\"node_id\": %u, \"state\": %d, \"cycles_per_s\": %.1f, \"loop_max_us\": %u, \"resets\": %u, "
+               "\"srdo_state\": %d}%s\n",
+               configs[i].nodeId, status[i].state, (double)loops[i] / elapsed_s, status[i].loopMax_us,
+               status[i].resetCount, srdo_state[i], i + 1U < count ? "," : "");
+    }
+    printf("    ],\n    \"cycles_per_s\": %.1f\n  },\n", (double)loops_total / elapsed_s);
+    printf("  \"pdo\": {\"received\": %llu, \"per_s\": %.1f, \"expected_per_s\": %.1f},\n",
+           (unsigned long long)rpdo_count, (double)rpdo_count / elapsed_s, slave_count * 1e6 / sync_period_us);
+    print_hist("rpdo_rx_to_od_us", &rx_to_od, "  ", false);
+    print_hist("pdo_end_to_end_us", &end_to_end, "  ", false);
+    print_hist("sync_jitter_us", &sync_jitter, "  ", false);
+    printf("  \"sdo\": {\n    \"server_node_id\": %u,\n    \"domain_bytes\": %zu,\n", master.server_node,
+           master.big_size);
+    for (uint8_t p = SDO_EXPEDITED; p < SDO_PROFILE; p++) {
+        print_sdo(&master.result[p], false);
+    }
+    print_hist("expedited_latency_us", &master.expedited_latency, "    ", true);
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+    printf("  },\n  \"profile_ns\": {\n    \"local\": [\n");
+    for (uint8_t i = 0; i < count; i++) {
+        printf("      {\"node_id\": %u, \"sections\": {", configs[i].nodeId);
+        print_prof(&profiles[i]);
+        printf("}}%s\n", i + 1U < count ? "," : "");
+    }
+    printf("    ],\n    \"remote\": {\"node_id\": %u, \"sections\": {", master.server_node);
+    print_prof_remote();
+    printf("}}\n");
+#endif
+    printf("  }\n}\n");
+}
+
+/* main ***********************************************************************/
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -i <interface>  CAN interface, default vcan0\n"
+            "  -n <slaves>     simulated slaves, 2..%d, default 4\n"
+            "  -t <seconds>    PDO and SYNC measurement time, default 10\n"
+            "  -s <us>         SYNC period, default 1000\n"
+            "  -b <bytes>      size of segmented and block SDO transfers, default 65536\n"
+            "  -e <count>      expedited SDO transfers, default 1000\n"
+            "  -p <priority>   SCHED_FIFO priority of the network threads, default normal scheduling\n",
+            prog, MAX_SLAVES);
+}
+
+int main(int argc, char *argv[]) {
+    const char *ifname = "vcan0";
+    unsigned long slave_count = 4;
+    unsigned long duration_s = 10;
+    unsigned long big_size = 65536;
+    unsigned long expedited_count = 1000;
+    long priority = 0;
+    int opt;
+    int ret = EXIT_SUCCESS;
+
+    while ((opt = getopt(argc, argv, "i:n:t:s:b:e:p:h")) != -1) {
+        switch (opt) {
+            case 'i': ifname = optarg; break;
+            case 'n': slave_count = strtoul(optarg, NULL, 0); break;
+            case 't': duration_s = strtoul(optarg, NULL, 0); break;
+            case 's': sync_period_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'b': big_size = strtoul(optarg, NULL, 0); break;
+            case 'e': expedited_count = strtoul(optarg, NULL, 0); break;
+            case 'p': priority = strtol(optarg, NULL, 0); break;
+            default: print_usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if (slave_count < 2 || slave_count > MAX_SLAVES || duration_s == 0 || sync_period_us < 100 || big_size <= 4
+        || big_size > 0x1000000 || priority < 0 || priority > 99) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+#if OD_HASH > 0
+    if (OD_initHash(OD, &OD_hash) != ODR_OK) {
+        fprintf(stderr, "Error: OD is not ordered by index or OD_hash.c does not match OD.c\n");
+        return EXIT_FAILURE;
+    }
+#endif
+
+    // master produces SYNC and transmits SRDO
+    uint8_t count = (uint8_t)slave_count + 1U;
+    if (!od_set_u32(OD, 0x1005, 0, 0x40000000U | CO_CAN_ID_SYNC) || !od_set_u32(OD, 0x1006, 0, sync_period_us)) {
+        fprintf(stderr, "Error: SYNC producer can't be configured\n");
+        return EXIT_FAILURE;
+    }
+    OD_entry_t master_entries[SRDO_ENTRIES];
+    OD_t *master_od = srdo_free(OD) ? od_insert(OD, master_entries, srdo_entries(&srdo[0], true, master_entries))
+                                    : NULL;
+    if (master_od == NULL) {
+        fprintf(stderr, "Error: SRDO producer can't be configured\n");
+        return EXIT_FAILURE;
+    }
+    master.server_node = MASTER_NODE_ID + 1;
+    master.big_size = big_size;
+    master.expedited_count = (uint32_t)expedited_count;
+    master.result[SDO_EXPEDITED].name = "expedited";
+    master.result[SDO_SEG_DOWNLOAD].name = "segmented_download";
+    master.result[SDO_SEG_UPLOAD].name = "segmented_upload";
+    master.result[SDO_BLOCK_DOWNLOAD].name = "block_download";
+    master.result[SDO_BLOCK_UPLOAD].name = "block_upload";
+    configs[0] = (CO_networkConfig_t){.ifName = ifname, .nodeId = MASTER_NODE_ID, .od = master_od, .cpu = -1,
+                                      .priority = (int)priority, .interval_us = NETWORK_INTERVAL,
+                                      .appProcess = master_process, .appObject = &master};
+
+    CO_network_ODregion_t regions[] = {{.addr = &OD_erob_RAM, .len = sizeof(OD_erob_RAM)},
+                                       {.addr = &OD_erob_PERSIST_COMM, .len = sizeof(OD_erob_PERSIST_COMM)}};
+    for (uint8_t i = 0; i < slave_count; i++) {
+        bench_slave_t *s = &slaves[i];
+        uint8_t node = MASTER_NODE_ID + 1U + i;
+        uint8_t producer = i == 0U ? MASTER_NODE_ID + (uint8_t)slave_count : node - 1U;
+
+        s->network = &networks[i + 1U];
+        s->od_clone = CO_network_cloneOD(OD_erob, regions, sizeof(regions) / sizeof(regions[0]));
+        s->od = NULL;
+        if (s->od_clone != NULL && srdo_free(s->od_clone)
+            && (i > 0U || (OD_find(s->od_clone, BIG_INDEX) == NULL && OD_find(s->od_clone, PROF_INDEX) == NULL))) {
+            // SRDO receiver, first slave also has the large domain and the statistics record
+            OD_entry_t entries[SRDO_ENTRIES + 2];
+            uint16_t entry_count = srdo_entries(&srdo[i + 1U], false, entries);
+            bool_t ok = true;
+
+            if (i == 0U) {
+                s->big = (OD_obj_var_t){.dataOrig = calloc(1, big_size), .attribute = ODA_SDO_RW,
+                                        .dataLength = (OD_size_t)big_size};
+                ok = s->big.dataOrig != NULL;
+                entries[entry_count++] = (OD_entry_t){.index = BIG_INDEX, .subEntriesCount = 1,
+                                                      .odObjectType = ODT_VAR, .odObject = &s->big};
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+                // sub-index 0 is writable, 0 clears the statistics
+                s->prof[0] = (OD_obj_record_t){.subIndex = 0, .attribute = ODA_SDO_RW, .dataLength = 1};
+                for (uint8_t sub = 1; sub <= CO_PROF_COUNT; sub++) {
+                    s->prof[sub] = (OD_obj_record_t){.subIndex = sub, .attribute = ODA_SDO_R,
+                                                     .dataLength = CO_PROF_OD_SIZE};
+                }
+                entries[entry_count++] = (OD_entry_t){.index = PROF_INDEX, .subEntriesCount = CO_PROF_COUNT + 1,
+                                                      .odObjectType = ODT_REC, .odObject = s->prof};
+#endif
+            }
+            s->od = ok ? od_insert(s->od_clone, entries, entry_count) : NULL;
+        }
+        if (s->od == NULL || !slave_configure(s, producer)) {
+            fprintf(stderr, "Error: Object Dictionary of slave %u can't be prepared\n", node);
+            return EXIT_FAILURE;
+        }
+        configs[i + 1U] = (CO_networkConfig_t){.ifName = ifname, .nodeId = node, .od = s->od, .cpu = -1,
+                                               .priority = (int)priority, .interval_us = NETWORK_INTERVAL,
+                                               .appInit = slave_init, .appObject = s};
+    }
+
+    signal(SIGINT, sig_handler);
+    signal(SIGTERM, sig_handler);
+
+    CO_ReturnError_t err = CO_network_start(networks, configs, count);
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "Error: Networks start failed on %s: %d\n", ifname, err);
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "# %u nodes on %s, warm-up %d s, measurement %lu s\n", count, ifname, WARMUP_S, duration_s);
+    sleep(WARMUP_S);
+
+    CO_networkStatus_t status[MAX_SLAVES + 1];
+    uint64_t loops[MAX_SLAVES + 1];
+    for (uint8_t i = 0; i < count; i++) {
+        CO_network_getStatus(&networks[i], &status[i]);
+        loops[i] = status[i].loopCount;
+    }
+    measuring = true;
+    uint64_t start_us = time_us();
+
+    // PDOs and SYNC are measured for duration_s, SDO transfers may take longer
+    uint64_t pdo_end_us = start_us + duration_s * 1000000U;
+    uint64_t end_us = 0;
+    while (end_program == 0) {
+        struct timespec ts = {0, 10000000};
+        uint64_t now = time_us();
+        bool_t running = true;
+
+        nanosleep(&ts, NULL);
+        for (uint8_t i = 0; i < count; i++) {
+            CO_network_getStatus(&networks[i], &status[i]);
+            running = running && status[i].state == CO_NETWORK_RUNNING;
+        }
+        if (!running) {
+            fprintf(stderr, "Error: network thread stopped\n");
+            ret = EXIT_FAILURE;
+            break;
+        }
+        if (end_us == 0U && now >= pdo_end_us) {
+            end_us = now;
+            for (uint8_t i = 0; i < count; i++) {
+                loops[i] = status[i].loopCount - loops[i];
+            }
+            measuring = false;
+        }
+        if (end_us != 0U && (master.phase == SDO_DONE || now >= pdo_end_us + SDO_EXTRA_TIME_S * 1000000U)) {
+            break;
+        }
+    }
+    if (end_us == 0U) {
+        end_us = time_us();
+        for (uint8_t i = 0; i < count; i++) {
+            loops[i] = status[i].loopCount - loops[i];
+        }
+    }
+    measuring = false;
+
+    // threads are still running, values are informative
+    CO_SRDO_state_t srdo_state[MAX_SLAVES + 1];
+    for (uint8_t i = 0; i < count; i++) {
+        srdo_state[i] = __atomic_load_n(&networks[i].ep.SRDOstate, __ATOMIC_RELAXED);
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+        profiles[i] = *networks[i].co->prof;
+#endif
+    }
+    CO_network_stop(networks, count);
+    print_result(ifname, (uint8_t)slave_count, (double)(end_us - start_us) / 1e6, loops, status, srdo_state);
+
+    for (uint8_t i = 0; i < slave_count; i++) {
+        if (slaves[i].od != slaves[i].od_clone) {
+            free(slaves[i].od->list);
+            free(slaves[i].od);
+        }
+        free(slaves[i].big.dataOrig);
+        CO_network_deleteOD(slaves[i].od_clone);
+    }
+    free(master_od->list);
+    free(master_od);
+    return ret;
+}
@@ -0,0 +1,154 @@
+/*
+ * author: ZeroErr Inc.
+ * CiA402 drive state machine, see cia402.h
+ */
+
+#include <string.h>
+
+#include "cia402.h"
+
+cia402_state_t cia402_state(uint16_t statusword) {
+    if ((statusword & 0x004F) == 0x0000) return CIA402_NOT_READY_TO_SWITCH_ON;
+    if ((statusword & 0x004F) == 0x0040) return CIA402_SWITCH_ON_DISABLED;
+    if ((statusword & 0x006F) == 0x0021) return CIA402_READY_TO_SWITCH_ON;
+    if ((statusword & 0x006F) == 0x0023) return CIA402_SWITCHED_ON;
+    if ((statusword & 0x006F) == 0x0027) return CIA402_OPERATION_ENABLED;
+    if ((statusword & 0x006F) == 0x0007) return CIA402_QUICK_STOP_ACTIVE;
+    if ((statusword & 0x004F) == 0x000F) return CIA402_FAULT_REACTION_ACTIVE;
+    if ((statusword & 0x004F) == 0x0008) return CIA402_FAULT;
+    return CIA402_UNKNOWN;
+}
+
+const char *cia402_state_name(cia402_state_t state) {
+    switch (state) {
+        case CIA402_NOT_READY_TO_SWITCH_ON: return "Not ready to switch on";
+        case CIA402_SWITCH_ON_DISABLED: return "Switch on disabled";
+        case CIA402_READY_TO_SWITCH_ON: return "Ready to switch on";
+        case CIA402_SWITCHED_ON: return "Switched on";
+        case CIA402_OPERATION_ENABLED: return "Operation enabled";
+        case CIA402_QUICK_STOP_ACTIVE: return "Quick stop active";
+        case CIA402_FAULT_REACTION_ACTIVE: return "Fault reaction active";
+        case CIA402_FAULT: return "Fault";
+        default: return "Unknown";
+    }
+}
+
+void cia402_init(cia402_axis_t *axis, uint8_t node_id, uint32_t timeout_ms) {
+    memset(axis, 0, sizeof(*axis));
+    axis->node_id = node_id;
+    axis->status = CIA402_SM_IDLE;
+    axis->state = CIA402_UNKNOWN;
+    axis->timeout_us = (timeout_ms > 0 ? timeout_ms : CIA402_TRANSITION_TIMEOUT_MS) * 1000U;
+    axis->failed_state = CIA402_UNKNOWN;
+}
+
+/* Controlword for the next transition from the observed state. Return 1, if it changed. */
+static int cia402_step(cia402_axis_t *axis, uint64_t now_us) {
+    uint16_t cw = axis->controlword;
+
+    if (!axis->statusword_valid) {
+        return 0;
+    }
+    if (axis->status == CIA402_SM_ENABLING) {
+        switch (axis->state) {
+            case CIA402_FAULT:
+                // rising edge of bit 7; after a failed attempt cia402_process() clears it first
+                cw = CIA402_CW_FAULT_RESET;
+                break;
+            case CIA402_SWITCH_ON_DISABLED: cw = CIA402_CW_SHUTDOWN; break;
+            case CIA402_READY_TO_SWITCH_ON: cw = CIA402_CW_SWITCH_ON; break;
+            case CIA402_SWITCHED_ON: cw = CIA402_CW_ENABLE_OPERATION; break;
+            case CIA402_QUICK_STOP_ACTIVE: cw = CIA402_CW_DISABLE_VOLTAGE; break;
+            case CIA402_OPERATION_ENABLED:
+                cw = CIA402_CW_ENABLE_OPERATION;
+                axis->status = CIA402_SM_ENABLED;
+                axis->done_us = now_us;
+                break;
+            default: break;  // transition of the drive itself, wait
+        }
+    } else if (axis->status == CIA402_SM_DISABLING) {
+        switch (axis->state) {
+            case CIA402_FAULT:
+            case CIA402_SWITCH_ON_DISABLED:
+            case CIA402_READY_TO_SWITCH_ON:
+                axis->status = CIA402_SM_IDLE;
+                axis->done_us = now_us;
+                break;
+            case CIA402_SWITCHED_ON:
+            case CIA402_OPERATION_ENABLED:
+            case CIA402_QUICK_STOP_ACTIVE: cw = CIA402_CW_SHUTDOWN; break;
+            default: break;
+        }
+    }
+
+    if (cw != axis->controlword) {
+        axis->controlword = cw;
+        return 1;
+    }
+    return 0;
+}
+
+static int cia402_request(cia402_axis_t *axis, cia402_sm_status_t status, uint64_t now_us) {
+    axis->status = status;
+    axis->start_us = now_us;
+    axis->transition_us = now_us;
+    axis->done_us = 0;
+    axis->fault_resets = 0;
+    axis->failed_state = CIA402_UNKNOWN;
+    // fault reset needs a rising edge of bit 7: if it is already set, clear it first, next statusword sets it again
+    if (axis->state == CIA402_FAULT && status == CIA402_SM_ENABLING && (axis->controlword & CIA402_CW_FAULT_RESET)) {
+        axis->controlword &= (uint16_t)~CIA402_CW_FAULT_RESET;
+        return 1;
+    }
+    return cia402_step(axis, now_us);
+}
+
+int cia402_enable(cia402_axis_t *axis, uint64_t now_us) {
+    return cia402_request(axis, CIA402_SM_ENABLING, now_us);
+}
+
+int cia402_disable(cia402_axis_t *axis, uint64_t now_us) {
+    return cia402_request(axis, CIA402_SM_DISABLING, now_us);
+}
+
+int cia402_update(cia402_axis_t *axis, uint16_t statusword, uint64_t now_us) {
+    cia402_state_t state = cia402_state(statusword);
+
+    if (!axis->statusword_valid || state != axis->state) {
+        axis->transition_us = now_us;
+    }
+    axis->statusword = statusword;
+    axis->statusword_valid = 1;
+    axis->state = state;
+
+    // drive left operation enabled by itself, for example on fault
+    if (axis->status == CIA402_SM_ENABLED && state != CIA402_OPERATION_ENABLED) {
+        axis->status = CIA402_SM_IDLE;
+    }
+    return cia402_step(axis, now_us);
+}
+
+int cia402_process(cia402_axis_t *axis, uint64_t now_us) {
+    if (axis->status != CIA402_SM_ENABLING && axis->status != CIA402_SM_DISABLING) {
+        return 0;
+    }
+    if (now_us - axis->transition_us < axis->timeout_us) {
+        return 0;
+    }
+    if (axis->status == CIA402_SM_ENABLING && axis->state == CIA402_FAULT
+        && axis->fault_resets < CIA402_FAULT_RESETS) {
+        // fault is still present, clear bit 7, next statusword sets it again
+        axis->fault_resets++;
+        axis->transition_us = now_us;
+        axis->controlword &= (uint16_t)~CIA402_CW_FAULT_RESET;
+        return 1;
+    }
+    axis->failed_state = axis->state;
+    axis->status = CIA402_SM_FAILED;
+    axis->done_us = now_us;
+    return 0;
+}
+
+int cia402_done(const cia402_axis_t *axis) {
+    return axis->status == CIA402_SM_ENABLED || axis->status == CIA402_SM_IDLE || axis->status == CIA402_SM_FAILED;
+}
@@ -0,0 +1,92 @@
+/*
+ * author: ZeroErr Inc.
+ * CiA402 drive state machine, driven by the observed statusword
+ *
+ * Each axis has its own cia402_axis_t. Application passes every received statusword (from TPDO, or from SDO polling
+ * of 0x6041) to cia402_update(), which selects the controlword for the next transition as soon as the drive reaches
+ * the previous state. There are no fixed delays: the sequence is as fast as the drive. If the drive does not change
+ * its state within the transition timeout, the axis fails with the state, where it stopped. A fault is reset with a
+ * rising edge of controlword bit 7; if it does not clear within the timeout, reset is repeated a few times.
+ *
+ * Controlword is sent by the application (RPDO or SDO), so many axes can be enabled in parallel: call
+ * cia402_update() for each axis and send the controlwords of all axes, which changed.
+ */
+
+#ifndef CIA402_H
+#define CIA402_H
+
+#include <stdint.h>
+
+// CiA402 controlword commands
+#define CIA402_CW_DISABLE_VOLTAGE 0x0000
+#define CIA402_CW_SHUTDOWN 0x0006
+#define CIA402_CW_SWITCH_ON 0x0007
+#define CIA402_CW_ENABLE_OPERATION 0x000F
+#define CIA402_CW_FAULT_RESET 0x0080
+
+#define CIA402_TRANSITION_TIMEOUT_MS 500  // Default timeout for one state transition
+#define CIA402_FAULT_RESETS 3             // Number of fault reset attempts
+
+// Drive state, from statusword
+typedef enum {
+    CIA402_NOT_READY_TO_SWITCH_ON,
+    CIA402_SWITCH_ON_DISABLED,
+    CIA402_READY_TO_SWITCH_ON,
+    CIA402_SWITCHED_ON,
+    CIA402_OPERATION_ENABLED,
+    CIA402_QUICK_STOP_ACTIVE,
+    CIA402_FAULT_REACTION_ACTIVE,
+    CIA402_FAULT,
+    CIA402_UNKNOWN
+} cia402_state_t;
+
+// Progress of the requested sequence
+typedef enum {
+    CIA402_SM_IDLE,        // no request, controlword is not changed
+    CIA402_SM_ENABLING,    // going to operation enabled
+    CIA402_SM_ENABLED,     // drive is in operation enabled
+    CIA402_SM_DISABLING,   // going to ready to switch on
+    CIA402_SM_FAILED       // transition timeout, see failed_state
+} cia402_sm_status_t;
+
+typedef struct {
+    uint8_t node_id;
+    cia402_sm_status_t status;
+    cia402_state_t state;          // Last observed state
+    uint16_t statusword;           // Last observed statusword
+    int statusword_valid;          // At least one statusword was observed
+    uint16_t controlword;          // Controlword, which must be sent to the drive
+    uint32_t timeout_us;           // Transition timeout
+    uint64_t start_us;             // Time of cia402_enable() or cia402_disable()
+    uint64_t transition_us;        // Time of the last state change or request
+    uint64_t done_us;              // Time, when the sequence finished
+    uint8_t fault_resets;          // Fault reset attempts in this sequence
+    cia402_state_t failed_state;   // State, in which transition timed out
+} cia402_axis_t;
+
+/* Initialize axis, timeout_ms is the transition timeout (0 for default) */
+void cia402_init(cia402_axis_t *axis, uint8_t node_id, uint32_t timeout_ms);
+
+/* Request operation enabled. Return 1, if controlword must be sent. Without known statusword the first controlword
+ * is selected by cia402_update(). */
+int cia402_enable(cia402_axis_t *axis, uint64_t now_us);
+
+/* Request ready to switch on (shutdown). Return 1, if controlword must be sent. */
+int cia402_disable(cia402_axis_t *axis, uint64_t now_us);
+
+/* Statusword was received. Advance the sequence and return 1, if controlword changed and must be sent. */
+int cia402_update(cia402_axis_t *axis, uint16_t statusword, uint64_t now_us);
+
+/* Check transition timeout, called cyclically also without new statusword. Return 1, if controlword changed. */
+int cia402_process(cia402_axis_t *axis, uint64_t now_us);
+
+/* Return nonzero, if the requested sequence is finished: enabled, idle after disable, or failed */
+int cia402_done(const cia402_axis_t *axis);
+
+/* State from statusword */
+cia402_state_t cia402_state(uint16_t statusword);
+
+/* Name of the state, for printing */
+const char *cia402_state_name(cia402_state_t state);
+
+#endif // CIA402_H
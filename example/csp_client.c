@@ -0,0 +1,793 @@
+/*
+ * CANopen Cyclic Synchronous Position (CSP) client for Linux socketCAN.
+ *
+ * Program runs CANopenNode as the SYNC producer and streams interpolated target positions to one CiA402 drive
+ * (eRob). Drive is configured with SDO and put into mode 8, then each SYNC cycle:
+ * - SYNC is produced by CO_process_SYNC() with period from 0x1006, or with option -r by a separate SCHED_FIFO thread
+ *   with absolute deadlines, see CO_syncProducer.h,
+ * - statusword, position actual value and following error, received from drive TPDOs, are copied into the Object
+ *   Dictionary by CO_process_RPDO(),
+ * - SYNC callback runs the CiA402 enable sequence, takes the next precomputed setpoint from the trajectory player
+ *   and writes controlword and target position into the Object Dictionary,
+ * - synchronous TPDO with controlword and target position is sent by CO_process_TPDO(). Drive applies it on the next
+ *   SYNC.
+ *
+ * Path through the targets is a sequence of jerk-limited S-curve moves. Setpoints of each move are computed in the
+ * mainline into one of two buffers, while the SYNC callback plays the other one, see trajectory.h.
+ *
+ * Generated example Object Dictionary has no application objects, so objects 0x2000..0x2005 are appended to it at
+ * startup, see cspOD_init(). Object 0x2005 contains statistics of the SYNC producer thread.
+ *
+ * @file        csp_client.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <net/if.h>
+
+/* Application objects are defined here, like in OD.c */
+#define OD_DEFINITION
+#include "CANopen.h"
+#include "OD.h"
+#include "CO_epoll_interface.h"
+#include "CO_syncProducer.h"
+#include "trajectory.h"
+
+#define log_printf(macropar_message, ...) printf(macropar_message, ##__VA_ARGS__)
+
+/* CANopen parameters of this node */
+#define NMT_CONTROL          CO_NMT_STARTUP_TO_OPERATIONAL
+#define FIRST_HB_TIME        500
+#define SDO_SRV_TIMEOUT_TIME 1000
+#define SDO_CLI_TIMEOUT_TIME 500
+#define SDO_CLI_BLOCK        false
+#define OD_STATUS_BITS       NULL
+
+/* Maximum interval between two wakeups, if no CANopen timer is running */
+#define MAIN_THREAD_INTERVAL_US 100000
+
+/* Limits of the SYNC period */
+#define CSP_PERIOD_MIN_US 250
+#define CSP_PERIOD_MAX_US 4000
+
+/* Maximum number of targets from the command line */
+#define CSP_TARGETS_MAX 16
+
+/* Number of SYNC cycles with "shutdown" controlword before the drive is set to NMT pre-operational on exit */
+#define CSP_SHUTDOWN_CYCLES 20
+
+/* Motor resolution, counts per revolution */
+#define MOTOR_RESOLUTION 524288
+
+/* Application objects, mapped into PDOs of this node */
+#define CSP_OD_CONTROLWORD  0x2000U /* Controlword for the drive, TPDO1 */
+#define CSP_OD_TARGET       0x2001U /* Target position for the drive, TPDO1 */
+#define CSP_OD_STATUSWORD   0x2002U /* Statusword from the drive, RPDO2 */
+#define CSP_OD_POSITION     0x2003U /* Position actual value from the drive, RPDO1 */
+#define CSP_OD_FOLLOWING    0x2004U /* Following error actual value from the drive, RPDO1 */
+#define CSP_OD_ENTRIES      5U
+#define CSP_OD_SYNC_STATS   0x2005U /* Statistics of the SYNC producer thread, see CO_syncProducer_initOD() */
+
+/* CiA402 objects of the drive */
+#define CIA402_CONTROLWORD     0x6040U
+#define CIA402_STATUSWORD      0x6041U
+#define CIA402_MODES           0x6060U
+#define CIA402_POSITION_ACTUAL 0x6064U
+#define CIA402_TARGET_POSITION 0x607AU
+#define CIA402_INTERPOL_PERIOD 0x60C2U
+#define CIA402_FOLLOWING_ERROR 0x60F4U
+#define CIA402_MODE_CSP        8
+
+/* CiA402 controlword commands */
+#define CW_SHUTDOWN         0x0006U
+#define CW_SWITCH_ON        0x0007U
+#define CW_ENABLE_OPERATION 0x000FU
+#define CW_FAULT_RESET      0x0080U
+
+/* PDO mapping entry: index, subIndex and length in bits */
+#define PDO_MAP(index, subIndex, bits) (((uint32_t)(index) << 16) | ((uint32_t)(subIndex) << 8) | (uint32_t)(bits))
+#define PDO_COB_ID_INVALID             0x80000000UL
+
+/* Application variables, mapped into PDOs */
+static uint16_t cspControlword;
+static int32_t cspTarget;
+static uint16_t cspStatusword;
+static int32_t cspPosition;
+static int32_t cspFollowing;
+
+/* Application objects, appended to the Object Dictionary */
+static OD_obj_var_t cspODobjs[CSP_OD_ENTRIES] = {
+    {.dataOrig = &cspControlword, .attribute = ODA_SDO_RW | ODA_TPDO | ODA_MB, .dataLength = 2},
+    {.dataOrig = &cspTarget, .attribute = ODA_SDO_RW | ODA_TPDO | ODA_MB, .dataLength = 4},
+    {.dataOrig = &cspStatusword, .attribute = ODA_SDO_RW | ODA_RPDO | ODA_MB, .dataLength = 2},
+    {.dataOrig = &cspPosition, .attribute = ODA_SDO_RW | ODA_RPDO | ODA_MB, .dataLength = 4},
+    {.dataOrig = &cspFollowing, .attribute = ODA_SDO_RW | ODA_RPDO | ODA_MB, .dataLength = 4},
+};
+static uint8_t cspSyncStatsCount = 7;
+static uint32_t cspSyncStats[7];
+static OD_obj_array_t cspODsyncStats = {.dataOrig0 = &cspSyncStatsCount,
+                                        .dataOrig = cspSyncStats,
+                                        .attribute0 = ODA_SDO_R,
+                                        .attribute = ODA_SDO_RW | ODA_MB,
+                                        .dataElementLength = 4,
+                                        .dataElementSizeof = sizeof(uint32_t)};
+static OD_t cspOD;
+#if OD_HASH > 0
+/* OD is assembled at run time, so its hash index is calculated at run time too */
+static OD_hash_t cspODhash;
+static uint16_t cspODhashTable[1024];
+#endif
+
+/* State of the drive configuration in the mainline */
+typedef enum {
+    CSP_CFG_START,    /* send NMT pre-operational to the drive */
+    CSP_CFG_SDO,      /* SDO downloads from cspClient_t.sdo[] */
+    CSP_CFG_RUNNING,  /* drive is operational, setpoints are streamed */
+    CSP_CFG_STOPPING, /* shutdown controlword is sent, see CSP_SHUTDOWN_CYCLES */
+    CSP_CFG_FINISHED, /* drive is pre-operational, program may exit */
+    CSP_CFG_ERROR     /* SDO configuration failed */
+} cspCfgState_t;
+
+/* One SDO download to the drive */
+typedef struct {
+    uint16_t index;
+    uint8_t subIndex;
+    uint8_t size;
+    uint32_t value;
+    bool_t optional; /* abort of this download is not an error */
+} cspSdo_t;
+
+/* Object for the CSP client */
+typedef struct {
+    /* parameters */
+    uint8_t driveId;
+    uint32_t period_us;
+    trajParams_t params; /* velocity, acceleration and jerk limit of the path */
+    uint32_t dwell_us;
+    int syncPriority; /* priority of the SYNC producer thread, -1 if SYNC is produced by CO_process_SYNC() */
+    int32_t targets[CSP_TARGETS_MAX];
+    uint8_t targetCount;
+    /* drive configuration */
+    cspCfgState_t cfgState;
+    cspSdo_t sdo[48];
+    uint8_t sdoCount;
+    uint8_t sdoIndex;
+    bool_t sdoInProgress;
+    CO_SDO_abortCode_t abortCode;
+    bool_t stopRequest;
+    uint16_t stopCycles;
+    /* trajectory, planned in the mainline and played from the SYNC callback */
+    trajPlayer_t traj;
+    bool_t enabled;
+    bool_t done;          /* all targets reached */
+    /* statistics, reset each second by the mainline */
+    struct timespec lastSync;
+    uint32_t syncCount;
+    uint32_t intervalMin_us;
+    uint32_t intervalMax_us;
+    uint32_t jitterMax_us;
+    int32_t followingMax;
+} cspClient_t;
+
+static volatile sig_atomic_t CO_endProgram = 0;
+
+static void
+sigHandler(int sig) {
+    (void)sig;
+    CO_endProgram = 1;
+}
+
+static void
+printUsage(char* progName) {
+    printf("Usage: %s [options] <CAN device name>\n", progName);
+    printf("\n"
+           "Cyclic Synchronous Position client: produces SYNC, configures drive PDOs and streams interpolated target\n"
+           "positions to the drive at SYNC rate.\n"
+           "\n"
+           "Options:\n"
+           "  -n <Node ID>        Node ID of the drive (1..127), default is 2.\n"
+           "  -i <Node ID>        Node ID of this node (1..127), default is 1.\n"
+           "  -p <period us>      SYNC period in microseconds (%d..%d), default is 1000.\n"
+           "  -t <position>       Target position in counts, may be repeated up to %d times. Targets are reached one\n"
+           "                      after another. Without targets drive holds its position until Ctrl+C.\n"
+           "  -v <velocity>       Maximum velocity in counts/s, default is %d.\n"
+           "  -a <acceleration>   Acceleration in counts/s^2, default is %d.\n"
+           "  -j <jerk>           Jerk in counts/s^3, default is %d.\n"
+           "  -d <dwell ms>       Pause after each target, default is 500.\n"
+           "  -r <priority>       Produce SYNC from a separate thread with absolute deadlines and SCHED_FIFO\n"
+           "                      priority (1..99, 0 for default scheduling). Default is SYNC from the mainline.\n"
+           "\n"
+           "Example: %s -n 2 -p 1000 -t 524288 -t 0 can0\n"
+           "\n",
+           CSP_PERIOD_MIN_US, CSP_PERIOD_MAX_US, CSP_TARGETS_MAX, MOTOR_RESOLUTION / 10, MOTOR_RESOLUTION, MOTOR_RESOLUTION * 10,
+           progName);
+}
+
+/* Append application objects to the generated Object Dictionary. Entries of the generated OD keep their positions,
+ * so OD_ENTRY_Hxxxx macros, used by CANopen.c, stay valid. Return false if out of memory or OD is not ordered. */
+static bool_t
+cspOD_init(void) {
+    OD_entry_t* list = calloc((size_t)OD->size + CSP_OD_ENTRIES + 2U, sizeof(OD_entry_t));
+    uint16_t i;
+
+    if (list == NULL) {
+        return false;
+    }
+    memcpy(list, OD->list, (size_t)OD->size * sizeof(OD_entry_t));
+    for (i = 0; i < CSP_OD_ENTRIES; i++) {
+        OD_entry_t* entry = &list[OD->size + i];
+
+        entry->index = (uint16_t)(CSP_OD_CONTROLWORD + i);
+        entry->subEntriesCount = 1;
+        entry->odObjectType = ODT_VAR;
+        entry->odObject = &cspODobjs[i];
+    }
+    list[OD->size + CSP_OD_ENTRIES].index = CSP_OD_SYNC_STATS;
+    list[OD->size + CSP_OD_ENTRIES].subEntriesCount = 8;
+    list[OD->size + CSP_OD_ENTRIES].odObjectType = ODT_ARR;
+    list[OD->size + CSP_OD_ENTRIES].odObject = &cspODsyncStats;
+    /* last entry is blank, from calloc */
+    cspOD.size = (uint16_t)(OD->size + CSP_OD_ENTRIES + 1U);
+    cspOD.list = list;
+#if OD_HASH > 0
+    if ((OD_hashBuild(&cspOD, &cspODhash, cspODhashTable, sizeof(cspODhashTable) / sizeof(cspODhashTable[0])) != ODR_OK)
+        || (OD_initHash(&cspOD, &cspODhash) != ODR_OK)) {
+        free(list);
+        return false;
+    }
+#endif
+    OD = &cspOD;
+    return true;
+}
+
+/* PDOs of this node: TPDO1 -> drive RPDO1, drive TPDO1 -> RPDO1, drive TPDO2 -> RPDO2. Other PDOs are disabled. */
+static void
+cspOD_configurePDO(const cspClient_t* csp) {
+    uint8_t id = csp->driveId;
+
+    OD_PERSIST_COMM.x1005_COB_ID_SYNCMessage = 0x40000000UL | CO_CAN_ID_SYNC; /* SYNC producer */
+    OD_PERSIST_COMM.x1006_communicationCyclePeriod = csp->period_us;
+    OD_PERSIST_COMM.x1007_synchronousWindowLength = 0;
+    OD_PERSIST_COMM.x1019_synchronousCounterOverflowValue = 0;
+
+    OD_PERSIST_COMM.x1800_TPDOCommunicationParameter.COB_IDUsedByTPDO = CO_CAN_ID_RPDO_1 + id;
+    OD_PERSIST_COMM.x1800_TPDOCommunicationParameter.transmissionType = 1;
+    OD_PERSIST_COMM.x1800_TPDOCommunicationParameter.inhibitTime = 0;
+    OD_PERSIST_COMM.x1800_TPDOCommunicationParameter.eventTimer = 0;
+    OD_PERSIST_COMM.x1800_TPDOCommunicationParameter.SYNCStartValue = 0;
+    OD_PERSIST_COMM.x1A00_TPDOMappingParameter.numberOfMappedApplicationObjectsInPDO = 2;
+    OD_PERSIST_COMM.x1A00_TPDOMappingParameter.applicationObject1 = PDO_MAP(CSP_OD_CONTROLWORD, 0, 16);
+    OD_PERSIST_COMM.x1A00_TPDOMappingParameter.applicationObject2 = PDO_MAP(CSP_OD_TARGET, 0, 32);
+
+    OD_PERSIST_COMM.x1400_RPDOCommunicationParameter.COB_IDUsedByRPDO = CO_CAN_ID_TPDO_1 + id;
+    OD_PERSIST_COMM.x1400_RPDOCommunicationParameter.transmissionType = CO_PDO_TRANSM_TYPE_SYNC_EVENT_LO;
+    OD_PERSIST_COMM.x1400_RPDOCommunicationParameter.eventTimer = 0;
+    OD_PERSIST_COMM.x1600_RPDOMappingParameter.numberOfMappedApplicationObjectsInPDO = 2;
+    OD_PERSIST_COMM.x1600_RPDOMappingParameter.applicationObject1 = PDO_MAP(CSP_OD_POSITION, 0, 32);
+    OD_PERSIST_COMM.x1600_RPDOMappingParameter.applicationObject2 = PDO_MAP(CSP_OD_FOLLOWING, 0, 32);
+
+    OD_PERSIST_COMM.x1401_RPDOCommunicationParameter.COB_IDUsedByRPDO = CO_CAN_ID_TPDO_2 + id;
+    OD_PERSIST_COMM.x1401_RPDOCommunicationParameter.transmissionType = CO_PDO_TRANSM_TYPE_SYNC_EVENT_LO;
+    OD_PERSIST_COMM.x1401_RPDOCommunicationParameter.eventTimer = 0;
+    OD_PERSIST_COMM.x1601_RPDOMappingParameter.numberOfMappedApplicationObjectsInPDO = 1;
+    OD_PERSIST_COMM.x1601_RPDOMappingParameter.applicationObject1 = PDO_MAP(CSP_OD_STATUSWORD, 0, 16);
+
+    OD_PERSIST_COMM.x1402_RPDOCommunicationParameter.COB_IDUsedByRPDO |= PDO_COB_ID_INVALID;
+    OD_PERSIST_COMM.x1403_RPDOCommunicationParameter.COB_IDUsedByRPDO |= PDO_COB_ID_INVALID;
+    OD_PERSIST_COMM.x1801_TPDOCommunicationParameter.COB_IDUsedByTPDO |= PDO_COB_ID_INVALID;
+    OD_PERSIST_COMM.x1802_TPDOCommunicationParameter.COB_IDUsedByTPDO |= PDO_COB_ID_INVALID;
+    OD_PERSIST_COMM.x1803_TPDOCommunicationParameter.COB_IDUsedByTPDO |= PDO_COB_ID_INVALID;
+}
+
+static void
+cspSdo_add(cspClient_t* csp, uint16_t index, uint8_t subIndex, uint8_t size, uint32_t value, bool_t optional) {
+    if (csp->sdoCount < (sizeof(csp->sdo) / sizeof(csp->sdo[0]))) {
+        cspSdo_t* sdo = &csp->sdo[csp->sdoCount++];
+
+        sdo->index = index;
+        sdo->subIndex = subIndex;
+        sdo->size = size;
+        sdo->value = value;
+        sdo->optional = optional;
+    }
+}
+
+/* Add SDO downloads for one drive PDO: disable it, write mapping, transmission type and enable it again. */
+static void
+cspSdo_addPDO(cspClient_t* csp, uint16_t commIndex, uint32_t cobId, const uint32_t* map, uint8_t mapCount) {
+    uint16_t mapIndex = (uint16_t)(commIndex + 0x200U);
+    uint8_t i;
+
+    cspSdo_add(csp, commIndex, 1, 4, cobId | PDO_COB_ID_INVALID, false);
+    cspSdo_add(csp, mapIndex, 0, 1, 0, false);
+    for (i = 0; i < mapCount; i++) {
+        cspSdo_add(csp, mapIndex, (uint8_t)(i + 1U), 4, map[i], false);
+    }
+    cspSdo_add(csp, mapIndex, 0, 1, mapCount, false);
+    cspSdo_add(csp, commIndex, 2, 1, 1, false); /* synchronous, every SYNC */
+    cspSdo_add(csp, commIndex, 1, 4, cobId, false);
+}
+
+/* Table of SDO downloads, which configure the drive for CSP mode. */
+static void
+cspSdo_init(cspClient_t* csp) {
+    const uint32_t rpdo1[] = {PDO_MAP(CIA402_CONTROLWORD, 0, 16), PDO_MAP(CIA402_TARGET_POSITION, 0, 32)};
+    const uint32_t tpdo1[] = {PDO_MAP(CIA402_POSITION_ACTUAL, 0, 32), PDO_MAP(CIA402_FOLLOWING_ERROR, 0, 32)};
+    const uint32_t tpdo2[] = {PDO_MAP(CIA402_STATUSWORD, 0, 16)};
+    uint8_t id = csp->driveId;
+    uint32_t value = csp->period_us;
+    int8_t exponent = -6;
+
+    /* Interpolation time period: value * 10^exponent seconds, value is uint8_t */
+    while (value > 255U) {
+        value /= 10U;
+        exponent++;
+    }
+
+    csp->sdoCount = 0;
+    cspSdo_addPDO(csp, 0x1400, CO_CAN_ID_RPDO_1 + id, rpdo1, 2);
+    cspSdo_addPDO(csp, 0x1800, CO_CAN_ID_TPDO_1 + id, tpdo1, 2);
+    cspSdo_addPDO(csp, 0x1801, CO_CAN_ID_TPDO_2 + id, tpdo2, 1);
+    cspSdo_add(csp, CIA402_INTERPOL_PERIOD, 1, 1, value, true);
+    cspSdo_add(csp, CIA402_INTERPOL_PERIOD, 2, 1, (uint8_t)exponent, true);
+    cspSdo_add(csp, 0x1006, 0, 4, csp->period_us, true);
+    cspSdo_add(csp, CIA402_MODES, 0, 1, CIA402_MODE_CSP, false);
+    csp->sdoIndex = 0;
+    csp->sdoInProgress = false;
+}
+
+/* Nonblocking processing of the drive configuration, called from the mainline. */
+static void
+csp_processMain(cspClient_t* csp, CO_t* co, uint32_t timeDifference_us, uint32_t* timerNext_us) {
+    CO_SDOclient_t* SDO_C = &co->SDOclient[0];
+
+    switch (csp->cfgState) {
+        case CSP_CFG_START:
+            if (CO_SDOclient_setup(SDO_C, CO_CAN_ID_SDO_CLI + csp->driveId, CO_CAN_ID_SDO_SRV + csp->driveId,
+                                   csp->driveId)
+                != CO_SDO_RT_ok_communicationEnd) {
+                log_printf("Error: SDO client setup\n");
+                csp->cfgState = CSP_CFG_ERROR;
+                break;
+            }
+            (void)CO_NMT_sendCommand(co->NMT, CO_NMT_ENTER_PRE_OPERATIONAL, csp->driveId);
+            cspSdo_init(csp);
+            csp->cfgState = CSP_CFG_SDO;
+            break;
+
+        case CSP_CFG_SDO: {
+            const cspSdo_t* sdo = &csp->sdo[csp->sdoIndex];
+            CO_SDO_return_t ret;
+
+            if (!csp->sdoInProgress) {
+                uint8_t buf[4];
+
+                CO_setUint32(buf, sdo->value);
+                if (CO_SDOclientDownloadInitiate(SDO_C, sdo->index, sdo->subIndex, sdo->size, SDO_CLI_TIMEOUT_TIME,
+                                                 false)
+                    != CO_SDO_RT_ok_communicationEnd) {
+                    log_printf("Error: SDO download initiate 0x%04X:%02X\n", sdo->index, sdo->subIndex);
+                    csp->cfgState = CSP_CFG_ERROR;
+                    break;
+                }
+                (void)CO_SDOclientDownloadBufWrite(SDO_C, buf, sdo->size);
+                csp->sdoInProgress = true;
+            }
+            ret = CO_SDOclientDownload(SDO_C, timeDifference_us, false, false, &csp->abortCode, NULL, timerNext_us);
+            if (ret > 0) {
+                break;
+            }
+            csp->sdoInProgress = false;
+            if (ret < 0) {
+                if (!sdo->optional) {
+                    log_printf("Error: drive 0x%04X:%02X, SDO abort 0x%08X\n", sdo->index, sdo->subIndex,
+                               (unsigned)csp->abortCode);
+                    csp->cfgState = CSP_CFG_ERROR;
+                    break;
+                }
+                log_printf("Drive 0x%04X:%02X not written, SDO abort 0x%08X\n", sdo->index, sdo->subIndex,
+                           (unsigned)csp->abortCode);
+            }
+            if (++csp->sdoIndex >= csp->sdoCount) {
+                (void)CO_NMT_sendCommand(co->NMT, CO_NMT_ENTER_OPERATIONAL, csp->driveId);
+                log_printf("Drive %d configured for CSP mode, period %uus\n", csp->driveId, csp->period_us);
+                csp->cfgState = CSP_CFG_RUNNING;
+            }
+            break;
+        }
+
+        case CSP_CFG_RUNNING:
+            if (csp->stopRequest || csp->done) {
+                csp->stopCycles = 0;
+                csp->cfgState = CSP_CFG_STOPPING;
+            }
+            break;
+
+        case CSP_CFG_STOPPING:
+            if (csp->stopCycles >= CSP_SHUTDOWN_CYCLES) {
+                (void)CO_NMT_sendCommand(co->NMT, CO_NMT_ENTER_PRE_OPERATIONAL, csp->driveId);
+                csp->cfgState = CSP_CFG_FINISHED;
+            }
+            break;
+
+        default: break;
+    }
+}
+
+/* Called by CO_epoll_processRT() after SYNC, after RPDOs and before TPDOs, inside CO_LOCK_OD. */
+static void
+csp_sync(void* object, CO_t* co) {
+    cspClient_t* csp = (cspClient_t*)object;
+    uint16_t sw = cspStatusword;
+    uint16_t cw = cspControlword;
+    struct timespec now;
+
+    (void)co;
+
+    /* SYNC interval statistics */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (csp->lastSync.tv_sec != 0 || csp->lastSync.tv_nsec != 0) {
+        int64_t interval_ns = (int64_t)(now.tv_sec - csp->lastSync.tv_sec) * 1000000000
+                              + (now.tv_nsec - csp->lastSync.tv_nsec);
+        uint32_t interval_us = (uint32_t)(interval_ns / 1000);
+        uint32_t jitter_us = interval_us > csp->period_us ? interval_us - csp->period_us
+                                                          : csp->period_us - interval_us;
+
+        if (csp->syncCount == 0U || interval_us < csp->intervalMin_us) {
+            csp->intervalMin_us = interval_us;
+        }
+        if (interval_us > csp->intervalMax_us) {
+            csp->intervalMax_us = interval_us;
+        }
+        if (jitter_us > csp->jitterMax_us) {
+            csp->jitterMax_us = jitter_us;
+        }
+        csp->syncCount++;
+    }
+    csp->lastSync = now;
+
+    if (csp->cfgState == CSP_CFG_STOPPING || csp->cfgState == CSP_CFG_FINISHED) {
+        cspControlword = CW_SHUTDOWN;
+        cspTarget = cspPosition;
+        csp->stopCycles++;
+        return;
+    }
+    if (csp->cfgState != CSP_CFG_RUNNING) {
+        return;
+    }
+
+    /* CiA402 state machine of the drive, from statusword */
+    if ((sw & 0x004FU) == 0x0008U) { /* Fault, reset it with rising edge of bit 7 */
+        cw = (cw & CW_FAULT_RESET) != 0U ? 0U : CW_FAULT_RESET;
+        csp->enabled = false;
+    } else if ((sw & 0x004FU) == 0x0040U) { /* Switch on disabled */
+        cw = CW_SHUTDOWN;
+        csp->enabled = false;
+    } else if ((sw & 0x006FU) == 0x0021U) { /* Ready to switch on */
+        cw = CW_SWITCH_ON;
+        csp->enabled = false;
+    } else if ((sw & 0x006FU) == 0x0023U) { /* Switched on */
+        cw = CW_ENABLE_OPERATION;
+        csp->enabled = false;
+    } else if ((sw & 0x006FU) == 0x0027U) { /* Operation enabled */
+        cw = CW_ENABLE_OPERATION;
+        if (!csp->enabled) {
+            /* start trajectory from the actual position, so drive does not jump */
+            csp->enabled = true;
+            traj_player_start(&csp->traj, cspPosition);
+        }
+    } else {
+        /* Not ready to switch on or transition in progress */
+    }
+
+    if (!csp->enabled) {
+        cspTarget = cspPosition;
+    } else {
+        cspTarget = traj_player_next(&csp->traj);
+        if (csp->targetCount > 0U && traj_player_done(&csp->traj)) {
+            csp->done = true;
+        }
+    }
+    cspControlword = cw;
+
+    if (abs(cspFollowing) > csp->followingMax) {
+        csp->followingMax = abs(cspFollowing);
+    }
+}
+
+/* main ***********************************************************************/
+int
+main(int argc, char* argv[]) {
+    int programExit = EXIT_SUCCESS;
+    CO_epoll_t epMain;
+    CO_t* CO = NULL;
+    CO_ReturnError_t err;
+    CO_NMT_reset_cmd_t reset = CO_RESET_NOT;
+    uint32_t heapMemoryUsed = 0;
+    CO_CANptrSocketCan_t CANptr = {0};
+    char* CANdevice = NULL;
+    uint8_t pendingNodeId = 1;
+    uint16_t pendingBitRate = 125;
+    cspClient_t csp;
+    CO_syncProducer_t syncProducer;
+    struct timespec lastPrint;
+    int opt;
+
+    memset(&csp, 0, sizeof(csp));
+    csp.driveId = 2;
+    csp.period_us = 1000;
+    csp.params.velocity = MOTOR_RESOLUTION / 10;
+    csp.params.acceleration = MOTOR_RESOLUTION;
+    csp.params.jerk = MOTOR_RESOLUTION * 10;
+    csp.dwell_us = 500000;
+    csp.syncPriority = -1;
+
+    /* Get program options */
+    if (argc < 2 || strcmp(argv[1], "--help") == 0) {
+        printUsage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+    while ((opt = getopt(argc, argv, "n:i:p:t:v:a:j:d:r:")) != -1) {
+        long value = (opt != '?') ? strtol(optarg, NULL, 0) : 0;
+
+        switch (opt) {
+            case 'n':
+            case 'i':
+                if (value < 1 || value > 127) {
+                    log_printf("Error: Wrong node ID (%s)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                if (opt == 'n') {
+                    csp.driveId = (uint8_t)value;
+                } else {
+                    pendingNodeId = (uint8_t)value;
+                }
+                break;
+            case 'p':
+                if (value < CSP_PERIOD_MIN_US || value > CSP_PERIOD_MAX_US) {
+                    log_printf("Error: Wrong SYNC period (%s)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                csp.period_us = (uint32_t)value;
+                break;
+            case 't':
+                if (csp.targetCount >= CSP_TARGETS_MAX) {
+                    log_printf("Error: Maximum %d targets\n", CSP_TARGETS_MAX);
+                    return EXIT_FAILURE;
+                }
+                csp.targets[csp.targetCount++] = (int32_t)value;
+                break;
+            case 'v':
+            case 'a':
+            case 'j':
+                if (value <= 0) {
+                    log_printf("Error: Wrong velocity, acceleration or jerk (%s)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                if (opt == 'v') {
+                    csp.params.velocity = (double)value;
+                } else if (opt == 'a') {
+                    csp.params.acceleration = (double)value;
+                } else {
+                    csp.params.jerk = (double)value;
+                }
+                break;
+            case 'd':
+                if (value < 0 || value > 60000) {
+                    log_printf("Error: Wrong dwell time (%s)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                csp.dwell_us = (uint32_t)value * 1000U;
+                break;
+            case 'r':
+                if (value < 0 || value > 99) {
+                    log_printf("Error: Wrong SYNC thread priority (%s)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                csp.syncPriority = (int)value;
+                break;
+            default: printUsage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if (pendingNodeId == csp.driveId) {
+        log_printf("Error: Node ID of this node and of the drive must differ\n");
+        return EXIT_FAILURE;
+    }
+    if (optind < argc) {
+        CANdevice = argv[optind];
+        CANptr.can_ifindex = (int)if_nametoindex(CANdevice);
+    }
+    if (CANptr.can_ifindex == 0) {
+        log_printf("Error: Can't find CAN device \"%s\"\n", CANdevice != NULL ? CANdevice : "");
+        return EXIT_FAILURE;
+    }
+
+    csp.params.period_us = csp.period_us;
+    if (!traj_player_init(&csp.traj, &csp.params, csp.targets, csp.targetCount, csp.dwell_us)) {
+        log_printf("Error: Wrong trajectory parameters\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Application objects and PDO configuration of this node */
+    if (!cspOD_init()) {
+        log_printf("Error: Can't allocate memory or OD is not ordered by index\n");
+        return EXIT_FAILURE;
+    }
+    cspOD_configurePDO(&csp);
+
+    /* Allocate memory */
+    CO = CO_new(NULL, &heapMemoryUsed);
+    if (CO == NULL) {
+        log_printf("Error: Can't allocate memory\n");
+        return EXIT_FAILURE;
+    }
+
+    err = CO_epoll_create(&epMain, MAIN_THREAD_INTERVAL_US);
+    if (err != CO_ERROR_NO) {
+        log_printf("Error: epoll creation failed: %d\n", err);
+        return EXIT_FAILURE;
+    }
+
+    if (signal(SIGINT, sigHandler) == SIG_ERR || signal(SIGTERM, sigHandler) == SIG_ERR) {
+        log_printf("Error: signal handler\n");
+        return EXIT_FAILURE;
+    }
+
+    /* SYNC producer thread, paused during each communication reset */
+    memset(&syncProducer, 0, sizeof(syncProducer));
+    if (csp.syncPriority >= 0) {
+        err = CO_syncProducer_start(&syncProducer, CO, &epMain, -1, csp.syncPriority);
+        if (err != CO_ERROR_NO) {
+            log_printf("Error: SYNC producer thread can't be started (SCHED_FIFO permitted?): %d\n", err);
+            return EXIT_FAILURE;
+        }
+    }
+
+    while (reset != CO_RESET_APP && reset != CO_RESET_QUIT && csp.cfgState != CSP_CFG_FINISHED
+           && csp.cfgState != CSP_CFG_ERROR) {
+        /* CANopen communication reset - initialize CANopen objects *******************/
+        uint32_t errInfo = 0;
+
+        CO_syncProducer_pause(&syncProducer);
+        CO->CANmodule->CANnormal = false;
+        CO_CANsetConfigurationMode((void*)&CANptr);
+        CO_CANmodule_disable(CO->CANmodule);
+
+        err = CO_CANinit(CO, (void*)&CANptr, pendingBitRate);
+        if (err != CO_ERROR_NO) {
+            log_printf("Error: CAN initialization failed: %d\n", err);
+            return EXIT_FAILURE;
+        }
+
+        CO_LSS_address_t lssAddress = {.identity = {.vendorID = OD_PERSIST_COMM.x1018_identity.vendor_ID,
+                                                    .productCode = OD_PERSIST_COMM.x1018_identity.productCode,
+                                                    .revisionNumber = OD_PERSIST_COMM.x1018_identity.revisionNumber,
+                                                    .serialNumber = OD_PERSIST_COMM.x1018_identity.serialNumber}};
+        err = CO_LSSinit(CO, &lssAddress, &pendingNodeId, &pendingBitRate);
+        if (err != CO_ERROR_NO) {
+            log_printf("Error: LSS slave initialization failed: %d\n", err);
+            return EXIT_FAILURE;
+        }
+
+        err = CO_CANopenInit(CO, NULL, NULL, OD, OD_STATUS_BITS, NMT_CONTROL, FIRST_HB_TIME, SDO_SRV_TIMEOUT_TIME,
+                             SDO_CLI_TIMEOUT_TIME, SDO_CLI_BLOCK, pendingNodeId, &errInfo);
+        if (err == CO_ERROR_NO) {
+            err = CO_CANopenInitPDO(CO, CO->em, OD, pendingNodeId, &errInfo);
+        }
+        if (err != CO_ERROR_NO) {
+            if (err == CO_ERROR_OD_PARAMETERS) {
+                log_printf("Error: Object Dictionary entry 0x%X\n", errInfo);
+            } else {
+                log_printf("Error: CANopen initialization failed: %d\n", err);
+            }
+            return EXIT_FAILURE;
+        }
+
+        err = CO_epoll_initCANopenMain(&epMain, CO);
+        if (err != CO_ERROR_NO) {
+            log_printf("Error: epoll initialization failed: %d\n", err);
+            return EXIT_FAILURE;
+        }
+        CO_epoll_initCallbackSync(&epMain, &csp, csp_sync);
+        if (syncProducer.threadStarted) {
+            (void)CO_syncProducer_initOD(&syncProducer, OD_find(OD, CSP_OD_SYNC_STATS));
+        }
+
+        /* Drive is configured again after each communication reset */
+        csp.cfgState = CSP_CFG_START;
+        csp.enabled = false;
+
+        CO_CANsetNormalMode(CO->CANmodule);
+        CO_syncProducer_resume(&syncProducer);
+        reset = CO_RESET_NOT;
+        clock_gettime(CLOCK_MONOTONIC, &lastPrint);
+
+        log_printf("CSP client - Running on %s, drive %d, SYNC period %uus...\n", CANdevice, csp.driveId,
+                   csp.period_us);
+        fflush(stdout);
+
+        while (reset == CO_RESET_NOT && csp.cfgState != CSP_CFG_FINISHED && csp.cfgState != CSP_CFG_ERROR) {
+            struct timespec now;
+
+            /* loop for normal program execution ******************************************/
+            CO_epoll_wait(&epMain);
+            CO_epoll_processRT(&epMain, CO, false);
+            CO_epoll_processMain(&epMain, CO, false, &reset);
+
+            if (CO_endProgram != 0) {
+                if (csp.cfgState == CSP_CFG_RUNNING) {
+                    csp.stopRequest = true;
+                } else if (csp.cfgState != CSP_CFG_STOPPING) {
+                    (void)CO_NMT_sendCommand(CO->NMT, CO_NMT_ENTER_PRE_OPERATIONAL, csp.driveId);
+                    csp.cfgState = CSP_CFG_FINISHED;
+                }
+            }
+            csp_processMain(&csp, CO, epMain.timeDifference_us, &epMain.timerNext_us);
+            /* Next segment of the path, while the SYNC callback plays the current one */
+            if (!traj_player_plan(&csp.traj)) {
+                log_printf("Error: Can't allocate memory for trajectory\n");
+                csp.stopRequest = true;
+            }
+
+            /* Statistics once per second */
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (now.tv_sec > lastPrint.tv_sec && csp.cfgState == CSP_CFG_RUNNING) {
+                /* SYNC callback runs in this thread, from CO_epoll_processRT() */
+                log_printf("sw=0x%04X pos=%d target=%d followingMax=%d | SYNC %u, interval %u..%uus, jitter %uus, "
+                           "underruns %u\n",
+                           cspStatusword, cspPosition, cspTarget, csp.followingMax, csp.syncCount, csp.intervalMin_us,
+                           csp.intervalMax_us, csp.jitterMax_us, atomic_load(&csp.traj.underruns));
+                csp.syncCount = 0;
+                csp.intervalMin_us = 0;
+                csp.intervalMax_us = 0;
+                csp.jitterMax_us = 0;
+                csp.followingMax = 0;
+                if (syncProducer.threadStarted) {
+                    CO_syncProducerStats_t st;
+
+                    CO_syncProducer_getStats(&syncProducer, &st);
+                    log_printf("SYNC thread: cycles %u, missed %u, send errors %u, jitter %d/%d/%dns (min/mean/max), "
+                               "latency max %uns\n",
+                               st.cycles, st.missed, st.sendErrors, st.jitterMin_ns, st.jitterMean_ns, st.jitterMax_ns,
+                               st.latencyMax_ns);
+                }
+                fflush(stdout);
+                lastPrint = now;
+            }
+
+            CO_epoll_processLast(&epMain);
+        }
+    }
+
+    if (csp.cfgState == CSP_CFG_ERROR) {
+        programExit = EXIT_FAILURE;
+    } else if (csp.done) {
+        log_printf("All targets reached\n");
+    }
+
+    /* program exit ***************************************************************/
+    CO_syncProducer_stop(&syncProducer);
+    CO_epoll_close(&epMain);
+    CO_CANsetConfigurationMode((void*)&CANptr);
+    CO_delete(CO);
+    free(cspOD.list);
+    traj_player_free(&csp.traj);
+
+    log_printf("CSP client finished\n");
+
+    return programExit;
+}
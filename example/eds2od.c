@@ -0,0 +1,1099 @@
+/*
+ * author: ZeroErr Inc.
+ * EDS to Object Dictionary generator: build-time C sources from an EDS file
+ *
+ * Usage: eds2od od <file.eds> <name> <name.c> <name.h>
+ *        eds2od remote <file.eds> <name> <name.c> <name.h>
+ *
+ * "od" writes a CANopenNode V4 Object Dictionary in the same layout as CANopenEditor: data structures per storage
+ * group, OD_obj_xxx_t descriptors and the OD_entry_t list sorted by index, as required by OD_find(). All symbols are
+ * prefixed with <name> (OD_ENTRY_H1000 becomes <name>_ENTRY_H1000 and so on), so name "OD" gives a drop-in OD.c/OD.h
+ * and other names can be linked next to it, for example with CO_MULTIPLE_OD.
+ *
+ * "remote" writes the object table of a remote device for the master: a sorted eds_object_t array, which is used
+ * with eds_index_from_table() without parsing the EDS at runtime, and <NAME>_iiii_ss_SIZE / _TYPE macros with the size
+ * and data type of each object, usable in constant expressions.
+ *
+ * Storage group of an object is taken from the "StorageLocation" or "CO_storageGroup" key of its section (also as
+ * ";" comment, written by CANopenEditor). Without it, objects 0x1000..0x1FFF are in PERSIST_COMM, except the volatile
+ * ones (0x1001..0x1003, 0x1010, 0x1011, SDO server parameters), and all other objects are in RAM.
+ *
+ * XDD/XPD files are not supported, export them as EDS first. CompactSubObj is not supported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <stdint.h>
+
+#include "eds_index.h"
+
+#define NAME_MAX_LEN 64
+#define GROUP_MAX_LEN 32
+#define GROUPS_MAX 8
+
+// Sub-entry with data, also the data of the VAR object (subindex 0)
+typedef struct {
+    uint8_t subindex;
+    uint16_t data_type;
+    uint8_t access;          // eds_access_t
+    uint8_t flags;           // EDS_FLAG_xxx
+    int has_data_type;
+    int64_t default_value;
+    int64_t low_limit;
+    int64_t high_limit;
+    char default_str[256];   // DefaultValue as written in the EDS, for strings and REAL
+    char name[NAME_MAX_LEN];
+    char member[NAME_MAX_LEN]; // C name of the record member
+} sub_t;
+
+typedef struct {
+    uint16_t index;
+    uint8_t object_type;     // 0x7 VAR, 0x8 ARRAY, 0x9 RECORD
+    int odt;                 // emitted as: 0 VAR, 1 ARR, 2 REC
+    char name[NAME_MAX_LEN];
+    char cname[NAME_MAX_LEN];
+    char group[GROUP_MAX_LEN];
+    sub_t *subs;
+    uint16_t sub_count;
+    uint16_t sub_capacity;
+} object_t;
+
+enum { ODT_VAR_ = 0, ODT_ARR_ = 1, ODT_REC_ = 2 };
+
+static object_t *objects;
+static uint32_t object_count;
+static uint32_t object_capacity;
+
+static const char *eds_path;
+
+static const char *base_name(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash != NULL ? slash + 1 : path;
+}
+
+static void fail(const char *message, uint16_t index) {
+    fprintf(stderr, "eds2od: %s: %s (object 0x%04X)\n", eds_path, message, (unsigned)index);
+    exit(EXIT_FAILURE);
+}
+
+static void *xrealloc(void *p, size_t size) {
+    p = realloc(p, size);
+    if (p == NULL) {
+        fprintf(stderr, "eds2od: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+static object_t *get_object(uint16_t index) {
+    for (uint32_t i = 0; i < object_count; i++) {
+        if (objects[i].index == index) {
+            return &objects[i];
+        }
+    }
+    if (object_count == object_capacity) {
+        object_capacity = object_capacity ? object_capacity * 2 : 128;
+        objects = xrealloc(objects, object_capacity * sizeof(object_t));
+    }
+    object_t *obj = &objects[object_count++];
+    memset(obj, 0, sizeof(*obj));
+    obj->index = index;
+    obj->object_type = 0x7;
+    return obj;
+}
+
+static sub_t *get_sub(object_t *obj, uint8_t subindex) {
+    for (uint16_t i = 0; i < obj->sub_count; i++) {
+        if (obj->subs[i].subindex == subindex) {
+            return &obj->subs[i];
+        }
+    }
+    if (obj->sub_count == obj->sub_capacity) {
+        obj->sub_capacity = obj->sub_capacity ? obj->sub_capacity * 2 : 8;
+        obj->subs = xrealloc(obj->subs, obj->sub_capacity * sizeof(sub_t));
+    }
+    sub_t *sub = &obj->subs[obj->sub_count++];
+    memset(sub, 0, sizeof(*sub));
+    sub->subindex = subindex;
+    return sub;
+}
+
+static uint8_t parse_access(const char *value) {
+    if (strcasecmp(value, "ro") == 0) return EDS_ACCESS_RO;
+    if (strcasecmp(value, "wo") == 0) return EDS_ACCESS_WO;
+    if (strcasecmp(value, "rw") == 0) return EDS_ACCESS_RW;
+    if (strcasecmp(value, "rwr") == 0) return EDS_ACCESS_RWR;
+    if (strcasecmp(value, "rww") == 0) return EDS_ACCESS_RWW;
+    if (strcasecmp(value, "const") == 0) return EDS_ACCESS_CONST;
+    return EDS_ACCESS_UNKNOWN;
+}
+
+/* Parse integer value: decimal, 0x hex, negative or "$NODEID+value", same rules as eds_index.c */
+static int parse_number(const char *value, int64_t *number, int *nodeid_relative) {
+    char *end;
+
+    *nodeid_relative = 0;
+    if (strncasecmp(value, "$NODEID", 7) == 0) {
+        *nodeid_relative = 1;
+        value += 7;
+        while (*value == ' ' || *value == '+') {
+            value++;
+        }
+        if (*value == 0) {
+            *number = 0;
+            return 1;
+        }
+    }
+    if (*value == 0) {
+        return 0;
+    }
+    if (*value == '-') {
+        *number = strtoll(value, &end, 0);
+    } else {
+        *number = (int64_t)strtoull(value, &end, 0);
+    }
+    return end != value;
+}
+
+/* End of the object section: VAR keeps its data as sub-index 0, ARRAY/RECORD only the name */
+static void finish_section(object_t *obj, const sub_t *head, uint8_t object_type) {
+    if (obj == NULL) {
+        return;
+    }
+    obj->object_type = object_type;
+    snprintf(obj->name, sizeof(obj->name), "%s", head->name);
+    if (object_type == 0x7) {
+        *get_sub(obj, 0) = *head;
+    }
+}
+
+/* Parse all object sections ([xxxx] and [xxxxsubN]) of the EDS file */
+static void parse_eds(void) {
+    FILE *file = fopen(eds_path, "r");
+    object_t *obj = NULL;    // object of the current section
+    object_t *head_obj = NULL; // object of the current [xxxx] section
+    sub_t head;              // data of the [xxxx] section
+    uint8_t head_type = 0x7;
+    sub_t *sub = NULL;       // &head or sub-entry of the current [xxxxsubN] section
+    char line[512];
+
+    if (file == NULL) {
+        perror(eds_path);
+        exit(EXIT_FAILURE);
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = 0;
+
+        if (line[0] == '[') {
+            char *end_bracket = strchr(line, ']');
+            unsigned int index, subindex = 0;
+            char tail[8] = "";
+
+            finish_section(head_obj, &head, head_type);
+            head_obj = NULL;
+            obj = NULL;
+            sub = NULL;
+            if (end_bracket == NULL) {
+                continue;
+            }
+            *end_bracket = 0;
+            if (strlen(line + 1) < 4 || !isxdigit((unsigned char)line[1])
+                || sscanf(line + 1, "%4x%7s", &index, tail) < 1) {
+                continue;
+            }
+            if (tail[0] == 0) {
+                obj = head_obj = get_object((uint16_t)index);
+                memset(&head, 0, sizeof(head));
+                head_type = 0x7;
+                sub = &head;
+            } else if (strncasecmp(tail, "sub", 3) == 0 && sscanf(tail + 3, "%x", &subindex) == 1) {
+                obj = get_object((uint16_t)index);
+                sub = get_sub(obj, (uint8_t)subindex);
+            } else if (strcasecmp(tail, "Name") == 0 || strcasecmp(tail, "Value") == 0) {
+                fail("CompactSubObj is not supported", (uint16_t)index);
+            }
+            continue;
+        }
+        if (obj == NULL) {
+            continue;
+        }
+
+        // CANopenEditor writes its own properties as comments
+        char *key = line;
+        int comment = 0;
+        if (*key == ';') {
+            key++;
+            comment = 1;
+        }
+        char *eq = strchr(key, '=');
+        if (eq == NULL) {
+            continue;
+        }
+        *eq = 0;
+        char *value = eq + 1;
+        while (*value == ' ' || *value == '\t') {
+            value++;
+        }
+        for (char *p = value + strlen(value); p > value && (p[-1] == ' ' || p[-1] == '\t'); p--) {
+            p[-1] = 0;
+        }
+
+        int64_t number;
+        int nodeid_relative;
+        if (strcasecmp(key, "StorageLocation") == 0 || strcasecmp(key, "CO_storageGroup") == 0) {
+            snprintf(obj->group, sizeof(obj->group), "%s", value);
+        } else if (comment) {
+            continue;
+        } else if (strcasecmp(key, "ParameterName") == 0) {
+            snprintf(sub->name, sizeof(sub->name), "%s", value);
+        } else if (strcasecmp(key, "ObjectType") == 0) {
+            if (sub == &head && parse_number(value, &number, &nodeid_relative)) {
+                head_type = (uint8_t)number;
+            }
+        } else if (strcasecmp(key, "CompactSubObj") == 0) {
+            if (parse_number(value, &number, &nodeid_relative) && number != 0) {
+                fail("CompactSubObj is not supported", obj->index);
+            }
+        } else if (strcasecmp(key, "DataType") == 0) {
+            if (parse_number(value, &number, &nodeid_relative)) {
+                sub->data_type = (uint16_t)number;
+                sub->has_data_type = 1;
+            }
+        } else if (strcasecmp(key, "AccessType") == 0) {
+            sub->access = parse_access(value);
+        } else if (strcasecmp(key, "PDOMapping") == 0) {
+            if (parse_number(value, &number, &nodeid_relative) && number != 0) {
+                sub->flags |= EDS_FLAG_PDO_MAPPING;
+            }
+        } else if (strcasecmp(key, "DefaultValue") == 0) {
+            snprintf(sub->default_str, sizeof(sub->default_str), "%s", value);
+            if (parse_number(value, &number, &nodeid_relative)) {
+                sub->default_value = number;
+                sub->flags |= EDS_FLAG_DEFAULT | (nodeid_relative ? EDS_FLAG_DEFAULT_NODEID : 0);
+            }
+        } else if (strcasecmp(key, "LowLimit") == 0) {
+            if (parse_number(value, &number, &nodeid_relative)) {
+                sub->low_limit = number;
+                sub->flags |= EDS_FLAG_LOW_LIMIT;
+            }
+        } else if (strcasecmp(key, "HighLimit") == 0) {
+            if (parse_number(value, &number, &nodeid_relative)) {
+                sub->high_limit = number;
+                sub->flags |= EDS_FLAG_HIGH_LIMIT;
+            }
+        }
+    }
+    finish_section(head_obj, &head, head_type);
+    fclose(file);
+}
+
+static int compare_subs(const void *a, const void *b) {
+    const sub_t *sa = a;
+    const sub_t *sb = b;
+    return (sa->subindex > sb->subindex) - (sa->subindex < sb->subindex);
+}
+
+static int compare_object_index(const void *a, const void *b) {
+    const object_t *oa = a;
+    const object_t *ob = b;
+    return (oa->index > ob->index) - (oa->index < ob->index);
+}
+
+/* CANopenEditor style C name: "COB-ID used by RPDO" -> "COB_IDUsedByRPDO", "Device type" -> "deviceType" */
+static void make_cname(char *out, size_t out_size, const char *name) {
+    size_t n = 0;
+    int upper_next = 0;
+
+    for (const char *p = name; *p != 0 && n + 1 < out_size; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (isalnum(c)) {
+            if (n == 0) {
+                // first letter is lower case, unless the word is an abbreviation
+                c = isupper((unsigned char)p[1]) ? c : (unsigned char)tolower(c);
+            } else if (upper_next) {
+                // two abbreviations are separated: "COB-ID SYNC" -> "COB_ID_SYNC"
+                if (isupper((unsigned char)out[n - 1]) && isupper(c) && isupper((unsigned char)p[1])
+                    && n + 2 < out_size) {
+                    out[n++] = '_';
+                }
+                c = (unsigned char)toupper(c);
+            }
+            out[n++] = (char)c;
+            upper_next = 0;
+        } else if (c == '-' || c == '_') {
+            if (n > 0) {
+                out[n++] = '_';
+            }
+            upper_next = 0;
+        } else {
+            upper_next = 1;
+        }
+    }
+    if (n == 0 || isdigit((unsigned char)out[0])) {
+        // name is empty or starts with a number
+        memmove(out + 1, out, n < out_size - 1 ? n : out_size - 2);
+        out[0] = 'x';
+        n = n < out_size - 1 ? n + 1 : out_size - 1;
+    }
+    out[n] = 0;
+}
+
+/* Sort, verify and classify the objects */
+static void finish_objects(void) {
+    for (uint32_t i = 0; i < object_count; i++) {
+        object_t *obj = &objects[i];
+
+        if (obj->object_type == 0x7) {
+            // VAR: only the data of the object section
+            if (obj->sub_count != 1 || !obj->subs[0].has_data_type) {
+                fail("VAR without DataType or with sub-indexes", obj->index);
+            }
+            obj->odt = ODT_VAR_;
+        } else if (obj->object_type == 0x8 || obj->object_type == 0x9) {
+            // sub-indexes without data are not in the OD
+            for (uint16_t s = 0; s < obj->sub_count; s++) {
+                if (!obj->subs[s].has_data_type) {
+                    obj->subs[s] = obj->subs[--obj->sub_count];
+                    s--;
+                }
+            }
+            qsort(obj->subs, obj->sub_count, sizeof(sub_t), compare_subs);
+            if (obj->sub_count == 0 || obj->subs[0].subindex != 0) {
+                fail("ARRAY or RECORD without sub-index 0", obj->index);
+            }
+            obj->odt = (obj->object_type == 0x8) ? ODT_ARR_ : ODT_REC_;
+            // array must have equal, contiguous elements, else it is written as record
+            for (uint16_t s = 1; obj->odt == ODT_ARR_ && s < obj->sub_count; s++) {
+                if (obj->subs[s].subindex != s || obj->subs[s].data_type != obj->subs[1].data_type) {
+                    obj->odt = ODT_REC_;
+                }
+            }
+            if (obj->odt == ODT_ARR_ && obj->sub_count < 2) {
+                obj->odt = ODT_REC_;
+            }
+        } else {
+            fail("ObjectType is not supported", obj->index);
+        }
+
+        make_cname(obj->cname, sizeof(obj->cname), obj->name);
+
+        // unique member names inside record
+        for (uint16_t s = 0; s < obj->sub_count; s++) {
+            sub_t *sub = &obj->subs[s];
+            make_cname(sub->member, sizeof(sub->member), sub->name);
+            for (uint16_t t = 0; t < s; t++) {
+                if (strcmp(obj->subs[t].member, sub->member) == 0) {
+                    size_t len = strlen(sub->member);
+                    snprintf(sub->member + (len < NAME_MAX_LEN - 5 ? len : NAME_MAX_LEN - 5), 5, "_%u",
+                             (unsigned)sub->subindex);
+                    break;
+                }
+            }
+        }
+
+        if (obj->group[0] == 0) {
+            uint16_t index = obj->index;
+            int is_volatile = index == 0x1001 || index == 0x1002 || index == 0x1003 || index == 0x1010
+                              || index == 0x1011 || (index >= 0x1200 && index < 0x1280);
+            snprintf(obj->group, sizeof(obj->group), "%s",
+                     (index >= 0x1000 && index < 0x2000 && !is_volatile) ? "PERSIST_COMM" : "RAM");
+        }
+        for (char *p = obj->group; *p != 0; p++) {
+            if (!isalnum((unsigned char)*p) && *p != '_') {
+                fail("invalid storage group name", obj->index);
+            }
+        }
+    }
+    qsort(objects, object_count, sizeof(object_t), compare_object_index);
+    for (uint32_t i = 1; i < object_count; i++) {
+        if (objects[i].index == objects[i - 1].index) {
+            fail("duplicate object", objects[i].index);
+        }
+    }
+}
+
+/* C type and size of the CANopen data type, size 0 for types with length from the default value */
+// Unsupported types give 0 with type NULL and size 0; verify_types() rejects them before generation
+static int c_type(uint16_t data_type, const char **type, uint32_t *size) {
+    *type = NULL;
+    *size = 0;
+    switch (data_type) {
+        case 0x0001: *type = "bool_t"; *size = 1; return 1;
+        case 0x0002: *type = "int8_t"; *size = 1; return 1;
+        case 0x0003: *type = "int16_t"; *size = 2; return 1;
+        case 0x0004: *type = "int32_t"; *size = 4; return 1;
+        case 0x0005: *type = "uint8_t"; *size = 1; return 1;
+        case 0x0006: *type = "uint16_t"; *size = 2; return 1;
+        case 0x0007: *type = "uint32_t"; *size = 4; return 1;
+        case 0x0008: *type = "float32_t"; *size = 4; return 1;
+        case 0x0009: *type = "char"; *size = 0; return 1;       // VISIBLE_STRING
+        case 0x000A: *type = "uint8_t"; *size = 0; return 1;    // OCTET_STRING
+        case 0x000F: *type = NULL; *size = 0; return 1;         // DOMAIN, no data in the OD
+        case 0x0011: *type = "float64_t"; *size = 8; return 1;
+        case 0x0015: *type = "int64_t"; *size = 8; return 1;
+        case 0x001B: *type = "uint64_t"; *size = 8; return 1;
+        default: return 0;
+    }
+}
+
+static int is_string(uint16_t data_type) {
+    return data_type == 0x0009 || data_type == 0x000A;
+}
+
+/* Length of the string data: VISIBLE_STRING from DefaultValue plus terminator, OCTET_STRING are hex bytes */
+static uint32_t string_length(const sub_t *sub) {
+    if (sub->data_type == 0x0009) {
+        return (uint32_t)strlen(sub->default_str) + 1;
+    }
+    uint32_t digits = 0;
+    for (const char *p = sub->default_str; *p != 0; p++) {
+        digits += isxdigit((unsigned char)*p) ? 1 : 0;
+    }
+    return digits >= 2 ? digits / 2 : 1;
+}
+
+static void verify_types(void) {
+    for (uint32_t i = 0; i < object_count; i++) {
+        for (uint16_t s = 0; s < objects[i].sub_count; s++) {
+            const char *type;
+            uint32_t size;
+            if (!c_type(objects[i].subs[s].data_type, &type, &size)) {
+                fail("DataType is not supported", objects[i].index);
+            }
+        }
+    }
+}
+
+/* Data of the sub-entry: C type, length in the OD and array suffix for strings */
+static void sub_data(const sub_t *sub, const char **type, uint32_t *length, char *suffix, size_t suffix_size) {
+    c_type(sub->data_type, type, length);
+    suffix[0] = 0;
+    if (is_string(sub->data_type)) {
+        *length = string_length(sub);
+        snprintf(suffix, suffix_size, "[%u]", (unsigned)*length);
+    }
+}
+
+static uint8_t sub_attribute_bits(const sub_t *sub, char *out, size_t out_size) {
+    const char *sdo;
+    const char *pdo = NULL;
+    int mappable = (sub->flags & EDS_FLAG_PDO_MAPPING) != 0;
+    uint8_t attr = 0;
+
+    switch (sub->access) {
+        case EDS_ACCESS_WO: sdo = "ODA_SDO_W"; attr = 0x02; pdo = mappable ? "ODA_RPDO" : NULL; break;
+        case EDS_ACCESS_RW: sdo = "ODA_SDO_RW"; attr = 0x03; pdo = mappable ? "ODA_TRPDO" : NULL; break;
+        case EDS_ACCESS_RWR: sdo = "ODA_SDO_RW"; attr = 0x03; pdo = mappable ? "ODA_TPDO" : NULL; break;
+        case EDS_ACCESS_RWW: sdo = "ODA_SDO_RW"; attr = 0x03; pdo = mappable ? "ODA_RPDO" : NULL; break;
+        default: sdo = "ODA_SDO_R"; attr = 0x01; pdo = mappable ? "ODA_TPDO" : NULL; break;
+    }
+
+    const char *type;
+    uint32_t size;
+    c_type(sub->data_type, &type, &size);
+    snprintf(out, out_size, "%s%s%s%s%s", sdo, pdo ? " | " : "", pdo ? pdo : "",
+             (size > 1 && !is_string(sub->data_type)) ? " | ODA_MB" : "",
+             is_string(sub->data_type) ? " | ODA_STR" : "");
+    return attr;
+}
+
+/* Default value as C initializer */
+static void default_value(const sub_t *sub, char *out, size_t out_size) {
+    const char *type;
+    uint32_t size;
+    c_type(sub->data_type, &type, &size);
+
+    if (sub->data_type == 0x0009) {
+        size_t n = 0;
+        out[n++] = '"';
+        for (const char *p = sub->default_str; *p != 0 && n + 3 < out_size; p++) {
+            if (*p == '"' || *p == '\\') {
+                out[n++] = '\\';
+            }
+            out[n++] = *p;
+        }
+        out[n++] = '"';
+        out[n] = 0;
+    } else if (sub->data_type == 0x000A) {
+        size_t n = 0;
+        uint32_t bytes = string_length(sub);
+        const char *p = sub->default_str;
+        out[n++] = '{';
+        for (uint32_t b = 0; b < bytes && n + 8 < out_size; b++) {
+            unsigned int byte = 0;
+            for (int d = 0; d < 2 && *p != 0;) {
+                if (isxdigit((unsigned char)*p)) {
+                    byte = byte * 16 + (unsigned int)(isdigit((unsigned char)*p) ? *p - '0'
+                                                                                  : tolower((unsigned char)*p) - 'a'
+                                                                                        + 10);
+                    d++;
+                }
+                p++;
+            }
+            n += (size_t)snprintf(out + n, out_size - n, "%s0x%02X", b ? ", " : "", byte);
+        }
+        out[n++] = '}';
+        out[n] = 0;
+    } else if (sub->data_type == 0x0008 || sub->data_type == 0x0011) {
+        double value = sub->default_str[0] ? strtod(sub->default_str, NULL) : 0.0;
+        snprintf(out, out_size, "%.17g%s", value, sub->data_type == 0x0008 ? "F" : "");
+        if (strpbrk(out, ".eEni") == NULL) {
+            // integral value, make it a floating point constant
+            char *f = strchr(out, 'F');
+            snprintf(f != NULL ? f : out + strlen(out), 6, ".0%s", sub->data_type == 0x0008 ? "F" : "");
+        }
+    } else if (sub->data_type == 0x0002 || sub->data_type == 0x0003 || sub->data_type == 0x0004
+               || sub->data_type == 0x0015) {
+        int64_t value = sub->default_value;
+        if (value == INT32_MIN || value == INT64_MIN) {
+            // (-2147483647 - 1) form avoids the unsigned constant for the minimum
+            snprintf(out, out_size, "(%lld - 1)", (long long)(value + 1));
+        } else {
+            snprintf(out, out_size, "%lld", (long long)value);
+        }
+    } else {
+        uint64_t mask = size >= 8 ? UINT64_MAX : ((1ULL << (size * 8)) - 1);
+        snprintf(out, out_size, "0x%0*llX", (int)(size * 2), (unsigned long long)((uint64_t)sub->default_value & mask));
+        if (size == 8) {
+            strncat(out, "ULL", out_size - strlen(out) - 1);
+        }
+    }
+}
+
+/* Upper case copy of the name for macros */
+static void upper(char *out, size_t out_size, const char *name) {
+    size_t n = 0;
+    for (; name[n] != 0 && n + 1 < out_size; n++) {
+        out[n] = (char)toupper((unsigned char)name[n]);
+    }
+    out[n] = 0;
+}
+
+static void header_comment(FILE *f, const char *title) {
+    fprintf(f, "/*******************************************************************************\n");
+    fprintf(f, "    %s\n", title);
+    fprintf(f, "*******************************************************************************/\n");
+}
+
+static const char *groups[GROUPS_MAX];
+static uint32_t group_count;
+
+static void collect_groups(void) {
+    for (uint32_t i = 0; i < object_count; i++) {
+        uint32_t g;
+        for (g = 0; g < group_count; g++) {
+            if (strcmp(groups[g], objects[i].group) == 0) {
+                break;
+            }
+        }
+        if (g == group_count) {
+            if (group_count == GROUPS_MAX) {
+                fail("too many storage groups", objects[i].index);
+            }
+            groups[group_count++] = objects[i].group;
+        }
+    }
+}
+
+static const object_t *find_object(uint16_t index) {
+    for (uint32_t i = 0; i < object_count; i++) {
+        if (objects[i].index == index) {
+            return &objects[i];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t count_range(uint16_t first, uint16_t last) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < object_count; i++) {
+        count += (objects[i].index >= first && objects[i].index <= last) ? 1 : 0;
+    }
+    return count;
+}
+
+/* Counters of OD objects, same labels as CO_countLabel of CANopenEditor */
+typedef struct {
+    const char *label;
+    uint16_t first;
+    uint16_t last;
+} count_label_t;
+
+static const count_label_t count_labels[] = {
+    {"NMT", 0x1000, 0x1000},     {"EM", 0x1001, 0x1001},       {"SYNC", 0x1005, 0x1005},
+    {"SYNC_PROD", 0x1006, 0x1006}, {"STORAGE", 0x1010, 0x1010}, {"TIME", 0x1012, 0x1012},
+    {"EM_PROD", 0x1014, 0x1014}, {"HB_CONS", 0x1016, 0x1016},  {"HB_PROD", 0x1017, 0x1017},
+    {"SDO_SRV", 0x1200, 0x127F}, {"SDO_CLI", 0x1280, 0x12FF},  {"RPDO", 0x1400, 0x15FF},
+    {"TPDO", 0x1800, 0x19FF},
+};
+
+static void write_entry_config(FILE *f, const char *name, const char *field, uint16_t index) {
+    if (find_object(index) != NULL) {
+        fprintf(f, "    (config).%s = %s_ENTRY_H%04X;\\\n", field, name, (unsigned)index);
+    } else {
+        fprintf(f, "    (config).%s = NULL;\\\n", field);
+    }
+}
+
+static void write_count_config(FILE *f, const char *name, const char *label) {
+    for (size_t c = 0; c < sizeof(count_labels) / sizeof(count_labels[0]); c++) {
+        if (strcmp(count_labels[c].label, label) == 0
+            && count_range(count_labels[c].first, count_labels[c].last) > 0) {
+            fprintf(f, "    (config).CNT_%s = %s_CNT_%s;\\\n", label, name, label);
+            return;
+        }
+    }
+    fprintf(f, "    (config).CNT_%s = 0;\\\n", label);
+}
+
+static void write_array_config(FILE *f, const char *name, uint16_t index) {
+    const object_t *obj = find_object(index);
+    if (obj != NULL && obj->odt == ODT_ARR_) {
+        fprintf(f, "    (config).CNT_ARR_%04X = %s_CNT_ARR_%04X;\\\n", (unsigned)index, name, (unsigned)index);
+    } else {
+        fprintf(f, "    (config).CNT_ARR_%04X = 0;\\\n", (unsigned)index);
+    }
+}
+
+static int write_od_header(const char *path, const char *name) {
+    FILE *f = fopen(path, "w");
+    char guard[NAME_MAX_LEN + 3];
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    upper(guard, sizeof(guard), name);
+    strncat(guard, "_H", sizeof(guard) - strlen(guard) - 1);
+
+    fprintf(f, "/*******************************************************************************\n");
+    fprintf(f, "    CANopen Object Dictionary definition for CANopenNode V4\n\n");
+    fprintf(f, "    This file was automatically generated by eds2od from %s\n\n", base_name(eds_path));
+    fprintf(f, "    DON'T EDIT THIS FILE MANUALLY !!!!\n");
+    fprintf(f, "*******************************************************************************/\n\n");
+    fprintf(f, "#ifndef %s\n#define %s\n", guard, guard);
+
+    header_comment(f, "Counters of OD objects");
+    for (size_t c = 0; c < sizeof(count_labels) / sizeof(count_labels[0]); c++) {
+        uint32_t count = count_range(count_labels[c].first, count_labels[c].last);
+        if (count > 0) {
+            fprintf(f, "#define %s_CNT_%s %u\n", name, count_labels[c].label, (unsigned)count);
+        }
+    }
+    fprintf(f, "\n\n");
+
+    header_comment(f, "Sizes of OD arrays");
+    for (uint32_t i = 0; i < object_count; i++) {
+        if (objects[i].odt == ODT_ARR_) {
+            fprintf(f, "#define %s_CNT_ARR_%04X %u\n", name, (unsigned)objects[i].index,
+                    (unsigned)(objects[i].sub_count - 1));
+        }
+    }
+    fprintf(f, "\n\n");
+
+    header_comment(f, "OD data declaration of all groups");
+    for (uint32_t g = 0; g < group_count; g++) {
+        fprintf(f, "typedef struct {\n");
+        for (uint32_t i = 0; i < object_count; i++) {
+            const object_t *obj = &objects[i];
+            const char *type;
+            uint32_t length;
+            char suffix[16];
+
+            if (strcmp(obj->group, groups[g]) != 0) {
+                continue;
+            }
+            if (obj->odt == ODT_VAR_) {
+                sub_data(&obj->subs[0], &type, &length, suffix, sizeof(suffix));
+                if (type != NULL) {
+                    fprintf(f, "    %s x%04X_%s%s;\n", type, (unsigned)obj->index, obj->cname, suffix);
+                }
+            } else if (obj->odt == ODT_ARR_) {
+                sub_data(&obj->subs[0], &type, &length, suffix, sizeof(suffix));
+                fprintf(f, "    %s x%04X_%s_sub0;\n", type, (unsigned)obj->index, obj->cname);
+                sub_data(&obj->subs[1], &type, &length, suffix, sizeof(suffix));
+                if (type != NULL) {
+                    fprintf(f, "    %s x%04X_%s[%s_CNT_ARR_%04X]%s;\n", type, (unsigned)obj->index, obj->cname, name,
+                            (unsigned)obj->index, suffix);
+                }
+            } else {
+                fprintf(f, "    struct {\n");
+                for (uint16_t s = 0; s < obj->sub_count; s++) {
+                    sub_data(&obj->subs[s], &type, &length, suffix, sizeof(suffix));
+                    if (type != NULL) {
+                        fprintf(f, "        %s %s%s;\n", type, obj->subs[s].member, suffix);
+                    }
+                }
+                fprintf(f, "    } x%04X_%s;\n", (unsigned)obj->index, obj->cname);
+            }
+        }
+        fprintf(f, "} %s_%s_t;\n\n", name, groups[g]);
+    }
+
+    for (uint32_t g = 0; g < group_count; g++) {
+        fprintf(f, "#ifndef %s_ATTR_%s\n#define %s_ATTR_%s\n#endif\n", name, groups[g], name, groups[g]);
+        fprintf(f, "extern %s_ATTR_%s %s_%s_t %s_%s;\n\n", name, groups[g], name, groups[g], name, groups[g]);
+    }
+    fprintf(f, "#ifndef %s_ATTR_OD\n#define %s_ATTR_OD\n#endif\n", name, name);
+    fprintf(f, "extern %s_ATTR_OD OD_t *%s;\n\n\n", name, name);
+
+    header_comment(f, "Object dictionary entries - shortcuts");
+    for (uint32_t i = 0; i < object_count; i++) {
+        fprintf(f, "#define %s_ENTRY_H%04X &%s->list[%u]\n", name, (unsigned)objects[i].index, name, (unsigned)i);
+    }
+    fprintf(f, "\n\n");
+
+    header_comment(f, "Object dictionary entries - shortcuts with names");
+    for (uint32_t i = 0; i < object_count; i++) {
+        fprintf(f, "#define %s_ENTRY_H%04X_%s &%s->list[%u]\n", name, (unsigned)objects[i].index, objects[i].cname,
+                name, (unsigned)i);
+    }
+    fprintf(f, "\n\n");
+
+    header_comment(f, "OD config structure");
+    fprintf(f, "#ifdef CO_MULTIPLE_OD\n");
+    fprintf(f, "#define %s_INIT_CONFIG(config) {\\\n", name);
+    write_count_config(f, name, "NMT");
+    write_entry_config(f, name, "ENTRY_H1017", 0x1017);
+    write_count_config(f, name, "HB_CONS");
+    write_array_config(f, name, 0x1016);
+    write_entry_config(f, name, "ENTRY_H1016", 0x1016);
+    write_entry_config(f, name, "ENTRY_H100C", 0x100C);
+    write_entry_config(f, name, "ENTRY_H100D", 0x100D);
+    write_count_config(f, name, "EM");
+    write_entry_config(f, name, "ENTRY_H1001", 0x1001);
+    write_entry_config(f, name, "ENTRY_H1014", 0x1014);
+    write_entry_config(f, name, "ENTRY_H1015", 0x1015);
+    write_array_config(f, name, 0x1003);
+    write_entry_config(f, name, "ENTRY_H1003", 0x1003);
+    write_count_config(f, name, "SDO_SRV");
+    write_entry_config(f, name, "ENTRY_H1200", 0x1200);
+    write_count_config(f, name, "SDO_CLI");
+    write_entry_config(f, name, "ENTRY_H1280", 0x1280);
+    write_count_config(f, name, "TIME");
+    write_entry_config(f, name, "ENTRY_H1012", 0x1012);
+    write_count_config(f, name, "SYNC");
+    write_entry_config(f, name, "ENTRY_H1005", 0x1005);
+    write_entry_config(f, name, "ENTRY_H1006", 0x1006);
+    write_entry_config(f, name, "ENTRY_H1007", 0x1007);
+    write_entry_config(f, name, "ENTRY_H1019", 0x1019);
+    write_count_config(f, name, "RPDO");
+    write_entry_config(f, name, "ENTRY_H1400", 0x1400);
+    write_entry_config(f, name, "ENTRY_H1600", 0x1600);
+    write_count_config(f, name, "TPDO");
+    write_entry_config(f, name, "ENTRY_H1800", 0x1800);
+    write_entry_config(f, name, "ENTRY_H1A00", 0x1A00);
+    fprintf(f, "    (config).CNT_LEDS = 0;\\\n");
+    fprintf(f, "    (config).CNT_GFC = 0;\\\n");
+    fprintf(f, "    (config).ENTRY_H1300 = NULL;\\\n");
+    fprintf(f, "    (config).CNT_SRDO = 0;\\\n");
+    fprintf(f, "    (config).ENTRY_H1301 = NULL;\\\n");
+    fprintf(f, "    (config).ENTRY_H1381 = NULL;\\\n");
+    fprintf(f, "    (config).ENTRY_H13FE = NULL;\\\n");
+    fprintf(f, "    (config).ENTRY_H13FF = NULL;\\\n");
+    fprintf(f, "    (config).CNT_LSS_SLV = 0;\\\n");
+    fprintf(f, "    (config).CNT_LSS_MST = 0;\\\n");
+    fprintf(f, "    (config).CNT_GTWA = 0;\\\n");
+    fprintf(f, "    (config).CNT_GTWB = 0;\\\n");
+    fprintf(f, "    (config).CNT_TRACE = 0;\\\n");
+    fprintf(f, "}\n#endif\n\n");
+    fprintf(f, "#endif /* %s */\n", guard);
+    return fclose(f);
+}
+
+/* Initializer of one group */
+static void write_group_data(FILE *f, const char *name, const char *group) {
+    char value[1024];
+    int first = 1;
+
+    fprintf(f, "%s_ATTR_%s %s_%s_t %s_%s = {\n", name, group, name, group, name, group);
+    for (uint32_t i = 0; i < object_count; i++) {
+        const object_t *obj = &objects[i];
+        const char *type;
+        uint32_t length;
+        char suffix[16];
+
+        if (strcmp(obj->group, group) != 0) {
+            continue;
+        }
+        if (obj->odt == ODT_VAR_) {
+            sub_data(&obj->subs[0], &type, &length, suffix, sizeof(suffix));
+            if (type == NULL) {
+                continue;
+            }
+            default_value(&obj->subs[0], value, sizeof(value));
+            fprintf(f, "%s    .x%04X_%s = %s", first ? "" : ",\n", (unsigned)obj->index, obj->cname, value);
+        } else if (obj->odt == ODT_ARR_) {
+            default_value(&obj->subs[0], value, sizeof(value));
+            fprintf(f, "%s    .x%04X_%s_sub0 = %s", first ? "" : ",\n", (unsigned)obj->index, obj->cname, value);
+            sub_data(&obj->subs[1], &type, &length, suffix, sizeof(suffix));
+            if (type != NULL) {
+                fprintf(f, ",\n    .x%04X_%s = {", (unsigned)obj->index, obj->cname);
+                for (uint16_t s = 1; s < obj->sub_count; s++) {
+                    default_value(&obj->subs[s], value, sizeof(value));
+                    fprintf(f, "%s%s", s > 1 ? ", " : "", value);
+                }
+                fprintf(f, "}");
+            }
+        } else {
+            int first_member = 1;
+            fprintf(f, "%s    .x%04X_%s = {\n", first ? "" : ",\n", (unsigned)obj->index, obj->cname);
+            for (uint16_t s = 0; s < obj->sub_count; s++) {
+                sub_data(&obj->subs[s], &type, &length, suffix, sizeof(suffix));
+                if (type == NULL) {
+                    continue;
+                }
+                default_value(&obj->subs[s], value, sizeof(value));
+                fprintf(f, "%s        .%s = %s", first_member ? "" : ",\n", obj->subs[s].member, value);
+                first_member = 0;
+            }
+            fprintf(f, "\n    }");
+        }
+        first = 0;
+    }
+    fprintf(f, "\n};\n\n");
+}
+
+/* Address of the sub-entry data as C expression */
+static void data_address(const object_t *obj, const sub_t *sub, const char *name, char *out, size_t out_size) {
+    const char *type;
+    uint32_t length;
+    char suffix[16];
+
+    sub_data(sub, &type, &length, suffix, sizeof(suffix));
+    if (type == NULL) {
+        snprintf(out, out_size, "NULL");
+    } else if (obj->odt == ODT_VAR_) {
+        snprintf(out, out_size, "&%s_%s.x%04X_%s%s", name, obj->group, (unsigned)obj->index, obj->cname,
+                 suffix[0] ? "[0]" : "");
+    } else {
+        snprintf(out, out_size, "&%s_%s.x%04X_%s.%s%s", name, obj->group, (unsigned)obj->index, obj->cname,
+                 sub->member, suffix[0] ? "[0]" : "");
+    }
+}
+
+static int write_od_source(const char *path, const char *name, const char *header_name) {
+    FILE *f = fopen(path, "w");
+    char attribute[64];
+    char address[256];
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "/*******************************************************************************\n");
+    fprintf(f, "    CANopen Object Dictionary definition for CANopenNode V4\n\n");
+    fprintf(f, "    This file was automatically generated by eds2od from %s\n\n", base_name(eds_path));
+    fprintf(f, "    DON'T EDIT THIS FILE MANUALLY !!!!\n");
+    fprintf(f, "*******************************************************************************/\n\n");
+    fprintf(f, "#define OD_DEFINITION\n");
+    fprintf(f, "#include \"301/CO_ODinterface.h\"\n");
+    fprintf(f, "#include \"%s\"\n\n", header_name);
+    fprintf(f, "#if CO_VERSION_MAJOR < 4\n");
+    fprintf(f, "#error This Object dictionary is compatible with CANopenNode V4.0 and above!\n");
+    fprintf(f, "#endif\n\n");
+
+    header_comment(f, "OD data initialization of all groups");
+    for (uint32_t g = 0; g < group_count; g++) {
+        write_group_data(f, name, groups[g]);
+    }
+    fprintf(f, "\n\n");
+
+    header_comment(f, "All OD objects (constant definitions)");
+    fprintf(f, "typedef struct {\n");
+    for (uint32_t i = 0; i < object_count; i++) {
+        const object_t *obj = &objects[i];
+        if (obj->odt == ODT_VAR_) {
+            fprintf(f, "    OD_obj_var_t o_%04X_%s;\n", (unsigned)obj->index, obj->cname);
+        } else if (obj->odt == ODT_ARR_) {
+            fprintf(f, "    OD_obj_array_t o_%04X_%s;\n", (unsigned)obj->index, obj->cname);
+        } else {
+            fprintf(f, "    OD_obj_record_t o_%04X_%s[%u];\n", (unsigned)obj->index, obj->cname,
+                    (unsigned)obj->sub_count);
+        }
+    }
+    fprintf(f, "} %s_Objs_t;\n\n", name);
+
+    fprintf(f, "static CO_PROGMEM %s_Objs_t %s_Objs = {\n", name, name);
+    for (uint32_t i = 0; i < object_count; i++) {
+        const object_t *obj = &objects[i];
+        const char *type;
+        uint32_t length;
+        char suffix[16];
+
+        fprintf(f, "    .o_%04X_%s = {\n", (unsigned)obj->index, obj->cname);
+        if (obj->odt == ODT_VAR_) {
+            sub_data(&obj->subs[0], &type, &length, suffix, sizeof(suffix));
+            data_address(obj, &obj->subs[0], name, address, sizeof(address));
+            sub_attribute_bits(&obj->subs[0], attribute, sizeof(attribute));
+            fprintf(f, "        .dataOrig = %s,\n", address);
+            fprintf(f, "        .attribute = %s,\n", attribute);
+            fprintf(f, "        .dataLength = %u\n", (unsigned)length);
+        } else if (obj->odt == ODT_ARR_) {
+            sub_data(&obj->subs[1], &type, &length, suffix, sizeof(suffix));
+            fprintf(f, "        .dataOrig0 = &%s_%s.x%04X_%s_sub0,\n", name, obj->group, (unsigned)obj->index,
+                    obj->cname);
+            if (type != NULL) {
+                fprintf(f, "        .dataOrig = &%s_%s.x%04X_%s[0]%s,\n", name, obj->group, (unsigned)obj->index,
+                        obj->cname, suffix[0] ? "[0]" : "");
+            } else {
+                fprintf(f, "        .dataOrig = NULL,\n");
+            }
+            sub_attribute_bits(&obj->subs[0], attribute, sizeof(attribute));
+            fprintf(f, "        .attribute0 = %s,\n", attribute);
+            sub_attribute_bits(&obj->subs[1], attribute, sizeof(attribute));
+            fprintf(f, "        .attribute = %s,\n", attribute);
+            fprintf(f, "        .dataElementLength = %u,\n", (unsigned)length);
+            if (type != NULL) {
+                fprintf(f, "        .dataElementSizeof = sizeof(%s%s)\n", type, suffix);
+            } else {
+                fprintf(f, "        .dataElementSizeof = 0\n");
+            }
+        } else {
+            for (uint16_t s = 0; s < obj->sub_count; s++) {
+                const sub_t *sub = &obj->subs[s];
+                sub_data(sub, &type, &length, suffix, sizeof(suffix));
+                data_address(obj, sub, name, address, sizeof(address));
+                sub_attribute_bits(sub, attribute, sizeof(attribute));
+                fprintf(f, "        {\n");
+                fprintf(f, "            .dataOrig = %s,\n", address);
+                fprintf(f, "            .subIndex = %u,\n", (unsigned)sub->subindex);
+                fprintf(f, "            .attribute = %s,\n", attribute);
+                fprintf(f, "            .dataLength = %u\n", (unsigned)length);
+                fprintf(f, "        }%s\n", (s + 1U < obj->sub_count) ? "," : "");
+            }
+        }
+        fprintf(f, "    }%s\n", (i + 1U < object_count) ? "," : "");
+    }
+    fprintf(f, "};\n\n\n");
+
+    static const char *odt_names[] = {"ODT_VAR", "ODT_ARR", "ODT_REC"};
+    header_comment(f, "Object dictionary");
+    fprintf(f, "static %s_ATTR_OD OD_entry_t %s_List[] = {\n", name, name);
+    for (uint32_t i = 0; i < object_count; i++) {
+        const object_t *obj = &objects[i];
+        fprintf(f, "    {0x%04X, 0x%02X, %s, &%s_Objs.o_%04X_%s, NULL},\n", (unsigned)obj->index,
+                (unsigned)(obj->odt == ODT_VAR_ ? 1U : obj->sub_count), odt_names[obj->odt], name,
+                (unsigned)obj->index, obj->cname);
+    }
+    fprintf(f, "    {0x0000, 0x00, 0, NULL, NULL}\n};\n\n");
+    fprintf(f, "static OD_t _%s = {\n", name);
+    fprintf(f, "    (sizeof(%s_List) / sizeof(%s_List[0])) - 1,\n", name, name);
+    fprintf(f, "    &%s_List[0]\n};\n\n", name);
+    fprintf(f, "OD_t *%s = &_%s;\n", name, name);
+    return fclose(f);
+}
+
+/* Object table of the remote device, see eds_index.h */
+static int write_remote_header(const char *path, const char *name) {
+    FILE *f = fopen(path, "w");
+    char upper_name[NAME_MAX_LEN];
+    uint32_t count = 0;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    upper(upper_name, sizeof(upper_name), name);
+    for (uint32_t i = 0; i < object_count; i++) {
+        count += objects[i].sub_count;
+    }
+
+    fprintf(f, "/* Object table of %s, generated by eds2od, do not edit */\n\n", base_name(eds_path));
+    fprintf(f, "#ifndef %s_H\n#define %s_H\n\n", upper_name, upper_name);
+    fprintf(f, "#include \"eds_index.h\"\n\n");
+    fprintf(f, "/* Number of objects with data (VAR and sub-entries) */\n");
+    fprintf(f, "#define %s_COUNT %uU\n\n", upper_name, (unsigned)count);
+    fprintf(f, "/* Objects sorted by index and subindex, use with eds_index_from_table() */\n");
+    fprintf(f, "extern const eds_object_t %s_objects[%s_COUNT];\n\n", name, upper_name);
+    fprintf(f, "/* Size in bytes (0 for variable length) and data type of each object */\n");
+    for (uint32_t i = 0; i < object_count; i++) {
+        const object_t *obj = &objects[i];
+        for (uint16_t s = 0; s < obj->sub_count; s++) {
+            const sub_t *sub = &obj->subs[s];
+            fprintf(f, "#define %s_%04X_%02X_SIZE %uU\n", upper_name, (unsigned)obj->index, (unsigned)sub->subindex,
+                    (unsigned)eds_data_type_size(sub->data_type));
+            fprintf(f, "#define %s_%04X_%02X_TYPE 0x%04XU\n", upper_name, (unsigned)obj->index,
+                    (unsigned)sub->subindex, (unsigned)sub->data_type);
+        }
+    }
+    fprintf(f, "\n#endif // %s_H\n", upper_name);
+    return fclose(f);
+}
+
+static int write_remote_source(const char *path, const char *name, const char *header_name) {
+    FILE *f = fopen(path, "w");
+    char upper_name[NAME_MAX_LEN];
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    upper(upper_name, sizeof(upper_name), name);
+
+    fprintf(f, "/* Object table of %s, generated by eds2od, do not edit */\n\n", base_name(eds_path));
+    fprintf(f, "#include \"%s\"\n\n", header_name);
+    fprintf(f, "const eds_object_t %s_objects[%s_COUNT] = {\n", name, upper_name);
+    for (uint32_t i = 0; i < object_count; i++) {
+        const object_t *obj = &objects[i];
+        for (uint16_t s = 0; s < obj->sub_count; s++) {
+            const sub_t *sub = &obj->subs[s];
+            char escaped[2 * sizeof(((eds_object_t *)0)->name)];
+            size_t n = 0;
+            // name is truncated to the size in eds_object_t, the same as in the parser of eds_index.c
+            for (size_t c = 0; sub->name[c] != 0 && c + 1 < sizeof(((eds_object_t *)0)->name); c++) {
+                if (sub->name[c] == '"' || sub->name[c] == '\\') {
+                    escaped[n++] = '\\';
+                }
+                escaped[n++] = sub->name[c];
+            }
+            escaped[n] = 0;
+            fprintf(f, "    {0x%04X, 0x%02X, 0x7, 0x%04X, %u, 0x%02X, %u, 0, %lldLL, %lldLL, %lldLL, \"%s\"},\n",
+                    (unsigned)obj->index, (unsigned)sub->subindex, (unsigned)sub->data_type, (unsigned)sub->access, (unsigned)sub->flags,
+                    (unsigned)eds_data_type_size(sub->data_type), (long long)sub->default_value,
+                    (long long)sub->low_limit, (long long)sub->high_limit, escaped);
+        }
+    }
+    fprintf(f, "};\n");
+    return fclose(f);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 6 || (strcmp(argv[1], "od") != 0 && strcmp(argv[1], "remote") != 0)) {
+        fprintf(stderr, "Usage: %s od|remote <file.eds> <name> <name.c> <name.h>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    eds_path = argv[2];
+    const char *name = argv[3];
+    for (const char *p = name; *p != 0; p++) {
+        if (!isalnum((unsigned char)*p) && *p != '_') {
+            fprintf(stderr, "eds2od: name must be a C identifier: %s\n", name);
+            return EXIT_FAILURE;
+        }
+    }
+    if (strlen(name) > NAME_MAX_LEN - 8) {
+        fprintf(stderr, "eds2od: name is too long: %s\n", name);
+        return EXIT_FAILURE;
+    }
+
+    parse_eds();
+    finish_objects();
+    verify_types();
+
+    int err;
+    if (strcmp(argv[1], "od") == 0) {
+        collect_groups();
+        err = write_od_source(argv[4], name, base_name(argv[5])) != 0 || write_od_header(argv[5], name) != 0;
+    } else {
+        err = write_remote_source(argv[4], name, base_name(argv[5])) != 0 || write_remote_header(argv[5], name) != 0;
+    }
+    if (err) {
+        return EXIT_FAILURE;
+    }
+    printf("eds2od: %u objects from %s\n", (unsigned)object_count, eds_path);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,393 @@
+/*
+ * author: ZeroErr Inc.
+ * EDS object index with binary cache, see eds_index.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eds_index.h"
+
+#define EDS_CACHE_SUFFIX ".idx"
+#define EDS_CACHE_MAGIC 0x49534445  // "EDSI"
+#define EDS_CACHE_VERSION 1
+
+// Header of the binary cache, followed by count eds_object_t entries
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_size;     // sizeof(eds_object_t), cache of a different build is rejected
+    uint32_t count;
+    uint32_t reserved;
+    int64_t eds_mtime_ns;    // Modification time and size of the parsed EDS
+    int64_t eds_size;
+} eds_cache_header_t;
+
+/* Size of the CANopen basic data type in bytes */
+uint8_t eds_data_type_size(uint16_t data_type) {
+    switch (data_type) {
+        case 0x0001: return 1;  // BOOLEAN
+        case 0x0002: return 1;  // INTEGER8
+        case 0x0003: return 2;  // INTEGER16
+        case 0x0004: return 4;  // INTEGER32
+        case 0x0005: return 1;  // UNSIGNED8
+        case 0x0006: return 2;  // UNSIGNED16
+        case 0x0007: return 4;  // UNSIGNED32
+        case 0x0008: return 4;  // REAL32
+        case 0x000F: return 0;  // DOMAIN
+        case 0x0010: return 3;  // INTEGER24
+        case 0x0011: return 8;  // REAL64
+        case 0x0012: return 5;  // INTEGER40
+        case 0x0013: return 6;  // INTEGER48
+        case 0x0014: return 7;  // INTEGER56
+        case 0x0015: return 8;  // INTEGER64
+        case 0x0016: return 3;  // UNSIGNED24
+        case 0x0018: return 5;  // UNSIGNED40
+        case 0x0019: return 6;  // UNSIGNED48
+        case 0x001A: return 7;  // UNSIGNED56
+        case 0x001B: return 8;  // UNSIGNED64
+        default: return 0;      // Strings and unknown types
+    }
+}
+
+const char *eds_access_name(uint8_t access) {
+    switch (access) {
+        case EDS_ACCESS_RO: return "ro";
+        case EDS_ACCESS_WO: return "wo";
+        case EDS_ACCESS_RW: return "rw";
+        case EDS_ACCESS_RWR: return "rwr";
+        case EDS_ACCESS_RWW: return "rww";
+        case EDS_ACCESS_CONST: return "const";
+        default: return "?";
+    }
+}
+
+static uint8_t parse_access(const char *value) {
+    if (strcasecmp(value, "ro") == 0) return EDS_ACCESS_RO;
+    if (strcasecmp(value, "wo") == 0) return EDS_ACCESS_WO;
+    if (strcasecmp(value, "rw") == 0) return EDS_ACCESS_RW;
+    if (strcasecmp(value, "rwr") == 0) return EDS_ACCESS_RWR;
+    if (strcasecmp(value, "rww") == 0) return EDS_ACCESS_RWW;
+    if (strcasecmp(value, "const") == 0) return EDS_ACCESS_CONST;
+    return EDS_ACCESS_UNKNOWN;
+}
+
+/* Parse integer value: decimal, 0x hex, negative or "$NODEID+value". Return 0 if value is empty or invalid. */
+static int parse_number(const char *value, int64_t *number, int *nodeid_relative) {
+    char *end;
+
+    *nodeid_relative = 0;
+    if (strncasecmp(value, "$NODEID", 7) == 0) {
+        *nodeid_relative = 1;
+        value += 7;
+        while (*value == ' ' || *value == '+') {
+            value++;
+        }
+        if (*value == 0) {
+            *number = 0;
+            return 1;
+        }
+    }
+    if (*value == 0) {
+        return 0;
+    }
+    if (*value == '-') {
+        *number = strtoll(value, &end, 0);
+    } else {
+        *number = (int64_t)strtoull(value, &end, 0);
+    }
+    return end != value;
+}
+
+/* Modification time in nanoseconds, EDS may be edited within the same second as the cache was written */
+static int64_t mtime_ns(const struct stat *st) {
+    return (int64_t)st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+}
+
+static int compare_objects(const void *a, const void *b) {
+    const eds_object_t *oa = a;
+    const eds_object_t *ob = b;
+    uint32_t ka = ((uint32_t)oa->index << 8) | oa->subindex;
+    uint32_t kb = ((uint32_t)ob->index << 8) | ob->subindex;
+    return (ka > kb) - (ka < kb);
+}
+
+/* Append current section to the array, if it describes data (has DataType) */
+static int add_object(eds_object_t **objects, uint32_t *count, uint32_t *capacity, const eds_object_t *obj,
+                      int has_data_type) {
+    if (!has_data_type) {
+        return 0;  // ARRAY/RECORD header or section without data
+    }
+    if (*count == *capacity) {
+        uint32_t new_capacity = *capacity ? *capacity * 2 : 256;
+        eds_object_t *p = realloc(*objects, new_capacity * sizeof(eds_object_t));
+        if (p == NULL) {
+            return -1;
+        }
+        *objects = p;
+        *capacity = new_capacity;
+    }
+    (*objects)[(*count)++] = *obj;
+    return 0;
+}
+
+/* Parse all object sections ([xxxx] and [xxxxsubN]) of the EDS file */
+static int parse_eds(eds_index_t *idx, const char *eds_path) {
+    FILE *file = fopen(eds_path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    eds_object_t *objects = NULL;
+    uint32_t count = 0;
+    uint32_t capacity = 0;
+    eds_object_t obj;
+    int in_object = 0;
+    int has_data_type = 0;
+    char line[512];
+    int err = 0;
+
+    while (!err && fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n;")] = 0;
+
+        if (line[0] == '[') {
+            if (in_object) {
+                err = add_object(&objects, &count, &capacity, &obj, has_data_type);
+            }
+            in_object = 0;
+
+            // Object sections are "[1018]" and "[1018sub1]", other sections are skipped
+            char *end_bracket = strchr(line, ']');
+            unsigned int index, subindex = 0;
+            char tail[8] = "";
+            if (end_bracket == NULL) {
+                continue;
+            }
+            *end_bracket = 0;
+            if (strlen(line + 1) < 4 || !isxdigit((unsigned char)line[1])) {
+                continue;
+            }
+            if (sscanf(line + 1, "%4x%7s", &index, tail) >= 1) {
+                if (tail[0] != 0 && (strncasecmp(tail, "sub", 3) != 0 || sscanf(tail + 3, "%x", &subindex) != 1)) {
+                    continue;  // for example [1018Name] or [1600Value]
+                }
+                memset(&obj, 0, sizeof(obj));
+                obj.index = (uint16_t)index;
+                obj.subindex = (uint8_t)subindex;
+                obj.object_type = 0x7;
+                in_object = 1;
+                has_data_type = 0;
+            }
+            continue;
+        }
+        if (!in_object) {
+            continue;
+        }
+
+        char *eq = strchr(line, '=');
+        if (eq == NULL) {
+            continue;
+        }
+        *eq = 0;
+        char *key = line;
+        char *value = eq + 1;
+        while (*value == ' ' || *value == '\t') {
+            value++;
+        }
+        for (char *p = value + strlen(value); p > value && (p[-1] == ' ' || p[-1] == '\t'); p--) {
+            p[-1] = 0;
+        }
+
+        int64_t number;
+        int nodeid_relative;
+        if (strcasecmp(key, "ParameterName") == 0) {
+            snprintf(obj.name, sizeof(obj.name), "%s", value);
+        } else if (strcasecmp(key, "ObjectType") == 0) {
+            if (parse_number(value, &number, &nodeid_relative)) {
+                obj.object_type = (uint8_t)number;
+            }
+        } else if (strcasecmp(key, "DataType") == 0) {
+            if (parse_number(value, &number, &nodeid_relative)) {
+                obj.data_type = (uint16_t)number;
+                obj.data_size = eds_data_type_size(obj.data_type);
+                has_data_type = 1;
+            }
+        } else if (strcasecmp(key, "AccessType") == 0) {
+            obj.access = parse_access(value);
+        } else if (strcasecmp(key, "PDOMapping") == 0) {
+            if (parse_number(value, &number, &nodeid_relative) && number != 0) {
+                obj.flags |= EDS_FLAG_PDO_MAPPING;
+            }
+        } else if (strcasecmp(key, "DefaultValue") == 0) {
+            if (parse_number(value, &number, &nodeid_relative)) {
+                obj.default_value = number;
+                obj.flags |= EDS_FLAG_DEFAULT | (nodeid_relative ? EDS_FLAG_DEFAULT_NODEID : 0);
+            }
+        } else if (strcasecmp(key, "LowLimit") == 0) {
+            if (parse_number(value, &number, &nodeid_relative)) {
+                obj.low_limit = number;
+                obj.flags |= EDS_FLAG_LOW_LIMIT;
+            }
+        } else if (strcasecmp(key, "HighLimit") == 0) {
+            if (parse_number(value, &number, &nodeid_relative)) {
+                obj.high_limit = number;
+                obj.flags |= EDS_FLAG_HIGH_LIMIT;
+            }
+        }
+    }
+    if (!err && in_object) {
+        err = add_object(&objects, &count, &capacity, &obj, has_data_type);
+    }
+    fclose(file);
+
+    if (err) {
+        free(objects);
+        return -1;
+    }
+
+    qsort(objects, count, sizeof(eds_object_t), compare_objects);
+    idx->heap = objects;
+    idx->objects = objects;
+    idx->count = count;
+    idx->from_cache = 0;
+    return 0;
+}
+
+/* Write the index to the binary cache, through a temporary file, so a reader never sees a partial cache */
+static int write_cache(const eds_index_t *idx, const char *cache_path, const struct stat *eds_stat) {
+    char tmp_path[4096 + 16];
+    eds_cache_header_t header = {
+        .magic = EDS_CACHE_MAGIC,
+        .version = EDS_CACHE_VERSION,
+        .entry_size = sizeof(eds_object_t),
+        .count = idx->count,
+        .eds_mtime_ns = mtime_ns(eds_stat),
+        .eds_size = (int64_t)eds_stat->st_size
+    };
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", cache_path, (int)getpid());
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(idx->objects, sizeof(eds_object_t), idx->count, file) == idx->count;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmp_path, cache_path) != 0) {
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+/* Map the binary cache. If eds_stat is not NULL, cache must be made from that EDS. */
+static int map_cache(eds_index_t *idx, const char *cache_path, const struct stat *eds_stat) {
+    int fd = open(cache_path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat cache_stat;
+    if (fstat(fd, &cache_stat) < 0 || (size_t)cache_stat.st_size < sizeof(eds_cache_header_t)) {
+        close(fd);
+        return -1;
+    }
+    if (eds_stat != NULL && mtime_ns(&cache_stat) < mtime_ns(eds_stat)) {
+        close(fd);
+        return -1;  // EDS was modified after the cache was written
+    }
+
+    size_t size = (size_t)cache_stat.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    const eds_cache_header_t *header = map;
+    int valid = header->magic == EDS_CACHE_MAGIC && header->version == EDS_CACHE_VERSION &&
+                header->entry_size == sizeof(eds_object_t) &&
+                size == sizeof(eds_cache_header_t) + (size_t)header->count * sizeof(eds_object_t);
+    if (valid && eds_stat != NULL) {
+        valid = header->eds_mtime_ns == mtime_ns(eds_stat) && header->eds_size == (int64_t)eds_stat->st_size;
+    }
+    if (!valid) {
+        munmap(map, size);
+        return -1;
+    }
+
+    idx->map = map;
+    idx->map_size = size;
+    idx->objects = (const eds_object_t *)((const uint8_t *)map + sizeof(eds_cache_header_t));
+    idx->count = header->count;
+    idx->from_cache = 1;
+    return 0;
+}
+
+int eds_index_load(eds_index_t *idx, const char *eds_path) {
+    char cache_path[4096];
+    struct stat eds_stat;
+
+    memset(idx, 0, sizeof(*idx));
+    if (snprintf(cache_path, sizeof(cache_path), "%s%s", eds_path, EDS_CACHE_SUFFIX) >= (int)sizeof(cache_path)) {
+        return -1;
+    }
+
+    // EDS is not available: use the cache alone, if it is valid
+    if (stat(eds_path, &eds_stat) < 0) {
+        return map_cache(idx, cache_path, NULL);
+    }
+
+    if (map_cache(idx, cache_path, &eds_stat) == 0) {
+        return 0;
+    }
+    if (parse_eds(idx, eds_path) < 0) {
+        return -1;
+    }
+    if (write_cache(idx, cache_path, &eds_stat) < 0) {
+        printf("EDS cache %s not written, EDS is parsed on each start\n", cache_path);
+    }
+    return 0;
+}
+
+void eds_index_from_table(eds_index_t *idx, const eds_object_t *objects, uint32_t count) {
+    memset(idx, 0, sizeof(*idx));
+    idx->objects = objects;
+    idx->count = count;
+}
+
+const eds_object_t *eds_index_find(const eds_index_t *idx, uint16_t index, uint8_t subindex) {
+    uint32_t key = ((uint32_t)index << 8) | subindex;
+    uint32_t lo = 0;
+    uint32_t hi = idx->count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const eds_object_t *obj = &idx->objects[mid];
+        uint32_t mid_key = ((uint32_t)obj->index << 8) | obj->subindex;
+        if (mid_key == key) {
+            return obj;
+        }
+        if (mid_key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+void eds_index_free(eds_index_t *idx) {
+    if (idx->map != NULL) {
+        munmap(idx->map, idx->map_size);
+    }
+    free(idx->heap);
+    memset(idx, 0, sizeof(*idx));
+}
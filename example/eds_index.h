@@ -0,0 +1,84 @@
+/*
+ * author: ZeroErr Inc.
+ * EDS object index with binary cache
+ *
+ * All objects of the EDS file (index, subindex, data type, access type, default value and limits) are kept in an
+ * array sorted by index and subindex, lookup is a binary search. After parsing, the array is written to a binary
+ * cache file next to the EDS ("<eds>.idx"). On next start the cache is memory-mapped instead of parsing the EDS, if
+ * it is newer than the EDS and was made from the same EDS file.
+ *
+ * For a known device the array can also be generated at build time with eds2od ("remote" mode) and used with
+ * eds_index_from_table(), without the EDS file at runtime.
+ */
+
+#ifndef EDS_INDEX_H
+#define EDS_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Access type from the EDS
+typedef enum {
+    EDS_ACCESS_UNKNOWN = 0,
+    EDS_ACCESS_RO = 1,
+    EDS_ACCESS_WO = 2,
+    EDS_ACCESS_RW = 3,
+    EDS_ACCESS_RWR = 4,    // rw, mappable to TPDO
+    EDS_ACCESS_RWW = 5,    // rw, mappable to RPDO
+    EDS_ACCESS_CONST = 6
+} eds_access_t;
+
+// Flags of eds_object_t
+#define EDS_FLAG_DEFAULT 0x01        // default_value is valid
+#define EDS_FLAG_LOW_LIMIT 0x02      // low_limit is valid
+#define EDS_FLAG_HIGH_LIMIT 0x04     // high_limit is valid
+#define EDS_FLAG_PDO_MAPPING 0x08    // object may be mapped to PDO
+#define EDS_FLAG_DEFAULT_NODEID 0x10 // default value is $NODEID + default_value
+
+// One object (VAR or sub-entry of ARRAY/RECORD) with data. Layout is stored in the binary cache.
+typedef struct {
+    uint16_t index;
+    uint8_t subindex;
+    uint8_t object_type;     // ObjectType of the section, 0x7 for VAR and sub-entries
+    uint16_t data_type;      // CANopen data type, for example 0x0007 UNSIGNED32
+    uint8_t access;          // eds_access_t
+    uint8_t flags;           // EDS_FLAG_xxx
+    uint32_t data_size;      // Size in bytes, 0 for variable length types (strings, domain)
+    uint32_t reserved;
+    int64_t default_value;
+    int64_t low_limit;
+    int64_t high_limit;
+    char name[48];           // ParameterName, truncated
+} eds_object_t;
+
+// Object index, objects are sorted by index and subindex
+typedef struct {
+    const eds_object_t *objects;
+    uint32_t count;
+    int from_cache;          // 1: objects are mapped from the binary cache, 0: parsed from the EDS
+    void *map;               // Mapped cache file or NULL
+    size_t map_size;
+    eds_object_t *heap;      // Parsed objects or NULL
+} eds_index_t;
+
+/* Load objects from the binary cache or, if it is missing or older than the EDS, parse the EDS and write the cache.
+ * Return 0 on success, -1 if neither the EDS nor a valid cache can be read. */
+int eds_index_load(eds_index_t *idx, const char *eds_path);
+
+/* Use a table generated at build time by eds2od, objects must be sorted by index and subindex. Table is not copied,
+ * eds_index_free() is optional. */
+void eds_index_from_table(eds_index_t *idx, const eds_object_t *objects, uint32_t count);
+
+/* Find object, return NULL if it is not in the EDS */
+const eds_object_t *eds_index_find(const eds_index_t *idx, uint16_t index, uint8_t subindex);
+
+/* Release memory or mapping of the index */
+void eds_index_free(eds_index_t *idx);
+
+/* Size of the CANopen basic data type in bytes, 0 for variable length or unknown types */
+uint8_t eds_data_type_size(uint16_t data_type);
+
+/* Name of the access type, for printing */
+const char *eds_access_name(uint8_t access);
+
+#endif // EDS_INDEX_H
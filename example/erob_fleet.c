@@ -0,0 +1,155 @@
+/*
+ * author: ZeroErr Inc.
+ * eRob fleet simulator: many simulated eRob drives (erob_sim.h) on one CAN interface, for load testing of masters
+ *
+ * Nodes behave as eRob drives: SDO server with the objects of the EDS, heartbeat, EMCY, CiA402 state machine and PP
+ * or CSP motion. Run it on vcan together with quick_scan, multi_axis_control, pp_mode_control or the gateway, to
+ * test them at full bus size without real drives. Once per second a summary is printed: number of nodes in each
+ * CiA402 state, failed nodes (CAN initialization), nodes in NMT operational, processing passes, SYNCs and faults.
+ *
+ * Usage: erob_fleet [-i <interface>] [-n <nodes>] [-s <first node-id>] [-t <threads>] [-c <cpu>] [-p <priority>]
+ *                   [-H <heartbeat ms>] [-k <tick us>] [-e <fault period ms>] [-d <seconds>]
+ *
+ * Example: sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+ *          ./erob_fleet -n 50 -s 2 &
+ *          ./multi_axis_control ...
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "erob_sim.h"
+
+static volatile sig_atomic_t end_program = 0;
+
+static void sig_handler(int sig) {
+    (void)sig;
+    end_program = 1;
+}
+
+static uint64_t time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U;
+}
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("Simulated eRob drives on one CAN interface.\n\n");
+    printf("Options:\n");
+    printf("  -i <interface>     CAN interface (default: vcan0)\n");
+    printf("  -n <nodes>         number of simulated drives (default: 8)\n");
+    printf("  -s <node-id>       node-id of the first drive, others follow (default: 2)\n");
+    printf("  -t <threads>       number of shared processing threads (default: 1)\n");
+    printf("  -c <cpu>           CPU core of the first thread, next threads use next cores (default: none)\n");
+    printf("  -p <priority>      SCHED_FIFO priority of the threads (default: normal scheduling)\n");
+    printf("  -H <ms>            producer heartbeat time (default: %d)\n", EROB_SIM_HEARTBEAT_MS);
+    printf("  -k <us>            motion tick in PP mode (default: %d)\n", EROB_SIM_TICK_US);
+    printf("  -e <ms>            inject a fault into a random drive with this period (default: off)\n");
+    printf("  -d <seconds>       run time (default: until Ctrl+C)\n");
+    printf("  -h                 this help\n");
+}
+
+static void print_summary(erob_sim_t *sim, uint64_t *loops_prev, double elapsed_s) {
+    unsigned states[CIA402_UNKNOWN + 1] = {0};
+    unsigned operational = 0;
+    unsigned failed = 0;
+    uint64_t loops = 0;
+    uint64_t syncs = 0;
+    uint64_t faults = 0;
+
+    for (uint8_t i = 0; i < sim->config.node_count; i++) {
+        erob_sim_status_t st;
+        if (!erob_sim_status(sim, (uint8_t)(sim->config.first_node_id + i), &st)) continue;
+        states[st.state <= CIA402_UNKNOWN ? st.state : CIA402_UNKNOWN]++;
+        if (st.network_state == CO_NETWORK_ERROR) failed++;
+        if (st.nmt_state == CO_NMT_OPERATIONAL) operational++;
+        loops += st.loops;
+        syncs += st.sync_count;
+        faults += st.faults;
+    }
+
+    printf("%u nodes, %u failed, %u operational, %.0f passes/s, %llu SYNC, %llu faults |",
+           (unsigned)sim->config.node_count, failed, operational,
+           elapsed_s > 0.0 ? (double)(loops - *loops_prev) / elapsed_s : 0.0, (unsigned long long)syncs,
+           (unsigned long long)faults);
+    for (int s = 0; s <= CIA402_UNKNOWN; s++) {
+        if (states[s] > 0) printf(" %s: %u,", cia402_state_name((cia402_state_t)s), states[s]);
+    }
+    printf("\n");
+    fflush(stdout);
+    *loops_prev = loops;
+}
+
+int main(int argc, char *argv[]) {
+    erob_sim_config_t config = {
+        .ifname = "vcan0",
+        .first_node_id = 2,
+        .node_count = 8,
+        .thread_count = 1,
+        .cpu = -1,
+        .priority = 0,
+    };
+    uint32_t fault_period_ms = 0;
+    uint32_t duration_s = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:n:s:t:c:p:H:k:e:d:h")) != -1) {
+        switch (opt) {
+            case 'i': config.ifname = optarg; break;
+            case 'n': config.node_count = (uint8_t)strtoul(optarg, NULL, 0); break;
+            case 's': config.first_node_id = (uint8_t)strtoul(optarg, NULL, 0); break;
+            case 't': config.thread_count = (uint8_t)strtoul(optarg, NULL, 0); break;
+            case 'c': config.cpu = (int)strtol(optarg, NULL, 0); break;
+            case 'p': config.priority = (int)strtol(optarg, NULL, 0); break;
+            case 'H': config.heartbeat_ms = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 'k': config.tick_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'e': fault_period_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'd': duration_s = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'h': print_usage(argv[0]); return EXIT_SUCCESS;
+            default: print_usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    signal(SIGINT, sig_handler);
+    signal(SIGTERM, sig_handler);
+
+    erob_sim_t sim;
+    CO_ReturnError_t err = erob_sim_start(&sim, &config);
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "Error: simulator start failed (%d), check interface %s and node-ids %u..%u\n", err,
+                config.ifname, config.first_node_id, config.first_node_id + config.node_count - 1U);
+        return EXIT_FAILURE;
+    }
+    printf("eRob fleet: %u drives, node-id %u..%u on %s, %u thread(s)\n", config.node_count, config.first_node_id,
+           config.first_node_id + config.node_count - 1U, config.ifname,
+           config.thread_count > 0 ? config.thread_count : 1U);
+
+    uint64_t start = time_ms();
+    uint64_t last_print = start;
+    uint64_t last_fault = start;
+    uint64_t loops_prev = 0;
+    srand((unsigned)start);
+
+    while (!end_program && (duration_s == 0 || time_ms() - start < (uint64_t)duration_s * 1000U)) {
+        usleep(10000);
+        uint64_t now = time_ms();
+
+        if (fault_period_ms > 0 && now - last_fault >= fault_period_ms) {
+            uint8_t node_id = (uint8_t)(config.first_node_id + (unsigned)rand() % config.node_count);
+            (void)erob_sim_fault(&sim, node_id, EROB_SIM_EMC_INJECTED);
+            last_fault = now;
+        }
+        if (now - last_print >= 1000) {
+            print_summary(&sim, &loops_prev, (double)(now - last_print) / 1000.0);
+            last_print = now;
+        }
+    }
+
+    erob_sim_stop(&sim);
+    return EXIT_SUCCESS;
+}
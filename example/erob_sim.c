@@ -0,0 +1,562 @@
+/*
+ * author: ZeroErr Inc.
+ * In-process eRob drive simulator, see erob_sim.h
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "erob_sim.h"
+#include "OD_erob.h"
+
+// statusword bits
+#define SW_READY_TO_SWITCH_ON 0x0001
+#define SW_SWITCHED_ON        0x0002
+#define SW_OPERATION_ENABLED  0x0004
+#define SW_FAULT              0x0008
+#define SW_VOLTAGE_ENABLED    0x0010
+#define SW_QUICK_STOP         0x0020  // 1: quick stop is not active
+#define SW_SWITCH_ON_DISABLED 0x0040
+#define SW_REMOTE             0x0200
+#define SW_TARGET_REACHED     0x0400
+#define SW_SETPOINT_ACK       0x1000  // PP: set-point acknowledge, CSP: drive follows the target
+#define SW_FOLLOWING_ERROR    0x2000
+
+// controlword bits
+#define CW_NEW_SETPOINT   0x0010
+#define CW_IMMEDIATE      0x0020
+#define CW_RELATIVE       0x0040
+#define CW_FAULT_RESET    0x0080
+#define CW_HALT           0x0100
+
+// error register bits of the simulated faults, see CO_error()
+#define EM_BIT_INJECTED        (CO_EM_MANUFACTURER_START + 0U)
+#define EM_BIT_FOLLOWING_ERROR (CO_EM_MANUFACTURER_START + 1U)
+
+#define TORQUE_PER_ACCELERATION 0.001  // 0x6077 in per mille of rated torque for 1 count/s^2
+#define TORQUE_MAX              3000
+#define NETWORK_INTERVAL_US     100000
+
+static uint64_t time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+static int32_t to_i32(double value) {
+    if (value >= 2147483647.0) return INT32_MAX;
+    if (value <= -2147483648.0) return INT32_MIN;
+    return (int32_t)lround(value);
+}
+
+// deceleration 0 stops immediately
+static double decelerate(double velocity, double deceleration, double dt) {
+    double dv = deceleration > 0.0 ? deceleration * dt : fabs(velocity);
+    if (fabs(velocity) <= dv) return 0.0;
+    return velocity > 0.0 ? velocity - dv : velocity + dv;
+}
+
+/* drive model ****************************************************************/
+static uint16_t node_statusword(const erob_sim_node_t *n) {
+    uint16_t sw = SW_REMOTE;
+
+    switch (n->state) {
+        case CIA402_SWITCH_ON_DISABLED: sw |= SW_SWITCH_ON_DISABLED; break;
+        case CIA402_READY_TO_SWITCH_ON: sw |= SW_QUICK_STOP | SW_READY_TO_SWITCH_ON; break;
+        case CIA402_SWITCHED_ON: sw |= SW_QUICK_STOP | SW_SWITCHED_ON | SW_READY_TO_SWITCH_ON; break;
+        case CIA402_OPERATION_ENABLED:
+            sw |= SW_QUICK_STOP | SW_OPERATION_ENABLED | SW_SWITCHED_ON | SW_READY_TO_SWITCH_ON;
+            break;
+        case CIA402_QUICK_STOP_ACTIVE: sw |= SW_OPERATION_ENABLED | SW_SWITCHED_ON | SW_READY_TO_SWITCH_ON; break;
+        case CIA402_FAULT_REACTION_ACTIVE:
+            sw |= SW_FAULT | SW_OPERATION_ENABLED | SW_SWITCHED_ON | SW_READY_TO_SWITCH_ON;
+            break;
+        case CIA402_FAULT: sw |= SW_FAULT; break;
+        default: break;
+    }
+    if (n->state != CIA402_NOT_READY_TO_SWITCH_ON && n->state != CIA402_SWITCH_ON_DISABLED
+        && n->state != CIA402_FAULT) {
+        sw |= SW_VOLTAGE_ENABLED;
+    }
+
+    if (n->state == CIA402_OPERATION_ENABLED && *n->mode_display == EROB_SIM_MODE_PP) {
+        bool halted = (n->controlword_prev & CW_HALT) != 0 && n->velocity == 0.0;
+        bool in_window = fabs(n->target - n->position) <= (double)abs(*n->position_window);
+        if (halted || (!n->moving && !n->next_pending && in_window)) sw |= SW_TARGET_REACHED;
+        if (n->setpoint_ack) sw |= SW_SETPOINT_ACK;
+    } else if (n->state == CIA402_OPERATION_ENABLED && *n->mode_display == EROB_SIM_MODE_CSP) {
+        sw |= SW_SETPOINT_ACK;
+        if (n->following_error_set) sw |= SW_FOLLOWING_ERROR;
+    } else if (n->velocity == 0.0) {
+        sw |= SW_TARGET_REACHED;
+    }
+    return sw;
+}
+
+// OD variables from the model, statusword change requests its TPDO
+static void node_publish(erob_sim_node_t *n) {
+    uint16_t sw = node_statusword(n);
+    double torque = n->acceleration * TORQUE_PER_ACCELERATION;
+
+    *n->position_actual = to_i32(n->position);
+    *n->position_demand = to_i32(*n->mode_display == EROB_SIM_MODE_CSP ? (double)*n->target_position : n->position);
+    *n->velocity_actual = to_i32(n->velocity);
+    *n->torque_actual = (int16_t)(torque > TORQUE_MAX ? TORQUE_MAX : torque < -TORQUE_MAX ? -TORQUE_MAX : torque);
+    if (sw != *n->statusword) {
+        *n->statusword = sw;
+        OD_requestTPDO(n->entry_6041, 0);
+    }
+}
+
+static void node_stop_motion(erob_sim_node_t *n) {
+    n->velocity = 0.0;
+    n->acceleration = 0.0;
+    n->moving = false;
+    n->next_pending = false;
+    n->setpoint_ack = false;
+    n->target = n->position;
+}
+
+static void node_fault(erob_sim_node_t *n, uint16_t error_code, uint8_t error_bit) {
+    if (n->state == CIA402_FAULT || n->state == CIA402_FAULT_REACTION_ACTIVE) return;
+
+    *n->error_code = error_code;
+    CO_errorReport(n->network->co->em, error_bit, error_code, (uint32_t)*n->position_actual);
+    n->faults++;
+    n->moving = false;
+    n->next_pending = false;
+    n->setpoint_ack = false;
+    n->state = (n->state == CIA402_OPERATION_ENABLED || n->state == CIA402_QUICK_STOP_ACTIVE)
+                   ? CIA402_FAULT_REACTION_ACTIVE
+                   : CIA402_FAULT;
+    if (n->state == CIA402_FAULT) n->velocity = 0.0;
+}
+
+static void node_fault_reset(erob_sim_node_t *n) {
+    CO_EM_t *em = n->network->co->em;
+    *n->error_code = 0;
+    CO_errorReset(em, EM_BIT_INJECTED, 0);
+    CO_errorReset(em, EM_BIT_FOLLOWING_ERROR, 0);
+    n->following_error_set = false;
+    n->state = CIA402_SWITCH_ON_DISABLED;
+}
+
+// PP set-point from 0x607A, on rising edge of controlword bit 4
+static void node_new_setpoint(erob_sim_node_t *n, uint16_t controlword) {
+    double base = 0.0;
+    if ((controlword & CW_RELATIVE) != 0) base = n->moving ? n->target : n->position;
+    double target = base + (double)*n->target_position;
+
+    if (!n->moving || (controlword & CW_IMMEDIATE) != 0) {
+        n->target = target;
+        n->moving = true;
+        n->next_pending = false;
+        n->setpoint_ack = true;
+    } else if (!n->next_pending) {
+        n->next_target = target;
+        n->next_pending = true;
+        n->setpoint_ack = true;
+    }
+    // else buffer is full, set-point is not acknowledged
+}
+
+// CiA402 state transitions, called when controlword is written
+static void node_controlword(erob_sim_node_t *n, uint16_t cw) {
+    uint16_t prev = n->controlword_prev;
+    n->controlword_prev = cw;
+
+    if (n->state == CIA402_FAULT) {
+        if ((cw & CW_FAULT_RESET) != 0 && (prev & CW_FAULT_RESET) == 0) node_fault_reset(n);
+        return;
+    }
+    if (n->state == CIA402_NOT_READY_TO_SWITCH_ON || n->state == CIA402_FAULT_REACTION_ACTIVE) return;
+
+    cia402_state_t state = n->state;
+    if ((cw & 0x0002) == 0) {
+        // disable voltage
+        state = CIA402_SWITCH_ON_DISABLED;
+    } else if ((cw & 0x0004) == 0) {
+        // quick stop
+        state = (state == CIA402_OPERATION_ENABLED || state == CIA402_QUICK_STOP_ACTIVE) ? CIA402_QUICK_STOP_ACTIVE
+                                                                                          : CIA402_SWITCH_ON_DISABLED;
+    } else if ((cw & 0x0007) == 0x0006) {
+        // shutdown
+        if (state != CIA402_QUICK_STOP_ACTIVE) state = CIA402_READY_TO_SWITCH_ON;
+    } else if ((cw & 0x000F) == 0x0007) {
+        // switch on or disable operation
+        if (state == CIA402_READY_TO_SWITCH_ON || state == CIA402_OPERATION_ENABLED) state = CIA402_SWITCHED_ON;
+    } else if ((cw & 0x000F) == 0x000F) {
+        // enable operation
+        if (state == CIA402_SWITCHED_ON) state = CIA402_OPERATION_ENABLED;
+    }
+
+    if (state != n->state) {
+        if (state != CIA402_OPERATION_ENABLED && state != CIA402_QUICK_STOP_ACTIVE) node_stop_motion(n);
+        if (state == CIA402_OPERATION_ENABLED) {
+            node_stop_motion(n);
+            n->last_sync_us = 0;
+        }
+        n->state = state;
+    }
+
+    if (n->state == CIA402_OPERATION_ENABLED && *n->mode_display == EROB_SIM_MODE_PP) {
+        if ((cw & CW_NEW_SETPOINT) != 0 && (prev & CW_NEW_SETPOINT) == 0) {
+            node_new_setpoint(n, cw);
+        } else if ((cw & CW_NEW_SETPOINT) == 0) {
+            n->setpoint_ack = false;
+        }
+    }
+}
+
+// trapezoidal PP profile, one tick
+static void node_pp_step(erob_sim_node_t *n, double dt) {
+    double vmax = (double)*n->profile_velocity;
+    double acc = (double)*n->profile_acceleration;
+    double dec = (double)*n->profile_deceleration;
+
+    if ((n->controlword_prev & CW_HALT) != 0 || !n->moving) {
+        n->velocity = decelerate(n->velocity, dec, dt);
+        n->position += n->velocity * dt;
+        if (!n->moving) n->target = n->position;
+        return;
+    }
+
+    double distance = n->target - n->position;
+    double dir = distance >= 0.0 ? 1.0 : -1.0;
+    double speed = n->velocity * dir;  // positive towards the target
+    double braking = (dec > 0.0 && speed > 0.0) ? speed * speed / (2.0 * dec) : 0.0;
+
+    if (speed < 0.0 || speed > vmax || braking >= fabs(distance)) {
+        // wrong direction, too fast or time to brake, keep at least one step of speed to arrive
+        speed = decelerate(speed, dec, dt);
+        if (speed >= 0.0 && speed < dec * dt) speed = dec * dt;
+    } else {
+        speed = acc > 0.0 ? speed + acc * dt : vmax;
+        if (speed > vmax) speed = vmax;
+    }
+    n->velocity = speed * dir;
+    n->position += n->velocity * dt;
+
+    if ((n->target - n->position) * dir <= 0.0) {
+        // arrived or passed the target
+        n->position = n->target;
+        n->velocity = 0.0;
+        n->moving = false;
+        if (n->next_pending) {
+            n->target = n->next_target;
+            n->next_pending = false;
+            n->moving = true;
+        }
+    }
+}
+
+static void node_tick(erob_sim_node_t *n, double dt) {
+    double velocity = n->velocity;
+
+    if (n->state == CIA402_QUICK_STOP_ACTIVE || n->state == CIA402_FAULT_REACTION_ACTIVE) {
+        n->velocity = decelerate(n->velocity, (double)*n->quick_stop_deceleration, dt);
+        n->position += n->velocity * dt;
+        if (n->velocity == 0.0) {
+            n->state = n->state == CIA402_QUICK_STOP_ACTIVE ? CIA402_SWITCH_ON_DISABLED : CIA402_FAULT;
+            node_stop_motion(n);
+        }
+    } else if (n->state == CIA402_OPERATION_ENABLED && *n->mode_display == EROB_SIM_MODE_PP) {
+        node_pp_step(n, dt);
+    } else if (*n->mode_display != EROB_SIM_MODE_CSP || n->state != CIA402_OPERATION_ENABLED) {
+        n->velocity = 0.0;
+    }
+    if (*n->mode_display != EROB_SIM_MODE_CSP || n->state != CIA402_OPERATION_ENABLED) {
+        n->acceleration = dt > 0.0 ? (n->velocity - velocity) / dt : 0.0;
+        *n->following_error = 0;
+    }
+}
+
+// drive moves without SYNC and needs the motion tick
+static bool node_active(const erob_sim_node_t *n) {
+    if (n->state == CIA402_OPERATION_ENABLED && *n->mode_display == EROB_SIM_MODE_CSP) return false;
+    return n->velocity != 0.0 || n->moving || n->state == CIA402_QUICK_STOP_ACTIVE
+           || n->state == CIA402_FAULT_REACTION_ACTIVE;
+}
+
+/* OD extensions **************************************************************/
+static ODR_t write_6040(OD_stream_t *stream, const void *buf, OD_size_t count, OD_size_t *countWritten) {
+    ODR_t ret = OD_writeOriginal(stream, buf, count, countWritten);
+    if (ret == ODR_OK && count == sizeof(uint16_t)) {
+        erob_sim_node_t *n = stream->object;
+        node_controlword(n, CO_getUint16(buf));
+        node_publish(n);
+    }
+    return ret;
+}
+
+static ODR_t write_6060(OD_stream_t *stream, const void *buf, OD_size_t count, OD_size_t *countWritten) {
+    erob_sim_node_t *n = stream->object;
+    if (count != sizeof(int8_t)) return ODR_TYPE_MISMATCH;
+
+    int8_t mode = (int8_t)CO_getUint8(buf);
+    if (mode != 0 && mode != EROB_SIM_MODE_PP && mode != EROB_SIM_MODE_CSP) return ODR_INVALID_VALUE;
+
+    ODR_t ret = OD_writeOriginal(stream, buf, count, countWritten);
+    if (ret == ODR_OK && mode != *n->mode_display) {
+        // mode change stops the motion of the previous mode
+        n->moving = false;
+        n->next_pending = false;
+        n->setpoint_ack = false;
+        n->target = n->position;
+        n->last_sync_us = 0;
+        *n->mode_display = mode;
+        node_publish(n);
+    }
+    return ret;
+}
+
+/* network callbacks **********************************************************/
+// CSP: position follows the target on each SYNC, called with OD locked, before TPDOs
+static void node_sync(void *object, CO_t *co) {
+    erob_sim_node_t *n = object;
+    uint64_t now = time_us();
+    (void)co;
+
+    if (n->state != CIA402_OPERATION_ENABLED || *n->mode_display != EROB_SIM_MODE_CSP) {
+        n->last_sync_us = 0;
+        return;
+    }
+    n->sync_count++;
+
+    double dt = n->last_sync_us != 0 ? (double)(now - n->last_sync_us) / 1e6 : 0.0;
+    double target = (double)*n->target_position;
+    double step = target - n->position;
+    if (*n->max_motor_speed > 0 && dt > 0.0) {
+        double limit = (double)*n->max_motor_speed * dt;
+        step = step > limit ? limit : step < -limit ? -limit : step;
+    }
+    double velocity = dt > 0.0 ? step / dt : 0.0;
+    n->acceleration = dt > 0.0 ? (velocity - n->velocity) / dt : 0.0;
+    n->velocity = velocity;
+    n->position += step;
+    n->last_sync_us = now;
+
+    double error = target - n->position;
+    *n->following_error = to_i32(error);
+    n->following_error_set = *n->following_error_window > 0 && fabs(error) > (double)*n->following_error_window;
+    if (n->following_error_set) node_fault(n, EROB_SIM_EMC_FOLLOWING_ERROR, EM_BIT_FOLLOWING_ERROR);
+    node_publish(n);
+}
+
+static void node_init(CO_network_t *network) {
+    erob_sim_node_t *n = network->config.appObject;
+    n->network = network;
+    n->last_sync_us = 0;
+    CO_epoll_initCallbackSync(&network->ep, n, node_sync);
+}
+
+static void node_process(CO_network_t *network) {
+    erob_sim_node_t *n = network->config.appObject;
+    CO_t *co = network->co;
+    uint64_t now = time_us();
+    double dt = (double)(now - n->last_tick_us) / 1e6;
+    n->last_tick_us = now;
+
+    CO_LOCK_OD(co->CANmodule);
+    if (n->state == CIA402_NOT_READY_TO_SWITCH_ON) {
+        if (now - n->start_us >= EROB_SIM_BOOT_US) {
+            n->state = CIA402_SWITCH_ON_DISABLED;
+        } else if (network->ep.timerNext_us > EROB_SIM_BOOT_US) {
+            network->ep.timerNext_us = EROB_SIM_BOOT_US;
+        } else { /* MISRA C 2004 14.10 */ }
+    }
+    unsigned int fault = atomic_exchange(&n->fault_request, 0U);
+    if (fault != 0U) node_fault(n, (uint16_t)fault, EM_BIT_INJECTED);
+
+    node_tick(n, dt);
+    if (node_active(n) && network->ep.timerNext_us > n->tick_us) {
+        network->ep.timerNext_us = n->tick_us;
+    }
+    node_publish(n);
+
+    erob_sim_status_t status = {
+        .node_id = n->node_id,
+        .state = n->state,
+        .statusword = *n->statusword,
+        .mode = *n->mode_display,
+        .position = *n->position_actual,
+        .velocity = *n->velocity_actual,
+        .error_code = *n->error_code,
+        .faults = n->faults,
+        .sync_count = n->sync_count,
+    };
+    CO_UNLOCK_OD(co->CANmodule);
+
+    (void)pthread_mutex_lock(&network->statusMutex);
+    status.nmt_state = CO_NMT_getInternalState(co->NMT);
+    status.loops = network->status.loopCount;
+    n->status = status;
+    (void)pthread_mutex_unlock(&network->statusMutex);
+}
+
+/* node setup *****************************************************************/
+static void *od_ptr(OD_t *od, uint16_t index, uint8_t sub, OD_size_t len, bool *ok) {
+    void *ptr = OD_getPtr(OD_find(od, index), sub, len, NULL);
+    if (ptr == NULL) *ok = false;
+    return ptr;
+}
+
+static bool node_setup(erob_sim_node_t *n, uint8_t node_id, const erob_sim_config_t *config) {
+    OD_t *od = n->od;
+    bool ok = true;
+
+    n->node_id = node_id;
+    n->tick_us = config->tick_us > 0 ? config->tick_us : EROB_SIM_TICK_US;
+    n->state = CIA402_NOT_READY_TO_SWITCH_ON;
+    n->start_us = time_us();
+    n->last_tick_us = n->start_us;
+    atomic_init(&n->fault_request, 0U);
+
+    n->controlword = od_ptr(od, 0x6040, 0, sizeof(uint16_t), &ok);
+    n->statusword = od_ptr(od, 0x6041, 0, sizeof(uint16_t), &ok);
+    n->error_code = od_ptr(od, 0x603F, 0, sizeof(uint16_t), &ok);
+    n->mode = od_ptr(od, 0x6060, 0, sizeof(int8_t), &ok);
+    n->mode_display = od_ptr(od, 0x6061, 0, sizeof(int8_t), &ok);
+    n->position_demand = od_ptr(od, 0x6062, 0, sizeof(int32_t), &ok);
+    n->position_actual = od_ptr(od, 0x6064, 0, sizeof(int32_t), &ok);
+    n->following_error_window = od_ptr(od, 0x6065, 0, sizeof(int32_t), &ok);
+    n->position_window = od_ptr(od, 0x6067, 0, sizeof(int32_t), &ok);
+    n->velocity_actual = od_ptr(od, 0x606C, 0, sizeof(int32_t), &ok);
+    n->torque_actual = od_ptr(od, 0x6077, 0, sizeof(int16_t), &ok);
+    n->target_position = od_ptr(od, 0x607A, 0, sizeof(int32_t), &ok);
+    n->max_motor_speed = od_ptr(od, 0x6080, 0, sizeof(uint32_t), &ok);
+    n->profile_velocity = od_ptr(od, 0x6081, 0, sizeof(uint32_t), &ok);
+    n->profile_acceleration = od_ptr(od, 0x6083, 0, sizeof(uint32_t), &ok);
+    n->profile_deceleration = od_ptr(od, 0x6084, 0, sizeof(uint32_t), &ok);
+    n->quick_stop_deceleration = od_ptr(od, 0x6085, 0, sizeof(uint32_t), &ok);
+    n->following_error = od_ptr(od, 0x60F4, 0, sizeof(int32_t), &ok);
+    if (!ok) return false;
+
+    *n->mode_display = *n->mode;
+    *n->statusword = node_statusword(n);
+
+    uint16_t heartbeat_ms = config->heartbeat_ms > 0 ? config->heartbeat_ms : EROB_SIM_HEARTBEAT_MS;
+    n->entry_6041 = OD_find(od, 0x6041);
+    n->ext_6040 = (OD_extension_t){.object = n, .read = OD_readOriginal, .write = write_6040};
+    n->ext_6041 = (OD_extension_t){.object = n, .read = OD_readOriginal, .write = OD_writeOriginal};
+    n->ext_6060 = (OD_extension_t){.object = n, .read = OD_readOriginal, .write = write_6060};
+    return OD_set_u16(OD_find(od, 0x1017), 0, heartbeat_ms, true) == ODR_OK
+           && OD_extension_init(OD_find(od, 0x6040), &n->ext_6040) == ODR_OK
+           && OD_extension_init(n->entry_6041, &n->ext_6041) == ODR_OK
+           && OD_extension_init(OD_find(od, 0x6060), &n->ext_6060) == ODR_OK;
+}
+
+static void sim_free(erob_sim_t *sim) {
+    if (sim->nodes != NULL) {
+        for (uint8_t i = 0; i < sim->config.node_count; i++) {
+            if (sim->nodes[i].od != NULL) CO_network_deleteOD(sim->nodes[i].od);
+        }
+    }
+    free(sim->nodes);
+    free(sim->networks);
+    free(sim->net_configs);
+    sim->nodes = NULL;
+    sim->networks = NULL;
+    sim->net_configs = NULL;
+}
+
+CO_ReturnError_t erob_sim_start(erob_sim_t *sim, const erob_sim_config_t *config) {
+    if (sim == NULL || config == NULL || config->ifname == NULL || config->node_count == 0
+        || config->first_node_id < 1 || (unsigned)config->first_node_id + config->node_count - 1U > 127U) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    uint8_t count = config->node_count;
+    uint8_t threads = config->thread_count > 0 ? config->thread_count : 1;
+    sim->nodes = calloc(count, sizeof(erob_sim_node_t));
+    sim->networks = calloc(count, sizeof(CO_network_t));
+    sim->net_configs = calloc(count, sizeof(CO_networkConfig_t));
+    if (sim->nodes == NULL || sim->networks == NULL || sim->net_configs == NULL) {
+        sim_free(sim);
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+
+    // each node has its own copy of the variables of the generated OD
+    CO_network_ODregion_t regions[] = {{.addr = &OD_erob_RAM, .len = sizeof(OD_erob_RAM)},
+                                       {.addr = &OD_erob_PERSIST_COMM, .len = sizeof(OD_erob_PERSIST_COMM)}};
+    for (uint8_t i = 0; i < count; i++) {
+        erob_sim_node_t *n = &sim->nodes[i];
+        n->od = CO_network_cloneOD(OD_erob, regions, sizeof(regions) / sizeof(regions[0]));
+        if (n->od == NULL) {
+            sim_free(sim);
+            return CO_ERROR_OUT_OF_MEMORY;
+        }
+        if (!node_setup(n, (uint8_t)(config->first_node_id + i), config)) {
+            sim_free(sim);
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+        sim->net_configs[i] = (CO_networkConfig_t){
+            .ifName = config->ifname,
+            .nodeId = n->node_id,
+            .od = n->od,
+            .cpu = (config->cpu >= 0 && i < threads) ? config->cpu + i : -1,
+            .priority = config->priority,
+            .interval_us = NETWORK_INTERVAL_US,
+            .appInit = node_init,
+            .appProcess = node_process,
+            .appObject = n,
+        };
+    }
+
+    CO_ReturnError_t err = CO_network_startShared(sim->networks, sim->net_configs, count, threads);
+    if (err != CO_ERROR_NO) {
+        sim_free(sim);
+        return err;
+    }
+    sim->started = true;
+    return CO_ERROR_NO;
+}
+
+void erob_sim_stop(erob_sim_t *sim) {
+    if (sim == NULL) return;
+    if (sim->started) {
+        CO_network_stop(sim->networks, sim->config.node_count);
+        sim->started = false;
+    }
+    sim_free(sim);
+}
+
+static erob_sim_node_t *sim_node(erob_sim_t *sim, uint8_t node_id, uint8_t *index) {
+    if (sim == NULL || !sim->started || node_id < sim->config.first_node_id
+        || node_id - sim->config.first_node_id >= sim->config.node_count) {
+        return NULL;
+    }
+    *index = (uint8_t)(node_id - sim->config.first_node_id);
+    return &sim->nodes[*index];
+}
+
+bool erob_sim_fault(erob_sim_t *sim, uint8_t node_id, uint16_t error_code) {
+    uint8_t i;
+    erob_sim_node_t *n = sim_node(sim, node_id, &i);
+    if (n == NULL) return false;
+
+    atomic_store(&n->fault_request, error_code != 0 ? error_code : EROB_SIM_EMC_INJECTED);
+    CO_epoll_signal(&sim->networks[i].ep);
+    return true;
+}
+
+bool erob_sim_status(erob_sim_t *sim, uint8_t node_id, erob_sim_status_t *status) {
+    uint8_t i;
+    erob_sim_node_t *n = sim_node(sim, node_id, &i);
+    if (n == NULL || status == NULL) return false;
+
+    (void)pthread_mutex_lock(&sim->networks[i].statusMutex);
+    *status = n->status;
+    status->network_state = sim->networks[i].status.state;
+    (void)pthread_mutex_unlock(&sim->networks[i].statusMutex);
+    if (status->node_id == 0) {
+        // not processed yet
+        status->node_id = node_id;
+        status->state = CIA402_NOT_READY_TO_SWITCH_ON;
+    }
+    return true;
+}
@@ -0,0 +1,149 @@
+/*
+ * author: ZeroErr Inc.
+ * In-process eRob drive simulator: many virtual CiA402 nodes on one socketCAN interface (vcan)
+ *
+ * Each simulated node is a complete CANopenNode device with its own CO_t from CO_new() and its own copy of the eRob
+ * Object Dictionary (OD_erob, generated from "ZeroErr Driver_V1.5.eds"), so masters see the same objects, PDO
+ * mapping, SDO server, heartbeat and EMCY as on a real drive. Nodes are processed by a few shared threads
+ * (CO_network_startShared()), each thread waits on all its nodes with one epoll and processes only ready nodes, so
+ * fifty nodes do not need fifty threads.
+ *
+ * Drive model of each node:
+ * - CiA402 state machine: controlword 0x6040 is evaluated when it is written (SDO or RPDO), statusword 0x6041 is
+ *   updated and requests the TPDO, to which it is mapped. Switch on disabled is entered shortly after start.
+ * - Modes of operation 0x6060: Profile Position (1) and Cyclic Synchronous Position (8), display in 0x6061.
+ * - PP: new set-point (bit 4 rising edge), change set immediately (bit 5), relative (bit 6), halt (bit 8), one
+ *   buffered set-point; trapezoidal profile with 0x6081, 0x6083 and 0x6084; set-point acknowledge and target reached
+ *   (0x6067 window) in the statusword.
+ * - CSP: on each SYNC the position moves to the target 0x607A, limited by 0x6080 (if not 0); following error
+ *   0x60F4 is checked against 0x6065 (if not 0), which causes fault 0x8611.
+ * - Quick stop and fault reaction decelerate with 0x6085. Fault sets 0x603F and sends EMCY, fault reset (controlword
+ *   bit 7 rising edge) clears it.
+ * - Position 0x6064, demand 0x6062, velocity 0x606C, following error 0x60F4 and torque 0x6077 (proportional to
+ *   acceleration) are updated every tick_us while the drive moves.
+ */
+
+#ifndef EROB_SIM_H
+#define EROB_SIM_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "CANopen.h"
+#include "CO_network.h"
+#include "cia402.h"
+
+#define EROB_SIM_MODE_PP  1  // 0x6060 Profile Position
+#define EROB_SIM_MODE_CSP 8  // 0x6060 Cyclic Synchronous Position
+
+#define EROB_SIM_EMC_FOLLOWING_ERROR 0x8611  // EMCY error code of the following error fault
+#define EROB_SIM_EMC_INJECTED        0xFF00  // default EMCY error code for erob_sim_fault()
+
+#define EROB_SIM_TICK_US       1000  // default motion tick
+#define EROB_SIM_HEARTBEAT_MS  100   // default producer heartbeat time
+#define EROB_SIM_BOOT_US       20000 // not ready to switch on to switch on disabled
+
+typedef struct {
+    const char *ifname;     // CAN interface, for example "vcan0"
+    uint8_t first_node_id;  // node-id of the first node, others follow
+    uint8_t node_count;     // number of nodes
+    uint8_t thread_count;   // number of shared threads, 0 for 1
+    int cpu;                // CPU core of the first thread, next threads use next cores, -1 for no affinity
+    int priority;           // SCHED_FIFO priority or 0
+    uint16_t heartbeat_ms;  // producer heartbeat time 0x1017, 0 for EROB_SIM_HEARTBEAT_MS
+    uint32_t tick_us;       // motion tick while the drive moves, 0 for EROB_SIM_TICK_US
+} erob_sim_config_t;
+
+// State of one node, see erob_sim_status()
+typedef struct {
+    uint8_t node_id;
+    CO_networkState_t network_state;  // CO_NETWORK_ERROR, if CAN or CANopen initialization failed
+    cia402_state_t state;
+    CO_NMT_internalState_t nmt_state;
+    uint16_t statusword;
+    int8_t mode;
+    int32_t position;
+    int32_t velocity;
+    uint16_t error_code;        // 0x603F
+    uint32_t faults;            // number of faults since start
+    uint32_t sync_count;        // number of SYNC messages, received in operation enabled
+    uint64_t loops;             // number of processing passes
+} erob_sim_status_t;
+
+// One simulated node, used by the network thread only
+typedef struct {
+    uint8_t node_id;
+    OD_t *od;                 // copy of OD_erob
+    CO_network_t *network;
+    uint32_t tick_us;
+
+    OD_extension_t ext_6040;
+    OD_extension_t ext_6041;
+    OD_extension_t ext_6060;
+    OD_entry_t *entry_6041;
+
+    // OD variables
+    uint16_t *controlword;
+    uint16_t *statusword;
+    uint16_t *error_code;
+    int8_t *mode;
+    int8_t *mode_display;
+    int32_t *position_actual;
+    int32_t *position_demand;
+    int32_t *velocity_actual;
+    int32_t *target_position;
+    int32_t *following_error;
+    int16_t *torque_actual;
+    int32_t *following_error_window;
+    int32_t *position_window;
+    uint32_t *max_motor_speed;
+    uint32_t *profile_velocity;
+    uint32_t *profile_acceleration;
+    uint32_t *profile_deceleration;
+    uint32_t *quick_stop_deceleration;
+
+    // drive model
+    cia402_state_t state;
+    uint16_t controlword_prev;
+    double position;          // counts
+    double velocity;          // counts/s
+    double acceleration;      // counts/s^2, for torque
+    double target;            // PP target
+    double next_target;       // buffered PP set-point
+    bool moving;              // PP profile in progress
+    bool next_pending;        // next_target is valid
+    bool setpoint_ack;        // statusword bit 12 in PP
+    bool following_error_set; // statusword bit 13 in CSP
+    uint64_t start_us;
+    uint64_t last_tick_us;
+    uint64_t last_sync_us;
+    uint32_t faults;
+    uint32_t sync_count;
+
+    atomic_uint fault_request;       // from erob_sim_fault(), 0 if none
+    erob_sim_status_t status;        // copy for erob_sim_status(), protected by network->statusMutex
+} erob_sim_node_t;
+
+typedef struct {
+    erob_sim_config_t config;
+    erob_sim_node_t *nodes;
+    CO_network_t *networks;
+    CO_networkConfig_t *net_configs;
+    bool started;
+} erob_sim_t;
+
+/* Create node_count nodes and start the shared threads. Return CO_ERROR_NO or error from CO_network_startShared(),
+ * CO_ERROR_ILLEGAL_ARGUMENT for wrong configuration or CO_ERROR_OUT_OF_MEMORY. */
+CO_ReturnError_t erob_sim_start(erob_sim_t *sim, const erob_sim_config_t *config);
+
+/* Stop the threads and delete all nodes */
+void erob_sim_stop(erob_sim_t *sim);
+
+/* Request fault with EMCY error code on the node, from any thread. Return false, if node does not exist. */
+bool erob_sim_fault(erob_sim_t *sim, uint8_t node_id, uint16_t error_code);
+
+/* Copy of the node state, from any thread. Return false, if node does not exist. */
+bool erob_sim_status(erob_sim_t *sim, uint8_t node_id, erob_sim_status_t *status);
+
+#endif // EROB_SIM_H
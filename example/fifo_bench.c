@@ -0,0 +1,132 @@
+/*
+ * author: ZeroErr Inc.
+ * CO_fifo micro benchmark: throughput of the circular buffer used by SDO client, SDO server and gateway
+ *
+ * Scenarios:
+ * - sdo segment: 7-byte writes and reads through a 1000-byte fifo, like segmented SDO transfer
+ * - sdo block:   889-byte writes (127 segments) with CRC, read back with CO_fifo_altRead, like SDO block transfer
+ * - gateway:     ASCII command lines through a 2000-byte fifo, read line by line with end of command detection
+ *
+ * Every scenario wraps around the end of the buffer, so both contiguous chunks of CO_fifo_write/read are used.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "301/CO_fifo.h"
+
+#define BENCH_BYTES (64UL * 1024 * 1024)
+
+static uint8_t fifo_buf[2000];
+static uint8_t src[1024];
+static uint8_t dst[1024];
+
+static double time_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void print_result(const char *name, size_t bytes, double elapsed_s, uint32_t check) {
+    printf("%-14s %10zu bytes %8.3f s %9.1f MB/s  (check 0x%08X)\n", name, bytes, elapsed_s,
+           elapsed_s > 0 ? bytes / 1e6 / elapsed_s : 0.0, check);
+}
+
+// write and read the same amount in each step, fifo is never full
+static void bench_segment(size_t fifo_size, size_t step) {
+    CO_fifo_t fifo;
+    size_t total = 0;
+    uint32_t check = 0;
+
+    CO_fifo_init(&fifo, fifo_buf, fifo_size);
+    double start = time_s();
+    while (total < BENCH_BYTES) {
+        size_t n = CO_fifo_write(&fifo, src, step, NULL);
+        n = CO_fifo_read(&fifo, dst, n, NULL);
+        check += dst[0];
+        total += n;
+    }
+    print_result("sdo segment", total, time_s() - start, check);
+}
+
+#if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_ALT_READ) != 0 && ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_CRC16_CCITT) != 0
+// sub-block is written with CRC and read with alternate read pointer, then confirmed
+static void bench_block(size_t fifo_size, size_t step) {
+    CO_fifo_t fifo;
+    size_t total = 0;
+    uint16_t crc_write = 0;
+    uint16_t crc_read = 0;
+
+    CO_fifo_init(&fifo, fifo_buf, fifo_size);
+    double start = time_s();
+    while (total < BENCH_BYTES) {
+        size_t n = CO_fifo_write(&fifo, src, step, &crc_write);
+        CO_fifo_altBegin(&fifo, 0);
+        n = CO_fifo_altRead(&fifo, dst, n);
+        CO_fifo_altFinish(&fifo, &crc_read);
+        total += n;
+    }
+    double elapsed = time_s() - start;
+    if (crc_write != crc_read) {
+        printf("sdo block: CRC mismatch 0x%04X 0x%04X\n", crc_write, crc_read);
+    }
+    print_result("sdo block", total, elapsed, crc_write);
+}
+#endif
+
+#if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_ASCII_COMMANDS) != 0
+// command lines are written as they come from the socket, each line is read up to the delimiter
+static void bench_gateway(size_t fifo_size) {
+    static const char line[] = "[1] 2 read 0x6064 0 i32\n";
+    CO_fifo_t fifo;
+    size_t total = 0;
+    uint32_t lines = 0;
+    size_t line_len = strlen(line);
+    size_t batch = 0;
+
+    // a batch of command lines is one write
+    while (batch + line_len <= sizeof(src)) {
+        memcpy(&src[batch], line, line_len);
+        batch += line_len;
+    }
+
+    CO_fifo_init(&fifo, fifo_buf, fifo_size);
+    double start = time_s();
+    while (total < BENCH_BYTES) {
+        size_t n = CO_fifo_write(&fifo, src, batch, NULL);
+        while (n > 0) {
+            bool_t eof = false;
+            size_t r = CO_fifo_read(&fifo, dst, sizeof(dst), &eof);
+            if (r == 0) {
+                break;
+            }
+            lines += eof ? 1 : 0;
+            n -= r < n ? r : n;
+            total += r;
+        }
+    }
+    print_result("gateway", total, time_s() - start, lines);
+}
+#endif
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    printf("CO_fifo benchmark, %lu MB per scenario\n", BENCH_BYTES / (1024 * 1024));
+    bench_segment(1000, 7);
+#if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_ALT_READ) != 0 && ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_CRC16_CCITT) != 0
+    bench_block(1000, 889);
+#endif
+#if ((CO_CONFIG_FIFO)&CO_CONFIG_FIFO_ASCII_COMMANDS) != 0
+    bench_gateway(sizeof(fifo_buf));
+#endif
+    return 0;
+}
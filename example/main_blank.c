@@ -39,6 +39,13 @@
 
 /* Global variables and objects */
 CO_t* CO = NULL; /* CANopen object */
+#ifdef CO_USE_ARENA
+/* Memory for all CANopen objects, no heap is used. Size must be at least CO_arenaSize(config_ptr). */
+#ifndef CO_APP_ARENA_SIZE
+#define CO_APP_ARENA_SIZE 65536U
+#endif
+static uint64_t CO_arenaMemory[CO_APP_ARENA_SIZE / sizeof(uint64_t)];
+#endif
 uint8_t LED_red, LED_green;
 
 /* main ***********************************************************************/
@@ -75,7 +82,11 @@ main(void) {
     co_config.CNT_LSS_SLV = 1;
     config_ptr = &co_config;
 #endif /* CO_MULTIPLE_OD */
+#ifdef CO_USE_ARENA
+    CO = CO_newArena(config_ptr, CO_arenaMemory, sizeof(CO_arenaMemory), &heapMemoryUsed);
+#else
     CO = CO_new(config_ptr, &heapMemoryUsed);
+#endif
     if (CO == NULL) {
         log_printf("Error: Can't allocate memory\n");
         return 0;
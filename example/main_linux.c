@@ -0,0 +1,330 @@
+/*
+ * CANopen main program file for Linux socketCAN.
+ *
+ * Single threaded, event driven mainline. Program sleeps in epoll_wait() until CAN frame is received, gateway command
+ * arrives or timer, armed from timerNext_us, expires.
+ *
+ * @file        main_linux.c
+ * @author      Janez Paternoster
+ * @copyright   2021 Janez Paternoster
+ *
+ * This file is part of <https://github.com/CANopenNode/CANopenNode>, a CANopen Stack.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <net/if.h>
+
+#include "CANopen.h"
+#include "OD.h"
+#include "OD_hash.h"
+#include "CO_epoll_interface.h"
+#include "CO_storageBlank.h"
+
+/* Log messages go to stderr, if standard output carries binary gateway frames */
+static FILE* logStream = NULL;
+#define log_printf(macropar_message, ...)                                                                              \
+    fprintf((logStream != NULL) ? logStream : stdout, macropar_message, ##__VA_ARGS__)
+
+/* default values for CO_CANopenInit() */
+#define NMT_CONTROL                                                                                                    \
+    CO_NMT_STARTUP_TO_OPERATIONAL                                                                                      \
+    | CO_NMT_ERR_ON_ERR_REG | CO_ERR_REG_GENERIC_ERR | CO_ERR_REG_COMMUNICATION
+#define FIRST_HB_TIME        500
+#define SDO_SRV_TIMEOUT_TIME 1000
+#define SDO_CLI_TIMEOUT_TIME 500
+#define SDO_CLI_BLOCK        false
+#define OD_STATUS_BITS       NULL
+
+/* Maximum interval between two wakeups, if no CANopen timer is running */
+#ifndef MAIN_THREAD_INTERVAL_US
+#define MAIN_THREAD_INTERVAL_US 100000
+#endif
+
+/* Global variables and objects */
+CO_t* CO = NULL; /* CANopen object */
+static CO_epoll_t epMain;
+static volatile sig_atomic_t CO_endProgram = 0;
+
+static void
+sigHandler(int sig) {
+    (void)sig;
+    CO_endProgram = 1;
+    CO_epoll_signal(&epMain);
+}
+
+static void
+printUsage(char* progName) {
+    printf("Usage: %s <CAN device name> [options]\n", progName);
+    printf("\n"
+           "Options:\n"
+           "  -i <Node ID>        CANopen Node-id (1..127), default is 10.\n"
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII
+           "  -c stdio            Enable command interface for ascii gateway on standard IO.\n"
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_BINARY
+           "  -c stdio_bin        Enable binary gateway (length-prefixed frames) on standard IO.\n"
+           "  -c local-<file path>  Enable binary gateway for multiple clients on local socket.\n"
+           "  -c tcp-<port>       Enable binary gateway for multiple clients on tcp socket.\n"
+#endif
+#endif
+           "\n");
+}
+
+/* main ***********************************************************************/
+int
+main(int argc, char* argv[]) {
+    CO_ReturnError_t err;
+    CO_NMT_reset_cmd_t reset = CO_RESET_NOT;
+    uint32_t heapMemoryUsed;
+    CO_CANptrSocketCan_t CANptr = {0};
+    uint8_t pendingNodeId = 10;    /* configurable by LSS slave */
+    uint8_t activeNodeId = 10;     /* Copied from pendingNodeId in the communication reset section */
+    uint16_t pendingBitRate = 125; /* bitrate is configured by the system, for example 'ip link set can0 ...' */
+    char* CANdevice = NULL;
+    int opt;
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII
+    static CO_epoll_gtw_t epGtw; /* large with socket clients */
+    int32_t commandInterface = CO_COMMAND_IF_DISABLED;
+    char* localSocketPath = NULL;
+#endif
+
+#if (CO_CONFIG_STORAGE) & CO_CONFIG_STORAGE_ENABLE
+    CO_storage_t storage;
+    CO_storage_entry_t storageEntries[] = {{.addr = &OD_PERSIST_COMM,
+                                            .len = sizeof(OD_PERSIST_COMM),
+                                            .subIndexOD = 2,
+                                            .attr = CO_storage_cmd | CO_storage_restore,
+                                            .addrNV = NULL}};
+    uint8_t storageEntriesCount = sizeof(storageEntries) / sizeof(storageEntries[0]);
+    uint32_t storageInitError = 0;
+#endif
+
+    /* Get program options */
+    if (argc < 2 || strcmp(argv[1], "--help") == 0) {
+        printUsage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+    while ((opt = getopt(argc, argv, "i:c:")) != -1) {
+        switch (opt) {
+            case 'i': {
+                long nodeIdFromArgs = strtol(optarg, NULL, 0);
+                if (nodeIdFromArgs < 1 || nodeIdFromArgs > 127) {
+                    log_printf("Error: Wrong node ID (%s)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                pendingNodeId = (uint8_t)nodeIdFromArgs;
+                break;
+            }
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII
+            case 'c':
+                if (strcmp(optarg, "stdio") == 0) {
+                    commandInterface = CO_COMMAND_IF_STDIO;
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_BINARY
+                } else if (strcmp(optarg, "stdio_bin") == 0) {
+                    commandInterface = CO_COMMAND_IF_STDIO_BIN;
+                    logStream = stderr;
+                } else if (strncmp(optarg, "local-", 6) == 0) {
+                    localSocketPath = &optarg[6];
+                    commandInterface = CO_COMMAND_IF_LOCAL_SOCKET;
+                } else if (strncmp(optarg, "tcp-", 4) == 0) {
+                    long port = strtol(&optarg[4], NULL, 0);
+                    if (port < CO_COMMAND_IF_TCP_SOCKET_MIN || port > CO_COMMAND_IF_TCP_SOCKET_MAX) {
+                        log_printf("Error: Wrong TCP port (%s)\n", optarg);
+                        return EXIT_FAILURE;
+                    }
+                    commandInterface = (int32_t)port;
+#endif
+                } else {
+                    log_printf("Error: Unknown command interface (%s)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+#endif
+            default: printUsage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if (optind < argc) {
+        CANdevice = argv[optind];
+        CANptr.can_ifindex = (int)if_nametoindex(CANdevice);
+    }
+    if (CANptr.can_ifindex == 0) {
+        log_printf("Error: Can't find CAN device \"%s\"\n", CANdevice != NULL ? CANdevice : "");
+        return EXIT_FAILURE;
+    }
+
+#if OD_HASH > 0
+    /* Verify Object Dictionary and enable its hash index, generated from OD.c at build time */
+    if (OD_initHash(OD, &OD_hash) != ODR_OK) {
+        log_printf("Error: OD is not ordered by index or OD_hash.c does not match OD.c\n");
+        return EXIT_FAILURE;
+    }
+#endif
+
+    /* Allocate memory */
+    CO = CO_new(NULL, &heapMemoryUsed);
+    if (CO == NULL) {
+        log_printf("Error: Can't allocate memory\n");
+        return EXIT_FAILURE;
+    } else {
+        log_printf("Allocated %u bytes for CANopen objects\n", heapMemoryUsed);
+    }
+
+#if (CO_CONFIG_STORAGE) & CO_CONFIG_STORAGE_ENABLE
+    err = CO_storageBlank_init(&storage, CO->CANmodule, OD_ENTRY_H1010_storeParameters,
+                               OD_ENTRY_H1011_restoreDefaultParameters, storageEntries, storageEntriesCount,
+                               &storageInitError);
+
+    if (err != CO_ERROR_NO && err != CO_ERROR_DATA_CORRUPT) {
+        log_printf("Error: Storage %d\n", storageInitError);
+        return EXIT_FAILURE;
+    }
+#endif
+
+    /* Create epoll functions */
+    err = CO_epoll_create(&epMain, MAIN_THREAD_INTERVAL_US);
+    if (err != CO_ERROR_NO) {
+        log_printf("Error: epoll creation failed: %d\n", err);
+        return EXIT_FAILURE;
+    }
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII
+    err = CO_epoll_createGtw(&epGtw, epMain.epoll_fd, commandInterface, localSocketPath);
+    if (err != CO_ERROR_NO) {
+        log_printf("Error: gateway creation failed: %d\n", err);
+        return EXIT_FAILURE;
+    }
+#endif
+
+    if (signal(SIGINT, sigHandler) == SIG_ERR || signal(SIGTERM, sigHandler) == SIG_ERR) {
+        log_printf("Error: signal handler\n");
+        return EXIT_FAILURE;
+    }
+
+    while (reset != CO_RESET_APP && reset != CO_RESET_QUIT && CO_endProgram == 0) {
+        /* CANopen communication reset - initialize CANopen objects *******************/
+        log_printf("CANopenNode - Reset communication...\n");
+
+        /* Enter CAN configuration. */
+        CO->CANmodule->CANnormal = false;
+        CO_CANsetConfigurationMode((void*)&CANptr);
+        CO_CANmodule_disable(CO->CANmodule);
+
+        /* initialize CANopen */
+        err = CO_CANinit(CO, (void*)&CANptr, pendingBitRate);
+        if (err != CO_ERROR_NO) {
+            log_printf("Error: CAN initialization failed: %d\n", err);
+            return EXIT_FAILURE;
+        }
+
+        CO_LSS_address_t lssAddress = {.identity = {.vendorID = OD_PERSIST_COMM.x1018_identity.vendor_ID,
+                                                    .productCode = OD_PERSIST_COMM.x1018_identity.productCode,
+                                                    .revisionNumber = OD_PERSIST_COMM.x1018_identity.revisionNumber,
+                                                    .serialNumber = OD_PERSIST_COMM.x1018_identity.serialNumber}};
+        err = CO_LSSinit(CO, &lssAddress, &pendingNodeId, &pendingBitRate);
+        if (err != CO_ERROR_NO) {
+            log_printf("Error: LSS slave initialization failed: %d\n", err);
+            return EXIT_FAILURE;
+        }
+
+        activeNodeId = pendingNodeId;
+        uint32_t errInfo = 0;
+
+        err = CO_CANopenInit(CO,                   /* CANopen object */
+                             NULL,                 /* alternate NMT */
+                             NULL,                 /* alternate em */
+                             OD,                   /* Object dictionary */
+                             OD_STATUS_BITS,       /* Optional OD_statusBits */
+                             NMT_CONTROL,          /* CO_NMT_control_t */
+                             FIRST_HB_TIME,        /* firstHBTime_ms */
+                             SDO_SRV_TIMEOUT_TIME, /* SDOserverTimeoutTime_ms */
+                             SDO_CLI_TIMEOUT_TIME, /* SDOclientTimeoutTime_ms */
+                             SDO_CLI_BLOCK,        /* SDOclientBlockTransfer */
+                             activeNodeId, &errInfo);
+        if (err != CO_ERROR_NO && err != CO_ERROR_NODE_ID_UNCONFIGURED_LSS) {
+            if (err == CO_ERROR_OD_PARAMETERS) {
+                log_printf("Error: Object Dictionary entry 0x%X\n", errInfo);
+            } else {
+                log_printf("Error: CANopen initialization failed: %d\n", err);
+            }
+            return EXIT_FAILURE;
+        }
+
+        err = CO_CANopenInitPDO(CO, CO->em, OD, activeNodeId, &errInfo);
+        if (err != CO_ERROR_NO && err != CO_ERROR_NODE_ID_UNCONFIGURED_LSS) {
+            if (err == CO_ERROR_OD_PARAMETERS) {
+                log_printf("Error: Object Dictionary entry 0x%X\n", errInfo);
+            } else {
+                log_printf("Error: PDO initialization failed: %d\n", err);
+            }
+            return EXIT_FAILURE;
+        }
+
+        /* Wake up on received CAN frames and on gateway commands */
+        err = CO_epoll_initCANopenMain(&epMain, CO);
+        if (err != CO_ERROR_NO) {
+            log_printf("Error: epoll initialization failed: %d\n", err);
+            return EXIT_FAILURE;
+        }
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII
+        CO_epoll_initCANopenGtw(&epGtw, CO);
+#endif
+
+        /* Configure CANopen callbacks, etc */
+        if (!CO->nodeIdUnconfigured) {
+#if (CO_CONFIG_STORAGE) & CO_CONFIG_STORAGE_ENABLE
+            if (storageInitError != 0) {
+                CO_errorReport(CO->em, CO_EM_NON_VOLATILE_MEMORY, CO_EMC_HARDWARE, storageInitError);
+            }
+#endif
+        } else {
+            log_printf("CANopenNode - Node-id not initialized\n");
+        }
+
+        /* start CAN */
+        CO_CANsetNormalMode(CO->CANmodule);
+
+        reset = CO_RESET_NOT;
+
+        log_printf("CANopenNode - Running on %s...\n", CANdevice);
+        fflush(stdout);
+
+        while (reset == CO_RESET_NOT && CO_endProgram == 0) {
+            /* loop for normal program execution ******************************************/
+            CO_epoll_wait(&epMain);
+            CO_epoll_processRT(&epMain, CO, false);
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII
+            CO_epoll_processGtw(&epGtw, CO, &epMain);
+#endif
+            CO_epoll_processMain(&epMain, CO, true, &reset);
+
+            /* Nonblocking application code may go here, it may lower epMain.timerNext_us. */
+
+            CO_epoll_processLast(&epMain);
+        }
+    }
+
+    /* program exit ***************************************************************/
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII
+    CO_epoll_closeGtw(&epGtw);
+#endif
+    CO_epoll_close(&epMain);
+
+    /* delete objects from memory */
+    CO_CANsetConfigurationMode((void*)&CANptr);
+    CO_delete(CO);
+
+    log_printf("CANopenNode finished\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/*
+ * CANopen main program file for several Linux socketCAN interfaces.
+ *
+ * Each CAN interface runs its own CANopen device in its own thread, see CO_network.h. Main thread only prints status
+ * of the networks once per second.
+ *
+ * @file        main_multi.c
+ * @author      Janez Paternoster
+ * @copyright   2021 Janez Paternoster
+ *
+ * This file is part of <https://github.com/CANopenNode/CANopenNode>, a CANopen Stack.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "CANopen.h"
+#include "OD.h"
+#include "OD_hash.h"
+#include "CO_network.h"
+
+#define log_printf(macropar_message, ...) printf(macropar_message, ##__VA_ARGS__)
+
+/* Maximum number of CAN interfaces */
+#define MAX_NETWORKS 8
+
+/* Maximum interval between two wakeups, if no CANopen timer is running */
+#ifndef MAIN_THREAD_INTERVAL_US
+#define MAIN_THREAD_INTERVAL_US 100000
+#endif
+
+static volatile sig_atomic_t CO_endProgram = 0;
+
+static void
+sigHandler(int sig) {
+    (void)sig;
+    CO_endProgram = 1;
+}
+
+static void
+printUsage(char* progName) {
+    printf("Usage: %s [options] <CAN device name>[:<Node ID>[:<CPU>]] ...\n", progName);
+    printf("\n"
+           "Each CAN device runs its own CANopen device in its own thread. Node ID is 1..127, default is 10. CPU is\n"
+           "the core for the network thread, default is no affinity.\n"
+           "\n"
+           "Options:\n"
+           "  -p <priority>       SCHED_FIFO priority of the network threads (1..99), default is normal scheduling.\n"
+           "\n"
+           "Example: %s -p 80 can0:1:1 can1:1:2\n"
+           "\n",
+           progName);
+}
+
+/* Parse "<CAN device name>[:<Node ID>[:<CPU>]]", modifies arg. Return false on error. */
+static bool_t
+parseNetwork(char* arg, CO_networkConfig_t* config) {
+    char* nodeIdStr = strchr(arg, ':');
+    char* cpuStr = NULL;
+
+    config->ifName = arg;
+    config->nodeId = 10;
+    config->cpu = -1;
+    if (nodeIdStr != NULL) {
+        *nodeIdStr++ = '\0';
+        cpuStr = strchr(nodeIdStr, ':');
+        if (cpuStr != NULL) {
+            *cpuStr++ = '\0';
+        }
+        long nodeId = strtol(nodeIdStr, NULL, 0);
+        if (nodeId < 1 || nodeId > 127) {
+            return false;
+        }
+        config->nodeId = (uint8_t)nodeId;
+    }
+    if (cpuStr != NULL) {
+        long cpu = strtol(cpuStr, NULL, 0);
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        config->cpu = (int)cpu;
+    }
+    return true;
+}
+
+/* main ***********************************************************************/
+int
+main(int argc, char* argv[]) {
+    CO_ReturnError_t err;
+    CO_networkConfig_t configs[MAX_NETWORKS];
+    CO_network_t networks[MAX_NETWORKS];
+    CO_network_ODregion_t ODregions[] = {{.addr = &OD_RAM, .len = sizeof(OD_RAM)},
+                                         {.addr = &OD_PERSIST_COMM, .len = sizeof(OD_PERSIST_COMM)}};
+    uint8_t ODregionCount = sizeof(ODregions) / sizeof(ODregions[0]);
+    uint8_t count = 0;
+    int priority = 0;
+    int opt;
+    uint8_t i;
+
+    /* Get program options */
+    if (argc < 2 || strcmp(argv[1], "--help") == 0) {
+        printUsage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+    while ((opt = getopt(argc, argv, "p:")) != -1) {
+        switch (opt) {
+            case 'p': {
+                long priorityFromArgs = strtol(optarg, NULL, 0);
+                if (priorityFromArgs < 1 || priorityFromArgs > 99) {
+                    log_printf("Error: Wrong priority (%s)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                priority = (int)priorityFromArgs;
+                break;
+            }
+            default: printUsage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((argc - optind) > MAX_NETWORKS) {
+        log_printf("Error: Maximum %d CAN devices\n", MAX_NETWORKS);
+        return EXIT_FAILURE;
+    }
+
+#if OD_HASH > 0
+    /* Verify Object Dictionary and enable its hash index, copies of the OD share it */
+    if (OD_initHash(OD, &OD_hash) != ODR_OK) {
+        log_printf("Error: OD is not ordered by index or OD_hash.c does not match OD.c\n");
+        return EXIT_FAILURE;
+    }
+#endif
+
+    memset(configs, 0, sizeof(configs));
+    for (; optind < argc; optind++, count++) {
+        CO_networkConfig_t* config = &configs[count];
+
+        if (!parseNetwork(argv[optind], config)) {
+            log_printf("Error: Wrong network argument (%s)\n", argv[optind]);
+            return EXIT_FAILURE;
+        }
+        config->priority = priority;
+        config->interval_us = MAIN_THREAD_INTERVAL_US;
+
+        /* First network uses generated Object Dictionary, others use its copy */
+        config->od = count == 0U ? OD : CO_network_cloneOD(OD, ODregions, ODregionCount);
+        if (config->od == NULL) {
+            log_printf("Error: Can't allocate memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (signal(SIGINT, sigHandler) == SIG_ERR || signal(SIGTERM, sigHandler) == SIG_ERR) {
+        log_printf("Error: signal handler\n");
+        return EXIT_FAILURE;
+    }
+
+    err = CO_network_start(networks, configs, count);
+    if (err != CO_ERROR_NO) {
+        log_printf("Error: Networks start failed: %d\n", err);
+        return EXIT_FAILURE;
+    }
+    log_printf("CANopenNode - Running %d networks...\n", count);
+    fflush(stdout);
+
+    while (CO_endProgram == 0) {
+        bool_t running = false;
+
+        (void)sleep(1);
+        for (i = 0; i < count; i++) {
+            CO_networkStatus_t status;
+
+            CO_network_getStatus(&networks[i], &status);
+            if (status.state == CO_NETWORK_RUNNING) {
+                running = true;
+            }
+            log_printf("%s: state=%d NMT=%d CANerr=0x%04X err=%d(0x%X) resets=%u loops=%llu loopMax=%uus\n",
+                       configs[i].ifName, status.state, status.NMTstate, status.CANerrorStatus, status.lastError,
+                       status.errInfo, status.resetCount, (unsigned long long)status.loopCount, status.loopMax_us);
+        }
+        fflush(stdout);
+        if (!running) {
+            break;
+        }
+    }
+
+    /* program exit ***************************************************************/
+    CO_network_stop(networks, count);
+    for (i = 1; i < count; i++) {
+        CO_network_deleteOD(configs[i].od);
+    }
+
+    log_printf("CANopenNode finished\n");
+
+    return EXIT_SUCCESS;
+}
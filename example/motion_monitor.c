@@ -0,0 +1,156 @@
+/*
+ * author: ZeroErr Inc.
+ * Event-driven motion monitor with latency histograms, see motion_monitor.h
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "motion_monitor.h"
+#include "app_log.h"
+#include "cia402.h"
+
+#define SW_TARGET_REACHED 0x0400
+#define SW_SETPOINT_ACK 0x1000
+
+void motion_monitor_init(motion_monitor_t *mon) {
+    memset(mon, 0, sizeof(*mon));
+}
+
+monitor_axis_t *motion_monitor_axis(motion_monitor_t *mon, uint8_t node_id) {
+    for (uint8_t i = 0; i < mon->count; i++) {
+        if (mon->axes[i].node_id == node_id) {
+            return &mon->axes[i];
+        }
+    }
+    if (mon->count >= MONITOR_AXES_MAX) {
+        return NULL;
+    }
+    monitor_axis_t *axis = &mon->axes[mon->count++];
+    memset(axis, 0, sizeof(*axis));
+    axis->node_id = node_id;
+    return axis;
+}
+
+static void hist_add(monitor_hist_t *hist, uint64_t latency_us) {
+    uint32_t us = latency_us > UINT32_MAX ? UINT32_MAX : (uint32_t)latency_us;
+    int bucket = 0;
+
+    while (bucket < MONITOR_HIST_BUCKETS - 1 && (us >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    if (hist->count == 0 || us < hist->min_us) {
+        hist->min_us = us;
+    }
+    if (us > hist->max_us) {
+        hist->max_us = us;
+    }
+    hist->sum_us += us;
+    hist->count++;
+    hist->buckets[bucket]++;
+}
+
+/* Upper bound of the bucket, which contains the given fraction of the samples */
+static uint32_t hist_percentile(const monitor_hist_t *hist, double fraction) {
+    uint32_t limit = (uint32_t)(hist->count * fraction + 0.5);
+    uint32_t sum = 0;
+
+    for (int i = 0; i < MONITOR_HIST_BUCKETS; i++) {
+        sum += hist->buckets[i];
+        if (sum >= limit && sum > 0) {
+            uint32_t upper = (2U << i) - 1U;
+            return upper < hist->max_us ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+void motion_monitor_command(motion_monitor_t *mon, uint8_t node_id, int32_t target, uint64_t now_us) {
+    monitor_axis_t *axis = motion_monitor_axis(mon, node_id);
+    if (axis == NULL) {
+        return;
+    }
+    axis->command_pending = 1;
+    axis->command_acked = 0;
+    axis->command_moving = 0;
+    axis->command_target = target;
+    axis->command_us = now_us;
+}
+
+void motion_monitor_update(motion_monitor_t *mon, uint8_t node_id, uint16_t statusword, int32_t position,
+                           uint64_t now_us) {
+    monitor_axis_t *axis = motion_monitor_axis(mon, node_id);
+    if (axis == NULL) {
+        return;
+    }
+    uint16_t changed = axis->updates == 0 ? 0xFFFF : (uint16_t)(axis->statusword ^ statusword);
+    axis->statusword = statusword;
+    axis->position = position;
+    axis->update_us = now_us;
+    axis->updates++;
+
+    if (changed != 0) {
+        uint8_t data[6] = {statusword & 0xFF, statusword >> 8, position & 0xFF, (position >> 8) & 0xFF,
+                           (position >> 16) & 0xFF, (position >> 24) & 0xFF};
+        app_log_event(APP_LOG_INFO, APP_LOG_EV_STATUS, node_id, data, sizeof(data), 0);
+    }
+    if (!axis->command_pending) {
+        return;
+    }
+
+    uint64_t latency_us = now_us - axis->command_us;
+    if (!axis->command_acked && (statusword & SW_SETPOINT_ACK) != 0) {
+        axis->command_acked = 1;
+        hist_add(&axis->ack_hist, latency_us);
+        app_log_event(APP_LOG_INFO, APP_LOG_EV_SETPOINT_ACK, node_id, NULL, 0, (uint32_t)latency_us);
+    }
+    if ((statusword & SW_TARGET_REACHED) == 0) {
+        axis->command_moving = 1;
+    } else if (axis->command_acked
+               && (axis->command_moving || abs(position - axis->command_target) <= MONITOR_TARGET_WINDOW)) {
+        axis->command_pending = 0;
+        hist_add(&axis->reached_hist, latency_us);
+        app_log_event(APP_LOG_INFO, APP_LOG_EV_TARGET_REACHED, node_id, NULL, 0, (uint32_t)latency_us);
+    }
+}
+
+void motion_monitor_reset(motion_monitor_t *mon) {
+    for (uint8_t i = 0; i < mon->count; i++) {
+        memset(&mon->axes[i].ack_hist, 0, sizeof(monitor_hist_t));
+        memset(&mon->axes[i].reached_hist, 0, sizeof(monitor_hist_t));
+    }
+}
+
+static void hist_print(const monitor_hist_t *hist, const char *name, FILE *out) {
+    if (hist->count == 0) {
+        fprintf(out, "  %-26s no samples\n", name);
+        return;
+    }
+    fprintf(out, "  %-26s n=%u min=%.3f avg=%.3f max=%.3f p50<=%.3f p90<=%.3f p99<=%.3f ms\n", name, hist->count,
+            hist->min_us / 1000.0, (double)hist->sum_us / hist->count / 1000.0, hist->max_us / 1000.0,
+            hist_percentile(hist, 0.5) / 1000.0, hist_percentile(hist, 0.9) / 1000.0,
+            hist_percentile(hist, 0.99) / 1000.0);
+    for (int i = 0; i < MONITOR_HIST_BUCKETS; i++) {
+        if (hist->buckets[i] == 0) {
+            continue;
+        }
+        int bar = (int)((uint64_t)hist->buckets[i] * 40 / hist->count);
+        fprintf(out, "    %9.3f ms %6u |%.*s\n", (1U << i) / 1000.0, hist->buckets[i], bar > 0 ? bar : 1,
+                "########################################");
+    }
+}
+
+void motion_monitor_print(const motion_monitor_t *mon, FILE *out) {
+    if (mon->count == 0) {
+        fprintf(out, "Motion monitor: no TPDO received yet\n");
+        return;
+    }
+    for (uint8_t i = 0; i < mon->count; i++) {
+        const monitor_axis_t *axis = &mon->axes[i];
+        fprintf(out, "Axis %d: %s, status word 0x%04X, position %d, %u updates%s\n", axis->node_id,
+                cia402_state_name(cia402_state(axis->statusword)), axis->statusword, axis->position, axis->updates,
+                axis->command_pending ? ", setpoint in progress" : "");
+        hist_print(&axis->ack_hist, "command -> setpoint ack:", out);
+        hist_print(&axis->reached_hist, "command -> target reached:", out);
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * author: ZeroErr Inc.
+ * Event-driven motion monitor with latency histograms
+ *
+ * Monitor is fed with statusword and position actual value of each axis as soon as they are received, usually from
+ * the receive callback of the drive TPDO. Statusword changes (CiA402 state, setpoint acknowledge, target reached,
+ * fault) are recorded in the event log (app_log.h) at the moment they arrive. When the application sends a new
+ * setpoint, it calls motion_monitor_command(); monitor then measures the time to the setpoint acknowledge (statusword
+ * bit 12) and to target reached (bit 10) and adds them to per-axis histograms.
+ *
+ * Monitor is not thread safe, all functions must be called from the thread, which processes CAN reception.
+ */
+
+#ifndef MOTION_MONITOR_H
+#define MOTION_MONITOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define MONITOR_AXES_MAX 16          // Number of monitored nodes
+#define MONITOR_HIST_BUCKETS 24      // Bucket k counts latencies of 2^k..2^(k+1)-1 us, last bucket also longer ones
+#define MONITOR_TARGET_WINDOW 100    // Target is reached without motion, if position is this close to it (counts)
+
+// Latency histogram, logarithmic buckets in microseconds
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[MONITOR_HIST_BUCKETS];
+} monitor_hist_t;
+
+// State of one axis
+typedef struct {
+    uint8_t node_id;
+    uint16_t statusword;         // Last received statusword
+    int32_t position;            // Last received position actual value
+    uint64_t update_us;          // Time of the last update
+    uint32_t updates;            // Number of updates
+    // Setpoint, which waits for acknowledge and target reached
+    int command_pending;
+    int command_acked;
+    int command_moving;          // Target reached bit was 0 since the command
+    int32_t command_target;
+    uint64_t command_us;
+    monitor_hist_t ack_hist;     // Command to statusword bit 12
+    monitor_hist_t reached_hist; // Command to statusword bit 10
+} monitor_axis_t;
+
+typedef struct {
+    monitor_axis_t axes[MONITOR_AXES_MAX];
+    uint8_t count;
+} motion_monitor_t;
+
+/* Remove all axes */
+void motion_monitor_init(motion_monitor_t *mon);
+
+/* Find axis, add it, if it is not monitored yet. Return NULL, if there is no free axis. */
+monitor_axis_t *motion_monitor_axis(motion_monitor_t *mon, uint8_t node_id);
+
+/* Application sent new setpoint to the axis at time now_us */
+void motion_monitor_command(motion_monitor_t *mon, uint8_t node_id, int32_t target, uint64_t now_us);
+
+/* Statusword and position actual value were received at time now_us */
+void motion_monitor_update(motion_monitor_t *mon, uint8_t node_id, uint16_t statusword, int32_t position,
+                           uint64_t now_us);
+
+/* Clear histograms of all axes */
+void motion_monitor_reset(motion_monitor_t *mon);
+
+/* Print state and latency histograms of all axes */
+void motion_monitor_print(const motion_monitor_t *mon, FILE *out);
+
+#endif // MOTION_MONITOR_H
@@ -0,0 +1,819 @@
+/*
+ * author: ZeroErr Inc.
+ * CANopen multi-axis coordinated controller for several eRob joints on one CAN bus
+ * Based on CiA402 standard and eRob CANopen and EtherCAT User Manual V1.9
+ * Uses Cyclic Synchronous Position mode (CSP, 0x6060 = 8)
+ *
+ * Features:
+ * - Axis table with state, PDO mapping and last status of each node
+ * - SDO configuration of all axes in parallel: one request per axis is on the bus at the same time, so configuration
+ *   time does not grow with the number of axes
+ * - All axes are enabled in parallel through the CiA402 state machine (cia402.h) in RPDO1 controlword, each
+ *   transition follows the statusword in TPDO1 and has its own timeout
+ * - Each cycle one SYNC is followed by RPDO1 of all axes in a single sendmmsg() call, drives latch the setpoints
+ *   together on the next SYNC
+ * - TPDO1 (statusword, position actual value) of all axes is gathered within the cycle into one process image
+ *   (CO_procImage.h), one array per value, missing TPDOs are counted
+ * - Setpoints of all axes are in one array, checked against the position limits with one batch call before sending
+ * - Coordinated moves: all axes start and finish together, duration is given by the longest move
+ *
+ * Bus usage per cycle: 1 SYNC + N RPDO1 (6 bytes) + N TPDO1 (6 bytes). Maximum number of axes for the selected
+ * period and bitrate is printed at startup.
+ */
+
+// _GNU_SOURCE (sendmmsg, recvmmsg) is defined by canopennode_socketcan
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+#include "cia402.h"
+#include "extra/CO_procImage.h"
+
+// Configuration constants
+#define MAX_AXES 16                 // Maximum number of axes in the axis table
+#define MAX_MOVES 16                // Maximum number of moves from the command line
+#define SDO_TIMEOUT_MS 500          // Timeout for one SDO response
+#define ENABLE_TRANSITION_TIMEOUT_MS 1000  // Each CiA402 transition of the enable sequence must finish within this time
+#define SHUTDOWN_CYCLES 20          // Cycles with "shutdown" controlword before NMT pre-operational on exit
+#define STATUS_PRINT_INTERVAL_MS 1000
+
+#if MAX_AXES > CO_PROC_IMAGE_AXES
+#error MAX_AXES must not be larger than CO_PROC_IMAGE_AXES
+#endif
+
+// Motor parameters
+#define MOTOR_RESOLUTION 524288  // Resolution per revolution
+
+// NMT commands
+#define NMT_START 0x01
+#define NMT_PRE_OPERATIONAL 0x80
+
+// PDO mapping entry
+#define PDO_MAP(index, subindex, bits) (((uint32_t)(index) << 16) | ((uint32_t)(subindex) << 8) | (uint32_t)(bits))
+#define PDO_COB_ID_INVALID 0x80000000U
+
+// State of one axis
+typedef enum {
+    AXIS_CONFIG,     // SDO configuration in progress
+    AXIS_ENABLING,   // drive is operational, CiA402 enable sequence in progress
+    AXIS_ENABLED,    // drive is in "operation enabled", follows setpoints
+    AXIS_FAULT,      // drive reported fault, fault reset is requested
+    AXIS_ERROR       // SDO configuration failed, axis is not used
+} axis_state_t;
+
+// One SDO download of the configuration
+typedef struct {
+    uint16_t index;
+    uint8_t subindex;
+    uint8_t size;
+    uint32_t value;
+    int optional;  // SDO abort is not an error
+} sdo_step_t;
+
+// Axis table entry
+typedef struct {
+    uint8_t node_id;
+    axis_state_t state;
+    // PDO mapping
+    uint16_t rpdo_cob_id;      // controlword + target position, sent by this program
+    uint16_t tpdo_cob_id;      // statusword + position actual value, received from the drive
+    // SDO configuration
+    uint8_t sdo_step;          // index in sdo_steps[]
+    uint64_t sdo_sent_us;      // time of the pending SDO request, 0 if none
+    uint32_t sdo_abort;        // abort code of the failed SDO
+    // last status, statusword and position actual value are in the process image
+    uint32_t tpdo_count;       // number of received TPDO1
+    int tpdo_this_cycle;       // TPDO1 received since the last SYNC
+    uint32_t tpdo_missed;      // cycles without TPDO1
+    // CiA402 enable sequence
+    cia402_axis_t sm;
+    // setpoint
+    uint16_t control_word;
+    int32_t home_position;     // position when all axes were enabled, moves are relative to it
+    int32_t move_start;        // position at the start of the current move
+    int32_t move_distance;     // distance of the current move
+    int32_t following_max;     // largest |target - actual| since the last status print
+} axis_t;
+
+static axis_t axes[MAX_AXES];
+static int axis_count = 0;
+
+// Received TPDO1 values and setpoints of all axes, index is the same as in axes[]
+static CO_procImage_t image;
+static int32_t target_positions[MAX_AXES];
+
+// SDO configuration, same for all axes; COB-IDs are completed per axis
+static sdo_step_t sdo_steps[32];
+static int sdo_step_count = 0;
+
+// Motion parameters
+static uint32_t period_us = 1000;
+static uint32_t bitrate = 1000000;
+static double profile_velocity = MOTOR_RESOLUTION / 10;  // counts/s, for the longest move
+static double profile_acceleration = MOTOR_RESOLUTION;   // counts/s^2
+static uint32_t dwell_ms = 500;
+static int32_t position_min = INT32_MIN;  // limits of setpoints and actual positions of all axes, counts
+static int32_t position_max = INT32_MAX;
+static int32_t moves[MAX_MOVES][MAX_AXES];  // relative moves from the start position of each axis
+static int move_count = 0;
+
+volatile int running = 1;
+
+void signal_handler(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static uint64_t time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+// Worst case length of the standard CAN frame with bit stuffing, in bits
+static uint32_t can_frame_bits(uint8_t dlc) {
+    return 8U * dlc + 44U + (34U + 8U * dlc - 1U) / 4U;
+}
+
+static void sdo_step_add(uint16_t index, uint8_t subindex, uint8_t size, uint32_t value, int optional) {
+    if (sdo_step_count < (int)(sizeof(sdo_steps) / sizeof(sdo_steps[0]))) {
+        sdo_steps[sdo_step_count++] = (sdo_step_t){index, subindex, size, value, optional};
+    }
+}
+
+// PDO configuration: disable PDO, write mapping, set synchronous transmission and enable PDO. Value of the COB-ID
+// entries is base COB-ID, node ID is added for each axis.
+static void sdo_steps_add_pdo(uint16_t comm_index, uint16_t cob_id_base, const uint32_t *map, uint8_t map_count) {
+    uint16_t map_index = comm_index + 0x200;
+
+    sdo_step_add(comm_index, 1, 4, PDO_COB_ID_INVALID | cob_id_base, 0);
+    sdo_step_add(map_index, 0, 1, 0, 0);
+    for (uint8_t i = 0; i < map_count; i++) {
+        sdo_step_add(map_index, i + 1, 4, map[i], 0);
+    }
+    sdo_step_add(map_index, 0, 1, map_count, 0);
+    sdo_step_add(comm_index, 2, 1, 1, 0);  // synchronous, every SYNC
+    sdo_step_add(comm_index, 1, 4, cob_id_base, 0);
+}
+
+static void sdo_steps_init(void) {
+    const uint32_t rpdo1[] = {PDO_MAP(0x6040, 0, 16), PDO_MAP(0x607A, 0, 32)};
+    const uint32_t tpdo1[] = {PDO_MAP(0x6041, 0, 16), PDO_MAP(0x6064, 0, 32)};
+    uint32_t value = period_us;
+    int8_t exponent = -6;
+
+    // interpolation time period: value * 10^exponent seconds, value is 8-bit
+    while (value > 255) {
+        value /= 10;
+        exponent++;
+    }
+
+    sdo_step_count = 0;
+    sdo_steps_add_pdo(0x1400, 0x200, rpdo1, 2);
+    sdo_steps_add_pdo(0x1800, 0x180, tpdo1, 2);
+    sdo_step_add(0x1801, 1, 4, PDO_COB_ID_INVALID | 0x280, 1);  // TPDO2 is not used
+    sdo_step_add(0x60C2, 1, 1, value, 1);
+    sdo_step_add(0x60C2, 2, 1, (uint8_t)exponent, 1);
+    sdo_step_add(0x6060, 0, 1, 8, 0);  // Cyclic Synchronous Position mode
+}
+
+// Value of the SDO step for the axis, COB-IDs get node ID
+static uint32_t sdo_step_value(const sdo_step_t *step, const axis_t *axis) {
+    uint16_t comm = step->index & 0xFF00;
+
+    if ((comm == 0x1400 || comm == 0x1800) && step->subindex == 1) {  // PDO COB-ID
+        return step->value + axis->node_id;
+    }
+    return step->value;
+}
+
+static int send_frame(int sock, uint32_t can_id, const uint8_t *data, uint8_t dlc) {
+    struct can_frame frame = {.can_id = can_id, .can_dlc = dlc};
+
+    if (dlc > 0) {
+        memcpy(frame.data, data, dlc);
+    }
+    if (write(sock, &frame, sizeof(frame)) != sizeof(frame)) {
+        perror("Send frame failed");
+        return -1;
+    }
+    return 0;
+}
+
+int send_nmt_command(int sock, uint8_t command, uint8_t node_id) {
+    uint8_t data[2] = {command, node_id};
+    return send_frame(sock, 0x000, data, 2);
+}
+
+static int send_sdo_download(int sock, axis_t *axis) {
+    const sdo_step_t *step = &sdo_steps[axis->sdo_step];
+    uint32_t value = sdo_step_value(step, axis);
+    uint8_t data[8] = {0};
+
+    data[0] = 0x23 | ((4 - step->size) << 2);  // expedited download, size indicated
+    data[1] = step->index & 0xFF;
+    data[2] = step->index >> 8;
+    data[3] = step->subindex;
+    for (int i = 0; i < 4; i++) {
+        data[4 + i] = (value >> (8 * i)) & 0xFF;
+    }
+    axis->sdo_sent_us = time_us();
+    return send_frame(sock, 0x600 + axis->node_id, data, 8);
+}
+
+// Next SDO step of the axis or end of the configuration
+static void sdo_step_next(int sock, axis_t *axis) {
+    axis->sdo_sent_us = 0;
+    if (++axis->sdo_step >= sdo_step_count) {
+        send_nmt_command(sock, NMT_START, axis->node_id);
+        axis->state = AXIS_ENABLING;
+        cia402_init(&axis->sm, axis->node_id, ENABLE_TRANSITION_TIMEOUT_MS);
+        cia402_enable(&axis->sm, time_us());
+    } else {
+        send_sdo_download(sock, axis);
+    }
+}
+
+// Index of the axis in axes[], process image and target_positions[]
+static int axis_index(const axis_t *axis) {
+    return (int)(axis - axes);
+}
+
+static axis_t *find_axis(uint8_t node_id) {
+    for (int i = 0; i < axis_count; i++) {
+        if (axes[i].node_id == node_id) {
+            return &axes[i];
+        }
+    }
+    return NULL;
+}
+
+static void handle_frame(int sock, const struct can_frame *frame) {
+    uint32_t id = frame->can_id & CAN_SFF_MASK;
+    axis_t *axis = find_axis(id & 0x7F);
+
+    if (axis == NULL || (frame->can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG)) != 0) {
+        return;
+    }
+    if (id == axis->tpdo_cob_id && frame->can_dlc >= 6) {
+        int n = axis_index(axis);
+        image.statusword[n] = frame->data[0] | (frame->data[1] << 8);
+        memcpy(&image.position[n], &frame->data[2], 4);
+        axis->tpdo_count++;
+        axis->tpdo_this_cycle = 1;
+    } else if (id == 0x580U + axis->node_id && axis->state == AXIS_CONFIG && axis->sdo_sent_us != 0) {
+        const sdo_step_t *step = &sdo_steps[axis->sdo_step];
+        uint16_t index = frame->data[1] | (frame->data[2] << 8);
+
+        if (index != step->index || frame->data[3] != step->subindex) {
+            return;  // response to something else
+        }
+        if (frame->data[0] == 0x60) {
+            sdo_step_next(sock, axis);
+        } else if (frame->data[0] == 0x80) {
+            memcpy(&axis->sdo_abort, &frame->data[4], 4);
+            if (step->optional) {
+                printf("Axis %d: 0x%04X:%02X not written, SDO abort 0x%08X\n", axis->node_id, step->index,
+                       step->subindex, axis->sdo_abort);
+                sdo_step_next(sock, axis);
+            } else {
+                printf("Axis %d: 0x%04X:%02X SDO abort 0x%08X, axis disabled\n", axis->node_id, step->index,
+                       step->subindex, axis->sdo_abort);
+                axis->sdo_sent_us = 0;
+                axis->state = AXIS_ERROR;
+            }
+        }
+    }
+}
+
+// Receive all waiting frames, up to the deadline
+static void receive_until(int sock, uint64_t deadline_us) {
+    struct can_frame frames[32];
+    struct mmsghdr msgs[32];
+    struct iovec iov[32];
+
+    for (int i = 0; i < 32; i++) {
+        iov[i] = (struct iovec){.iov_base = &frames[i], .iov_len = sizeof(frames[i])};
+        msgs[i] = (struct mmsghdr){.msg_hdr = {.msg_iov = &iov[i], .msg_iovlen = 1}};
+    }
+
+    for (;;) {
+        uint64_t now = time_us();
+        struct pollfd pfd = {.fd = sock, .events = POLLIN};
+
+        if (now >= deadline_us) {
+            break;
+        }
+        uint64_t remaining = deadline_us - now;
+        struct timespec ts = {.tv_sec = remaining / 1000000, .tv_nsec = (remaining % 1000000) * 1000};
+        if (ppoll(&pfd, 1, &ts, NULL) <= 0) {
+            continue;
+        }
+        int n = recvmmsg(sock, msgs, 32, MSG_DONTWAIT, NULL);
+        for (int i = 0; i < n; i++) {
+            if (msgs[i].msg_len == sizeof(struct can_frame)) {
+                handle_frame(sock, &frames[i]);
+            }
+        }
+    }
+}
+
+// Send SYNC and RPDO1 of all axes with one system call; SYNC goes first, so setpoints are latched together
+static int send_sync_and_rpdos(int sock) {
+    struct can_frame frames[MAX_AXES + 1];
+    struct mmsghdr msgs[MAX_AXES + 1];
+    struct iovec iov[MAX_AXES + 1];
+    int count = 0;
+
+    memset(frames, 0, sizeof(frames));
+    memset(msgs, 0, sizeof(msgs));
+    frames[count++].can_id = 0x080;
+    for (int i = 0; i < axis_count; i++) {
+        axis_t *axis = &axes[i];
+        struct can_frame *frame = &frames[count++];
+
+        if (axis->state == AXIS_CONFIG || axis->state == AXIS_ERROR) {
+            count--;
+            continue;
+        }
+        frame->can_id = axis->rpdo_cob_id;
+        frame->can_dlc = 6;
+        frame->data[0] = axis->control_word & 0xFF;
+        frame->data[1] = axis->control_word >> 8;
+        memcpy(&frame->data[2], &target_positions[i], 4);
+    }
+    for (int i = 0; i < count; i++) {
+        iov[i] = (struct iovec){.iov_base = &frames[i], .iov_len = sizeof(frames[i])};
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    for (int sent = 0; sent < count;) {
+        int n = sendmmsg(sock, &msgs[sent], count - sent, 0);
+        if (n < 0) {
+            if (errno == ENOBUFS || errno == EAGAIN) {
+                continue;  // transmit queue of the interface is full, retry
+            }
+            perror("Send SYNC and RPDOs failed");
+            return -1;
+        }
+        sent += n;
+    }
+    return 0;
+}
+
+// CiA402 enable sequence of one axis, from the last statusword. Return -1, if a transition timed out.
+static int axis_update_state(axis_t *axis, uint64_t now_us) {
+    int n = axis_index(axis);
+
+    if (axis->state == AXIS_CONFIG || axis->state == AXIS_ERROR) {
+        return 0;
+    }
+    if (axis->tpdo_count > 0) {
+        cia402_update(&axis->sm, image.statusword[n], now_us);
+    }
+    cia402_process(&axis->sm, now_us);
+    if (axis->sm.status == CIA402_SM_IDLE) {
+        // drive left "operation enabled" by itself, enable it again
+        cia402_enable(&axis->sm, now_us);
+    }
+    axis->control_word = axis->sm.controlword;
+
+    if (axis->sm.status == CIA402_SM_FAILED) {
+        return -1;
+    }
+    if (axis->sm.status == CIA402_SM_ENABLED) {
+        axis->state = AXIS_ENABLED;
+    } else if (axis->sm.state == CIA402_FAULT) {  // fault reset is repeated by the state machine
+        if (axis->state != AXIS_FAULT) {
+            printf("Axis %d: fault, statusword 0x%04X\n", axis->node_id, image.statusword[n]);
+        }
+        axis->state = AXIS_FAULT;
+    } else {
+        axis->state = AXIS_ENABLING;
+    }
+    // until enabled, setpoint follows the actual position, so drive does not jump
+    if (axis->state != AXIS_ENABLED) {
+        target_positions[n] = image.position[n];
+    }
+    return 0;
+}
+
+// Normalized trapezoidal profile over the distance of the longest axis. Return position along the longest move.
+static double profile_position(double distance, double t, double *duration) {
+    double v = profile_velocity;
+    double a = profile_acceleration;
+    double t_acc = v / a;
+    double t_const;
+
+    if (distance < v * t_acc) {  // triangle profile
+        t_acc = sqrt(distance / a);
+        v = a * t_acc;
+        t_const = 0;
+    } else {
+        t_const = (distance - v * t_acc) / v;
+    }
+    *duration = 2 * t_acc + t_const;
+
+    if (t <= 0) {
+        return 0;
+    } else if (t < t_acc) {
+        return 0.5 * a * t * t;
+    } else if (t < t_acc + t_const) {
+        return 0.5 * a * t_acc * t_acc + v * (t - t_acc);
+    } else if (t < *duration) {
+        double t_dec = *duration - t;
+        return distance - 0.5 * a * t_dec * t_dec;
+    }
+    return distance;
+}
+
+// Start move number n: record start positions and distances of all axes
+static double start_move(int n) {
+    double longest = 0;
+
+    for (int i = 0; i < axis_count; i++) {
+        axis_t *axis = &axes[i];
+
+        axis->move_start = target_positions[i];
+        axis->move_distance = axis->home_position + moves[n][i] - axis->move_start;
+        if (fabs((double)axis->move_distance) > longest) {
+            longest = fabs((double)axis->move_distance);
+        }
+    }
+    return longest;
+}
+
+static void print_status(uint32_t cycles, uint32_t late_max_us) {
+    float turns[MAX_AXES];
+
+    CO_procImage_toUnits(image.position, turns, (uint16_t)axis_count, CO_PROC_IMAGE_SCALE_TURNS(MOTOR_RESOLUTION));
+    printf("cycles=%u late_max=%uus |", cycles, late_max_us);
+    for (int i = 0; i < axis_count; i++) {
+        axis_t *axis = &axes[i];
+        printf(" %d:%s sw=%04X pos=%d/%.3ft ferr=%d miss=%u |", axis->node_id,
+               axis->state == AXIS_ENABLED ? "EN" : axis->state == AXIS_FAULT ? "FLT"
+                                                : axis->state == AXIS_ERROR ? "ERR"
+                                                : axis->state == AXIS_CONFIG ? "CFG" : "ENA",
+               image.statusword[i], image.position[i], turns[i], axis->following_max, axis->tpdo_missed);
+        axis->following_max = 0;
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+// Parse comma separated list of moves, last value repeats for remaining axes
+static int parse_move(char *arg, int32_t *move) {
+    char *save = NULL;
+    int count = 0;
+    int32_t last = 0;
+
+    for (char *tok = strtok_r(arg, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+        if (count >= MAX_AXES) {
+            return -1;
+        }
+        last = (int32_t)strtol(tok, NULL, 0);
+        move[count++] = last;
+    }
+    if (count == 0) {
+        return -1;
+    }
+    for (; count < MAX_AXES; count++) {
+        move[count] = last;
+    }
+    return 0;
+}
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options] <CAN interface> <node ID> [<node ID> ...]\n", prog);
+    printf("\n"
+           "Options:\n"
+           "  -p <period us>      Cycle (SYNC) period, 250..10000 us, default 1000\n"
+           "  -b <bitrate>        CAN bitrate for the bus load estimate, default 1000000\n"
+           "  -t <d1>[,<d2>...]   Relative move in counts, one value per axis (last value repeats), may be\n"
+           "                      repeated up to %d times. Without moves axes hold their position until Ctrl+C.\n"
+           "  -v <velocity>       Velocity of the longest move in counts/s, default %d\n"
+           "  -a <acceleration>   Acceleration of the longest move in counts/s^2, default %d\n"
+           "  -d <dwell ms>       Pause after each move, default 500\n"
+           "  -l <min>,<max>      Position limits in counts for setpoints and actual positions of all axes,\n"
+           "                      axes stop when one of them is outside. Default no limits.\n"
+           "  -r <priority>       SCHED_FIFO priority (1..99), default normal scheduling\n"
+           "\n"
+           "Example: %s -p 1000 -t 52428,-52428 -t 0 can0 1 2 3 4 5 6\n"
+           "\n",
+           MAX_MOVES, MOTOR_RESOLUTION / 10, MOTOR_RESOLUTION, prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *interface;
+    int priority = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:b:t:v:a:d:l:r:h")) != -1) {
+        switch (opt) {
+            case 'p':
+                period_us = (uint32_t)strtoul(optarg, NULL, 0);
+                if (period_us < 250 || period_us > 10000) {
+                    printf("Error: period must be 250..10000 us\n");
+                    return 1;
+                }
+                break;
+            case 'b': bitrate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 't':
+                if (move_count >= MAX_MOVES || parse_move(optarg, moves[move_count]) < 0) {
+                    printf("Error: wrong move (%s)\n", optarg);
+                    return 1;
+                }
+                move_count++;
+                break;
+            case 'v': profile_velocity = strtod(optarg, NULL); break;
+            case 'a': profile_acceleration = strtod(optarg, NULL); break;
+            case 'd': dwell_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'l':
+                if (sscanf(optarg, "%d,%d", &position_min, &position_max) != 2 || position_min > position_max) {
+                    printf("Error: wrong position limits (%s)\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'r': priority = atoi(optarg); break;
+            default: print_usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind + 1 >= argc || profile_velocity <= 0 || profile_acceleration <= 0 || bitrate == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    interface = argv[optind++];
+    CO_procImage_init(&image);
+    for (; optind < argc; optind++) {
+        int id = atoi(argv[optind]);
+        if (id < 1 || id > 127 || find_axis((uint8_t)id) != NULL || axis_count >= MAX_AXES) {
+            printf("Error: wrong or repeated node ID (%s), maximum %d axes\n", argv[optind], MAX_AXES);
+            return 1;
+        }
+        axis_t *axis = &axes[axis_count++];
+        memset(axis, 0, sizeof(*axis));
+        axis->node_id = (uint8_t)id;
+        axis->state = AXIS_CONFIG;
+        axis->rpdo_cob_id = 0x200 + id;
+        axis->tpdo_cob_id = 0x180 + id;
+    }
+
+    // bus load: SYNC, RPDO1 and TPDO1 of each axis in every cycle
+    uint32_t bits_per_cycle = can_frame_bits(0) + axis_count * 2 * can_frame_bits(6);
+    uint32_t bits_available = (uint32_t)((uint64_t)bitrate * period_us / 1000000);
+    int max_axes = (int)((bits_available - can_frame_bits(0)) / (2 * can_frame_bits(6)));
+    printf("eRob multi-axis CSP controller: %d axes, period %u us\n", axis_count, period_us);
+    printf("Bus load %u%% at %u bit/s, maximum %d axes at this period\n", bits_per_cycle * 100 / bits_available,
+           bitrate, max_axes);
+    if (axis_count > max_axes) {
+        printf("Error: too many axes for the period and bitrate\n");
+        return 1;
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    if (priority > 0) {
+        struct sched_param param = {.sched_priority = priority};
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            perror("SCHED_FIFO not set");
+        }
+    }
+
+    // create CAN socket
+    int sock = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (sock < 0) {
+        perror("Create socket failed");
+        return 1;
+    }
+
+    // receive only SDO responses and TPDO1 of the axes
+    struct can_filter filters[2 * MAX_AXES];
+    for (int i = 0; i < axis_count; i++) {
+        filters[2 * i] = (struct can_filter){.can_id = 0x580 + axes[i].node_id,
+                                             .can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_SFF_MASK};
+        filters[2 * i + 1] = (struct can_filter){.can_id = axes[i].tpdo_cob_id,
+                                                 .can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_SFF_MASK};
+    }
+    if (setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FILTER, filters, 2 * axis_count * sizeof(filters[0])) < 0) {
+        perror("Set CAN filter failed");
+    }
+
+    struct ifreq ifr;
+    struct sockaddr_can addr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, interface, IFNAMSIZ - 1);
+    if (ioctl(sock, SIOCGIFINDEX, &ifr) < 0) {
+        perror("Get interface index failed");
+        close(sock);
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("Bind socket failed");
+        close(sock);
+        return 1;
+    }
+
+    // configure all axes in parallel: first SDO request of each axis goes out now, next one on each response
+    sdo_steps_init();
+    for (int i = 0; i < axis_count; i++) {
+        send_nmt_command(sock, NMT_PRE_OPERATIONAL, axes[i].node_id);
+    }
+    for (int i = 0; i < axis_count; i++) {
+        send_sdo_download(sock, &axes[i]);
+    }
+    uint64_t config_start_us = time_us();
+    for (;;) {
+        int pending = 0;
+        uint64_t now = time_us();
+
+        for (int i = 0; i < axis_count; i++) {
+            axis_t *axis = &axes[i];
+            if (axis->state != AXIS_CONFIG) {
+                continue;
+            }
+            if (now - axis->sdo_sent_us > SDO_TIMEOUT_MS * 1000ULL) {
+                printf("Axis %d: 0x%04X:%02X SDO timeout, axis disabled\n", axis->node_id,
+                       sdo_steps[axis->sdo_step].index, sdo_steps[axis->sdo_step].subindex);
+                axis->state = AXIS_ERROR;
+                continue;
+            }
+            pending++;
+        }
+        if (pending == 0 || !running) {
+            break;
+        }
+        receive_until(sock, now + 1000);
+    }
+    printf("Configuration of %d axes: %.1f ms, %d SDO downloads per axis\n", axis_count,
+           (time_us() - config_start_us) / 1000.0, sdo_step_count);
+
+    // cyclic operation
+    uint64_t next_cycle_us = time_us();
+    uint64_t enable_start_us = next_cycle_us;
+    uint64_t last_print_us = next_cycle_us;
+    uint32_t cycles = 0;
+    uint32_t late_max_us = 0;
+    int all_enabled = 0;
+    int move = -1;  // index of the current move, -1 before the first move
+    double move_longest = 0;
+    double move_time = 0;
+    double move_duration = 0;
+    uint32_t dwell_cycles = 0;
+    int shutdown_cycles = 0;
+    int exit_code = 0;
+
+    while (shutdown_cycles < SHUTDOWN_CYCLES) {
+        // setpoints of all axes, from TPDOs gathered in the previous cycle
+        int enabled = 0, active = 0, failed = 0;
+        uint64_t now_us = time_us();
+        for (int i = 0; i < axis_count; i++) {
+            axis_t *axis = &axes[i];
+
+            if (axis->state == AXIS_CONFIG || axis->state == AXIS_ERROR) {
+                continue;
+            }
+            active++;
+            if (cycles > 0 && !axis->tpdo_this_cycle) {
+                axis->tpdo_missed++;
+            }
+            axis->tpdo_this_cycle = 0;
+            if (axis_update_state(axis, now_us) < 0) {
+                failed++;
+            }
+            if (axis->state == AXIS_ENABLED) {
+                enabled++;
+                int32_t ferr = abs(target_positions[i] - image.position[i]);
+                if (ferr > axis->following_max) {
+                    axis->following_max = ferr;
+                }
+            }
+        }
+        if (active == 0) {
+            printf("Error: no axis configured\n");
+            exit_code = 1;
+            break;
+        }
+
+        if (!running) {
+            // shutdown all axes, then stop PDOs
+            for (int i = 0; i < axis_count; i++) {
+                axes[i].control_word = CIA402_CW_SHUTDOWN;
+            }
+            shutdown_cycles++;
+        } else if (!all_enabled) {
+            if (enabled == active) {
+                all_enabled = 1;
+                for (int i = 0; i < axis_count; i++) {
+                    axes[i].home_position = image.position[i];
+                }
+                printf("All %d axes enabled in %.1f ms\n", enabled, (time_us() - enable_start_us) / 1000.0);
+            } else if (failed > 0) {
+                for (int i = 0; i < axis_count; i++) {
+                    if (axes[i].sm.status == CIA402_SM_FAILED) {
+                        printf("Axis %d: enable failed in state \"%s\", statusword 0x%04X\n", axes[i].node_id,
+                               cia402_state_name(axes[i].sm.failed_state), image.statusword[i]);
+                    }
+                }
+                printf("Error: only %d of %d axes enabled\n", enabled, active);
+                exit_code = 1;
+                running = 0;
+            }
+        } else if (enabled != active) {
+            printf("Error: axis left \"operation enabled\", stopping\n");
+            exit_code = 1;
+            running = 0;
+        } else if (move < move_count) {
+            // coordinated move: all axes follow the same normalized profile
+            if (move_time < move_duration) {
+                move_time += period_us / 1e6;
+                double s = profile_position(move_longest, move_time, &move_duration) / move_longest;
+                for (int i = 0; i < axis_count; i++) {
+                    axis_t *axis = &axes[i];
+                    target_positions[i] = axis->move_start + (int32_t)lround(s * axis->move_distance);
+                }
+            } else if (dwell_cycles > 0) {
+                dwell_cycles--;
+            } else if (++move < move_count) {
+                move_longest = start_move(move);
+                move_time = 0;
+                move_duration = 0;
+                if (move_longest > 0) {
+                    profile_position(move_longest, 0, &move_duration);
+                }
+                dwell_cycles = dwell_ms * 1000 / period_us;
+            } else {
+                printf("All moves done\n");
+                running = 0;
+            }
+        }
+
+        // position limits of all axes, checked in one batch; axes hold their position, then shut down
+        if (running && all_enabled) {
+            uint32_t outside = CO_procImage_checkLimits(target_positions, (uint16_t)axis_count, position_min,
+                                                        position_max)
+                               | CO_procImage_checkLimits(image.position, (uint16_t)axis_count, position_min,
+                                                          position_max);
+            if (outside != 0) {
+                for (int i = 0; i < axis_count; i++) {
+                    if ((outside & (1U << i)) != 0) {
+                        printf("Axis %d: position outside limits %d..%d, setpoint %d, actual %d\n", axes[i].node_id,
+                               position_min, position_max, target_positions[i], image.position[i]);
+                    }
+                    target_positions[i] = image.position[i];
+                }
+                exit_code = 1;
+                running = 0;
+            }
+        }
+
+        if (send_sync_and_rpdos(sock) < 0) {
+            exit_code = 1;
+            break;
+        }
+        cycles++;
+
+        // gather TPDOs of all axes until the next cycle
+        uint64_t now = time_us();
+        if (now > next_cycle_us && now - next_cycle_us > late_max_us) {
+            late_max_us = (uint32_t)(now - next_cycle_us);
+        }
+        next_cycle_us += period_us;
+        if (next_cycle_us < now) {
+            next_cycle_us = now;  // overrun, don't try to catch up
+        }
+        receive_until(sock, next_cycle_us);
+
+        if (next_cycle_us - last_print_us >= STATUS_PRINT_INTERVAL_MS * 1000ULL) {
+            print_status(cycles, late_max_us);
+            last_print_us = next_cycle_us;
+            late_max_us = 0;
+        }
+    }
+
+    for (int i = 0; i < axis_count; i++) {
+        if (axes[i].state != AXIS_ERROR) {
+            send_nmt_command(sock, NMT_PRE_OPERATIONAL, axes[i].node_id);
+        }
+    }
+    print_status(cycles, late_max_us);
+    close(sock);
+    printf("Program exit\n");
+    return exit_code;
+}
@@ -0,0 +1,110 @@
+/*
+ * author: ZeroErr Inc.
+ * OD hash generator: build-time perfect hash index of the Object Dictionary from OD.c for OD_find()
+ *
+ * Usage: od_hashgen <OD_hash.c> <OD_hash.h>
+ *
+ * The program is linked with OD.c, calculates the hash with OD_hashBuild() and writes the slot table as C source.
+ * Application enables it with OD_initHash(OD, &OD_hash), which verifies the table against the OD at init.
+ * Build fails, if OD.c is not ordered by index.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "301/CO_ODinterface.h"
+#include "OD.h"
+
+#if OD_HASH == 0
+#error od_hashgen requires OD_HASH enabled in CO_driver_target.h
+#endif
+
+static uint16_t table[65536];
+
+static int write_source(const char *path, const OD_hash_t *hash) {
+    FILE *f = fopen(path, "w");
+    uint32_t slots = 1UL << (32U - hash->shift);
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "/* Perfect hash index of OD.c for OD_find(), generated by od_hashgen, do not edit */\n\n");
+    fprintf(f, "#include \"OD_hash.h\"\n\n");
+    fprintf(f, "#if OD_HASH > 0\n");
+    fprintf(f, "/* %u entries in %u slots */\n", (unsigned)OD->size, (unsigned)slots);
+    fprintf(f, "static const uint16_t OD_hashTable[%u] = {", (unsigned)slots);
+    for (uint32_t s = 0; s < slots; s++) {
+        if (s % 4U == 0U) {
+            fprintf(f, "\n   ");
+        }
+        if (hash->table[s] == OD_HASH_EMPTY) {
+            fprintf(f, " OD_HASH_EMPTY,");
+        } else {
+            // position in the list and index as comment, so the table can be reviewed
+            fprintf(f, " %u /* %04X */,", (unsigned)hash->table[s], (unsigned)OD->list[hash->table[s]].index);
+        }
+    }
+    fprintf(f, "\n};\n\n");
+    fprintf(f, "const OD_hash_t OD_hash = {0x%08XU, %uU, OD_hashTable};\n", (unsigned)hash->multiplier,
+            (unsigned)hash->shift);
+    fprintf(f, "#endif\n");
+    return fclose(f);
+}
+
+static int write_header(const char *path) {
+    FILE *f = fopen(path, "w");
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "/* Perfect hash index of OD.c for OD_find(), generated by od_hashgen, do not edit */\n\n");
+    fprintf(f, "#ifndef OD_HASH_H\n#define OD_HASH_H\n\n");
+    fprintf(f, "#include \"301/CO_ODinterface.h\"\n\n");
+    fprintf(f, "#if OD_HASH > 0\n");
+    fprintf(f, "/* Hash index of the OD from OD.c, enable with OD_initHash(OD, &OD_hash) */\n");
+    fprintf(f, "extern const OD_hash_t OD_hash;\n");
+    fprintf(f, "#endif\n\n#endif /* OD_HASH_H */\n");
+    return fclose(f);
+}
+
+int main(int argc, char *argv[]) {
+    OD_hash_t hash;
+    ODR_t odRet;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <OD_hash.c> <OD_hash.h>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    odRet = OD_hashBuild(OD, &hash, table, sizeof(table) / sizeof(table[0]));
+    if (odRet == ODR_DEV_INCOMPAT) {
+        fprintf(stderr, "od_hashgen: OD.c is not ordered by index or has duplicate indexes\n");
+        for (uint16_t i = 1; i < OD->size; i++) {
+            if (OD->list[i - 1].index >= OD->list[i].index) {
+                fprintf(stderr, "  entry %u: 0x%04X after 0x%04X\n", (unsigned)i, (unsigned)OD->list[i].index,
+                        (unsigned)OD->list[i - 1].index);
+            }
+        }
+        return EXIT_FAILURE;
+    }
+    if (odRet != ODR_OK) {
+        fprintf(stderr, "od_hashgen: no perfect hash found for %u entries\n", (unsigned)OD->size);
+        return EXIT_FAILURE;
+    }
+
+    // verify the result the same way as application does at init
+    if (OD_initHash(OD, &hash) != ODR_OK) {
+        fprintf(stderr, "od_hashgen: verification of the hash failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (write_source(argv[1], &hash) != 0 || write_header(argv[2]) != 0) {
+        return EXIT_FAILURE;
+    }
+    printf("od_hashgen: %u entries in %u slots, multiplier 0x%08X\n", (unsigned)OD->size,
+           (unsigned)(1UL << (32U - hash.shift)), (unsigned)hash.multiplier);
+    return EXIT_SUCCESS;
+}
@@ -5,12 +5,17 @@
  * Uses SDO communication for PP mode control
  * 
  * Features:
- * - Automatic EDS file parsing for object dictionary
+ * - Automatic EDS file parsing for object dictionary, with binary cache for fast startup
  * - SDO communication for parameter configuration
  * - Profile Position Mode motor control with immediate update mode
- * - Real-time position monitoring and status checking
+ * - Event-driven motion monitor fed by TPDO1, with setpoint acknowledge and target reached latency histograms
  * - Interactive keyboard control interface
  * - Support for position, velocity, acceleration, and deceleration control
+ * - Optional PDO mode: controlword/target position in RPDO1, statusword/actual position in TPDO1
+ * - SDO transfers through CO_SDOengine (CANopenNode SDO client), requests to different nodes run in parallel
+ * - Binary event log (app_log) for SDO transfers and CAN frames, printed by a background thread
+ * - Enable sequence driven by the observed statusword (cia402.h), without fixed delays
+ * - SDO timeouts and retries adapted to the measured round trip time of the drive (CO_SDOrtt)
  */
 
 #include <stdio.h>
@@ -18,27 +23,41 @@
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
-#include <sys/socket.h>
-#include <sys/ioctl.h>
 #include <net/if.h>
-#include <linux/can.h>
-#include <linux/can/raw.h>
+#include <poll.h>
 #include <termios.h>
 #include <pthread.h>
 #include <signal.h>
 #include <time.h>
 
+#include "301/CO_driver.h"
+#include "extra/CO_SDOengine.h"
+#include "eds_index.h"
+#include "erob_eds.h"
+#include "app_log.h"
+#include "motion_monitor.h"
+#include "cia402.h"
+
 // Configuration constants
 #define TIMEOUT_MS 1000
+#define SDO_RTT_MIN_TIMEOUT_MS 10     // Shortest SDO retransmission timeout
+#define SDO_RTT_RETRIES 2             // SDO retransmissions of one request
 #define MOTOR_NODE_ID 2  // Default motor node ID, can be overridden by auto-detection
 #define SDO_CLIENT_COB_ID (0x600 + MOTOR_NODE_ID)  // 0x602 for node 2
 #define SDO_SERVER_COB_ID (0x580 + MOTOR_NODE_ID)  // 0x582 for node 2
 
+// PDO mode configuration
+#define PDO_HANDSHAKE_TIMEOUT_MS 500  // Timeout for statusword bit12 change in PDO mode
+#define TPDO_INHIBIT_TIME_100US 10    // Minimum interval between two TPDOs: 1 ms
+#define TPDO_EVENT_TIMER_MS 100       // TPDO is also sent periodically, for position monitoring
+
+// Enable sequence configuration
+#define BOOTUP_TIMEOUT_MS 2000        // Wait for boot-up message after NMT reset node
+#define STATUSWORD_TPDO_WAIT_US 5000  // PDO mode: wait so long for TPDO1, then read statusword with SDO
+
 // Auto-detection variables
 static uint8_t detected_motor_id = 0;  // 0 means not detected yet
 static uint8_t current_motor_id = MOTOR_NODE_ID;  // Currently used motor ID
-//#define EDS_FILE_PATH "/home/erobman/ecosystem/CANopenNode/example/ZeroErr_Driver_V1.5.xpd"
-#define EDS_FILE_PATH "/home/erobman/ecosystem/CANopenNode/example/ZeroErr Driver_V1.5.eds"
 
 // Global control variables
 volatile int running = 1;
@@ -50,6 +69,38 @@ uint32_t current_profile_acceleration = 5566;
 uint32_t current_profile_deceleration = 5566;
 int motor_enabled = 0; // Flag indicating if motor is enabled
 
+// PDO mode: setpoints are sent with RPDO1, statusword and actual position are received with TPDO1
+int use_pdo_mode = 0;
+uint16_t pdo_control_word = 0x0F;      // Last controlword sent with RPDO1
+uint16_t pdo_status_word = 0;          // Statusword from the last TPDO1
+int32_t pdo_actual_position = 0;       // Actual position from the last TPDO1
+uint32_t pdo_rx_count = 0;             // Number of received TPDO1 frames
+
+// CAN module and SDO engine, all CAN communication goes through them
+#define SDO_CHANNELS 8                      // Parallel SDO transfers, one receive and one transmit buffer each
+#define RX_IDX_SDO 0                        // Receive buffers: SDO channels, TPDO1, EMCY, boot-up
+#define RX_IDX_TPDO (SDO_CHANNELS)
+#define RX_IDX_EMCY (SDO_CHANNELS + 1)
+#define RX_IDX_BOOTUP (SDO_CHANNELS + 2)
+#define RX_COUNT (SDO_CHANNELS + 3)
+#define TX_IDX_SDO 0                        // Transmit buffers: SDO channels, NMT, RPDO1
+#define TX_IDX_NMT (SDO_CHANNELS)
+#define TX_IDX_RPDO (SDO_CHANNELS + 1)
+#define TX_COUNT (SDO_CHANNELS + 2)
+
+static CO_CANptrSocketCan_t can_ptr;
+static CO_CANmodule_t can_module;
+static CO_CANrx_t can_rx[RX_COUNT];
+static CO_CANtx_t can_tx[TX_COUNT];
+static CO_CANtx_t *nmt_tx = NULL;
+static CO_CANtx_t *rpdo_tx = NULL;
+static CO_SDOclient_t sdo_clients[SDO_CHANNELS];
+static CO_SDOengine_t sdo_engine;
+static CO_SDOrtt_t sdo_rtt;           // Round trip time of the drive, shared by all SDO channels
+static uint64_t can_last_us = 0;       // Time of the last CO_SDOengine_process() call
+static uint16_t sdo_pending = 0;       // Queued and active SDO transfers
+static uint32_t bootup_count = 0;      // Number of received boot-up messages
+
 // Motor parameters
 #define MOTOR_RESOLUTION 524288  // Resolution per revolution
 #define MAX_POSITION (MOTOR_RESOLUTION * 2)  // Maximum position: 2 revolutions
@@ -59,301 +110,370 @@ int motor_enabled = 0; // Flag indicating if motor is enabled
 
 // Function declarations
 int execute_position_move(int sock, int32_t target_position);
+int execute_position_move_pdo(int sock, int32_t target_position);
 void print_command_help(int sock);
 
-/* Object dictionary entry structure */
-typedef struct {
-    uint16_t index;
-    uint8_t subindex;
-    uint8_t data_size;
-} object_dict_entry_t;
-
-/* Simplified object dictionary */
-object_dict_entry_t object_dict[100];
-int object_dict_count = 0;
-
-/* Get byte size based on data type */
-uint8_t get_data_type_size(uint16_t data_type) {
-    switch (data_type) {
-        case 0x0001: return 1;  // BOOLEAN
-        case 0x0002: return 1;  // INTEGER8
-        case 0x0003: return 2;  // INTEGER16
-        case 0x0004: return 4;  // INTEGER32
-        case 0x0005: return 1;  // UNSIGNED8
-        case 0x0006: return 2;  // UNSIGNED16 (Control word type)
-        case 0x0007: return 4;  // UNSIGNED32
-        case 0x0008: return 8;  // REAL32
-        default: return 2;      // Default 2 bytes
+/* Statusword and position of the motor, from TPDO1 or SDO reads, and setpoint latency histograms */
+static motion_monitor_t monitor;
+
+/* Object dictionary of the drive, generated from "ZeroErr Driver_V1.5.eds" at build time (erob_eds.c) */
+static eds_index_t eds_index;
+
+// Sizes of the objects, written by the enable sequence, are known at compile time
+_Static_assert(EROB_EDS_6040_00_SIZE == 2, "Control word is 2 bytes (using 2B)");
+_Static_assert(EROB_EDS_6060_00_SIZE == 1, "Operation mode is 1 byte (using 2F)");
+_Static_assert(EROB_EDS_6081_00_SIZE == 4 && EROB_EDS_6083_00_SIZE == 4 && EROB_EDS_6084_00_SIZE == 4,
+               "Profile parameters are 4 bytes (using 23)");
+
+/* Find object dictionary entry */
+uint8_t get_object_size(uint16_t index, uint8_t subindex) {
+    const eds_object_t *obj = eds_index_find(&eds_index, index, subindex);
+    if (obj != NULL && obj->data_size >= 1 && obj->data_size <= 4) {
+        return (uint8_t)obj->data_size;
     }
+    return 4; // Default 4 bytes
+}
+
+/* Monotonic time in microseconds, for SDO timeouts and PDO handshake timing */
+static uint64_t time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
 }
 
-/* 解析EDS文件 */
-int parse_eds_file(const char* filename) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        printf("无法打开EDS文件: %s\n", filename);
+/* Run SDO engine with time elapsed since the previous call and send queued CAN frames. Return true, if any SDO
+ * transfer finished. */
+static int sdo_engine_run(uint32_t *timer_next_us) {
+    uint64_t now_us = time_us();
+    CO_CANtxDeferBegin();
+    uint16_t pending = CO_SDOengine_process(&sdo_engine, (uint32_t)(now_us - can_last_us), timer_next_us);
+    CO_CANtxDeferEnd();
+    int finished = pending < sdo_pending;
+    sdo_pending = pending;
+    can_last_us = now_us;
+    CO_CANtxFlush(&can_module);
+    return finished;
+}
+
+/* Queue SDO transfer, it is started by can_process() */
+int sdo_submit(CO_SDOengine_xfer_t *xfer) {
+    if (CO_SDOengine_submit(&sdo_engine, xfer) != CO_ERROR_NO) {
         return -1;
     }
-    
-    char line[256];
-    uint16_t current_index = 0;
-    uint8_t current_subindex = 0;
-    uint16_t current_data_type = 0;
-    int in_object = 0;
-    
-    while (fgets(line, sizeof(line), file)) {
-        line[strcspn(line, "\r\n")] = 0;
-        
-        if (line[0] == '[' && strchr(line, ']')) {
-            char *end_bracket = strchr(line, ']');
-            *end_bracket = 0;
-            char *object_id = line + 1;
-            
-            if (strstr(object_id, "sub")) {
-                sscanf(object_id, "%hxsub%hhu", &current_index, &current_subindex);
-            } else {
-                sscanf(object_id, "%hx", &current_index);
-                current_subindex = 0;
-            }
-            in_object = 1;
-            current_data_type = 0;
-        }
-        else if (in_object && strstr(line, "DataType=")) {
-            sscanf(line, "DataType=0x%hx", &current_data_type);
-            // Special handling for control word, ensure correct data type
-            if (current_index == 0x6040) {
-                current_data_type = 0x0006; // UNSIGNED16
-            }
-        }
-        else if (in_object && strstr(line, "AccessType=")) {
-            if (current_data_type > 0 && object_dict_count < 100) {
-                object_dict[object_dict_count].index = current_index;
-                object_dict[object_dict_count].subindex = current_subindex;
-                object_dict[object_dict_count].data_size = get_data_type_size(current_data_type);
-                object_dict_count++;
-            }
-            in_object = 0;
-        }
-    }
-    
-    fclose(file);
-    printf("EDS file parsed, loaded %d objects\n", object_dict_count);
+    sdo_pending++;
     return 0;
 }
 
-/* Find object dictionary entry */
-uint8_t get_object_size(uint16_t index, uint8_t subindex) {
-    for (int i = 0; i < object_dict_count; i++) {
-        if (object_dict[i].index == index && object_dict[i].subindex == subindex) {
-            return object_dict[i].data_size;
-        }
+/* Wait at most wait_us for CAN frames or for the next SDO timeout, then pass received frames to their handlers:
+ * SDO responses to the engine channels, TPDO1 and EMCY to the functions below. Return number of received frames. */
+int32_t can_process(uint32_t wait_us) {
+    struct pollfd pfd = {.fd = can_module.fd, .events = POLLIN};
+    uint32_t timer_next_us = wait_us;
+    int32_t received = 0;
+
+    // start queued SDO transfers and check timeouts, don't wait, if some transfer is already finished
+    if (sdo_engine_run(&timer_next_us)) {
+        timer_next_us = 0;
     }
-    // Special handling for control word and mode     
-    if (index == 0x6040) {
-        return 2; // Control word is 2 bytes (using 2B)
+
+    struct timespec timeout = {.tv_sec = timer_next_us / 1000000, .tv_nsec = (long)(timer_next_us % 1000000) * 1000};
+    if (ppoll(&pfd, 1, &timeout, NULL) > 0) {
+        received = CO_CANinterrupt(&can_module);
     }
-    if (index == 0x6060) {
-        return 1; // Operation mode is 1 byte (using 2F)
+    // SDO responses and timeouts, which expired while waiting
+    sdo_engine_run(NULL);
+    return received;
+}
+
+/* Submit SDO transfer and process CAN until it is finished. Return 0 on success, -1 on abort or timeout. */
+int sdo_transfer(CO_SDOengine_xfer_t *xfer) {
+    if (sdo_submit(xfer) < 0) {
+        return -1;
     }
-    if (index == 0x6081 || index == 0x6083 || index == 0x6084) {
-        return 4; // Profile parameters are 4 bytes (using 23)
+    while (xfer->state != CO_SDOengine_done) {
+        can_process(TIMEOUT_MS * 1000);
     }
-    return 4; // Default 4 bytes
+    xfer->state = CO_SDOengine_idle;
+    return xfer->result < 0 ? -1 : 0;
 }
 
-/* Send SDO request */
-int send_sdo_request(int sock, uint16_t index, uint8_t subindex, uint32_t data, int is_write) {
-    struct can_frame frame;
-    frame.can_id = 0x600 + current_motor_id;  // Use dynamic motor ID
-    frame.can_dlc = 8;
-    
-    uint8_t data_size = get_object_size(index, subindex);
-    
-    if (is_write) {
-        if (data_size == 1) {
-            frame.data[0] = 0x2F;  // 1 byte data
-        } else if (data_size == 2) {
-            frame.data[0] = 0x2B;  // 2 byte data
-        } else {
-            frame.data[0] = 0x23;  // 4 byte data
-        }
-        // Correct byte order: low byte first
-        frame.data[1] = index & 0xFF;        // Index low byte
-        frame.data[2] = (index >> 8) & 0xFF; // Index high byte
-        frame.data[3] = subindex;            // Subindex
-        frame.data[4] = data & 0xFF;         // Data low byte
-        frame.data[5] = (data >> 8) & 0xFF;  // Data second low byte
-        frame.data[6] = (data >> 16) & 0xFF; // Data second high byte
-        frame.data[7] = (data >> 24) & 0xFF; // Data high byte
-    } else {
-        frame.data[0] = 0x40;  // Upload request
-        frame.data[1] = index & 0xFF;
-        frame.data[2] = (index >> 8) & 0xFF;
-        frame.data[3] = subindex;
-        frame.data[4] = 0;
-        frame.data[5] = 0;
-        frame.data[6] = 0;
-        frame.data[7] = 0;
+/* Record finished SDO transfer in the event log: index, subindex, size and value, or abort code */
+static void log_sdo(const CO_SDOengine_xfer_t *xfer) {
+    uint8_t data[8] = {xfer->index & 0xFF, xfer->index >> 8, xfer->subIndex};
+    uint32_t cob_id = 0x600 + xfer->nodeId;
+
+    if (xfer->result < 0) {
+        data[3] = xfer->upload ? 1 : 0;
+        app_log_event(APP_LOG_ERROR, APP_LOG_EV_SDO_ABORT, cob_id, data, 4, (uint32_t)xfer->abortCode);
+        return;
     }
-    
-    // Add debug output
-    printf("[DEBUG] Send SDO: COB-ID=0x%03X, data: %02X %02X %02X %02X %02X %02X %02X %02X\n", 
-           frame.can_id, frame.data[0], frame.data[1], frame.data[2], frame.data[3],
-           frame.data[4], frame.data[5], frame.data[6], frame.data[7]);
-    
-    return write(sock, &frame, sizeof(frame));
+    if (!app_log_enabled(APP_LOG_INFO)) {
+        return;
+    }
+    data[3] = xfer->size > 4 ? 4 : (uint8_t)xfer->size;
+    memcpy(&data[4], xfer->data, data[3]);
+    app_log_event(APP_LOG_INFO, xfer->upload ? APP_LOG_EV_SDO_READ : APP_LOG_EV_SDO_WRITE, cob_id, data, 8, 0);
 }
 
-/* Receive SDO response */
-int receive_sdo_response(int sock, uint32_t *data) {
-    struct can_frame frame;
-    fd_set readfds;
-    struct timeval timeout;
-    int ret;
-    clock_t start_time = clock();
-    
-    while ((clock() - start_time) * 1000 / CLOCKS_PER_SEC < TIMEOUT_MS) {
-        FD_ZERO(&readfds);
-        FD_SET(sock, &readfds);
-        
-        timeout.tv_sec = 0;
-        timeout.tv_usec = 10000;
-        
-        ret = select(sock + 1, &readfds, NULL, NULL, &timeout);
-        if (ret > 0) {
-            ret = read(sock, &frame, sizeof(frame));
-            if (ret > 0) {
-                // Add debug output
-                printf("[DEBUG] Receive CAN: COB-ID=0x%03X, data: %02X %02X %02X %02X %02X %02X %02X %02X\n", 
-                       frame.can_id, frame.data[0], frame.data[1], frame.data[2], frame.data[3],
-                       frame.data[4], frame.data[5], frame.data[6], frame.data[7]);
-                
-                if (frame.can_id == (0x580 + current_motor_id)) {  // Use dynamic motor ID
-                    if ((frame.data[0] & 0xE0) == 0x40) {  // Upload response
-                        *data = frame.data[4] | (frame.data[5] << 8) | 
-                                (frame.data[6] << 16) | (frame.data[7] << 24);
-                        printf("[DEBUG] SDO upload response: data=0x%08X\n", *data);
-                        return 0;
-                    } else if ((frame.data[0] & 0xE0) == 0x60) {  // Download response
-                        *data = 0;
-                        printf("[DEBUG] SDO download response: success\n");
-                        return 0;
-                    } else if ((frame.data[0] & 0xE0) == 0x80) {  // Error response
-                        printf("[DEBUG] SDO error response: error code=0x%02X%02X%02X%02X\n", 
-                               frame.data[4], frame.data[5], frame.data[6], frame.data[7]);
-                        return -1;
-                    }
-                }
-            }
-        }
+/* Write SDO data with explicit data size, used for PDO configuration objects */
+int write_sdo_sized(int sock, uint16_t index, uint8_t subindex, uint32_t data, uint8_t data_size) {
+    CO_SDOengine_xfer_t xfer = {
+        .nodeId = current_motor_id, .index = index, .subIndex = subindex, .upload = false, .size = data_size
+    };
+    (void)sock;
+
+    // Correct byte order: low byte first
+    for (uint8_t i = 0; i < data_size && i < 4; i++) {
+        xfer.data[i] = (data >> (8 * i)) & 0xFF;
     }
-    printf("[DEBUG] SDO response timeout\n");
-    return -1;
+
+    int ret = sdo_transfer(&xfer);
+    log_sdo(&xfer);
+    return ret;
 }
 
-/* Write SDO data */
+/* Write SDO data, data size is taken from the object dictionary */
 int write_sdo(int sock, uint16_t index, uint8_t subindex, uint32_t data) {
-    printf("Write 0x%04X:%d = 0x%08X... ", index, subindex, data);
-    fflush(stdout);
-    
-    if (send_sdo_request(sock, index, subindex, data, 1) < 0) {
-        printf("Send failed\n");
+    return write_sdo_sized(sock, index, subindex, data, get_object_size(index, subindex));
+}
+
+/* One parameter write of a batch */
+typedef struct {
+    uint16_t index;
+    uint8_t subindex;
+    uint32_t value;
+} sdo_param_t;
+
+#define SDO_BATCH_MAX 8  // Maximum number of parameter writes in one batch
+
+// Parameter updates from keyboard commands, written in the background
+static CO_SDOengine_xfer_t param_xfer[SDO_BATCH_MAX];
+static CO_SDOengine_batch_t param_batch = {.xfers = param_xfer};
+
+/* Result of one write of the batch: record it in the event log, print it only on failure */
+static void sdo_batch_item(void *object, CO_SDOengine_batch_t *batch, CO_SDOengine_xfer_t *xfer) {
+    (void)object;
+    (void)batch;
+    log_sdo(xfer);
+    if (xfer->result < 0) {
+        printf("SDO write 0x%04X:%02X failed, SDO abort 0x%08X\n", xfer->index, xfer->subIndex,
+               (uint32_t)xfer->abortCode);
+    }
+}
+
+/* Process CAN until all writes of the batch are finished. Return number of failed writes. */
+int sdo_batch_wait(CO_SDOengine_batch_t *batch) {
+    while (batch->pending > 0) {
+        can_process(TIMEOUT_MS * 1000);
+    }
+    return batch->failed;
+}
+
+/* Queue parameter writes to the current motor as one batch and return immediately. Writes run one after another
+ * without waiting for the caller, results are reported by sdo_batch_item(). If the previous batch in the same objects
+ * is still running, it is finished first. Data size is taken from the object dictionary. */
+int write_sdo_batch(CO_SDOengine_batch_t *batch, const sdo_param_t *params, uint16_t count) {
+    if (count > SDO_BATCH_MAX) {
         return -1;
     }
-    
-    uint32_t response_data;
-    if (receive_sdo_response(sock, &response_data) < 0) {
-        printf("No response\n");
+    sdo_batch_wait(batch);
+    for (uint16_t i = 0; i < count; i++) {
+        CO_SDOengine_setDownload(&batch->xfers[i], current_motor_id, params[i].index, params[i].subindex,
+                                 params[i].value, get_object_size(params[i].index, params[i].subindex));
+        batch->xfers[i].state = CO_SDOengine_idle;
+    }
+    batch->count = count;
+    batch->pFunctItem = sdo_batch_item;
+    if (CO_SDOengine_submitBatch(&sdo_engine, batch) != CO_ERROR_NO) {
         return -1;
     }
-    
-    printf("Success\n");
+    sdo_pending += count;
     return 0;
 }
 
+/* Write profile parameter in the background, keyboard and motion monitor stay responsive */
+static void set_profile_parameter(uint16_t index, uint32_t value) {
+    sdo_param_t param = {index, 0, value};
+    if (write_sdo_batch(&param_batch, &param, 1) < 0) {
+        printf("SDO write 0x%04X:00 not queued\n", index);
+    }
+}
+
 /* Read SDO data */
 int read_sdo(int sock, uint16_t index, uint8_t subindex, uint32_t *data) {
-    printf("Read 0x%04X:%d... ", index, subindex);
-    fflush(stdout);
-    
-    if (send_sdo_request(sock, index, subindex, 0, 0) < 0) {
-        printf("Send failed\n");
+    CO_SDOengine_xfer_t xfer = {.nodeId = current_motor_id, .index = index, .subIndex = subindex, .upload = true};
+    (void)sock;
+
+    int ret = sdo_transfer(&xfer);
+    log_sdo(&xfer);
+    if (ret < 0) {
         return -1;
     }
-    
-    if (receive_sdo_response(sock, data) < 0) {
-        printf("No response\n");
+
+    *data = 0;
+    for (size_t i = 0; i < xfer.size && i < 4; i++) {
+        *data |= (uint32_t)xfer.data[i] << (8 * i);
+    }
+    return 0;
+}
+
+/* CAN receive callback for TPDO1: store statusword and actual position */
+static void pdo_receive(void *object, void *msg) {
+    const uint8_t *data = CO_CANrxMsg_readData(msg);
+
+    if (CO_CANrxMsg_readDLC(msg) < 6) {
+        return;
+    }
+    pdo_status_word = data[0] | (data[1] << 8);
+    pdo_actual_position = (int32_t)(data[2] | (data[3] << 8) | (data[4] << 16) | ((uint32_t)data[5] << 24));
+    pdo_rx_count++;
+    motion_monitor_update(&monitor, *(uint8_t *)object, pdo_status_word, pdo_actual_position, time_us());
+    app_log_event(APP_LOG_DEBUG, APP_LOG_EV_CAN_RX, CO_CANrxMsg_readIdent(msg), data, CO_CANrxMsg_readDLC(msg), 0);
+}
+
+/* CAN receive callback for EMCY of the motor, received also while waiting for SDO responses */
+static void emcy_receive(void *object, void *msg) {
+    const uint8_t *data = CO_CANrxMsg_readData(msg);
+
+    if (CO_CANrxMsg_readDLC(msg) < 3) {
+        return;
+    }
+    app_log_event(APP_LOG_ERROR, APP_LOG_EV_EMCY, CO_CAN_ID_EMERGENCY + *(uint8_t *)object, data,
+                  CO_CANrxMsg_readDLC(msg), 0);
+}
+
+/* CAN receive callback for heartbeat of the motor, counts boot-up messages */
+static void bootup_receive(void *object, void *msg) {
+    (void)object;
+    if (CO_CANrxMsg_readDLC(msg) >= 1 && CO_CANrxMsg_readData(msg)[0] == 0) {
+        bootup_count++;
+    }
+}
+
+/* Send RPDO1: controlword and target position */
+int send_rpdo(int sock, uint16_t control_word, int32_t target_position) {
+    (void)sock;
+    if (rpdo_tx == NULL) {
         return -1;
     }
-    
-    printf("0x%08X\n", *data);
+    rpdo_tx->data[0] = control_word & 0xFF;
+    rpdo_tx->data[1] = (control_word >> 8) & 0xFF;
+    rpdo_tx->data[2] = target_position & 0xFF;
+    rpdo_tx->data[3] = (target_position >> 8) & 0xFF;
+    rpdo_tx->data[4] = (target_position >> 16) & 0xFF;
+    rpdo_tx->data[5] = (target_position >> 24) & 0xFF;
+    pdo_control_word = control_word;
+    CO_ReturnError_t ret = CO_CANsend(&can_module, rpdo_tx);
+    app_log_event(APP_LOG_DEBUG, APP_LOG_EV_CAN_TX, rpdo_tx->ident & CAN_SFF_MASK, rpdo_tx->data, rpdo_tx->DLC, 0);
+    return ret == CO_ERROR_NO ? 0 : -1;
+}
+
+/* Process all frames, which are already waiting in the socket, without blocking */
+void pdo_drain(int sock) {
+    (void)sock;
+    while (can_process(0) > 0) {
+    }
+}
+
+/* Wait for TPDO1 with statusword bit12 equal to ack. Return latency in microseconds or -1 on timeout. */
+int64_t pdo_wait_setpoint_ack(int sock, int ack, uint64_t start_us) {
+    uint64_t deadline_us = start_us + PDO_HANDSHAKE_TIMEOUT_MS * 1000;
+    (void)sock;
+
+    for (;;) {
+        uint64_t now_us = time_us();
+        if (now_us >= deadline_us) {
+            return -1;
+        }
+        uint32_t count = pdo_rx_count;
+        can_process((uint32_t)(deadline_us - now_us));
+        if (pdo_rx_count != count && ((pdo_status_word & 0x1000) != 0) == (ack != 0)) {
+            return (int64_t)(time_us() - start_us);
+        }
+    }
+}
+
+/* Configure RPDO1 (controlword, target position) and TPDO1 (statusword, actual position), node must be
+ * pre-operational */
+int configure_pdo_mapping(int sock) {
+    uint32_t rpdo_cob_id = 0x200 + current_motor_id;
+    uint32_t tpdo_cob_id = 0x180 + current_motor_id;
+    int err = 0;
+    
+    printf("=== Configure PDO mapping ===\n");
+    
+    // RPDO1: disable, remap, asynchronous transmission type, enable
+    err |= write_sdo_sized(sock, 0x1400, 1, 0x80000000 | rpdo_cob_id, 4);
+    err |= write_sdo_sized(sock, 0x1600, 0, 0, 1);
+    err |= write_sdo_sized(sock, 0x1600, 1, 0x60400010, 4); // Controlword, 16 bit
+    err |= write_sdo_sized(sock, 0x1600, 2, 0x607A0020, 4); // Target position, 32 bit
+    err |= write_sdo_sized(sock, 0x1600, 0, 2, 1);
+    err |= write_sdo_sized(sock, 0x1400, 2, 0xFF, 1);
+    err |= write_sdo_sized(sock, 0x1400, 1, rpdo_cob_id, 4);
+    
+    // TPDO1: disable, remap, event driven with inhibit time and event timer, enable
+    err |= write_sdo_sized(sock, 0x1800, 1, 0x80000000 | tpdo_cob_id, 4);
+    err |= write_sdo_sized(sock, 0x1A00, 0, 0, 1);
+    err |= write_sdo_sized(sock, 0x1A00, 1, 0x60410010, 4); // Statusword, 16 bit
+    err |= write_sdo_sized(sock, 0x1A00, 2, 0x60640020, 4); // Actual position, 32 bit
+    err |= write_sdo_sized(sock, 0x1A00, 0, 2, 1);
+    err |= write_sdo_sized(sock, 0x1800, 2, 0xFF, 1);
+    err |= write_sdo_sized(sock, 0x1800, 3, TPDO_INHIBIT_TIME_100US, 2);
+    err |= write_sdo_sized(sock, 0x1800, 5, TPDO_EVENT_TIMER_MS, 2);
+    err |= write_sdo_sized(sock, 0x1800, 1, tpdo_cob_id, 4);
+    
+    if (err != 0) {
+        printf("PDO mapping failed, device may not support remapping\n");
+        return -1;
+    }
+    printf("RPDO1 0x%03X: controlword + target position, TPDO1 0x%03X: statusword + actual position\n",
+           rpdo_cob_id, tpdo_cob_id);
     return 0;
 }
 
-/* Auto-detect motor node ID */
+/* Auto-detect motor node ID, device type (0x1000) of all candidate nodes is read in parallel */
 int auto_detect_motor(int sock) {
+    CO_SDOengine_xfer_t xfer[20];
+    int pending = 0;
+    (void)sock;
+
     printf("正在自动检测电机节点ID...\n");
-    
-    for (uint8_t node_id = 1; node_id <= 20; node_id++) {
-        printf("检测节点 %d... ", node_id);
-        fflush(stdout);
-        
-        // 临时更新SDO COB ID
-        uint32_t temp_client_cob = 0x600 + node_id;
-        uint32_t temp_server_cob = 0x580 + node_id;
-        
-        // 发送SDO请求读取设备类型 (0x1000)
-        struct can_frame frame;
-        frame.can_id = temp_client_cob;
-        frame.can_dlc = 8;
-        frame.data[0] = 0x40;  // Upload request
-        frame.data[1] = 0x00;  // Index low
-        frame.data[2] = 0x10;  // Index high
-        frame.data[3] = 0x00;  // Subindex
-        frame.data[4] = 0;
-        frame.data[5] = 0;
-        frame.data[6] = 0;
-        frame.data[7] = 0;
-        
-        if (write(sock, &frame, sizeof(frame)) < 0) {
-            printf("发送失败\n");
-            continue;
+
+    // 所有请求同时进入队列, 每个SDO通道处理一个节点
+    memset(xfer, 0, sizeof(xfer));
+    for (uint8_t i = 0; i < 20; i++) {
+        xfer[i].nodeId = i + 1;
+        xfer[i].index = 0x1000;
+        xfer[i].subIndex = 0;
+        xfer[i].upload = true;
+        xfer[i].timeout_ms = 200;  // 200ms timeout
+        if (sdo_submit(&xfer[i]) == 0) {
+            pending++;
         }
-        
-        // 接收响应
-        fd_set readfds;
-        struct timeval timeout;
-        int ret;
-        clock_t start_time = clock();
-        uint32_t device_type = 0;
-        int found = 0;
-        
-        while ((clock() - start_time) * 1000 / CLOCKS_PER_SEC < 200) {  // 200ms timeout
-            FD_ZERO(&readfds);
-            FD_SET(sock, &readfds);
-            
-            timeout.tv_sec = 0;
-            timeout.tv_usec = 10000;  // 10ms
-            
-            ret = select(sock + 1, &readfds, NULL, NULL, &timeout);
-            if (ret > 0) {
-                ret = read(sock, &frame, sizeof(frame));
-                if (ret > 0 && frame.can_id == temp_server_cob) {
-                    if ((frame.data[0] & 0xE0) == 0x40) {  // Upload response
-                        device_type = frame.data[4] | (frame.data[5] << 8) | 
-                                     (frame.data[6] << 16) | (frame.data[7] << 24);
-                        found = 1;
-                        break;
-                    }
-                }
+    }
+
+    // 接收响应
+    while (pending > 0) {
+        can_process(200000);
+        pending = 0;
+        for (uint8_t i = 0; i < 20; i++) {
+            if (xfer[i].state == CO_SDOengine_queued || xfer[i].state == CO_SDOengine_active) {
+                pending++;
             }
         }
-        
-        if (found) {
+    }
+
+    for (uint8_t i = 0; i < 20; i++) {
+        uint8_t node_id = xfer[i].nodeId;
+        printf("检测节点 %d... ", node_id);
+
+        if (xfer[i].state == CO_SDOengine_done && xfer[i].result >= 0 && xfer[i].size >= 4) {
+            uint32_t device_type = xfer[i].data[0] | (xfer[i].data[1] << 8) | (xfer[i].data[2] << 16) |
+                                   ((uint32_t)xfer[i].data[3] << 24);
             printf("找到设备 (类型: 0x%08X)\n", device_type);
-            
+
             // 检查是否是电机设备 (CiA402设备类型通常是0x00020192)
-            if (device_type == 0x00020192 || device_type == 0x00020193 || 
+            if (device_type == 0x00020192 || device_type == 0x00020193 ||
                 device_type == 0x00020194 || device_type == 0x00020195) {
                 printf("✓ 找到CiA402电机设备，节点ID: %d\n", node_id);
                 detected_motor_id = node_id;
@@ -365,10 +485,8 @@ int auto_detect_motor(int sock) {
         } else {
             printf("无响应\n");
         }
-        
-        usleep(50000);  // 50ms delay
     }
-    
+
     printf("未找到电机设备，使用默认节点ID: %d\n", MOTOR_NODE_ID);
     detected_motor_id = 0;
     current_motor_id = MOTOR_NODE_ID;
@@ -377,12 +495,15 @@ int auto_detect_motor(int sock) {
 
 /* Send NMT command */
 int send_nmt_command(int sock, uint8_t command, uint8_t node_id) {
-    struct can_frame frame;
-    frame.can_id = 0x000;
-    frame.can_dlc = 2;
-    frame.data[0] = command;
-    frame.data[1] = node_id;
-    return write(sock, &frame, sizeof(frame));
+    (void)sock;
+    if (nmt_tx == NULL) {
+        return -1;
+    }
+    nmt_tx->data[0] = command;
+    nmt_tx->data[1] = node_id;
+    CO_ReturnError_t ret = CO_CANsend(&can_module, nmt_tx);
+    app_log_event(APP_LOG_DEBUG, APP_LOG_EV_CAN_TX, nmt_tx->ident & CAN_SFF_MASK, nmt_tx->data, nmt_tx->DLC, 0);
+    return ret == CO_ERROR_NO ? 0 : -1;
 }
 
 /* Signal handler */
@@ -464,7 +585,7 @@ void* keyboard_input_thread(void* arg) {
                     if (parsed_value > 0) {
                         current_profile_velocity = parsed_value;
                         printf("Set profile velocity: %d\n", current_profile_velocity);
-                        write_sdo(sock, 0x6081, 0, current_profile_velocity);
+                        set_profile_parameter(0x6081, current_profile_velocity);
                     } else {
                         printf("Current profile velocity: %d\n", current_profile_velocity);
                     }
@@ -475,7 +596,7 @@ void* keyboard_input_thread(void* arg) {
                     if (parsed_value > 0) {
                         current_profile_acceleration = parsed_value;
                         printf("Set profile acceleration: %d\n", current_profile_acceleration);
-                        write_sdo(sock, 0x6083, 0, current_profile_acceleration);
+                        set_profile_parameter(0x6083, current_profile_acceleration);
                     } else {
                         printf("Current profile acceleration: %d\n", current_profile_acceleration);
                     }
@@ -486,7 +607,7 @@ void* keyboard_input_thread(void* arg) {
                     if (parsed_value > 0) {
                         current_profile_deceleration = parsed_value;
                         printf("Set profile deceleration: %d\n", current_profile_deceleration);
-                        write_sdo(sock, 0x6084, 0, current_profile_deceleration);
+                        set_profile_parameter(0x6084, current_profile_deceleration);
                     } else {
                         printf("Current profile deceleration: %d\n", current_profile_deceleration);
                     }
@@ -499,17 +620,17 @@ void* keyboard_input_thread(void* arg) {
                             case 'v':
                                 current_profile_velocity += 100;
                                 printf("Increase profile velocity to: %d\n", current_profile_velocity);
-                                write_sdo(sock, 0x6081, 0, current_profile_velocity);
+                                set_profile_parameter(0x6081, current_profile_velocity);
                                 break;
                             case 'a':
                                 current_profile_acceleration += 100;
                                 printf("Increase profile acceleration to: %d\n", current_profile_acceleration);
-                                write_sdo(sock, 0x6083, 0, current_profile_acceleration);
+                                set_profile_parameter(0x6083, current_profile_acceleration);
                                 break;
                             case 'd':
                                 current_profile_deceleration += 100;
                                 printf("Increase profile deceleration to: %d\n", current_profile_deceleration);
-                                write_sdo(sock, 0x6084, 0, current_profile_deceleration);
+                                set_profile_parameter(0x6084, current_profile_deceleration);
                                 break;
                         }
                     }
@@ -522,7 +643,7 @@ void* keyboard_input_thread(void* arg) {
                                 if (current_profile_velocity > 100) {
                                     current_profile_velocity -= 100;
                                     printf("Decrease profile velocity to: %d\n", current_profile_velocity);
-                                    write_sdo(sock, 0x6081, 0, current_profile_velocity);
+                                    set_profile_parameter(0x6081, current_profile_velocity);
                                 } else {
                                     printf("Profile velocity cannot be less than 100\n");
                                 }
@@ -531,7 +652,7 @@ void* keyboard_input_thread(void* arg) {
                                 if (current_profile_acceleration > 100) {
                                     current_profile_acceleration -= 100;
                                     printf("Decrease profile acceleration to: %d\n", current_profile_acceleration);
-                                    write_sdo(sock, 0x6083, 0, current_profile_acceleration);
+                                    set_profile_parameter(0x6083, current_profile_acceleration);
                                 } else {
                                     printf("Profile acceleration cannot be less than 100\n");
                                 }
@@ -540,7 +661,7 @@ void* keyboard_input_thread(void* arg) {
                                 if (current_profile_deceleration > 100) {
                                     current_profile_deceleration -= 100;
                                     printf("Decrease profile deceleration to: %d\n", current_profile_deceleration);
-                                    write_sdo(sock, 0x6084, 0, current_profile_deceleration);
+                                    set_profile_parameter(0x6084, current_profile_deceleration);
                                 } else {
                                     printf("Profile deceleration cannot be less than 100\n");
                                 }
@@ -570,79 +691,130 @@ void* keyboard_input_thread(void* arg) {
     return NULL;
 }
 
+/* Wait for the boot-up message after NMT reset node. Return 0 on success, -1 on timeout. */
+static int wait_bootup(uint32_t count, uint32_t timeout_ms) {
+    uint64_t start_us = time_us();
+
+    while (bootup_count == count) {
+        uint64_t elapsed_us = time_us() - start_us;
+        if (elapsed_us >= (uint64_t)timeout_ms * 1000) {
+            return -1;
+        }
+        can_process((uint32_t)((uint64_t)timeout_ms * 1000 - elapsed_us));
+    }
+    return 0;
+}
+
+/* Get the next statusword for the enable sequence. In PDO mode wait shortly for TPDO1, otherwise (or if no TPDO1
+ * arrives) read 0x6041 with SDO. Polling reads are not recorded in the event log. Return 0 on success. */
+static int get_statusword(uint16_t *statusword) {
+    if (use_pdo_mode) {
+        uint32_t count = pdo_rx_count;
+        uint64_t start_us = time_us();
+        uint64_t elapsed_us;
+        while (pdo_rx_count == count && (elapsed_us = time_us() - start_us) < STATUSWORD_TPDO_WAIT_US) {
+            can_process((uint32_t)(STATUSWORD_TPDO_WAIT_US - elapsed_us));
+        }
+        if (pdo_rx_count != count) {
+            *statusword = pdo_status_word;
+            return 0;
+        }
+    }
+
+    CO_SDOengine_xfer_t xfer = {.nodeId = current_motor_id, .index = 0x6041, .subIndex = 0, .upload = true};
+    if (sdo_transfer(&xfer) < 0 || xfer.size < 2) {
+        log_sdo(&xfer);
+        return -1;
+    }
+    *statusword = (uint16_t)(xfer.data[0] | (xfer.data[1] << 8));
+    return 0;
+}
+
+/* Bring the drive to operation enabled. Each controlword is sent as soon as the statusword shows, that the previous
+ * transition is finished. Return 0 on success, -1 on transition timeout or communication error. */
+static int enable_motor(int sock) {
+    cia402_axis_t axis;
+    uint64_t now_us = time_us();
+
+    cia402_init(&axis, current_motor_id, 0);
+    int send = cia402_enable(&axis, now_us);
+    while (!cia402_done(&axis)) {
+        if (send) {
+            printf("    %s: control word=%d\n", cia402_state_name(axis.state), axis.controlword);
+            if (write_sdo(sock, 0x6040, 0, axis.controlword) < 0) {
+                printf("Write control word failed\n");
+                return -1;
+            }
+        }
+        uint16_t statusword;
+        if (get_statusword(&statusword) < 0) {
+            printf("Read status word failed\n");
+            return -1;
+        }
+        now_us = time_us();
+        send = cia402_update(&axis, statusword, now_us);
+        send |= cia402_process(&axis, now_us);
+    }
+
+    if (axis.status != CIA402_SM_ENABLED) {
+        printf("Motor enable failed: drive stays in state '%s' (status word 0x%04X)\n",
+               cia402_state_name(axis.failed_state), axis.statusword);
+        return -1;
+    }
+    printf("    %s (status word 0x%04X) after %.1f ms\n", cia402_state_name(axis.state), axis.statusword,
+           (axis.done_us - axis.start_us) / 1000.0);
+    return 0;
+}
+
 /* PP模式初始化 */
 int init_pp_mode(int sock) {
+    uint64_t start_us = time_us();
     printf("=== Initialize PP mode (profile position mode) ===\n");
     
-    // 1. Stop node
+    // 1. Stop node, reset it and wait for its boot-up message
     printf("1. Stop node...\n");
     send_nmt_command(sock, 0x02, current_motor_id);  // Close node
-    usleep(200000);
+    uint32_t bootups = bootup_count;
     send_nmt_command(sock, 0x82, current_motor_id);  // Reset node
-    usleep(1000000);  // Increase waiting time
+    if (wait_bootup(bootups, BOOTUP_TIMEOUT_MS) < 0) {
+        printf("No boot-up message from node %d, continue\n", current_motor_id);
+    }
+    
+    // PDO mode: node is pre-operational after reset, remap PDOs before start
+    if (use_pdo_mode && configure_pdo_mapping(sock) < 0) {
+        return -1;
+    }
     
-    // 2. Start node
+    // 2. Start node, following SDO transfers are confirmed by the drive, no need to wait
     printf("2. Start node...\n");
     send_nmt_command(sock, 0x01, current_motor_id);
-    usleep(1000000);  // Wait for node to start completely
     
-    // 3. Set to profile position mode
+    // 3. and 4. Profile position mode and profile parameters in one batch. Engine writes them in order before the
+    // controlword writes of the enable sequence, so the enable sequence does not wait for them.
     printf("3. Set to profile position mode...\n");
-    if (write_sdo(sock, 0x6060, 0, 0x01) < 0) {
-        printf("Set profile position mode failed, try again...\n");
-    }
-    usleep(200000);
-    
-    // 4. Set profile parameters
     printf("4. Set profile parameters...\n");
-    printf("    Set profile velocity...\n");
-    if (write_sdo(sock, 0x6081, 0, 5566) < 0) {
-        printf("Set profile velocity failed, try again...\n");
-    }
-    usleep(200000);
-    
-    printf("    Set profile acceleration...\n");
-    if (write_sdo(sock, 0x6083, 0, 5566) < 0) {
-        printf("Set profile acceleration failed, try again...\n");
-    }
-    usleep(200000);
-    
-    printf("    Set profile deceleration...\n");
-    if (write_sdo(sock, 0x6084, 0, 5566) < 0) {
-        printf("Set profile deceleration failed, try again...\n");
-    }
-    usleep(200000);
-    
-    // 5. Clear error state
-    printf("5. Clear error state...\n");
-    printf("    Control word=128 (Clear error)\n");
-    if (write_sdo(sock, 0x6040, 0, 0x80) < 0) {
-        printf("Clear error command failed, try again...\n");
+    const sdo_param_t pp_params[] = {
+        {0x6060, 0, 0x01}, // Profile position mode
+        {0x6081, 0, current_profile_velocity},
+        {0x6083, 0, current_profile_acceleration},
+        {0x6084, 0, current_profile_deceleration},
+    };
+    if (write_sdo_batch(&param_batch, pp_params, sizeof(pp_params) / sizeof(pp_params[0])) < 0) {
+        printf("Profile parameters not queued\n");
     }
-    usleep(500000);
     
-    // 6. Motor enable sequence (according to the correct sequence in the screenshot)
-    printf("6. Motor enable sequence...\n");
-    printf("    Control word=6 (Shutdown)\n");
-    if (write_sdo(sock, 0x6040, 0, 0x06) < 0) {
-        printf("Shutdown command failed, try again...\n");
-    }
-    usleep(500000);
-    
-    printf("    Control word=7 (Switch on)\n");
-    if (write_sdo(sock, 0x6040, 0, 0x07) < 0) {
-        printf("Switch on command failed, try again...\n");
+    // 5. Motor enable sequence: fault reset (if needed), shutdown, switch on, enable operation
+    printf("5. Motor enable sequence...\n");
+    if (enable_motor(sock) < 0) {
+        return -1;
     }
-    usleep(500000);
-    
-    printf("    Control word=15 (Enable operation)\n");
-    if (write_sdo(sock, 0x6040, 0, 0x0F) < 0) {
-        printf("Enable operation command failed, try again...\n");
+    if (sdo_batch_wait(&param_batch) > 0) {
+        printf("%u of %u profile parameters not written\n", param_batch.failed, param_batch.count);
     }
-    usleep(500000);
     
-    printf("=== PP mode initialization completed ===\n");
+    printf("=== PP mode initialization completed in %.1f ms ===\n", (time_us() - start_us) / 1000.0);
     motor_enabled = 1; // Mark motor as enabled
+    pdo_control_word = 0x0F;
     return 0;
 }
 
@@ -664,6 +836,9 @@ void print_command_help(int sock) {
         printf("+d           - Increase profile deceleration (+100)\n");
         printf("-d           - Decrease profile deceleration (-100)\n");
         printf("s            - Stop motor\n");
+        printf("m            - Motion monitor: status and latency histograms, \"m r\" clears them\n");
+        printf("r            - SDO round trip time, retries and timeouts of the drive\n");
+        printf("l <level>    - Log level (0 off, 1 error, 2 SDO, 3 all frames)\n");
         printf("q            - Exit program\n");
         printf("==================\n");
     } else {
@@ -679,6 +854,9 @@ void print_command_help(int sock) {
         printf("+d           - Increase profile deceleration (+100)\n");
         printf("-d           - Decrease profile deceleration (-100)\n");
         printf("s            - Stop motor\n");
+        printf("m            - Motion monitor: status and latency histograms, \"m r\" clears them\n");
+        printf("r            - SDO round trip time, retries and timeouts of the drive\n");
+        printf("l <level>    - Log level (0 off, 1 error, 2 SDO, 3 all frames)\n");
         printf("q            - Exit program\n");
         printf("==================\n");
     }
@@ -698,16 +876,22 @@ int execute_position_move(int sock, int32_t target_position) {
         return -1;
     }
     
+    if (use_pdo_mode) {
+        return execute_position_move_pdo(sock, target_position);
+    }
+    
     // Display position information (turns)
     float target_turns = (float)target_position / MOTOR_RESOLUTION;
     printf("Target position: %d (%.2f turns)\n", target_position, target_turns);
     
     // Read current position
     uint32_t current_position;
-    if (read_sdo(sock, 0x6064, 0, &current_position) == 0) {
-        float current_turns = (float)(int32_t)current_position / MOTOR_RESOLUTION;
-        printf("Current position: %d (%.2f turns)\n", (int32_t)current_position, current_turns);
+    if (read_sdo(sock, 0x6064, 0, &current_position) < 0) {
+        printf("Read current position failed\n");
+        return -1;
     }
+    float current_turns = (float)(int32_t)current_position / MOTOR_RESOLUTION;
+    printf("Current position: %d (%.2f turns)\n", (int32_t)current_position, current_turns);
     
     // 1. Update position parameters
     printf("1. Update position parameters...\n");
@@ -732,6 +916,7 @@ int execute_position_move(int sock, int32_t target_position) {
     // 3. Set control word bit4=1 (new position instruction)
     printf("3. Set control word bit4=1 (new position instruction)...\n");
     uint32_t new_control_word = current_control_word | 0x10; // Set bit4
+    motion_monitor_command(&monitor, current_motor_id, target_position, time_us());
     if (write_sdo(sock, 0x6040, 0, new_control_word) < 0) {
         printf("Set control word failed\n");
         return -1;
@@ -742,8 +927,12 @@ int execute_position_move(int sock, int32_t target_position) {
     printf("4. Wait for status word bit12=1 (instruction received)...\n");
     int timeout_count = 0;
     uint32_t status_word;
+    uint32_t poll_position;
     while (timeout_count < 50) { // 5 seconds timeout
         if (read_sdo(sock, 0x6041, 0, &status_word) == 0) {
+            if (read_sdo(sock, 0x6064, 0, &poll_position) == 0) {
+                motion_monitor_update(&monitor, current_motor_id, status_word, (int32_t)poll_position, time_us());
+            }
             if (status_word & 0x1000) { // bit12=1
                 printf("    Status word bit12=1, instruction received\n");
                 break;
@@ -810,81 +999,158 @@ int execute_position_move(int sock, int32_t target_position) {
     return 0;
 }
 
-/* Monitor motion status */
-void monitor_motion(int sock) {
-    uint32_t status_word;
-    uint32_t actual_position;
-    int loop_count = 0;
+/* Execute position movement with PDOs - bit4/bit12 handshake from TPDO events */
+int execute_position_move_pdo(int sock, int32_t target_position) {
+    pdo_drain(sock);
+    printf("Target position: %d (%.2f turns), current position: %d\n", target_position,
+           (float)target_position / MOTOR_RESOLUTION, pdo_actual_position);
+    
+    // 1. New setpoint: target position and controlword bit4=1 in one RPDO
+    uint16_t new_control_word = pdo_control_word | 0x10;
+    uint64_t start_us = time_us();
+    motion_monitor_command(&monitor, current_motor_id, target_position, start_us);
+    if (send_rpdo(sock, new_control_word, target_position) < 0) {
+        printf("Send RPDO failed\n");
+        return -1;
+    }
     
-    printf("\n=== Monitor motion status ===\n");
-    printf("Use keyboard commands to control the motor, input 'q' to exit the program\n\n");
+    // 2. Wait for TPDO with statusword bit12=1 (setpoint acknowledged)
+    int64_t ack_us = pdo_wait_setpoint_ack(sock, 1, start_us);
+    if (ack_us < 0) {
+        printf("Timeout: status word bit12 not changed to 1 (status word 0x%04X)\n", pdo_status_word);
+        send_rpdo(sock, new_control_word & ~0x10, target_position);
+        return -1;
+    }
     
-    while (running) {
-        loop_count++;
-        
-        // Read status word
-        if (read_sdo(sock, 0x6041, 0, &status_word) == 0) {
-            // Read actual position
-            if (read_sdo(sock, 0x6064, 0, &actual_position) == 0) {
-                // Print only when the status changes, to avoid screen flickering
-                static uint32_t last_status = 0;
-                static uint32_t last_position = 0;
-                
-                if (status_word != last_status || actual_position != last_position) {
-                    printf("\n[Status] Status word: 0x%04X | Actual position: %d | Target position: %d", 
-                           (uint16_t)status_word, (int32_t)actual_position, current_target_position);
-            
-            // Check if the target is reached
-            if (status_word & 0x0400) {
-                printf(" | Target reached!");
-                    }
-                    printf("\n");
-                    fflush(stdout);
-                    
-                    last_status = status_word;
-                    last_position = actual_position;
-                }
-            }
-        }
-        
-        usleep(5000000); // 5 seconds update once, reduce frequency
+    // 3. Release setpoint: controlword bit4=0, wait for bit12=0
+    uint64_t release_us = time_us();
+    send_rpdo(sock, new_control_word & ~0x10, target_position);
+    int64_t ready_us = pdo_wait_setpoint_ack(sock, 0, release_us);
+    
+    printf("Setpoint acknowledged in %.2f ms", ack_us / 1000.0);
+    if (ready_us >= 0) {
+        printf(", ready for new setpoint in %.2f ms", ready_us / 1000.0);
+    } else {
+        printf(", timeout waiting for status word bit12=0");
     }
+    printf(" (status word 0x%04X, actual position %d)\n", pdo_status_word, pdo_actual_position);
     
-    printf("\nMonitor end\n");
+    // Re-print command prompt
+    print_command_help(sock);
+    
+    return ready_us >= 0 ? 0 : -1;
+}
+
+/* Print motion monitor: last status of the motor and latency histograms. Status changes are printed by the log
+ * thread as soon as TPDO1 arrives, in SDO mode only statusword reads during a position move are monitored. */
+void monitor_motion(int sock) {
+    pdo_drain(sock);
+    uint64_t now_us = time_us();
+    printf("\n=== Motion monitor ===\n");
+    motion_monitor_print(&monitor, stdout);
+    monitor_axis_t *axis = motion_monitor_axis(&monitor, current_motor_id);
+    if (axis != NULL && axis->updates > 0) {
+        printf("Last update %.1f ms ago\n", (now_us - axis->update_us) / 1000.0);
+    }
+}
+
+/* Open CAN interface, initialize SDO engine, TPDO1 and EMCY reception, NMT and RPDO1 transmission */
+int can_init(const char *interface) {
+    can_ptr.can_ifindex = (int)if_nametoindex(interface);
+    if (can_ptr.can_ifindex == 0) {
+        perror("Get interface index failed");
+        return -1;
+    }
+
+    if (CO_CANmodule_init(&can_module, &can_ptr, can_rx, RX_COUNT, can_tx, TX_COUNT, 1000) != CO_ERROR_NO) {
+        printf("CAN module initialization failed\n");
+        return -1;
+    }
+    if (CO_SDOengine_init(&sdo_engine, sdo_clients, SDO_CHANNELS, &can_module, RX_IDX_SDO, &can_module, TX_IDX_SDO,
+                          TIMEOUT_MS) != CO_ERROR_NO) {
+        printf("SDO engine initialization failed\n");
+        CO_CANmodule_disable(&can_module);
+        return -1;
+    }
+    // lost SDO frame is repeated after the measured round trip time, TIMEOUT_MS stays the limit
+    CO_SDOrtt_init(&sdo_rtt, SDO_RTT_MIN_TIMEOUT_MS, TIMEOUT_MS, SDO_RTT_RETRIES);
+    for (int i = 0; i < SDO_CHANNELS; i++) {
+        CO_SDOclient_setRtt(&sdo_clients[i], &sdo_rtt);
+    }
+
+    nmt_tx = CO_CANtxBufferInit(&can_module, TX_IDX_NMT, CO_CAN_ID_NMT_SERVICE, false, 2, false);
+    rpdo_tx = CO_CANtxBufferInit(&can_module, TX_IDX_RPDO, CO_CAN_ID_RPDO_1 + current_motor_id, false, 6, false);
+    CO_ReturnError_t ret = CO_ERROR_NO;
+    if (use_pdo_mode) {
+        ret = CO_CANrxBufferInit(&can_module, RX_IDX_TPDO, CO_CAN_ID_TPDO_1 + current_motor_id, 0x7FF, false,
+                                 &current_motor_id, pdo_receive);
+    }
+    if (ret == CO_ERROR_NO) {
+        ret = CO_CANrxBufferInit(&can_module, RX_IDX_EMCY, CO_CAN_ID_EMERGENCY + current_motor_id, 0x7FF, false,
+                                 &current_motor_id, emcy_receive);
+    }
+    if (ret == CO_ERROR_NO) {
+        ret = CO_CANrxBufferInit(&can_module, RX_IDX_BOOTUP, CO_CAN_ID_HEARTBEAT + current_motor_id, 0x7FF, false,
+                                 &current_motor_id, bootup_receive);
+    }
+    if (ret != CO_ERROR_NO || nmt_tx == NULL || rpdo_tx == NULL) {
+        printf("CAN buffer initialization failed\n");
+        CO_CANmodule_disable(&can_module);
+        return -1;
+    }
+
+    CO_CANsetNormalMode(&can_module);
+    can_last_us = time_us();
+    return 0;
+}
+
+/* Print SDO round trip statistics of the drive */
+static void print_sdo_rtt(void) {
+    const CO_SDOrtt_node_t *node = CO_SDOrtt_get(&sdo_rtt, current_motor_id);
+    if (node == NULL || node->samples == 0) {
+        printf("SDO round trip: no response from node %d yet\n", current_motor_id);
+        return;
+    }
+    printf("SDO round trip of node %d: %u samples, smoothed %.2f ms, variation %.2f ms, min %.2f ms, max %.2f ms\n",
+           current_motor_id, node->samples, node->srtt_us / 1000.0, node->rttvar_us / 1000.0,
+           node->rttMin_us / 1000.0, node->rttMax_us / 1000.0);
+    printf("  retransmission timeout %.2f ms, %u retries, %u timeouts\n",
+           CO_SDOrtt_retryTimeout_us(&sdo_rtt, current_motor_id, TIMEOUT_MS * 1000) / 1000.0, node->retries,
+           node->timeouts);
 }
 
 /* Simplified node check - only send NMT start command */
 int check_can_connection(int sock) {
     printf("=== Check CAN connection ===\n");
-    struct can_frame frame;
-    
+
     // Send NMT start command to all nodes
-    frame.can_id = 0x000;
-    frame.can_dlc = 2;
-    frame.data[0] = 0x01;  // NMT start command
-    frame.data[1] = 0x00;  // All nodes
-    
-    if (write(sock, &frame, sizeof(frame)) < 0) {
+    if (send_nmt_command(sock, 0x01, 0x00) < 0) {
         printf("Send NMT start command failed\n");
         return -1;
     }
-    
-    usleep(500000);  // Wait 500ms for the node to start
     printf("CAN connection normal, start motor control\n");
     return 0;
 }
 
 int main(int argc, char *argv[]) {
     int sock;
-    struct sockaddr_can addr;
-    struct ifreq ifr;
     const char *interface = "can0";
     
     signal(SIGINT, signal_handler);
+    // stdin is unbuffered, so poll() in the main loop sees every pending input line
+    setvbuf(stdin, NULL, _IONBF, 0);
+    
+    // SDO transfers and CAN frames are printed by the log thread, APP_LOG_LEVEL=3 shows every PDO frame
+    app_log_init(APP_LOG_INFO);
+    motion_monitor_init(&monitor);
     
     printf("eRob joint motor PP mode control program\n");
     printf("Mode: Profile Position Mode (PP Mode)\n");
-    printf("Communication: CANopen SDO\n");
+    // PDO mode is selected with "pdo" after node ID
+    if (argc > 2 && strcmp(argv[2], "pdo") == 0) {
+        use_pdo_mode = 1;
+    }
+    printf("Communication: CANopen %s\n", use_pdo_mode ? "SDO configuration, PDO setpoints" : "SDO");
     printf("Based on: eRob CANopen and EtherCAT User Manual V1.9\n\n");
     
     // analyze command line parameters
@@ -895,13 +1161,13 @@ int main(int argc, char *argv[]) {
             printf("Using specified motor node ID: %d\n", current_motor_id);
         } else {
             printf("Error: node ID must be between 1 and 127\n");
-            printf("Usage: %s [node ID]\n", argv[0]);
-            printf("For example: %s 2\n", argv[0]);
+            printf("Usage: %s [node ID] [pdo]\n", argv[0]);
+            printf("For example: %s 2 pdo\n", argv[0]);
             return 1;
         }
     } else {
-        printf("Usage: %s [node ID]\n", argv[0]);
-        printf("For example: %s 2\n", argv[0]);
+        printf("Usage: %s [node ID] [pdo]\n", argv[0]);
+        printf("For example: %s 2 pdo\n", argv[0]);
         printf("Please specify motor node ID (1-127): ");
         
         int input_id;
@@ -919,39 +1185,21 @@ int main(int argc, char *argv[]) {
         }
     }
     
-    // Load EDS file
-    if (parse_eds_file(EDS_FILE_PATH) < 0) {
-        printf("EDS file load failed, using default data type\n");
-    }
-    
-    // create CAN socket
-    sock = socket(PF_CAN, SOCK_RAW, CAN_RAW);
-    if (sock < 0) {
-        perror("Create socket failed");
-        return 1;
-    }
-    
-    // set CAN interface
-    strcpy(ifr.ifr_name, interface);
-    if (ioctl(sock, SIOCGIFINDEX, &ifr) < 0) {
-        perror("Get interface index failed");
-        close(sock);
-        return 1;
-    }
-    
-    addr.can_family = AF_CAN;
-    addr.can_ifindex = ifr.ifr_ifindex;
+    // Object table of the drive, no EDS file is parsed at runtime
+    eds_index_from_table(&eds_index, erob_eds_objects, EROB_EDS_COUNT);
     
-    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
-        perror("Bind socket failed");
-        close(sock);
+    // open CAN interface, kernel filter passes only frames of the registered receive buffers
+    if (can_init(interface) < 0) {
+        app_log_close();
         return 1;
     }
+    sock = can_module.fd;
     
     // check CAN connection
     if (check_can_connection(sock) < 0) {
         printf("CAN connection check failed\n");
-        close(sock);
+        CO_CANmodule_disable(&can_module);
+        app_log_close();
         return 1;
     }
     
@@ -960,19 +1208,26 @@ int main(int argc, char *argv[]) {
     // initialize PP mode
     if (init_pp_mode(sock) < 0) {
         printf("PP mode initialization failed\n");
-        close(sock);
+        CO_CANmodule_disable(&can_module);
+        app_log_close();
         return 1;
     }
     
     // ensure terminal settings are correct
     print_command_help(sock);
     
-    // Main loop: keyboard input and status monitoring
+    // Main loop: keyboard input and status monitoring. TPDOs are processed by the motion monitor while waiting for
+    // input.
     char input[256];
     while (running) {
         printf("\n>>> Enter command: ");
         fflush(stdout);
         
+        struct pollfd stdin_pfd = {.fd = STDIN_FILENO, .events = POLLIN};
+        while (running && poll(&stdin_pfd, 1, 0) == 0) {
+            can_process(20000);
+        }
+        
         if (fgets(input, sizeof(input), stdin) != NULL) {
             // Remove newline
             input[strcspn(input, "\n")] = 0;
@@ -1003,7 +1258,7 @@ int main(int argc, char *argv[]) {
                     if (parsed_value > 0) {
                         current_profile_velocity = parsed_value;
                         printf("Set profile velocity: %d\n", current_profile_velocity);
-                        write_sdo(sock, 0x6081, 0, current_profile_velocity);
+                        set_profile_parameter(0x6081, current_profile_velocity);
                     } else {
                         printf("Current profile velocity: %d\n", current_profile_velocity);
                     }
@@ -1014,7 +1269,7 @@ int main(int argc, char *argv[]) {
                     if (parsed_value > 0) {
                         current_profile_acceleration = parsed_value;
                         printf("Set profile acceleration: %d\n", current_profile_acceleration);
-                        write_sdo(sock, 0x6083, 0, current_profile_acceleration);
+                        set_profile_parameter(0x6083, current_profile_acceleration);
                     } else {
                         printf("Current profile acceleration: %d\n", current_profile_acceleration);
                     }
@@ -1025,7 +1280,7 @@ int main(int argc, char *argv[]) {
                     if (parsed_value > 0) {
                         current_profile_deceleration = parsed_value;
                         printf("Set profile deceleration: %d\n", current_profile_deceleration);
-                        write_sdo(sock, 0x6084, 0, current_profile_deceleration);
+                        set_profile_parameter(0x6084, current_profile_deceleration);
                     } else {
                         printf("Current profile deceleration: %d\n", current_profile_deceleration);
                     }
@@ -1038,17 +1293,17 @@ int main(int argc, char *argv[]) {
                             case 'v':
                                 current_profile_velocity += 100;
                                 printf("Increase profile velocity to: %d\n", current_profile_velocity);
-                                write_sdo(sock, 0x6081, 0, current_profile_velocity);
+                                set_profile_parameter(0x6081, current_profile_velocity);
                                 break;
                             case 'a':
                                 current_profile_acceleration += 100;
                                 printf("Increase profile acceleration to: %d\n", current_profile_acceleration);
-                                write_sdo(sock, 0x6083, 0, current_profile_acceleration);
+                                set_profile_parameter(0x6083, current_profile_acceleration);
                                 break;
                             case 'd':
                                 current_profile_deceleration += 100;
                                     printf("Increase profile deceleration to: %d\n", current_profile_deceleration);
-                                write_sdo(sock, 0x6084, 0, current_profile_deceleration);
+                                set_profile_parameter(0x6084, current_profile_deceleration);
                                 break;
                         }
                     }
@@ -1061,7 +1316,7 @@ int main(int argc, char *argv[]) {
                                 if (current_profile_velocity > 100) {
                                     current_profile_velocity -= 100;
                                     printf("Decrease profile velocity to: %d\n", current_profile_velocity);
-                                    write_sdo(sock, 0x6081, 0, current_profile_velocity);
+                                    set_profile_parameter(0x6081, current_profile_velocity);
                                 } else {
                                     printf("Profile velocity cannot be less than 100\n");
                                 }
@@ -1070,7 +1325,7 @@ int main(int argc, char *argv[]) {
                                 if (current_profile_acceleration > 100) {
                                     current_profile_acceleration -= 100;
                                     printf("Decrease profile acceleration to: %d\n", current_profile_acceleration);
-                                    write_sdo(sock, 0x6083, 0, current_profile_acceleration);
+                                    set_profile_parameter(0x6083, current_profile_acceleration);
                                 } else {
                                     printf("Profile acceleration cannot be less than 100\n");
                                 }
@@ -1079,7 +1334,7 @@ int main(int argc, char *argv[]) {
                                 if (current_profile_deceleration > 100) {
                                     current_profile_deceleration -= 100;
                                     printf("Decrease profile deceleration to: %d\n", current_profile_deceleration);
-                                    write_sdo(sock, 0x6084, 0, current_profile_deceleration);
+                                    set_profile_parameter(0x6084, current_profile_deceleration);
                                 } else {
                                     printf("Profile deceleration cannot be less than 100\n");
                                 }
@@ -1094,6 +1349,26 @@ int main(int argc, char *argv[]) {
                     print_command_help(sock);
                     break;
                     
+                case 'm': // Motion monitor
+                    if (input[1] == ' ' && input[2] == 'r') {
+                        motion_monitor_reset(&monitor);
+                        printf("Latency histograms cleared\n");
+                    } else {
+                        monitor_motion(sock);
+                    }
+                    break;
+                    
+                case 'r': // SDO round trip time
+                    print_sdo_rtt();
+                    break;
+                    
+                case 'l': // Log level
+                    if (strlen(input) > 2) {
+                        app_log_set_level(parsed_value);
+                    }
+                    printf("Log level: %d (0 off, 1 error, 2 SDO, 3 all frames)\n", atomic_load(&app_log_level));
+                    break;
+                    
                 case 'q': // Exit program
                     printf("Exit program...\n");
                     running = 0;
@@ -1116,7 +1391,9 @@ int main(int argc, char *argv[]) {
     // Restore terminal settings
     restore_terminal();
     
-    close(sock);
+    CO_CANmodule_disable(&can_module);
+    eds_index_free(&eds_index);
+    app_log_close();
     printf("Program end\n");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*
+ * author: ZeroErr Inc.
+ * CO_process benchmark: execution time of one processing cycle (CO_process, CO_process_SYNC, CO_process_RPDO and
+ * CO_process_TPDO) of a single CANopen node with the default Object Dictionary (OD.c)
+ *
+ * The same source is built twice: process_bench_generic with objects from heap, where the processing functions
+ * access objects through the pointers in CO_t, and process_bench_static with CO_USE_GLOBALS, where the processing
+ * functions are specialized for the fixed configuration. Cycles run back to back with a simulated time step, so
+ * timers in the stack (heartbeat, SYNC, PDO event timers) advance as in a real application. Both variants are built
+ * without CO_prof (CO_CONFIG_PROF=0), because its clock reads cost the same in both and would hide the difference.
+ * Code size of both variants is printed by the process_bench_size build target. The process_bench_compare target runs
+ * both variants twice, alternating.
+ *
+ * Result is one JSON object on stdout, errors are on stderr.
+ *
+ * Usage: process_bench [-i <interface>] [-n <cycles>] [-s <time step us>]
+ *
+ * Example: sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0 && ./process_bench_static -n 1000000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <net/if.h>
+
+#include "CANopen.h"
+#include "OD.h"
+#include "OD_hash.h"
+
+#ifdef CO_USE_GLOBALS
+#define VARIANT "static"
+#else
+#define VARIANT "generic"
+#endif
+
+#define NODE_ID        4
+#define DEFAULT_CYCLES 1000000
+#define DEFAULT_STEP   1000
+#define WARMUP_CYCLES  10000
+// cycles measured together, best batch is reported as min
+#define BATCH_CYCLES   1000
+
+static void usage(const char *prog) {
+    printf("Usage: %s [-i <interface>] [-n <cycles>] [-s <time step us>]\n\n", prog);
+    printf("Options:\n");
+    printf("  -i <interface>  CAN interface (default: vcan0)\n");
+    printf("  -n <cycles>     number of measured processing cycles (default: %d)\n", DEFAULT_CYCLES);
+    printf("  -s <step>       simulated time between cycles in microseconds (default: %d)\n", DEFAULT_STEP);
+}
+
+static uint64_t time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static void cycle(CO_t *co, uint32_t step_us) {
+    uint32_t timer_next_us = step_us;
+    bool_t sync_was = false;
+
+    (void)CO_process(co, false, step_us, &timer_next_us);
+#if ((CO_CONFIG_SYNC)&CO_CONFIG_SYNC_ENABLE) != 0
+    sync_was = CO_process_SYNC(co, step_us, &timer_next_us);
+#endif
+#if ((CO_CONFIG_PDO)&CO_CONFIG_RPDO_ENABLE) != 0
+    CO_process_RPDO(co, sync_was, step_us, &timer_next_us);
+#endif
+#if ((CO_CONFIG_PDO)&CO_CONFIG_TPDO_ENABLE) != 0
+    CO_process_TPDO(co, sync_was, step_us, &timer_next_us);
+#endif
+    (void)sync_was;
+}
+
+static bool_t node_init(CO_t *co, CO_CANptrSocketCan_t *can_ptr) {
+    uint8_t node_id = NODE_ID;
+    uint16_t bit_rate = 1000;
+    uint32_t err_info = 0;
+    CO_ReturnError_t err;
+
+    err = CO_CANinit(co, can_ptr, bit_rate);
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "Error: CAN initialization failed: %d\n", err);
+        return false;
+    }
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_SLAVE) != 0
+    CO_LSS_address_t lss_address = {.identity = {.vendorID = OD_PERSIST_COMM.x1018_identity.vendor_ID,
+                                                 .productCode = OD_PERSIST_COMM.x1018_identity.productCode,
+                                                 .revisionNumber = OD_PERSIST_COMM.x1018_identity.revisionNumber,
+                                                 .serialNumber = OD_PERSIST_COMM.x1018_identity.serialNumber}};
+    err = CO_LSSinit(co, &lss_address, &node_id, &bit_rate);
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "Error: LSS slave initialization failed: %d\n", err);
+        return false;
+    }
+#endif
+    err = CO_CANopenInit(co, NULL, NULL, OD, NULL, CO_NMT_STARTUP_TO_OPERATIONAL, 500, 1000, 500, false, node_id,
+                         &err_info);
+    if (err == CO_ERROR_NO) {
+        err = CO_CANopenInitPDO(co, co->em, OD, node_id, &err_info);
+    }
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "Error: CANopen initialization failed: %d, OD entry 0x%X\n", err, err_info);
+        return false;
+    }
+    CO_CANsetNormalMode(co->CANmodule);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const char *ifname = "vcan0";
+    uint32_t cycles = DEFAULT_CYCLES;
+    uint32_t step_us = DEFAULT_STEP;
+    uint32_t heap_used = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:n:s:h")) != -1) {
+        switch (opt) {
+            case 'i': ifname = optarg; break;
+            case 'n': cycles = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': step_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default: usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (cycles < BATCH_CYCLES) {
+        cycles = BATCH_CYCLES;
+    }
+
+    CO_CANptrSocketCan_t can_ptr = {.can_ifindex = (int)if_nametoindex(ifname)};
+    if (can_ptr.can_ifindex == 0) {
+        fprintf(stderr, "Error: Can't find CAN device \"%s\"\n", ifname);
+        return EXIT_FAILURE;
+    }
+#if OD_HASH > 0
+    if (OD_initHash(OD, &OD_hash) != ODR_OK) {
+        fprintf(stderr, "Error: OD_hash.c does not match OD.c\n");
+        return EXIT_FAILURE;
+    }
+#endif
+
+    CO_t *co = CO_new(NULL, &heap_used);
+    if (co == NULL || !node_init(co, &can_ptr)) {
+        CO_delete(co);
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < WARMUP_CYCLES; i++) {
+        cycle(co, step_us);
+    }
+
+    uint64_t best_ns = UINT64_MAX;
+    uint64_t worst_ns = 0;
+    uint64_t total_ns = 0;
+    uint32_t batches = cycles / BATCH_CYCLES;
+    for (uint32_t b = 0; b < batches; b++) {
+        uint64_t start = time_ns();
+        for (uint32_t i = 0; i < BATCH_CYCLES; i++) {
+            cycle(co, step_us);
+        }
+        uint64_t elapsed = time_ns() - start;
+        total_ns += elapsed;
+        if (elapsed < best_ns) {
+            best_ns = elapsed;
+        }
+        if (elapsed > worst_ns) {
+            worst_ns = elapsed;
+        }
+    }
+
+    uint32_t measured = batches * BATCH_CYCLES;
+    printf("{\"variant\": \"%s\", \"interface\": \"%s\", \"cycles\": %u, \"step_us\": %u, \"heap_bytes\": %u, "
+           "\"ns_per_cycle\": {\"mean\": %.2f, \"min_batch\": %.2f, \"max_batch\": %.2f}}\n",
+           VARIANT, ifname, measured, step_us, heap_used, (double)total_ns / (double)measured,
+           (double)best_ns / BATCH_CYCLES, (double)worst_ns / BATCH_CYCLES);
+
+    CO_delete(co);
+    return EXIT_SUCCESS;
+}
@@ -1,6 +1,11 @@
   /*
  * CANopen电机扫描和详细信息读取程序
- * 支持快速扫描和详细读取两种模式
+ * 支持快速扫描, 并行扫描和详细读取三种模式
+ * 并行扫描: 向所有节点连续发送请求, 一个超时窗口内收集响应, 同时监听启动和心跳报文
+ * 身份对象 (0x1018) 缓存在文件中 (CO_SDOcache), 再次读取时不发送SDO请求. 节点启动报文或设备类型变化时缓存失效
+ * 每个节点测量SDO往返时间 (CO_SDOrtt), 丢失的请求在重发超时后重发, 不必等待整个超时时间
+ * 总线负载模式: 监听总线上的所有报文 (CO_CANstats), 每秒打印1s, 10s和60s窗口的负载 (包括填充位), 结束时打印每个
+ * COB-ID的报文数, 字节数, 最小和最大间隔及占用的总线负载, 用于确定PDO频率和SYNC周期
  */
 
 #include <stdio.h>
@@ -8,6 +13,8 @@
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
+#include <errno.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
 #include <net/if.h>
@@ -16,12 +23,30 @@
 #include <signal.h>
 #include <time.h>
 
+#include "extra/CO_SDOcache.h"
+#include "extra/CO_SDOrtt.h"
+#include "CO_CANstats.h"
+
 #define QUICK_TIMEOUT_MS 100  // 100ms超时
 #define DETAIL_TIMEOUT_MS 1000  // 1000ms超时
+#define RTT_MIN_TIMEOUT_MS 10   // 最短重发超时
+#define RTT_RETRIES 2           // 一个请求最多重发次数
 #define MAX_SCAN_NODES 20     // 只扫描前20个节点
+#define BUSLOAD_BITRATE_KBIT 1000   // 总线负载模式默认波特率
+#define BUSLOAD_WARNING 7000        // 负载超过70%时警告, 单位0.01%
+#define CACHE_FILE "quick_scan.cache"  // 静态对象缓存文件, 在当前目录
+#define CACHE_MAGIC 0x31435351U        // "QSC1"
 
 volatile int running = 1;
 
+/* 静态对象缓存, 程序启动时从文件读取, 结束时写入文件 */
+static CO_SDOcache_t sdo_cache;
+static unsigned cache_hits;    // 从缓存读取的对象数
+static unsigned sdo_requests;  // 发送的SDO请求数
+
+/* 每个节点的SDO往返时间, 决定重发超时 */
+static CO_SDOrtt_t sdo_rtt;
+
 void signal_handler(int sig) {
     running = 0;
     printf("\n程序被中断\n");
@@ -111,167 +136,638 @@ int quick_scan_node(int sock, uint8_t node_id) {
     return 0;
 }
 
-/* 读取节点详细信息 */
-int read_node_info(int sock, uint8_t node_id) {
-    uint32_t data;
+/* 单调时钟, 微秒 */
+static uint64_t time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/* 详细信息中读取的对象, 第一个是设备类型 */
+static const struct {
+    uint16_t index;
+    uint8_t subindex;
+} info_objects[] = {
+    {0x1000, 0}, // 设备类型
+    {0x1001, 0}, // 错误寄存器
+    {0x1018, 1}, // 厂商ID
+    {0x1018, 2}, // 产品代码
+    {0x1018, 3}, // 版本号
+    {0x1018, 4}, // 序列号
+    {0x6040, 0}, // 控制字
+    {0x6041, 0}, // 状态字
+    {0x6060, 0}, // 操作模式
+};
+#define INFO_COUNT (int)(sizeof(info_objects) / sizeof(info_objects[0]))
+
+/* 并行扫描中一个节点的状态, 每个节点同时只有一个SDO请求 */
+typedef struct {
+    int pending;                      // 等待SDO响应
+    int step;                         // 当前请求在info_objects中的序号
+    int end;                          // 最后一个请求之后的序号
+    uint64_t deadline_us;             // 当前请求的超时时刻
+    uint64_t sent_us;                 // 当前请求的发送时刻
+    uint64_t retry_us;                // 重发时刻
+    uint32_t rto_us;                  // 重发超时, 每次重发加倍
+    int retries;                      // 当前请求的重发次数
+    int responded;                    // 收到过0x580+id的响应
+    uint32_t response_us;             // 第一个响应距扫描开始的时间
+    int heartbeat;                    // 收到过0x700+id (启动或心跳报文)
+    uint8_t nmt_state;                // 最后一个心跳报文中的NMT状态
+    int valid[INFO_COUNT];            // 1: 读取成功, 0: 无响应, -1: SDO中止
+    uint32_t value[INFO_COUNT];       // 读取的数据或SDO中止码
+} scan_node_t;
+
+/* 缓存文件头 */
+typedef struct {
+    uint32_t magic;
+    uint32_t entries;
+    uint32_t entry_size;
+} cache_header_t;
+
+/* 从文件读取缓存, 文件不存在或格式不同时缓存为空 */
+static void cache_load(void) {
+    cache_header_t header;
+    FILE *f = fopen(CACHE_FILE, "rb");
+
+    CO_SDOcache_init(&sdo_cache, NULL, NULL);
+    if (f == NULL) {
+        return;
+    }
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != CACHE_MAGIC
+        || header.entries != CO_SDO_CACHE_ENTRIES || header.entry_size != sizeof(CO_SDOcache_entry_t)
+        || fread(sdo_cache.entries, sizeof(sdo_cache.entries), 1, f) != 1) {
+        CO_SDOcache_invalidate(&sdo_cache, 0);
+    }
+    fclose(f);
+    CO_SDOcache_verify(&sdo_cache);
+}
+
+/* 写入缓存文件 */
+static void cache_save(void) {
+    cache_header_t header = {CACHE_MAGIC, CO_SDO_CACHE_ENTRIES, sizeof(CO_SDOcache_entry_t)};
+    FILE *f = fopen(CACHE_FILE, "wb");
+
+    if (f == NULL) {
+        return;
+    }
+    if (fwrite(&header, sizeof(header), 1, f) != 1 || fwrite(sdo_cache.entries, sizeof(sdo_cache.entries), 1, f) != 1) {
+        perror("写入缓存文件失败");
+    }
+    fclose(f);
+}
+
+/* 从缓存读取当前步骤的对象, 成功时返回1. 第一步 (0x1000) 总是从总线读取, 用于确认节点存在 */
+static int scan_cached(scan_node_t *n, uint8_t node_id) {
+    uint8_t buf[4] = {0};
+    size_t size = 0;
+
+    if (n->step == 0 || !CO_SDOcache_get(&sdo_cache, node_id, info_objects[n->step].index,
+                                         info_objects[n->step].subindex, buf, sizeof(buf), &size)) {
+        return 0;
+    }
+    n->valid[n->step] = 1;
+    n->value[n->step] = buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+    cache_hits++;
+    return 1;
+}
+
+/* 保存读取成功的对象. 设备类型与缓存不同时, 节点可能被更换, 删除节点的所有缓存 */
+static void scan_store(const scan_node_t *n, uint8_t node_id, const struct can_frame *frame) {
+    uint8_t size = (frame->data[0] & 0x01) ? 4 - ((frame->data[0] >> 2) & 0x03) : 4;
+    uint8_t cached[4];
+    size_t cached_size = 0;
+
+    if ((frame->data[0] & 0x02) == 0) {
+        return;  // 只缓存快速传输的数据
+    }
+    if (n->step == 0 && CO_SDOcache_get(&sdo_cache, node_id, 0x1000, 0, cached, sizeof(cached), &cached_size)
+        && (cached_size != size || memcmp(cached, &frame->data[4], size) != 0)) {
+        CO_SDOcache_invalidate(&sdo_cache, node_id);
+    }
+    CO_SDOcache_put(&sdo_cache, node_id, info_objects[n->step].index, info_objects[n->step].subindex,
+                    &frame->data[4], size);
+}
+
+/* 发送节点当前步骤的SDO请求, 缓存中的对象不发送请求. 发送队列满时等待, 不丢弃请求 */
+static int scan_send(int sock, scan_node_t *nodes, uint8_t node_id, int timeout_ms) {
+    scan_node_t *n = &nodes[node_id];
+    while (n->step < n->end && scan_cached(n, node_id)) {
+        n->step++;
+    }
+    if (n->step >= n->end) {
+        n->pending = 0;
+        return 0;
+    }
+    while (send_sdo_request(sock, node_id, info_objects[n->step].index, info_objects[n->step].subindex) < 0) {
+        if (errno != ENOBUFS && errno != EAGAIN) {
+            n->pending = 0;
+            return -1;
+        }
+        struct pollfd pfd = {.fd = sock, .events = POLLOUT};
+        poll(&pfd, 1, 10);
+    }
+    n->pending = 1;
+    n->sent_us = time_us();
+    n->retries = 0;
+    // 慢节点的超时延长到重发超时, 没有测量值时不重发
+    n->deadline_us = n->sent_us + CO_SDOrtt_timeout_us(&sdo_rtt, node_id, (uint32_t)timeout_ms * 1000);
+    n->rto_us = CO_SDOrtt_retryTimeout_us(&sdo_rtt, node_id, (uint32_t)timeout_ms * 1000);
+    n->retry_us = n->sent_us + n->rto_us;
+    sdo_requests++;
+    return 0;
+}
+
+/* 重发超时后再次发送当前请求. 重发的请求不用于测量往返时间 */
+static void scan_retry(int sock, scan_node_t *nodes, uint8_t node_id, uint64_t now_us) {
+    scan_node_t *n = &nodes[node_id];
+    if (n->retries >= sdo_rtt.maxRetries || n->retry_us > now_us || n->retry_us >= n->deadline_us) {
+        return;
+    }
+    if (send_sdo_request(sock, node_id, info_objects[n->step].index, info_objects[n->step].subindex) < 0) {
+        n->retry_us = now_us + 1000;  // 发送队列满, 1ms后再试
+        return;
+    }
+    CO_SDOrtt_retry(&sdo_rtt, node_id);
+    n->retries++;
+    n->rto_us *= 2;
+    n->retry_us = now_us + n->rto_us;
+    sdo_requests++;
+}
+
+/* 当前步骤结束, 发送同一节点的下一个请求 */
+static void scan_next(int sock, scan_node_t *nodes, uint8_t node_id, int timeout_ms) {
+    scan_node_t *n = &nodes[node_id];
+    n->pending = 0;
+    if (++n->step < n->end) {
+        scan_send(sock, nodes, node_id, timeout_ms);
+    }
+}
+
+/* 处理一帧: SDO响应按0x580+id分配给节点, 0x700+id记录启动和心跳 */
+static void scan_handle_frame(int sock, scan_node_t *nodes, int max_nodes, const struct can_frame *frame,
+                              uint64_t start_us, int timeout_ms) {
+    uint8_t node_id = frame->can_id & 0x7F;
+    uint32_t function = frame->can_id & 0x780;
+    
+    if ((frame->can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG)) != 0 || node_id == 0 || node_id > max_nodes) {
+        return;
+    }
+    scan_node_t *n = &nodes[node_id];
     
-    printf("=== 节点 %d 详细信息 ===\n", node_id);
+    if (function == 0x700 && frame->can_dlc >= 1) {
+        n->heartbeat = 1;
+        n->nmt_state = frame->data[0] & 0x7F;
+        if (n->nmt_state == 0x00) {
+            CO_SDOcache_invalidate(&sdo_cache, node_id);  // 启动报文, 节点被复位
+        }
+        return;
+    }
+    if (function != 0x580 || frame->can_dlc != 8 || !n->pending) {
+        return;
+    }
+    uint16_t index = frame->data[1] | (frame->data[2] << 8);
+    if (index != info_objects[n->step].index || frame->data[3] != info_objects[n->step].subindex) {
+        return;  // 不是当前请求的响应
+    }
     
-    // 读取设备类型 (0x1000)
-    printf("读取设备类型 (0x1000)... ");
-    if (send_sdo_request(sock, node_id, 0x1000, 0) < 0) {
-        printf("发送失败\n");
-        return -1;
+    uint32_t data = frame->data[4] | (frame->data[5] << 8) | (frame->data[6] << 16) | ((uint32_t)frame->data[7] << 24);
+    if (n->retries == 0) {
+        CO_SDOrtt_sample(&sdo_rtt, node_id, (uint32_t)(time_us() - n->sent_us));
+    }
+    if ((frame->data[0] & 0xE0) == 0x40) {  // 上传响应
+        n->valid[n->step] = 1;
+        scan_store(n, node_id, frame);
+    } else if (frame->data[0] == 0x80) {  // SDO中止
+        n->valid[n->step] = -1;
+    } else {
+        return;
     }
+    n->value[n->step] = data;
+    if (!n->responded) {
+        n->responded = 1;
+        n->response_us = (uint32_t)(time_us() - start_us);
+    }
+    scan_next(sock, nodes, node_id, timeout_ms);
+}
+
+/* 接收响应直到所有节点的请求完成或超时 */
+static void scan_run(int sock, scan_node_t *nodes, int max_nodes, uint64_t start_us, int timeout_ms) {
+    struct can_frame frame;
     
-    if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) < 0) {
+    while (running) {
+        uint64_t now_us = time_us();
+        uint64_t next_us = UINT64_MAX;
+        
+        for (int id = 1; id <= max_nodes; id++) {
+            scan_node_t *n = &nodes[id];
+            if (n->pending && n->deadline_us <= now_us) {
+                n->valid[n->step] = 0;  // 超时
+                CO_SDOrtt_timeout(&sdo_rtt, id);
+                scan_next(sock, nodes, id, timeout_ms);
+            }
+            if (n->pending) {
+                scan_retry(sock, nodes, id, now_us);
+            }
+            if (n->pending && n->deadline_us < next_us) {
+                next_us = n->deadline_us;
+            }
+            if (n->pending && n->retries < sdo_rtt.maxRetries && n->retry_us < next_us) {
+                next_us = n->retry_us;
+            }
+        }
+        if (next_us == UINT64_MAX) {
+            break;
+        }
+        
+        struct pollfd pfd = {.fd = sock, .events = POLLIN};
+        int wait_ms = (int)((next_us - now_us + 999) / 1000);
+        if (poll(&pfd, 1, wait_ms) > 0) {
+            while (recv(sock, &frame, sizeof(frame), MSG_DONTWAIT) == sizeof(frame)) {
+                scan_handle_frame(sock, nodes, max_nodes, &frame, start_us, timeout_ms);
+            }
+        }
+    }
+}
+
+/* 同时读取多个节点的详细信息, 不同节点的请求同时在总线上 */
+static void read_nodes_info(int sock, scan_node_t *nodes, int max_nodes, const uint8_t *node_ids, int count,
+                            int first_step) {
+    for (int i = 0; i < count; i++) {
+        nodes[node_ids[i]].step = first_step;
+        nodes[node_ids[i]].end = INFO_COUNT;
+        scan_send(sock, nodes, node_ids[i], DETAIL_TIMEOUT_MS);
+    }
+    scan_run(sock, nodes, max_nodes, time_us(), DETAIL_TIMEOUT_MS);
+}
+
+/* 打印一个对象的读取结果, 成功时返回1 */
+static int print_info_value(const scan_node_t *n, int step, const char *format) {
+    if (n->valid[step] > 0) {
+        printf(format, n->value[step]);
+        return 1;
+    }
+    if (n->valid[step] < 0) {
+        printf("SDO中止 0x%08X\n", n->value[step]);
+    } else {
         printf("无响应\n");
-        return -1;
     }
+    return 0;
+}
+
+/* 打印节点详细信息 */
+static void print_node_info(const scan_node_t *n, uint8_t node_id) {
+    uint32_t data;
+    
+    printf("=== 节点 %d 详细信息 ===\n", node_id);
     
-    printf("0x%08X\n", data);
-    printf("  设备类型: 0x%04X\n", data & 0xFFFF);
-    printf("  厂商特定: %s\n", (data & 0xFFFF) == 0x92 ? "标准CiA402" : "厂商特定");
+    printf("读取设备类型 (0x1000)... ");
+    if (!print_info_value(n, 0, "0x%08X\n")) {
+        return;
+    }
+    printf("  设备类型: 0x%04X\n", n->value[0] & 0xFFFF);
+    printf("  厂商特定: %s\n", (n->value[0] & 0xFFFF) == 0x92 ? "标准CiA402" : "厂商特定");
     
-    // 读取错误寄存器 (0x1001)
     printf("读取错误寄存器 (0x1001)... ");
-    if (send_sdo_request(sock, node_id, 0x1001, 0) >= 0) {
-        if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) >= 0) {
-            printf("0x%02X\n", data & 0xFF);
-            printf("  错误状态: %s\n", (data & 0xFF) == 0 ? "正常" : "有错误");
-        } else {
-            printf("无响应\n");
-        }
+    if (print_info_value(n, 1, "0x%02X\n")) {
+        printf("  错误状态: %s\n", (n->value[1] & 0xFF) == 0 ? "正常" : "有错误");
     }
     
-    // 读取厂商ID (0x1018:1)
     printf("读取厂商ID (0x1018:1)... ");
-    if (send_sdo_request(sock, node_id, 0x1018, 1) >= 0) {
-        if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) >= 0) {
-            printf("0x%08X\n", data);
-            printf("  厂商: ");
-            switch (data) {
-                case 0x5A65726F:  // ZEROERR CONTROL
-                    printf("ZeroErr Control");
-                    break;
-                case 0x00000001:
-                    printf("示例厂商");
-                    break;
-                default:
-                    printf("未知厂商");
-                    break;
-            }
-            printf("\n");
-        } else {
-            printf("无响应\n");
+    if (print_info_value(n, 2, "0x%08X\n")) {
+        printf("  厂商: ");
+        switch (n->value[2]) {
+            case 0x5A65726F:  // ZEROERR CONTROL
+                printf("ZeroErr Control");
+                break;
+            case 0x00000001:
+                printf("示例厂商");
+                break;
+            default:
+                printf("未知厂商");
+                break;
         }
+        printf("\n");
     }
     
-    // 读取产品代码 (0x1018:2)
     printf("读取产品代码 (0x1018:2)... ");
-    if (send_sdo_request(sock, node_id, 0x1018, 2) >= 0) {
-        if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) >= 0) {
-            printf("0x%08X\n", data);
-        } else {
-            printf("无响应\n");
-        }
-    }
-    
-    // 读取版本号 (0x1018:3)
+    print_info_value(n, 3, "0x%08X\n");
     printf("读取版本号 (0x1018:3)... ");
-    if (send_sdo_request(sock, node_id, 0x1018, 3) >= 0) {
-        if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) >= 0) {
-            printf("0x%08X\n", data);
-        } else {
-            printf("无响应\n");
-        }
-    }
-    
-    // 读取序列号 (0x1018:4)
+    print_info_value(n, 4, "0x%08X\n");
     printf("读取序列号 (0x1018:4)... ");
-    if (send_sdo_request(sock, node_id, 0x1018, 4) >= 0) {
-        if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) >= 0) {
-            printf("0x%08X\n", data);
-        } else {
-            printf("无响应\n");
-        }
-    }
+    print_info_value(n, 5, "0x%08X\n");
     
-    // 尝试读取CiA402相关对象
     printf("\n=== CiA402 电机控制对象 ===\n");
     
-    // 读取控制字 (0x6040)
     printf("读取控制字 (0x6040)... ");
-    if (send_sdo_request(sock, node_id, 0x6040, 0) >= 0) {
-        if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) >= 0) {
-            printf("0x%04X\n", data & 0xFFFF);
-        } else {
-            printf("无响应\n");
-        }
+    if (n->valid[6] > 0) {
+        printf("0x%04X\n", n->value[6] & 0xFFFF);
+    } else {
+        print_info_value(n, 6, "");
     }
     
-    // 读取状态字 (0x6041)
     printf("读取状态字 (0x6041)... ");
-    if (send_sdo_request(sock, node_id, 0x6041, 0) >= 0) {
-        if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) >= 0) {
-            printf("0x%04X\n", data & 0xFFFF);
-            printf("  状态: ");
-            uint16_t status = data & 0xFFFF;
-            if (status & 0x0001) printf("准备就绪 ");
-            if (status & 0x0002) printf("已切换 ");
-            if (status & 0x0004) printf("操作使能 ");
-            if (status & 0x0008) printf("故障 ");
-            if (status & 0x0010) printf("电压使能 ");
-            if (status & 0x0020) printf("快速停止 ");
-            if (status & 0x0040) printf("开关禁用 ");
-            if (status & 0x0080) printf("警告 ");
-            if (status & 0x0100) printf("制造商特定 ");
-            if (status & 0x0200) printf("远程 ");
-            if (status & 0x0400) printf("目标达到 ");
-            if (status & 0x0800) printf("内部限制 ");
-            printf("\n");
-        } else {
-            printf("无响应\n");
-        }
+    if (n->valid[7] > 0) {
+        uint16_t status = n->value[7] & 0xFFFF;
+        printf("0x%04X\n", status);
+        printf("  状态: ");
+        if (status & 0x0001) printf("准备就绪 ");
+        if (status & 0x0002) printf("已切换 ");
+        if (status & 0x0004) printf("操作使能 ");
+        if (status & 0x0008) printf("故障 ");
+        if (status & 0x0010) printf("电压使能 ");
+        if (status & 0x0020) printf("快速停止 ");
+        if (status & 0x0040) printf("开关禁用 ");
+        if (status & 0x0080) printf("警告 ");
+        if (status & 0x0100) printf("制造商特定 ");
+        if (status & 0x0200) printf("远程 ");
+        if (status & 0x0400) printf("目标达到 ");
+        if (status & 0x0800) printf("内部限制 ");
+        printf("\n");
+    } else {
+        print_info_value(n, 7, "");
     }
     
-    // 读取操作模式 (0x6060)
     printf("读取操作模式 (0x6060)... ");
-    if (send_sdo_request(sock, node_id, 0x6060, 0) >= 0) {
-        if (receive_sdo_response(sock, node_id, &data, DETAIL_TIMEOUT_MS) >= 0) {
-            printf("%d\n", data & 0xFF);
-            printf("  模式: ");
-            switch (data & 0xFF) {
-                case 0: printf("无模式"); break;
-                case 1: printf("位置模式"); break;
-                case 2: printf("速度模式"); break;
-                case 3: printf("速度轮廓模式"); break;
-                case 4: printf("扭矩模式"); break;
-                case 6: printf("回零模式"); break;
-                case 7: printf("插补位置模式"); break;
-                case 8: printf("循环同步位置模式"); break;
-                case 9: printf("循环同步速度模式"); break;
-                case 10: printf("循环同步扭矩模式"); break;
-                default: printf("未知模式"); break;
-            }
-            printf("\n");
-        } else {
-            printf("无响应\n");
+    if (n->valid[8] > 0) {
+        data = n->value[8];
+        printf("%d\n", data & 0xFF);
+        printf("  模式: ");
+        switch (data & 0xFF) {
+            case 0: printf("无模式"); break;
+            case 1: printf("位置模式"); break;
+            case 2: printf("速度模式"); break;
+            case 3: printf("速度轮廓模式"); break;
+            case 4: printf("扭矩模式"); break;
+            case 6: printf("回零模式"); break;
+            case 7: printf("插补位置模式"); break;
+            case 8: printf("循环同步位置模式"); break;
+            case 9: printf("循环同步速度模式"); break;
+            case 10: printf("循环同步扭矩模式"); break;
+            default: printf("未知模式"); break;
         }
+        printf("\n");
+    } else {
+        print_info_value(n, 8, "");
     }
     
     printf("\n=== 结论 ===\n");
     printf("节点 %d 是一个CANopen设备，", node_id);
-    if ((data & 0xFFFF) == 0x92 || (data & 0xFFFF) == 0x0192) {
+    if ((n->value[0] & 0xFFFF) == 0x92 || (n->value[0] & 0xFFFF) == 0x0192) {
         printf("很可能是电机驱动器！\n");
         printf("建议使用节点 %d 进行电机控制。\n", node_id);
     } else {
         printf("但不是标准的CiA402电机驱动器。\n");
     }
-    
+}
+
+/* 打印节点的SDO往返时间, 往返时间长, 波动大或重发多的节点可能有问题 */
+static void print_node_rtt(uint8_t node_id) {
+    const CO_SDOrtt_node_t *rtt = CO_SDOrtt_get(&sdo_rtt, node_id);
+    if (rtt == NULL || rtt->samples == 0) {
+        return;
+    }
+    printf("  节点 %d SDO往返: 平均 %.2fms, 波动 %.2fms, 最短 %.2fms, 最长 %.2fms, %u 次测量, 重发 %u, 超时 %u\n",
+           node_id, rtt->srtt_us / 1000.0, rtt->rttvar_us / 1000.0, rtt->rttMin_us / 1000.0, rtt->rttMax_us / 1000.0,
+           rtt->samples, rtt->retries, rtt->timeouts);
+}
+
+/* 读取节点详细信息 */
+int read_node_info(int sock, uint8_t node_id) {
+    static scan_node_t nodes[128];
+    
+    memset(nodes, 0, sizeof(nodes));
+    read_nodes_info(sock, nodes, 127, &node_id, 1, 0);
+    print_node_info(&nodes[node_id], node_id);
+    printf("\n%u 个SDO请求, %u 个对象从缓存读取 (%s)\n", sdo_requests, cache_hits, CACHE_FILE);
+    print_node_rtt(node_id);
+    return nodes[node_id].valid[0] > 0 ? 0 : -1;
+}
+
+/* NMT状态名称 */
+static const char *nmt_state_name(uint8_t state) {
+    switch (state) {
+        case 0x00: return "启动";
+        case 0x04: return "停止";
+        case 0x05: return "运行";
+        case 0x7F: return "预运行";
+        default: return "未知";
+    }
+}
+
+/* COB-ID对应的CANopen对象 (预定义连接集) */
+static const char *cob_name(uint16_t cob_id, char *buf, size_t size) {
+    static const char *names[16] = {NULL, "EMCY", NULL, "TPDO1", "RPDO1", "TPDO2", "RPDO2", "TPDO3", "RPDO3",
+                                    "TPDO4", "RPDO4", "SDO响应", "SDO请求", NULL, "心跳", NULL};
+    uint8_t node_id = cob_id & 0x7F;
+    const char *name = names[(cob_id >> 7) & 0x0F];
+
+    if (cob_id == 0x000) return "NMT";
+    if (cob_id == 0x080) return "SYNC";
+    if (cob_id == 0x100) return "TIME";
+    if (cob_id == 0x7E4 || cob_id == 0x7E5) return "LSS";
+    if (cob_id == CO_CAN_STATS_EXT) return "扩展帧";
+    if (name == NULL || node_id == 0) return "-";
+    snprintf(buf, size, "%s 节点%u", name, node_id);
+    return buf;
+}
+
+/* 0.01%单位的负载 */
+static double load_percent(uint16_t load) {
+    return load / 100.0;
+}
+
+/* 每秒打印一行: 各窗口的负载, 最忙的100ms, 报文速率和事件 */
+static void busload_print(const CO_CANstats_t *stats, uint32_t elapsed_s) {
+    uint64_t now = CO_CANtimestampNow();
+    CO_CANstatsLoad_t load_1s, load_10s, load_60s;
+
+    CO_CANstats_load(stats, 1000000, now, &load_1s);
+    CO_CANstats_load(stats, 10000000, now, &load_10s);
+    CO_CANstats_load(stats, 60000000, now, &load_60s);
+    printf("[%4us] 负载 1s: %6.2f%%  10s: %6.2f%%  60s: %6.2f%%  10s内最忙100ms: %6.2f%%  %u 帧/s",
+           elapsed_s, load_percent(load_1s.load), load_percent(load_10s.load), load_percent(load_60s.load),
+           load_percent(load_10s.peak),
+           load_1s.window_us > 0 ? (unsigned)((uint64_t)load_1s.frames * 1000000 / load_1s.window_us) : 0);
+    printf("  错误帧 %u  丢失 %u%s\n", CO_CANstats_getEvent(stats, CO_CAN_STATS_EV_ERROR_FRAME),
+           CO_CANstats_getEvent(stats, CO_CAN_STATS_EV_RX_OVERFLOW),
+           load_10s.peak > BUSLOAD_WARNING ? "  ⚠ 负载过高" : "");
+    fflush(stdout);
+}
+
+/* 结束时打印每个COB-ID的统计 */
+static void busload_report(const CO_CANstats_t *stats) {
+    uint64_t now = CO_CANtimestampNow();
+    uint64_t elapsed_us = now - atomic_load(&stats->start_us);
+    double elapsed_s = elapsed_us / 1000000.0;
+    uint64_t total_frames = 0, total_bits = 0;
+    CO_CANstatsLoad_t load_60s;
+    char buf[32];
+
+    if (elapsed_us == 0) {
+        return;
+    }
+    printf("\n%-6s %-14s %10s %9s %10s %10s %10s %10s %8s\n", "COB-ID", "对象", "帧数", "帧/s", "字节",
+           "平均间隔ms", "最小ms", "最大ms", "负载%");
+    for (uint16_t index = 0; index < CO_CAN_STATS_IDENTS; index++) {
+        CO_CANstatsIdent_t ident;
+        if (!CO_CANstats_get(stats, index, &ident) || ident.frames == 0) {
+            continue;
+        }
+        total_frames += ident.frames;
+        total_bits += ident.bits;
+        if (index == CO_CAN_STATS_EXT) {
+            printf("%-6s", "EXT");
+        } else {
+            printf("0x%03X ", index);
+        }
+        printf(" %-14s %10u %9.1f %10llu", cob_name(index, buf, sizeof(buf)), ident.frames, ident.frames / elapsed_s,
+               (unsigned long long)ident.bytes);
+        if (ident.frames > 1) {
+            printf(" %10.3f %10.3f %10.3f", elapsed_s * 1000.0 / ident.frames, ident.gapMin_us / 1000.0,
+                   ident.gapMax_us / 1000.0);
+        } else {
+            printf(" %10s %10s %10s", "-", "-", "-");
+        }
+        printf(" %8.2f\n", ident.bits * 100.0 / ((double)stats->bitrate * elapsed_s));
+    }
+
+    CO_CANstats_load(stats, 60000000, now, &load_60s);
+    printf("\n监听 %.1fs, %llu 帧, 平均负载 %.2f%%, 60s内最忙100ms %.2f%% (波特率 %u kbit/s)\n", elapsed_s,
+           (unsigned long long)total_frames, total_bits * 100.0 / ((double)stats->bitrate * elapsed_s),
+           load_percent(load_60s.peak), stats->bitrate / 1000);
+    printf("错误帧 %u, 接收丢失 %u\n", CO_CANstats_getEvent(stats, CO_CAN_STATS_EV_ERROR_FRAME),
+           CO_CANstats_getEvent(stats, CO_CAN_STATS_EV_RX_OVERFLOW));
+    if (load_60s.peak > BUSLOAD_WARNING) {
+        printf("⚠ 总线负载超过%d%%, 建议降低PDO频率, 增大SYNC周期或使用事件驱动的TPDO\n", BUSLOAD_WARNING / 100);
+    }
+}
+
+/* 总线负载模式: 独立的监听socket不设置过滤器, 接收总线上的所有报文, 包括本机其他程序发送的报文 */
+static int busload_run(const char *interface, uint32_t seconds, uint32_t bitrate_kbit) {
+    static CO_CANstats_t stats;
+    static CO_CANstatsMonitor_t monitor;
+    int ifindex = (int)if_nametoindex(interface);
+
+    if (ifindex == 0) {
+        perror("获取接口索引失败");
+        return 1;
+    }
+    if (CO_CANstats_init(&stats, bitrate_kbit * 1000, 0) != CO_ERROR_NO) {
+        printf("波特率错误\n");
+        return 1;
+    }
+    if (CO_CANstats_monitorOpen(&monitor, &stats, ifindex) != CO_ERROR_NO) {
+        perror("创建监听socket失败");
+        return 1;
+    }
+
+    printf("CAN总线负载分析\n");
+    printf("接口: %s, 波特率: %u kbit/s, ", interface, bitrate_kbit);
+    if (seconds > 0) {
+        printf("监听 %us\n", seconds);
+    } else {
+        printf("按Ctrl+C停止\n");
+    }
+    printf("负载包括填充位, 帧间隔和应答位, 按波特率计算\n\n");
+
+    struct pollfd pfd = {.fd = monitor.fd, .events = POLLIN};
+    uint64_t start = time_us();
+    uint64_t last_print = start;
+    while (running && (seconds == 0 || time_us() - start < (uint64_t)seconds * 1000000)) {
+        if (poll(&pfd, 1, 100) < 0 && errno != EINTR) {
+            perror("poll失败");
+            break;
+        }
+        if (CO_CANstats_monitorRead(&monitor) < 0) {
+            perror("接收失败");
+            break;
+        }
+        uint64_t now = time_us();
+        if (now - last_print >= 1000000) {
+            busload_print(&stats, (uint32_t)((now - start) / 1000000));
+            last_print = now;
+        }
+    }
+
+    (void)CO_CANstats_monitorRead(&monitor);
+    busload_report(&stats);
+    CO_CANstats_monitorClose(&monitor);
     return 0;
 }
 
+/* 并行扫描: 所有节点的0x1000请求连续发送, 在一个超时窗口内接收响应, 然后同时读取所有响应节点的详细信息 */
+int parallel_scan(int sock, int max_nodes) {
+    static scan_node_t nodes[128];
+    uint8_t responders[127];
+    int responder_count = 0;
+    int found_count = 0;
+    
+    memset(nodes, 0, sizeof(nodes));
+    uint64_t start_us = time_us();
+    for (int id = 1; id <= max_nodes; id++) {
+        nodes[id].step = 0;
+        nodes[id].end = 1;
+        if (scan_send(sock, nodes, id, QUICK_TIMEOUT_MS) < 0) {
+            printf("节点 %d 发送失败\n", id);
+        }
+    }
+    uint32_t sent_us = (uint32_t)(time_us() - start_us);
+    scan_run(sock, nodes, max_nodes, start_us, QUICK_TIMEOUT_MS);
+    uint32_t scan_us = (uint32_t)(time_us() - start_us);
+    
+    for (int id = 1; id <= max_nodes; id++) {
+        scan_node_t *n = &nodes[id];
+        if (!n->responded && !n->heartbeat) {
+            continue;
+        }
+        printf("节点 %d... ", id);
+        if (!n->responded) {
+            printf("无SDO响应, 心跳 (%s)\n", nmt_state_name(n->nmt_state));
+            continue;
+        }
+        responders[responder_count++] = id;
+        if (n->valid[0] < 0) {
+            printf("SDO中止 0x%08X", n->value[0]);
+        } else {
+            uint16_t device_type = n->value[0] & 0xFFFF;
+            if (device_type == 0x92 || device_type == 0x0192) {
+                printf("✓ 电机设备! (0x%08X)", n->value[0]);
+                found_count++;
+            } else {
+                printf("非电机 (0x%04X)", device_type);
+            }
+        }
+        printf(", 响应 %.1fms", n->response_us / 1000.0);
+        if (n->heartbeat) {
+            printf(", 心跳 (%s)", nmt_state_name(n->nmt_state));
+        }
+        printf("\n");
+    }
+    
+    printf("\n扫描完成! 发送 %d 个请求用时 %.1fms, 扫描用时 %.1fms\n", max_nodes, sent_us / 1000.0,
+           scan_us / 1000.0);
+    printf("%d 个节点响应, 找到 %d 个电机设备\n", responder_count, found_count);
+    
+    if (responder_count > 0 && running) {
+        printf("\n同时读取 %d 个节点的详细信息...\n", responder_count);
+        uint64_t info_start_us = time_us();
+        read_nodes_info(sock, nodes, max_nodes, responders, responder_count, 1);
+        uint32_t info_us = (uint32_t)(time_us() - info_start_us);
+        for (int i = 0; i < responder_count; i++) {
+            printf("\n");
+            print_node_info(&nodes[responders[i]], responders[i]);
+        }
+        printf("\n详细信息读取用时 %.1fms, %u 个SDO请求, %u 个对象从缓存读取 (%s)\n", info_us / 1000.0,
+               sdo_requests, cache_hits, CACHE_FILE);
+        for (int i = 0; i < responder_count; i++) {
+            print_node_rtt(responders[i]);
+        }
+    }
+    
+    return found_count;
+}
+
 int main(int argc, char *argv[]) {
     int sock;
     struct sockaddr_can addr;
@@ -279,8 +775,10 @@ int main(int argc, char *argv[]) {
     const char *interface = "can0";
     int found_count = 0;
     int max_nodes = MAX_SCAN_NODES;
-    int mode = 0; // 0=扫描模式, 1=详细读取模式
+    int mode = 0; // 0=扫描模式, 1=详细读取模式, 2=并行扫描模式, 3=总线负载模式
     uint8_t target_node = 2;
+    uint32_t busload_seconds = 0;
+    uint32_t busload_kbit = BUSLOAD_BITRATE_KBIT;
     
     // 解析命令行参数
     if (argc > 1) {
@@ -289,18 +787,40 @@ int main(int argc, char *argv[]) {
             if (argc > 2) {
                 target_node = atoi(argv[2]);
             }
+        } else if (strcmp(argv[1], "parallel") == 0 || strcmp(argv[1], "all") == 0) {
+            mode = 2; // 并行扫描模式, 默认扫描全部节点
+            max_nodes = 127;
+            if (argc > 3) {
+                interface = argv[3];
+            }
+        } else if (strcmp(argv[1], "busload") == 0) {
+            mode = 3; // 总线负载模式, 默认监听到Ctrl+C
+            if (argc > 2) {
+                busload_seconds = (uint32_t)atoi(argv[2]);
+            }
+            if (argc > 3) {
+                interface = argv[3];
+            }
+            if (argc > 4 && atoi(argv[4]) > 0) {
+                busload_kbit = (uint32_t)atoi(argv[4]);
+            }
         } else {
             interface = argv[1];
         }
     }
-    if (argc > 2 && mode == 0) {
+    if (argc > 2 && mode != 1 && mode != 3) {
         max_nodes = atoi(argv[2]);
         if (max_nodes > 127) max_nodes = 127;
+        if (max_nodes < 1) max_nodes = 1;
     }
     
     // 设置信号处理
     signal(SIGINT, signal_handler);
+    CO_SDOrtt_init(&sdo_rtt, RTT_MIN_TIMEOUT_MS, DETAIL_TIMEOUT_MS, RTT_RETRIES);
     
+    if (mode == 3) {
+        return busload_run(interface, busload_seconds, busload_kbit);
+    }
     if (mode == 1) {
         printf("CANopen设备详细信息读取工具\n");
         printf("接口: %s\n", interface);
@@ -314,6 +834,8 @@ int main(int argc, char *argv[]) {
         printf("使用方法:\n");
         printf("  %s                    # 快速扫描模式\n", argv[0]);
         printf("  %s read [节点ID]      # 详细读取模式\n", argv[0]);
+        printf("  %s parallel [节点数]  # 并行扫描模式, 约一个超时窗口\n", argv[0]);
+        printf("  %s busload [秒数] [接口] [波特率kbit/s]  # 总线负载和每个COB-ID的流量\n", argv[0]);
         printf("  %s can0 50            # 扫描can0接口，节点1-50\n\n", argv[0]);
     }
     
@@ -324,6 +846,16 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
+    // 只接收SDO服务器响应(0x581-0x5FF)，并行扫描时还接收启动和心跳报文(0x701-0x77F)，总线上的PDO等报文由内核过滤
+    struct can_filter filters[2] = {
+        {.can_id = 0x580, .can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | 0x780},
+        {.can_id = 0x700, .can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | 0x780}
+    };
+    socklen_t filters_size = (mode == 2 ? 2 : 1) * sizeof(filters[0]);
+    if (setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FILTER, filters, filters_size) < 0) {
+        perror("设置CAN过滤器失败");
+    }
+    
     // 设置CAN接口
     strcpy(ifr.ifr_name, interface);
     if (ioctl(sock, SIOCGIFINDEX, &ifr) < 0) {
@@ -343,7 +875,15 @@ int main(int argc, char *argv[]) {
     
     if (mode == 1) {
         // 详细读取模式
+        cache_load();
         read_node_info(sock, target_node);
+        cache_save();
+    } else if (mode == 2) {
+        // 并行扫描模式
+        printf("开始并行扫描...\n");
+        cache_load();
+        parallel_scan(sock, max_nodes);
+        cache_save();
     } else {
         // 快速扫描模式
         printf("开始快速扫描...\n");
@@ -0,0 +1,218 @@
+/*
+ * author: ZeroErr Inc.
+ * SDO bulk transfer tool: download a file into an object of the drive or upload an object into a file
+ *
+ * Features:
+ * - SDO block transfer with CRC (CiA 301), up to 127 segments per block, through CO_SDObulk (extra/CO_SDObulk.h)
+ * - Data are streamed from and to the file, file size is not limited by memory
+ * - Automatic fallback to segmented transfer, if the drive refuses block transfer
+ * - Transfer time and throughput are printed, for comparison of block and segmented transfer
+ *
+ * Typical use: parameter images and firmware (program data 0x1F50:1).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <net/if.h>
+#include <sys/stat.h>
+
+#define OD_DEFINITION
+#include "301/CO_driver.h"
+#include "extra/CO_SDObulk.h"
+
+#define SDO_TIMEOUT_MS 1000
+#define PROGRESS_INTERVAL_MS 500
+
+static volatile sig_atomic_t running = 1;
+
+// CAN module with one receive and one transmit buffer for the SDO client
+static CO_CANptrSocketCan_t can_ptr;
+static CO_CANmodule_t can_module;
+static CO_CANrx_t can_rx[1];
+static CO_CANtx_t can_tx[1];
+static CO_SDOclient_t sdo_client;
+static CO_SDObulk_t bulk;
+
+// Initial SDO client parameters (OD object 0x1280), client is configured with CO_SDOclient_setup()
+static uint8_t sdo_max_subindex = 3;
+static uint32_t sdo_cob_id_disabled = 0x80000000UL;
+static uint8_t sdo_node_id_none = 0;
+static OD_obj_record_t sdo_param_record[4] = {
+    {.dataOrig = &sdo_max_subindex, .subIndex = 0, .attribute = ODA_SDO_R, .dataLength = 1},
+    {.dataOrig = &sdo_cob_id_disabled, .subIndex = 1, .attribute = ODA_SDO_R | ODA_MB, .dataLength = 4},
+    {.dataOrig = &sdo_cob_id_disabled, .subIndex = 2, .attribute = ODA_SDO_R | ODA_MB, .dataLength = 4},
+    {.dataOrig = &sdo_node_id_none, .subIndex = 3, .attribute = ODA_SDO_R, .dataLength = 1}};
+static OD_entry_t sdo_param_entry = {
+    .index = OD_H1280_SDO_CLIENT_1_PARAM, .subEntriesCount = 4, .odObjectType = ODT_REC,
+    .odObject = sdo_param_record, .extension = NULL};
+
+static void signal_handler(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static uint64_t time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+// Download source: read from file
+static size_t file_source(void *object, uint8_t *buf, size_t count) {
+    return fread(buf, 1, count, (FILE *)object);
+}
+
+// Upload sink: write to file
+static bool_t file_sink(void *object, const uint8_t *buf, size_t count) {
+    return fwrite(buf, 1, count, (FILE *)object) == count;
+}
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options] <CAN interface> <node ID> download|upload <index> <subindex> <file>\n\n", prog);
+    printf("Options:\n");
+    printf("  -b <blksize>   Maximum number of segments per block at block upload, 1..127, default 127\n");
+    printf("                 (at block download the drive selects the block size)\n");
+    printf("  -s             Segmented transfer only, don't try block transfer\n");
+    printf("  -t <ms>        SDO timeout, default %d ms\n\n", SDO_TIMEOUT_MS);
+    printf("Example: %s can0 2 download 0x1F50 1 firmware.bin\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    int blksize = 127;
+    int block_enable = 1;
+    int timeout_ms = SDO_TIMEOUT_MS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:st:h")) != -1) {
+        switch (opt) {
+            case 'b': blksize = atoi(optarg); break;
+            case 's': block_enable = 0; break;
+            case 't': timeout_ms = atoi(optarg); break;
+            default: print_usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (argc - optind != 6 || blksize < 1 || blksize > 127 || timeout_ms < 1 || timeout_ms > 65535) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    const char *interface = argv[optind];
+    int node_id = (int)strtol(argv[optind + 1], NULL, 0);
+    int upload = strcmp(argv[optind + 2], "upload") == 0;
+    uint16_t index = (uint16_t)strtoul(argv[optind + 3], NULL, 0);
+    uint8_t subindex = (uint8_t)strtoul(argv[optind + 4], NULL, 0);
+    const char *file_name = argv[optind + 5];
+    if (node_id < 1 || node_id > 127 || (!upload && strcmp(argv[optind + 2], "download") != 0)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    FILE *file = fopen(file_name, upload ? "wb" : "rb");
+    if (file == NULL) {
+        perror(file_name);
+        return 1;
+    }
+    size_t file_size = 0;
+    struct stat st;
+    if (!upload && fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode)) {
+        file_size = (size_t)st.st_size;
+    }
+
+    can_ptr.can_ifindex = (int)if_nametoindex(interface);
+    if (can_ptr.can_ifindex == 0) {
+        perror("Get interface index failed");
+        fclose(file);
+        return 1;
+    }
+    uint32_t err_info = 0;
+    if (CO_CANmodule_init(&can_module, &can_ptr, can_rx, 1, can_tx, 1, 1000) != CO_ERROR_NO
+        || CO_SDOclient_init(&sdo_client, NULL, &sdo_param_entry, 0, &can_module, 0, &can_module, 0, &err_info)
+               != CO_ERROR_NO
+        || CO_SDOclient_setup(&sdo_client, CO_CAN_ID_SDO_CLI + node_id, CO_CAN_ID_SDO_SRV + node_id, node_id)
+               != CO_SDO_RT_ok_communicationEnd) {
+        printf("CAN or SDO client initialization failed\n");
+        fclose(file);
+        return 1;
+    }
+    CO_SDOclient_setBlockSize(&sdo_client, (uint8_t)blksize);
+    CO_CANsetNormalMode(&can_module);
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    CO_SDO_return_t ret;
+    if (upload) {
+        printf("Upload node %d 0x%04X:%d -> %s\n", node_id, index, subindex, file_name);
+        ret = CO_SDObulk_upload(&bulk, &sdo_client, index, subindex, (uint16_t)timeout_ms, block_enable, file_sink,
+                                file);
+    } else {
+        printf("Download %s (%zu bytes) -> node %d 0x%04X:%d\n", file_name, file_size, node_id, index, subindex);
+        ret = CO_SDObulk_download(&bulk, &sdo_client, index, subindex, file_size, (uint16_t)timeout_ms, block_enable,
+                                  file_source, file);
+    }
+
+    if (ret != CO_SDO_RT_ok_communicationEnd) {
+        printf("SDO transfer initiate failed\n");
+        fclose(file);
+        CO_CANmodule_disable(&can_module);
+        return 1;
+    }
+
+    uint64_t start_us = time_us();
+    uint64_t last_us = start_us;
+    uint64_t progress_us = start_us;
+    for (;;) {
+        uint32_t timer_next_us = 10000;
+        uint64_t now_us = time_us();
+
+        // segments of one block leave with a single sendmmsg()
+        CO_CANtxDeferBegin();
+        ret = CO_SDObulk_process(&bulk, (uint32_t)(now_us - last_us), !running, &timer_next_us);
+        CO_CANtxDeferEnd();
+        last_us = now_us;
+        CO_CANtxFlush(&can_module);
+        if (ret <= CO_SDO_RT_ok_communicationEnd) {
+            break;
+        }
+
+        if (now_us - progress_us >= PROGRESS_INTERVAL_MS * 1000ULL) {
+            printf("  %zu bytes, %.1f kB/s\r", bulk.sizeTransferred,
+                   bulk.sizeTransferred / 1000.0 / ((now_us - start_us) / 1e6));
+            fflush(stdout);
+            progress_us = now_us;
+        }
+
+        // block download: next segment as soon as the previous one is passed to the kernel, otherwise wait for the
+        // response or the next SDO timeout
+        struct pollfd pfd = {.fd = can_module.fd, .events = POLLIN};
+        if (ret == CO_SDO_RT_blockDownldInProgress && !sdo_client.CANtxBuff->bufferFull) {
+            timer_next_us = 0;
+        } else if (sdo_client.CANtxBuff->bufferFull) {
+            pfd.events |= POLLOUT;  // kernel transmit queue is full
+            timer_next_us = 1000;
+        }
+        struct timespec timeout = {.tv_sec = timer_next_us / 1000000, .tv_nsec = (long)(timer_next_us % 1000000) * 1000};
+        if (ppoll(&pfd, 1, &timeout, NULL) > 0 && (pfd.revents & POLLIN)) {
+            CO_CANinterrupt(&can_module);
+        }
+    }
+
+    double elapsed_s = (time_us() - start_us) / 1e6;
+    fclose(file);
+    CO_CANmodule_disable(&can_module);
+
+    const char *mode = bulk.block ? (sdo_client.block_crcEnabled ? "block, CRC" : "block") : "segmented";
+    if (ret < 0) {
+        printf("Transfer failed after %zu bytes: SDO abort 0x%08X\n", bulk.sizeTransferred, (uint32_t)bulk.abortCode);
+        return 1;
+    }
+    printf("%zu bytes in %.3f s, %.1f kB/s (%s transfer%s)\n", bulk.sizeTransferred, elapsed_s,
+           elapsed_s > 0 ? bulk.sizeTransferred / 1000.0 / elapsed_s : 0.0, mode,
+           bulk.fallback ? ", drive refused block transfer" : "");
+    return 0;
+}
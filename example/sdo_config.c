@@ -0,0 +1,299 @@
+/*
+ * author: ZeroErr Inc.
+ * SDO configuration tool: write a parameter list to many nodes at the same time, from one thread
+ *
+ * Features:
+ * - One configuration task per node (CO_SDOasync task, extra/CO_SDOasync.h), all tasks run in the same poll() loop
+ * - Each task reads device type (0x1000) and vendor-ID (0x1018:1), writes the parameters one after another and
+ *   optionally reads them back for verification
+ * - Tasks of different nodes run in parallel on the SDO channels of CO_SDOengine, nothing blocks while waiting
+ * - Nodes, which don't respond, or parameters, which are refused, are reported per node
+ *
+ * Example: configure profile position mode on nodes 1..32
+ *   sdo_config -v can0 1-32 0x6060:0=1/1 0x6081:0=100000 0x6083:0=50000 0x6084:0=50000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <net/if.h>
+
+#include "301/CO_driver.h"
+#include "extra/CO_SDOasync.h"
+#include "extra/CO_SDOrtt.h"
+
+#define SDO_TIMEOUT_MS 500
+#define SDO_CHANNELS_DEFAULT 16
+#define RTT_MIN_TIMEOUT_MS 10
+#define RTT_RETRIES 2
+#define PARAMS_MAX 32
+
+static volatile sig_atomic_t running = 1;
+
+// One parameter of the list
+typedef struct {
+    uint16_t index;
+    uint8_t subindex;
+    uint8_t size;
+    uint32_t value;
+} param_t;
+
+// Configuration of one node, state of its task must survive CO_SDOASYNC_AWAIT(), so it is kept here
+typedef struct {
+    CO_SDOasync_task_t task;
+    uint8_t node_id;
+    CO_SDOasync_op_t *device_type;
+    CO_SDOasync_op_t *vendor_id;
+    CO_SDOasync_op_t *op;
+    uint16_t param;     // Current parameter
+    uint16_t written;   // Successfully written parameters
+    uint16_t verified;  // Parameters with equal read back value
+    int responding;
+} node_cfg_t;
+
+static param_t params[PARAMS_MAX];
+static uint16_t param_count = 0;
+static int verify = 0;
+
+static CO_CANptrSocketCan_t can_ptr;
+static CO_CANmodule_t can_module;
+static CO_CANrx_t can_rx[CO_SDO_ENGINE_CHANNELS];
+static CO_CANtx_t can_tx[CO_SDO_ENGINE_CHANNELS];
+static CO_SDOclient_t sdo_clients[CO_SDO_ENGINE_CHANNELS];
+static CO_SDOengine_t sdo_engine;
+static CO_SDOasync_t sdo_async;
+static CO_SDOrtt_t sdo_rtt;
+static node_cfg_t nodes[127];
+
+static void signal_handler(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static uint64_t time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+// Print failed operation of the node
+static void print_failed(const node_cfg_t *cfg, const char *what, const CO_SDOasync_op_t *op) {
+    if (op == NULL) {
+        printf("node %3d: 0x%04X:%02X %s not started\n", cfg->node_id, params[cfg->param].index,
+               params[cfg->param].subindex, what);
+        return;
+    }
+    printf("node %3d: 0x%04X:%02X %s failed, SDO abort 0x%08X\n", cfg->node_id, op->xfer.index, op->xfer.subIndex,
+           what, (uint32_t)op->xfer.abortCode);
+}
+
+// Configuration task of one node, resumed by CO_SDOasync each time its SDO operations are finished
+static void node_task(CO_SDOasync_task_t *task) {
+    node_cfg_t *cfg = (node_cfg_t *)task->object;
+
+    CO_SDOASYNC_BEGIN(task);
+
+    // identity, both reads are queued at once
+    cfg->device_type = CO_SDOasync_taskRead(task, cfg->node_id, 0x1000, 0);
+    cfg->vendor_id = CO_SDOasync_taskRead(task, cfg->node_id, 0x1018, 1);
+    CO_SDOASYNC_AWAIT(task);
+    cfg->responding = CO_SDOasync_isOk(cfg->device_type);
+    if (cfg->responding) {
+        printf("node %3d: device type 0x%08X, vendor-ID 0x%08X\n", cfg->node_id,
+               CO_SDOasync_getValue(cfg->device_type), CO_SDOasync_getValue(cfg->vendor_id));
+    }
+
+    // parameters, SDO server processes one request at a time anyway, so write them one after another
+    for (cfg->param = 0; cfg->responding && cfg->param < param_count; cfg->param++) {
+        cfg->op = CO_SDOasync_taskWriteValue(task, cfg->node_id, params[cfg->param].index,
+                                             params[cfg->param].subindex, params[cfg->param].value,
+                                             params[cfg->param].size);
+        CO_SDOASYNC_AWAIT(task);
+        if (CO_SDOasync_isOk(cfg->op)) {
+            cfg->written++;
+        } else {
+            print_failed(cfg, "write", cfg->op);
+        }
+    }
+
+    // read back
+    for (cfg->param = 0; cfg->responding && verify && cfg->param < param_count; cfg->param++) {
+        cfg->op = CO_SDOasync_taskRead(task, cfg->node_id, params[cfg->param].index, params[cfg->param].subindex);
+        CO_SDOASYNC_AWAIT(task);
+        uint32_t mask = params[cfg->param].size >= 4 ? 0xFFFFFFFFU : (1U << (8 * params[cfg->param].size)) - 1;
+        if (!CO_SDOasync_isOk(cfg->op)) {
+            print_failed(cfg, "read back", cfg->op);
+        } else if ((CO_SDOasync_getValue(cfg->op) & mask) != (params[cfg->param].value & mask)) {
+            printf("node %3d: 0x%04X:%02X is 0x%X, written 0x%X\n", cfg->node_id, params[cfg->param].index,
+                   params[cfg->param].subindex, CO_SDOasync_getValue(cfg->op), params[cfg->param].value);
+        } else {
+            cfg->verified++;
+        }
+    }
+
+    CO_SDOASYNC_END(task);
+}
+
+// Task of the node is finished
+static void node_done(CO_SDOasync_task_t *task) {
+    const node_cfg_t *cfg = (const node_cfg_t *)task->object;
+
+    if (!cfg->responding) {
+        return;
+    }
+    if (verify) {
+        printf("node %3d: %d/%d written, %d verified\n", cfg->node_id, cfg->written, param_count, cfg->verified);
+    } else {
+        printf("node %3d: %d/%d written\n", cfg->node_id, cfg->written, param_count);
+    }
+}
+
+// Parse "index:subindex=value[/size]", size is 1, 2 or 4 bytes, default 4
+static int parse_param(const char *arg, param_t *param) {
+    char *end;
+    param->index = (uint16_t)strtoul(arg, &end, 0);
+    if (*end != ':') {
+        return -1;
+    }
+    param->subindex = (uint8_t)strtoul(end + 1, &end, 0);
+    if (*end != '=') {
+        return -1;
+    }
+    param->value = (uint32_t)strtoul(end + 1, &end, 0);
+    param->size = 4;
+    if (*end == '/') {
+        param->size = (uint8_t)strtoul(end + 1, &end, 0);
+    }
+    return (*end == '\0' && (param->size == 1 || param->size == 2 || param->size == 4)) ? 0 : -1;
+}
+
+// Parse node list like "1-32" or "2,5,77", set node_id of selected nodes
+static int parse_nodes(const char *arg) {
+    int count = 0;
+    while (*arg != '\0') {
+        char *end;
+        long first = strtol(arg, &end, 0);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 0);
+        }
+        if (first < 1 || last > 127 || first > last || (*end != ',' && *end != '\0')) {
+            return -1;
+        }
+        for (long id = first; id <= last; id++) {
+            count += nodes[id - 1].node_id == 0 ? 1 : 0;
+            nodes[id - 1].node_id = (uint8_t)id;
+        }
+        arg = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options] <CAN interface> <nodes> <index:subindex=value[/size]> ...\n\n", prog);
+    printf("Options:\n");
+    printf("  -c <channels>  Parallel SDO transfers, 1..%d, default %d\n", CO_SDO_ENGINE_CHANNELS,
+           SDO_CHANNELS_DEFAULT);
+    printf("  -t <ms>        SDO timeout, default %d ms\n", SDO_TIMEOUT_MS);
+    printf("  -v             Read back and verify written parameters\n\n");
+    printf("Nodes: list of node IDs and ranges, for example 1-32 or 2,5,77. Size of value: 1, 2 or 4 bytes.\n");
+    printf("Example: %s -v can0 1-32 0x6060:0=1/1 0x6081:0=100000\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    int channels = SDO_CHANNELS_DEFAULT;
+    int timeout_ms = SDO_TIMEOUT_MS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:t:vh")) != -1) {
+        switch (opt) {
+            case 'c': channels = atoi(optarg); break;
+            case 't': timeout_ms = atoi(optarg); break;
+            case 'v': verify = 1; break;
+            default: print_usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (argc - optind < 2 || argc - optind - 2 > PARAMS_MAX || channels < 1 || channels > CO_SDO_ENGINE_CHANNELS
+        || timeout_ms < 1 || timeout_ms > 65535) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    const char *interface = argv[optind];
+    int node_count = parse_nodes(argv[optind + 1]);
+    if (node_count <= 0) {
+        printf("Invalid node list: %s\n", argv[optind + 1]);
+        return 1;
+    }
+    for (int i = optind + 2; i < argc; i++) {
+        if (parse_param(argv[i], &params[param_count]) < 0) {
+            printf("Invalid parameter: %s\n", argv[i]);
+            return 1;
+        }
+        param_count++;
+    }
+
+    can_ptr.can_ifindex = (int)if_nametoindex(interface);
+    if (can_ptr.can_ifindex == 0) {
+        perror("Get interface index failed");
+        return 1;
+    }
+    if (CO_CANmodule_init(&can_module, &can_ptr, can_rx, (uint16_t)channels, can_tx, (uint16_t)channels, 1000)
+            != CO_ERROR_NO
+        || CO_SDOengine_init(&sdo_engine, sdo_clients, (uint8_t)channels, &can_module, 0, &can_module, 0,
+                             (uint16_t)timeout_ms)
+               != CO_ERROR_NO
+        || CO_SDOasync_init(&sdo_async, &sdo_engine) != CO_ERROR_NO) {
+        printf("CAN or SDO engine initialization failed\n");
+        return 1;
+    }
+    CO_SDOrtt_init(&sdo_rtt, RTT_MIN_TIMEOUT_MS, (uint16_t)timeout_ms, RTT_RETRIES);
+    for (int i = 0; i < channels; i++) {
+        CO_SDOclient_setRtt(&sdo_clients[i], &sdo_rtt);
+    }
+    CO_CANsetNormalMode(&can_module);
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    printf("Configure %d nodes, %d parameters, %d SDO channels\n", node_count, param_count, channels);
+    uint64_t start_us = time_us();
+    for (int i = 0; i < 127; i++) {
+        if (nodes[i].node_id != 0) {
+            CO_SDOasync_taskStart(&sdo_async, &nodes[i].task, node_task, node_done, &nodes[i]);
+        }
+    }
+
+    // event loop: engine resumes the tasks, when their SDO transfers are finished
+    uint64_t last_us = start_us;
+    while (running && sdo_async.tasks > 0) {
+        uint32_t timer_next_us = 100000;
+        uint64_t now_us = time_us();
+
+        CO_CANtxDeferBegin();
+        CO_SDOengine_process(&sdo_engine, (uint32_t)(now_us - last_us), &timer_next_us);
+        CO_CANtxDeferEnd();
+        last_us = now_us;
+        CO_CANtxFlush(&can_module);
+
+        struct pollfd pfd = {.fd = can_module.fd, .events = POLLIN};
+        struct timespec timeout = {.tv_sec = timer_next_us / 1000000, .tv_nsec = (long)(timer_next_us % 1000000) * 1000};
+        if (ppoll(&pfd, 1, &timeout, NULL) > 0) {
+            CO_CANinterrupt(&can_module);
+        }
+    }
+
+    double elapsed_s = (time_us() - start_us) / 1e6;
+    int responding = 0;
+    for (int i = 0; i < 127; i++) {
+        responding += nodes[i].responding;
+    }
+    printf("%d of %d nodes responding, %u SDO transfers (%u failed) in %.3f s, at most %d outstanding\n", responding,
+           node_count, sdo_async.finishedCount, sdo_async.failedCount, elapsed_s, sdo_async.usedMax);
+    CO_CANmodule_disable(&can_module);
+    return running ? 0 : 1;
+}
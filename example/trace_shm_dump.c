@@ -0,0 +1,107 @@
+/*
+ * Live trace recorder, reads CO_traceShm shared memory ring and prints CSV.
+ *
+ * Producer is a CANopenNode program with CO_traceMulti, which publishes each sample with CO_traceShm_sample(). This
+ * program attaches to the same shared memory and prints one line per sample: sequence number, timestamp in
+ * microseconds and channel values. Output may be piped to a plotter or a file. Dropped samples (ring was full,
+ * because reader was too slow) are reported on stderr, producer is never blocked.
+ *
+ * Usage: trace_shm_dump [-n <name>] [-c <count>]
+ *
+ * @file        trace_shm_dump.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "CO_traceShm.h"
+
+/* Poll interval, when ring is empty */
+#define POLL_INTERVAL_NS 1000000
+
+static volatile sig_atomic_t end_program = 0;
+
+static void
+sig_handler(int sig) {
+    (void)sig;
+    end_program = 1;
+}
+
+int
+main(int argc, char* argv[]) {
+    const char* name = "/canopen_trace";
+    unsigned long count = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:c:h")) != -1) {
+        switch (opt) {
+            case 'n': name = optarg; break;
+            case 'c': count = strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "Usage: %s [-n <shm name, default /canopen_trace>] [-c <samples, default all>]\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    CO_traceShm_t shm;
+    if (CO_traceShm_attach(&shm, name) != CO_ERROR_NO) {
+        fprintf(stderr, "Can't attach to trace shared memory %s\n", name);
+        return EXIT_FAILURE;
+    }
+    signal(SIGINT, sig_handler);
+    signal(SIGTERM, sig_handler);
+
+    const CO_traceShm_header_t* h = shm.header;
+    int32_t record[CO_TRACE_MULTI_CHANNELS + 1];
+    uint32_t sequence, sequenceNext = 0;
+    bool_t first = true;
+    unsigned long n = 0;
+
+    /* CSV header: channel mapping as index:subindex */
+    printf("seq,time_us");
+    for (uint16_t i = 1; i < h->recordWords; i++) {
+        uint32_t map = h->channelMap[i - 1U];
+        printf(",%04X:%02X", (unsigned)(map >> 16), (unsigned)((map >> 8) & 0xFFU));
+    }
+    printf("\n");
+
+    while (!end_program && ((count == 0U) || (n < count))) {
+        if (!CO_traceShm_read(&shm, &sequence, record)) {
+            struct timespec ts = {0, POLL_INTERVAL_NS};
+            fflush(stdout);
+            nanosleep(&ts, NULL);
+            continue;
+        }
+        if (!first && (sequence != sequenceNext)) {
+            fprintf(stderr, "# %u samples dropped before %u\n", (unsigned)(sequence - sequenceNext),
+                    (unsigned)sequence);
+        }
+        first = false;
+        sequenceNext = sequence + 1U;
+
+        printf("%u,%u", (unsigned)sequence, (unsigned)record[0]);
+        for (uint16_t i = 1; i < h->recordWords; i++) {
+            printf(",%d", (int)record[i]);
+        }
+        printf("\n");
+        n++;
+    }
+
+    fprintf(stderr, "# %lu samples, %u dropped by producer\n", n, (unsigned)atomic_load(&shm.header->dropped));
+    CO_traceShm_close(&shm);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,328 @@
+/*
+ * Offline trajectory planner with double-buffered setpoint player.
+ *
+ * @file        trajectory.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trajectory.h"
+
+/* Number of bisection steps for the reduced velocity of short moves */
+#define TRAJ_BISECTION_STEPS 100
+
+/* Acceleration phase for velocity v: constant jerk tj, constant acceleration ta, reached acceleration a. */
+static void
+traj_accelPhase(double v, double aMax, double jerk, double* a, double* tj, double* ta) {
+    if (v * jerk >= aMax * aMax) {
+        *a = aMax;
+        *tj = aMax / jerk;
+        *ta = v / aMax - *tj;
+    } else {
+        /* Acceleration limit is not reached */
+        *tj = sqrt(v / jerk);
+        *a = jerk * *tj;
+        *ta = 0.0;
+    }
+}
+
+bool
+traj_profile(const trajParams_t* params, double distance, trajProfile_t* profile) {
+    double v = params->velocity;
+    double a, tj, ta;
+
+    if (params->velocity <= 0.0 || params->acceleration <= 0.0 || params->jerk <= 0.0 || params->period_us == 0U) {
+        return false;
+    }
+
+    memset(profile, 0, sizeof(*profile));
+    profile->distance = fabs(distance);
+    profile->jerk = params->jerk;
+    if (profile->distance == 0.0) {
+        return true;
+    }
+
+    traj_accelPhase(v, params->acceleration, params->jerk, &a, &tj, &ta);
+    if (v * (2.0 * tj + ta) <= profile->distance) {
+        profile->tv = (profile->distance - v * (2.0 * tj + ta)) / v;
+    } else {
+        /* Move is too short to reach the velocity limit. Distance of acceleration and deceleration, v * (2tj + ta),
+         * increases with v, so reached velocity is found by bisection. */
+        double vLow = 0.0;
+        double vHigh = v;
+        int i;
+
+        for (i = 0; i < TRAJ_BISECTION_STEPS; i++) {
+            v = (vLow + vHigh) / 2.0;
+            traj_accelPhase(v, params->acceleration, params->jerk, &a, &tj, &ta);
+            if (v * (2.0 * tj + ta) > profile->distance) {
+                vHigh = v;
+            } else {
+                vLow = v;
+            }
+        }
+        v = vLow;
+        traj_accelPhase(v, params->acceleration, params->jerk, &a, &tj, &ta);
+        profile->tv = (profile->distance - v * (2.0 * tj + ta)) / v;
+    }
+
+    profile->velocity = v;
+    profile->acceleration = a;
+    profile->tj = tj;
+    profile->ta = ta;
+    profile->duration = 2.0 * (2.0 * tj + ta) + profile->tv;
+    return true;
+}
+
+/* Distance of the first part of the acceleration phase, t = 0..tj+ta */
+static double
+traj_accelStart(const trajProfile_t* p, double t) {
+    double u;
+
+    if (t <= p->tj) {
+        return p->jerk * t * t * t / 6.0;
+    }
+    u = t - p->tj;
+    return p->jerk * p->tj * p->tj * p->tj / 6.0 + p->jerk * p->tj * p->tj / 2.0 * u + p->acceleration * u * u / 2.0;
+}
+
+/* Distance of the acceleration phase, t = 0..2tj+ta. Velocity is symmetric: v(tAcc - t) = velocity - v(t). */
+static double
+traj_accelPosition(const trajProfile_t* p, double t) {
+    double tAcc = 2.0 * p->tj + p->ta;
+    double s;
+
+    if (t <= p->tj + p->ta) {
+        return traj_accelStart(p, t);
+    }
+    s = tAcc - t;
+    return p->velocity * tAcc / 2.0 - p->velocity * s + traj_accelStart(p, s);
+}
+
+double
+traj_position(const trajProfile_t* profile, double t) {
+    double tAcc = 2.0 * profile->tj + profile->ta;
+
+    if (t <= 0.0) {
+        return 0.0;
+    }
+    if (t >= profile->duration) {
+        return profile->distance;
+    }
+    if (t < tAcc) {
+        return traj_accelPosition(profile, t);
+    }
+    if (t < tAcc + profile->tv) {
+        return profile->velocity * tAcc / 2.0 + profile->velocity * (t - tAcc);
+    }
+    return profile->distance - traj_accelPosition(profile, profile->duration - t);
+}
+
+uint32_t
+traj_moveLength(const trajProfile_t* profile, uint32_t period_us) {
+    double steps = ceil(profile->duration * 1000000.0 / (double)period_us);
+
+    return steps < 1.0 ? 1U : (uint32_t)steps;
+}
+
+/* Number of setpoints of the dwell */
+static uint32_t
+traj_dwellLength(uint32_t dwell_us, uint32_t period_us) {
+    return (dwell_us + period_us - 1U) / period_us;
+}
+
+uint32_t
+traj_planMove(const trajParams_t* params, int32_t start, int32_t end, uint32_t dwell_us, int32_t* setpoints,
+              uint32_t capacity) {
+    trajProfile_t profile;
+    double dt, direction;
+    uint32_t n, count, i;
+
+    if (setpoints == NULL || !traj_profile(params, (double)end - (double)start, &profile)) {
+        return 0;
+    }
+    n = traj_moveLength(&profile, params->period_us);
+    count = n + traj_dwellLength(dwell_us, params->period_us);
+    if (count > capacity) {
+        return 0;
+    }
+
+    dt = (double)params->period_us / 1000000.0;
+    direction = end >= start ? 1.0 : -1.0;
+    for (i = 0; i < n - 1U; i++) {
+        setpoints[i] = (int32_t)lround((double)start + direction * traj_position(&profile, (double)(i + 1U) * dt));
+    }
+    for (; i < count; i++) {
+        setpoints[i] = end;
+    }
+    return count;
+}
+
+bool
+traj_player_init(trajPlayer_t* player, const trajParams_t* params, const int32_t* waypoints, uint8_t waypointCount,
+                 uint32_t dwell_us) {
+    trajProfile_t profile;
+
+    if (player == NULL || params == NULL || (waypoints == NULL && waypointCount > 0U)
+        || waypointCount > TRAJ_WAYPOINTS_MAX || !traj_profile(params, 0.0, &profile)) {
+        return false;
+    }
+
+    memset(player, 0, sizeof(*player));
+    player->params = *params;
+    if (waypointCount > 0U) {
+        memcpy(player->waypoints, waypoints, waypointCount * sizeof(waypoints[0]));
+    }
+    player->waypointCount = waypointCount;
+    player->dwell_us = dwell_us;
+    atomic_init(&player->buf[0].state, TRAJ_BUF_FREE);
+    atomic_init(&player->buf[1].state, TRAJ_BUF_FREE);
+    atomic_init(&player->generation, 0U);
+    atomic_init(&player->startPosition, 0);
+    atomic_init(&player->segmentsPlayed, 0U);
+    atomic_init(&player->underruns, 0U);
+    return true;
+}
+
+void
+traj_player_free(trajPlayer_t* player) {
+    uint8_t i;
+
+    for (i = 0; i < 2U; i++) {
+        free(player->buf[i].setpoints);
+        player->buf[i].setpoints = NULL;
+        player->buf[i].capacity = 0;
+    }
+}
+
+/* Take back buffer, which was planned for the previous start and was not played */
+static void
+traj_reclaim(trajBuffer_t* buf, uint32_t generation) {
+    unsigned int expected = TRAJ_BUF_READY;
+
+    if (atomic_load_explicit(&buf->state, memory_order_acquire) == TRAJ_BUF_READY && buf->generation != generation) {
+        (void)atomic_compare_exchange_strong(&buf->state, &expected, TRAJ_BUF_FREE);
+    }
+}
+
+bool
+traj_player_plan(trajPlayer_t* player) {
+    uint32_t generation = atomic_load_explicit(&player->generation, memory_order_acquire);
+
+    if (generation == 0U) {
+        return true; /* not started */
+    }
+    if (generation != player->planGeneration) {
+        player->planGeneration = generation;
+        player->planIndex = 0;
+        player->planStart = atomic_load_explicit(&player->startPosition, memory_order_relaxed);
+        player->planBuf = 0;
+    }
+
+    while (player->planIndex < player->waypointCount) {
+        trajBuffer_t* buf = &player->buf[player->planBuf];
+        int32_t end = player->waypoints[player->planIndex];
+        trajProfile_t profile;
+        uint32_t count;
+
+        traj_reclaim(buf, generation);
+        if (atomic_load_explicit(&buf->state, memory_order_acquire) != TRAJ_BUF_FREE) {
+            break; /* both buffers are waiting or playing */
+        }
+
+        (void)traj_profile(&player->params, (double)end - (double)player->planStart, &profile);
+        count = traj_moveLength(&profile, player->params.period_us)
+                + traj_dwellLength(player->dwell_us, player->params.period_us);
+        if (count > buf->capacity) {
+            int32_t* setpoints = realloc(buf->setpoints, count * sizeof(int32_t));
+
+            if (setpoints == NULL) {
+                return false;
+            }
+            buf->setpoints = setpoints;
+            buf->capacity = count;
+        }
+        buf->count = traj_planMove(&player->params, player->planStart, end, player->dwell_us, buf->setpoints,
+                                   buf->capacity);
+        buf->generation = generation;
+        atomic_store_explicit(&buf->state, TRAJ_BUF_READY, memory_order_release);
+
+        player->planStart = end;
+        player->planIndex++;
+        player->planBuf ^= 1U;
+    }
+    return true;
+}
+
+void
+traj_player_start(trajPlayer_t* player, int32_t position) {
+    uint8_t i;
+
+    for (i = 0; i < 2U; i++) {
+        if (atomic_load_explicit(&player->buf[i].state, memory_order_relaxed) == TRAJ_BUF_PLAYING) {
+            atomic_store_explicit(&player->buf[i].state, TRAJ_BUF_FREE, memory_order_release);
+        }
+    }
+    player->playBuf = 0;
+    player->playIndex = 0;
+    player->playStarted = false;
+    player->setpoint = position;
+    atomic_store_explicit(&player->segmentsPlayed, 0U, memory_order_relaxed);
+    atomic_store_explicit(&player->startPosition, position, memory_order_relaxed);
+    /* generation 0 means not started */
+    if (atomic_fetch_add_explicit(&player->generation, 1U, memory_order_release) == UINT32_MAX) {
+        atomic_fetch_add_explicit(&player->generation, 1U, memory_order_release);
+    }
+}
+
+int32_t
+traj_player_next(trajPlayer_t* player) {
+    trajBuffer_t* buf = &player->buf[player->playBuf];
+
+    if (atomic_load_explicit(&buf->state, memory_order_relaxed) != TRAJ_BUF_PLAYING) {
+        unsigned int expected = TRAJ_BUF_READY;
+
+        if (traj_player_done(player)) {
+            return player->setpoint;
+        }
+        if (!atomic_compare_exchange_strong_explicit(&buf->state, &expected, TRAJ_BUF_PLAYING, memory_order_acquire,
+                                                     memory_order_relaxed)) {
+            if (player->playStarted) {
+                atomic_fetch_add_explicit(&player->underruns, 1U, memory_order_relaxed);
+            }
+            return player->setpoint;
+        }
+        if (buf->generation != atomic_load_explicit(&player->generation, memory_order_relaxed)) {
+            /* planned for the previous start */
+            atomic_store_explicit(&buf->state, TRAJ_BUF_FREE, memory_order_release);
+            return player->setpoint;
+        }
+        player->playIndex = 0;
+        player->playStarted = true;
+    }
+
+    player->setpoint = buf->setpoints[player->playIndex++];
+    if (player->playIndex >= buf->count) {
+        atomic_store_explicit(&buf->state, TRAJ_BUF_FREE, memory_order_release);
+        atomic_fetch_add_explicit(&player->segmentsPlayed, 1U, memory_order_relaxed);
+        player->playBuf ^= 1U;
+    }
+    return player->setpoint;
+}
+
+bool
+traj_player_done(const trajPlayer_t* player) {
+    return atomic_load_explicit(&player->segmentsPlayed, memory_order_relaxed) >= player->waypointCount;
+}
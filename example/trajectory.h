@@ -0,0 +1,200 @@
+/**
+ * Offline trajectory planner with double-buffered setpoint player.
+ *
+ * Motion is planned in the mainline as a sequence of segments. Each segment is a jerk-limited (7-phase S-curve)
+ * rest-to-rest move from the previous waypoint to the next one, followed by an optional dwell. All setpoints of the
+ * segment, one per SYNC period, are precomputed into a contiguous buffer. The player has two buffers: while the SYNC
+ * callback plays one of them, the mainline plans the next segment into the other. The SYNC callback only reads the
+ * next value from the buffer, nothing is computed per cycle.
+ *
+ * Buffers are handed over with atomic state, so planner and player may run in different threads. There must be only
+ * one planner thread and only one player thread.
+ *
+ * @file        trajectory.h
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of waypoints of one path */
+#define TRAJ_WAYPOINTS_MAX 64U
+
+/** Limits of the S-curve profile */
+typedef struct {
+    double velocity;     /**< Maximum velocity in counts/s */
+    double acceleration; /**< Maximum acceleration in counts/s^2 */
+    double jerk;         /**< Maximum jerk in counts/s^3 */
+    uint32_t period_us;  /**< Setpoint period (SYNC period) in microseconds */
+} trajParams_t;
+
+/** Times of the S-curve profile of one move, calculated by traj_profile() */
+typedef struct {
+    double distance;     /**< Absolute distance of the move in counts */
+    double velocity;     /**< Reached velocity, may be lower than the limit on short moves */
+    double acceleration; /**< Reached acceleration, may be lower than the limit on short moves */
+    double jerk;         /**< Jerk */
+    double tj;           /**< Time of one constant jerk phase */
+    double ta;           /**< Time of the constant acceleration phase */
+    double tv;           /**< Time of the constant velocity phase */
+    double duration;     /**< Total time of the move: 2 * (2 * tj + ta) + tv */
+} trajProfile_t;
+
+/** State of the setpoint buffer */
+typedef enum {
+    TRAJ_BUF_FREE = 0,  /**< Buffer is owned by the planner */
+    TRAJ_BUF_READY = 1, /**< Buffer is planned and waits for the player */
+    TRAJ_BUF_PLAYING = 2 /**< Buffer is owned by the player */
+} trajBufState_t;
+
+/** Buffer with setpoints of one segment */
+typedef struct {
+    int32_t* setpoints;   /**< Setpoints, one per period */
+    uint32_t capacity;    /**< Size of setpoints[] in elements */
+    uint32_t count;       /**< Number of valid setpoints */
+    uint32_t generation;  /**< Value of trajPlayer_t.generation, for which buffer was planned */
+    atomic_uint state;    /**< trajBufState_t */
+} trajBuffer_t;
+
+/** Player, planner part is accessed from the mainline, player part from the SYNC callback */
+typedef struct {
+    trajParams_t params;                      /**< From traj_player_init() */
+    int32_t waypoints[TRAJ_WAYPOINTS_MAX];    /**< Path, from traj_player_init() */
+    uint8_t waypointCount;                    /**< Number of waypoints */
+    uint32_t dwell_us;                        /**< Pause after each waypoint */
+    trajBuffer_t buf[2];                      /**< Setpoint buffers */
+    /* planner */
+    uint32_t planGeneration;                  /**< Generation of the path, which is planned */
+    uint8_t planIndex;                        /**< Next waypoint to plan */
+    int32_t planStart;                        /**< Start position of the next segment */
+    uint8_t planBuf;                          /**< Buffer for the next segment */
+    /* player */
+    atomic_uint generation;                   /**< Incremented by traj_player_start() */
+    atomic_int startPosition;                 /**< Start of the path, from traj_player_start() */
+    uint8_t playBuf;                          /**< Buffer, which is played */
+    uint32_t playIndex;                       /**< Next setpoint in buf[playBuf] */
+    bool playStarted;                         /**< First segment after traj_player_start() was taken */
+    int32_t setpoint;                         /**< Last setpoint from traj_player_next() */
+    atomic_uint segmentsPlayed;               /**< Number of segments, which finished playing */
+    atomic_uint underruns;                    /**< Periods, when next segment was not planned in time */
+} trajPlayer_t;
+
+/**
+ * Calculate S-curve profile of a rest-to-rest move. If distance is too short to reach the velocity or acceleration
+ * limit, reached velocity and acceleration are reduced.
+ *
+ * @param params Limits of the profile.
+ * @param distance Distance of the move in counts, sign is ignored.
+ * @param [out] profile Calculated profile.
+ *
+ * @return false if limits are not positive.
+ */
+bool traj_profile(const trajParams_t* params, double distance, trajProfile_t* profile);
+
+/**
+ * Position on the S-curve profile at time t from the start of the move.
+ *
+ * @param profile Profile from traj_profile().
+ * @param t Time in seconds, limited to 0..duration.
+ *
+ * @return Distance from the start, 0..profile->distance.
+ */
+double traj_position(const trajProfile_t* profile, double t);
+
+/**
+ * Number of setpoints of the move from traj_planMove() without dwell. Start position is not included, last setpoint is
+ * the end position.
+ */
+uint32_t traj_moveLength(const trajProfile_t* profile, uint32_t period_us);
+
+/**
+ * Sample S-curve move from start to end into setpoints[], one per period. First setpoint is the first step after
+ * start, last setpoint is end, followed by dwell setpoints equal to end.
+ *
+ * @param params Limits of the profile.
+ * @param start Start position in counts.
+ * @param end End position in counts.
+ * @param dwell_us Time to hold end position after the move.
+ * @param [out] setpoints Buffer for setpoints.
+ * @param capacity Size of setpoints[] in elements.
+ *
+ * @return Number of setpoints written, 0 if capacity is too small or parameters are wrong.
+ */
+uint32_t traj_planMove(const trajParams_t* params, int32_t start, int32_t end, uint32_t dwell_us, int32_t* setpoints,
+                       uint32_t capacity);
+
+/**
+ * Initialize player with the path. Buffers are allocated by traj_player_plan().
+ *
+ * @param player This object.
+ * @param params Limits of the profile.
+ * @param waypoints Positions in counts, which are reached one after another.
+ * @param waypointCount Number of waypoints, up to TRAJ_WAYPOINTS_MAX.
+ * @param dwell_us Pause after each waypoint.
+ *
+ * @return false if arguments are wrong.
+ */
+bool traj_player_init(trajPlayer_t* player, const trajParams_t* params, const int32_t* waypoints,
+                      uint8_t waypointCount, uint32_t dwell_us);
+
+/**
+ * Release buffers of the player. Player must not be used from the SYNC callback any more.
+ */
+void traj_player_free(trajPlayer_t* player);
+
+/**
+ * Plan next segments into free buffers. Called cyclically from the mainline, not from the real-time thread.
+ *
+ * @param player This object.
+ *
+ * @return false on out of memory.
+ */
+bool traj_player_plan(trajPlayer_t* player);
+
+/**
+ * Start the path from position. Called from the player thread, for example when the drive enters operation enabled.
+ * Buffers of previous start are discarded, first segment is planned by the next traj_player_plan(). Until it is
+ * ready, traj_player_next() holds position.
+ *
+ * @param player This object.
+ * @param position Actual position, where path starts.
+ */
+void traj_player_start(trajPlayer_t* player, int32_t position);
+
+/**
+ * Next setpoint, called once per SYNC period. If next segment is not ready, last setpoint is held. Wait for the
+ * first segment after traj_player_start() is expected, later waits increment underruns.
+ *
+ * @param player This object.
+ *
+ * @return Setpoint in counts.
+ */
+int32_t traj_player_next(trajPlayer_t* player);
+
+/**
+ * Return true, if all segments of the path after the last traj_player_start() are played.
+ */
+bool traj_player_done(const trajPlayer_t* player);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* TRAJECTORY_H */
@@ -0,0 +1,213 @@
+/*
+ * CANopen Emergency consumer with lock-free queue, history of each node and batch delivery.
+ *
+ * @file        CO_EMcons.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_EMcons.h"
+
+#if ((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0
+
+#if (CO_EM_CONS_QUEUE_SIZE & (CO_EM_CONS_QUEUE_SIZE - 1U)) != 0
+#error CO_EM_CONS_QUEUE_SIZE must be a power of 2
+#endif
+
+/* Atomic access to the queue positions and cell sequences. May be defined in CO_driver_target.h for other compilers */
+#ifndef CO_EM_CONS_CAS
+#if defined __GNUC__
+#define CO_EM_CONS_LOAD(var)       __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define CO_EM_CONS_STORE(var, val) __atomic_store_n(&(var), (val), __ATOMIC_RELEASE)
+#define CO_EM_CONS_CAS(var, expected, desired)                                                                         \
+    __atomic_compare_exchange_n(&(var), &(expected), (desired), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#define CO_EM_CONS_INC(var) (void)__atomic_fetch_add(&(var), 1U, __ATOMIC_RELAXED)
+#else
+#error CO_CONFIG_EM_CONS requires CO_EM_CONS_LOAD(), CO_EM_CONS_STORE(), CO_EM_CONS_CAS() and CO_EM_CONS_INC()
+#endif
+#endif
+
+/* True, if both records describe the same emergency condition */
+static inline bool_t
+CO_EMcons_same(const CO_EMcons_rec_t* a, const CO_EMcons_rec_t* b) {
+    return (a->nodeId == b->nodeId) && (a->errorCode == b->errorCode) && (a->errorRegister == b->errorRegister)
+           && (a->errorBit == b->errorBit) && (a->infoCode == b->infoCode);
+}
+
+/* Merge repeated record rec into the older record dst */
+static inline void
+CO_EMcons_merge(CO_EMcons_rec_t* dst, const CO_EMcons_rec_t* rec) {
+    uint32_t repeat = (uint32_t)dst->repeat + rec->repeat;
+
+    dst->repeat = (repeat < 0xFFFFU) ? (uint16_t)repeat : 0xFFFFU;
+    dst->last_us = rec->last_us;
+}
+
+/* Store record into the history of its node */
+static void
+CO_EMcons_store(CO_EMcons_t* emc, const CO_EMcons_rec_t* rec) {
+    CO_EMcons_history_t* h = &emc->history[rec->nodeId];
+
+    if ((h->count > 0U) && CO_EMcons_same(&h->rec[h->newest], rec)) {
+        CO_EMcons_merge(&h->rec[h->newest], rec);
+        return;
+    }
+    if (h->count > 0U) {
+        h->newest = (uint8_t)((h->newest + 1U) % CO_EM_CONS_HISTORY);
+    }
+    if (h->count < CO_EM_CONS_HISTORY) {
+        h->count++;
+    }
+    h->rec[h->newest] = *rec;
+}
+
+/* Deliver collected batch to the application */
+static void
+CO_EMcons_deliver(CO_EMcons_t* emc, uint16_t* batchCount) {
+    if ((*batchCount > 0U) && (emc->pFunctBatch != NULL)) {
+        emc->pFunctBatch(emc->functBatchObject, emc->batch, *batchCount);
+    }
+    *batchCount = 0;
+}
+
+void
+CO_EMcons_init(CO_EMcons_t* emc) {
+    if (emc == NULL) {
+        return;
+    }
+    (void)memset(emc, 0, sizeof(CO_EMcons_t));
+    for (uint32_t i = 0; i < CO_EM_CONS_QUEUE_SIZE; i++) {
+        emc->queue[i].seq = i;
+    }
+}
+
+void
+CO_EMcons_initCallbackBatch(CO_EMcons_t* emc, void* object,
+                            void (*pFunctBatch)(void* object, const CO_EMcons_rec_t* recs, uint16_t count)) {
+    if (emc != NULL) {
+        emc->functBatchObject = object;
+        emc->pFunctBatch = pFunctBatch;
+    }
+}
+
+bool_t
+CO_EMcons_push(CO_EMcons_t* emc, uint8_t nodeId, uint16_t errorCode, uint8_t errorRegister, uint8_t errorBit,
+               uint32_t infoCode) {
+    if ((emc == NULL) || (nodeId > 127U)) {
+        return false;
+    }
+
+    /* reserve a free cell: its sequence equals the position, which is then claimed by CAS */
+    CO_EMcons_cell_t* cell;
+    uint32_t pos = CO_EM_CONS_LOAD(emc->enqPos);
+    for (;;) {
+        cell = &emc->queue[pos & (CO_EM_CONS_QUEUE_SIZE - 1U)];
+        int32_t dif = (int32_t)(CO_EM_CONS_LOAD(cell->seq) - pos);
+        if (dif == 0) {
+            if (CO_EM_CONS_CAS(emc->enqPos, pos, pos + 1U)) {
+                break;
+            }
+        } else if (dif < 0) {
+            /* queue is full, cell is not drained yet */
+            CO_EM_CONS_INC(emc->dropCount);
+            return false;
+        } else {
+            pos = CO_EM_CONS_LOAD(emc->enqPos);
+        }
+    }
+
+    cell->rec.infoCode = infoCode;
+    cell->rec.first_us = emc->now_us;
+    cell->rec.last_us = cell->rec.first_us;
+    cell->rec.errorCode = errorCode;
+    cell->rec.repeat = 1;
+    cell->rec.nodeId = nodeId;
+    cell->rec.errorRegister = errorRegister;
+    cell->rec.errorBit = errorBit;
+
+    /* publish the cell to CO_EMcons_process() */
+    CO_EM_CONS_STORE(cell->seq, pos + 1U);
+    return true;
+}
+
+void
+CO_EMcons_process(CO_EMcons_t* emc, uint32_t timeDifference_us, uint32_t* timerNext_us) {
+    if (emc == NULL) {
+        return;
+    }
+    emc->now_us += timeDifference_us;
+
+    uint16_t batchCount = 0;
+    for (uint32_t n = 0; n < CO_EM_CONS_QUEUE_SIZE; n++) {
+        CO_EMcons_cell_t* cell = &emc->queue[emc->deqPos & (CO_EM_CONS_QUEUE_SIZE - 1U)];
+        if (CO_EM_CONS_LOAD(cell->seq) != (emc->deqPos + 1U)) {
+            break; /* empty or producer is still writing the cell */
+        }
+        CO_EMcons_rec_t rec = cell->rec;
+
+        /* release the cell to producers for the next round */
+        CO_EM_CONS_STORE(cell->seq, emc->deqPos + CO_EM_CONS_QUEUE_SIZE);
+        emc->deqPos++;
+
+        CO_EMcons_store(emc, &rec);
+
+        /* merge repeated message into the batch or append it */
+        bool_t merged = false;
+        for (uint16_t i = 0; i < batchCount; i++) {
+            if (CO_EMcons_same(&emc->batch[i], &rec)) {
+                CO_EMcons_merge(&emc->batch[i], &rec);
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            if (batchCount >= CO_EM_CONS_BATCH) {
+                CO_EMcons_deliver(emc, &batchCount);
+            }
+            emc->batch[batchCount] = rec;
+            batchCount++;
+        }
+    }
+    CO_EMcons_deliver(emc, &batchCount);
+
+    if ((timerNext_us != NULL)
+        && (CO_EM_CONS_LOAD(emc->queue[emc->deqPos & (CO_EM_CONS_QUEUE_SIZE - 1U)].seq) == (emc->deqPos + 1U))) {
+        *timerNext_us = 0;
+    }
+}
+
+uint8_t
+CO_EMcons_historyCount(const CO_EMcons_t* emc, uint8_t nodeId) {
+    return (nodeId < 128U) ? emc->history[nodeId].count : 0U;
+}
+
+const CO_EMcons_rec_t*
+CO_EMcons_history(const CO_EMcons_t* emc, uint8_t nodeId, uint8_t index) {
+    if ((nodeId > 127U) || (index >= emc->history[nodeId].count)) {
+        return NULL;
+    }
+    const CO_EMcons_history_t* h = &emc->history[nodeId];
+    return &h->rec[(h->newest + CO_EM_CONS_HISTORY - index) % CO_EM_CONS_HISTORY];
+}
+
+void
+CO_EMcons_clearHistory(CO_EMcons_t* emc, uint8_t nodeId) {
+    if (nodeId == 0xFFU) {
+        (void)memset(emc->history, 0, sizeof(emc->history));
+    } else if (nodeId < 128U) {
+        (void)memset(&emc->history[nodeId], 0, sizeof(emc->history[nodeId]));
+    } else { /* MISRA C 2004 14.10 */
+    }
+}
+
+#endif /* (CO_CONFIG_EM_CONS) & CO_CONFIG_EM_CONS_ENABLE */
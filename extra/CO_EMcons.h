@@ -0,0 +1,208 @@
+/**
+ * CANopen Emergency consumer with lock-free queue, history of each node and batch delivery.
+ *
+ * @file        CO_EMcons.h
+ * @ingroup     CO_EMcons
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_EM_CONS_H
+#define CO_EM_CONS_H
+
+#include "301/CO_driver.h"
+
+/* default configuration, see CO_config.h */
+#ifndef CO_CONFIG_EM_CONS
+#define CO_CONFIG_EM_CONS (0)
+#endif
+
+#if (((CO_CONFIG_EM_CONS)&CO_CONFIG_EM_CONS_ENABLE) != 0) || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_EMcons Emergency consumer
+ * Queue, history and batch delivery of emergency messages from all nodes.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * Emergency receive callback only pushes the message into a bounded lock-free queue with CO_EMcons_push(). Several
+ * producers may push concurrently, for example receive threads of more CAN interfaces and CO_EM_process(), which
+ * reports own emergency messages with node-id 0. If the queue is full, message is dropped and counted, producer never
+ * waits.
+ *
+ * CO_EMcons_process() drains the queue from the processing thread. Each message is stored into the ring history of
+ * its node. If it is the same as the newest message of the node (error code, error register, error bit and info code),
+ * then only repeat count and time of the newest record are updated, so a node which repeats the same fault does not
+ * flush its history. Messages are then delivered to the application in batches of up to @ref CO_EM_CONS_BATCH
+ * records, repeated messages within a batch are merged into one record.
+ *
+ * CO_EMcons_t is attached to the Emergency object with CO_EM_setEMcons(). CO_CANopenInit() does that for the CANopen
+ * object and CO_process() calls CO_EMcons_process(). History access functions must be used from the processing thread
+ * or with CO_LOCK_OD().
+ */
+
+/** Size of the queue, must be a power of 2 */
+#ifndef CO_EM_CONS_QUEUE_SIZE
+#define CO_EM_CONS_QUEUE_SIZE 64U
+#endif
+
+/** Number of history records for each node, node-id 0 is this node */
+#ifndef CO_EM_CONS_HISTORY
+#define CO_EM_CONS_HISTORY 4U
+#endif
+
+/** Maximum number of records in one call of the batch callback */
+#ifndef CO_EM_CONS_BATCH
+#define CO_EM_CONS_BATCH 16U
+#endif
+
+/** Emergency record, in the queue, in the history and in the batch */
+typedef struct {
+    uint32_t infoCode;     /**< Manufacturer specific info code from bytes 4..7 */
+    uint32_t first_us;     /**< Time of the first occurrence, see CO_EMcons_t::now_us */
+    uint32_t last_us;      /**< Time of the last occurrence */
+    uint16_t errorCode;    /**< Emergency error code, see @ref CO_EM_errorCode_t */
+    uint16_t repeat;       /**< Number of occurrences, saturated at 0xFFFF */
+    uint8_t nodeId;        /**< Node-id of the producer, 0 for this node */
+    uint8_t errorRegister; /**< Error register, see @ref CO_errorRegister_t */
+    uint8_t errorBit;      /**< Error bit, see @ref CO_EM_errorStatusBits_t */
+} CO_EMcons_rec_t;
+
+/** Cell of the queue */
+typedef struct {
+    volatile uint32_t seq; /**< Sequence of the cell, see CO_EMcons_push() */
+    CO_EMcons_rec_t rec;   /**< Record */
+} CO_EMcons_cell_t;
+
+/** History of one node */
+typedef struct {
+    CO_EMcons_rec_t rec[CO_EM_CONS_HISTORY]; /**< Ring of records */
+    uint8_t newest;                          /**< Index of the newest record */
+    uint8_t count;                           /**< Number of valid records */
+} CO_EMcons_history_t;
+
+/** Emergency consumer object */
+typedef struct {
+    CO_EMcons_cell_t queue[CO_EM_CONS_QUEUE_SIZE]; /**< Queue of received messages */
+    volatile uint32_t enqPos;                      /**< Next push position, shared by producers */
+    uint32_t deqPos;                               /**< Next drain position, used by CO_EMcons_process() only */
+    volatile uint32_t dropCount;                   /**< Number of messages dropped because the queue was full */
+    volatile uint32_t now_us;                      /**< Time, advanced by CO_EMcons_process() */
+    CO_EMcons_history_t history[128];              /**< History of each node, index is node-id */
+    CO_EMcons_rec_t batch[CO_EM_CONS_BATCH];       /**< Batch of records for pFunctBatch */
+    /** From CO_EMcons_initCallbackBatch() or NULL */
+    void (*pFunctBatch)(void* object, const CO_EMcons_rec_t* recs, uint16_t count);
+    void* functBatchObject; /**< From CO_EMcons_initCallbackBatch() or NULL */
+} CO_EMcons_t;
+
+/**
+ * Initialize Emergency consumer object, empty queue and history, without callback
+ *
+ * @param emc This object will be initialized.
+ */
+void CO_EMcons_init(CO_EMcons_t* emc);
+
+/**
+ * Initialize batch callback
+ *
+ * Callback is called from CO_EMcons_process() with records drained from the queue. Records are valid only during the
+ * call.
+ *
+ * @param emc This object.
+ * @param object Pointer to object, which will be passed to pFunctBatch(). Can be NULL
+ * @param pFunctBatch Pointer to the callback function. Not called if NULL.
+ */
+void CO_EMcons_initCallbackBatch(CO_EMcons_t* emc, void* object,
+                                 void (*pFunctBatch)(void* object, const CO_EMcons_rec_t* recs, uint16_t count));
+
+/**
+ * Push emergency message into the queue
+ *
+ * Function is lock-free and may be called concurrently from more threads, including receive callbacks.
+ *
+ * @param emc This object, may be NULL.
+ * @param nodeId Node-id of the producer, 0 for this node.
+ * @param errorCode Emergency error code.
+ * @param errorRegister Error register.
+ * @param errorBit Error bit.
+ * @param infoCode Info code.
+ *
+ * @return True if message was queued, false if it was dropped.
+ */
+bool_t CO_EMcons_push(CO_EMcons_t* emc, uint8_t nodeId, uint16_t errorCode, uint8_t errorRegister, uint8_t errorBit,
+                      uint32_t infoCode);
+
+/**
+ * Process Emergency consumer
+ *
+ * Drain the queue into history and deliver batches to the callback. At most @ref CO_EM_CONS_QUEUE_SIZE messages are
+ * drained in one call, so a fault storm can not block the processing thread.
+ *
+ * @param emc This object, may be NULL.
+ * @param timeDifference_us Time difference from previous function call in microseconds.
+ * @param [out] timerNext_us info to OS, set to 0 if messages remain in the queue - see CO_process(), may be NULL.
+ */
+void CO_EMcons_process(CO_EMcons_t* emc, uint32_t timeDifference_us, uint32_t* timerNext_us);
+
+/**
+ * Get number of history records of the node
+ *
+ * @param emc This object.
+ * @param nodeId Node-id, 0 for this node.
+ *
+ * @return Number of records, up to @ref CO_EM_CONS_HISTORY.
+ */
+uint8_t CO_EMcons_historyCount(const CO_EMcons_t* emc, uint8_t nodeId);
+
+/**
+ * Get history record of the node
+ *
+ * @param emc This object.
+ * @param nodeId Node-id, 0 for this node.
+ * @param index 0 for the newest record.
+ *
+ * @return Pointer to the record or NULL, if there is no such record.
+ */
+const CO_EMcons_rec_t* CO_EMcons_history(const CO_EMcons_t* emc, uint8_t nodeId, uint8_t index);
+
+/**
+ * Clear history of the node
+ *
+ * @param emc This object.
+ * @param nodeId Node-id, 0 for this node, 0xFF for all nodes.
+ */
+void CO_EMcons_clearHistory(CO_EMcons_t* emc, uint8_t nodeId);
+
+/**
+ * Get number of messages dropped because the queue was full
+ *
+ * @param emc This object.
+ *
+ * @return Number of dropped messages since initialization.
+ */
+static inline uint32_t
+CO_EMcons_getDropCount(const CO_EMcons_t* emc) {
+    return emc->dropCount;
+}
+
+/** @} */ /* CO_EMcons */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_EM_CONS) & CO_CONFIG_EM_CONS_ENABLE */
+
+#endif /* CO_EM_CONS_H */
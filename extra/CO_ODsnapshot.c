@@ -0,0 +1,203 @@
+/*
+ * CANopen Object Dictionary snapshots, double-buffered copies of OD regions for readers outside the real-time thread.
+ *
+ * @file        CO_ODsnapshot.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_ODsnapshot.h"
+
+CO_ReturnError_t
+CO_ODsnapshot_init(CO_ODsnapshot_t* snap) {
+    if (snap == NULL) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    (void)memset(snap, 0, sizeof(CO_ODsnapshot_t));
+    return CO_ERROR_NO;
+}
+
+CO_ReturnError_t
+CO_ODsnapshot_addRegion(CO_ODsnapshot_t* snap, const void* live, size_t len, uint8_t* copies) {
+    if ((snap == NULL) || (live == NULL) || (len == 0U) || (copies == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    if (snap->regionCount >= CO_OD_SNAPSHOT_REGIONS) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+
+    CO_ODsnapshot_region_t* region = &snap->regions[snap->regionCount];
+    region->live = (const uint8_t*)live;
+    region->copy[0] = copies;
+    region->copy[1] = copies + len;
+    region->len = len;
+    (void)memcpy(region->copy[0], live, len);
+    (void)memcpy(region->copy[1], live, len);
+    snap->regionCount++;
+
+    return CO_ERROR_NO;
+}
+
+void
+CO_ODsnapshot_publish(CO_ODsnapshot_t* snap) {
+    if (snap == NULL) {
+        return;
+    }
+
+    /* generation is even here, only this thread changes it */
+    uint32_t generation = snap->generation;
+    uint8_t next = (uint8_t)(((generation >> 1) + 1U) & 1U);
+
+    /* odd generation: copy[next] is being written, published copy stays valid */
+    snap->generation = generation + 1U;
+    CO_MemoryBarrier();
+    for (uint8_t i = 0; i < snap->regionCount; i++) {
+        CO_ODsnapshot_region_t* region = &snap->regions[i];
+        (void)memcpy(region->copy[next], region->live, region->len);
+    }
+    CO_MemoryBarrier();
+    snap->generation = generation + 2U;
+}
+
+/* Find region, which contains the whole range, NULL if none */
+static const CO_ODsnapshot_region_t*
+CO_ODsnapshot_findRegion(const CO_ODsnapshot_t* snap, const void* live, size_t len) {
+    const uint8_t* addr = (const uint8_t*)live;
+
+    for (uint8_t i = 0; i < snap->regionCount; i++) {
+        const CO_ODsnapshot_region_t* region = &snap->regions[i];
+        if ((addr >= region->live) && (addr < (region->live + region->len))
+            && (len <= (size_t)((region->live + region->len) - addr))) {
+            return region;
+        }
+    }
+    return NULL;
+}
+
+/* Copy range from the published copy of the region. Copy published with generation G is overwritten by the
+ * publication of G + 2, which starts, when generation becomes 2 * (G + 1) + 1. */
+static void
+CO_ODsnapshot_copy(CO_ODsnapshot_t* snap, const CO_ODsnapshot_region_t* region, size_t offset, void* buf, size_t len) {
+    for (;;) {
+        uint32_t generation = snap->generation;
+        CO_MemoryBarrier();
+        (void)memcpy(buf, region->copy[(generation >> 1) & 1U] + offset, len);
+        CO_MemoryBarrier();
+        if ((snap->generation - (generation & ~1U)) <= 2U) {
+            break;
+        }
+        snap->readRetries++;
+    }
+}
+
+bool_t
+CO_ODsnapshot_read(CO_ODsnapshot_t* snap, const void* live, void* buf, size_t len) {
+    if ((snap == NULL) || (live == NULL) || (buf == NULL)) {
+        return false;
+    }
+
+    const CO_ODsnapshot_region_t* region = CO_ODsnapshot_findRegion(snap, live, len);
+    if (region == NULL) {
+        return false;
+    }
+    CO_ODsnapshot_copy(snap, region, (size_t)((const uint8_t*)live - region->live), buf, len);
+    return true;
+}
+
+ODR_t
+CO_ODsnapshot_readSub(CO_ODsnapshot_t* snap, const OD_entry_t* entry, uint8_t subIndex, void* val,
+                      OD_size_t len) {
+    if ((snap == NULL) || (val == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    OD_IO_t io;
+    ODR_t ret = OD_getSub(entry, subIndex, &io, true);
+    if (ret != ODR_OK) {
+        return ret;
+    }
+    if (io.stream.dataLength != len) {
+        return ODR_TYPE_MISMATCH;
+    }
+    return CO_ODsnapshot_read(snap, io.stream.dataOrig, val, len) ? ODR_OK : ODR_DEV_INCOMPAT;
+}
+
+/* OD read function of attached entries, same as OD_readOriginal(), but from the published copy */
+static ODR_t
+CO_ODsnapshot_readOD(OD_stream_t* stream, void* buf, OD_size_t count, OD_size_t* countRead) {
+    if ((stream == NULL) || (buf == NULL) || (countRead == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    CO_ODsnapshot_t* snap = (CO_ODsnapshot_t*)stream->object;
+    OD_size_t dataLenToCopy = stream->dataLength;
+    const uint8_t* dataOrig = stream->dataOrig;
+
+    if (dataOrig == NULL) {
+        return ODR_SUB_NOT_EXIST;
+    }
+
+    ODR_t returnCode = ODR_OK;
+
+    /* If previous read was partial or OD variable length is larger than current buffer size, then data was (will be)
+     * read in several segments */
+    if ((stream->dataOffset > 0U) || (dataLenToCopy > count)) {
+        if (stream->dataOffset >= dataLenToCopy) {
+            return ODR_DEV_INCOMPAT;
+        }
+        dataLenToCopy -= stream->dataOffset;
+        dataOrig += stream->dataOffset;
+
+        if (dataLenToCopy > count) {
+            dataLenToCopy = count;
+            stream->dataOffset += dataLenToCopy;
+            returnCode = ODR_PARTIAL;
+        } else {
+            stream->dataOffset = 0;
+        }
+    }
+
+    if (!CO_ODsnapshot_read(snap, dataOrig, buf, dataLenToCopy)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    *countRead = dataLenToCopy;
+    return returnCode;
+}
+
+CO_ReturnError_t
+CO_ODsnapshot_attach(CO_ODsnapshot_t* snap, OD_entry_t* entry, OD_extension_t* extension) {
+    if ((snap == NULL) || (entry == NULL) || (extension == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* all sub-entries with data must be inside regions */
+    for (uint8_t subIndex = 0; subIndex < entry->subEntriesCount; subIndex++) {
+        OD_IO_t io;
+        if (OD_getSub(entry, subIndex, &io, true) != ODR_OK) {
+            continue;
+        }
+        if ((io.stream.dataOrig != NULL) && (io.stream.dataLength > 0U)
+            && (CO_ODsnapshot_findRegion(snap, io.stream.dataOrig, io.stream.dataLength) == NULL)) {
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    extension->object = snap;
+    extension->read = CO_ODsnapshot_readOD;
+    extension->write = OD_writeOriginal;
+#if OD_IO_VIEW > 0
+    extension->view = NULL;
+#endif
+    return (OD_extension_init(entry, extension) == ODR_OK) ? CO_ERROR_NO : CO_ERROR_ILLEGAL_ARGUMENT;
+}
@@ -0,0 +1,156 @@
+/**
+ * CANopen Object Dictionary snapshots, double-buffered copies of OD regions for readers outside the real-time thread.
+ *
+ * @file        CO_ODsnapshot.h
+ * @ingroup     CO_ODsnapshot
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_OD_SNAPSHOT_H
+#define CO_OD_SNAPSHOT_H
+
+#include "301/CO_driver.h"
+#include "301/CO_ODinterface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_ODsnapshot OD snapshots
+ * Double-buffered copies of PDO mapped OD regions, published by the real-time thread.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * Real-time thread and mainline both access OD variables, protected by CO_LOCK_OD(). Mainline readers of PDO mapped
+ * variables, like SDO uploads, gateway dumps or monitoring, can instead read a snapshot, so they don't depend on the
+ * lock and always see values from the same cycle.
+ *
+ * Application designates OD memory regions with CO_ODsnapshot_addRegion(), for example structure with RPDO and TPDO
+ * mapped variables. Each region has two copies. Real-time thread calls CO_ODsnapshot_publish() once per cycle: it
+ * copies live regions into the copy, which is not published, and flips the published index. Publishing never waits
+ * for readers.
+ *
+ * Readers use CO_ODsnapshot_read() or CO_ODsnapshot_readSub() from any thread. They copy from the published copy,
+ * which is overwritten only by the publication after the next one, so the reader has a full cycle for the copy. This
+ * is verified with the generation counter after the copy and the read is repeated in the rare case it took longer.
+ *
+ * OD entries may be attached to the snapshot with CO_ODsnapshot_attach(). Then reads through the OD interface (SDO
+ * server, local SDO client of the gateway, TPDO) come from the published copy and writes go to the live variable. If
+ * CO_ODsnapshot_publish() is called after the application has processed the cycle and before TPDOs are sent, like in
+ * CO_epoll_processRT(), TPDOs see the same values as in live memory. Values written by SDO appear in reads after the
+ * next publication.
+ */
+
+/** Maximum number of regions in one snapshot */
+#ifndef CO_OD_SNAPSHOT_REGIONS
+#define CO_OD_SNAPSHOT_REGIONS 4U
+#endif
+
+/** OD memory region with two copies */
+typedef struct {
+    const uint8_t* live; /**< Live OD memory, written by the real-time thread and by OD writes */
+    uint8_t* copy[2];    /**< Two copies of the region, second follows the first, from CO_ODsnapshot_addRegion() */
+    size_t len;          /**< Length of the region in bytes */
+} CO_ODsnapshot_region_t;
+
+/** OD snapshot object */
+typedef struct {
+    CO_ODsnapshot_region_t regions[CO_OD_SNAPSHOT_REGIONS]; /**< Designated regions */
+    uint8_t regionCount;                                    /**< Number of used regions */
+    volatile uint32_t generation; /**< Twice the number of publications, odd while the copy is written. Published copy
+                                     is copy[(generation >> 1) & 1]. */
+    volatile uint32_t readRetries; /**< Statistics: reads repeated, because the copy was overwritten meanwhile */
+} CO_ODsnapshot_t;
+
+/**
+ * Initialize OD snapshot object without regions
+ *
+ * @param snap This object will be initialized.
+ *
+ * @return CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_ODsnapshot_init(CO_ODsnapshot_t* snap);
+
+/**
+ * Designate OD memory region for snapshots
+ *
+ * Must be called before real-time thread starts publishing. Both copies are filled with the current content.
+ *
+ * @param snap This object.
+ * @param live Address of the OD memory, for example &OD_RAM or a part of it.
+ * @param len Length of the region in bytes.
+ * @param copies Memory for two copies, 2 * len bytes, owned by application.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_OUT_OF_MEMORY if there are already
+ * CO_OD_SNAPSHOT_REGIONS regions.
+ */
+CO_ReturnError_t CO_ODsnapshot_addRegion(CO_ODsnapshot_t* snap, const void* live, size_t len, uint8_t* copies);
+
+/**
+ * Publish consistent copy of all regions
+ *
+ * Called from the real-time thread, once per cycle, after RPDOs and application processing, inside CO_LOCK_OD().
+ * Only one thread may publish.
+ *
+ * @param snap This object, may be NULL.
+ */
+void CO_ODsnapshot_publish(CO_ODsnapshot_t* snap);
+
+/**
+ * Read from the published copy
+ *
+ * @param snap This object.
+ * @param live Address of the data in the live OD memory, range must lie inside one region.
+ * @param [out] buf Data are copied here.
+ * @param len Number of bytes to copy.
+ *
+ * @return true on success, false if range is not inside any region.
+ */
+bool_t CO_ODsnapshot_read(CO_ODsnapshot_t* snap, const void* live, void* buf, size_t len);
+
+/**
+ * Read OD variable from the published copy, same as OD_get_value() on the snapshot
+ *
+ * @param snap This object.
+ * @param entry Object Dictionary entry.
+ * @param subIndex Sub-index of the variable from the OD object.
+ * @param [out] val Value will be written here.
+ * @param len Size of value to retrieve, must match length of the variable.
+ *
+ * @return Value from @ref ODR_t, "ODR_OK" in case of success, "ODR_TYPE_MISMATCH" if variable has different length,
+ * "ODR_DEV_INCOMPAT" if variable is not inside any region.
+ */
+ODR_t CO_ODsnapshot_readSub(CO_ODsnapshot_t* snap, const OD_entry_t* entry, uint8_t subIndex, void* val,
+                            OD_size_t len);
+
+/**
+ * Serve reads of OD entry from the snapshot
+ *
+ * Initializes IO extension of the entry with read from the published copy and original write. All sub-entries with
+ * data must lie inside regions of the snapshot. Entry must not have other IO extension.
+ *
+ * @param snap This object.
+ * @param entry Object Dictionary entry.
+ * @param extension Extension object, owned by application.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT if arguments are wrong or sub-entries are outside regions.
+ */
+CO_ReturnError_t CO_ODsnapshot_attach(CO_ODsnapshot_t* snap, OD_entry_t* entry, OD_extension_t* extension);
+
+/** @} */ /* CO_ODsnapshot */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* CO_OD_SNAPSHOT_H */
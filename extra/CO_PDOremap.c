@@ -0,0 +1,118 @@
+/*
+ * CANopen PDO remapping of remote devices, complete PDO configuration written as one pipelined SDO sequence.
+ *
+ * @file        CO_PDOremap.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_PDOremap.h"
+
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0)                                                              \
+    && (((CO_CONFIG_PDO) & (CO_CONFIG_RPDO_ENABLE | CO_CONFIG_TPDO_ENABLE)) != 0)
+
+/* Append step to the sequence */
+static void
+CO_PDOremap_add(CO_PDOremap_t* remap, uint16_t index, uint8_t subIndex, uint32_t value, uint8_t size,
+                bool_t optional) {
+    CO_PDOremap_step_t* step = &remap->steps[remap->stepCount];
+
+    step->index = index;
+    step->subIndex = subIndex;
+    step->value = value;
+    step->size = size;
+    step->optional = optional;
+    remap->stepCount++;
+}
+
+/* Step is finished, called from CO_SDOengine_process(). Submit the next step or finish the sequence. */
+static void
+CO_PDOremap_xferDone(void* object, CO_SDOengine_xfer_t* xfer) {
+    CO_PDOremap_t* remap = (CO_PDOremap_t*)object;
+    const CO_PDOremap_step_t* step = &remap->steps[remap->step];
+
+    if ((xfer->result < CO_SDO_RT_ok_communicationEnd)
+        && !(step->optional && (xfer->abortCode == CO_SDO_AB_SUB_UNKNOWN))) {
+        remap->result = xfer->result;
+        remap->abortCode = xfer->abortCode;
+    } else if ((remap->step + 1U) >= remap->stepCount) {
+        remap->result = CO_SDO_RT_ok_communicationEnd;
+    } else {
+        remap->step++;
+        step = &remap->steps[remap->step];
+        CO_SDOengine_setDownload(xfer, xfer->nodeId, step->index, step->subIndex, step->value, step->size);
+        if (CO_SDOengine_submit(remap->engine, xfer) == CO_ERROR_NO) {
+            return;
+        }
+        remap->result = CO_SDO_RT_wrongArguments;
+    }
+
+    if (remap->result != CO_SDO_RT_ok_communicationEnd) {
+        remap->errInfo = ((uint32_t)step->index << 8) | step->subIndex;
+    }
+    remap->busy = false;
+    if (remap->pFunctDone != NULL) {
+        remap->pFunctDone(remap->object, remap);
+    }
+}
+
+CO_ReturnError_t
+CO_PDOremap_start(CO_PDOremap_t* remap, CO_SDOengine_t* engine, uint8_t nodeId, bool_t isRPDO, uint16_t pdoNumber,
+                  const CO_PDO_config_t* config, void (*pFunctDone)(void* object, CO_PDOremap_t* remap),
+                  void* object) {
+    if ((remap == NULL) || (engine == NULL) || (config == NULL) || remap->busy || (nodeId < 1U) || (nodeId > 127U)
+        || (pdoNumber < 1U) || (pdoNumber > 512U) || (config->mappedObjectsCount > CO_PDO_MAX_MAPPED_ENTRIES)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    uint16_t commIndex = (isRPDO ? 0x1400U : 0x1800U) + pdoNumber - 1U;
+    uint16_t mapIndex = commIndex + 0x200U;
+
+    (void)memset(remap, 0, sizeof(CO_PDOremap_t));
+    remap->engine = engine;
+    remap->pFunctDone = pFunctDone;
+    remap->object = object;
+
+    /* PDO must be disabled for the mapping and for some communication parameters */
+    CO_PDOremap_add(remap, commIndex, 1, config->COB_ID | 0x80000000U, 4, false);
+    CO_PDOremap_add(remap, mapIndex, 0, 0, 1, false);
+    for (uint8_t i = 0; i < config->mappedObjectsCount; i++) {
+        CO_PDOremap_add(remap, mapIndex, i + 1U, config->map[i], 4, false);
+    }
+    CO_PDOremap_add(remap, mapIndex, 0, config->mappedObjectsCount, 1, false);
+    CO_PDOremap_add(remap, commIndex, 2, config->transmissionType, 1, false);
+    if (!isRPDO) {
+        CO_PDOremap_add(remap, commIndex, 3, config->inhibitTime, 2, config->inhibitTime == 0U);
+    }
+    CO_PDOremap_add(remap, commIndex, 5, config->eventTimer, 2, config->eventTimer == 0U);
+    if (!isRPDO) {
+        CO_PDOremap_add(remap, commIndex, 6, config->syncStartValue, 1, config->syncStartValue == 0U);
+    }
+    /* enable, if bit 31 is not set in config */
+    if ((config->COB_ID & 0x80000000U) == 0U) {
+        CO_PDOremap_add(remap, commIndex, 1, config->COB_ID, 4, false);
+    }
+
+    const CO_PDOremap_step_t* step = &remap->steps[0];
+    CO_SDOengine_setDownload(&remap->xfer, nodeId, step->index, step->subIndex, step->value, step->size);
+    remap->xfer.pFunctDone = CO_PDOremap_xferDone;
+    remap->xfer.object = remap;
+    if (CO_SDOengine_submit(engine, &remap->xfer) != CO_ERROR_NO) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    remap->result = CO_SDO_RT_waitingResponse;
+    remap->busy = true;
+    return CO_ERROR_NO;
+}
+
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_ENABLE && (CO_CONFIG_PDO) & ... */
@@ -0,0 +1,105 @@
+/**
+ * CANopen PDO remapping of remote devices, complete PDO configuration written as one pipelined SDO sequence.
+ *
+ * @file        CO_PDOremap.h
+ * @ingroup     CO_PDOremap
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_PDO_REMAP_H
+#define CO_PDO_REMAP_H
+
+#include "301/CO_PDO.h"
+#include "extra/CO_SDOengine.h"
+
+#if ((((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0)                                                             \
+     && (((CO_CONFIG_PDO) & (CO_CONFIG_RPDO_ENABLE | CO_CONFIG_TPDO_ENABLE)) != 0))                                    \
+    || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_PDOremap PDO remapping of remote devices
+ * Switch complete PDO configuration of a remote device with one call, remote counterpart of CO_PDO_configure().
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * CO_PDOremap_start() translates @ref CO_PDO_config_t into the sequence of SDO downloads, required for dynamic PDO
+ * configuration: disable the PDO, clear the mapping, write the map entries and their number, write the communication
+ * parameters and enable the PDO with the new COB-ID. Sequence runs on a @ref CO_SDOengine. Each step is submitted from
+ * the engine callback of the previous one, so the steps follow each other without waiting for the application loop.
+ * Re-configuring a PDO with four map entries takes about ten SDO round trips.
+ *
+ * Sequence stops at the first aborted step. PDO of the remote device then stays disabled, failed parameter and SDO
+ * abort code are reported. Optional communication parameters (inhibit time, event timer, SYNC start value), which are
+ * zero in the configuration and don't exist in the remote Object Dictionary, are skipped.
+ *
+ * All functions must be called from the thread, which processes the engine.
+ */
+
+/** Maximum number of SDO downloads in one sequence */
+#define CO_PDO_REMAP_STEPS (CO_PDO_MAX_MAPPED_ENTRIES + 8U)
+
+/** One SDO download of the sequence */
+typedef struct {
+    uint16_t index;   /**< Object Dictionary index */
+    uint8_t subIndex; /**< Object Dictionary sub-index */
+    uint8_t size;     /**< Size of the value, 1, 2 or 4 */
+    uint32_t value;   /**< Value */
+    bool_t optional;  /**< Step is skipped, if sub-index does not exist */
+} CO_PDOremap_step_t;
+
+/** PDO remapping object */
+typedef struct CO_PDOremap {
+    CO_SDOengine_t* engine;                       /**< From CO_PDOremap_start() */
+    CO_SDOengine_xfer_t xfer;                     /**< Transfer, submitted again for each step */
+    CO_PDOremap_step_t steps[CO_PDO_REMAP_STEPS]; /**< Sequence, prepared by CO_PDOremap_start() */
+    uint8_t stepCount;                            /**< Number of steps in the sequence */
+    uint8_t step;                                 /**< Current step */
+    volatile bool_t busy;                         /**< True, while sequence is running */
+    CO_SDO_return_t result;       /**< CO_SDO_RT_ok_communicationEnd or value below 0, when sequence is finished */
+    CO_SDO_abortCode_t abortCode; /**< SDO abort code of the failed step */
+    uint32_t errInfo;             /**< Failed parameter, (index << 8) | subIndex */
+    /** Optional callback, called from CO_SDOengine_process(), when sequence is finished */
+    void (*pFunctDone)(void* object, struct CO_PDOremap* remap);
+    void* object; /**< Object for pFunctDone */
+} CO_PDOremap_t;
+
+/**
+ * Start remapping of the remote PDO
+ *
+ * @param remap This object, must not be busy. It must stay valid until sequence is finished.
+ * @param engine SDO engine.
+ * @param nodeId Node-id of the remote device, 1..127.
+ * @param isRPDO True for RPDO (0x1400+, 0x1600+) and false for TPDO (0x1800+, 0x1A00+) of the remote device.
+ * @param pdoNumber PDO number, 1..512.
+ * @param config New configuration. inhibitTime and syncStartValue are ignored for RPDO.
+ * @param pFunctDone Callback, called when sequence is finished, may be NULL.
+ * @param object Object for pFunctDone.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_PDOremap_start(CO_PDOremap_t* remap, CO_SDOengine_t* engine, uint8_t nodeId, bool_t isRPDO,
+                                   uint16_t pdoNumber, const CO_PDO_config_t* config,
+                                   void (*pFunctDone)(void* object, CO_PDOremap_t* remap), void* object);
+
+/** @} */ /* CO_PDOremap */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_ENABLE && (CO_CONFIG_PDO) & ... */
+
+#endif /* CO_PDO_REMAP_H */
@@ -0,0 +1,307 @@
+/*
+ * CANopen SDO client asynchronous front-end, callbacks, futures and tasks on top of the SDO transaction engine.
+ *
+ * @file        CO_SDOasync.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_SDOasync.h"
+
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0
+
+CO_ReturnError_t
+CO_SDOasync_init(CO_SDOasync_t* async, CO_SDOengine_t* engine) {
+    if ((async == NULL) || (engine == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    (void)memset(async, 0, sizeof(CO_SDOasync_t));
+    async->engine = engine;
+    for (uint16_t i = CO_SDO_ASYNC_OPS; i > 0U; i--) {
+        CO_SDOasync_op_t* op = &async->ops[i - 1U];
+        op->async = async;
+        op->next = async->freeList;
+        async->freeList = op;
+    }
+
+    return CO_ERROR_NO;
+}
+
+void
+CO_SDOasync_initCallbackSignal(CO_SDOasync_t* async, void* object, void (*pFunctSignal)(void* object)) {
+    if (async != NULL) {
+        async->functSignalObject = object;
+        async->pFunctSignal = pFunctSignal;
+    }
+}
+
+/* Return operation to the pool */
+static void
+CO_SDOasync_free(CO_SDOasync_op_t* op) {
+    CO_SDOasync_t* async = op->async;
+
+    op->xfer.state = CO_SDOengine_idle;
+    op->task = NULL;
+    op->pFunctDone = NULL;
+    op->object = NULL;
+    op->detached = false;
+    op->next = async->freeList;
+    async->freeList = op;
+    async->used--;
+}
+
+/* Call task function and release operations, which were finished before it */
+static void
+CO_SDOasync_taskResume(CO_SDOasync_task_t* task) {
+    CO_SDOasync_op_t* op = task->finished;
+
+    task->finished = NULL;
+    /* task may end and be freed inside, don't use it after */
+    task->pFunct(task);
+
+    while (op != NULL) {
+        CO_SDOasync_op_t* next = op->next;
+        CO_SDOasync_free(op);
+        op = next;
+    }
+}
+
+/* Engine transfer is finished, called from CO_SDOengine_process() */
+static void
+CO_SDOasync_xferDone(void* object, CO_SDOengine_xfer_t* xfer) {
+    CO_SDOasync_op_t* op = (CO_SDOasync_op_t*)object;
+    CO_SDOasync_t* async = op->async;
+    CO_SDOasync_task_t* task = op->task;
+    (void)xfer;
+
+    async->finishedCount++;
+    if (op->xfer.result < CO_SDO_RT_ok_communicationEnd) {
+        async->failedCount++;
+    }
+
+    if (task != NULL) {
+        task->pending--;
+        if (op->xfer.result < CO_SDO_RT_ok_communicationEnd) {
+            task->failed++;
+        }
+        op->next = task->finished;
+        task->finished = op;
+        if (task->pending == 0U) {
+            CO_SDOasync_taskResume(task);
+        }
+    } else if (op->pFunctDone != NULL) {
+        op->pFunctDone(op->object, op);
+        CO_SDOasync_free(op);
+    } else if (op->detached) {
+        CO_SDOasync_free(op);
+    } else { /* MISRA C 2004 14.10 */
+    }
+}
+
+/* Take operation from the pool, prepare the transfer, return NULL, if pool is empty or arguments are wrong */
+static CO_SDOasync_op_t*
+CO_SDOasync_prepare(CO_SDOasync_t* async, uint8_t nodeId, uint16_t index, uint8_t subIndex, bool_t upload,
+                    size_t size) {
+    if ((async == NULL) || (async->freeList == NULL) || (nodeId < 1U) || (nodeId > 127U)
+        || (size > CO_SDO_ENGINE_DATA_SIZE)) {
+        return NULL;
+    }
+
+    CO_SDOasync_op_t* op = async->freeList;
+    async->freeList = op->next;
+    async->used++;
+    if (async->used > async->usedMax) {
+        async->usedMax = async->used;
+    }
+
+    CO_SDOengine_xfer_t* xfer = &op->xfer;
+    (void)memset(xfer, 0, sizeof(CO_SDOengine_xfer_t));
+    xfer->nodeId = nodeId;
+    xfer->index = index;
+    xfer->subIndex = subIndex;
+    xfer->upload = upload;
+    xfer->size = size;
+    xfer->pFunctDone = CO_SDOasync_xferDone;
+    xfer->object = op;
+    op->next = NULL;
+    return op;
+}
+
+/* Queue prepared operation in the engine */
+static CO_SDOasync_op_t*
+CO_SDOasync_submit(CO_SDOasync_op_t* op, CO_SDOasync_task_t* task,
+                   void (*pFunctDone)(void* object, CO_SDOasync_op_t* op), void* object) {
+    CO_SDOasync_t* async = op->async;
+
+    op->task = task;
+    op->pFunctDone = pFunctDone;
+    op->object = object;
+    if (CO_SDOengine_submit(async->engine, &op->xfer) != CO_ERROR_NO) {
+        CO_SDOasync_free(op);
+        return NULL;
+    }
+    if (task != NULL) {
+        task->pending++;
+    }
+    if (async->pFunctSignal != NULL) {
+        async->pFunctSignal(async->functSignalObject);
+    }
+    return op;
+}
+
+CO_SDOasync_op_t*
+CO_SDOasync_read(CO_SDOasync_t* async, uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                 void (*pFunctDone)(void* object, CO_SDOasync_op_t* op), void* object) {
+    CO_SDOasync_op_t* op = CO_SDOasync_prepare(async, nodeId, index, subIndex, true, 0);
+    return (op != NULL) ? CO_SDOasync_submit(op, NULL, pFunctDone, object) : NULL;
+}
+
+CO_SDOasync_op_t*
+CO_SDOasync_write(CO_SDOasync_t* async, uint8_t nodeId, uint16_t index, uint8_t subIndex, const uint8_t* data,
+                  size_t size, void (*pFunctDone)(void* object, CO_SDOasync_op_t* op), void* object) {
+    if ((data == NULL) && (size > 0U)) {
+        return NULL;
+    }
+    CO_SDOasync_op_t* op = CO_SDOasync_prepare(async, nodeId, index, subIndex, false, size);
+    if (op == NULL) {
+        return NULL;
+    }
+    if (size > 0U) {
+        (void)memcpy(op->xfer.data, data, size);
+    }
+    return CO_SDOasync_submit(op, NULL, pFunctDone, object);
+}
+
+CO_SDOasync_op_t*
+CO_SDOasync_writeValue(CO_SDOasync_t* async, uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t value,
+                       uint8_t size, void (*pFunctDone)(void* object, CO_SDOasync_op_t* op), void* object) {
+    CO_SDOasync_op_t* op = CO_SDOasync_prepare(async, nodeId, index, subIndex, false, 0);
+    if (op == NULL) {
+        return NULL;
+    }
+    CO_SDOengine_setDownload(&op->xfer, nodeId, index, subIndex, value, size);
+    return CO_SDOasync_submit(op, NULL, pFunctDone, object);
+}
+
+uint32_t
+CO_SDOasync_getValue(const CO_SDOasync_op_t* op) {
+    uint32_t value = 0;
+
+    if (CO_SDOasync_isOk(op)) {
+        size_t size = (op->xfer.size > 4U) ? 4U : op->xfer.size;
+        for (size_t i = 0; i < size; i++) {
+            value |= (uint32_t)op->xfer.data[i] << (8U * i);
+        }
+    }
+    return value;
+}
+
+void
+CO_SDOasync_release(CO_SDOasync_op_t* op) {
+    if ((op == NULL) || (op->task != NULL) || (op->pFunctDone != NULL) || op->detached) {
+        return;
+    }
+    if (CO_SDOasync_isDone(op)) {
+        CO_SDOasync_free(op);
+    } else {
+        op->detached = true;
+    }
+}
+
+CO_ReturnError_t
+CO_SDOasync_taskStart(CO_SDOasync_t* async, CO_SDOasync_task_t* task, void (*pFunct)(CO_SDOasync_task_t* task),
+                      void (*pFunctDone)(CO_SDOasync_task_t* task), void* object) {
+    if ((async == NULL) || (task == NULL) || (pFunct == NULL) || task->running) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    task->async = async;
+    task->pFunct = pFunct;
+    task->pFunctDone = pFunctDone;
+    task->object = object;
+    task->resume = 0;
+    task->pending = 0;
+    task->failed = 0;
+    task->finished = NULL;
+    task->running = true;
+    async->tasks++;
+
+    CO_SDOasync_taskResume(task);
+    return CO_ERROR_NO;
+}
+
+/* Queue prepared operation of the task, count it as failed, if it can not be started */
+static CO_SDOasync_op_t*
+CO_SDOasync_taskSubmit(CO_SDOasync_task_t* task, CO_SDOasync_op_t* op) {
+    if (op != NULL) {
+        op = CO_SDOasync_submit(op, task, NULL, NULL);
+    }
+    if ((op == NULL) && (task != NULL)) {
+        task->failed++;
+    }
+    return op;
+}
+
+CO_SDOasync_op_t*
+CO_SDOasync_taskRead(CO_SDOasync_task_t* task, uint8_t nodeId, uint16_t index, uint8_t subIndex) {
+    CO_SDOasync_op_t* op = NULL;
+
+    if (task != NULL) {
+        op = CO_SDOasync_prepare(task->async, nodeId, index, subIndex, true, 0);
+    }
+    return CO_SDOasync_taskSubmit(task, op);
+}
+
+CO_SDOasync_op_t*
+CO_SDOasync_taskWrite(CO_SDOasync_task_t* task, uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                      const uint8_t* data, size_t size) {
+    CO_SDOasync_op_t* op = NULL;
+
+    if ((task != NULL) && ((data != NULL) || (size == 0U))) {
+        op = CO_SDOasync_prepare(task->async, nodeId, index, subIndex, false, size);
+        if ((op != NULL) && (size > 0U)) {
+            (void)memcpy(op->xfer.data, data, size);
+        }
+    }
+    return CO_SDOasync_taskSubmit(task, op);
+}
+
+CO_SDOasync_op_t*
+CO_SDOasync_taskWriteValue(CO_SDOasync_task_t* task, uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                           uint32_t value, uint8_t size) {
+    CO_SDOasync_op_t* op = NULL;
+
+    if (task != NULL) {
+        op = CO_SDOasync_prepare(task->async, nodeId, index, subIndex, false, 0);
+        if (op != NULL) {
+            CO_SDOengine_setDownload(&op->xfer, nodeId, index, subIndex, value, size);
+        }
+    }
+    return CO_SDOasync_taskSubmit(task, op);
+}
+
+void
+CO_SDOasync_taskEnd(CO_SDOasync_task_t* task) {
+    if ((task == NULL) || !task->running) {
+        return;
+    }
+    task->resume = 0;
+    task->running = false;
+    task->async->tasks--;
+    if (task->pFunctDone != NULL) {
+        task->pFunctDone(task);
+    }
+}
+
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_ENABLE */
@@ -0,0 +1,315 @@
+/**
+ * CANopen SDO client asynchronous front-end, callbacks, futures and tasks on top of the SDO transaction engine.
+ *
+ * @file        CO_SDOasync.h
+ * @ingroup     CO_SDOasync
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_SDO_ASYNC_H
+#define CO_SDO_ASYNC_H
+
+#include "extra/CO_SDOengine.h"
+
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0) || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_SDOasync SDO asynchronous front-end
+ * SDO reads and writes without blocking, results are delivered by callbacks, futures or resumed tasks.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * Asynchronous object uses a @ref CO_SDOengine, for example co->SDOpool or an engine with own SDO clients. Each SDO
+ * read or write is an operation, which is taken from a fixed pool of @ref CO_SDO_ASYNC_OPS operations, so the
+ * application does not keep transfer objects itself. Operations are finished from CO_SDOengine_process(), which
+ * runs in the event loop (CO_process() for co->SDOpool), so any number of them may be outstanding at the same time
+ * without blocking the loop. All functions must be called from the thread, which processes the engine.
+ *
+ * Each operation finishes in one of the three ways:
+ * - Callback: pFunctDone is called with the finished operation. Operation is released after the callback returns.
+ * - Future: pFunctDone is NULL. Application checks CO_SDOasync_isDone(), reads the result and calls
+ *   CO_SDOasync_release(). Unfinished operation may also be released, then it is discarded when it finishes.
+ * - Task: operation is started with CO_SDOasync_taskRead() or similar. Task is a sequence of steps in one function,
+ *   written with the CO_SDOASYNC_BEGIN(), CO_SDOASYNC_AWAIT() and CO_SDOASYNC_END() macros, similar to a coroutine.
+ *   Task function returns at CO_SDOASYNC_AWAIT() and is called again, when all operations, started before it, are
+ *   finished. It continues after the CO_SDOASYNC_AWAIT() and may read the results of those operations. They are
+ *   released after the task function returns.
+ *
+ * Task function is re-entered from the top, so local variables are not preserved across CO_SDOASYNC_AWAIT(). State
+ * must be kept in the object, which contains the task, and switch statements must not span CO_SDOASYNC_AWAIT().
+ *
+ * @code{.c}
+ * typedef struct {
+ *     CO_SDOasync_task_t task;
+ *     uint8_t nodeId;
+ *     CO_SDOasync_op_t* type;
+ * } config_t;
+ *
+ * static void config_task(CO_SDOasync_task_t* task) {
+ *     config_t* cfg = (config_t*)task->object;
+ *     CO_SDOASYNC_BEGIN(task);
+ *     cfg->type = CO_SDOasync_taskRead(task, cfg->nodeId, 0x1000, 0);
+ *     CO_SDOASYNC_AWAIT(task);
+ *     if ((task->failed == 0U) && ((CO_SDOasync_getValue(cfg->type) & 0xFFFFU) == 402U)) {
+ *         (void)CO_SDOasync_taskWriteValue(task, cfg->nodeId, 0x6060, 0, 1, 1);
+ *         (void)CO_SDOasync_taskWriteValue(task, cfg->nodeId, 0x6081, 0, 10000, 4);
+ *         CO_SDOASYNC_AWAIT(task);
+ *     }
+ *     CO_SDOASYNC_END(task);
+ * }
+ * @endcode
+ */
+
+/** Number of operations in the pool of one asynchronous object. */
+#ifndef CO_SDO_ASYNC_OPS
+#define CO_SDO_ASYNC_OPS 256U
+#endif
+
+struct CO_SDOasync;
+struct CO_SDOasync_task;
+
+/** One SDO read or write. Result is in xfer.result and xfer.abortCode, uploaded data in xfer.data and xfer.size. */
+typedef struct CO_SDOasync_op {
+    CO_SDOengine_xfer_t xfer;         /**< Engine transfer. xfer.timeout_ms and xfer.blockEnable may be set
+                                           after the operation is started, before the engine is processed. */
+    struct CO_SDOasync* async;        /**< Owner of the operation */
+    struct CO_SDOasync_task* task;    /**< Task of the operation or NULL */
+    /** Optional callback, called from CO_SDOengine_process(), when operation is finished. */
+    void (*pFunctDone)(void* object, struct CO_SDOasync_op* op);
+    void* object;                     /**< Object for pFunctDone */
+    bool_t detached;                  /**< Released before finished, discard on finish */
+    struct CO_SDOasync_op* next;      /**< Internal list: free operations or finished operations of the task */
+} CO_SDOasync_op_t;
+
+/** Task, sequence of SDO operations in one function. Object must stay valid until the task is finished. */
+typedef struct CO_SDOasync_task {
+    struct CO_SDOasync* async; /**< From CO_SDOasync_taskStart() */
+    /** Task function, from CO_SDOasync_taskStart(). Called at start and each time, when all operations, started
+     * before CO_SDOASYNC_AWAIT(), are finished. */
+    void (*pFunct)(struct CO_SDOasync_task* task);
+    /** Optional callback, called at CO_SDOASYNC_END(). Task may be freed or started again from it. */
+    void (*pFunctDone)(struct CO_SDOasync_task* task);
+    void* object;                /**< Application object of the task, from CO_SDOasync_taskStart() */
+    uint16_t resume;             /**< Position of the last CO_SDOASYNC_AWAIT(), used by the macros */
+    uint16_t pending;            /**< Number of unfinished operations of the task */
+    uint16_t failed;             /**< Number of failed operations since start, including operations not started */
+    volatile bool_t running;     /**< True between CO_SDOasync_taskStart() and CO_SDOASYNC_END() */
+    CO_SDOasync_op_t* finished;  /**< Finished operations, released after the task function returns */
+} CO_SDOasync_task_t;
+
+/** SDO asynchronous object */
+typedef struct CO_SDOasync {
+    CO_SDOengine_t* engine;                /**< From CO_SDOasync_init() */
+    CO_SDOasync_op_t ops[CO_SDO_ASYNC_OPS]; /**< Pool of operations */
+    CO_SDOasync_op_t* freeList;            /**< First free operation */
+    uint16_t used;                         /**< Number of operations, which are not free */
+    uint16_t usedMax;                      /**< Largest number of used operations */
+    uint16_t tasks;                        /**< Number of running tasks */
+    uint32_t finishedCount;                /**< Number of finished operations */
+    uint32_t failedCount;                  /**< Number of finished operations with result below 0 */
+    void (*pFunctSignal)(void* object);    /**< From CO_SDOasync_initCallbackSignal() */
+    void* functSignalObject;               /**< From CO_SDOasync_initCallbackSignal() */
+} CO_SDOasync_t;
+
+/**
+ * Initialize SDO asynchronous object
+ *
+ * @param async This object will be initialized.
+ * @param engine Initialized SDO transaction engine, which will process the operations.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_SDOasync_init(CO_SDOasync_t* async, CO_SDOengine_t* engine);
+
+/**
+ * Initialize callback, which wakes the event loop
+ *
+ * Callback is called, when a new operation is queued, so the event loop can process the engine without waiting for
+ * its timer, for example with CO_epoll_signal(). Operations, started from callbacks or tasks inside
+ * CO_SDOengine_process(), are started by the same call of the engine, signal is redundant then.
+ *
+ * @param async This object.
+ * @param object Pointer to object, which will be passed to pFunctSignal(). Can be NULL.
+ * @param pFunctSignal Pointer to the callback function. Not called if NULL.
+ */
+void CO_SDOasync_initCallbackSignal(CO_SDOasync_t* async, void* object, void (*pFunctSignal)(void* object));
+
+/**
+ * Start SDO read
+ *
+ * @param async This object.
+ * @param nodeId Node-id of the SDO server, 1..127.
+ * @param index Object Dictionary index.
+ * @param subIndex Object Dictionary sub-index.
+ * @param pFunctDone Callback, called when operation is finished, or NULL for the future.
+ * @param object Object for pFunctDone.
+ *
+ * @return Operation or NULL, if arguments are wrong or pool is empty.
+ */
+CO_SDOasync_op_t* CO_SDOasync_read(CO_SDOasync_t* async, uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                   void (*pFunctDone)(void* object, CO_SDOasync_op_t* op), void* object);
+
+/**
+ * Start SDO write
+ *
+ * @param async This object.
+ * @param nodeId Node-id of the SDO server, 1..127.
+ * @param index Object Dictionary index.
+ * @param subIndex Object Dictionary sub-index.
+ * @param data Data to write, copied into the operation.
+ * @param size Size of data, at most @ref CO_SDO_ENGINE_DATA_SIZE.
+ * @param pFunctDone Callback, called when operation is finished, or NULL for the future.
+ * @param object Object for pFunctDone.
+ *
+ * @return Operation or NULL, if arguments are wrong or pool is empty.
+ */
+CO_SDOasync_op_t* CO_SDOasync_write(CO_SDOasync_t* async, uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                    const uint8_t* data, size_t size,
+                                    void (*pFunctDone)(void* object, CO_SDOasync_op_t* op), void* object);
+
+/**
+ * Start SDO write of a numeric value
+ *
+ * Same as CO_SDOasync_write(), value is written in little endian byte order, size is 1..4.
+ */
+CO_SDOasync_op_t* CO_SDOasync_writeValue(CO_SDOasync_t* async, uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                         uint32_t value, uint8_t size,
+                                         void (*pFunctDone)(void* object, CO_SDOasync_op_t* op), void* object);
+
+/**
+ * Check, if operation is finished
+ *
+ * @param op Operation.
+ *
+ * @return True, if finished. Result is in op->xfer.result and op->xfer.abortCode.
+ */
+static inline bool_t
+CO_SDOasync_isDone(const CO_SDOasync_op_t* op) {
+    return (op != NULL) && (op->xfer.state == CO_SDOengine_done);
+}
+
+/**
+ * Check, if operation finished successfully
+ *
+ * @param op Operation.
+ *
+ * @return True, if finished with CO_SDO_RT_ok_communicationEnd.
+ */
+static inline bool_t
+CO_SDOasync_isOk(const CO_SDOasync_op_t* op) {
+    return CO_SDOasync_isDone(op) && (op->xfer.result == CO_SDO_RT_ok_communicationEnd);
+}
+
+/**
+ * Get uploaded numeric value
+ *
+ * @param op Finished read operation.
+ *
+ * @return First up to four bytes of uploaded data in little endian byte order, 0 if operation failed.
+ */
+uint32_t CO_SDOasync_getValue(const CO_SDOasync_op_t* op);
+
+/**
+ * Release operation
+ *
+ * Only for operations without callback and task. Finished operation is returned to the pool. Unfinished operation is
+ * returned to the pool, when it finishes, its result is discarded. Operation must not be used after this call.
+ *
+ * @param op Operation.
+ */
+void CO_SDOasync_release(CO_SDOasync_op_t* op);
+
+/**
+ * Start task
+ *
+ * Task function is called immediately, until its first CO_SDOASYNC_AWAIT() or CO_SDOASYNC_END().
+ *
+ * @param async This object.
+ * @param task Task object, must not be running.
+ * @param pFunct Task function.
+ * @param pFunctDone Optional callback, called at the end of the task.
+ * @param object Application object, available in task->object.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_SDOasync_taskStart(CO_SDOasync_t* async, CO_SDOasync_task_t* task,
+                                       void (*pFunct)(CO_SDOasync_task_t* task),
+                                       void (*pFunctDone)(CO_SDOasync_task_t* task), void* object);
+
+/**
+ * Start SDO read from the task
+ *
+ * Same as CO_SDOasync_read(). Result is available after the next CO_SDOASYNC_AWAIT(). If operation can not be
+ * started, task->failed is incremented and NULL is returned.
+ */
+CO_SDOasync_op_t* CO_SDOasync_taskRead(CO_SDOasync_task_t* task, uint8_t nodeId, uint16_t index, uint8_t subIndex);
+
+/**
+ * Start SDO write from the task
+ *
+ * Same as CO_SDOasync_write(). Result is available after the next CO_SDOASYNC_AWAIT(). If operation can not be
+ * started, task->failed is incremented and NULL is returned.
+ */
+CO_SDOasync_op_t* CO_SDOasync_taskWrite(CO_SDOasync_task_t* task, uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                        const uint8_t* data, size_t size);
+
+/**
+ * Start SDO write of a numeric value from the task
+ *
+ * Same as CO_SDOasync_writeValue(). Result is available after the next CO_SDOASYNC_AWAIT(). If operation can not be
+ * started, task->failed is incremented and NULL is returned.
+ */
+CO_SDOasync_op_t* CO_SDOasync_taskWriteValue(CO_SDOasync_task_t* task, uint8_t nodeId, uint16_t index,
+                                             uint8_t subIndex, uint32_t value, uint8_t size);
+
+/**
+ * Finish the task, used by CO_SDOASYNC_END().
+ *
+ * @param task Task object.
+ */
+void CO_SDOasync_taskEnd(CO_SDOasync_task_t* task);
+
+/** Begin of the task function, after declarations. */
+#define CO_SDOASYNC_BEGIN(task)                                                                                        \
+    switch ((task)->resume) {                                                                                          \
+        case 0:
+
+/** Return from the task function, until all operations started before are finished, then continue after it. Task
+ * function enters the code after it through the switch of CO_SDOASYNC_BEGIN(), never by falling through. */
+#define CO_SDOASYNC_AWAIT(task)                                                                                        \
+    (task)->resume = (uint16_t)__LINE__;                                                                               \
+    if ((task)->pending > 0U) {                                                                                        \
+        return;                                                                                                        \
+    }                                                                                                                  \
+    if ((task)->pending > 0U) {                                                                                        \
+        case __LINE__:;                                                                                                \
+    }
+
+/** End of the task function. Waits for unfinished operations, then task is finished and its pFunctDone is called. */
+#define CO_SDOASYNC_END(task)                                                                                          \
+    CO_SDOASYNC_AWAIT(task)                                                                                            \
+    }                                                                                                                  \
+    CO_SDOasync_taskEnd(task)
+
+/** @} */ /* CO_SDOasync */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_ENABLE */
+
+#endif /* CO_SDO_ASYNC_H */
@@ -0,0 +1,222 @@
+/*
+ * CANopen SDO bulk transfer.
+ *
+ * @file        CO_SDObulk.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_SDObulk.h"
+
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_BLOCK) != 0
+
+/* Return true, if server abort in the block initiate phase means, that block transfer is not supported. Aborts, which
+ * are specific to the object, would be repeated by segmented transfer. */
+static bool_t
+CO_SDObulk_blockRefused(CO_SDO_abortCode_t abortCode) {
+    return (abortCode != CO_SDO_AB_NOT_EXIST) && (abortCode != CO_SDO_AB_SUB_UNKNOWN)
+           && (abortCode != CO_SDO_AB_READONLY) && (abortCode != CO_SDO_AB_WRITEONLY);
+}
+
+/* Copy data from the source into the SDO client fifo, until fifo is full or source is empty */
+static void
+CO_SDObulk_fill(CO_SDObulk_t* bulk) {
+    for (;;) {
+        if (bulk->chunkPos == bulk->chunkCount) {
+            if (bulk->sourceEnd) {
+                break;
+            }
+            bulk->chunkPos = 0;
+            bulk->chunkCount = bulk->source(bulk->object, bulk->chunk, sizeof(bulk->chunk));
+            if (bulk->chunkCount == 0U) {
+                bulk->sourceEnd = true;
+                break;
+            }
+        }
+        size_t count = CO_SDOclientDownloadBufWrite(bulk->SDO_C, &bulk->chunk[bulk->chunkPos],
+                                                    bulk->chunkCount - bulk->chunkPos);
+        if (count == 0U) {
+            break;
+        }
+        bulk->chunkPos += count;
+    }
+}
+
+/* Pass received data from the SDO client fifo to the sink. Return false, if sink failed. */
+static bool_t
+CO_SDObulk_drain(CO_SDObulk_t* bulk) {
+    size_t count;
+
+    while ((count = CO_SDOclientUploadBufRead(bulk->SDO_C, bulk->chunk, sizeof(bulk->chunk))) > 0U) {
+        if (!bulk->sink(bulk->object, bulk->chunk, count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void
+CO_SDObulk_reset(CO_SDObulk_t* bulk, CO_SDOclient_t* SDO_C, uint16_t index, uint8_t subIndex, bool_t upload,
+                 uint16_t timeoutTime_ms, bool_t blockEnable, void* object) {
+    bulk->SDO_C = SDO_C;
+    bulk->index = index;
+    bulk->subIndex = subIndex;
+    bulk->upload = upload;
+    bulk->sizeIndicated = 0;
+    bulk->timeout_ms = timeoutTime_ms;
+    bulk->source = NULL;
+    bulk->sink = NULL;
+    bulk->object = object;
+    bulk->block = blockEnable;
+    bulk->fallback = false;
+    bulk->sourceEnd = false;
+    bulk->chunkCount = 0;
+    bulk->chunkPos = 0;
+    bulk->sizeTransferred = 0;
+    bulk->abortCode = CO_SDO_AB_NONE;
+}
+
+CO_SDO_return_t
+CO_SDObulk_download(CO_SDObulk_t* bulk, CO_SDOclient_t* SDO_C, uint16_t index, uint8_t subIndex, size_t sizeIndicated,
+                    uint16_t timeoutTime_ms, bool_t blockEnable, CO_SDObulk_source_t source, void* object) {
+    if ((bulk == NULL) || (SDO_C == NULL) || (source == NULL)) {
+        return CO_SDO_RT_wrongArguments;
+    }
+
+    CO_SDObulk_reset(bulk, SDO_C, index, subIndex, false, timeoutTime_ms, blockEnable, object);
+    bulk->sizeIndicated = sizeIndicated;
+    bulk->source = source;
+
+    CO_SDO_return_t ret = CO_SDOclientDownloadInitiate(SDO_C, index, subIndex, sizeIndicated, timeoutTime_ms,
+                                                       blockEnable);
+    /* small transfers are not started in block mode, see CO_CONFIG_SDO_CLI_PST */
+    bulk->block = blockEnable && (SDO_C->state == CO_SDO_ST_DOWNLOAD_BLK_INITIATE_REQ);
+    if ((ret == CO_SDO_RT_ok_communicationEnd) && !bulk->block) {
+        CO_SDObulk_fill(bulk);
+    }
+    return ret;
+}
+
+CO_SDO_return_t
+CO_SDObulk_upload(CO_SDObulk_t* bulk, CO_SDOclient_t* SDO_C, uint16_t index, uint8_t subIndex, uint16_t timeoutTime_ms,
+                  bool_t blockEnable, CO_SDObulk_sink_t sink, void* object) {
+    if ((bulk == NULL) || (SDO_C == NULL) || (sink == NULL)) {
+        return CO_SDO_RT_wrongArguments;
+    }
+
+    CO_SDObulk_reset(bulk, SDO_C, index, subIndex, true, timeoutTime_ms, blockEnable, object);
+    bulk->sink = sink;
+
+    return CO_SDOclientUploadInitiate(SDO_C, index, subIndex, timeoutTime_ms, blockEnable);
+}
+
+/* Process download, return value of CO_SDOclientDownload() */
+static CO_SDO_return_t
+CO_SDObulk_processDownload(CO_SDObulk_t* bulk, uint32_t timeDifference_us, bool_t abort,
+                           CO_SDO_abortCode_t* abortCode, uint32_t* timerNext_us) {
+    CO_SDOclient_t* SDO_C = bulk->SDO_C;
+    bool_t initiating = (SDO_C->state == CO_SDO_ST_DOWNLOAD_BLK_INITIATE_REQ)
+                        || (SDO_C->state == CO_SDO_ST_DOWNLOAD_BLK_INITIATE_RSP);
+
+    /* data stay in the source until server confirms block transfer, they may be needed for segmented transfer */
+    if (!initiating) {
+        CO_SDObulk_fill(bulk);
+    }
+    bool_t bufferPartial = !bulk->sourceEnd || (bulk->chunkPos < bulk->chunkCount);
+    CO_SDO_return_t ret = CO_SDOclientDownload(SDO_C, timeDifference_us, abort, bufferPartial, abortCode,
+                                               &bulk->sizeTransferred, timerNext_us);
+
+    if (initiating && (ret == CO_SDO_RT_endedWithServerAbort) && CO_SDObulk_blockRefused(*abortCode)) {
+        /* restart as segmented transfer */
+        bulk->block = false;
+        bulk->fallback = true;
+        ret = CO_SDOclientDownloadInitiate(SDO_C, bulk->index, bulk->subIndex, bulk->sizeIndicated,
+                                           bulk->timeout_ms, false);
+        if (ret == CO_SDO_RT_ok_communicationEnd) {
+            CO_SDObulk_fill(bulk);
+            ret = CO_SDOclientDownload(SDO_C, 0, false, !bulk->sourceEnd || (bulk->chunkPos < bulk->chunkCount),
+                                       abortCode, &bulk->sizeTransferred, timerNext_us);
+        }
+    } else if (initiating && (ret > CO_SDO_RT_ok_communicationEnd)
+               && (SDO_C->state == CO_SDO_ST_DOWNLOAD_BLK_SUBBLOCK_REQ)) {
+        /* block transfer confirmed, start with the first sub-block */
+        CO_SDObulk_fill(bulk);
+        ret = CO_SDO_RT_blockDownldInProgress;
+    } else { /* MISRA C 2004 14.10 */
+    }
+    return ret;
+}
+
+/* Process upload, return value of CO_SDOclientUpload() */
+static CO_SDO_return_t
+CO_SDObulk_processUpload(CO_SDObulk_t* bulk, uint32_t timeDifference_us, bool_t abort, CO_SDO_abortCode_t* abortCode,
+                         uint32_t* timerNext_us) {
+    CO_SDOclient_t* SDO_C = bulk->SDO_C;
+    bool_t initiating = (SDO_C->state == CO_SDO_ST_UPLOAD_BLK_INITIATE_REQ)
+                        || (SDO_C->state == CO_SDO_ST_UPLOAD_BLK_INITIATE_RSP);
+
+    CO_SDO_return_t ret = CO_SDOclientUpload(SDO_C, timeDifference_us, abort, abortCode, &bulk->sizeIndicated,
+                                             &bulk->sizeTransferred, timerNext_us);
+
+    if (initiating && (ret == CO_SDO_RT_endedWithServerAbort) && CO_SDObulk_blockRefused(*abortCode)) {
+        /* restart as segmented transfer */
+        bulk->block = false;
+        bulk->fallback = true;
+        ret = CO_SDOclientUploadInitiate(SDO_C, bulk->index, bulk->subIndex, bulk->timeout_ms, false);
+        if (ret == CO_SDO_RT_ok_communicationEnd) {
+            ret = CO_SDOclientUpload(SDO_C, 0, false, abortCode, NULL, NULL, timerNext_us);
+        }
+    }
+
+    /* data must not be read from the fifo during sub-block */
+    if ((ret >= CO_SDO_RT_ok_communicationEnd) && (ret != CO_SDO_RT_blockUploadInProgress)) {
+        if (!CO_SDObulk_drain(bulk)) {
+            *abortCode = CO_SDO_AB_DATA_TRANSF;
+            (void)CO_SDOclientUpload(SDO_C, 0, true, abortCode, NULL, NULL, NULL);
+            ret = CO_SDO_RT_endedWithClientAbort;
+        } else if (ret == CO_SDO_RT_uploadDataBufferFull) {
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_FLAG_TIMERNEXT) != 0
+            /* buffer is empty again, continue without delay */
+            if (timerNext_us != NULL) {
+                *timerNext_us = 0;
+            }
+#endif
+        } else { /* MISRA C 2004 14.10 */
+        }
+    }
+    return ret;
+}
+
+CO_SDO_return_t
+CO_SDObulk_process(CO_SDObulk_t* bulk, uint32_t timeDifference_us, bool_t abort, uint32_t* timerNext_us) {
+    CO_SDO_abortCode_t abortCode = CO_SDO_AB_GENERAL;
+    CO_SDO_return_t ret;
+
+    if ((bulk == NULL) || (bulk->SDO_C == NULL)) {
+        return CO_SDO_RT_wrongArguments;
+    }
+
+    if (bulk->upload) {
+        ret = CO_SDObulk_processUpload(bulk, timeDifference_us, abort, &abortCode, timerNext_us);
+    } else {
+        ret = CO_SDObulk_processDownload(bulk, timeDifference_us, abort, &abortCode, timerNext_us);
+    }
+
+    if (ret <= CO_SDO_RT_ok_communicationEnd) {
+        bulk->abortCode = (ret == CO_SDO_RT_ok_communicationEnd) ? CO_SDO_AB_NONE : abortCode;
+        CO_SDOclientClose(bulk->SDO_C);
+    }
+    return ret;
+}
+
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_BLOCK */
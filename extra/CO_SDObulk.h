@@ -0,0 +1,159 @@
+/**
+ * CANopen SDO bulk transfer, block transfer of large data streams with fallback to segmented transfer.
+ *
+ * @file        CO_SDObulk.h
+ * @ingroup     CO_SDObulk
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_SDO_BULK_H
+#define CO_SDO_BULK_H
+
+#include "301/CO_SDOclient.h"
+
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_BLOCK) != 0) || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_SDObulk SDO bulk transfer
+ * Download or upload of data streams of any size, for example parameter images or firmware (object 0x1F50).
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * Data are not kept in memory. At download, data are read with the source callback (for example from file) into a
+ * staging buffer of @ref CO_SDO_BULK_CHUNK_SIZE bytes and copied into the fifo of the SDO client as space gets free. At
+ * upload, received data are passed to the sink callback. The fifo of the SDO client (CO_CONFIG_SDO_CLI_BUFFER_SIZE)
+ * only needs to hold one block, 127 * 7 = 889 bytes for the largest block.
+ *
+ * Block transfer is used with CRC, if enabled. If the server refuses block transfer in the initiate phase (SDO abort,
+ * for example @ref CO_SDO_AB_CMD), transfer is automatically restarted as segmented transfer. At download no data are
+ * passed to the SDO client before the server confirms block transfer, so nothing must be read from the source twice.
+ *
+ * SDO client must be initialized and configured with CO_SDOclient_setup() by the application. Block size for block
+ * upload is set with CO_SDOclient_setBlockSize(). CO_SDObulk_process() is non-blocking, it is called cyclically. If it
+ * returns @ref CO_SDO_RT_blockDownldInProgress, it should be called again immediately after CAN messages are passed to
+ * the driver.
+ */
+
+/** Size of the staging buffer between the source or sink callback and the SDO client fifo. */
+#ifndef CO_SDO_BULK_CHUNK_SIZE
+#define CO_SDO_BULK_CHUNK_SIZE 4096U
+#endif
+
+/**
+ * Source of download data.
+ *
+ * @param object Object from CO_SDObulk_download().
+ * @param buf Buffer for data.
+ * @param count Size of the buffer.
+ *
+ * @return Number of bytes written into buf, 0 at the end of data.
+ */
+typedef size_t (*CO_SDObulk_source_t)(void* object, uint8_t* buf, size_t count);
+
+/**
+ * Sink for uploaded data.
+ *
+ * @param object Object from CO_SDObulk_upload().
+ * @param buf Received data.
+ * @param count Number of bytes in buf.
+ *
+ * @return True on success. If false, transfer is aborted with @ref CO_SDO_AB_DATA_TRANSF.
+ */
+typedef bool_t (*CO_SDObulk_sink_t)(void* object, const uint8_t* buf, size_t count);
+
+/** SDO bulk transfer object */
+typedef struct {
+    CO_SDOclient_t* SDO_C;       /**< From CO_SDObulk_download() or CO_SDObulk_upload() */
+    uint16_t index;              /**< Object Dictionary index */
+    uint8_t subIndex;            /**< Object Dictionary sub-index */
+    bool_t upload;               /**< True for upload */
+    size_t sizeIndicated;        /**< Download: size of data, 0 if unknown. Upload: size indicated by the server. */
+    uint16_t timeout_ms;         /**< SDO timeout */
+    CO_SDObulk_source_t source;  /**< Download source */
+    CO_SDObulk_sink_t sink;      /**< Upload sink */
+    void* object;                /**< Object for source or sink */
+    bool_t block;                /**< Block transfer is requested or in progress */
+    bool_t fallback;             /**< Server refused block transfer, segmented transfer is used */
+    bool_t sourceEnd;            /**< Download: source returned 0 */
+    size_t chunkCount;           /**< Number of bytes in chunk */
+    size_t chunkPos;             /**< Position of the next byte in chunk */
+    size_t sizeTransferred;      /**< Number of bytes transferred */
+    CO_SDO_abortCode_t abortCode; /**< SDO abort code of the failed transfer */
+    uint8_t chunk[CO_SDO_BULK_CHUNK_SIZE]; /**< Staging buffer */
+} CO_SDObulk_t;
+
+/**
+ * Initiate bulk download.
+ *
+ * @param bulk This object.
+ * @param SDO_C Initialized SDO client, configured for the server.
+ * @param index Index of object in object dictionary in remote node.
+ * @param subIndex Subindex of object in object dictionary in remote node.
+ * @param sizeIndicated Size of data, if known, otherwise 0. Server verifies it.
+ * @param timeoutTime_ms Timeout time for SDO communication in milliseconds.
+ * @param blockEnable Try block transfer, otherwise use segmented transfer.
+ * @param source Callback, which provides the data.
+ * @param object Object for source.
+ *
+ * @return #CO_SDO_return_t, CO_SDO_RT_ok_communicationEnd on success.
+ */
+CO_SDO_return_t CO_SDObulk_download(CO_SDObulk_t* bulk, CO_SDOclient_t* SDO_C, uint16_t index, uint8_t subIndex,
+                                    size_t sizeIndicated, uint16_t timeoutTime_ms, bool_t blockEnable,
+                                    CO_SDObulk_source_t source, void* object);
+
+/**
+ * Initiate bulk upload.
+ *
+ * @param bulk This object.
+ * @param SDO_C Initialized SDO client, configured for the server.
+ * @param index Index of object in object dictionary in remote node.
+ * @param subIndex Subindex of object in object dictionary in remote node.
+ * @param timeoutTime_ms Timeout time for SDO communication in milliseconds.
+ * @param blockEnable Try block transfer, otherwise use segmented transfer.
+ * @param sink Callback, which receives the data.
+ * @param object Object for sink.
+ *
+ * @return #CO_SDO_return_t, CO_SDO_RT_ok_communicationEnd on success.
+ */
+CO_SDO_return_t CO_SDObulk_upload(CO_SDObulk_t* bulk, CO_SDOclient_t* SDO_C, uint16_t index, uint8_t subIndex,
+                                  uint16_t timeoutTime_ms, bool_t blockEnable, CO_SDObulk_sink_t sink, void* object);
+
+/**
+ * Process bulk transfer.
+ *
+ * Function must be called cyclically until it returns <=0. At the end bulk->sizeTransferred contains the number of
+ * transferred bytes and bulk->abortCode the reason of the error. SDO client is closed at the end.
+ *
+ * @param bulk This object.
+ * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param abort If true, transfer is aborted with @ref CO_SDO_AB_GENERAL.
+ * @param [out] timerNext_us info to OS - see CO_process(). Ignored if NULL.
+ *
+ * @return #CO_SDO_return_t. If less than 0, then error occurred. If 0, transfer ended successfully. If greater than 0,
+ * then transfer is in progress.
+ */
+CO_SDO_return_t CO_SDObulk_process(CO_SDObulk_t* bulk, uint32_t timeDifference_us, bool_t abort,
+                                   uint32_t* timerNext_us);
+
+/** @} */ /* CO_SDObulk */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_BLOCK */
+
+#endif /* CO_SDO_BULK_H */
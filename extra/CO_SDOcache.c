@@ -0,0 +1,141 @@
+/*
+ * CANopen SDO client cache for static objects of remote nodes.
+ *
+ * @file        CO_SDOcache.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_SDOcache.h"
+
+/* Find entry, return NULL if not found */
+static CO_SDOcache_entry_t*
+CO_SDOcache_find(CO_SDOcache_t* cache, uint8_t nodeId, uint16_t index, uint8_t subIndex) {
+    for (uint16_t i = 0; i < CO_SDO_CACHE_ENTRIES; i++) {
+        CO_SDOcache_entry_t* entry = &cache->entries[i];
+        if ((entry->nodeId == nodeId) && (entry->index == index) && (entry->subIndex == subIndex)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void
+CO_SDOcache_init(CO_SDOcache_t* cache, CO_SDOcache_static_t isStatic, void* object) {
+    if (cache == NULL) {
+        return;
+    }
+    (void)memset(cache, 0, sizeof(CO_SDOcache_t));
+    cache->isStatic = (isStatic != NULL) ? isStatic : CO_SDOcache_isIdentity;
+    cache->object = object;
+}
+
+bool_t
+CO_SDOcache_isIdentity(void* object, uint8_t nodeId, uint16_t index, uint8_t subIndex) {
+    (void)object;
+    (void)nodeId;
+    (void)subIndex;
+    return (index == 0x1000U) || (index == 0x1008U) || (index == 0x1009U) || (index == 0x100AU)
+           || (index == 0x1018U);
+}
+
+bool_t
+CO_SDOcache_get(CO_SDOcache_t* cache, uint8_t nodeId, uint16_t index, uint8_t subIndex, uint8_t* buf,
+                size_t bufSize, size_t* size) {
+    if ((cache == NULL) || (buf == NULL) || (nodeId == 0U) || !cache->isStatic(cache->object, nodeId, index, subIndex)) {
+        return false;
+    }
+
+    CO_SDOcache_entry_t* entry = CO_SDOcache_find(cache, nodeId, index, subIndex);
+    if ((entry == NULL) || (entry->size > bufSize)) {
+        cache->misses++;
+        return false;
+    }
+
+    (void)memcpy(buf, entry->data, entry->size);
+    if (size != NULL) {
+        *size = entry->size;
+    }
+    cache->hits++;
+    return true;
+}
+
+void
+CO_SDOcache_put(CO_SDOcache_t* cache, uint8_t nodeId, uint16_t index, uint8_t subIndex, const uint8_t* data,
+                size_t size) {
+    if ((cache == NULL) || (data == NULL) || (nodeId == 0U) || (nodeId > 127U) || (size == 0U)
+        || (size > CO_SDO_CACHE_DATA_SIZE) || !cache->isStatic(cache->object, nodeId, index, subIndex)) {
+        return;
+    }
+
+    CO_SDOcache_entry_t* entry = CO_SDOcache_find(cache, nodeId, index, subIndex);
+    if (entry == NULL) {
+        entry = CO_SDOcache_find(cache, 0, 0, 0);
+    }
+    if (entry == NULL) {
+        /* cache is full, replace entries in round robin */
+        entry = &cache->entries[cache->replaceNext];
+        cache->replaceNext = (uint16_t)((cache->replaceNext + 1U) % CO_SDO_CACHE_ENTRIES);
+    }
+
+    entry->index = index;
+    entry->subIndex = subIndex;
+    entry->nodeId = nodeId;
+    entry->size = (uint8_t)size;
+    entry->reserved = 0;
+    (void)memcpy(entry->data, data, size);
+}
+
+void
+CO_SDOcache_invalidate(CO_SDOcache_t* cache, uint8_t nodeId) {
+    if (cache == NULL) {
+        return;
+    }
+    for (uint16_t i = 0; i < CO_SDO_CACHE_ENTRIES; i++) {
+        CO_SDOcache_entry_t* entry = &cache->entries[i];
+        if ((nodeId == 0U) || (entry->nodeId == nodeId)) {
+            (void)memset(entry, 0, sizeof(CO_SDOcache_entry_t));
+        }
+    }
+}
+
+void
+CO_SDOcache_verify(CO_SDOcache_t* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    for (uint16_t i = 0; i < CO_SDO_CACHE_ENTRIES; i++) {
+        CO_SDOcache_entry_t* entry = &cache->entries[i];
+        if ((entry->nodeId > 127U) || (entry->size == 0U) || (entry->size > CO_SDO_CACHE_DATA_SIZE)
+            || !cache->isStatic(cache->object, entry->nodeId, entry->index, entry->subIndex)) {
+            (void)memset(entry, 0, sizeof(CO_SDOcache_entry_t));
+        }
+    }
+    cache->replaceNext = 0;
+}
+
+void
+CO_SDOcache_nmtChanged(uint8_t nodeId, uint8_t idx, CO_NMT_internalState_t NMTstate, void* object) {
+    (void)idx;
+    if ((NMTstate == CO_NMT_INITIALIZING) || (NMTstate == CO_NMT_UNKNOWN)) {
+        CO_SDOcache_invalidate((CO_SDOcache_t*)object, nodeId);
+    }
+}
+
+void
+CO_SDOcache_remoteReset(uint8_t nodeId, uint8_t idx, void* object) {
+    (void)idx;
+    if (nodeId != 0U) {
+        CO_SDOcache_invalidate((CO_SDOcache_t*)object, nodeId);
+    }
+}
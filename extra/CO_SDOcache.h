@@ -0,0 +1,184 @@
+/**
+ * CANopen SDO client cache for static objects of remote nodes.
+ *
+ * @file        CO_SDOcache.h
+ * @ingroup     CO_SDOcache
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_SDO_CACHE_H
+#define CO_SDO_CACHE_H
+
+#include "301/CO_driver.h"
+#include "301/CO_NMT_Heartbeat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_SDOcache SDO cache
+ * Read-through cache for SDO uploads of constant objects, for example identity of the remote node.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * Objects like device type (0x1000), device name (0x1008), hardware and software version (0x1009, 0x100A) and
+ * identity (0x1018) do not change while the remote node is running, but tools and gateway read them again and again,
+ * each time with an SDO round trip. If cache is attached to the SDO client with CO_SDOclient_setCache(),
+ * CO_SDOclientUploadInitiate() first searches the cache. On hit, data are copied into the SDO client buffer and the
+ * following CO_SDOclientUpload() finishes immediately, without CAN communication. Successful uploads of static objects
+ * are stored into the cache.
+ *
+ * Which objects are static is decided by the callback from CO_SDOcache_init(). Default is
+ * CO_SDOcache_isIdentity(), application may use object access type "const" or "ro" from the EDS of the remote node.
+ *
+ * Entries of the node must be invalidated, when the node is reset or replaced. Cache of the CANopen object is
+ * attached to its heartbeat consumer with CO_HBconsumer_setSDOcache() inside CO_CANopenInit(), which invalidates the
+ * monitored node on boot-up and on heartbeat timeout. Heartbeat consumer callbacks are not used for this, they stay
+ * free for the application. Caches, which are not attached to a heartbeat consumer, may use CO_SDOcache_nmtChanged()
+ * or CO_SDOcache_remoteReset() as heartbeat consumer callback. After sending NMT reset command, application calls
+ * CO_SDOcache_invalidate().
+ *
+ * #CO_SDOcache_t.entries is a plain array without pointers, it may be stored between runs (for example with
+ * @ref CO_storage or into a file) and loaded back before the first use. CO_SDOcache_verify() must be called after
+ * loading.
+ */
+
+/** Number of cached objects (all nodes together). When cache is full, oldest entries are replaced. */
+#ifndef CO_SDO_CACHE_ENTRIES
+#define CO_SDO_CACHE_ENTRIES 64U
+#endif
+
+/** Maximum size of cached object in bytes, larger objects are not cached. */
+#ifndef CO_SDO_CACHE_DATA_SIZE
+#define CO_SDO_CACHE_DATA_SIZE 26U
+#endif
+
+/** One cached object */
+typedef struct {
+    uint16_t index;                       /**< Object Dictionary index */
+    uint8_t subIndex;                     /**< Object Dictionary sub-index */
+    uint8_t nodeId;                       /**< Node-ID of the SDO server, 0 for free entry */
+    uint8_t size;                         /**< Size of data in bytes, 1..CO_SDO_CACHE_DATA_SIZE */
+    uint8_t reserved;                     /**< Not used, 0 */
+    uint8_t data[CO_SDO_CACHE_DATA_SIZE]; /**< Uploaded data */
+} CO_SDOcache_entry_t;
+
+/**
+ * Callback, which decides, if object of the remote node is static and may be cached.
+ *
+ * @param object Object from CO_SDOcache_init().
+ * @param nodeId Node-ID of the SDO server.
+ * @param index Object Dictionary index.
+ * @param subIndex Object Dictionary sub-index.
+ *
+ * @return true, if object does not change while the node is running.
+ */
+typedef bool_t (*CO_SDOcache_static_t)(void* object, uint8_t nodeId, uint16_t index, uint8_t subIndex);
+
+/** SDO cache object */
+typedef struct {
+    CO_SDOcache_entry_t entries[CO_SDO_CACHE_ENTRIES]; /**< Cached objects, may be persisted between runs */
+    CO_SDOcache_static_t isStatic;                     /**< From CO_SDOcache_init() */
+    void* object;                                      /**< From CO_SDOcache_init() */
+    uint16_t replaceNext;                              /**< Entry to replace, when cache is full */
+    uint32_t hits;                                     /**< Number of uploads served from the cache */
+    uint32_t misses;                                   /**< Number of uploads of static objects not in the cache */
+} CO_SDOcache_t;
+
+/**
+ * Initialize SDO cache, all entries are free.
+ *
+ * @param cache This object will be initialized.
+ * @param isStatic Callback, which decides, which objects are cached. If NULL, CO_SDOcache_isIdentity() is used.
+ * @param object Object for isStatic.
+ */
+void CO_SDOcache_init(CO_SDOcache_t* cache, CO_SDOcache_static_t isStatic, void* object);
+
+/**
+ * Default #CO_SDOcache_static_t: objects 0x1000, 0x1008, 0x1009, 0x100A and 0x1018.
+ *
+ * @return true for identity objects.
+ */
+bool_t CO_SDOcache_isIdentity(void* object, uint8_t nodeId, uint16_t index, uint8_t subIndex);
+
+/**
+ * Get cached object.
+ *
+ * @param cache This object.
+ * @param nodeId Node-ID of the SDO server.
+ * @param index Object Dictionary index.
+ * @param subIndex Object Dictionary sub-index.
+ * @param [out] buf Buffer for data.
+ * @param bufSize Size of buf.
+ * @param [out] size Size of data.
+ *
+ * @return true, if object was found and copied into buf.
+ */
+bool_t CO_SDOcache_get(CO_SDOcache_t* cache, uint8_t nodeId, uint16_t index, uint8_t subIndex, uint8_t* buf,
+                       size_t bufSize, size_t* size);
+
+/**
+ * Store uploaded object into the cache. Objects, which are not static or are too large, are ignored.
+ *
+ * @param cache This object.
+ * @param nodeId Node-ID of the SDO server.
+ * @param index Object Dictionary index.
+ * @param subIndex Object Dictionary sub-index.
+ * @param data Uploaded data.
+ * @param size Size of data.
+ */
+void CO_SDOcache_put(CO_SDOcache_t* cache, uint8_t nodeId, uint16_t index, uint8_t subIndex, const uint8_t* data,
+                     size_t size);
+
+/**
+ * Remove all cached objects of the node.
+ *
+ * @param cache This object.
+ * @param nodeId Node-ID of the SDO server, 0 for all nodes.
+ */
+void CO_SDOcache_invalidate(CO_SDOcache_t* cache, uint8_t nodeId);
+
+/**
+ * Remove invalid entries, for example after entries were loaded from the storage.
+ *
+ * @param cache This object.
+ */
+void CO_SDOcache_verify(CO_SDOcache_t* cache);
+
+/**
+ * Heartbeat consumer callback, see CO_HBconsumer_initCallbackNmtChanged(). Invalidates the node on boot-up and on
+ * heartbeat timeout.
+ *
+ * @param nodeId Node-ID of the remote node.
+ * @param idx Index of the monitored node, not used.
+ * @param NMTstate New NMT state of the remote node.
+ * @param object Pointer to #CO_SDOcache_t.
+ */
+void CO_SDOcache_nmtChanged(uint8_t nodeId, uint8_t idx, CO_NMT_internalState_t NMTstate, void* object);
+
+/**
+ * Heartbeat consumer callback, see CO_HBconsumer_initCallbackRemoteReset(). Invalidates the node on boot-up.
+ *
+ * @param nodeId Node-ID of the remote node.
+ * @param idx Index of the monitored node, not used.
+ * @param object Pointer to #CO_SDOcache_t.
+ */
+void CO_SDOcache_remoteReset(uint8_t nodeId, uint8_t idx, void* object);
+
+/** @} */ /* CO_SDOcache */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* CO_SDO_CACHE_H */
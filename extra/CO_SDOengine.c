@@ -0,0 +1,339 @@
+/*
+ * CANopen SDO transaction engine.
+ *
+ * @file        CO_SDOengine.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#define OD_DEFINITION
+#include "extra/CO_SDOengine.h"
+
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0
+
+/* Initial SDO client parameters for CO_SDOclient_init(), all channels start disabled and are configured with
+ * CO_SDOclient_setup() for each transfer. Values are only read. */
+static uint8_t CO_SDOengine_maxSubIndex = 3;
+static uint32_t CO_SDOengine_COB_IDdisabled = 0x80000000UL;
+static uint8_t CO_SDOengine_nodeIdNone = 0;
+
+static OD_obj_record_t CO_SDOengine_1280[4] = {
+    {.dataOrig = &CO_SDOengine_maxSubIndex, .subIndex = 0, .attribute = ODA_SDO_R, .dataLength = 1},
+    {.dataOrig = &CO_SDOengine_COB_IDdisabled, .subIndex = 1, .attribute = ODA_SDO_R | ODA_MB, .dataLength = 4},
+    {.dataOrig = &CO_SDOengine_COB_IDdisabled, .subIndex = 2, .attribute = ODA_SDO_R | ODA_MB, .dataLength = 4},
+    {.dataOrig = &CO_SDOengine_nodeIdNone, .subIndex = 3, .attribute = ODA_SDO_R, .dataLength = 1}};
+
+CO_ReturnError_t
+CO_SDOengine_initPool(CO_SDOengine_t* engine, CO_SDOclient_t* clients, uint8_t channelCount,
+                      uint16_t timeoutDefault_ms) {
+    /* verify arguments */
+    if ((engine == NULL) || (clients == NULL) || (channelCount == 0U) || (channelCount > CO_SDO_ENGINE_CHANNELS)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    (void)memset(engine, 0, sizeof(CO_SDOengine_t));
+    engine->channelCount = channelCount;
+    engine->timeoutDefault_ms = timeoutDefault_ms;
+
+    for (uint8_t i = 0; i < channelCount; i++) {
+        engine->channels[i].client = &clients[i];
+    }
+
+    return CO_ERROR_NO;
+}
+
+CO_ReturnError_t
+CO_SDOengine_init(CO_SDOengine_t* engine, CO_SDOclient_t* clients, uint8_t channelCount, CO_CANmodule_t* CANdevRx,
+                  uint16_t CANdevRxIdx, CO_CANmodule_t* CANdevTx, uint16_t CANdevTxIdx, uint16_t timeoutDefault_ms) {
+    /* verify arguments */
+    if ((CANdevRx == NULL) || (CANdevTx == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    CO_ReturnError_t ret = CO_SDOengine_initPool(engine, clients, channelCount, timeoutDefault_ms);
+    if (ret != CO_ERROR_NO) {
+        return ret;
+    }
+
+    for (uint8_t i = 0; i < channelCount; i++) {
+        CO_SDOengine_channel_t* ch = &engine->channels[i];
+
+        /* each channel has own OD entry, because SDO client may attach an OD extension to it */
+        ch->paramEntry.index = (uint16_t)OD_H1280_SDO_CLIENT_1_PARAM + i;
+        ch->paramEntry.subEntriesCount = 4;
+        ch->paramEntry.odObjectType = (uint8_t)ODT_REC;
+        ch->paramEntry.odObject = CO_SDOengine_1280;
+        ch->paramEntry.extension = NULL;
+
+        ret = CO_SDOclient_init(ch->client, NULL, &ch->paramEntry, 0, CANdevRx, CANdevRxIdx + i, CANdevTx,
+                                CANdevTxIdx + i, NULL);
+        if (ret != CO_ERROR_NO) {
+            return ret;
+        }
+    }
+
+    return CO_ERROR_NO;
+}
+
+#if ((CO_CONFIG_SDO_CLI)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0
+void
+CO_SDOengine_initCallbackPre(CO_SDOengine_t* engine, void* object, void (*pFunctSignal)(void* object)) {
+    if (engine != NULL) {
+        for (uint8_t i = 0; i < engine->channelCount; i++) {
+            CO_SDOclient_initCallbackPre(engine->channels[i].client, object, pFunctSignal);
+        }
+    }
+}
+#endif
+
+/* Return true, if transfer can be submitted */
+static bool_t
+CO_SDOengine_xferValid(const CO_SDOengine_xfer_t* xfer) {
+    return (xfer != NULL) && (xfer->nodeId >= 1U) && (xfer->nodeId <= 127U) && (xfer->state != CO_SDOengine_queued)
+           && (xfer->state != CO_SDOengine_active) && (xfer->upload || (xfer->size <= CO_SDO_ENGINE_DATA_SIZE));
+}
+
+CO_ReturnError_t
+CO_SDOengine_submit(CO_SDOengine_t* engine, CO_SDOengine_xfer_t* xfer) {
+    if ((engine == NULL) || !CO_SDOengine_xferValid(xfer)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    xfer->state = CO_SDOengine_queued;
+    xfer->result = CO_SDO_RT_waitingResponse;
+    xfer->abortCode = CO_SDO_AB_NONE;
+    xfer->next = NULL;
+    if (engine->queueTail == NULL) {
+        engine->queueHead = xfer;
+    } else {
+        engine->queueTail->next = xfer;
+    }
+    engine->queueTail = xfer;
+
+    return CO_ERROR_NO;
+}
+
+/* Transfer of a batch is finished */
+static void
+CO_SDOengine_batchItemDone(void* object, CO_SDOengine_xfer_t* xfer) {
+    CO_SDOengine_batch_t* batch = (CO_SDOengine_batch_t*)object;
+
+    batch->pending--;
+    if (xfer->result < CO_SDO_RT_ok_communicationEnd) {
+        batch->failed++;
+    }
+    if (batch->pFunctItem != NULL) {
+        batch->pFunctItem(batch->object, batch, xfer);
+    }
+    if ((batch->pending == 0U) && (batch->pFunctDone != NULL)) {
+        batch->pFunctDone(batch->object, batch);
+    }
+}
+
+CO_ReturnError_t
+CO_SDOengine_submitBatch(CO_SDOengine_t* engine, CO_SDOengine_batch_t* batch) {
+    if ((engine == NULL) || (batch == NULL) || (batch->xfers == NULL) || (batch->count == 0U)
+        || (batch->pending != 0U)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    for (uint16_t i = 0; i < batch->count; i++) {
+        if (!CO_SDOengine_xferValid(&batch->xfers[i])) {
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    batch->pending = batch->count;
+    batch->failed = 0;
+    for (uint16_t i = 0; i < batch->count; i++) {
+        CO_SDOengine_xfer_t* xfer = &batch->xfers[i];
+        xfer->pFunctDone = CO_SDOengine_batchItemDone;
+        xfer->object = batch;
+        (void)CO_SDOengine_submit(engine, xfer);
+    }
+
+    return CO_ERROR_NO;
+}
+
+void
+CO_SDOengine_setDownload(CO_SDOengine_xfer_t* xfer, uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t value,
+                         uint8_t size) {
+    if (xfer == NULL) {
+        return;
+    }
+    xfer->nodeId = nodeId;
+    xfer->index = index;
+    xfer->subIndex = subIndex;
+    xfer->upload = false;
+    xfer->size = (size > 4U) ? 4U : size;
+    for (uint8_t i = 0; i < xfer->size; i++) {
+        xfer->data[i] = (uint8_t)(value >> (8U * i));
+    }
+}
+
+/* Finish transfer on the channel and release the channel */
+static void
+CO_SDOengine_finish(CO_SDOengine_t* engine, CO_SDOengine_channel_t* ch, CO_SDO_return_t result,
+                    CO_SDO_abortCode_t abortCode) {
+    CO_SDOengine_xfer_t* xfer = ch->xfer;
+
+    CO_SDOclientClose(ch->client);
+    ch->xfer = NULL;
+    engine->activeCount--;
+    engine->nodeBusy[xfer->nodeId >> 5] &= ~(1UL << (xfer->nodeId & 0x1FU));
+
+    xfer->result = result;
+    xfer->abortCode = abortCode;
+    xfer->state = CO_SDOengine_done;
+    if (xfer->pFunctDone != NULL) {
+        xfer->pFunctDone(xfer->object, xfer);
+    }
+}
+
+/* Process one active channel */
+static void
+CO_SDOengine_processChannel(CO_SDOengine_t* engine, CO_SDOengine_channel_t* ch, uint32_t timeDifference_us,
+                            uint32_t* timerNext_us) {
+    CO_SDOengine_xfer_t* xfer = ch->xfer;
+    CO_SDO_abortCode_t abortCode = CO_SDO_AB_NONE;
+    CO_SDO_return_t ret;
+
+    if (xfer->upload) {
+        size_t sizeIndicated = 0;
+        size_t sizeTransferred = 0;
+        ret = CO_SDOclientUpload(ch->client, timeDifference_us, false, &abortCode, &sizeIndicated, &sizeTransferred,
+                                 timerNext_us);
+
+        /* empty the buffer into the transfer, when it is full or when communication ends */
+        if ((ret == CO_SDO_RT_uploadDataBufferFull) || (ret == CO_SDO_RT_ok_communicationEnd)) {
+            size_t space = CO_SDO_ENGINE_DATA_SIZE - xfer->size;
+            xfer->size += CO_SDOclientUploadBufRead(ch->client, &xfer->data[xfer->size], space);
+
+            if (CO_fifo_getOccupied(&ch->client->bufFifo) > 0U) {
+                /* data does not fit, abort the transfer */
+                abortCode = CO_SDO_AB_OUT_OF_MEM;
+                (void)CO_SDOclientUpload(ch->client, 0, true, &abortCode, NULL, NULL, NULL);
+                CO_SDOengine_finish(engine, ch, CO_SDO_RT_endedWithClientAbort, CO_SDO_AB_OUT_OF_MEM);
+                return;
+            }
+        }
+    } else {
+        size_t sizeTransferred = 0;
+        ret = CO_SDOclientDownload(ch->client, timeDifference_us, false, false, &abortCode, &sizeTransferred,
+                                   timerNext_us);
+    }
+
+    if (ret <= CO_SDO_RT_ok_communicationEnd) {
+        CO_SDOengine_finish(engine, ch, ret, abortCode);
+    }
+}
+
+/* Start transfer on the channel, return false, if it failed and is already finished */
+static bool_t
+CO_SDOengine_start(CO_SDOengine_t* engine, CO_SDOengine_channel_t* ch, CO_SDOengine_xfer_t* xfer) {
+    uint16_t timeout_ms = (xfer->timeout_ms != 0U) ? xfer->timeout_ms : engine->timeoutDefault_ms;
+    CO_SDO_return_t ret;
+
+    ch->xfer = xfer;
+    engine->activeCount++;
+    engine->nodeBusy[xfer->nodeId >> 5] |= 1UL << (xfer->nodeId & 0x1FU);
+    xfer->state = CO_SDOengine_active;
+
+    ret = CO_SDOclient_setup(ch->client, CO_CAN_ID_SDO_CLI + xfer->nodeId, CO_CAN_ID_SDO_SRV + xfer->nodeId,
+                             xfer->nodeId);
+    if (ret == CO_SDO_RT_ok_communicationEnd) {
+        if (xfer->upload) {
+            xfer->size = 0;
+            ret = CO_SDOclientUploadInitiate(ch->client, xfer->index, xfer->subIndex, timeout_ms, xfer->blockEnable);
+        } else {
+            ret = CO_SDOclientDownloadInitiate(ch->client, xfer->index, xfer->subIndex, xfer->size, timeout_ms,
+                                               xfer->blockEnable);
+            if (ret == CO_SDO_RT_ok_communicationEnd) {
+                (void)CO_SDOclientDownloadBufWrite(ch->client, xfer->data, xfer->size);
+            }
+        }
+    }
+
+    if (ret != CO_SDO_RT_ok_communicationEnd) {
+        CO_SDOengine_finish(engine, ch, ret, CO_SDO_AB_GENERAL);
+        return false;
+    }
+    return true;
+}
+
+/* Return true, if transfer to the node is active */
+static bool_t
+CO_SDOengine_nodeBusy(const CO_SDOengine_t* engine, uint8_t nodeId) {
+    return (engine->nodeBusy[nodeId >> 5] & (1UL << (nodeId & 0x1FU))) != 0U;
+}
+
+uint16_t
+CO_SDOengine_process(CO_SDOengine_t* engine, uint32_t timeDifference_us, uint32_t* timerNext_us) {
+    uint16_t count = 0;
+
+    if (engine == NULL) {
+        return 0;
+    }
+
+    /* process active transfers */
+    for (uint8_t i = 0; i < engine->channelCount; i++) {
+        CO_SDOengine_channel_t* ch = &engine->channels[i];
+        if (ch->xfer != NULL) {
+            CO_SDOengine_processChannel(engine, ch, timeDifference_us, timerNext_us);
+        }
+    }
+
+    /* start queued transfers on free channels, keep order of transfers to the same node */
+    CO_SDOengine_xfer_t* prev = NULL;
+    CO_SDOengine_xfer_t* xfer = engine->queueHead;
+    while ((xfer != NULL) && (engine->activeCount < engine->channelCount)) {
+        CO_SDOengine_xfer_t* next = xfer->next;
+
+        if (CO_SDOengine_nodeBusy(engine, xfer->nodeId)) {
+            prev = xfer;
+        } else {
+            /* remove from the queue */
+            if (prev == NULL) {
+                engine->queueHead = next;
+            } else {
+                prev->next = next;
+            }
+            if (engine->queueTail == xfer) {
+                engine->queueTail = prev;
+            }
+            xfer->next = NULL;
+
+            CO_SDOengine_channel_t* ch = NULL;
+            for (uint8_t i = 0; i < engine->channelCount; i++) {
+                if (engine->channels[i].xfer == NULL) {
+                    ch = &engine->channels[i];
+                    break;
+                }
+            }
+            if (CO_SDOengine_start(engine, ch, xfer)) {
+                /* send the first segment immediately */
+                CO_SDOengine_processChannel(engine, ch, 0, timerNext_us);
+            }
+            /* callback of a finished transfer may have modified the queue, start from its new head */
+            prev = NULL;
+            next = engine->queueHead;
+        }
+        xfer = next;
+    }
+
+    for (xfer = engine->queueHead; xfer != NULL; xfer = xfer->next) {
+        count++;
+    }
+
+    return count + engine->activeCount;
+}
+
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_ENABLE */
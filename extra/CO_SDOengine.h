@@ -0,0 +1,236 @@
+/**
+ * CANopen SDO transaction engine, parallel SDO client transfers to several nodes.
+ *
+ * @file        CO_SDOengine.h
+ * @ingroup     CO_SDOengine
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_SDO_ENGINE_H
+#define CO_SDO_ENGINE_H
+
+#include "301/CO_SDOclient.h"
+
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_SDO_CLI_ENABLE) != 0) || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_SDOengine SDO transaction engine
+ * Queue of SDO transfers, processed by several SDO client channels in parallel.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * Application prepares CO_SDOengine_xfer_t objects and submits them with CO_SDOengine_submit(). Engine keeps them in
+ * a FIFO queue. Each channel (own @ref CO_SDOclient_t with own CAN receive and transmit buffer) processes one transfer
+ * at a time. At most one transfer per node is active, so requests to the same node are processed in order, while
+ * requests to different nodes are on the bus at the same time.
+ *
+ * Engine runs from CO_SDOengine_process(), which is nonblocking and should be called cyclically with time difference
+ * from the monotonic clock. SDO timeouts are counted from that time. Other CAN messages, received by the same CAN
+ * module, are passed to their own CO_CANrxBufferInit() callbacks and are not affected by the engine.
+ *
+ * Channels are re-configured with CO_SDOclient_setup() for each transfer. Local transfers (to own node-id) are not
+ * supported. Engine either initializes own SDO clients without the Object Dictionary (CO_SDOengine_init()), or uses a
+ * pool of SDO clients, which are already initialized from the Object Dictionary, objects 0x1280..0x12FF
+ * (CO_SDOengine_initPool()). With CO_CONFIG_SDO_CLI_POOL the pool of CANopen object is processed by CO_process().
+ */
+
+/** Maximum number of SDO client channels in one engine, each needs one CAN receive and one CAN transmit buffer. */
+#ifndef CO_SDO_ENGINE_CHANNELS
+#define CO_SDO_ENGINE_CHANNELS 16U
+#endif
+
+/** Size of data buffer in one transfer. Larger uploads are aborted with @ref CO_SDO_AB_OUT_OF_MEM. */
+#ifndef CO_SDO_ENGINE_DATA_SIZE
+#define CO_SDO_ENGINE_DATA_SIZE 32U
+#endif
+
+/** State of one transfer */
+typedef enum {
+    CO_SDOengine_idle = 0,   /**< Not submitted yet, or finished and read by the application */
+    CO_SDOengine_queued = 1, /**< Waiting in the queue */
+    CO_SDOengine_active = 2, /**< Processed by the channel */
+    CO_SDOengine_done = 3    /**< Finished, see result and abortCode */
+} CO_SDOengine_state_t;
+
+/** One SDO transfer. Object must stay valid until finished. */
+typedef struct CO_SDOengine_xfer {
+    uint8_t nodeId;          /**< Node-id of the SDO server, 1..127 */
+    uint16_t index;          /**< Object Dictionary index */
+    uint8_t subIndex;        /**< Object Dictionary sub-index */
+    bool_t upload;           /**< True: read data from the server, false: write data to the server */
+    bool_t blockEnable;      /**< Try block transfer */
+    uint16_t timeout_ms;     /**< SDO timeout, 0 for the engine default */
+    size_t size;             /**< Download: size of data. Upload: size of received data. */
+    uint8_t data[CO_SDO_ENGINE_DATA_SIZE]; /**< Download: data to write. Upload: received data. */
+    /** Optional callback, called from CO_SDOengine_process(), when transfer is finished. Application may submit the
+     * same or other transfer from it. */
+    void (*pFunctDone)(void* object, struct CO_SDOengine_xfer* xfer);
+    void* object;                         /**< Object for pFunctDone */
+    volatile CO_SDOengine_state_t state; /**< Set by the engine */
+    CO_SDO_return_t result;               /**< CO_SDO_RT_ok_communicationEnd or value below 0, set by the engine */
+    CO_SDO_abortCode_t abortCode;         /**< SDO abort code, if result is below 0, set by the engine */
+    struct CO_SDOengine_xfer* next;       /**< Internal queue */
+} CO_SDOengine_xfer_t;
+
+/** Batch of SDO transfers, submitted together with CO_SDOengine_submitBatch(). Object must stay valid until finished.
+ */
+typedef struct CO_SDOengine_batch {
+    CO_SDOengine_xfer_t* xfers; /**< Array of transfers, prepared by the application */
+    uint16_t count;             /**< Number of transfers in xfers */
+    /** Optional callback, called from CO_SDOengine_process() after each transfer of the batch is finished. Result is in
+     * xfer->result and xfer->abortCode. */
+    void (*pFunctItem)(void* object, struct CO_SDOengine_batch* batch, CO_SDOengine_xfer_t* xfer);
+    /** Optional callback, called from CO_SDOengine_process() after the last transfer of the batch is finished. */
+    void (*pFunctDone)(void* object, struct CO_SDOengine_batch* batch);
+    void* object;              /**< Object for pFunctItem and pFunctDone */
+    volatile uint16_t pending; /**< Number of unfinished transfers, set by the engine, 0 when batch is finished */
+    uint16_t failed;           /**< Number of transfers with result below 0, set by the engine */
+} CO_SDOengine_batch_t;
+
+/** One SDO client channel */
+typedef struct {
+    CO_SDOclient_t* client;    /**< SDO client object */
+    OD_entry_t paramEntry;     /**< Initial SDO client parameters, for CO_SDOclient_init() */
+    CO_SDOengine_xfer_t* xfer; /**< Active transfer or NULL */
+} CO_SDOengine_channel_t;
+
+/** SDO engine object */
+typedef struct {
+    CO_SDOengine_channel_t channels[CO_SDO_ENGINE_CHANNELS]; /**< SDO client channels */
+    uint8_t channelCount;                                    /**< From CO_SDOengine_init() */
+    uint16_t timeoutDefault_ms;                              /**< From CO_SDOengine_init() */
+    CO_SDOengine_xfer_t* queueHead;                          /**< First queued transfer */
+    CO_SDOengine_xfer_t* queueTail;                          /**< Last queued transfer */
+    uint16_t activeCount;                                    /**< Number of active transfers */
+    uint32_t nodeBusy[4];                                    /**< Bit for each node-id with active transfer */
+} CO_SDOengine_t;
+
+/**
+ * Initialize SDO engine object with own SDO clients
+ *
+ * @param engine This object will be initialized.
+ * @param clients Array of channelCount SDO client objects, they will be initialized without Object Dictionary.
+ * @param channelCount Number of parallel transfers, 1..@ref CO_SDO_ENGINE_CHANNELS.
+ * @param CANdevRx CAN device for SDO client reception.
+ * @param CANdevRxIdx Index of the first of channelCount receive buffers in the above CAN device.
+ * @param CANdevTx CAN device for SDO client transmission.
+ * @param CANdevTxIdx Index of the first of channelCount transmit buffers in the above CAN device.
+ * @param timeoutDefault_ms SDO timeout for transfers with timeout_ms equal to 0.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_SDOengine_init(CO_SDOengine_t* engine, CO_SDOclient_t* clients, uint8_t channelCount,
+                                   CO_CANmodule_t* CANdevRx, uint16_t CANdevRxIdx, CO_CANmodule_t* CANdevTx,
+                                   uint16_t CANdevTxIdx, uint16_t timeoutDefault_ms);
+
+/**
+ * Initialize SDO engine object with a pool of existing SDO clients
+ *
+ * SDO clients must be initialized with CO_SDOclient_init(), usually from the Object Dictionary entries 0x1280..0x12FF.
+ * Engine configures them with CO_SDOclient_setup() for each transfer, so they must not be used by other parts of the
+ * application. Dynamic configuration of the clients through the Object Dictionary is overridden by the engine.
+ *
+ * @param engine This object will be initialized.
+ * @param clients Array of channelCount initialized SDO client objects.
+ * @param channelCount Number of parallel transfers, 1..@ref CO_SDO_ENGINE_CHANNELS.
+ * @param timeoutDefault_ms SDO timeout for transfers with timeout_ms equal to 0.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_SDOengine_initPool(CO_SDOengine_t* engine, CO_SDOclient_t* clients, uint8_t channelCount,
+                                       uint16_t timeoutDefault_ms);
+
+#if (((CO_CONFIG_SDO_CLI)&CO_CONFIG_FLAG_CALLBACK_PRE) != 0) || defined CO_DOXYGEN
+/**
+ * Initialize engine callback function.
+ *
+ * Function initializes optional callback function, which should immediately start processing of
+ * CO_SDOengine_process(). Callback is called after SDO response is received from the CAN bus, see
+ * CO_SDOclient_initCallbackPre().
+ *
+ * @param engine This object.
+ * @param object Pointer to object, which will be passed to pFunctSignal(). Can be NULL
+ * @param pFunctSignal Pointer to the callback function. Not called if NULL.
+ */
+void CO_SDOengine_initCallbackPre(CO_SDOengine_t* engine, void* object, void (*pFunctSignal)(void* object));
+#endif
+
+/**
+ * Submit SDO transfer
+ *
+ * Transfer is added to the end of the queue. It is started by CO_SDOengine_process(), when a channel is free and no
+ * other transfer to the same node is active.
+ *
+ * @param engine This object.
+ * @param xfer Transfer with nodeId, index, subIndex, upload and, for download, size and data set. Must not be queued
+ * or active.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_SDOengine_submit(CO_SDOengine_t* engine, CO_SDOengine_xfer_t* xfer);
+
+/**
+ * Submit batch of SDO transfers
+ *
+ * All transfers of the batch are added to the end of the queue in array order, or none, if any of them is not valid.
+ * Transfers to different nodes run in parallel, transfers to the same node one after another, without waiting for the
+ * application between them. Engine uses pFunctDone and object of the transfers, they must not be set by the
+ * application. Results are reported with the callbacks of the batch.
+ *
+ * @param engine This object.
+ * @param batch Batch with xfers, count and optional callbacks set. Must not be pending.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_SDOengine_submitBatch(CO_SDOengine_t* engine, CO_SDOengine_batch_t* batch);
+
+/**
+ * Prepare SDO download of a numeric value
+ *
+ * @param xfer Transfer to prepare, must not be queued or active.
+ * @param nodeId Node-id of the SDO server.
+ * @param index Object Dictionary index.
+ * @param subIndex Object Dictionary sub-index.
+ * @param value Value, written in little endian byte order.
+ * @param size Size of the value in bytes, 1..4.
+ */
+void CO_SDOengine_setDownload(CO_SDOengine_xfer_t* xfer, uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                              uint32_t value, uint8_t size);
+
+/**
+ * Process SDO engine
+ *
+ * Function processes active transfers, marks finished transfers as @ref CO_SDOengine_done, calls their pFunctDone
+ * and starts queued transfers on free channels. Function is nonblocking. CAN messages are only queued by
+ * CO_CANsend(), so driver may need to flush them after this function.
+ *
+ * @param engine This object.
+ * @param timeDifference_us Time difference from previous function call in microseconds, from the monotonic clock.
+ * @param [out] timerNext_us info to OS - see CO_process(). Can be NULL.
+ *
+ * @return Number of queued and active transfers.
+ */
+uint16_t CO_SDOengine_process(CO_SDOengine_t* engine, uint32_t timeDifference_us, uint32_t* timerNext_us);
+
+/** @} */ /* CO_SDOengine */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_SDO_CLI) & CO_CONFIG_SDO_CLI_ENABLE */
+
+#endif /* CO_SDO_ENGINE_H */
@@ -0,0 +1,129 @@
+/*
+ * CANopen SDO round trip time estimation for remote nodes.
+ *
+ * @file        CO_SDOrtt.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_SDOrtt.h"
+
+/* Get statistics of the node, NULL for invalid arguments */
+static CO_SDOrtt_node_t*
+CO_SDOrtt_node(const CO_SDOrtt_t* rtt, uint8_t nodeId) {
+    if ((rtt == NULL) || (nodeId == 0U) || (nodeId > CO_SDO_RTT_NODES)) {
+        return NULL;
+    }
+    return (CO_SDOrtt_node_t*)&rtt->nodes[nodeId - 1U];
+}
+
+void
+CO_SDOrtt_init(CO_SDOrtt_t* rtt, uint16_t minTimeout_ms, uint16_t maxTimeout_ms, uint8_t maxRetries) {
+    if (rtt == NULL) {
+        return;
+    }
+    (void)memset(rtt, 0, sizeof(CO_SDOrtt_t));
+    rtt->minTimeout_us = (uint32_t)minTimeout_ms * 1000U;
+    rtt->maxTimeout_us = (uint32_t)maxTimeout_ms * 1000U;
+    if (rtt->maxTimeout_us < rtt->minTimeout_us) {
+        rtt->maxTimeout_us = rtt->minTimeout_us;
+    }
+    rtt->maxRetries = maxRetries;
+}
+
+void
+CO_SDOrtt_reset(CO_SDOrtt_t* rtt, uint8_t nodeId) {
+    if (rtt == NULL) {
+        return;
+    }
+    if (nodeId == 0U) {
+        (void)memset(rtt->nodes, 0, sizeof(rtt->nodes));
+    } else {
+        CO_SDOrtt_node_t* node = CO_SDOrtt_node(rtt, nodeId);
+        if (node != NULL) {
+            (void)memset(node, 0, sizeof(CO_SDOrtt_node_t));
+        }
+    }
+}
+
+void
+CO_SDOrtt_sample(CO_SDOrtt_t* rtt, uint8_t nodeId, uint32_t rtt_us) {
+    CO_SDOrtt_node_t* node = CO_SDOrtt_node(rtt, nodeId);
+    if (node == NULL) {
+        return;
+    }
+
+    if (node->samples == 0U) {
+        node->srtt_us = rtt_us;
+        node->rttvar_us = rtt_us / 2U;
+        node->rttMin_us = rtt_us;
+        node->rttMax_us = rtt_us;
+    } else {
+        uint32_t diff = (node->srtt_us > rtt_us) ? (node->srtt_us - rtt_us) : (rtt_us - node->srtt_us);
+        node->rttvar_us = node->rttvar_us - (node->rttvar_us / 4U) + (diff / 4U);
+        node->srtt_us = node->srtt_us - (node->srtt_us / 8U) + (rtt_us / 8U);
+        if (rtt_us < node->rttMin_us) {
+            node->rttMin_us = rtt_us;
+        }
+        if (rtt_us > node->rttMax_us) {
+            node->rttMax_us = rtt_us;
+        }
+    }
+    if (node->samples < UINT32_MAX) {
+        node->samples++;
+    }
+}
+
+uint32_t
+CO_SDOrtt_retryTimeout_us(const CO_SDOrtt_t* rtt, uint8_t nodeId, uint32_t timeout_us) {
+    const CO_SDOrtt_node_t* node = CO_SDOrtt_node(rtt, nodeId);
+    if ((node == NULL) || (node->samples == 0U)) {
+        return timeout_us;
+    }
+
+    uint64_t rto = (uint64_t)node->srtt_us + (4U * (uint64_t)node->rttvar_us);
+    if (rto < rtt->minTimeout_us) {
+        rto = rtt->minTimeout_us;
+    } else if (rto > rtt->maxTimeout_us) {
+        rto = rtt->maxTimeout_us;
+    } else { /* MISRA C 2004 14.10 */
+    }
+    return (uint32_t)rto;
+}
+
+uint32_t
+CO_SDOrtt_timeout_us(const CO_SDOrtt_t* rtt, uint8_t nodeId, uint32_t timeout_us) {
+    uint32_t rto = CO_SDOrtt_retryTimeout_us(rtt, nodeId, timeout_us);
+    return (rto > timeout_us) ? rto : timeout_us;
+}
+
+void
+CO_SDOrtt_retry(CO_SDOrtt_t* rtt, uint8_t nodeId) {
+    CO_SDOrtt_node_t* node = CO_SDOrtt_node(rtt, nodeId);
+    if ((node != NULL) && (node->retries < UINT32_MAX)) {
+        node->retries++;
+    }
+}
+
+void
+CO_SDOrtt_timeout(CO_SDOrtt_t* rtt, uint8_t nodeId) {
+    CO_SDOrtt_node_t* node = CO_SDOrtt_node(rtt, nodeId);
+    if ((node != NULL) && (node->timeouts < UINT32_MAX)) {
+        node->timeouts++;
+    }
+}
+
+const CO_SDOrtt_node_t*
+CO_SDOrtt_get(const CO_SDOrtt_t* rtt, uint8_t nodeId) {
+    return CO_SDOrtt_node(rtt, nodeId);
+}
@@ -0,0 +1,171 @@
+/**
+ * CANopen SDO round trip time estimation for remote nodes.
+ *
+ * @file        CO_SDOrtt.h
+ * @ingroup     CO_SDOrtt
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_SDO_RTT_H
+#define CO_SDO_RTT_H
+
+#include "301/CO_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_SDOrtt SDO round trip time
+ * Per node estimation of the SDO round trip time, adaptive SDO timeouts and fast retries.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * Time between SDO request and response is measured for each remote node. Smoothed round trip time (SRTT) and its
+ * variation (RTTVAR) are calculated like in TCP (RFC 6298): RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R| and
+ * SRTT = 7/8 SRTT + 1/8 R. Retransmission timeout is SRTT + 4 * RTTVAR, limited by minTimeout and maxTimeout from
+ * CO_SDOrtt_init().
+ *
+ * If estimator is attached to the SDO client with CO_SDOclient_setRtt(), client measures each request - response
+ * pair. Samples are not taken from retransmitted requests (Karn's algorithm). SDO timeout from
+ * CO_SDOclientDownloadInitiate() or CO_SDOclientUploadInitiate() stays the limit for the whole request. It is only
+ * extended for slow nodes, if their retransmission timeout is longer. If response to the initiate request of
+ * expedited download or of upload does not arrive within retransmission timeout, request is sent again, at most
+ * maxRetries times, with doubled timeout each time. Other requests are not repeated, because the SDO server would
+ * abort the transfer. Until the first sample of the node is taken, there is no fast retry.
+ *
+ * Statistics of each node are available with CO_SDOrtt_get(), for example to find nodes with long or unstable
+ * response times, or with many retries.
+ */
+
+/** Number of nodes, node-id 1..CO_SDO_RTT_NODES. */
+#ifndef CO_SDO_RTT_NODES
+#define CO_SDO_RTT_NODES 127U
+#endif
+
+/** Default minimum retransmission timeout, used by CO_CANopenInit(). */
+#ifndef CO_SDO_RTT_MIN_TIMEOUT_MS
+#define CO_SDO_RTT_MIN_TIMEOUT_MS 10U
+#endif
+
+/** Default maximum retransmission timeout and maximum extension of SDO timeout, used by CO_CANopenInit(). */
+#ifndef CO_SDO_RTT_MAX_TIMEOUT_MS
+#define CO_SDO_RTT_MAX_TIMEOUT_MS 5000U
+#endif
+
+/** Default maximum number of retransmissions of one request, used by CO_CANopenInit(). */
+#ifndef CO_SDO_RTT_RETRIES
+#define CO_SDO_RTT_RETRIES 2U
+#endif
+
+/** Round trip statistics of one node */
+typedef struct {
+    uint32_t srtt_us;   /**< Smoothed round trip time in microseconds */
+    uint32_t rttvar_us; /**< Round trip time variation in microseconds */
+    uint32_t rttMin_us; /**< Shortest measured round trip time */
+    uint32_t rttMax_us; /**< Longest measured round trip time */
+    uint32_t samples;   /**< Number of measured round trips, 0 if node did not respond yet */
+    uint32_t retries;   /**< Number of retransmitted requests */
+    uint32_t timeouts;  /**< Number of SDO transfers aborted by timeout */
+} CO_SDOrtt_node_t;
+
+/** SDO round trip time object */
+typedef struct {
+    CO_SDOrtt_node_t nodes[CO_SDO_RTT_NODES]; /**< Statistics, index is node-id - 1 */
+    uint32_t minTimeout_us;                   /**< From CO_SDOrtt_init() */
+    uint32_t maxTimeout_us;                   /**< From CO_SDOrtt_init() */
+    uint8_t maxRetries;                       /**< From CO_SDOrtt_init() */
+} CO_SDOrtt_t;
+
+/**
+ * Initialize SDO round trip time object, statistics of all nodes are cleared.
+ *
+ * @param rtt This object will be initialized.
+ * @param minTimeout_ms Minimum retransmission timeout. It should be longer than the period of processing the SDO
+ * client, because response time is measured with that resolution.
+ * @param maxTimeout_ms Maximum retransmission timeout, SDO timeout of slow nodes is extended at most to this value.
+ * @param maxRetries Maximum number of retransmissions of one request, 0 disables fast retries.
+ */
+void CO_SDOrtt_init(CO_SDOrtt_t* rtt, uint16_t minTimeout_ms, uint16_t maxTimeout_ms, uint8_t maxRetries);
+
+/**
+ * Clear statistics of the node, for example after the node was replaced.
+ *
+ * @param rtt This object.
+ * @param nodeId Node-ID of the SDO server, 0 for all nodes.
+ */
+void CO_SDOrtt_reset(CO_SDOrtt_t* rtt, uint8_t nodeId);
+
+/**
+ * Add measured round trip time of the node.
+ *
+ * @param rtt This object, may be NULL.
+ * @param nodeId Node-ID of the SDO server.
+ * @param rtt_us Time between request and response in microseconds.
+ */
+void CO_SDOrtt_sample(CO_SDOrtt_t* rtt, uint8_t nodeId, uint32_t rtt_us);
+
+/**
+ * Get retransmission timeout of the node.
+ *
+ * @param rtt This object, may be NULL.
+ * @param nodeId Node-ID of the SDO server.
+ * @param timeout_us SDO timeout of the request.
+ *
+ * @return SRTT + 4 * RTTVAR within minTimeout and maxTimeout. timeout_us, if there are no samples of the node.
+ */
+uint32_t CO_SDOrtt_retryTimeout_us(const CO_SDOrtt_t* rtt, uint8_t nodeId, uint32_t timeout_us);
+
+/**
+ * Get SDO timeout of the request to the node.
+ *
+ * @param rtt This object, may be NULL.
+ * @param nodeId Node-ID of the SDO server.
+ * @param timeout_us SDO timeout from the application.
+ *
+ * @return timeout_us or longer retransmission timeout of the slow node.
+ */
+uint32_t CO_SDOrtt_timeout_us(const CO_SDOrtt_t* rtt, uint8_t nodeId, uint32_t timeout_us);
+
+/**
+ * Count retransmitted request of the node.
+ *
+ * @param rtt This object, may be NULL.
+ * @param nodeId Node-ID of the SDO server.
+ */
+void CO_SDOrtt_retry(CO_SDOrtt_t* rtt, uint8_t nodeId);
+
+/**
+ * Count SDO transfer to the node, which was aborted by timeout.
+ *
+ * @param rtt This object, may be NULL.
+ * @param nodeId Node-ID of the SDO server.
+ */
+void CO_SDOrtt_timeout(CO_SDOrtt_t* rtt, uint8_t nodeId);
+
+/**
+ * Get round trip statistics of the node.
+ *
+ * @param rtt This object.
+ * @param nodeId Node-ID of the SDO server.
+ *
+ * @return Pointer to statistics or NULL for invalid arguments.
+ */
+const CO_SDOrtt_node_t* CO_SDOrtt_get(const CO_SDOrtt_t* rtt, uint8_t nodeId);
+
+/** @} */ /* CO_SDOrtt */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* CO_SDO_RTT_H */
@@ -0,0 +1,298 @@
+/*
+ * CANopen network state table, NMT and health state of all remote nodes as bitsets.
+ *
+ * @file        CO_netState.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_netState.h"
+
+#if ((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0
+
+#if !defined CO_FLAG_BITS_SET || !defined CO_FLAG_BITS_TAKE
+#error CO_CONFIG_NET_STATE requires CO_FLAG_BITS_SET() and CO_FLAG_BITS_TAKE() in CO_driver_target.h
+#endif
+
+/* NMT states from the messages, see CO_NMT_internalState_t */
+#define CO_NET_NMT_INITIALIZING    0U
+#define CO_NET_NMT_STOPPED         4U
+#define CO_NET_NMT_OPERATIONAL     5U
+#define CO_NET_NMT_PRE_OPERATIONAL 127U
+#define CO_NET_NMT_UNKNOWN         0xFFU
+
+/* Lowest set bit of the non zero word */
+static inline uint8_t
+CO_netState_lowestBit(uint32_t bits) {
+#if defined __GNUC__
+    return (uint8_t)__builtin_ctz(bits);
+#else
+    uint8_t bit = 0;
+    while ((bits & (1UL << bit)) == 0U) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/* Put node into the set or remove it and remember the change */
+static void
+CO_netState_put(CO_netState_t* ns, CO_netState_set_t set, uint8_t nodeId, bool_t in) {
+    if (CO_netState_bitTest(&ns->sets[set], nodeId) != in) {
+        uint32_t mask = 1UL << (nodeId & 0x1FU);
+        ns->sets[set].w[nodeId >> 5] ^= mask;
+        ns->changed[set].w[nodeId >> 5] |= mask;
+    }
+}
+
+/* Apply received NMT state of the node */
+static void
+CO_netState_applyNMT(CO_netState_t* ns, uint8_t nodeId, uint8_t NMTstate) {
+    bool_t alive = NMTstate != CO_NET_NMT_INITIALIZING;
+
+    ns->NMTstate[nodeId] = NMTstate;
+    ns->lastSeen_us[nodeId] = ns->now_us;
+    CO_netState_bitSet(&ns->seen, nodeId);
+    if (!alive) {
+        CO_netState_put(ns, CO_NET_STATE_BOOTUP, nodeId, true);
+    } else {
+        CO_netState_put(ns, CO_NET_STATE_TIMEOUT, nodeId, false);
+    }
+    CO_netState_put(ns, CO_NET_STATE_ALIVE, nodeId, alive);
+    CO_netState_put(ns, CO_NET_STATE_OPERATIONAL, nodeId, NMTstate == CO_NET_NMT_OPERATIONAL);
+    CO_netState_put(ns, CO_NET_STATE_PRE_OPERATIONAL, nodeId, NMTstate == CO_NET_NMT_PRE_OPERATIONAL);
+    CO_netState_put(ns, CO_NET_STATE_STOPPED, nodeId, NMTstate == CO_NET_NMT_STOPPED);
+}
+
+int16_t
+CO_netState_bitNext(const CO_netState_bits_t* bits, uint8_t nodeId) {
+    for (uint8_t w = nodeId >> 5; w < CO_NET_STATE_WORDS; w++) {
+        uint32_t word = bits->w[w];
+        if (w == (nodeId >> 5)) {
+            word &= ~((1UL << (nodeId & 0x1FU)) - 1U);
+        }
+        if (word != 0U) {
+            return (int16_t)((w * 32U) + CO_netState_lowestBit(word));
+        }
+    }
+    return -1;
+}
+
+void
+CO_netState_init(CO_netState_t* ns) {
+    if (ns == NULL) {
+        return;
+    }
+    (void)memset(ns, 0, sizeof(CO_netState_t));
+    (void)memset(ns->NMTstate, CO_NET_NMT_UNKNOWN, sizeof(ns->NMTstate));
+}
+
+void
+CO_netState_rxNMT(CO_netState_t* ns, uint8_t nodeId, uint8_t NMTstate) {
+    if ((ns == NULL) || (nodeId < 1U) || (nodeId > 127U)) {
+        return;
+    }
+    ns->rxNMTstate[nodeId] = NMTstate;
+    CO_FLAG_BITS_SET(ns->rxNMT[nodeId >> 5], 1UL << (nodeId & 0x1FU));
+}
+
+void
+CO_netState_rxEMCY(CO_netState_t* ns, uint8_t nodeId, uint8_t errorRegister) {
+    if ((ns == NULL) || (nodeId < 1U) || (nodeId > 127U)) {
+        return;
+    }
+    ns->rxErrorRegister[nodeId] = errorRegister;
+    CO_FLAG_BITS_SET(ns->rxEMCY[nodeId >> 5], 1UL << (nodeId & 0x1FU));
+}
+
+void
+CO_netState_process(CO_netState_t* ns, uint32_t timeDifference_us) {
+    if (ns == NULL) {
+        return;
+    }
+    ns->now_us += timeDifference_us;
+
+    /* apply values from receive callbacks */
+    for (uint8_t w = 0; w < CO_NET_STATE_WORDS; w++) {
+        uint32_t bits = CO_FLAG_BITS_TAKE(ns->rxNMT[w]);
+        while (bits != 0U) {
+            uint8_t nodeId = (uint8_t)((w * 32U) + CO_netState_lowestBit(bits));
+            bits &= bits - 1U;
+            CO_netState_applyNMT(ns, nodeId, ns->rxNMTstate[nodeId]);
+        }
+        bits = CO_FLAG_BITS_TAKE(ns->rxEMCY[w]);
+        while (bits != 0U) {
+            uint8_t nodeId = (uint8_t)((w * 32U) + CO_netState_lowestBit(bits));
+            bits &= bits - 1U;
+            ns->errorRegister[nodeId] = ns->rxErrorRegister[nodeId];
+            CO_netState_put(ns, CO_NET_STATE_EMCY, nodeId, ns->errorRegister[nodeId] != 0U);
+        }
+    }
+
+    /* signal subscribers */
+    for (uint8_t i = 0; i < CO_NET_STATE_SUBSCRIBERS; i++) {
+        const CO_netState_sub_t* sub = &ns->subs[i];
+        if (sub->pFunctChanged == NULL) {
+            continue;
+        }
+        CO_netState_bits_t changed;
+        uint32_t any = 0;
+        for (uint8_t w = 0; w < CO_NET_STATE_WORDS; w++) {
+            uint32_t word = 0;
+            for (uint8_t set = 0; set < (uint8_t)CO_NET_STATE_COUNT; set++) {
+                if ((sub->setsMask & (1U << set)) != 0U) {
+                    word |= ns->changed[set].w[w];
+                }
+            }
+            changed.w[w] = word & sub->nodes.w[w];
+            any |= changed.w[w];
+        }
+        if (any != 0U) {
+            sub->pFunctChanged(sub->object, &changed);
+        }
+    }
+    (void)memset(ns->changed, 0, sizeof(ns->changed));
+}
+
+void
+CO_netState_lost(CO_netState_t* ns, uint8_t nodeId, bool_t timeout) {
+    if ((ns == NULL) || (nodeId < 1U) || (nodeId > 127U)) {
+        return;
+    }
+    ns->NMTstate[nodeId] = CO_NET_NMT_UNKNOWN;
+    CO_netState_put(ns, CO_NET_STATE_ALIVE, nodeId, false);
+    CO_netState_put(ns, CO_NET_STATE_OPERATIONAL, nodeId, false);
+    CO_netState_put(ns, CO_NET_STATE_PRE_OPERATIONAL, nodeId, false);
+    CO_netState_put(ns, CO_NET_STATE_STOPPED, nodeId, false);
+    if (timeout) {
+        CO_netState_put(ns, CO_NET_STATE_TIMEOUT, nodeId, true);
+    }
+}
+
+void
+CO_netState_monitor(CO_netState_t* ns, uint8_t nodeId, bool_t monitored) {
+    if ((ns == NULL) || (nodeId < 1U) || (nodeId > 127U)) {
+        return;
+    }
+    CO_netState_put(ns, CO_NET_STATE_MONITORED, nodeId, monitored);
+    if (!monitored) {
+        CO_netState_lost(ns, nodeId, false);
+        CO_netState_put(ns, CO_NET_STATE_TIMEOUT, nodeId, false);
+    }
+}
+
+void
+CO_netState_clear(CO_netState_t* ns, CO_netState_set_t set, const CO_netState_bits_t* nodes) {
+    if ((ns == NULL) || (set >= CO_NET_STATE_COUNT)) {
+        return;
+    }
+    for (uint8_t w = 0; w < CO_NET_STATE_WORDS; w++) {
+        uint32_t remove = ns->sets[set].w[w] & ((nodes != NULL) ? nodes->w[w] : 0xFFFFFFFFUL);
+        ns->sets[set].w[w] &= ~remove;
+        ns->changed[set].w[w] |= remove;
+    }
+}
+
+bool_t
+CO_netState_all(const CO_netState_t* ns, CO_netState_set_t set, const CO_netState_bits_t* nodes) {
+    if (nodes == NULL) {
+        nodes = &ns->sets[CO_NET_STATE_MONITORED];
+    }
+    for (uint8_t w = 0; w < CO_NET_STATE_WORDS; w++) {
+        if ((nodes->w[w] & ~ns->sets[set].w[w]) != 0U) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool_t
+CO_netState_any(const CO_netState_t* ns, CO_netState_set_t set, const CO_netState_bits_t* nodes,
+                CO_netState_bits_t* match) {
+    uint32_t any = 0;
+
+    for (uint8_t w = 0; w < CO_NET_STATE_WORDS; w++) {
+        uint32_t word = ns->sets[set].w[w] & ((nodes != NULL) ? nodes->w[w] : 0xFFFFFFFFUL);
+        if (match != NULL) {
+            match->w[w] = word;
+        }
+        any |= word;
+    }
+    return any != 0U;
+}
+
+uint8_t
+CO_netState_count(const CO_netState_t* ns, CO_netState_set_t set) {
+    uint8_t count = 0;
+
+    for (uint8_t w = 0; w < CO_NET_STATE_WORDS; w++) {
+#if defined __GNUC__
+        count += (uint8_t)__builtin_popcount(ns->sets[set].w[w]);
+#else
+        for (uint32_t word = ns->sets[set].w[w]; word != 0U; word &= word - 1U) {
+            count++;
+        }
+#endif
+    }
+    return count;
+}
+
+bool_t
+CO_netState_lastSeen(const CO_netState_t* ns, uint8_t nodeId, uint32_t* age_us) {
+    if ((nodeId > 127U) || !CO_netState_bitTest(&ns->seen, nodeId)) {
+        return false;
+    }
+    if (age_us != NULL) {
+        *age_us = ns->now_us - ns->lastSeen_us[nodeId];
+    }
+    return true;
+}
+
+CO_ReturnError_t
+CO_netState_subscribe(CO_netState_t* ns, uint16_t setsMask, const CO_netState_bits_t* nodes,
+                      void (*pFunctChanged)(void* object, const CO_netState_bits_t* changed), void* object) {
+    if ((ns == NULL) || (pFunctChanged == NULL) || (setsMask == 0U)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    for (uint8_t i = 0; i < CO_NET_STATE_SUBSCRIBERS; i++) {
+        CO_netState_sub_t* sub = &ns->subs[i];
+        if (sub->pFunctChanged == NULL) {
+            if (nodes != NULL) {
+                sub->nodes = *nodes;
+            } else {
+                (void)memset(&sub->nodes, 0xFF, sizeof(sub->nodes));
+            }
+            sub->setsMask = setsMask;
+            sub->object = object;
+            sub->pFunctChanged = pFunctChanged;
+            return CO_ERROR_NO;
+        }
+    }
+    return CO_ERROR_OUT_OF_MEMORY;
+}
+
+void
+CO_netState_unsubscribe(CO_netState_t* ns, void (*pFunctChanged)(void* object, const CO_netState_bits_t* changed),
+                        void* object) {
+    if (ns == NULL) {
+        return;
+    }
+    for (uint8_t i = 0; i < CO_NET_STATE_SUBSCRIBERS; i++) {
+        CO_netState_sub_t* sub = &ns->subs[i];
+        if ((sub->pFunctChanged == pFunctChanged) && (sub->object == object)) {
+            sub->pFunctChanged = NULL;
+        }
+    }
+}
+
+#endif /* (CO_CONFIG_NET_STATE) & CO_CONFIG_NET_STATE_ENABLE */
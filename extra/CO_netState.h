@@ -0,0 +1,308 @@
+/**
+ * CANopen network state table, NMT and health state of all remote nodes as bitsets.
+ *
+ * @file        CO_netState.h
+ * @ingroup     CO_netState
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_NET_STATE_H
+#define CO_NET_STATE_H
+
+#include "301/CO_driver.h"
+
+/* default configuration, see CO_config.h */
+#ifndef CO_CONFIG_NET_STATE
+#define CO_CONFIG_NET_STATE (0)
+#endif
+
+#if (((CO_CONFIG_NET_STATE)&CO_CONFIG_NET_STATE_ENABLE) != 0) || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_netState Network state
+ * Table of NMT and health states of all remote nodes, for whole-bus queries.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * For each state from @ref CO_netState_set_t there is a 128-bit set of nodes, bit n is node-id n. Questions like "are
+ * all drives operational" or "which nodes timed out" are then a few word operations on @ref CO_netState_bits_t, without
+ * lookups of each node. Last-seen time of each node is also kept.
+ *
+ * Table is filled by Heartbeat consumer, Node Guarding master and Emergency consumer, which are attached with
+ * CO_HBconsumer_setNetState(), CO_nodeGuardingMaster_setNetState() and CO_EM_setNetState(). CO_CANopenInit() does
+ * that for the objects of the CANopen object and CO_process() calls CO_netState_process().
+ *
+ * Receive callbacks only store the received value and mark the node with CO_FLAG_BITS_SET(). Sets are updated by
+ * CO_netState_process(), which then calls subscribers of changed nodes. Queries and subscriptions must be used from
+ * the same thread, which processes the table, or with CO_LOCK_OD().
+ */
+
+/** Number of subscribers, see CO_netState_subscribe() */
+#ifndef CO_NET_STATE_SUBSCRIBERS
+#define CO_NET_STATE_SUBSCRIBERS 4U
+#endif
+
+/** Number of uint32_t words in the node bitset */
+#define CO_NET_STATE_WORDS 4U
+
+/** Set of nodes, bit n is node-id n, bit 0 is not used */
+typedef struct {
+    uint32_t w[CO_NET_STATE_WORDS]; /**< Words, node-id n is bit (n & 31) of word (n >> 5) */
+} CO_netState_bits_t;
+
+/** States of the nodes, each has its own set of nodes */
+typedef enum {
+    CO_NET_STATE_MONITORED = 0,       /**< Node is monitored by Heartbeat consumer or Node Guarding master */
+    CO_NET_STATE_ALIVE = 1,           /**< Heartbeat or guarding response received and not timed out since */
+    CO_NET_STATE_OPERATIONAL = 2,     /**< Node is alive and NMT operational */
+    CO_NET_STATE_PRE_OPERATIONAL = 3, /**< Node is alive and NMT pre-operational */
+    CO_NET_STATE_STOPPED = 4,         /**< Node is alive and NMT stopped */
+    CO_NET_STATE_TIMEOUT = 5,         /**< Heartbeat or guarding timeout, cleared when node is alive again */
+    CO_NET_STATE_BOOTUP = 6,          /**< Boot-up message received, stays set until CO_netState_clear() */
+    CO_NET_STATE_EMCY = 7,            /**< Last emergency message from the node has error register different than 0 */
+    CO_NET_STATE_COUNT = 8            /**< Number of states */
+} CO_netState_set_t;
+
+/** Subscription to changes, see CO_netState_subscribe() */
+typedef struct {
+    CO_netState_bits_t nodes; /**< Nodes of interest */
+    uint16_t setsMask;        /**< Bit (1 << @ref CO_netState_set_t) for each state of interest */
+    /** Callback, NULL if subscription is not used */
+    void (*pFunctChanged)(void* object, const CO_netState_bits_t* changed);
+    void* object; /**< Object for pFunctChanged */
+} CO_netState_sub_t;
+
+/** Network state object */
+typedef struct {
+    CO_netState_bits_t sets[CO_NET_STATE_COUNT];    /**< Set of nodes for each state */
+    CO_netState_bits_t changed[CO_NET_STATE_COUNT]; /**< Nodes, which entered or left the set since last processing */
+    uint8_t NMTstate[128];                          /**< Last received NMT state of each node, 0xFF if unknown */
+    uint8_t errorRegister[128];                     /**< Error register from the last emergency of each node */
+    CO_netState_bits_t seen;                        /**< Nodes with valid lastSeen_us */
+    uint32_t lastSeen_us[128];                      /**< Time of the last heartbeat or guarding response */
+    uint32_t now_us;                                /**< Time, advanced by CO_netState_process() */
+    volatile uint8_t rxNMTstate[128];               /**< NMT state from receive callbacks */
+    volatile uint8_t rxErrorRegister[128];          /**< Error register from receive callbacks */
+    volatile uint32_t rxNMT[CO_NET_STATE_WORDS];    /**< Nodes with received NMT state, see CO_FLAG_BITS_SET() */
+    volatile uint32_t rxEMCY[CO_NET_STATE_WORDS];   /**< Nodes with received emergency */
+    CO_netState_sub_t subs[CO_NET_STATE_SUBSCRIBERS]; /**< Subscriptions */
+} CO_netState_t;
+
+/**
+ * Test node in the set
+ *
+ * @param bits Set of nodes.
+ * @param nodeId Node-id, 0..127.
+ *
+ * @return True, if node is in the set.
+ */
+static inline bool_t
+CO_netState_bitTest(const CO_netState_bits_t* bits, uint8_t nodeId) {
+    return (bits->w[(nodeId >> 5) & 3U] & (1UL << (nodeId & 0x1FU))) != 0U;
+}
+
+/**
+ * Put node into the set
+ *
+ * @param bits Set of nodes.
+ * @param nodeId Node-id, 0..127.
+ */
+static inline void
+CO_netState_bitSet(CO_netState_bits_t* bits, uint8_t nodeId) {
+    bits->w[(nodeId >> 5) & 3U] |= 1UL << (nodeId & 0x1FU);
+}
+
+/**
+ * Get next node in the set, for iteration over the set
+ *
+ * @param bits Set of nodes.
+ * @param nodeId Search starts at this node-id.
+ *
+ * @return Lowest node-id >= nodeId in the set or -1.
+ */
+int16_t CO_netState_bitNext(const CO_netState_bits_t* bits, uint8_t nodeId);
+
+/**
+ * Initialize network state object, all nodes are unknown and there are no subscribers
+ *
+ * @param ns This object will be initialized.
+ */
+void CO_netState_init(CO_netState_t* ns);
+
+/**
+ * Process network state
+ *
+ * Apply values from receive callbacks, then call subscribers, whose nodes entered or left any of their sets.
+ *
+ * @param ns This object, may be NULL.
+ * @param timeDifference_us Time difference from previous function call in microseconds.
+ */
+void CO_netState_process(CO_netState_t* ns, uint32_t timeDifference_us);
+
+/**
+ * Store received NMT state of the node, heartbeat, boot-up or guarding response. May be called from receive callback.
+ *
+ * @param ns This object, may be NULL.
+ * @param nodeId Node-id, 1..127.
+ * @param NMTstate NMT state from the message, CO_NMT_INITIALIZING for boot-up.
+ */
+void CO_netState_rxNMT(CO_netState_t* ns, uint8_t nodeId, uint8_t NMTstate);
+
+/**
+ * Store error register from received emergency message. May be called from receive callback.
+ *
+ * @param ns This object, may be NULL.
+ * @param nodeId Node-id, 1..127.
+ * @param errorRegister Error register from the message.
+ */
+void CO_netState_rxEMCY(CO_netState_t* ns, uint8_t nodeId, uint8_t errorRegister);
+
+/**
+ * Node is lost, heartbeat or guarding timeout, or monitoring was restarted. Called from processing function.
+ *
+ * @param ns This object, may be NULL.
+ * @param nodeId Node-id, 1..127.
+ * @param timeout True for timeout, node is put into @ref CO_NET_STATE_TIMEOUT.
+ */
+void CO_netState_lost(CO_netState_t* ns, uint8_t nodeId, bool_t timeout);
+
+/**
+ * Start or stop monitoring of the node. Called from processing function or initialization.
+ *
+ * @param ns This object, may be NULL.
+ * @param nodeId Node-id, 1..127.
+ * @param monitored True, if node is monitored.
+ */
+void CO_netState_monitor(CO_netState_t* ns, uint8_t nodeId, bool_t monitored);
+
+/**
+ * Remove nodes from the set, for example acknowledge @ref CO_NET_STATE_BOOTUP
+ *
+ * @param ns This object.
+ * @param set State.
+ * @param nodes Nodes to remove, NULL for all.
+ */
+void CO_netState_clear(CO_netState_t* ns, CO_netState_set_t set, const CO_netState_bits_t* nodes);
+
+/**
+ * Get set of nodes in the state
+ *
+ * @param ns This object.
+ * @param set State.
+ *
+ * @return Pointer to the set, valid until the next processing.
+ */
+static inline const CO_netState_bits_t*
+CO_netState_get(const CO_netState_t* ns, CO_netState_set_t set) {
+    return &ns->sets[set];
+}
+
+/**
+ * Test, if node is in the state
+ *
+ * @param ns This object.
+ * @param set State.
+ * @param nodeId Node-id, 1..127.
+ *
+ * @return True, if node is in the state.
+ */
+static inline bool_t
+CO_netState_test(const CO_netState_t* ns, CO_netState_set_t set, uint8_t nodeId) {
+    return CO_netState_bitTest(&ns->sets[set], nodeId);
+}
+
+/**
+ * Test, if all nodes are in the state
+ *
+ * @param ns This object.
+ * @param set State.
+ * @param nodes Nodes to test, NULL for all monitored nodes.
+ *
+ * @return True, if all nodes are in the state, also if there are no nodes.
+ */
+bool_t CO_netState_all(const CO_netState_t* ns, CO_netState_set_t set, const CO_netState_bits_t* nodes);
+
+/**
+ * Test, if any node is in the state
+ *
+ * @param ns This object.
+ * @param set State.
+ * @param nodes Nodes to test, NULL for all nodes.
+ * @param [out] match Nodes from nodes, which are in the state, may be NULL.
+ *
+ * @return True, if at least one node is in the state.
+ */
+bool_t CO_netState_any(const CO_netState_t* ns, CO_netState_set_t set, const CO_netState_bits_t* nodes,
+                       CO_netState_bits_t* match);
+
+/**
+ * Get number of nodes in the state
+ *
+ * @param ns This object.
+ * @param set State.
+ *
+ * @return Number of nodes.
+ */
+uint8_t CO_netState_count(const CO_netState_t* ns, CO_netState_set_t set);
+
+/**
+ * Get time since the last heartbeat or guarding response from the node
+ *
+ * @param ns This object.
+ * @param nodeId Node-id, 1..127.
+ * @param [out] age_us Time since the node was last seen in microseconds.
+ *
+ * @return True, if node was seen since initialization.
+ */
+bool_t CO_netState_lastSeen(const CO_netState_t* ns, uint8_t nodeId, uint32_t* age_us);
+
+/**
+ * Subscribe to changes of the nodes
+ *
+ * Callback is called from CO_netState_process(), when any of the nodes entered or left any of the sets.
+ *
+ * @param ns This object.
+ * @param setsMask Bit (1 << @ref CO_netState_set_t) for each state of interest.
+ * @param nodes Nodes of interest, NULL for all nodes.
+ * @param pFunctChanged Callback. Its argument changed contains the nodes of interest, which changed.
+ * @param object Object for the callback.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_OUT_OF_MEMORY, if all
+ * CO_NET_STATE_SUBSCRIBERS are used.
+ */
+CO_ReturnError_t CO_netState_subscribe(CO_netState_t* ns, uint16_t setsMask, const CO_netState_bits_t* nodes,
+                                       void (*pFunctChanged)(void* object, const CO_netState_bits_t* changed),
+                                       void* object);
+
+/**
+ * Remove subscription
+ *
+ * @param ns This object.
+ * @param pFunctChanged Callback from CO_netState_subscribe().
+ * @param object Object from CO_netState_subscribe().
+ */
+void CO_netState_unsubscribe(CO_netState_t* ns, void (*pFunctChanged)(void* object, const CO_netState_bits_t* changed),
+                             void* object);
+
+/** @} */ /* CO_netState */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_NET_STATE) & CO_CONFIG_NET_STATE_ENABLE */
+
+#endif /* CO_NET_STATE_H */
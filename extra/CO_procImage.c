@@ -0,0 +1,197 @@
+/*
+ * CANopen process image, received drive values of many axes in structure of arrays, with batch unit conversion.
+ *
+ * @file        CO_procImage.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_procImage.h"
+
+#if (((CO_CONFIG_PDO)&CO_CONFIG_RPDO_ENABLE) != 0) && (((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0)            \
+    && (((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0)
+
+#if CO_PROC_IMAGE_AXES > 32U
+#error CO_PROC_IMAGE_AXES must be at most 32
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Largest float below 2^31 and its negative, floats outside are saturated before conversion to int32_t */
+#define CO_PROC_IMAGE_FLOAT_MAX 2147483520.0F
+#define CO_PROC_IMAGE_FLOAT_MIN (-2147483648.0F)
+
+/* Size of each value in bytes, see CO_procImage_field_t */
+static const uint8_t CO_procImage_size[CO_PROC_IMAGE_FIELDS] = {2U, 4U, 4U, 2U};
+
+void
+CO_procImage_init(CO_procImage_t* image) {
+    if (image != NULL) {
+        (void)memset(image, 0, sizeof(*image));
+    }
+}
+
+CO_ReturnError_t
+CO_procImage_bind(CO_procImage_t* image, uint8_t axis, CO_procImage_field_t field, const CO_RPDO_t* RPDO,
+                  uint8_t mapIndex) {
+    if ((image == NULL) || (axis >= CO_PROC_IMAGE_AXES) || ((uint8_t)field >= (uint8_t)CO_PROC_IMAGE_FIELDS)
+        || (RPDO == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    const CO_PDO_common_t* PDO = &RPDO->PDO_common;
+    if (!PDO->valid || (mapIndex >= PDO->mappedObjectsCount)
+        || ((CO_PDO_size_t)PDO->OD_IO[mapIndex].stream.dataOffset != CO_procImage_size[field])) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* position of the entry in the PDO data, mappedLength is stored in dataOffset */
+    CO_PDO_size_t offset = 0;
+    for (uint8_t i = 0; i < mapIndex; i++) {
+        offset += (CO_PDO_size_t)PDO->OD_IO[i].stream.dataOffset;
+    }
+
+    /* last step of the copy plan, which starts at or before the entry */
+    const CO_PDO_copy_t* step = NULL;
+    for (uint8_t i = 0; i < PDO->copyCount; i++) {
+        if (PDO->copyPlan[i].mapIndex <= mapIndex) {
+            step = &PDO->copyPlan[i];
+        }
+    }
+    if ((step == NULL) || (step->dataOD == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    image->src[field][axis] = &step->dataOD[offset - step->offset];
+    if (axis >= image->axisCount) {
+        image->axisCount = (uint8_t)(axis + 1U);
+    }
+    return CO_ERROR_NO;
+}
+
+void
+CO_procImage_update(CO_procImage_t* image) {
+    uint8_t count = image->axisCount;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* src = image->src[CO_PROC_IMAGE_STATUSWORD][i];
+        if (src != NULL) {
+            (void)memcpy(&image->statusword[i], src, sizeof(image->statusword[i]));
+        }
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* src = image->src[CO_PROC_IMAGE_POSITION][i];
+        if (src != NULL) {
+            (void)memcpy(&image->position[i], src, sizeof(image->position[i]));
+        }
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* src = image->src[CO_PROC_IMAGE_VELOCITY][i];
+        if (src != NULL) {
+            (void)memcpy(&image->velocity[i], src, sizeof(image->velocity[i]));
+        }
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* src = image->src[CO_PROC_IMAGE_TORQUE][i];
+        if (src != NULL) {
+            (void)memcpy(&image->torque[i], src, sizeof(image->torque[i]));
+        }
+    }
+}
+
+void
+CO_procImage_toUnits(const int32_t* counts, float* units, uint16_t count, float scale) {
+    uint16_t i = 0;
+
+#ifdef __SSE2__
+    __m128 s = _mm_set1_ps(scale);
+    for (; (i + 4U) <= count; i += 4U) {
+        __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&counts[i]));
+        _mm_storeu_ps(&units[i], _mm_mul_ps(v, s));
+    }
+#endif
+    for (; i < count; i++) {
+        units[i] = (float)counts[i] * scale;
+    }
+}
+
+void
+CO_procImage_toCounts(const float* units, int32_t* counts, uint16_t count, float scale) {
+    float inv = 1.0F / scale;
+    uint16_t i = 0;
+
+#ifdef __SSE2__
+    /* truncate, then correct the fraction of +-0.5 or more away from zero, like the scalar code below */
+    __m128 s = _mm_set1_ps(inv);
+    __m128 vMax = _mm_set1_ps(CO_PROC_IMAGE_FLOAT_MAX);
+    __m128 vMin = _mm_set1_ps(CO_PROC_IMAGE_FLOAT_MIN);
+    __m128 half = _mm_set1_ps(0.5F);
+    __m128 halfNeg = _mm_set1_ps(-0.5F);
+    for (; (i + 4U) <= count; i += 4U) {
+        __m128 v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(&units[i]), s), vMin), vMax);
+        __m128i t = _mm_cvttps_epi32(v);
+        __m128 frac = _mm_sub_ps(v, _mm_cvtepi32_ps(t));
+        /* comparison results are -1 (all bits set) or 0 */
+        t = _mm_sub_epi32(t, _mm_castps_si128(_mm_cmpge_ps(frac, half)));
+        t = _mm_add_epi32(t, _mm_castps_si128(_mm_cmple_ps(frac, halfNeg)));
+        _mm_storeu_si128((__m128i*)&counts[i], t);
+    }
+#endif
+    for (; i < count; i++) {
+        float v = units[i] * inv;
+        /* NaN is saturated to the minimum, like with _mm_max_ps() */
+        if (v > CO_PROC_IMAGE_FLOAT_MAX) {
+            v = CO_PROC_IMAGE_FLOAT_MAX;
+        } else if (!(v >= CO_PROC_IMAGE_FLOAT_MIN)) {
+            v = CO_PROC_IMAGE_FLOAT_MIN;
+        } else { /* MISRA C 2004 14.10 */
+        }
+        int32_t t = (int32_t)v;
+        float frac = v - (float)t;
+        if (frac >= 0.5F) {
+            t++;
+        } else if (frac <= -0.5F) {
+            t--;
+        } else { /* MISRA C 2004 14.10 */
+        }
+        counts[i] = t;
+    }
+}
+
+uint32_t
+CO_procImage_checkLimits(const int32_t* values, uint16_t count, int32_t min, int32_t max) {
+    uint32_t outside = 0;
+    uint16_t i = 0;
+
+    if (count > 32U) {
+        count = 32U;
+    }
+#ifdef __SSE2__
+    __m128i vMin = _mm_set1_epi32(min);
+    __m128i vMax = _mm_set1_epi32(max);
+    for (; (i + 4U) <= count; i += 4U) {
+        __m128i v = _mm_loadu_si128((const __m128i*)&values[i]);
+        __m128i out = _mm_or_si128(_mm_cmplt_epi32(v, vMin), _mm_cmpgt_epi32(v, vMax));
+        outside |= (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(out)) << i;
+    }
+#endif
+    for (; i < count; i++) {
+        if ((values[i] < min) || (values[i] > max)) {
+            outside |= (uint32_t)1U << i;
+        }
+    }
+    return outside;
+}
+
+#endif /* (CO_CONFIG_PDO) & CO_CONFIG_RPDO_ENABLE && ... */
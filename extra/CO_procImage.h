@@ -0,0 +1,161 @@
+/**
+ * CANopen process image, received drive values of many axes in structure of arrays, with batch unit conversion.
+ *
+ * @file        CO_procImage.h
+ * @ingroup     CO_procImage
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_PROC_IMAGE_H
+#define CO_PROC_IMAGE_H
+
+#include "301/CO_PDO.h"
+
+#if ((((CO_CONFIG_PDO)&CO_CONFIG_RPDO_ENABLE) != 0) && (((CO_CONFIG_PDO)&CO_CONFIG_PDO_OD_IO_ACCESS) != 0)          \
+     && (((CO_CONFIG_PDO)&CO_CONFIG_PDO_COPY_PLAN) != 0))                                                              \
+    || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_procImage Process image
+ * Statusword, position, velocity and torque actual values of all axes in contiguous arrays.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * Master, which controls many drives, receives their TPDOs as own RPDOs. CO_process_RPDO() copies the RPDO data into
+ * the Object Dictionary variables, one variable per drive and value, spread over the Object Dictionary. Process image
+ * collects these values into one array per value (structure of arrays), so controller of all axes reads one block
+ * per cycle and can process the axes in batches.
+ *
+ * Each value of an axis is bound to one mapped entry of an RPDO with CO_procImage_bind(). Address of the OD variable
+ * is taken from the copy plan of the RPDO (see CO_CONFIG_PDO_COPY_PLAN in @ref CO_STACK_CONFIG_SYNC_PDO), so
+ * CO_procImage_update() copies directly from the memory, where the RPDO data was written, without OD access
+ * functions. Bound entry must be mapped whole and copied directly, without OD extension. Bindings must be renewed
+ * after the RPDO mapping changes.
+ *
+ * CO_procImage_update() is usually called after CO_process_RPDO(), for example from the SYNC callback, inside
+ * CO_LOCK_OD. Batch functions for unit conversion and limit checks work on any arrays, use SSE2 instructions if
+ * available and give the same results as the portable implementation.
+ *
+ * Example for the eRob drive with 524288 counts per revolution:
+ * @code{.c}
+    CO_procImage_update(&image);
+    CO_procImage_toUnits(image.position, positionRad, image.axisCount, CO_PROC_IMAGE_SCALE_RAD(524288));
+    CO_procImage_toUnits(image.velocity, velocityRadS, image.axisCount, CO_PROC_IMAGE_SCALE_RAD(524288));
+    uint32_t outside = CO_procImage_checkLimits(image.position, image.axisCount, MIN_POSITION, MAX_POSITION);
+ * @endcode
+ */
+
+/** Maximum number of axes in the process image, at most 32 (bitmask of CO_procImage_checkLimits()) */
+#ifndef CO_PROC_IMAGE_AXES
+#define CO_PROC_IMAGE_AXES 16U
+#endif
+
+/** Scale from encoder counts to turns (or from counts/s to turns/s) for the resolution in counts per revolution */
+#define CO_PROC_IMAGE_SCALE_TURNS(resolution) (1.0F / (float)(resolution))
+/** Scale from encoder counts to radians (or from counts/s to rad/s) for the resolution in counts per revolution */
+#define CO_PROC_IMAGE_SCALE_RAD(resolution)   (6.28318531F / (float)(resolution))
+
+/** Value in the process image */
+typedef enum {
+    CO_PROC_IMAGE_STATUSWORD = 0, /**< Statusword, 0x6041, UNSIGNED16 */
+    CO_PROC_IMAGE_POSITION = 1,   /**< Position actual value, 0x6064, INTEGER32 */
+    CO_PROC_IMAGE_VELOCITY = 2,   /**< Velocity actual value, 0x606C, INTEGER32 */
+    CO_PROC_IMAGE_TORQUE = 3,     /**< Torque actual value, 0x6077, INTEGER16 */
+    CO_PROC_IMAGE_FIELDS = 4      /**< Number of values */
+} CO_procImage_field_t;
+
+/** Process image object */
+typedef struct {
+    uint16_t statusword[CO_PROC_IMAGE_AXES]; /**< Statusword of each axis */
+    int32_t position[CO_PROC_IMAGE_AXES];    /**< Position actual value of each axis, in counts */
+    int32_t velocity[CO_PROC_IMAGE_AXES];    /**< Velocity actual value of each axis, in counts/s */
+    int16_t torque[CO_PROC_IMAGE_AXES];      /**< Torque actual value of each axis, in per thousand of rated torque */
+    uint8_t axisCount;                       /**< Number of axes, highest bound axis + 1 */
+    /** Memory of the OD variable, written by the RPDO copy plan, for each value and axis. NULL if not bound. */
+    const uint8_t* src[CO_PROC_IMAGE_FIELDS][CO_PROC_IMAGE_AXES];
+} CO_procImage_t;
+
+/**
+ * Initialize process image, all values are zero and not bound.
+ *
+ * @param image This object.
+ */
+void CO_procImage_init(CO_procImage_t* image);
+
+/**
+ * Bind value of the axis to the mapped entry of the RPDO.
+ *
+ * @param image This object.
+ * @param axis Axis, 0 to CO_PROC_IMAGE_AXES - 1.
+ * @param field Value of the axis.
+ * @param RPDO Received PDO, initialized and valid.
+ * @param mapIndex Mapped entry, sub-index of the RPDO mapping parameter - 1.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT, if arguments are wrong, RPDO is not valid, size
+ * of the mapped entry differs from the value or entry is not copied directly by the copy plan.
+ */
+CO_ReturnError_t CO_procImage_bind(CO_procImage_t* image, uint8_t axis, CO_procImage_field_t field,
+                                   const CO_RPDO_t* RPDO, uint8_t mapIndex);
+
+/**
+ * Copy all bound values from the Object Dictionary into the process image.
+ *
+ * @param image This object.
+ */
+void CO_procImage_update(CO_procImage_t* image);
+
+/**
+ * Convert integer values (counts, counts/s) into engineering units: units[i] = counts[i] * scale.
+ *
+ * @param counts Source array.
+ * @param [out] units Destination array, must not overlap with counts.
+ * @param count Number of values.
+ * @param scale Scale, for example CO_PROC_IMAGE_SCALE_RAD().
+ */
+void CO_procImage_toUnits(const int32_t* counts, float* units, uint16_t count, float scale);
+
+/**
+ * Convert engineering units into integer values: counts[i] = units[i] * (1 / scale), rounded to nearest, halfway away
+ * from zero, saturated to the INTEGER32 range. NaN gives the minimum.
+ *
+ * @param units Source array.
+ * @param [out] counts Destination array, must not overlap with units.
+ * @param count Number of values.
+ * @param scale Scale, for example CO_PROC_IMAGE_SCALE_RAD(), not zero.
+ */
+void CO_procImage_toCounts(const float* units, int32_t* counts, uint16_t count, float scale);
+
+/**
+ * Check, if values are inside limits.
+ *
+ * @param values Array of values, for example position of all axes.
+ * @param count Number of values, at most 32.
+ * @param min Minimum allowed value.
+ * @param max Maximum allowed value.
+ *
+ * @return Bitmask, bit i is set, if values[i] is below min or above max. 0, if all values are inside limits.
+ */
+uint32_t CO_procImage_checkLimits(const int32_t* values, uint16_t count, int32_t min, int32_t max);
+
+/** @} */ /* CO_procImage */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_PDO) & CO_CONFIG_RPDO_ENABLE && ... */
+
+#endif /* CO_PROC_IMAGE_H */
@@ -0,0 +1,131 @@
+/*
+ * CANopen hot-path profiling, execution time of each processing step.
+ *
+ * @file        CO_prof.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_prof.h"
+
+#if ((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0
+
+static const char* const CO_prof_names[CO_PROF_COUNT] = {
+    "PROCESS", "CAN",  "LSS",     "LEDS", "EM",   "NMT",  "SDO_SRV", "HB_CONS", "NG",  "NET_STATE",
+    "EM_CONS", "TIME", "SDO_CLI", "GTWA", "GTWB", "SYNC", "RPDO",    "TPDO",    "SRDO"};
+
+void
+CO_prof_init(CO_prof_t* prof) {
+    if (prof == NULL) {
+        return;
+    }
+    for (uint8_t i = 0; i < (uint8_t)CO_PROF_COUNT; i++) {
+        (void)memset(&prof->stats[i], 0, sizeof(prof->stats[i]));
+        prof->stats[i].min_ns = UINT32_MAX;
+    }
+}
+
+void
+CO_prof_get(const CO_prof_t* prof, CO_prof_section_t section, CO_profStats_t* stats, uint32_t* mean_ns) {
+    if ((prof == NULL) || (stats == NULL) || (section >= CO_PROF_COUNT)) {
+        return;
+    }
+    *stats = prof->stats[section];
+    if (mean_ns != NULL) {
+        *mean_ns = (stats->count > 0U) ? (uint32_t)(stats->sum_ns / stats->count) : 0U;
+    }
+}
+
+const char*
+CO_prof_name(CO_prof_section_t section) {
+    return (section < CO_PROF_COUNT) ? CO_prof_names[section] : "?";
+}
+
+/*
+ * Custom function for reading OD record with statistics
+ *
+ * For more information see file CO_ODinterface.h, OD_IO_t.
+ */
+static ODR_t
+OD_read_prof(OD_stream_t* stream, void* buf, OD_size_t count, OD_size_t* countRead) {
+    if ((stream == NULL) || (buf == NULL) || (countRead == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    CO_prof_t* prof = (CO_prof_t*)stream->object;
+
+    if (stream->subIndex == 0U) {
+        if (count < sizeof(uint8_t)) {
+            return ODR_DEV_INCOMPAT;
+        }
+        (void)CO_setUint8(buf, (uint8_t)CO_PROF_COUNT);
+        *countRead = sizeof(uint8_t);
+        return ODR_OK;
+    }
+    if (stream->subIndex > (uint8_t)CO_PROF_COUNT) {
+        return ODR_SUB_NOT_EXIST;
+    }
+    if (count < CO_PROF_OD_SIZE) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    CO_profStats_t st = {0};
+    uint32_t mean_ns = 0;
+    uint8_t* b = (uint8_t*)buf;
+
+    CO_prof_get(prof, (CO_prof_section_t)(stream->subIndex - 1U), &st, &mean_ns);
+    (void)CO_setUint32(&b[0], st.count);
+    (void)CO_setUint32(&b[4], (st.count > 0U) ? st.min_ns : 0U);
+    (void)CO_setUint32(&b[8], st.max_ns);
+    (void)CO_setUint32(&b[12], mean_ns);
+    for (uint8_t i = 0; i < CO_PROF_HIST_BINS; i++) {
+        (void)CO_setUint32(&b[16U + (4U * i)], st.hist[i]);
+    }
+    *countRead = CO_PROF_OD_SIZE;
+    return ODR_OK;
+}
+
+/*
+ * Custom function for writing OD record with statistics, 0 to sub-index 0 clears statistics
+ *
+ * For more information see file CO_ODinterface.h, OD_IO_t.
+ */
+static ODR_t
+OD_write_prof(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_t* countWritten) {
+    if ((stream == NULL) || (buf == NULL) || (countWritten == NULL) || (count != sizeof(uint8_t))) {
+        return ODR_DEV_INCOMPAT;
+    }
+    if (stream->subIndex != 0U) {
+        return ODR_READONLY;
+    }
+    if (CO_getUint8(buf) != 0U) {
+        return ODR_INVALID_VALUE;
+    }
+
+    CO_prof_init((CO_prof_t*)stream->object);
+    *countWritten = sizeof(uint8_t);
+    return ODR_OK;
+}
+
+CO_ReturnError_t
+CO_prof_initOD(CO_prof_t* prof, OD_entry_t* OD_prof) {
+    if ((prof == NULL) || (OD_prof == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    prof->OD_prof_extension.object = prof;
+    prof->OD_prof_extension.read = OD_read_prof;
+    prof->OD_prof_extension.write = OD_write_prof;
+    return (OD_extension_init(OD_prof, &prof->OD_prof_extension) == ODR_OK) ? CO_ERROR_NO : CO_ERROR_ILLEGAL_ARGUMENT;
+}
+
+#endif /* (CO_CONFIG_PROF) & CO_CONFIG_PROF_ENABLE */
@@ -0,0 +1,203 @@
+/**
+ * CANopen hot-path profiling, execution time of each processing step.
+ *
+ * @file        CO_prof.h
+ * @ingroup     CO_prof
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_PROF_H
+#define CO_PROF_H
+
+#include "301/CO_driver.h"
+#include "301/CO_ODinterface.h"
+
+/* default configuration, see CO_config.h */
+#ifndef CO_CONFIG_PROF
+#define CO_CONFIG_PROF (0)
+#endif
+
+#if (((CO_CONFIG_PROF)&CO_CONFIG_PROF_ENABLE) != 0) || defined CO_DOXYGEN
+
+#if !defined CO_PROF_TIME_NS && !defined CO_DOXYGEN
+#error CO_CONFIG_PROF requires CO_PROF_TIME_NS() in CO_driver_target.h
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_prof Hot-path profiling
+ * Execution time of each step of CO_process(), CO_process_SYNC(), CO_process_RPDO(), CO_process_TPDO() and
+ * CO_process_SRDO().
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * When processing pass overruns, the time must be assigned to the object, which caused it. CANopen.c calls
+ * CO_prof_lap() after each step, so each step costs one read of the CO_PROF_TIME_NS() clock, which is provided by the
+ * target (for example CLOCK_MONOTONIC). For each @ref CO_prof_section_t count, minimum, maximum, sum and a histogram
+ * with @ref CO_PROF_HIST_BINS power-of-two bins are kept. Step, which is not configured or is skipped (for example
+ * SDO servers of unconfigured node), is not counted.
+ *
+ * Statistics are available with CO_prof_get() and over SDO or the gateway from the manufacturer specific OD record,
+ * see CO_prof_initOD(). Steps of CO_process() are recorded by the mainline, others by the thread, which processes
+ * SYNC and PDOs. If this is a different thread, values read from it are informative, they may be from two updates.
+ */
+
+/** Number of histogram bins, see CO_profStats_t::hist */
+#define CO_PROF_HIST_BINS 8U
+
+/** Upper limit of the first histogram bin in nanoseconds, each next bin has double limit */
+#ifndef CO_PROF_HIST_BASE_NS
+#define CO_PROF_HIST_BASE_NS 1000U
+#endif
+
+/** Size of one sub-index of the OD record in bytes, see CO_prof_initOD() */
+#define CO_PROF_OD_SIZE (4U * (4U + CO_PROF_HIST_BINS))
+
+/** Profiled steps, sub-index of the OD record is section + 1 */
+typedef enum {
+    CO_PROF_PROCESS = 0,    /**< Whole CO_process() */
+    CO_PROF_CAN = 1,        /**< CO_CANmodule_process() */
+    CO_PROF_LSS = 2,        /**< CO_LSSslave_process() */
+    CO_PROF_LEDS = 3,       /**< CO_LEDs_process() */
+    CO_PROF_EM = 4,         /**< CO_EM_process() */
+    CO_PROF_NMT = 5,        /**< CO_NMT_process() */
+    CO_PROF_SDO_SRV = 6,    /**< CO_SDOserver_process() of all SDO servers */
+    CO_PROF_HB_CONS = 7,    /**< CO_HBconsumer_process() */
+    CO_PROF_NG = 8,         /**< Node guarding slave and master */
+    CO_PROF_NET_STATE = 9,  /**< CO_netState_process() */
+    CO_PROF_EM_CONS = 10,   /**< CO_EMcons_process() */
+    CO_PROF_TIME = 11,      /**< CO_TIME_process() */
+    CO_PROF_SDO_CLI = 12,   /**< CO_SDOengine_process() of the SDO client pool */
+    CO_PROF_GTWA = 13,      /**< CO_GTWA_process() */
+    CO_PROF_GTWB = 14,      /**< CO_GTWB_process() */
+    CO_PROF_SYNC = 15,      /**< CO_process_SYNC() */
+    CO_PROF_RPDO = 16,      /**< CO_process_RPDO(), loop over RPDOs */
+    CO_PROF_TPDO = 17,      /**< CO_process_TPDO(), loop over TPDOs */
+    CO_PROF_SRDO = 18,      /**< CO_process_SRDO(), loop over SRDOs */
+    CO_PROF_COUNT = 19      /**< Number of sections */
+} CO_prof_section_t;
+
+/** Statistics of one section */
+typedef struct {
+    uint32_t count;                    /**< Number of calls */
+    uint32_t min_ns;                   /**< Shortest call, UINT32_MAX if count is 0 */
+    uint32_t max_ns;                   /**< Longest call */
+    uint64_t sum_ns;                   /**< Sum of all calls, for the mean */
+    uint32_t hist[CO_PROF_HIST_BINS];  /**< Bin n counts calls shorter than CO_PROF_HIST_BASE_NS << n, last bin the
+                                          rest */
+} CO_profStats_t;
+
+/** Profiling object */
+typedef struct {
+    CO_profStats_t stats[CO_PROF_COUNT]; /**< Statistics of each section */
+    OD_extension_t OD_prof_extension;    /**< Extension for OD object, see CO_prof_initOD() */
+} CO_prof_t;
+
+/**
+ * Initialize profiling object, all statistics are cleared
+ *
+ * @param prof This object will be initialized.
+ */
+void CO_prof_init(CO_prof_t* prof);
+
+/**
+ * Add one call to the statistics of the section
+ *
+ * @param prof This object, may be NULL.
+ * @param section Section.
+ * @param duration_ns Execution time.
+ */
+static inline void
+CO_prof_add(CO_prof_t* prof, CO_prof_section_t section, uint32_t duration_ns) {
+    if ((prof == NULL) || (section >= CO_PROF_COUNT)) {
+        return;
+    }
+    CO_profStats_t* st = &prof->stats[section];
+    uint32_t limit = CO_PROF_HIST_BASE_NS;
+    uint8_t bin = 0;
+
+    while ((bin < (CO_PROF_HIST_BINS - 1U)) && (duration_ns >= limit)) {
+        limit <<= 1;
+        bin++;
+    }
+    st->hist[bin]++;
+    st->count++;
+    st->sum_ns += duration_ns;
+    if (duration_ns < st->min_ns) {
+        st->min_ns = duration_ns;
+    }
+    if (duration_ns > st->max_ns) {
+        st->max_ns = duration_ns;
+    }
+}
+
+/**
+ * Record the step, which ended now
+ *
+ * @param prof This object, may be NULL.
+ * @param section Section of the step.
+ * @param [in,out] time_ns Time from CO_PROF_TIME_NS() at start of the step. It is set to the current time, which is
+ * the start of the next step.
+ */
+static inline void
+CO_prof_lap(CO_prof_t* prof, CO_prof_section_t section, uint32_t* time_ns) {
+    uint32_t now_ns = CO_PROF_TIME_NS();
+    CO_prof_add(prof, section, now_ns - *time_ns);
+    *time_ns = now_ns;
+}
+
+/**
+ * Get statistics of the section
+ *
+ * @param prof This object.
+ * @param section Section.
+ * @param [out] stats Copy of the statistics.
+ * @param [out] mean_ns Mean execution time, may be NULL.
+ */
+void CO_prof_get(const CO_prof_t* prof, CO_prof_section_t section, CO_profStats_t* stats, uint32_t* mean_ns);
+
+/**
+ * Get name of the section, for example "SDO_SRV"
+ *
+ * @param section Section.
+ *
+ * @return Name or "?".
+ */
+const char* CO_prof_name(CO_prof_section_t section);
+
+/**
+ * Make statistics accessible from OD record
+ *
+ * Record must have @ref CO_PROF_COUNT sub-indexes after sub-index 0, each is an OCTET_STRING of @ref CO_PROF_OD_SIZE
+ * bytes. Sub-index n contains statistics of section n - 1 as little-endian UNSIGNED32 values: count, min_ns
+ * (0 if count is 0), max_ns, mean_ns and then @ref CO_PROF_HIST_BINS histogram bins. Writing UNSIGNED8 0 to sub-index 0
+ * (it must be writable in the OD) clears all statistics.
+ *
+ * @param prof This object.
+ * @param OD_prof OD entry, for example from manufacturer specific area.
+ *
+ * @return CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_prof_initOD(CO_prof_t* prof, OD_entry_t* OD_prof);
+
+/** @} */ /* CO_prof */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* (CO_CONFIG_PROF) & CO_CONFIG_PROF_ENABLE */
+
+#endif /* CO_PROF_H */
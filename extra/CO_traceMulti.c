@@ -0,0 +1,433 @@
+/*
+ * Multi-channel trace of OD variables into interleaved records with binary export.
+ *
+ * @file        CO_traceMulti.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <string.h>
+
+#include "extra/CO_traceMulti.h"
+
+/* Read channel variable as int32_t, variable may be unaligned */
+static inline int32_t
+CO_traceMulti_readChannel(const CO_traceMulti_channel_t* ch) {
+    switch (ch->type) {
+        case CO_TRACE_MULTI_TYPE_U8: return (int32_t)(*(const uint8_t*)ch->ptr);
+        case CO_TRACE_MULTI_TYPE_I8: return (int32_t)(*(const int8_t*)ch->ptr);
+        case CO_TRACE_MULTI_TYPE_U16: {
+            uint16_t v;
+            (void)memcpy(&v, ch->ptr, sizeof(v));
+            return (int32_t)CO_SWAP_16(v);
+        }
+        case CO_TRACE_MULTI_TYPE_I16: {
+            uint16_t v;
+            (void)memcpy(&v, ch->ptr, sizeof(v));
+            return (int32_t)(int16_t)CO_SWAP_16(v);
+        }
+        default: {
+            uint32_t v;
+            (void)memcpy(&v, ch->ptr, sizeof(v));
+            return (int32_t)CO_SWAP_32(v);
+        }
+    }
+}
+
+/* Put uint32_t into buffer, little-endian */
+static inline void
+CO_traceMulti_putU32(uint8_t* buf, uint32_t value) {
+    buf[0] = (uint8_t)value;
+    buf[1] = (uint8_t)(value >> 8);
+    buf[2] = (uint8_t)(value >> 16);
+    buf[3] = (uint8_t)(value >> 24);
+}
+
+CO_ReturnError_t
+CO_traceMulti_init(CO_traceMulti_t* tr, int32_t* buf, uint32_t bufWords, int32_t* live, uint32_t period_us) {
+    if ((tr == NULL) || (buf == NULL) || (bufWords == 0U)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    (void)memset(tr, 0, sizeof(CO_traceMulti_t));
+    tr->buf = buf;
+    tr->bufWords = bufWords;
+    tr->live = live;
+    tr->period_us = period_us;
+    tr->recordWords = 1;
+    tr->state = CO_TRACE_MULTI_IDLE;
+    CO_FLAG_CLEAR(tr->armRequest);
+    CO_FLAG_CLEAR(tr->stopRequest);
+    CO_FLAG_CLEAR(tr->frozen);
+
+    return CO_ERROR_NO;
+}
+
+CO_ReturnError_t
+CO_traceMulti_addChannel(CO_traceMulti_t* tr, const void* ptr, uint32_t map, uint8_t type) {
+    uint8_t size = type & (uint8_t)(~CO_TRACE_MULTI_TYPE_SIGNED);
+
+    if ((tr == NULL) || (ptr == NULL) || ((size != 1U) && (size != 2U) && (size != 4U))) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    if (tr->channelCount >= CO_TRACE_MULTI_CHANNELS) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+
+    CO_traceMulti_channel_t* ch = &tr->channels[tr->channelCount];
+    ch->ptr = ptr;
+    ch->map = map;
+    ch->type = type;
+    tr->channelCount++;
+    tr->recordWords = (uint16_t)tr->channelCount + 1U;
+
+    return CO_ERROR_NO;
+}
+
+CO_ReturnError_t
+CO_traceMulti_addChannelOD(CO_traceMulti_t* tr, OD_t* od, uint16_t index, uint8_t subIndex, bool_t isSigned) {
+    OD_entry_t* entry = OD_find(od, index);
+    OD_IO_t io;
+
+    if ((tr == NULL) || (entry == NULL) || (OD_getSub(entry, subIndex, &io, true) != ODR_OK)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    OD_size_t len = io.stream.dataLength;
+    const void* ptr = OD_getPtr(entry, subIndex, len, NULL);
+    if ((ptr == NULL) || ((len != 1U) && (len != 2U) && (len != 4U))) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    uint32_t map = ((uint32_t)index << 16) | ((uint32_t)subIndex << 8) | (len * 8U);
+    uint8_t type = (uint8_t)len | (isSigned ? CO_TRACE_MULTI_TYPE_SIGNED : 0U);
+    return CO_traceMulti_addChannel(tr, ptr, map, type);
+}
+
+CO_ReturnError_t
+CO_traceMulti_setTrigger(CO_traceMulti_t* tr, CO_traceMulti_trigger_t edge, uint8_t channel, int32_t level,
+                         uint32_t preRecords, uint32_t postRecords) {
+    if ((tr == NULL) || (edge > CO_TRACE_MULTI_TRIG_BOTH)
+        || ((edge != CO_TRACE_MULTI_TRIG_NONE) && (channel >= tr->channelCount))) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    uint32_t pre = (edge != CO_TRACE_MULTI_TRIG_NONE) ? preRecords : 0U;
+    uint32_t capacity = tr->bufWords / tr->recordWords;
+    if ((pre >= capacity) || (postRecords >= (capacity - pre))) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    tr->trigEdge = (uint8_t)edge;
+    tr->trigChannel = channel;
+    tr->trigLevel = level;
+    tr->preRecords = pre;
+    tr->postRecords = postRecords;
+
+    return CO_ERROR_NO;
+}
+
+void
+CO_traceMulti_initCallbackSample(CO_traceMulti_t* tr, void* object,
+                                 void (*pFunctSample)(void* object, const int32_t* record, uint16_t words)) {
+    if (tr != NULL) {
+        tr->functSampleObject = object;
+        tr->pFunctSample = pFunctSample;
+    }
+}
+
+void
+CO_traceMulti_arm(CO_traceMulti_t* tr) {
+    if (tr != NULL) {
+        CO_FLAG_CLEAR(tr->frozen);
+        CO_FLAG_SET(tr->armRequest);
+    }
+}
+
+void
+CO_traceMulti_stop(CO_traceMulti_t* tr) {
+    if (tr != NULL) {
+        CO_FLAG_SET(tr->stopRequest);
+    }
+}
+
+/* Freeze the capture: export window ends with the last stored record */
+static void
+CO_traceMulti_freeze(CO_traceMulti_t* tr) {
+    uint32_t count = tr->recCount;
+
+    if (tr->triggered) {
+        /* window is preRecords before the trigger, trigger record and post-trigger records */
+        uint32_t window = tr->preRecords + 1U + (tr->postRecords - tr->postLeft);
+        if (count > window) {
+            count = window;
+        }
+    }
+    tr->exportCount = count;
+    tr->firstRec = (tr->writeRec + tr->capacity - count) % tr->capacity;
+    tr->state = CO_TRACE_MULTI_FROZEN;
+    CO_FLAG_SET(tr->frozen);
+}
+
+/* Take one sample */
+static void
+CO_traceMulti_sample(CO_traceMulti_t* tr) {
+    bool_t capturing;
+    int32_t* rec;
+
+    if (CO_FLAG_READ(tr->armRequest)) {
+        CO_FLAG_CLEAR(tr->armRequest);
+        CO_FLAG_CLEAR(tr->stopRequest);
+        tr->capacity = tr->bufWords / tr->recordWords;
+        tr->writeRec = 0;
+        tr->recCount = 0;
+        tr->triggered = false;
+        tr->trigRec = 0;
+        tr->postLeft = tr->postRecords;
+        tr->state = CO_TRACE_MULTI_ARMED;
+    }
+    if (CO_FLAG_READ(tr->stopRequest)) {
+        CO_FLAG_CLEAR(tr->stopRequest);
+        if ((tr->state == CO_TRACE_MULTI_ARMED) || (tr->state == CO_TRACE_MULTI_TRIGGERED)) {
+            CO_traceMulti_freeze(tr);
+        }
+    }
+
+    capturing = (tr->state == CO_TRACE_MULTI_ARMED) || (tr->state == CO_TRACE_MULTI_TRIGGERED);
+    if (capturing) {
+        rec = &tr->buf[tr->writeRec * tr->recordWords];
+    } else if ((tr->pFunctSample != NULL) && (tr->live != NULL)) {
+        rec = tr->live;
+    } else {
+        return;
+    }
+
+    rec[0] = (int32_t)tr->now_us;
+    for (uint8_t i = 0; i < tr->channelCount; i++) {
+        rec[i + 1U] = CO_traceMulti_readChannel(&tr->channels[i]);
+    }
+    tr->samples++;
+
+    if (capturing) {
+        uint32_t thisRec = tr->writeRec;
+
+        tr->writeRec = (tr->writeRec + 1U < tr->capacity) ? (tr->writeRec + 1U) : 0U;
+        if (tr->recCount < tr->capacity) {
+            tr->recCount++;
+        }
+
+        if (tr->state == CO_TRACE_MULTI_ARMED) {
+            int32_t value = rec[tr->trigChannel + 1U];
+            bool_t trig = false;
+
+            if (tr->trigEdge == (uint8_t)CO_TRACE_MULTI_TRIG_NONE) {
+                trig = true;
+            } else if (tr->recCount > (tr->preRecords + 1U)) {
+                /* previous value exists and pre-trigger records are stored */
+                bool_t rising = (tr->trigPrev < tr->trigLevel) && (value >= tr->trigLevel);
+                bool_t falling = (tr->trigPrev > tr->trigLevel) && (value <= tr->trigLevel);
+                trig = (((tr->trigEdge & (uint8_t)CO_TRACE_MULTI_TRIG_RISING) != 0U) && rising)
+                       || (((tr->trigEdge & (uint8_t)CO_TRACE_MULTI_TRIG_FALLING) != 0U) && falling);
+            } else { /* MISRA C 2004 14.10 */
+            }
+            tr->trigPrev = value;
+
+            if (trig) {
+                tr->triggered = true;
+                tr->trigRec = thisRec;
+                tr->state = CO_TRACE_MULTI_TRIGGERED;
+                if (tr->postLeft == 0U) {
+                    CO_traceMulti_freeze(tr);
+                }
+            }
+        } else {
+            tr->postLeft--;
+            if (tr->postLeft == 0U) {
+                CO_traceMulti_freeze(tr);
+            }
+        }
+    }
+
+    if (tr->pFunctSample != NULL) {
+        tr->pFunctSample(tr->functSampleObject, rec, tr->recordWords);
+    }
+}
+
+void
+CO_traceMulti_process(CO_traceMulti_t* tr, bool_t syncWas, uint32_t timeDifference_us, uint32_t* timerNext_us) {
+    if ((tr == NULL) || (tr->channelCount == 0U)) {
+        return;
+    }
+    tr->now_us += timeDifference_us;
+
+    if (tr->period_us == 0U) {
+        if (syncWas) {
+            CO_traceMulti_sample(tr);
+        }
+        return;
+    }
+
+    tr->timer_us += timeDifference_us;
+    if (tr->timer_us >= tr->period_us) {
+        tr->timer_us -= tr->period_us;
+        if (tr->timer_us >= tr->period_us) {
+            /* samples were missed, don't repeat them */
+            tr->timer_us = 0;
+        }
+        CO_traceMulti_sample(tr);
+    }
+    if ((timerNext_us != NULL) && (*timerNext_us > (tr->period_us - tr->timer_us))) {
+        *timerNext_us = tr->period_us - tr->timer_us;
+    }
+}
+
+uint32_t
+CO_traceMulti_rewind(CO_traceMulti_t* tr) {
+    if ((tr == NULL) || !CO_FLAG_READ(tr->frozen)) {
+        return 0;
+    }
+
+    uint8_t* h = tr->header;
+    uint32_t trigPos = 0xFFFFFFFFU;
+    if (tr->triggered) {
+        uint32_t pos = (tr->trigRec + tr->capacity - tr->firstRec) % tr->capacity;
+        if (pos < tr->exportCount) {
+            trigPos = pos;
+        }
+    }
+
+    h[0] = (uint8_t)'C';
+    h[1] = (uint8_t)'O';
+    h[2] = (uint8_t)'T';
+    h[3] = (uint8_t)'M';
+    h[4] = 1U;
+    h[5] = tr->channelCount;
+    h[6] = 0U;
+    h[7] = 0U;
+    CO_traceMulti_putU32(&h[8], tr->exportCount);
+    CO_traceMulti_putU32(&h[12], trigPos);
+    CO_traceMulti_putU32(&h[16], tr->period_us);
+    h = &h[20];
+    for (uint8_t i = 0; i < tr->channelCount; i++) {
+        CO_traceMulti_putU32(h, tr->channels[i].map);
+        h[4] = tr->channels[i].type;
+        h = &h[5];
+    }
+    tr->headerLen = (uint16_t)(20U + (5U * (uint16_t)tr->channelCount));
+    tr->readPos = 0;
+    tr->readRec = 0;
+    tr->readWord = 0;
+
+    return tr->exportCount;
+}
+
+size_t
+CO_traceMulti_read(CO_traceMulti_t* tr, uint8_t* buf, size_t size) {
+    size_t n = 0;
+
+    if ((tr == NULL) || (buf == NULL) || !CO_FLAG_READ(tr->frozen)) {
+        return 0;
+    }
+
+    /* header */
+    if (tr->readPos < tr->headerLen) {
+        n = tr->headerLen - tr->readPos;
+        if (n > size) {
+            n = size;
+        }
+        (void)memcpy(buf, &tr->header[tr->readPos], n);
+        tr->readPos += (uint32_t)n;
+    }
+
+    /* records, each word as zigzag varint of the difference from the previous record */
+    while ((tr->readRec < tr->exportCount) && ((size - n) >= 5U)) {
+        uint32_t ring = (tr->firstRec + tr->readRec) % tr->capacity;
+        uint32_t value = (uint32_t)tr->buf[(ring * tr->recordWords) + tr->readWord];
+        uint32_t prev = 0;
+        if (tr->readRec > 0U) {
+            uint32_t ringPrev = (ring > 0U) ? (ring - 1U) : (tr->capacity - 1U);
+            prev = (uint32_t)tr->buf[(ringPrev * tr->recordWords) + tr->readWord];
+        }
+        uint32_t diff = value - prev;
+        uint32_t zz = (diff << 1) ^ (((diff & 0x80000000U) != 0U) ? 0xFFFFFFFFU : 0U);
+
+        while (zz >= 0x80U) {
+            buf[n] = (uint8_t)(zz | 0x80U);
+            n++;
+            zz >>= 7;
+        }
+        buf[n] = (uint8_t)zz;
+        n++;
+
+        tr->readWord++;
+        if (tr->readWord >= tr->recordWords) {
+            tr->readWord = 0;
+            tr->readRec++;
+        }
+    }
+
+    return n;
+}
+
+/* OD read function: binary export of the frozen capture, read in segments */
+static ODR_t
+CO_traceMulti_readOD(OD_stream_t* stream, void* buf, OD_size_t count, OD_size_t* countRead) {
+    if ((stream == NULL) || (buf == NULL) || (countRead == NULL)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    CO_traceMulti_t* tr = (CO_traceMulti_t*)stream->object;
+
+    if (!CO_FLAG_READ(tr->frozen)) {
+        return ODR_DATA_DEV_STATE;
+    }
+    if (stream->dataOffset == 0U) {
+        (void)CO_traceMulti_rewind(tr);
+    }
+
+    size_t n = CO_traceMulti_read(tr, (uint8_t*)buf, count);
+    *countRead = (OD_size_t)n;
+    if ((tr->readRec < tr->exportCount) || (tr->readPos < tr->headerLen)) {
+        stream->dataOffset += (OD_size_t)n;
+        return ODR_PARTIAL;
+    }
+    stream->dataOffset = 0;
+    return ODR_OK;
+}
+
+/* OD write function: 1 arms the trace, 0 stops it */
+static ODR_t
+CO_traceMulti_writeOD(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_t* countWritten) {
+    if ((stream == NULL) || (buf == NULL) || (countWritten == NULL) || (count != 1U)) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    CO_traceMulti_t* tr = (CO_traceMulti_t*)stream->object;
+    uint8_t command = *(const uint8_t*)buf;
+
+    if (command == 1U) {
+        CO_traceMulti_arm(tr);
+    } else if (command == 0U) {
+        CO_traceMulti_stop(tr);
+    } else {
+        return ODR_INVALID_VALUE;
+    }
+    *countWritten = count;
+    return ODR_OK;
+}
+
+CO_ReturnError_t
+CO_traceMulti_initOD(CO_traceMulti_t* tr, OD_entry_t* OD_trace) {
+    if ((tr == NULL) || (OD_trace == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    tr->OD_trace_extension.object = tr;
+    tr->OD_trace_extension.read = CO_traceMulti_readOD;
+    tr->OD_trace_extension.write = CO_traceMulti_writeOD;
+    return (OD_extension_init(OD_trace, &tr->OD_trace_extension) == ODR_OK) ? CO_ERROR_NO : CO_ERROR_ILLEGAL_ARGUMENT;
+}
@@ -0,0 +1,298 @@
+/**
+ * Multi-channel trace of OD variables into interleaved records with binary export.
+ *
+ * @file        CO_traceMulti.h
+ * @ingroup     CO_traceMulti
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_TRACE_MULTI_H
+#define CO_TRACE_MULTI_H
+
+#include "301/CO_driver.h"
+#include "301/CO_ODinterface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_traceMulti Multi-channel trace
+ * Sampling of many OD variables per tick into one record, with pre/post-trigger capture and delta encoded export.
+ *
+ * @ingroup CO_CANopen_extra
+ * @{
+ * @ref CO_trace records one variable per object, reads it through a function pointer and formats the curve as text.
+ * Multi-channel trace instead samples all channels at once into one interleaved record: timestamp followed by the
+ * value of each channel, as int32_t. Records are stored in a ring buffer provided by the application. Channel pointers
+ * into the OD are resolved once with CO_traceMulti_addChannelOD(), so sampling is only a copy of a few words, for
+ * example 6 axes with position, velocity, current and statusword is one record of 25 words.
+ *
+ * CO_traceMulti_process() is called from the real-time thread, after CO_process_SYNC(). It samples on each SYNC or
+ * every period of the timer, see CO_traceMulti_init(). Capture is started with CO_traceMulti_arm(): records are
+ * stored continuously, until trigger channel crosses the trigger level. Then the configured number of post-trigger
+ * records is stored and trace freezes with the configured number of pre-trigger records before the trigger. Without
+ * trigger, capture begins immediately and freezes after the post-trigger records.
+ *
+ * Frozen trace is read with CO_traceMulti_read() in binary format, optionally from the OD domain entry, see
+ * CO_traceMulti_initOD(). All values are little-endian:
+ * - header: "COTM", version (1), number of channels, two zero bytes, number of records (uint32), index of the trigger
+ *   record or 0xFFFFFFFF (uint32), sample period in microseconds or 0 for SYNC (uint32), then mapping (uint32, as in
+ *   PDO) and type (uint8, @ref CO_TRACE_MULTI_TYPE) for each channel.
+ * - records: each word of the record (timestamp, channel values) is encoded as difference from the same word of the
+ *   previous record (zero for the first record), zigzag mapped to unsigned and written as base-128 varint, low
+ *   group first. Slowly changing values take one byte.
+ *
+ * Control functions (arm, stop, setTrigger, read) are called from mainline. Real-time thread takes arm and stop
+ * requests at the next sample. Records are read only after the trace is frozen, so no lock is needed.
+ */
+
+/** Maximum number of channels */
+#ifndef CO_TRACE_MULTI_CHANNELS
+#define CO_TRACE_MULTI_CHANNELS 32U
+#endif
+
+/**
+ * @defgroup CO_TRACE_MULTI_TYPE Channel types
+ * Size of the variable in bytes, ORed with CO_TRACE_MULTI_TYPE_SIGNED for signed integers.
+ * @{
+ */
+#define CO_TRACE_MULTI_TYPE_U8     0x01U
+#define CO_TRACE_MULTI_TYPE_U16    0x02U
+#define CO_TRACE_MULTI_TYPE_U32    0x04U
+#define CO_TRACE_MULTI_TYPE_SIGNED 0x80U
+#define CO_TRACE_MULTI_TYPE_I8     (CO_TRACE_MULTI_TYPE_U8 | CO_TRACE_MULTI_TYPE_SIGNED)
+#define CO_TRACE_MULTI_TYPE_I16    (CO_TRACE_MULTI_TYPE_U16 | CO_TRACE_MULTI_TYPE_SIGNED)
+#define CO_TRACE_MULTI_TYPE_I32    (CO_TRACE_MULTI_TYPE_U32 | CO_TRACE_MULTI_TYPE_SIGNED)
+/** @} */
+
+/** Size of the export header in bytes */
+#define CO_TRACE_MULTI_HEADER_SIZE (20U + (5U * CO_TRACE_MULTI_CHANNELS))
+
+/** Trigger edge */
+typedef enum {
+    CO_TRACE_MULTI_TRIG_NONE = 0,    /**< No trigger, capture starts immediately */
+    CO_TRACE_MULTI_TRIG_RISING = 1,  /**< Value was below level and is now at or above level */
+    CO_TRACE_MULTI_TRIG_FALLING = 2, /**< Value was above level and is now at or below level */
+    CO_TRACE_MULTI_TRIG_BOTH = 3     /**< Rising or falling */
+} CO_traceMulti_trigger_t;
+
+/** State of the capture */
+typedef enum {
+    CO_TRACE_MULTI_IDLE = 0,      /**< Not armed, samples are only passed to the sample callback */
+    CO_TRACE_MULTI_ARMED = 1,     /**< Storing pre-trigger records, waiting for trigger */
+    CO_TRACE_MULTI_TRIGGERED = 2, /**< Storing post-trigger records */
+    CO_TRACE_MULTI_FROZEN = 3     /**< Capture is finished, records may be read */
+} CO_traceMulti_state_t;
+
+/** Traced variable */
+typedef struct {
+    const void* ptr; /**< Variable */
+    uint32_t map;    /**< Index, sub-index and length in bits, as in PDO mapping, for the export header */
+    uint8_t type;    /**< See @ref CO_TRACE_MULTI_TYPE */
+} CO_traceMulti_channel_t;
+
+/** Multi-channel trace object */
+typedef struct {
+    /** Configured channels */
+    CO_traceMulti_channel_t channels[CO_TRACE_MULTI_CHANNELS];
+    uint8_t channelCount;                       /**< Number of configured channels */
+    uint16_t recordWords;                       /**< Words in one record, timestamp and channels */
+    int32_t* buf;                               /**< Ring buffer of records, from CO_traceMulti_init() */
+    uint32_t bufWords;                          /**< Size of buf in words */
+    int32_t* live;                              /**< Record for the sample callback when not capturing, or NULL */
+    uint32_t period_us;                         /**< Sample period or 0 for sampling on SYNC */
+    uint32_t timer_us;                          /**< Time since the last sample */
+    uint32_t now_us;                            /**< Timestamp, advanced by CO_traceMulti_process() */
+    uint8_t trigChannel;                        /**< Trigger channel */
+    uint8_t trigEdge;                           /**< Trigger edge, see @ref CO_traceMulti_trigger_t */
+    int32_t trigLevel;                          /**< Trigger level */
+    uint32_t preRecords;                        /**< Number of records before the trigger record */
+    uint32_t postRecords;                       /**< Number of records after the trigger record */
+    volatile uint8_t state;                     /**< See @ref CO_traceMulti_state_t, written by real-time thread */
+    uint32_t capacity;                          /**< Number of records in buf, set on arm */
+    uint32_t writeRec;                          /**< Next record in the ring */
+    uint32_t recCount;                          /**< Number of stored records, up to capacity */
+    uint32_t postLeft;                          /**< Remaining post-trigger records */
+    uint32_t trigRec;                           /**< Ring index of the trigger record */
+    bool_t triggered;                           /**< True, if trigger record exists in the capture */
+    int32_t trigPrev;                           /**< Previous value of the trigger channel */
+    uint32_t firstRec;                          /**< Ring index of the first exported record */
+    uint32_t exportCount;                       /**< Number of exported records */
+    volatile void* armRequest;                  /**< Set by CO_traceMulti_arm() */
+    volatile void* stopRequest;                 /**< Set by CO_traceMulti_stop() */
+    volatile void* frozen;                      /**< Set by the real-time thread, when capture is finished */
+    uint8_t header[CO_TRACE_MULTI_HEADER_SIZE]; /**< Export header, prepared by CO_traceMulti_rewind() */
+    uint16_t headerLen;                         /**< Length of the header */
+    uint32_t readPos;                           /**< Bytes of the header consumed by CO_traceMulti_read() */
+    uint32_t readRec;                           /**< Next record for CO_traceMulti_read() */
+    uint16_t readWord;                          /**< Next word of the record for CO_traceMulti_read() */
+    uint32_t samples;                           /**< Total number of samples */
+    /** From CO_traceMulti_initCallbackSample() or NULL */
+    void (*pFunctSample)(void* object, const int32_t* record, uint16_t words);
+    void* functSampleObject;           /**< From CO_traceMulti_initCallbackSample() or NULL */
+    OD_extension_t OD_trace_extension; /**< Extension for OD object, see CO_traceMulti_initOD() */
+} CO_traceMulti_t;
+
+/**
+ * Initialize trace object without channels
+ *
+ * @param tr This object will be initialized.
+ * @param buf Memory for records, aligned to int32_t.
+ * @param bufWords Size of buf in words. Capacity is bufWords / (1 + number of channels) records.
+ * @param live Memory for one record, used for the sample callback while not capturing. Size is 1 +
+ * @ref CO_TRACE_MULTI_CHANNELS words. May be NULL, if the callback is not used.
+ * @param period_us Sample period in microseconds or 0 for sampling on each SYNC.
+ *
+ * @return CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_traceMulti_init(CO_traceMulti_t* tr, int32_t* buf, uint32_t bufWords, int32_t* live,
+                                    uint32_t period_us);
+
+/**
+ * Add channel with variable in memory
+ *
+ * Channels are added in the communication reset section, before CO_traceMulti_process() runs.
+ *
+ * @param tr This object.
+ * @param ptr Variable, may be unaligned.
+ * @param map Index, sub-index and length in bits, as in PDO mapping, only for the export header.
+ * @param type See @ref CO_TRACE_MULTI_TYPE.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_OUT_OF_MEMORY, if all channels are used.
+ */
+CO_ReturnError_t CO_traceMulti_addChannel(CO_traceMulti_t* tr, const void* ptr, uint32_t map, uint8_t type);
+
+/**
+ * Add channel with OD variable
+ *
+ * Pointer to the variable is resolved once with OD_getPtr(). IO extension of the entry is not used.
+ *
+ * @param tr This object.
+ * @param od Object Dictionary.
+ * @param index Index of the OD variable.
+ * @param subIndex Sub-index of the OD variable.
+ * @param isSigned True for signed integer.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT (no such variable or length not 1, 2 or 4) or CO_ERROR_OUT_OF_MEMORY.
+ */
+CO_ReturnError_t CO_traceMulti_addChannelOD(CO_traceMulti_t* tr, OD_t* od, uint16_t index, uint8_t subIndex,
+                                            bool_t isSigned);
+
+/**
+ * Configure trigger and capture window, effective on the next CO_traceMulti_arm()
+ *
+ * @param tr This object.
+ * @param edge See @ref CO_traceMulti_trigger_t.
+ * @param channel Trigger channel.
+ * @param level Trigger level.
+ * @param preRecords Number of records before the trigger record. Ignored with #CO_TRACE_MULTI_TRIG_NONE.
+ * @param postRecords Number of records after the trigger record.
+ *
+ * @return CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT, if channel does not exist or window does not fit the buffer.
+ */
+CO_ReturnError_t CO_traceMulti_setTrigger(CO_traceMulti_t* tr, CO_traceMulti_trigger_t edge, uint8_t channel,
+                                          int32_t level, uint32_t preRecords, uint32_t postRecords);
+
+/**
+ * Initialize sample callback
+ *
+ * Callback is called from the real-time thread with each sample, also while not capturing, for example for live
+ * export. Record is valid only during the call.
+ *
+ * @param tr This object.
+ * @param object Pointer to object, which will be passed to pFunctSample(). Can be NULL
+ * @param pFunctSample Pointer to the callback function. Not called if NULL.
+ */
+void CO_traceMulti_initCallbackSample(CO_traceMulti_t* tr, void* object,
+                                      void (*pFunctSample)(void* object, const int32_t* record, uint16_t words));
+
+/**
+ * Start new capture
+ *
+ * Previous capture is discarded. Request is taken by the real-time thread at the next sample.
+ *
+ * @param tr This object.
+ */
+void CO_traceMulti_arm(CO_traceMulti_t* tr);
+
+/**
+ * Stop capture and freeze stored records
+ *
+ * @param tr This object.
+ */
+void CO_traceMulti_stop(CO_traceMulti_t* tr);
+
+/**
+ * Process trace, called from the real-time thread
+ *
+ * @param tr This object, may be NULL.
+ * @param syncWas True, if CANopen SYNC message was just received or transmitted.
+ * @param timeDifference_us Time difference from previous function call in microseconds.
+ * @param [out] timerNext_us info to OS, time to the next sample of the timer - see CO_process(), may be NULL.
+ */
+void CO_traceMulti_process(CO_traceMulti_t* tr, bool_t syncWas, uint32_t timeDifference_us, uint32_t* timerNext_us);
+
+/**
+ * Check if capture is frozen and may be read
+ *
+ * @param tr This object.
+ *
+ * @return True, if frozen.
+ */
+static inline bool_t
+CO_traceMulti_isFrozen(CO_traceMulti_t* tr) {
+    return CO_FLAG_READ(tr->frozen);
+}
+
+/**
+ * Restart reading of the frozen capture from the header
+ *
+ * @param tr This object.
+ *
+ * @return Number of records in the capture or 0, if not frozen.
+ */
+uint32_t CO_traceMulti_rewind(CO_traceMulti_t* tr);
+
+/**
+ * Read next part of the binary export
+ *
+ * Values are encoded only as whole, so function may return less than size bytes before the end.
+ *
+ * @param tr This object.
+ * @param buf Buffer for data.
+ * @param size Size of the buffer, at least 5 bytes.
+ *
+ * @return Number of bytes written to buf, 0 at the end of export or if not frozen.
+ */
+size_t CO_traceMulti_read(CO_traceMulti_t* tr, uint8_t* buf, size_t size);
+
+/**
+ * Make capture accessible from OD entry
+ *
+ * Entry is a DOMAIN variable. SDO upload rewinds and reads the binary export of the frozen capture, device state
+ * error is returned if capture is not frozen. Writing 1 (one byte) arms the trace, writing 0 stops it.
+ *
+ * @param tr This object.
+ * @param OD_trace OD entry, for example from manufacturer specific area.
+ *
+ * @return CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_traceMulti_initOD(CO_traceMulti_t* tr, OD_entry_t* OD_trace);
+
+/** @} */ /* CO_traceMulti */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* CO_TRACE_MULTI_H */
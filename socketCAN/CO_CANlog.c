@@ -0,0 +1,292 @@
+/*
+ * CAN frame recorder and replayer for Linux socketCAN, memory mapped binary log.
+ *
+ * @file        CO_CANlog.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "CO_CANlog.h"
+
+/* Record with its data bytes, rounded up to 8 bytes */
+#define CO_CAN_LOG_RECORD_SIZE(dataSize) ((offsetof(CO_CANlogRecord_t, data) + (dataSize) + 7U) & ~(size_t)7U)
+
+static inline CO_CANlogRecord_t*
+CO_CANlog_at(const CO_CANlog_t* log, uint32_t n) {
+    return (CO_CANlogRecord_t*)&log->records[(size_t)n * log->header->recordSize];
+}
+
+CO_ReturnError_t
+CO_CANlog_create(CO_CANlog_t* log, const char* path, uint32_t capacity, bool_t canFd) {
+    if ((log == NULL) || (path == NULL) || (capacity == 0U)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    (void)memset(log, 0, sizeof(CO_CANlog_t));
+    log->fd = -1;
+
+    uint32_t dataSize = canFd ? 64U : 8U;
+    size_t recordSize = CO_CAN_LOG_RECORD_SIZE(dataSize);
+    size_t size = sizeof(CO_CANlog_header_t) + ((size_t)capacity * recordSize);
+
+    int fd = open(path, O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    /* file is zero filled, so record links and index are initially empty */
+    if (ftruncate(fd, (off_t)size) != 0) {
+        (void)close(fd);
+        return CO_ERROR_SYSCALL;
+    }
+    void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (mem == MAP_FAILED) {
+        (void)close(fd);
+        return CO_ERROR_SYSCALL;
+    }
+
+    CO_CANlog_header_t* h = (CO_CANlog_header_t*)mem;
+    h->version = CO_CAN_LOG_VERSION;
+    h->recordSize = (uint16_t)recordSize;
+    h->dataSize = dataSize;
+    h->capacity = capacity;
+    h->headerSize = (uint32_t)sizeof(CO_CANlog_header_t);
+    h->start_us = CO_CANtimestampNow();
+    atomic_thread_fence(memory_order_release);
+    h->magic = CO_CAN_LOG_MAGIC;
+
+    log->header = h;
+    log->records = (uint8_t*)mem + sizeof(CO_CANlog_header_t);
+    log->size = size;
+    log->fd = fd;
+    return CO_ERROR_NO;
+}
+
+CO_ReturnError_t
+CO_CANlog_open(CO_CANlog_t* log, const char* path) {
+    struct stat st;
+
+    if ((log == NULL) || (path == NULL)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    (void)memset(log, 0, sizeof(CO_CANlog_t));
+    log->fd = -1;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    if (fstat(fd, &st) != 0) {
+        (void)close(fd);
+        return CO_ERROR_SYSCALL;
+    }
+    if ((size_t)st.st_size < sizeof(CO_CANlog_header_t)) {
+        (void)close(fd);
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    void* mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (mem == MAP_FAILED) {
+        return CO_ERROR_SYSCALL;
+    }
+
+    CO_CANlog_header_t* h = (CO_CANlog_header_t*)mem;
+    if ((h->magic != CO_CAN_LOG_MAGIC) || (h->version != CO_CAN_LOG_VERSION)
+        || (h->headerSize != sizeof(CO_CANlog_header_t)) || (h->dataSize > 64U)
+        || (h->recordSize != CO_CAN_LOG_RECORD_SIZE(h->dataSize))) {
+        (void)munmap(mem, (size_t)st.st_size);
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* written records, file of killed recorder still has its full size */
+    uint32_t count = (uint32_t)atomic_load_explicit(&h->head, memory_order_acquire);
+    size_t inFile = ((size_t)st.st_size - sizeof(CO_CANlog_header_t)) / h->recordSize;
+    if (count > h->capacity) {
+        count = h->capacity;
+    }
+    if (count > inFile) {
+        count = (uint32_t)inFile;
+    }
+
+    log->header = h;
+    log->records = (uint8_t*)mem + sizeof(CO_CANlog_header_t);
+    log->size = (size_t)st.st_size;
+    log->count = count;
+    return CO_ERROR_NO;
+}
+
+void
+CO_CANlog_close(CO_CANlog_t* log) {
+    if ((log == NULL) || (log->header == NULL)) {
+        return;
+    }
+    if (log->fd >= 0) {
+        size_t size = sizeof(CO_CANlog_header_t) + ((size_t)CO_CANlog_count(log) * log->header->recordSize);
+        (void)msync(log->header, log->size, MS_SYNC);
+        (void)munmap(log->header, log->size);
+        (void)ftruncate(log->fd, (off_t)size);
+        (void)close(log->fd);
+    } else {
+        (void)munmap(log->header, log->size);
+    }
+    (void)memset(log, 0, sizeof(CO_CANlog_t));
+    log->fd = -1;
+}
+
+void
+CO_CANlog_frame(CO_CANlog_t* log, uint32_t can_id, uint8_t len, const uint8_t* data, uint8_t flags,
+                uint64_t time_us) {
+    if ((log == NULL) || (log->header == NULL) || (log->fd < 0)) {
+        return;
+    }
+
+    CO_CANlog_header_t* h = log->header;
+    uint32_t n = (uint32_t)atomic_fetch_add_explicit(&h->head, 1U, memory_order_relaxed);
+    if (n >= h->capacity) {
+        (void)atomic_fetch_add_explicit(&h->dropped, 1U, memory_order_relaxed);
+        return;
+    }
+
+    CO_CANlogRecord_t* rec = CO_CANlog_at(log, n);
+    uint16_t index = ((can_id & CAN_EFF_FLAG) != 0U) ? (uint16_t)CO_CAN_LOG_EXT : (uint16_t)(can_id & CAN_SFF_MASK);
+    CO_CANlogIndex_t* idx = &h->index[index];
+
+    if (len > h->dataSize) {
+        len = (uint8_t)h->dataSize;
+    }
+    rec->timestamp_us = time_us;
+    rec->can_id = can_id;
+    rec->len = len;
+    if ((data != NULL) && (len > 0U)) {
+        (void)memcpy(rec->data, data, len);
+    }
+
+    /* Link from the previous record of the same COB-ID. Its writer does not touch its link, file was zeroed. */
+    uint32_t prev = (uint32_t)atomic_exchange_explicit(&idx->last, n + 1U, memory_order_acq_rel);
+    if (prev == 0U) {
+        atomic_store_explicit(&idx->first, n + 1U, memory_order_release);
+    } else {
+        CO_CANlog_at(log, prev - 1U)->next = n + 1U;
+    }
+    (void)atomic_fetch_add_explicit(&idx->count, 1U, memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_release);
+    rec->flags = (uint8_t)((flags & (uint8_t)~CO_CAN_LOG_VALID) | CO_CAN_LOG_VALID);
+}
+
+uint32_t
+CO_CANlog_count(const CO_CANlog_t* log) {
+    if ((log == NULL) || (log->header == NULL)) {
+        return 0U;
+    }
+    if (log->fd < 0) {
+        return log->count;
+    }
+    uint32_t head = (uint32_t)atomic_load_explicit(&log->header->head, memory_order_relaxed);
+    return (head < log->header->capacity) ? head : log->header->capacity;
+}
+
+const CO_CANlogRecord_t*
+CO_CANlog_record(const CO_CANlog_t* log, uint32_t n) {
+    if (n >= CO_CANlog_count(log)) {
+        return NULL;
+    }
+    const CO_CANlogRecord_t* rec = CO_CANlog_at(log, n);
+    if ((rec->flags & CO_CAN_LOG_VALID) == 0U) {
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return rec;
+}
+
+const CO_CANlogRecord_t*
+CO_CANlog_first(const CO_CANlog_t* log, uint16_t index) {
+    if ((log == NULL) || (log->header == NULL) || (index >= CO_CAN_LOG_IDENTS)) {
+        return NULL;
+    }
+    uint32_t first = (uint32_t)atomic_load_explicit(&log->header->index[index].first, memory_order_acquire);
+    return (first != 0U) ? CO_CANlog_record(log, first - 1U) : NULL;
+}
+
+const CO_CANlogRecord_t*
+CO_CANlog_next(const CO_CANlog_t* log, const CO_CANlogRecord_t* record) {
+    if ((log == NULL) || (log->header == NULL) || (record == NULL) || (record->next == 0U)) {
+        return NULL;
+    }
+    return CO_CANlog_record(log, record->next - 1U);
+}
+
+uint32_t
+CO_CANlog_identCount(const CO_CANlog_t* log, uint16_t index) {
+    if ((log == NULL) || (log->header == NULL) || (index >= CO_CAN_LOG_IDENTS)) {
+        return 0U;
+    }
+    return (uint32_t)atomic_load_explicit(&log->header->index[index].count, memory_order_relaxed);
+}
+
+void
+CO_CANreplay_init(CO_CANreplay_t* replay, const CO_CANlog_t* log, int64_t offset_us, uint8_t skipFlags) {
+    if (replay == NULL) {
+        return;
+    }
+    (void)memset(replay, 0, sizeof(CO_CANreplay_t));
+    replay->log = log;
+    replay->offset_us = offset_us;
+    replay->skipFlags = skipFlags;
+}
+
+uint64_t
+CO_CANreplay_nextTime(const CO_CANreplay_t* replay) {
+    if ((replay == NULL) || (replay->next >= CO_CANlog_count(replay->log))) {
+        return UINT64_MAX;
+    }
+    const CO_CANlogRecord_t* rec = CO_CANlog_at(replay->log, replay->next);
+    return (uint64_t)((int64_t)rec->timestamp_us + replay->offset_us);
+}
+
+uint32_t
+CO_CANreplay_process(CO_CANreplay_t* replay, CO_CANmodule_t* CANmodule, uint64_t until_us,
+                     uint32_t maxFrames) {
+    uint32_t replayed = 0U;
+
+    if ((replay == NULL) || (CANmodule == NULL)) {
+        return 0U;
+    }
+
+    while ((replayed < maxFrames) && (replay->next < CO_CANlog_count(replay->log))
+           && (CO_CANreplay_nextTime(replay) <= until_us)) {
+        const CO_CANlogRecord_t* rec = CO_CANlog_record(replay->log, replay->next);
+        CO_CANrxMsg_t msg;
+
+        replay->next++;
+        if ((rec == NULL) || ((rec->flags & replay->skipFlags) != 0U) || (rec->len > CO_CAN_DATA_MAX)) {
+            replay->skipped++;
+            continue;
+        }
+        (void)memset(&msg, 0, sizeof(msg));
+        msg.frame.can_id = rec->can_id;
+        msg.frame.len = rec->len;
+#if CO_DRIVER_CAN_FD
+        msg.frame.flags = ((rec->flags & CO_CAN_LOG_BRS) != 0U) ? CANFD_BRS : 0U;
+#endif
+        (void)memcpy(msg.frame.data, rec->data, rec->len);
+        msg.timestamp_us = (uint64_t)((int64_t)rec->timestamp_us + replay->offset_us);
+
+        CO_CANrxInject(CANmodule, &msg);
+        replay->replayed++;
+        replayed++;
+    }
+    return replayed;
+}
@@ -0,0 +1,281 @@
+/*
+ * CAN frame recorder and replayer for Linux socketCAN, memory mapped binary log.
+ *
+ * @file        CO_CANlog.h
+ * @ingroup     CO_CANlog
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_CAN_LOG_H
+#define CO_CAN_LOG_H
+
+#include <stdatomic.h>
+
+#include "301/CO_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_CANlog CAN record and replay
+ * Timestamped CAN frames in append-only, memory mapped log with COB-ID index, replay through CANrx_callback.
+ *
+ * @ingroup CO_socketCAN
+ * @{
+ *
+ * Log file is @ref CO_CANlog_header_t followed by fixed size records (@ref CO_CANlogRecord_t), in order in which
+ * they were written. File is created with the size for all records and mapped with MAP_SHARED and MAP_POPULATE by
+ * CO_CANlog_create(), so CO_CANlog_frame() only copies the frame into the mapped memory: no system call, no lock and
+ * no page fault in the real-time thread. Record slot is reserved with atomic increment, so frames are recorded from
+ * the receive thread and from the transmitting thread at the same time. If log is full, frames are counted in
+ * CO_CANlog_header_t::dropped. CO_CANlog_close() truncates the file to the written records.
+ *
+ * Header contains index of each 11-bit COB-ID (and one for extended frames): number of records, the first and the
+ * last record. Each record links to the next record with the same COB-ID, so CO_CANlog_first() and CO_CANlog_next()
+ * walk over one COB-ID without reading the whole log. Index is maintained while recording, so also the log of the
+ * program, which was killed, is readable. Incomplete record has no @ref CO_CAN_LOG_VALID flag and is skipped.
+ *
+ * Recording from the driver: if @ref CO_DRIVER_LOG is enabled and CO_CANptrSocketCan_t::log is set before
+ * CO_CANinit(), driver records all frames received by the CANopen socket (including error frames) before they are
+ * passed to CANrx_callback and all frames passed to the kernel for sending (@ref CO_CAN_LOG_TX).
+ *
+ * Replay: CO_CANreplay_process() passes recorded frames to CO_CANrxInject(), which calls CANrx_callback of the
+ * matching CANopen object, as CO_CANinterrupt() does with the received frame. Frames are replayed at the original
+ * timing (record timestamp plus offset compared with CO_CANtimestampNow()) or as fast as possible (until time is
+ * UINT64_MAX and a limited number of frames per call, followed by processing). Frames, which were sent by recording
+ * node, are skipped by default.
+ *
+ * @code{.c}
+ * static CO_CANlog_t canLog;
+ * CO_CANlog_create(&canLog, "/var/log/can0.colog", 1000000, false);
+ * CO_CANptrSocketCan_t CANptr = {.can_ifindex = if_nametoindex("can0"), .log = &canLog};
+ * // ... CO_CANinit(co, &CANptr, 0) ..., at the end CO_CANlog_close(&canLog);
+ *
+ * // replay in the thread, which processes CANopen, after CO_process()
+ * CO_CANlog_open(&canLog, "can0.colog");
+ * CO_CANreplay_init(&replay, &canLog, (int64_t)(CO_CANtimestampNow() - CO_CANlog_record(&canLog, 0)->timestamp_us),
+ *                   CO_CAN_LOG_TX);
+ * CO_CANreplay_process(&replay, co->CANmodule, CO_CANtimestampNow(), UINT32_MAX);
+ * @endcode
+ */
+
+/** Magic number at the start of the log file, "COLG" */
+#define CO_CAN_LOG_MAGIC 0x474C4F43U
+
+/** Version of the log file layout */
+#define CO_CAN_LOG_VERSION 1U
+
+/** Index of extended frames (29-bit identifier), after 2048 11-bit COB-IDs */
+#define CO_CAN_LOG_EXT 2048U
+/** Number of index entries */
+#define CO_CAN_LOG_IDENTS (CO_CAN_LOG_EXT + 1U)
+
+/**
+ * @defgroup CO_CAN_LOG_FLAGS Record flags
+ * CO_CANlogRecord_t::flags
+ * @{
+ */
+#define CO_CAN_LOG_TX    0x01U /**< Frame was sent by the recording node */
+#define CO_CAN_LOG_FD    0x02U /**< CAN FD frame */
+#define CO_CAN_LOG_BRS   0x04U /**< CAN FD frame with bit rate switch */
+#define CO_CAN_LOG_VALID 0x80U /**< Record is complete, set last */
+/** @} */
+
+/** One record, followed by CO_CANlog_header_t::dataSize data bytes and padded to CO_CANlog_header_t::recordSize */
+typedef struct {
+    uint64_t timestamp_us; /**< Receive timestamp or time of sending, CO_CANtimestampNow() */
+    uint32_t can_id;       /**< CAN identifier with CAN_EFF_FLAG, CAN_RTR_FLAG or CAN_ERR_FLAG, as in can_frame */
+    uint32_t next;         /**< Number of the next record with the same COB-ID plus one, 0 if none */
+    uint8_t len;           /**< Number of data bytes */
+    uint8_t flags;         /**< @ref CO_CAN_LOG_FLAGS */
+    uint8_t reserved[2];   /**< Zero */
+    uint8_t data[];        /**< Data bytes */
+} CO_CANlogRecord_t;
+
+/** Index of one COB-ID, record numbers are plus one, 0 if none */
+typedef struct {
+    atomic_uint_least32_t first; /**< The first record */
+    atomic_uint_least32_t last;  /**< The last record */
+    atomic_uint_least32_t count; /**< Number of records */
+} CO_CANlogIndex_t;
+
+/** Header at the start of the log file, all values in host byte order */
+typedef struct {
+    uint32_t magic;                          /**< CO_CAN_LOG_MAGIC */
+    uint16_t version;                        /**< CO_CAN_LOG_VERSION */
+    uint16_t recordSize;                     /**< Size of one record in bytes, multiple of 8 */
+    uint32_t dataSize;                       /**< Data bytes in each record, 8 or 64 (CAN FD) */
+    uint32_t capacity;                       /**< Number of records, for which the file was created */
+    uint32_t headerSize;                     /**< Size of this header, offset of the first record */
+    uint32_t reserved;                       /**< Zero */
+    uint64_t start_us;                       /**< Time of CO_CANlog_create() */
+    atomic_uint_least32_t head;              /**< Reserved records, may be larger than capacity */
+    atomic_uint_least32_t dropped;           /**< Frames not recorded, because log was full */
+    CO_CANlogIndex_t index[CO_CAN_LOG_IDENTS]; /**< Index of each COB-ID and of extended frames */
+} CO_CANlog_header_t;
+
+/** CAN log object, see @ref CO_CANlog */
+typedef struct CO_CANlog {
+    CO_CANlog_header_t* header; /**< Mapped file or NULL */
+    uint8_t* records;           /**< The first record, after the header */
+    size_t size;                /**< Size of the mapped memory */
+    uint32_t count;             /**< Number of records in the file, opened with CO_CANlog_open() */
+    int fd;                     /**< File, opened with CO_CANlog_create(), -1 otherwise */
+} CO_CANlog_t;
+
+/** Replay object, see CO_CANreplay_init() */
+typedef struct {
+    const CO_CANlog_t* log; /**< From CO_CANreplay_init() */
+    int64_t offset_us;      /**< Added to record timestamps */
+    uint8_t skipFlags;      /**< Records with any of these flags are not replayed */
+    uint32_t next;          /**< Number of the next record */
+    uint32_t replayed;      /**< Frames passed to CO_CANrxInject() */
+    uint32_t skipped;       /**< Records skipped: skipFlags, incomplete or too long for the driver */
+} CO_CANreplay_t;
+
+/**
+ * Create new log file for recording, existing file is replaced
+ *
+ * @param log This object will be initialized.
+ * @param path Path of the file.
+ * @param capacity Maximum number of records.
+ * @param canFd If true, records have 64 data bytes, otherwise 8.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_SYSCALL (open, ftruncate or mmap failed).
+ */
+CO_ReturnError_t CO_CANlog_create(CO_CANlog_t* log, const char* path, uint32_t capacity, bool_t canFd);
+
+/**
+ * Open existing log file for reading and replay, read-only
+ *
+ * @param log This object will be initialized.
+ * @param path Path of the file.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT (not a log file) or CO_ERROR_SYSCALL.
+ */
+CO_ReturnError_t CO_CANlog_open(CO_CANlog_t* log, const char* path);
+
+/**
+ * Close log, file created with CO_CANlog_create() is truncated to written records
+ *
+ * Recording must be stopped before, for example with CO_CANmodule_disable().
+ *
+ * @param log This object.
+ */
+void CO_CANlog_close(CO_CANlog_t* log);
+
+/**
+ * Record one frame, from any thread
+ *
+ * @param log This object, created with CO_CANlog_create().
+ * @param can_id CAN identifier with CAN_EFF_FLAG, CAN_RTR_FLAG or CAN_ERR_FLAG.
+ * @param len Number of data bytes, truncated to CO_CANlog_header_t::dataSize.
+ * @param data Data bytes.
+ * @param flags @ref CO_CAN_LOG_FLAGS, without CO_CAN_LOG_VALID.
+ * @param time_us Time of the frame, time base of CO_CANtimestampNow() and receive timestamps.
+ */
+void CO_CANlog_frame(CO_CANlog_t* log, uint32_t can_id, uint8_t len, const uint8_t* data, uint8_t flags,
+                     uint64_t time_us);
+
+/**
+ * Number of records in the log
+ *
+ * @param log This object.
+ *
+ * @return Written records (recording) or records in the file (reading).
+ */
+uint32_t CO_CANlog_count(const CO_CANlog_t* log);
+
+/**
+ * Get record
+ *
+ * @param log This object.
+ * @param n Number of the record, from 0 to CO_CANlog_count() - 1.
+ *
+ * @return Record or NULL, if n is out of range or record is incomplete.
+ */
+const CO_CANlogRecord_t* CO_CANlog_record(const CO_CANlog_t* log, uint32_t n);
+
+/**
+ * Get the first record of the COB-ID from the index
+ *
+ * @param log This object.
+ * @param index 11-bit COB-ID or @ref CO_CAN_LOG_EXT.
+ *
+ * @return Record or NULL, if there is none.
+ */
+const CO_CANlogRecord_t* CO_CANlog_first(const CO_CANlog_t* log, uint16_t index);
+
+/**
+ * Get the next record with the same COB-ID
+ *
+ * @param log This object.
+ * @param record Record from CO_CANlog_first() or CO_CANlog_next().
+ *
+ * @return Record or NULL, if there is none.
+ */
+const CO_CANlogRecord_t* CO_CANlog_next(const CO_CANlog_t* log, const CO_CANlogRecord_t* record);
+
+/**
+ * Number of records of the COB-ID from the index
+ *
+ * @param log This object.
+ * @param index 11-bit COB-ID or @ref CO_CAN_LOG_EXT.
+ *
+ * @return Number of records.
+ */
+uint32_t CO_CANlog_identCount(const CO_CANlog_t* log, uint16_t index);
+
+/**
+ * Initialize replay of the log from the first record
+ *
+ * @param replay This object will be initialized.
+ * @param log Log with records.
+ * @param offset_us Added to record timestamps, for replay time and for timestamps of the replayed frames. For
+ * replay at original timing it is CO_CANtimestampNow() minus timestamp of the first record.
+ * @param skipFlags Records with any of @ref CO_CAN_LOG_FLAGS are skipped, usually CO_CAN_LOG_TX.
+ */
+void CO_CANreplay_init(CO_CANreplay_t* replay, const CO_CANlog_t* log, int64_t offset_us, uint8_t skipFlags);
+
+/**
+ * Replay frames, which are due
+ *
+ * Function must be called from the thread, which processes received frames: the thread of CO_CANinterrupt() or the
+ * mainline thread, if @ref CO_DRIVER_MULTI_THREAD is enabled.
+ *
+ * @param replay This object.
+ * @param CANmodule CAN module, which receives the frames.
+ * @param until_us Frames with timestamp plus offset up to this time are replayed, UINT64_MAX for all.
+ * @param maxFrames Maximum number of frames to replay in this call.
+ *
+ * @return Number of replayed frames.
+ */
+uint32_t CO_CANreplay_process(CO_CANreplay_t* replay, CO_CANmodule_t* CANmodule, uint64_t until_us,
+                              uint32_t maxFrames);
+
+/**
+ * Time of the next frame to replay
+ *
+ * @param replay This object.
+ *
+ * @return Timestamp plus offset of the next record or UINT64_MAX, if replay is finished.
+ */
+uint64_t CO_CANreplay_nextTime(const CO_CANreplay_t* replay);
+
+/** @} */ /* CO_CANlog */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CO_CAN_LOG_H */
@@ -0,0 +1,497 @@
+/*
+ * CAN traffic statistics and bus load for Linux socketCAN.
+ *
+ * @file        CO_CANstats.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* recvmmsg() */
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/can/raw.h>
+#include <linux/can/error.h>
+#include <linux/net_tstamp.h>
+
+#include "CO_CANstats.h"
+
+/* Layout of the bus load slot word */
+#define CO_CAN_STATS_SLOT_NUMBER_SHIFT 40U
+#define CO_CAN_STATS_SLOT_NUMBER_MASK  0xFFFFFFU
+#define CO_CAN_STATS_SLOT_FRAMES_SHIFT 24U
+#define CO_CAN_STATS_SLOT_FRAMES_MASK  0xFFFFU
+#define CO_CAN_STATS_SLOT_BITS_MASK    0xFFFFFFU
+
+/* CRC delimiter, ACK slot, ACK delimiter, end of frame and interframe space, not stuffed */
+#define CO_CAN_STATS_TAIL_BITS 13U
+
+/* Bit stream of the frame: counts bits with stuff bits and calculates CRC-15 of classic frame */
+typedef struct {
+    uint32_t bits;
+    uint16_t crc;
+    uint8_t last;
+    uint8_t run;
+} CO_CANstatsBits_t;
+
+/* Append count bits of value, most significant first. After five equal bits stuff bit of opposite value is inserted,
+ * which also starts the next run. */
+static void
+CO_CANstats_putBits(CO_CANstatsBits_t* s, uint32_t value, uint8_t count) {
+    while (count > 0U) {
+        count--;
+        uint8_t bit = (uint8_t)((value >> count) & 1U);
+        uint16_t crcNext = (uint16_t)(bit ^ ((s->crc >> 14) & 1U));
+
+        s->crc = (uint16_t)((s->crc << 1) & 0x7FFFU);
+        if (crcNext != 0U) {
+            s->crc ^= 0x4599U;
+        }
+        s->bits++;
+        if (bit == s->last) {
+            s->run++;
+            if (s->run == 5U) {
+                s->bits++;
+                s->last = (uint8_t)(bit ^ 1U);
+                s->run = 1U;
+            }
+        } else {
+            s->last = bit;
+            s->run = 1U;
+        }
+    }
+}
+
+/* Number of data bytes in CAN FD frame, which carries len bytes, as can_fd_len2dlc() and can_fd_dlc2len() */
+static uint8_t
+CO_CANstats_fdLength(uint8_t len) {
+    static const uint8_t lengths[] = {8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
+    uint8_t i;
+
+    if (len <= 8U) {
+        return len;
+    }
+    for (i = 1U; i < (uint8_t)(sizeof(lengths) - 1U); i++) {
+        if (lengths[i] >= len) {
+            break;
+        }
+    }
+    return lengths[i];
+}
+
+/* DLC code of CAN FD frame with len data bytes, len must be from CO_CANstats_fdLength() */
+static uint8_t
+CO_CANstats_fdDlc(uint8_t len) {
+    static const uint8_t lengths[] = {12U, 16U, 20U, 24U, 32U, 48U, 64U};
+    uint8_t dlc = 9U;
+    uint8_t i;
+
+    if (len <= 8U) {
+        return len;
+    }
+    for (i = 0U; (i < (uint8_t)(sizeof(lengths) - 1U)) && (lengths[i] < len); i++) {
+        dlc++;
+    }
+    return dlc;
+}
+
+CO_ReturnError_t
+CO_CANstats_init(CO_CANstats_t* stats, uint32_t bitrate, uint32_t dataBitrate) {
+    if ((stats == NULL) || (bitrate == 0U)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    stats->bitrate = bitrate;
+    stats->dataBitrate = (dataBitrate != 0U) ? dataBitrate : bitrate;
+    CO_CANstats_reset(stats);
+    return CO_ERROR_NO;
+}
+
+void
+CO_CANstats_reset(CO_CANstats_t* stats) {
+    uint16_t i;
+
+    if (stats == NULL) {
+        return;
+    }
+    for (i = 0U; i < (uint16_t)CO_CAN_STATS_EV_COUNT; i++) {
+        atomic_store_explicit(&stats->events[i], 0U, memory_order_relaxed);
+    }
+    for (i = 0U; i < CO_CAN_STATS_SLOTS; i++) {
+        atomic_store_explicit(&stats->slots[i], 0U, memory_order_relaxed);
+    }
+    for (i = 0U; i < CO_CAN_STATS_IDENTS; i++) {
+        CO_CANstatsCounters_t* c = &stats->idents[i];
+        atomic_store_explicit(&c->frames, 0U, memory_order_relaxed);
+        atomic_store_explicit(&c->txFrames, 0U, memory_order_relaxed);
+        atomic_store_explicit(&c->bytes, 0U, memory_order_relaxed);
+        atomic_store_explicit(&c->bits, 0U, memory_order_relaxed);
+        atomic_store_explicit(&c->last_us, 0U, memory_order_relaxed);
+        atomic_store_explicit(&c->gapMin_us, UINT32_MAX, memory_order_relaxed);
+        atomic_store_explicit(&c->gapMax_us, 0U, memory_order_relaxed);
+    }
+    atomic_store_explicit(&stats->start_us, CO_CANtimestampNow(), memory_order_relaxed);
+}
+
+uint32_t
+CO_CANstats_frameBits(const CO_CANstats_t* stats, uint32_t can_id, uint8_t len, const uint8_t* data,
+                      uint8_t flags) {
+    CO_CANstatsBits_t s = {0U, 0U, 2U, 0U};
+    bool_t ext = (can_id & CAN_EFF_FLAG) != 0U;
+    bool_t fd = (flags & CO_CAN_STATS_FD) != 0U;
+    uint8_t bytes;
+    uint8_t i;
+
+    /* start of frame and arbitration field, SRR and IDE of extended frame are recessive */
+    CO_CANstats_putBits(&s, 0U, 1U);
+    if (ext) {
+        CO_CANstats_putBits(&s, (can_id >> 18) & CAN_SFF_MASK, 11U);
+        CO_CANstats_putBits(&s, 3U, 2U);
+        CO_CANstats_putBits(&s, can_id & 0x3FFFFU, 18U);
+    } else {
+        CO_CANstats_putBits(&s, can_id & CAN_SFF_MASK, 11U);
+    }
+
+    if (!fd) {
+        bool_t rtr = (can_id & CAN_RTR_FLAG) != 0U;
+        uint8_t dlc = (len > 8U) ? 8U : len;
+
+        /* RTR, then IDE and r0 (standard) or r1 and r0 (extended), DLC */
+        CO_CANstats_putBits(&s, rtr ? 1U : 0U, 1U);
+        CO_CANstats_putBits(&s, 0U, 2U);
+        CO_CANstats_putBits(&s, dlc, 4U);
+        bytes = rtr ? 0U : dlc;
+        for (i = 0U; i < bytes; i++) {
+            CO_CANstats_putBits(&s, (data != NULL) ? data[i] : 0U, 8U);
+        }
+        uint16_t crc = s.crc;
+        CO_CANstats_putBits(&s, crc, 15U);
+        return s.bits + CO_CAN_STATS_TAIL_BITS;
+    }
+
+    /* CAN FD: RRS, IDE (standard frame only), FDF, res and BRS. Arbitration phase ends with BRS. */
+    bool_t brs = (flags & CO_CAN_STATS_BRS) != 0U;
+    CO_CANstats_putBits(&s, 0U, ext ? 1U : 2U);
+    CO_CANstats_putBits(&s, 2U, 2U);
+    CO_CANstats_putBits(&s, brs ? 1U : 0U, 1U);
+    uint32_t arbitrationBits = s.bits;
+
+    /* ESI (error active), DLC and data with dynamic stuff bits, data beyond len are padding zeros */
+    bytes = CO_CANstats_fdLength(len);
+    CO_CANstats_putBits(&s, 0U, 1U);
+    CO_CANstats_putBits(&s, CO_CANstats_fdDlc(bytes), 4U);
+    for (i = 0U; i < bytes; i++) {
+        CO_CANstats_putBits(&s, ((data != NULL) && (i < len)) ? data[i] : 0U, 8U);
+    }
+    /* stuff count (4 bits) and CRC-17 or CRC-21 with fixed stuff bit before and after each 4 bits */
+    uint32_t dataBits = (s.bits - arbitrationBits) + ((bytes <= 16U) ? (21U + 6U) : (25U + 7U));
+
+    if (brs && (stats != NULL) && (stats->dataBitrate > stats->bitrate)) {
+        dataBits = (uint32_t)((((uint64_t)dataBits * stats->bitrate) + stats->dataBitrate - 1U) / stats->dataBitrate);
+    }
+    return arbitrationBits + dataBits + CO_CAN_STATS_TAIL_BITS;
+}
+
+/* Atomic minimum and maximum */
+static void
+CO_CANstats_min(atomic_uint_least32_t* var, uint32_t value) {
+    uint_least32_t old = atomic_load_explicit(var, memory_order_relaxed);
+    while ((value < old)
+           && !atomic_compare_exchange_weak_explicit(var, &old, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void
+CO_CANstats_max(atomic_uint_least32_t* var, uint32_t value) {
+    uint_least32_t old = atomic_load_explicit(var, memory_order_relaxed);
+    while ((value > old)
+           && !atomic_compare_exchange_weak_explicit(var, &old, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/* Add frame into its bus load slot. Slot of older time is started again, frame older than the slot is ignored. */
+static void
+CO_CANstats_slotAdd(CO_CANstats_t* stats, uint64_t time_us, uint32_t bits) {
+    uint64_t number = time_us / CO_CAN_STATS_SLOT_US;
+    uint32_t numberMasked = (uint32_t)(number & CO_CAN_STATS_SLOT_NUMBER_MASK);
+    atomic_uint_least64_t* slot = &stats->slots[number % CO_CAN_STATS_SLOTS];
+    uint_least64_t old = atomic_load_explicit(slot, memory_order_relaxed);
+    uint64_t word;
+
+    do {
+        uint32_t oldNumber = (uint32_t)(old >> CO_CAN_STATS_SLOT_NUMBER_SHIFT);
+        uint64_t frames = 1U;
+        uint64_t sum = bits;
+
+        if (oldNumber == numberMasked) {
+            frames += (old >> CO_CAN_STATS_SLOT_FRAMES_SHIFT) & CO_CAN_STATS_SLOT_FRAMES_MASK;
+            sum += old & CO_CAN_STATS_SLOT_BITS_MASK;
+        } else if (((numberMasked - oldNumber) & CO_CAN_STATS_SLOT_NUMBER_MASK)
+                   > (CO_CAN_STATS_SLOT_NUMBER_MASK >> 1)) {
+            return;
+        } else { /* MISRA C 2004 14.10 */
+        }
+        if (frames > CO_CAN_STATS_SLOT_FRAMES_MASK) {
+            frames = CO_CAN_STATS_SLOT_FRAMES_MASK;
+        }
+        if (sum > CO_CAN_STATS_SLOT_BITS_MASK) {
+            sum = CO_CAN_STATS_SLOT_BITS_MASK;
+        }
+        word = ((uint64_t)numberMasked << CO_CAN_STATS_SLOT_NUMBER_SHIFT) | (frames << CO_CAN_STATS_SLOT_FRAMES_SHIFT)
+               | sum;
+    } while (!atomic_compare_exchange_weak_explicit(slot, &old, word, memory_order_relaxed, memory_order_relaxed));
+}
+
+void
+CO_CANstats_frame(CO_CANstats_t* stats, uint32_t can_id, uint8_t len, const uint8_t* data, uint8_t flags,
+                  uint64_t time_us) {
+    if (stats == NULL) {
+        return;
+    }
+
+    uint16_t index = ((can_id & CAN_EFF_FLAG) != 0U) ? (uint16_t)CO_CAN_STATS_EXT : (uint16_t)(can_id & CAN_SFF_MASK);
+    CO_CANstatsCounters_t* c = &stats->idents[index];
+    uint32_t bits = CO_CANstats_frameBits(stats, can_id, len, data, flags);
+    bool_t rtr = ((can_id & CAN_RTR_FLAG) != 0U) && ((flags & CO_CAN_STATS_FD) == 0U);
+
+    (void)atomic_fetch_add_explicit(&c->frames, 1U, memory_order_relaxed);
+    if ((flags & CO_CAN_STATS_TX) != 0U) {
+        (void)atomic_fetch_add_explicit(&c->txFrames, 1U, memory_order_relaxed);
+    }
+    (void)atomic_fetch_add_explicit(&c->bytes, rtr ? 0U : len, memory_order_relaxed);
+    (void)atomic_fetch_add_explicit(&c->bits, bits, memory_order_relaxed);
+
+    uint64_t last = atomic_exchange_explicit(&c->last_us, time_us, memory_order_relaxed);
+    if ((last != 0U) && (time_us >= last)) {
+        uint64_t gap = time_us - last;
+        uint32_t gap32 = (gap > UINT32_MAX) ? UINT32_MAX : (uint32_t)gap;
+        CO_CANstats_min(&c->gapMin_us, gap32);
+        CO_CANstats_max(&c->gapMax_us, gap32);
+    }
+
+    CO_CANstats_slotAdd(stats, time_us, bits);
+}
+
+bool_t
+CO_CANstats_get(const CO_CANstats_t* stats, uint16_t index, CO_CANstatsIdent_t* ident) {
+    if ((stats == NULL) || (ident == NULL) || (index >= CO_CAN_STATS_IDENTS)) {
+        return false;
+    }
+
+    const CO_CANstatsCounters_t* c = &stats->idents[index];
+    ident->frames = (uint32_t)atomic_load_explicit(&c->frames, memory_order_relaxed);
+    ident->txFrames = (uint32_t)atomic_load_explicit(&c->txFrames, memory_order_relaxed);
+    ident->bytes = atomic_load_explicit(&c->bytes, memory_order_relaxed);
+    ident->bits = atomic_load_explicit(&c->bits, memory_order_relaxed);
+    ident->last_us = atomic_load_explicit(&c->last_us, memory_order_relaxed);
+    ident->gapMin_us = (uint32_t)atomic_load_explicit(&c->gapMin_us, memory_order_relaxed);
+    ident->gapMax_us = (uint32_t)atomic_load_explicit(&c->gapMax_us, memory_order_relaxed);
+    if (ident->gapMin_us == UINT32_MAX) {
+        ident->gapMin_us = 0U;
+    }
+    return true;
+}
+
+/* Bus load in 0.01 % of bits in time_us, limited to 100 % */
+static uint16_t
+CO_CANstats_percent(const CO_CANstats_t* stats, uint64_t bits, uint64_t time_us) {
+    uint64_t load;
+
+    if ((time_us == 0U) || (stats->bitrate == 0U)) {
+        return 0U;
+    }
+    load = (bits * 10000U * 1000000U) / ((uint64_t)stats->bitrate * time_us);
+    return (load > 10000U) ? 10000U : (uint16_t)load;
+}
+
+void
+CO_CANstats_load(const CO_CANstats_t* stats, uint32_t window_us, uint64_t now_us, CO_CANstatsLoad_t* load) {
+    if ((stats == NULL) || (load == NULL)) {
+        return;
+    }
+    (void)memset(load, 0, sizeof(CO_CANstatsLoad_t));
+
+    uint64_t start_us = atomic_load_explicit(&stats->start_us, memory_order_relaxed);
+    uint64_t number = now_us / CO_CAN_STATS_SLOT_US;
+    uint32_t count = (window_us + CO_CAN_STATS_SLOT_US - 1U) / CO_CAN_STATS_SLOT_US;
+    uint64_t covered;
+    uint32_t i;
+
+    if (now_us <= start_us) {
+        return;
+    }
+    if (count == 0U) {
+        count = 1U;
+    } else if (count > CO_CAN_STATS_SLOTS) {
+        count = CO_CAN_STATS_SLOTS;
+    } else { /* MISRA C 2004 14.10 */
+    }
+    /* finished slots and the current part of the last slot */
+    covered = ((uint64_t)(count - 1U) * CO_CAN_STATS_SLOT_US) + (now_us % CO_CAN_STATS_SLOT_US);
+    if (covered > (now_us - start_us)) {
+        covered = now_us - start_us;
+    }
+
+    for (i = 0U; (i < count) && (i <= number); i++) {
+        uint64_t n = number - i;
+        uint64_t word = atomic_load_explicit(&stats->slots[n % CO_CAN_STATS_SLOTS], memory_order_relaxed);
+
+        if ((word >> CO_CAN_STATS_SLOT_NUMBER_SHIFT) != (n & CO_CAN_STATS_SLOT_NUMBER_MASK)) {
+            continue;
+        }
+        uint64_t bits = word & CO_CAN_STATS_SLOT_BITS_MASK;
+        load->frames += (uint32_t)((word >> CO_CAN_STATS_SLOT_FRAMES_SHIFT) & CO_CAN_STATS_SLOT_FRAMES_MASK);
+        load->bits += bits;
+        if (i > 0U) {
+            uint16_t peak = CO_CANstats_percent(stats, bits, CO_CAN_STATS_SLOT_US);
+            if (peak > load->peak) {
+                load->peak = peak;
+            }
+        }
+    }
+    load->window_us = (uint32_t)covered;
+    load->load = CO_CANstats_percent(stats, load->bits, covered);
+}
+
+CO_ReturnError_t
+CO_CANstats_monitorOpen(CO_CANstatsMonitor_t* mon, CO_CANstats_t* stats, int can_ifindex) {
+    struct sockaddr_can sockAddr;
+    can_err_mask_t errMask = CAN_ERR_MASK;
+    int optEnable = 1;
+    int tsFlags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    uint16_t i;
+
+    if ((mon == NULL) || (stats == NULL) || (can_ifindex <= 0)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    (void)memset(mon, 0, sizeof(CO_CANstatsMonitor_t));
+    mon->stats = stats;
+    for (i = 0U; i < CO_CAN_STATS_MONITOR_BATCH; i++) {
+        mon->iov[i].iov_base = &mon->frames[i];
+        mon->iov[i].iov_len = CANFD_MTU;
+    }
+
+    mon->fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (mon->fd < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    /* Timestamps and CAN FD frames are not required: frames are then counted at receive time or as classic. */
+    (void)setsockopt(mon->fd, SOL_SOCKET, SO_TIMESTAMPING, &tsFlags, sizeof(tsFlags));
+    (void)setsockopt(mon->fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &optEnable, sizeof(optEnable));
+
+    memset(&sockAddr, 0, sizeof(sockAddr));
+    sockAddr.can_family = AF_CAN;
+    sockAddr.can_ifindex = can_ifindex;
+    if ((setsockopt(mon->fd, SOL_SOCKET, SO_RXQ_OVFL, &optEnable, sizeof(optEnable)) < 0)
+        || (setsockopt(mon->fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errMask, sizeof(errMask)) < 0)
+        || (bind(mon->fd, (struct sockaddr*)&sockAddr, sizeof(sockAddr)) < 0)) {
+        CO_CANstats_monitorClose(mon);
+        return CO_ERROR_SYSCALL;
+    }
+    return CO_ERROR_NO;
+}
+
+/* Count one received frame of the monitor with its ancillary data, realtimeOffset_us converts its timestamp */
+static void
+CO_CANstats_monitorFrame(CO_CANstatsMonitor_t* mon, uint16_t i, int64_t realtimeOffset_us) {
+    struct msghdr* hdr = &mon->hdr[i].msg_hdr;
+    const struct canfd_frame* frame = &mon->frames[i];
+    uint64_t time_us = 0U;
+    struct cmsghdr* cmsg;
+
+    for (cmsg = CMSG_FIRSTHDR(hdr); cmsg != NULL; cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+        if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+            uint32_t dropCount;
+            memcpy(&dropCount, CMSG_DATA(cmsg), sizeof(dropCount));
+            if (dropCount != mon->dropCount) {
+                CO_CANstats_event(mon->stats, CO_CAN_STATS_EV_RX_OVERFLOW, dropCount - mon->dropCount);
+                mon->dropCount = dropCount;
+            }
+        } else if (cmsg->cmsg_type == SO_TIMESTAMPING) {
+            struct timespec ts[3];
+            memcpy(ts, CMSG_DATA(cmsg), sizeof(ts));
+            time_us = CO_CANtimestampFromRealtime(&ts[0], realtimeOffset_us);
+        } else { /* MISRA C 2004 14.10 */
+        }
+    }
+
+    if ((mon->hdr[i].msg_len != CAN_MTU) && (mon->hdr[i].msg_len != CANFD_MTU)) {
+        return;
+    }
+    if ((frame->can_id & CAN_ERR_FLAG) != 0U) {
+        CO_CANstats_event(mon->stats, CO_CAN_STATS_EV_ERROR_FRAME, 1U);
+        return;
+    }
+
+    uint8_t flags = 0U;
+    if (mon->hdr[i].msg_len == CANFD_MTU) {
+        flags = ((frame->flags & CANFD_BRS) != 0U) ? (CO_CAN_STATS_FD | CO_CAN_STATS_BRS) : CO_CAN_STATS_FD;
+    }
+    CO_CANstats_frame(mon->stats, frame->can_id, frame->len, frame->data, flags,
+                      (time_us != 0U) ? time_us : CO_CANtimestampNow());
+}
+
+int32_t
+CO_CANstats_monitorRead(CO_CANstatsMonitor_t* mon) {
+    int32_t received = 0;
+
+    if ((mon == NULL) || (mon->fd < 0)) {
+        return -1;
+    }
+
+    for (;;) {
+        uint16_t i;
+        int n;
+
+        for (i = 0U; i < CO_CAN_STATS_MONITOR_BATCH; i++) {
+            struct msghdr* hdr = &mon->hdr[i].msg_hdr;
+            memset(hdr, 0, sizeof(*hdr));
+            hdr->msg_iov = &mon->iov[i];
+            hdr->msg_iovlen = 1;
+            hdr->msg_control = mon->ctrl[i];
+            hdr->msg_controllen = sizeof(mon->ctrl[i]);
+        }
+
+        do {
+            n = recvmmsg(mon->fd, mon->hdr, CO_CAN_STATS_MONITOR_BATCH, MSG_DONTWAIT, NULL);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0) {
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? received : -1;
+        }
+
+        int64_t realtimeOffset_us = (n > 0) ? CO_CANtimestampRealtimeOffset_us() : 0;
+        for (i = 0U; i < (uint16_t)n; i++) {
+            CO_CANstats_monitorFrame(mon, i, realtimeOffset_us);
+        }
+        received += n;
+
+        if ((unsigned int)n < CO_CAN_STATS_MONITOR_BATCH) {
+            /* receive queue is empty */
+            break;
+        }
+    }
+
+    return received;
+}
+
+void
+CO_CANstats_monitorClose(CO_CANstatsMonitor_t* mon) {
+    if ((mon != NULL) && (mon->fd >= 0)) {
+        (void)close(mon->fd);
+        mon->fd = -1;
+    }
+}
@@ -0,0 +1,292 @@
+/*
+ * CAN traffic statistics and bus load for Linux socketCAN.
+ *
+ * @file        CO_CANstats.h
+ * @ingroup     CO_CANstats
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_CAN_STATS_H
+#define CO_CAN_STATS_H
+
+#include <stdatomic.h>
+
+#include "301/CO_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_CANstats CAN traffic statistics
+ * Per COB-ID frame counters and bus load over sliding windows.
+ *
+ * @ingroup CO_socketCAN
+ * @{
+ *
+ * Statistics object counts frames, data bytes and inter-arrival time (minimum and maximum) for each 11-bit COB-ID,
+ * extended frames are counted together in @ref CO_CAN_STATS_EXT. Each frame is also converted to its length on the
+ * bus, including stuff bits, and summed into slots of @ref CO_CAN_STATS_SLOT_US, from which CO_CANstats_load()
+ * calculates bus load over any window up to @ref CO_CAN_STATS_SLOTS slots (one minute) and the busiest slot in it.
+ * Stuff bits are counted exactly from the identifier, data and CRC of the frame, for classic and CAN FD frames. Data
+ * phase of CAN FD frame with bit rate switch is converted into nominal bit times with the data bit rate.
+ *
+ * All counters are C11 atomics with relaxed order, so frames are counted from any thread (receive thread, mainline,
+ * transmit) without lock and statistics are read by other thread at any time. Snapshot of one COB-ID is not atomic
+ * as a whole, which is not important for statistics.
+ *
+ * There are two sources of frames:
+ * - Driver: if @ref CO_DRIVER_STATS is enabled and CO_CANptrSocketCan_t::stats is set before CO_CANinit(), driver
+ *   counts frames received by the CANopen socket and frames sent by it, and also @ref CO_CAN_STATS_EV_TX_OVERFLOW
+ *   (CO_CAN_ERRTX_OVERFLOW) and @ref CO_CAN_STATS_EV_PDO_LATE (CO_CAN_ERRTX_PDO_LATE) events. Because of kernel
+ *   filter (@ref CO_DRIVER_RX_KERNEL_FILTER) only COB-IDs, used by the node, are seen.
+ * - Monitor: CO_CANstats_monitorOpen() opens own socket without filter, which receives all frames on the bus,
+ *   including frames from other sockets on the same host. This is the bus analyzer, used by 'quick_scan busload'.
+ *
+ * Both sources must not count into the same object, frames sent by the node would be counted twice.
+ *
+ * @code{.c}
+ * static CO_CANstats_t stats;
+ * CO_CANptrSocketCan_t CANptr = {.can_ifindex = if_nametoindex("can0"), .stats = &stats};
+ * CO_CANstats_init(&stats, 1000000, 0);
+ * // ... CO_CANinit(co, &CANptr, 0) ...
+ *
+ * // later, from any thread
+ * CO_CANstatsLoad_t load;
+ * CO_CANstats_load(&stats, 1000000, CO_CANtimestampNow(), &load);
+ * printf("bus load %u.%02u %%\n", load.load / 100U, load.load % 100U);
+ * @endcode
+ */
+
+/** Index of the counters of extended frames (29-bit identifier), after 2048 11-bit COB-IDs */
+#define CO_CAN_STATS_EXT 2048U
+/** Number of COB-ID counters */
+#define CO_CAN_STATS_IDENTS (CO_CAN_STATS_EXT + 1U)
+/** Length of one bus load slot in microseconds */
+#define CO_CAN_STATS_SLOT_US 100000U
+/** Number of bus load slots, longest window is CO_CAN_STATS_SLOTS * CO_CAN_STATS_SLOT_US (one minute) */
+#define CO_CAN_STATS_SLOTS 600U
+
+/**
+ * @defgroup CO_CAN_STATS_FLAGS Frame flags
+ * Flags argument of CO_CANstats_frame()
+ * @{
+ */
+#define CO_CAN_STATS_TX  0x01U /**< Frame was sent by this node */
+#define CO_CAN_STATS_FD  0x02U /**< CAN FD frame */
+#define CO_CAN_STATS_BRS 0x04U /**< CAN FD frame with bit rate switch, data phase at data bit rate */
+/** @} */
+
+/** Events, counted with CO_CANstats_event() */
+typedef enum {
+    CO_CAN_STATS_EV_TX_OVERFLOW = 0, /**< CO_CANsend() to a buffer, which was not sent yet (CO_CAN_ERRTX_OVERFLOW) */
+    CO_CAN_STATS_EV_PDO_LATE = 1,    /**< Synchronous TPDO deleted, not sent in SYNC window (CO_CAN_ERRTX_PDO_LATE) */
+    CO_CAN_STATS_EV_RX_OVERFLOW = 2, /**< Frames dropped by the kernel, socket receive queue was full */
+    CO_CAN_STATS_EV_ERROR_FRAME = 3, /**< CAN error frames, received from the CAN controller */
+    CO_CAN_STATS_EV_COUNT = 4        /**< Number of event counters */
+} CO_CANstats_event_t;
+
+/** Counters of one COB-ID, internal */
+typedef struct {
+    atomic_uint_least32_t frames;    /**< Number of frames */
+    atomic_uint_least32_t txFrames;  /**< Number of frames with @ref CO_CAN_STATS_TX */
+    atomic_uint_least64_t bytes;     /**< Number of data bytes */
+    atomic_uint_least64_t bits;      /**< Time on the bus in nominal bit times */
+    atomic_uint_least64_t last_us;   /**< Timestamp of the last frame */
+    atomic_uint_least32_t gapMin_us; /**< Shortest time between two frames, UINT32_MAX if not known */
+    atomic_uint_least32_t gapMax_us; /**< Longest time between two frames */
+} CO_CANstatsCounters_t;
+
+/** Snapshot of one COB-ID, see CO_CANstats_get() */
+typedef struct {
+    uint32_t frames;    /**< Number of frames, received and sent */
+    uint32_t txFrames;  /**< Frames, which were sent by this node */
+    uint64_t bytes;     /**< Number of data bytes */
+    uint64_t bits;      /**< Time on the bus in nominal bit times */
+    uint64_t last_us;   /**< Timestamp of the last frame, 0 if none */
+    uint32_t gapMin_us; /**< Shortest time between two frames, 0 if less than two frames */
+    uint32_t gapMax_us; /**< Longest time between two frames */
+} CO_CANstatsIdent_t;
+
+/** Bus load over a window, see CO_CANstats_load() */
+typedef struct {
+    uint32_t window_us; /**< Covered time, shorter than requested shortly after CO_CANstats_init() */
+    uint32_t frames;    /**< Frames in the window */
+    uint64_t bits;      /**< Bus time of the frames in nominal bit times */
+    uint16_t load;      /**< Bus load in 0.01 % */
+    uint16_t peak;      /**< Load of the busiest finished slot in the window in 0.01 % */
+} CO_CANstatsLoad_t;
+
+/** CAN statistics object, see @ref CO_CANstats */
+typedef struct CO_CANstats {
+    uint32_t bitrate;                                 /**< Nominal bit rate in bit/s, from CO_CANstats_init() */
+    uint32_t dataBitrate;                             /**< CAN FD data bit rate in bit/s */
+    atomic_uint_least64_t start_us;                   /**< Time of CO_CANstats_init() or CO_CANstats_reset() */
+    atomic_uint_least32_t events[CO_CAN_STATS_EV_COUNT]; /**< Event counters, see CO_CANstats_event_t */
+    /** Bus load slots: slot number (24 bits), frames (16 bits) and bits (24 bits) in one word, updated with CAS */
+    atomic_uint_least64_t slots[CO_CAN_STATS_SLOTS];
+    CO_CANstatsCounters_t idents[CO_CAN_STATS_IDENTS]; /**< Counters for each COB-ID and extended frames */
+} CO_CANstats_t;
+
+/** Number of frames in one read of the monitor socket */
+#define CO_CAN_STATS_MONITOR_BATCH 32U
+
+/** Monitor socket, which receives all frames on the bus into statistics object */
+typedef struct {
+    int fd;                                                      /**< Socket, -1 if not opened */
+    CO_CANstats_t* stats;                                        /**< From CO_CANstats_monitorOpen() */
+    uint32_t dropCount;                                          /**< Last kernel drop counter (SO_RXQ_OVFL) */
+    struct canfd_frame frames[CO_CAN_STATS_MONITOR_BATCH];       /**< Receive batch */
+    struct iovec iov[CO_CAN_STATS_MONITOR_BATCH];                /**< Receive batch io vectors */
+    struct mmsghdr hdr[CO_CAN_STATS_MONITOR_BATCH];              /**< Receive batch message headers */
+    /** Ancillary data: kernel drop counter and receive timestamps (struct scm_timestamping) */
+    uint64_t ctrl[CO_CAN_STATS_MONITOR_BATCH]
+                 [(CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(3U * sizeof(struct timespec))) / sizeof(uint64_t)];
+} CO_CANstatsMonitor_t;
+
+/**
+ * Initialize statistics object, all counters are cleared
+ *
+ * @param stats This object will be initialized.
+ * @param bitrate Nominal bit rate of the CAN bus in bit/s, for bus load.
+ * @param dataBitrate CAN FD data bit rate in bit/s, 0 if the same as bitrate.
+ *
+ * @return CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_CANstats_init(CO_CANstats_t* stats, uint32_t bitrate, uint32_t dataBitrate);
+
+/**
+ * Clear all counters, bit rates are kept
+ *
+ * Frames, which are counted at the same time from other thread, may be partially lost.
+ *
+ * @param stats This object.
+ */
+void CO_CANstats_reset(CO_CANstats_t* stats);
+
+/**
+ * Length of the frame on the bus, including stuff bits, end of frame and interframe space
+ *
+ * @param stats This object, source of the bit rates.
+ * @param can_id CAN identifier with CAN_EFF_FLAG and CAN_RTR_FLAG, as in struct can_frame.
+ * @param len Number of data bytes, as in struct can_frame or struct canfd_frame.
+ * @param data Data bytes, their values determine stuff bits. If NULL, zeros are used, which is the worst case.
+ * @param flags @ref CO_CAN_STATS_FLAGS, CO_CAN_STATS_FD and CO_CAN_STATS_BRS are used.
+ *
+ * @return Time on the bus in nominal bit times. Data phase of CAN FD frame with bit rate switch is converted.
+ */
+uint32_t CO_CANstats_frameBits(const CO_CANstats_t* stats, uint32_t can_id, uint8_t len, const uint8_t* data,
+                               uint8_t flags);
+
+/**
+ * Count one frame, from any thread
+ *
+ * Error frames (CAN_ERR_FLAG) must be counted with CO_CANstats_event() instead.
+ *
+ * @param stats This object.
+ * @param can_id CAN identifier with CAN_EFF_FLAG and CAN_RTR_FLAG.
+ * @param len Number of data bytes.
+ * @param data Data bytes or NULL, see CO_CANstats_frameBits().
+ * @param flags @ref CO_CAN_STATS_FLAGS.
+ * @param time_us Time of the frame, time base of CO_CANtimestampNow() and receive timestamps.
+ */
+void CO_CANstats_frame(CO_CANstats_t* stats, uint32_t can_id, uint8_t len, const uint8_t* data, uint8_t flags,
+                       uint64_t time_us);
+
+/**
+ * Count event, from any thread
+ *
+ * @param stats This object.
+ * @param event Event.
+ * @param count Number of events.
+ */
+static inline void
+CO_CANstats_event(CO_CANstats_t* stats, CO_CANstats_event_t event, uint32_t count) {
+    if ((stats != NULL) && (event < CO_CAN_STATS_EV_COUNT)) {
+        (void)atomic_fetch_add_explicit(&stats->events[event], count, memory_order_relaxed);
+    }
+}
+
+/**
+ * Read event counter
+ *
+ * @param stats This object.
+ * @param event Event.
+ *
+ * @return Number of events since CO_CANstats_init() or CO_CANstats_reset().
+ */
+static inline uint32_t
+CO_CANstats_getEvent(const CO_CANstats_t* stats, CO_CANstats_event_t event) {
+    return ((stats != NULL) && (event < CO_CAN_STATS_EV_COUNT))
+               ? (uint32_t)atomic_load_explicit(&stats->events[event], memory_order_relaxed)
+               : 0U;
+}
+
+/**
+ * Snapshot of the counters of one COB-ID
+ *
+ * @param stats This object.
+ * @param index 11-bit COB-ID or @ref CO_CAN_STATS_EXT.
+ * @param [out] ident Counters.
+ *
+ * @return False, if index is out of range.
+ */
+bool_t CO_CANstats_get(const CO_CANstats_t* stats, uint16_t index, CO_CANstatsIdent_t* ident);
+
+/**
+ * Bus load over the window, which ends at now_us
+ *
+ * @param stats This object.
+ * @param window_us Length of the window, rounded up to @ref CO_CAN_STATS_SLOT_US, at most one minute.
+ * @param now_us Current time, CO_CANtimestampNow().
+ * @param [out] load Bus load.
+ */
+void CO_CANstats_load(const CO_CANstats_t* stats, uint32_t window_us, uint64_t now_us, CO_CANstatsLoad_t* load);
+
+/**
+ * Open monitor socket on CAN interface
+ *
+ * Socket has no filter and receives all frames and error frames on the bus with receive timestamps. It is
+ * non-blocking, application waits on CO_CANstatsMonitor_t::fd with poll() or epoll and then calls
+ * CO_CANstats_monitorRead().
+ *
+ * @param mon This object will be initialized.
+ * @param stats Statistics object, initialized with CO_CANstats_init().
+ * @param can_ifindex CAN network interface index, for example from if_nametoindex("can0").
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_SYSCALL.
+ */
+CO_ReturnError_t CO_CANstats_monitorOpen(CO_CANstatsMonitor_t* mon, CO_CANstats_t* stats, int can_ifindex);
+
+/**
+ * Read all received frames from the monitor socket and count them, does not block
+ *
+ * @param mon This object.
+ *
+ * @return Number of frames read or -1 on socket error.
+ */
+int32_t CO_CANstats_monitorRead(CO_CANstatsMonitor_t* mon);
+
+/**
+ * Close monitor socket
+ *
+ * @param mon This object.
+ */
+void CO_CANstats_monitorClose(CO_CANstatsMonitor_t* mon);
+
+/** @} */ /* CO_CANstats */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CO_CAN_STATS_H */
@@ -0,0 +1,1164 @@
+/*
+ * CAN module object for Linux socketCAN.
+ *
+ * @file        CO_driver.c
+ * @ingroup     CO_driver
+ * @author      Janez Paternoster
+ * @copyright   2004 - 2020 Janez Paternoster
+ *
+ * This file is part of <https://github.com/CANopenNode/CANopenNode>, a CANopen Stack.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* recvmmsg(), sendmmsg() */
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <linux/can/raw.h>
+#include <linux/can/error.h>
+#include <linux/net_tstamp.h>
+
+#include "301/CO_driver.h"
+#if CO_DRIVER_STATS
+#include "CO_CANstats.h"
+#endif
+#if CO_DRIVER_LOG
+#include "CO_CANlog.h"
+#endif
+
+#if CO_DRIVER_CAN_FD
+#define CO_CAN_FRAME_MTU CANFD_MTU /* Size of the largest frame, which is read from socket */
+#else
+#define CO_CAN_FRAME_MTU CAN_MTU
+#endif
+/* Frame is passed to CANrx_callback, if it is standard or CAN FD frame */
+#define CO_CANrxFrameValid(len) (((len) == CAN_MTU) || ((len) == CO_CAN_FRAME_MTU))
+
+/* CO_CANrxMsg_t starts with the kernel frame. The first part of CO_CANtx_t is passed to the kernel directly as struct
+ * can_frame or struct canfd_frame. */
+typedef char CO_CANtx_canFrameCheck[((offsetof(CO_CANtx_t, DLC) == offsetof(struct canfd_frame, len))
+                                     && (offsetof(CO_CANtx_t, flags) == offsetof(struct canfd_frame, flags))
+                                     && (offsetof(CO_CANtx_t, data) == offsetof(struct canfd_frame, data))
+                                     && (offsetof(CO_CANtx_t, bufferFull) >= CO_CAN_FRAME_MTU))
+                                        ? 1
+                                        : -1];
+
+void
+CO_CANsetConfigurationMode(void* CANptr) {
+    /* Bitrate and mode of the interface are configured by the system, for example with 'ip link set can0 ...' */
+    (void)CANptr;
+}
+
+/* Install registered receive buffers into the kernel as CAN_RAW_FILTER array. */
+static void
+CO_CANrxFilterSync(CO_CANmodule_t* CANmodule) {
+#if CO_DRIVER_RX_KERNEL_FILTER
+    struct can_filter filters[CAN_RAW_FILTER_MAX];
+    uint16_t count = 0U;
+    uint16_t i;
+
+    if (CANmodule->fd < 0) {
+        return;
+    }
+
+    for (i = 0U; i < CANmodule->rxSize; i++) {
+        const CO_CANrx_t* buffer = &CANmodule->rxArray[i];
+        struct can_filter filter;
+        uint16_t j;
+
+        if (buffer->CANrx_callback == NULL) {
+            continue;
+        }
+        /* CAN_ERR_FLAG in the mask would register filter for error frames, which are set by CAN_RAW_ERR_FILTER */
+        filter.can_id = buffer->ident;
+        filter.can_mask = buffer->mask & ~CAN_ERR_FLAG;
+
+        for (j = 0U; j < count; j++) {
+            if (filters[j].can_id == filter.can_id && filters[j].can_mask == filter.can_mask) {
+                break;
+            }
+        }
+        if (j < count) {
+            continue; /* duplicate */
+        }
+        if (count >= CAN_RAW_FILTER_MAX) {
+            /* too many filters, receive all standard frames */
+            filters[0].can_id = 0U;
+            filters[0].can_mask = CAN_EFF_FLAG;
+            count = 1U;
+            break;
+        }
+        filters[count++] = filter;
+    }
+
+    /* Empty filter array is valid, socket then receives only error frames. */
+    if (setsockopt(CANmodule->fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters, count * sizeof(struct can_filter)) == 0) {
+        CANmodule->useCANrxFilters = true;
+    } else {
+        /* default filter of the new socket receives all frames */
+        CANmodule->useCANrxFilters = false;
+    }
+#else
+    (void)CANmodule;
+#endif
+}
+
+void
+CO_CANsetNormalMode(CO_CANmodule_t* CANmodule) {
+    /* Filter is installed once after all CANopen objects are initialized. */
+    CO_CANrxFilterSync(CANmodule);
+    CANmodule->CANnormal = true;
+}
+
+CO_ReturnError_t
+CO_CANmodule_init(CO_CANmodule_t* CANmodule, void* CANptr, CO_CANrx_t rxArray[], uint16_t rxSize, CO_CANtx_t txArray[],
+                  uint16_t txSize, uint16_t CANbitRate) {
+    CO_CANptrSocketCan_t* CANptrReal = (CO_CANptrSocketCan_t*)CANptr;
+    struct sockaddr_can sockAddr;
+    can_err_mask_t errMask;
+    int optEnable = 1;
+#if CO_DRIVER_RX_TIMESTAMP
+    int tsFlags;
+#endif
+    uint16_t i;
+
+    (void)CANbitRate; /* configured by the system */
+
+    /* verify arguments */
+    if (CANmodule == NULL || CANptrReal == NULL || rxArray == NULL || txArray == NULL
+        || txSize > CO_DRIVER_TX_SIZE_MAX) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* Mutexes are initialized only once, CANmodule object is zeroed by CO_new(). */
+    if (!CANmodule->locksInitialized) {
+        pthread_mutexattr_t sendAttr;
+        bool_t sendOk = (pthread_mutexattr_init(&sendAttr) == 0)
+                        && (pthread_mutexattr_setprotocol(&sendAttr, PTHREAD_PRIO_INHERIT) == 0)
+                        && (pthread_mutex_init(&CANmodule->sendMutex, &sendAttr) == 0);
+        (void)pthread_mutexattr_destroy(&sendAttr);
+        if (!sendOk || pthread_mutex_init(&CANmodule->emcyMutex, NULL) != 0
+            || pthread_mutex_init(&CANmodule->odMutex, NULL) != 0) {
+            return CO_ERROR_SYSCALL;
+        }
+        CANmodule->locksInitialized = true;
+        CANmodule->fd = -1;
+#if CO_DRIVER_MULTI_THREAD
+        CANmodule->rxThreadWakeFd = -1;
+#endif
+    } else if (CANmodule->fd >= 0) {
+        /* CO_CANmodule_disable() was not called */
+#if CO_DRIVER_MULTI_THREAD
+        CO_CANrxThreadStop(CANmodule);
+#endif
+        (void)close(CANmodule->fd);
+        CANmodule->fd = -1;
+    }
+
+    /* Configure object variables */
+    CANmodule->CANptr = CANptr;
+    CANmodule->rxArray = rxArray;
+    CANmodule->rxSize = rxSize;
+    CANmodule->txArray = txArray;
+    CANmodule->txSize = txSize;
+    CANmodule->CANerrorStatus = 0;
+    CANmodule->CANnormal = false;
+    CANmodule->useCANrxFilters = false;
+    CANmodule->bufferInhibitFlag = false;
+    CANmodule->firstCANtxMessage = true;
+    CANmodule->CANtxCount = 0U;
+    CANmodule->txPrioGeneration = 0U;
+    CANmodule->errOld = 0U;
+    CANmodule->rxDropCount = 0U;
+    CANmodule->txErrors = 0U;
+    CANmodule->rxErrors = 0U;
+    CANmodule->busOff = false;
+#if CO_DRIVER_STATS
+    CANmodule->stats = CANptrReal->stats;
+#endif
+#if CO_DRIVER_LOG
+    CANmodule->log = CANptrReal->log;
+#endif
+
+    for (i = 0U; i < rxSize; i++) {
+        rxArray[i].ident = 0U;
+        rxArray[i].mask = 0xFFFFFFFFU;
+        rxArray[i].object = NULL;
+        rxArray[i].CANrx_callback = NULL;
+    }
+    memset(CANmodule->rxIdentTable, 0, sizeof(CANmodule->rxIdentTable));
+    CANmodule->rxMaskedCount = 0U;
+    CANmodule->rxMaskedOverflow = false;
+    for (i = 0U; i < txSize; i++) {
+        txArray[i].bufferFull = false;
+        txArray[i].syncFlag = false;
+        CANmodule->txSlotToIndex[i] = i;
+        CANmodule->txIndexToSlot[i] = i;
+    }
+    memset(CANmodule->txPending, 0, sizeof(CANmodule->txPending));
+    memset(CANmodule->txSyncSlots, 0, sizeof(CANmodule->txSyncSlots));
+
+    /* Receive batch: each io vector points to its own frame, ancillary data carries the kernel drop counter and
+     * receive timestamp. */
+    for (i = 0U; i < CO_DRIVER_RX_BATCH_SIZE; i++) {
+        CANmodule->rxIov[i].iov_base = &CANmodule->rxBatch[i];
+        CANmodule->rxIov[i].iov_len = CO_CAN_FRAME_MTU;
+    }
+#if CO_DRIVER_MULTI_THREAD
+    atomic_store(&CANmodule->rxRingHead, 0U);
+    atomic_store(&CANmodule->rxRingTail, 0U);
+    atomic_store(&CANmodule->rxRingDropCount, 0U);
+    CANmodule->rxRingDropCountOld = 0U;
+#endif
+
+    /* Create and bind the socket */
+    CANmodule->fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (CANmodule->fd < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+
+    /* Report number of frames, dropped because of full socket receive queue */
+    if (setsockopt(CANmodule->fd, SOL_SOCKET, SO_RXQ_OVFL, &optEnable, sizeof(optEnable)) < 0) {
+        CO_CANmodule_disable(CANmodule);
+        return CO_ERROR_SYSCALL;
+    }
+
+#if CO_DRIVER_RX_TIMESTAMP
+    /* Receive timestamps. Failure is not fatal, frames are then received without timestamp. */
+    tsFlags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+#if CO_DRIVER_RX_TIMESTAMP == 2
+    tsFlags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+#endif
+    (void)setsockopt(CANmodule->fd, SOL_SOCKET, SO_TIMESTAMPING, &tsFlags, sizeof(tsFlags));
+#endif
+
+#if CO_DRIVER_CAN_FD
+    if (setsockopt(CANmodule->fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &optEnable, sizeof(optEnable)) < 0) {
+        CO_CANmodule_disable(CANmodule);
+        return CO_ERROR_SYSCALL;
+    }
+#endif
+
+    /* Receive CAN error frames, they are used for CANerrorStatus */
+    errMask = CAN_ERR_TX_TIMEOUT | CAN_ERR_CRTL | CAN_ERR_BUSOFF | CAN_ERR_RESTARTED | CAN_ERR_CNT;
+    if (setsockopt(CANmodule->fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errMask, sizeof(errMask)) < 0) {
+        CO_CANmodule_disable(CANmodule);
+        return CO_ERROR_SYSCALL;
+    }
+
+    memset(&sockAddr, 0, sizeof(sockAddr));
+    sockAddr.can_family = AF_CAN;
+    sockAddr.can_ifindex = CANptrReal->can_ifindex;
+    if (bind(CANmodule->fd, (struct sockaddr*)&sockAddr, sizeof(sockAddr)) < 0) {
+        CO_CANmodule_disable(CANmodule);
+        return CO_ERROR_SYSCALL;
+    }
+
+    return CO_ERROR_NO;
+}
+
+void
+CO_CANmodule_disable(CO_CANmodule_t* CANmodule) {
+    if (CANmodule != NULL && CANmodule->locksInitialized && CANmodule->fd >= 0) {
+#if CO_DRIVER_MULTI_THREAD
+        /* receive thread reads the socket */
+        CO_CANrxThreadStop(CANmodule);
+#endif
+        (void)close(CANmodule->fd);
+        CANmodule->fd = -1;
+        CANmodule->CANnormal = false;
+    }
+}
+
+/* Buffer accepts only one 11-bit COB-ID, so it can be found by the direct table. */
+#define CO_CANrx_isExact(buffer) (((buffer)->mask & CAN_SFF_MASK) == CAN_SFF_MASK)
+
+/* Set rxIdentTable entry for one COB-ID to the lowest rxArray index, which is registered for it. */
+static void
+CO_CANrxIdentTableUpdate(CO_CANmodule_t* CANmodule, uint32_t ident) {
+    uint16_t entry = 0U;
+    uint16_t i;
+
+    ident &= CAN_SFF_MASK;
+    for (i = 0U; i < CANmodule->rxSize; i++) {
+        const CO_CANrx_t* buffer = &CANmodule->rxArray[i];
+        if ((buffer->CANrx_callback != NULL) && CO_CANrx_isExact(buffer) && ((buffer->ident & CAN_SFF_MASK) == ident)) {
+            entry = i + 1U;
+            break;
+        }
+    }
+    CANmodule->rxIdentTable[ident] = entry;
+}
+
+/* Rebuild list of registered buffers with partial mask. */
+static void
+CO_CANrxMaskedUpdate(CO_CANmodule_t* CANmodule) {
+    uint16_t i;
+
+    CANmodule->rxMaskedCount = 0U;
+    CANmodule->rxMaskedOverflow = false;
+    for (i = 0U; i < CANmodule->rxSize; i++) {
+        const CO_CANrx_t* buffer = &CANmodule->rxArray[i];
+        if ((buffer->CANrx_callback != NULL) && !CO_CANrx_isExact(buffer)) {
+            if (CANmodule->rxMaskedCount >= CO_DRIVER_RX_MASKED_SIZE) {
+                CANmodule->rxMaskedOverflow = true;
+                break;
+            }
+            CANmodule->rxMasked[CANmodule->rxMaskedCount++] = i;
+        }
+    }
+}
+
+CO_ReturnError_t
+CO_CANrxBufferInit(CO_CANmodule_t* CANmodule, uint16_t index, uint16_t ident, uint16_t mask, bool_t rtr, void* object,
+                   void (*CANrx_callback)(void* object, void* message)) {
+    CO_ReturnError_t ret = CO_ERROR_NO;
+
+    if ((CANmodule != NULL) && (object != NULL) && (CANrx_callback != NULL) && (index < CANmodule->rxSize)) {
+        /* buffer, which will be configured */
+        CO_CANrx_t* buffer = &CANmodule->rxArray[index];
+        bool_t wasRegistered = buffer->CANrx_callback != NULL;
+        bool_t wasExact = CO_CANrx_isExact(buffer);
+        uint32_t identOld = buffer->ident;
+        uint32_t maskOld = buffer->mask;
+
+        /* Configure object variables */
+        buffer->object = object;
+        buffer->CANrx_callback = CANrx_callback;
+
+        /* CAN identifier and CAN mask, bit aligned with can_frame.can_id. Extended and error frames never match. */
+        buffer->ident = ident & CAN_SFF_MASK;
+        if (rtr) {
+            buffer->ident |= CAN_RTR_FLAG;
+        }
+        buffer->mask = (mask & CAN_SFF_MASK) | CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG;
+
+        /* Update dispatch index. Buffer may be re-registered with different COB-ID, for example by OD_write_14xx. */
+        if (wasRegistered && wasExact) {
+            CO_CANrxIdentTableUpdate(CANmodule, identOld);
+        }
+        if (CO_CANrx_isExact(buffer)) {
+            CO_CANrxIdentTableUpdate(CANmodule, buffer->ident);
+        }
+        if ((wasRegistered && !wasExact) || !CO_CANrx_isExact(buffer)) {
+            CO_CANrxMaskedUpdate(CANmodule);
+        }
+
+        /* Buffers registered during communication reset are installed with CO_CANsetNormalMode(). Later changes, for
+         * example PDO COB-ID written by OD_write_14xx, update the kernel filter immediately. */
+        if (CANmodule->CANnormal && (!wasRegistered || identOld != buffer->ident || maskOld != buffer->mask)) {
+            CO_CANrxFilterSync(CANmodule);
+        }
+    } else {
+        ret = CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    return ret;
+}
+
+/* Sort transmit buffers by CAN-ID into priority slots and rebuild bitmaps. Called with CO_LOCK_CAN_SEND. Data frame
+ * has priority over RTR frame with the same CAN-ID, buffers with the same CAN-ID are ordered by txArray index. */
+static void
+CO_CANtxPrioUpdate(CO_CANmodule_t* CANmodule) {
+    uint16_t i;
+
+    /* odd generation tells concurrent CO_CANsend() that slots are being moved */
+    (void)__atomic_fetch_add(&CANmodule->txPrioGeneration, 1U, __ATOMIC_SEQ_CST);
+
+    for (i = 0U; i < CANmodule->txSize; i++) {
+        const CO_CANtx_t* buffer = &CANmodule->txArray[i];
+        uint32_t key = ((buffer->ident & CAN_SFF_MASK) << 1) | (((buffer->ident & CAN_RTR_FLAG) != 0U) ? 1U : 0U);
+        uint16_t j = i;
+
+        /* insertion sort, txArray is small and CAN-IDs are changed rarely */
+        while (j > 0U) {
+            const CO_CANtx_t* prev = &CANmodule->txArray[CANmodule->txSlotToIndex[j - 1U]];
+            uint32_t keyPrev = ((prev->ident & CAN_SFF_MASK) << 1) | (((prev->ident & CAN_RTR_FLAG) != 0U) ? 1U : 0U);
+            if (keyPrev <= key) {
+                break;
+            }
+            CANmodule->txSlotToIndex[j] = CANmodule->txSlotToIndex[j - 1U];
+            j--;
+        }
+        CANmodule->txSlotToIndex[j] = i;
+    }
+
+    memset(CANmodule->txPending, 0, sizeof(CANmodule->txPending));
+    memset(CANmodule->txSyncSlots, 0, sizeof(CANmodule->txSyncSlots));
+    for (i = 0U; i < CANmodule->txSize; i++) {
+        uint16_t index = CANmodule->txSlotToIndex[i];
+        uint64_t bit = (uint64_t)1U << (i % 64U);
+
+        CANmodule->txIndexToSlot[index] = i;
+        if (CANmodule->txArray[index].bufferFull) {
+            CANmodule->txPending[i / 64U] |= bit;
+        }
+        if (CANmodule->txArray[index].syncFlag) {
+            CANmodule->txSyncSlots[i / 64U] |= bit;
+        }
+    }
+    (void)__atomic_fetch_add(&CANmodule->txPrioGeneration, 1U, __ATOMIC_SEQ_CST);
+}
+
+CO_CANtx_t*
+CO_CANtxBufferInit(CO_CANmodule_t* CANmodule, uint16_t index, uint16_t ident, bool_t rtr, uint8_t noOfBytes,
+                   bool_t syncFlag) {
+    CO_CANtx_t* buffer = NULL;
+
+    if ((CANmodule != NULL) && (index < CANmodule->txSize) && (noOfBytes <= CO_CAN_DATA_MAX)) {
+        /* get specific buffer */
+        buffer = &CANmodule->txArray[index];
+
+        CO_LOCK_CAN_SEND(CANmodule);
+        /* CAN identifier, DLC and rtr, bit aligned with can_frame */
+        buffer->ident = (uint32_t)ident & CAN_SFF_MASK;
+        if (rtr) {
+            buffer->ident |= CAN_RTR_FLAG;
+        }
+        buffer->DLC = noOfBytes;
+        buffer->flags = 0U;
+        memset(buffer->padding, 0, sizeof(buffer->padding));
+#if CO_DRIVER_CAN_FD
+        if (noOfBytes > CAN_MAX_DLEN) {
+            /* CAN FD frame with bit rate switch, unused data bytes up to the next valid length are zero */
+            buffer->DLC = CO_CANfd_paddedLength(noOfBytes);
+            buffer->flags = CANFD_BRS;
+#ifdef CANFD_FDF
+            buffer->flags |= CANFD_FDF;
+#endif
+            memset(buffer->data, 0, sizeof(buffer->data));
+        }
+#endif
+
+        if (__atomic_exchange_n(&buffer->bufferFull, false, __ATOMIC_ACQ_REL)) {
+            (void)__atomic_fetch_sub(&CANmodule->CANtxCount, 1U, __ATOMIC_RELAXED);
+        }
+        buffer->syncFlag = syncFlag;
+
+        CO_CANtxPrioUpdate(CANmodule);
+        CO_UNLOCK_CAN_SEND(CANmodule);
+    }
+
+    return buffer;
+}
+
+/* Nesting depth of CO_CANtxDeferBegin() in the calling thread */
+static _Thread_local uint16_t CO_CANtxDeferDepth = 0U;
+
+void
+CO_CANtxDeferBegin(void) {
+    CO_CANtxDeferDepth++;
+}
+
+void
+CO_CANtxDeferEnd(void) {
+    if (CO_CANtxDeferDepth > 0U) {
+        CO_CANtxDeferDepth--;
+    }
+}
+
+CO_ReturnError_t
+CO_CANsend(CO_CANmodule_t* CANmodule, CO_CANtx_t* buffer) {
+    CO_ReturnError_t err = CO_ERROR_NO;
+
+    /* Buffer is claimed with bufferFull, no lock is taken. Verify overflow, previous message from this buffer is still
+     * waiting for CO_CANtxFlush(). */
+    if (__atomic_exchange_n(&buffer->bufferFull, true, __ATOMIC_ACQ_REL)) {
+        if (!CANmodule->firstCANtxMessage) {
+            /* don't set error, if bootup message is still on buffers */
+            (void)__atomic_fetch_or(&CANmodule->CANerrorStatus, CO_CAN_ERRTX_OVERFLOW, __ATOMIC_RELAXED);
+#if CO_DRIVER_STATS
+            CO_CANstats_event(CANmodule->stats, CO_CAN_STATS_EV_TX_OVERFLOW, 1U);
+#endif
+        }
+        err = CO_ERROR_TX_OVERFLOW;
+    } else {
+        /* message will be passed to the socket with the next CO_CANtxFlush() */
+        uint16_t index = (uint16_t)(buffer - CANmodule->txArray);
+        uint32_t generation = __atomic_load_n(&CANmodule->txPrioGeneration, __ATOMIC_SEQ_CST);
+        uint16_t slot = CANmodule->txIndexToSlot[index];
+
+        (void)__atomic_fetch_add(&CANmodule->CANtxCount, 1U, __ATOMIC_RELAXED);
+        (void)__atomic_fetch_or(&CANmodule->txPending[slot / 64U], (uint64_t)1U << (slot % 64U), __ATOMIC_SEQ_CST);
+        if (((generation & 1U) != 0U)
+            || (generation != __atomic_load_n(&CANmodule->txPrioGeneration, __ATOMIC_SEQ_CST))) {
+            /* Slots were moved by CO_CANtxBufferInit() in another thread. Mark the slot again, when they are stable.
+             * Stray bit in the old slot is ignored by CO_CANtxFlush(). */
+            CO_LOCK_CAN_SEND(CANmodule);
+            slot = CANmodule->txIndexToSlot[index];
+            (void)__atomic_fetch_or(&CANmodule->txPending[slot / 64U], (uint64_t)1U << (slot % 64U), __ATOMIC_SEQ_CST);
+            CO_UNLOCK_CAN_SEND(CANmodule);
+        }
+    }
+
+    /* Outside of the processing pass message leaves immediately */
+    if ((err == CO_ERROR_NO) && (CO_CANtxDeferDepth == 0U)) {
+        CO_CANtxFlush(CANmodule);
+    }
+
+    return err;
+}
+
+/* Pass prepared batch to the kernel. Called with CO_LOCK_CAN_SEND. Returns true, if all messages were accepted. */
+static bool_t
+CO_CANtxSendBatch(CO_CANmodule_t* CANmodule, unsigned int n) {
+    int sent;
+
+    do {
+        sent = sendmmsg(CANmodule->fd, CANmodule->txMsgHdr, n, MSG_DONTWAIT);
+    } while (sent < 0 && errno == EINTR);
+
+    if (sent > 0) {
+        unsigned int j;
+#if CO_DRIVER_STATS || CO_DRIVER_LOG
+        bool_t observed = false;
+#if CO_DRIVER_STATS
+        observed = observed || (CANmodule->stats != NULL);
+#endif
+#if CO_DRIVER_LOG
+        observed = observed || (CANmodule->log != NULL);
+#endif
+        uint64_t now_us = observed ? CO_CANtimestampNow() : 0U;
+#endif
+        for (j = 0U; j < (unsigned int)sent; j++) {
+            CO_CANtx_t* buffer = CANmodule->txBatch[j];
+            uint16_t slot = CANmodule->txIndexToSlot[buffer - CANmodule->txArray];
+#if CO_DRIVER_STATS
+            if (CANmodule->stats != NULL) {
+                uint8_t flags = CO_CAN_STATS_TX;
+                if (buffer->DLC > CAN_MAX_DLEN) {
+                    flags |= ((buffer->flags & CANFD_BRS) != 0U) ? (CO_CAN_STATS_FD | CO_CAN_STATS_BRS)
+                                                                 : CO_CAN_STATS_FD;
+                }
+                CO_CANstats_frame(CANmodule->stats, buffer->ident, buffer->DLC, buffer->data, flags, now_us);
+            }
+#endif
+#if CO_DRIVER_LOG
+            if (CANmodule->log != NULL) {
+                uint8_t flags = CO_CAN_LOG_TX;
+                if (buffer->DLC > CAN_MAX_DLEN) {
+                    flags |= ((buffer->flags & CANFD_BRS) != 0U) ? (CO_CAN_LOG_FD | CO_CAN_LOG_BRS) : CO_CAN_LOG_FD;
+                }
+                CO_CANlog_frame(CANmodule->log, buffer->ident, buffer->DLC, buffer->data, flags, now_us);
+            }
+#endif
+            /* slot is free before the buffer, so next CO_CANsend() marks it again */
+            (void)__atomic_fetch_and(&CANmodule->txPending[slot / 64U], ~((uint64_t)1U << (slot % 64U)),
+                                     __ATOMIC_SEQ_CST);
+            __atomic_store_n(&buffer->bufferFull, false, __ATOMIC_RELEASE);
+            (void)__atomic_fetch_sub(&CANmodule->CANtxCount, 1U, __ATOMIC_RELAXED);
+        }
+        /* First CAN message (bootup) was sent successfully */
+        CANmodule->firstCANtxMessage = false;
+    }
+
+    /* If kernel transmit queue is full (EAGAIN, ENOBUFS) or interface is down, remaining messages stay pending and
+     * will be retried with the next call. */
+    return sent == (int)n;
+}
+
+/* Pass pending messages from the group (all, if groupSlots is NULL) to the kernel in priority order. */
+static void
+CO_CANtxFlushGroup(CO_CANmodule_t* CANmodule, const uint64_t* groupSlots) {
+    unsigned int n = 0U;
+    bool_t allSent = true;
+    uint16_t w;
+
+    if (CANmodule == NULL || CANmodule->fd < 0) {
+        return;
+    }
+
+    CO_LOCK_CAN_SEND(CANmodule);
+    uint16_t txCount = __atomic_load_n(&CANmodule->CANtxCount, __ATOMIC_RELAXED);
+    for (w = 0U; (w < CO_DRIVER_TX_WORDS) && allSent && (txCount > 0U); w++) {
+        uint64_t bits = __atomic_load_n(&CANmodule->txPending[w], __ATOMIC_ACQUIRE);
+
+        if (groupSlots != NULL) {
+            bits &= groupSlots[w];
+        }
+        while (bits != 0U) {
+            uint16_t slot = (uint16_t)(w * 64U + (uint16_t)__builtin_ctzll(bits));
+            CO_CANtx_t* buffer = &CANmodule->txArray[CANmodule->txSlotToIndex[slot]];
+
+            bits &= bits - 1U;
+            if (!__atomic_load_n(&buffer->bufferFull, __ATOMIC_ACQUIRE)) {
+                /* stray bit from CO_CANsend() concurrent with CO_CANtxBufferInit() */
+                (void)__atomic_fetch_and(&CANmodule->txPending[w], ~((uint64_t)1U << (slot % 64U)), __ATOMIC_SEQ_CST);
+                continue;
+            }
+            CANmodule->txBatch[n] = buffer;
+            CANmodule->txIov[n].iov_base = buffer;
+            CANmodule->txIov[n].iov_len = (buffer->DLC > CAN_MAX_DLEN) ? CANFD_MTU : CAN_MTU;
+            memset(&CANmodule->txMsgHdr[n], 0, sizeof(CANmodule->txMsgHdr[n]));
+            CANmodule->txMsgHdr[n].msg_hdr.msg_iov = &CANmodule->txIov[n];
+            CANmodule->txMsgHdr[n].msg_hdr.msg_iovlen = 1;
+            n++;
+
+            if (n == CO_DRIVER_TX_BATCH_SIZE) {
+                allSent = CO_CANtxSendBatch(CANmodule, n);
+                n = 0U;
+                if (!allSent) {
+                    break;
+                }
+            }
+        }
+    }
+    if (allSent && n > 0U) {
+        (void)CO_CANtxSendBatch(CANmodule, n);
+    }
+    CO_UNLOCK_CAN_SEND(CANmodule);
+}
+
+void
+CO_CANtxFlush(CO_CANmodule_t* CANmodule) {
+    CO_CANtxFlushGroup(CANmodule, NULL);
+}
+
+void
+CO_CANtxFlushSync(CO_CANmodule_t* CANmodule) {
+    if (CANmodule != NULL) {
+        CO_CANtxFlushGroup(CANmodule, CANmodule->txSyncSlots);
+    }
+}
+
+void
+CO_CANclearPendingSyncPDOs(CO_CANmodule_t* CANmodule) {
+    uint32_t tpdoDeleted = 0U;
+    uint16_t w;
+
+    CO_LOCK_CAN_SEND(CANmodule);
+    /* Messages already passed to the kernel can not be aborted. Delete pending synchronous TPDOs in TX buffers. */
+    for (w = 0U; (w < CO_DRIVER_TX_WORDS) && (__atomic_load_n(&CANmodule->CANtxCount, __ATOMIC_RELAXED) != 0U); w++) {
+        uint64_t bits = __atomic_fetch_and(&CANmodule->txPending[w], ~CANmodule->txSyncSlots[w], __ATOMIC_SEQ_CST)
+                        & CANmodule->txSyncSlots[w];
+
+        while (bits != 0U) {
+            uint16_t slot = (uint16_t)(w * 64U + (uint16_t)__builtin_ctzll(bits));
+            bits &= bits - 1U;
+            if (__atomic_exchange_n(&CANmodule->txArray[CANmodule->txSlotToIndex[slot]].bufferFull, false,
+                                    __ATOMIC_ACQ_REL)) {
+                (void)__atomic_fetch_sub(&CANmodule->CANtxCount, 1U, __ATOMIC_RELAXED);
+                tpdoDeleted++;
+            }
+        }
+    }
+    CO_UNLOCK_CAN_SEND(CANmodule);
+
+    if (tpdoDeleted != 0U) {
+        (void)__atomic_fetch_or(&CANmodule->CANerrorStatus, CO_CAN_ERRTX_PDO_LATE, __ATOMIC_RELAXED);
+#if CO_DRIVER_STATS
+        CO_CANstats_event(CANmodule->stats, CO_CAN_STATS_EV_PDO_LATE, tpdoDeleted);
+#endif
+    }
+}
+
+void
+CO_CANmodule_process(CO_CANmodule_t* CANmodule) {
+    uint32_t err;
+
+#if CO_DRIVER_MULTI_THREAD
+    /* Frames, which were not yet processed by the application */
+    (void)CO_CANrxRingProcess(CANmodule);
+#endif
+    /* Pass messages, which were not flushed by the application */
+    CO_CANtxFlush(CANmodule);
+
+    /* Error counters are updated from CAN error frames in CO_CANinterrupt() */
+    err = ((uint32_t)CANmodule->txErrors << 16) | ((uint32_t)CANmodule->rxErrors << 8) | CANmodule->busOff;
+
+    if (CANmodule->errOld != err) {
+        uint16_t status = CANmodule->CANerrorStatus;
+
+        CANmodule->errOld = err;
+
+        if (CANmodule->busOff) {
+            status |= CO_CAN_ERRTX_BUS_OFF;
+        } else {
+            /* recalculate CANerrorStatus, first clear some flags */
+            status &= 0xFFFF
+                      ^ (CO_CAN_ERRTX_BUS_OFF | CO_CAN_ERRRX_WARNING | CO_CAN_ERRRX_PASSIVE | CO_CAN_ERRTX_WARNING
+                         | CO_CAN_ERRTX_PASSIVE);
+
+            /* rx bus warning or passive */
+            if (CANmodule->rxErrors >= 128U) {
+                status |= CO_CAN_ERRRX_WARNING | CO_CAN_ERRRX_PASSIVE;
+            } else if (CANmodule->rxErrors >= 96U) {
+                status |= CO_CAN_ERRRX_WARNING;
+            }
+
+            /* tx bus warning or passive */
+            if (CANmodule->txErrors >= 128U) {
+                status |= CO_CAN_ERRTX_WARNING | CO_CAN_ERRTX_PASSIVE;
+            } else if (CANmodule->txErrors >= 96U) {
+                status |= CO_CAN_ERRTX_WARNING;
+            }
+
+            /* if not tx passive clear also overflow */
+            if ((status & CO_CAN_ERRTX_PASSIVE) == 0U) {
+                status &= 0xFFFF ^ CO_CAN_ERRTX_OVERFLOW;
+            }
+        }
+
+        CANmodule->CANerrorStatus = status;
+    }
+}
+
+/* Update error state from CAN error frame, see linux/can/error.h */
+static void
+CO_CANerrorFrame(CO_CANmodule_t* CANmodule, const CO_CANrxMsg_t* msg) {
+    if ((msg->frame.can_id & CAN_ERR_BUSOFF) != 0U) {
+        CANmodule->busOff = true;
+    }
+    if ((msg->frame.can_id & CAN_ERR_RESTARTED) != 0U) {
+        CANmodule->busOff = false;
+    }
+    if ((msg->frame.can_id & CAN_ERR_CNT) != 0U) {
+        CANmodule->txErrors = msg->frame.data[6];
+        CANmodule->rxErrors = msg->frame.data[7];
+    } else if ((msg->frame.can_id & CAN_ERR_CRTL) != 0U) {
+        /* error counters are not available, estimate them from controller status */
+        uint8_t ctrl = msg->frame.data[1];
+        if ((ctrl & CAN_ERR_CRTL_TX_PASSIVE) != 0U) {
+            CANmodule->txErrors = 128U;
+        } else if ((ctrl & CAN_ERR_CRTL_TX_WARNING) != 0U) {
+            CANmodule->txErrors = 96U;
+        }
+        if ((ctrl & CAN_ERR_CRTL_RX_PASSIVE) != 0U) {
+            CANmodule->rxErrors = 128U;
+        } else if ((ctrl & CAN_ERR_CRTL_RX_WARNING) != 0U) {
+            CANmodule->rxErrors = 96U;
+        }
+        if ((ctrl & (CAN_ERR_CRTL_RX_OVERFLOW | CAN_ERR_CRTL_TX_OVERFLOW)) != 0U) {
+            CANmodule->CANerrorStatus |= CO_CAN_ERRRX_OVERFLOW;
+        }
+        if ((ctrl & CAN_ERR_CRTL_ACTIVE) != 0U) {
+            CANmodule->txErrors = 0U;
+            CANmodule->rxErrors = 0U;
+        }
+    }
+}
+
+/* Find receive buffer for can_frame.can_id. Result is the same as with linear search through rxArray: the matching
+ * buffer with the lowest index. */
+static inline CO_CANrx_t*
+CO_CANrxFind(CO_CANmodule_t* CANmodule, uint32_t rcvMsgIdent) {
+    CO_CANrx_t* buffer = NULL;
+    uint16_t best = CANmodule->rxSize;
+    uint16_t entry = CANmodule->rxIdentTable[rcvMsgIdent & CAN_SFF_MASK];
+    bool_t searchAll = CANmodule->rxMaskedOverflow;
+    uint16_t i;
+
+    if (entry != 0U) {
+        buffer = &CANmodule->rxArray[entry - 1U];
+        if (((rcvMsgIdent ^ buffer->ident) & buffer->mask) == 0U) {
+            best = entry - 1U;
+        } else {
+            /* Same COB-ID registered with different RTR bit, uncommon. */
+            buffer = NULL;
+            searchAll = true;
+        }
+    }
+
+    if (searchAll) {
+        /* Linear search through whole rxArray */
+        buffer = &CANmodule->rxArray[0];
+        for (i = CANmodule->rxSize; i > 0U; i--) {
+            if ((buffer->CANrx_callback != NULL) && (((rcvMsgIdent ^ buffer->ident) & buffer->mask) == 0U)) {
+                return buffer;
+            }
+            buffer++;
+        }
+        return NULL;
+    }
+
+    /* Masked buffers with lower index have priority over direct table entry. */
+    for (i = 0U; (i < CANmodule->rxMaskedCount) && (CANmodule->rxMasked[i] < best); i++) {
+        CO_CANrx_t* masked = &CANmodule->rxArray[CANmodule->rxMasked[i]];
+        if (((rcvMsgIdent ^ masked->ident) & masked->mask) == 0U) {
+            return masked;
+        }
+    }
+
+    return buffer;
+}
+
+/* Pass received frame to the matching CANopen object. */
+static inline void
+CO_CANrxDispatch(CO_CANmodule_t* CANmodule, CO_CANrxMsg_t* rcvMsg) {
+    if ((rcvMsg->frame.can_id & CAN_ERR_FLAG) != 0U) {
+        CO_CANerrorFrame(CANmodule, rcvMsg);
+    } else if (CANmodule->CANnormal) {
+        CO_CANrx_t* buffer = CO_CANrxFind(CANmodule, rcvMsg->frame.can_id);
+        if (buffer != NULL) {
+            /* Call specific function, which will process the message */
+            buffer->CANrx_callback(buffer->object, (void*)rcvMsg);
+        }
+    }
+}
+
+/* Prepare receive message headers for recvmmsg(). io vectors must be already set. */
+static void
+CO_CANrxPrepare(CO_CANmodule_t* CANmodule, unsigned int count) {
+    unsigned int i;
+
+    for (i = 0U; i < count; i++) {
+        struct msghdr* hdr = &CANmodule->rxMsgHdr[i].msg_hdr;
+        memset(hdr, 0, sizeof(*hdr));
+        hdr->msg_iov = &CANmodule->rxIov[i];
+        hdr->msg_iovlen = 1;
+        hdr->msg_control = CANmodule->rxCtrl[i];
+        hdr->msg_controllen = sizeof(CANmodule->rxCtrl[i]);
+    }
+}
+
+/* Read the kernel drop counter and receive timestamp of rcvMsg from ancillary data. realtimeOffset_us is from
+ * CO_CANtimestampRealtimeOffset_us(). Return number of newly dropped frames. */
+static uint32_t
+CO_CANrxAncillary(CO_CANmodule_t* CANmodule, struct msghdr* hdr, CO_CANrxMsg_t* rcvMsg, int64_t realtimeOffset_us) {
+    uint32_t dropped = 0U;
+    struct cmsghdr* cmsg;
+
+    rcvMsg->timestamp_us = 0U;
+    for (cmsg = CMSG_FIRSTHDR(hdr); cmsg != NULL; cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+        if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+            uint32_t dropCount;
+            memcpy(&dropCount, CMSG_DATA(cmsg), sizeof(dropCount));
+            dropped = dropCount - CANmodule->rxDropCount;
+            CANmodule->rxDropCount = dropCount;
+        }
+#if CO_DRIVER_RX_TIMESTAMP
+        else if (cmsg->cmsg_type == SO_TIMESTAMPING) {
+            /* struct scm_timestamping: ts[0] is software, ts[2] is raw hardware timestamp */
+            struct timespec ts[3];
+            memcpy(ts, CMSG_DATA(cmsg), sizeof(ts));
+            if (ts[2].tv_sec == 0 && ts[2].tv_nsec == 0) {
+                ts[2] = ts[0];
+            }
+            rcvMsg->timestamp_us = CO_CANtimestampFromRealtime(&ts[2], realtimeOffset_us);
+        }
+#endif
+        else { /* MISRA C 2004 14.10 */
+        }
+    }
+    (void)realtimeOffset_us;
+    return dropped;
+}
+
+/* Call recvmmsg(), repeat if interrupted. Return 0 if receive queue is empty. */
+static int
+CO_CANrxRead(CO_CANmodule_t* CANmodule, unsigned int count) {
+    int n;
+
+    do {
+        n = recvmmsg(CANmodule->fd, CANmodule->rxMsgHdr, count, MSG_DONTWAIT, NULL);
+    } while (n < 0 && errno == EINTR);
+
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        n = 0;
+    }
+    return n;
+}
+
+#if CO_DRIVER_STATS
+/* Count received frame and frames, dropped before it, into statistics. Frames, which are dropped from the full receive
+ * ring, are counted as well, they were on the bus. */
+static void
+CO_CANrxStats(CO_CANmodule_t* CANmodule, const CO_CANrxMsg_t* rcvMsg, unsigned int msgLen, uint32_t dropped) {
+    struct CO_CANstats* stats = CANmodule->stats;
+    uint8_t flags = 0U;
+
+    if (stats == NULL) {
+        return;
+    }
+    if (dropped != 0U) {
+        CO_CANstats_event(stats, CO_CAN_STATS_EV_RX_OVERFLOW, dropped);
+    }
+    if (!CO_CANrxFrameValid(msgLen)) {
+        return;
+    }
+    if ((rcvMsg->frame.can_id & CAN_ERR_FLAG) != 0U) {
+        CO_CANstats_event(stats, CO_CAN_STATS_EV_ERROR_FRAME, 1U);
+        return;
+    }
+#if CO_DRIVER_CAN_FD
+    if (msgLen == CANFD_MTU) {
+        flags = ((rcvMsg->frame.flags & CANFD_BRS) != 0U) ? (CO_CAN_STATS_FD | CO_CAN_STATS_BRS) : CO_CAN_STATS_FD;
+    }
+#endif
+    CO_CANstats_frame(stats, rcvMsg->frame.can_id, rcvMsg->frame.len, rcvMsg->frame.data, flags,
+                      (rcvMsg->timestamp_us != 0U) ? rcvMsg->timestamp_us : CO_CANtimestampNow());
+}
+#endif
+
+#if CO_DRIVER_LOG
+/* Record received frame, error frames included. */
+static void
+CO_CANrxLog(CO_CANmodule_t* CANmodule, const CO_CANrxMsg_t* rcvMsg, unsigned int msgLen) {
+    uint8_t flags = 0U;
+
+    if ((CANmodule->log == NULL) || !CO_CANrxFrameValid(msgLen)) {
+        return;
+    }
+#if CO_DRIVER_CAN_FD
+    if (msgLen == CANFD_MTU) {
+        flags = ((rcvMsg->frame.flags & CANFD_BRS) != 0U) ? (CO_CAN_LOG_FD | CO_CAN_LOG_BRS) : CO_CAN_LOG_FD;
+    }
+#endif
+    CO_CANlog_frame(CANmodule->log, rcvMsg->frame.can_id, rcvMsg->frame.len, rcvMsg->frame.data, flags,
+                    (rcvMsg->timestamp_us != 0U) ? rcvMsg->timestamp_us : CO_CANtimestampNow());
+}
+#endif
+
+void
+CO_CANrxInject(CO_CANmodule_t* CANmodule, CO_CANrxMsg_t* rcvMsg) {
+    if ((CANmodule != NULL) && (rcvMsg != NULL)) {
+        CO_CANrxDispatch(CANmodule, rcvMsg);
+    }
+}
+
+#if CO_DRIVER_MULTI_THREAD
+int32_t
+CO_CANinterrupt(CO_CANmodule_t* CANmodule) {
+    int32_t received = 0;
+
+    if (CANmodule == NULL || CANmodule->fd < 0) {
+        return -1;
+    }
+
+    for (;;) {
+        uint_fast32_t head = atomic_load_explicit(&CANmodule->rxRingHead, memory_order_relaxed);
+        uint_fast32_t tail = atomic_load_explicit(&CANmodule->rxRingTail, memory_order_acquire);
+        uint_fast32_t space = CO_DRIVER_RX_RING_SIZE - (head - tail);
+        uint32_t dropped = 0U;
+        unsigned int count = (space < CO_DRIVER_RX_BATCH_SIZE) ? (unsigned int)space : CO_DRIVER_RX_BATCH_SIZE;
+        int64_t realtimeOffset_us;
+        unsigned int i;
+        int n;
+
+        if (count == 0U) {
+            /* ring is full, remaining frames wait in the socket receive queue */
+            break;
+        }
+        /* Frames are read directly into free ring slots */
+        for (i = 0U; i < count; i++) {
+            CANmodule->rxIov[i].iov_base = &CANmodule->rxRing[(head + i) & (CO_DRIVER_RX_RING_SIZE - 1U)];
+        }
+        CO_CANrxPrepare(CANmodule, count);
+
+        n = CO_CANrxRead(CANmodule, count);
+        if (n < 0) {
+            return -1;
+        }
+        realtimeOffset_us = ((n > 0) && CO_DRIVER_RX_TIMESTAMP) ? CO_CANtimestampRealtimeOffset_us() : 0;
+
+        for (i = 0U; i < (unsigned int)n; i++) {
+            CO_CANrxMsg_t* rcvMsg = (CO_CANrxMsg_t*)CANmodule->rxIov[i].iov_base;
+            uint32_t droppedKernel = CO_CANrxAncillary(CANmodule, &CANmodule->rxMsgHdr[i].msg_hdr, rcvMsg,
+                                                       realtimeOffset_us);
+            dropped += droppedKernel;
+#if CO_DRIVER_STATS
+            CO_CANrxStats(CANmodule, rcvMsg, CANmodule->rxMsgHdr[i].msg_len, droppedKernel);
+#endif
+#if CO_DRIVER_LOG
+            CO_CANrxLog(CANmodule, rcvMsg, CANmodule->rxMsgHdr[i].msg_len);
+#endif
+            if (!CO_CANrxFrameValid(CANmodule->rxMsgHdr[i].msg_len)) {
+                /* extended frame never matches, slot is skipped by CO_CANrxRingProcess() */
+                rcvMsg->frame.can_id = CAN_EFF_FLAG;
+            }
+        }
+        atomic_store_explicit(&CANmodule->rxRingHead, head + (uint_fast32_t)n, memory_order_release);
+        received += n;
+        if (dropped != 0U) {
+            (void)atomic_fetch_add_explicit(&CANmodule->rxRingDropCount, dropped, memory_order_relaxed);
+        }
+
+        if ((unsigned int)n < count) {
+            /* receive queue is empty */
+            break;
+        }
+    }
+
+    return received;
+}
+
+int32_t
+CO_CANrxRingProcess(CO_CANmodule_t* CANmodule) {
+    uint_fast32_t tail = atomic_load_explicit(&CANmodule->rxRingTail, memory_order_relaxed);
+    uint_fast32_t head = atomic_load_explicit(&CANmodule->rxRingHead, memory_order_acquire);
+    uint32_t dropCount = (uint32_t)atomic_load_explicit(&CANmodule->rxRingDropCount, memory_order_relaxed);
+    int32_t processed = (int32_t)(head - tail);
+
+    if (dropCount != CANmodule->rxRingDropCountOld) {
+        CANmodule->rxRingDropCountOld = dropCount;
+        CANmodule->CANerrorStatus |= CO_CAN_ERRRX_OVERFLOW;
+    }
+
+    for (; tail != head; tail++) {
+        CO_CANrxDispatch(CANmodule, &CANmodule->rxRing[tail & (CO_DRIVER_RX_RING_SIZE - 1U)]);
+    }
+    /* slots can be reused by the receive thread */
+    atomic_store_explicit(&CANmodule->rxRingTail, tail, memory_order_release);
+
+    return processed;
+}
+
+/* Receive thread: wait for the socket, push frames into the ring and wake the mainline. */
+static void*
+CO_CANrxThread(void* arg) {
+    CO_CANmodule_t* CANmodule = (CO_CANmodule_t*)arg;
+    struct pollfd fds[2];
+
+    fds[0].fd = CANmodule->fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = CANmodule->rxThreadWakeFd;
+    fds[1].events = POLLIN;
+
+    for (;;) {
+        int ready = poll(fds, 2, -1);
+
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents != 0) {
+            /* CO_CANrxThreadStop() */
+            break;
+        }
+        if (fds[0].revents != 0) {
+            int32_t received = CO_CANinterrupt(CANmodule);
+
+            if (received > 0) {
+                if (CANmodule->rxNotify != NULL) {
+                    CANmodule->rxNotify(CANmodule->rxNotifyObject);
+                }
+                /* Ring is full, wait for CO_CANrxRingProcess() instead of polling the still readable socket. Frames
+                 * are kept by the kernel meanwhile. */
+                while ((atomic_load_explicit(&CANmodule->rxRingHead, memory_order_relaxed)
+                        - atomic_load_explicit(&CANmodule->rxRingTail, memory_order_acquire))
+                       == CO_DRIVER_RX_RING_SIZE) {
+                    if (poll(&fds[1], 1, 1) > 0) {
+                        break;
+                    }
+                }
+            } else if (received < 0) {
+                /* socket error, for example interface down, don't spin */
+                struct timespec ts = {.tv_sec = 0, .tv_nsec = 10000000L};
+                (void)nanosleep(&ts, NULL);
+            } else { /* MISRA C 2004 14.10 */
+            }
+        }
+    }
+
+    return NULL;
+}
+
+bool_t
+CO_CANrxThreadStart(CO_CANmodule_t* CANmodule, void (*notify)(void* object), void* object) {
+    if (CANmodule == NULL || CANmodule->fd < 0) {
+        return false;
+    }
+
+    CO_CANrxThreadStop(CANmodule);
+
+    CANmodule->rxNotify = notify;
+    CANmodule->rxNotifyObject = object;
+    CANmodule->rxThreadWakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (CANmodule->rxThreadWakeFd < 0) {
+        return false;
+    }
+    if (pthread_create(&CANmodule->rxThread, NULL, CO_CANrxThread, CANmodule) != 0) {
+        (void)close(CANmodule->rxThreadWakeFd);
+        CANmodule->rxThreadWakeFd = -1;
+        return false;
+    }
+    CANmodule->rxThreadStarted = true;
+
+    return true;
+}
+
+void
+CO_CANrxThreadStop(CO_CANmodule_t* CANmodule) {
+    if (CANmodule == NULL || !CANmodule->rxThreadStarted) {
+        return;
+    }
+
+    uint64_t u = 1;
+    ssize_t s = write(CANmodule->rxThreadWakeFd, &u, sizeof(u));
+    (void)s;
+    (void)pthread_join(CANmodule->rxThread, NULL);
+    (void)close(CANmodule->rxThreadWakeFd);
+    CANmodule->rxThreadWakeFd = -1;
+    CANmodule->rxThreadStarted = false;
+}
+#else
+int32_t
+CO_CANinterrupt(CO_CANmodule_t* CANmodule) {
+    int32_t received = 0;
+
+    if (CANmodule == NULL || CANmodule->fd < 0) {
+        return -1;
+    }
+
+    for (;;) {
+        int64_t realtimeOffset_us;
+        unsigned int i;
+        int n;
+
+        for (i = 0U; i < CO_DRIVER_RX_BATCH_SIZE; i++) {
+            CANmodule->rxIov[i].iov_base = &CANmodule->rxBatch[i];
+        }
+        CO_CANrxPrepare(CANmodule, CO_DRIVER_RX_BATCH_SIZE);
+
+        n = CO_CANrxRead(CANmodule, CO_DRIVER_RX_BATCH_SIZE);
+        if (n < 0) {
+            return -1;
+        }
+        realtimeOffset_us = ((n > 0) && CO_DRIVER_RX_TIMESTAMP) ? CO_CANtimestampRealtimeOffset_us() : 0;
+
+        for (i = 0U; i < (unsigned int)n; i++) {
+            uint32_t dropped = CO_CANrxAncillary(CANmodule, &CANmodule->rxMsgHdr[i].msg_hdr, &CANmodule->rxBatch[i],
+                                                 realtimeOffset_us);
+            if (dropped != 0U) {
+                CANmodule->CANerrorStatus |= CO_CAN_ERRRX_OVERFLOW;
+            }
+#if CO_DRIVER_STATS
+            CO_CANrxStats(CANmodule, &CANmodule->rxBatch[i], CANmodule->rxMsgHdr[i].msg_len, dropped);
+#endif
+#if CO_DRIVER_LOG
+            CO_CANrxLog(CANmodule, &CANmodule->rxBatch[i], CANmodule->rxMsgHdr[i].msg_len);
+#endif
+            if (CO_CANrxFrameValid(CANmodule->rxMsgHdr[i].msg_len)) {
+                CO_CANrxDispatch(CANmodule, &CANmodule->rxBatch[i]);
+            }
+        }
+        received += n;
+
+        if ((unsigned int)n < CO_DRIVER_RX_BATCH_SIZE) {
+            /* receive queue is empty */
+            break;
+        }
+    }
+
+    return received;
+}
+#endif /* CO_DRIVER_MULTI_THREAD */
@@ -0,0 +1,707 @@
+/*
+ * Linux socketCAN specific definitions for CANopenNode.
+ *
+ * @file        CO_driver_target.h
+ * @ingroup     CO_socketCAN_driver_target
+ * @author      Janez Paternoster
+ * @copyright   2004 - 2020 Janez Paternoster
+ *
+ * This file is part of <https://github.com/CANopenNode/CANopenNode>, a CANopen Stack.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_DRIVER_TARGET_H
+#define CO_DRIVER_TARGET_H
+
+/* This file contains device and application specific definitions. It is included from CO_driver.h, which contains
+ * documentation for common definitions below.
+ *
+ * struct mmsghdr is used in CO_CANmodule_t, so _GNU_SOURCE must be defined for all files, which include this file. */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <endian.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <linux/can.h>
+
+#ifdef CO_DRIVER_CUSTOM
+#include "CO_driver_custom.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_socketCAN socketCAN
+ * Linux socketCAN interface for CANopenNode.
+ *
+ * Received frames are read with recvmmsg() in CO_CANinterrupt() and transmitted frames are passed to the kernel with
+ * sendmmsg() in CO_CANtxFlush(), so single wakeup handles the whole burst of CAN messages. Messages are collected for
+ * CO_CANtxFlush() only inside of the processing pass, see CO_CANtxDeferBegin(), otherwise CO_CANsend() passes them to
+ * the kernel immediately.
+ */
+
+/**
+ * @defgroup CO_socketCAN_driver_target CO_driver_target.h
+ * Linux socketCAN specific @ref CO_driver definitions for CANopenNode.
+ *
+ * @ingroup CO_socketCAN
+ * @{
+ */
+
+/**
+ * CAN FD. If 1, socket is configured with CAN_RAW_FD_FRAMES, CO_CANrxMsg_t and CO_CANtx_t carry up to 64 data bytes
+ * and PDOs may be up to @ref CO_PDO_MAX_SIZE = 64 bytes long. Messages with more than 8 data bytes are sent as CAN FD
+ * frames with bit rate switch, other messages as classic CAN frames. CAN interface must be configured for CAN FD, for
+ * example with 'ip link set can0 type can bitrate 1000000 dbitrate 5000000 fd on'.
+ */
+#ifndef CO_DRIVER_CAN_FD
+#define CO_DRIVER_CAN_FD 0
+#endif
+
+#if CO_DRIVER_CAN_FD
+#define CO_CAN_DATA_MAX 64U /**< Maximum number of data bytes in CAN message */
+#ifndef CO_PDO_MAX_SIZE
+#define CO_PDO_MAX_SIZE 64U
+#endif
+#define CO_CAN_PADDED_LENGTH(len) CO_CANfd_paddedLength(len)
+#else
+#define CO_CAN_DATA_MAX 8U
+#endif
+
+/**
+ * Receive timestamps, see CO_CANrxMsg_readTimestamp().
+ * - 0 - Timestamps are disabled.
+ * - 1 - Software timestamps, taken by the kernel when frame is received from the CAN driver.
+ * - 2 - Hardware timestamps from the CAN controller, if available, otherwise software timestamps. Hardware clock must
+ *   be synchronized to CLOCK_REALTIME (for example with phc2sys).
+ *
+ * Kernel reports both in CLOCK_REALTIME. Driver converts them into CLOCK_MONOTONIC of CO_CANtimestampNow() with the
+ * offset between both clocks, sampled once for each recvmmsg() batch, so setting of the system time does not change
+ * the age of received messages.
+ */
+#ifndef CO_DRIVER_RX_TIMESTAMP
+#define CO_DRIVER_RX_TIMESTAMP 1
+#endif
+
+/* Stack configuration override default values. For more information see file CO_config.h. */
+#define CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE CO_CONFIG_FLAG_CALLBACK_PRE
+#define CO_CONFIG_GLOBAL_FLAG_TIMERNEXT    CO_CONFIG_FLAG_TIMERNEXT
+#if CO_DRIVER_RX_TIMESTAMP
+#define CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP CO_CONFIG_FLAG_RX_TIMESTAMP
+#endif
+
+#ifndef CO_CONFIG_NMT
+#define CO_CONFIG_NMT                                                                                                  \
+    (CO_CONFIG_NMT_CALLBACK_CHANGE | CO_CONFIG_NMT_MASTER | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE                         \
+     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT)
+#endif
+
+#ifndef CO_CONFIG_HB_CONS
+#define CO_CONFIG_HB_CONS                                                                                              \
+    (CO_CONFIG_HB_CONS_ENABLE | CO_CONFIG_HB_CONS_CALLBACK_CHANGE | CO_CONFIG_HB_CONS_QUERY_FUNCT                      \
+     | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+#endif
+
+#ifndef CO_CONFIG_EM
+#define CO_CONFIG_EM                                                                                                   \
+    (CO_CONFIG_EM_PRODUCER | CO_CONFIG_EM_PROD_CONFIGURABLE | CO_CONFIG_EM_PROD_INHIBIT | CO_CONFIG_EM_HISTORY         \
+     | CO_CONFIG_EM_STATUS_BITS | CO_CONFIG_EM_CONSUMER | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE                           \
+     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT)
+#endif
+
+#ifndef CO_CONFIG_SDO_SRV
+#define CO_CONFIG_SDO_SRV                                                                                              \
+    (CO_CONFIG_SDO_SRV_SEGMENTED | CO_CONFIG_SDO_SRV_BLOCK | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE                        \
+     | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+#endif
+
+#ifndef CO_CONFIG_SDO_SRV_BUFFER_SIZE
+#define CO_CONFIG_SDO_SRV_BUFFER_SIZE 900
+#endif
+
+/* SDO server uploads large OD variables directly from their memory, see OD_IO_t.view */
+#ifndef OD_IO_VIEW
+#define OD_IO_VIEW 1
+#endif
+
+/* OD_find() uses perfect hash index from OD_hash.c, generated by od_hashgen, see OD_initHash() */
+#ifndef OD_HASH
+#define OD_HASH 1
+#endif
+
+/* Application and gateway access hot OD variables through resolved handles, see OD_handle_init() */
+#ifndef OD_HANDLES
+#define OD_HANDLES 1
+#endif
+
+/* CO_process_TPDO() visits only active TPDOs and TPDOs marked by OD_requestTPDO(), see CO_TPDO_pending_t */
+#ifndef OD_TPDO_PENDING_WORDS
+#define OD_TPDO_PENDING_WORDS 2
+#endif
+
+/* CO_process_RPDO() visits only received RPDOs and RPDOs with running timeout monitoring, see CO_RPDO_ready_t */
+#ifndef CO_RPDO_READY_WORDS
+#define CO_RPDO_READY_WORDS 2
+#endif
+
+/* Heartbeat consumer and Node Guarding master process only received and expired nodes, see CO_nodeTimers_t */
+#ifndef CO_NODE_TIMERS
+#define CO_NODE_TIMERS 1
+#endif
+
+/* States of all remote nodes as bitsets, see CO_netState_t */
+#ifndef CO_CONFIG_NET_STATE
+#define CO_CONFIG_NET_STATE (CO_CONFIG_NET_STATE_ENABLE)
+#endif
+
+/* Received emergency messages are queued and delivered in batches from CO_process(), see CO_EMcons_t */
+#ifndef CO_CONFIG_EM_CONS
+#define CO_CONFIG_EM_CONS (CO_CONFIG_EM_CONS_ENABLE)
+#endif
+
+/* Execution time of each processing step, see CO_prof_t. Clock is read once per step, define CO_CONFIG_PROF to 0 to
+ * remove it. */
+#ifndef CO_CONFIG_PROF
+#define CO_CONFIG_PROF (CO_CONFIG_PROF_ENABLE)
+#endif
+
+#ifndef CO_CONFIG_SDO_CLI
+#define CO_CONFIG_SDO_CLI                                                                                              \
+    (CO_CONFIG_SDO_CLI_ENABLE | CO_CONFIG_SDO_CLI_SEGMENTED | CO_CONFIG_SDO_CLI_BLOCK | CO_CONFIG_SDO_CLI_LOCAL        \
+     | CO_CONFIG_SDO_CLI_POOL | CO_CONFIG_SDO_CLI_CACHE | CO_CONFIG_SDO_CLI_RTT                                        \
+     | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC)
+#endif
+
+#ifndef CO_CONFIG_SDO_CLI_BUFFER_SIZE
+#define CO_CONFIG_SDO_CLI_BUFFER_SIZE 1000
+#endif
+
+#ifndef CO_CONFIG_PDO
+#define CO_CONFIG_PDO                                                                                                  \
+    (CO_CONFIG_RPDO_ENABLE | CO_CONFIG_TPDO_ENABLE | CO_CONFIG_RPDO_TIMERS_ENABLE | CO_CONFIG_TPDO_TIMERS_ENABLE       \
+     | CO_CONFIG_PDO_SYNC_ENABLE | CO_CONFIG_PDO_OD_IO_ACCESS | CO_CONFIG_PDO_COPY_PLAN                                \
+     | CO_CONFIG_GLOBAL_RT_FLAG_CALLBACK_PRE | CO_CONFIG_GLOBAL_FLAG_TIMERNEXT | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC      \
+     | CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP)
+#endif
+
+#ifndef CO_CONFIG_TIME
+#define CO_CONFIG_TIME                                                                                                 \
+    (CO_CONFIG_TIME_ENABLE | CO_CONFIG_TIME_PRODUCER | CO_CONFIG_TIME_PRECISE | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE     \
+     | CO_CONFIG_GLOBAL_FLAG_OD_DYNAMIC | CO_CONFIG_GLOBAL_FLAG_RX_TIMESTAMP)
+#endif
+
+#ifndef CO_CONFIG_LSS
+#define CO_CONFIG_LSS                                                                                                  \
+    (CO_CONFIG_LSS_SLAVE | CO_CONFIG_LSS_SLAVE_FASTSCAN_DIRECT_RESPOND | CO_CONFIG_LSS_MASTER                          \
+     | CO_CONFIG_LSS_MASTER_BULK | CO_CONFIG_GLOBAL_FLAG_CALLBACK_PRE)
+#endif
+
+#ifndef CO_CONFIG_GTW
+#define CO_CONFIG_GTW                                                                                                  \
+    (CO_CONFIG_GTW_ASCII | CO_CONFIG_GTW_ASCII_SDO | CO_CONFIG_GTW_ASCII_NMT | CO_CONFIG_GTW_ASCII_LSS                 \
+     | CO_CONFIG_GTW_ASCII_LOG | CO_CONFIG_GTW_ASCII_ERROR_DESC | CO_CONFIG_GTW_ASCII_PRINT_HELP                       \
+     | CO_CONFIG_GTW_ASCII_PRINT_LEDS | CO_CONFIG_GTW_BINARY)
+#define CO_CONFIG_GTW_BLOCK_DL_LOOP  3
+#define CO_CONFIG_GTWA_COMM_BUF_SIZE 2000
+#define CO_CONFIG_GTWA_LOG_BUF_SIZE  10000
+#endif
+
+#ifndef CO_CONFIG_CRC16
+#define CO_CONFIG_CRC16 (CO_CONFIG_CRC16_ENABLE | CO_CONFIG_CRC16_SLICING)
+#endif
+
+#ifndef CO_CONFIG_FIFO
+#define CO_CONFIG_FIFO                                                                                                 \
+    (CO_CONFIG_FIFO_ENABLE | CO_CONFIG_FIFO_ALT_READ | CO_CONFIG_FIFO_CRC16_CCITT | CO_CONFIG_FIFO_ASCII_COMMANDS      \
+     | CO_CONFIG_FIFO_ASCII_DATATYPES)
+#endif
+
+/**
+ * Maximum number of CAN frames, which are read from the socket with single recvmmsg() call. Each frame is then passed
+ * to its CANrx_callback() directly from the receive buffer.
+ */
+#ifndef CO_DRIVER_RX_BATCH_SIZE
+#define CO_DRIVER_RX_BATCH_SIZE 32U
+#endif
+
+/**
+ * Maximum number of CAN frames, which are passed to the socket with single sendmmsg() call from CO_CANtxFlush().
+ */
+#ifndef CO_DRIVER_TX_BATCH_SIZE
+#define CO_DRIVER_TX_BATCH_SIZE 32U
+#endif
+
+/**
+ * Maximum number of transmit buffers (txSize). Pending transmit buffers are tracked with bitmap, ordered by CAN-ID
+ * priority.
+ */
+#ifndef CO_DRIVER_TX_SIZE_MAX
+#define CO_DRIVER_TX_SIZE_MAX 256U
+#endif
+#define CO_DRIVER_TX_WORDS ((CO_DRIVER_TX_SIZE_MAX + 63U) / 64U) /**< Number of 64-bit words in transmit bitmaps */
+
+/**
+ * If 1, COB-IDs registered with CO_CANrxBufferInit() are installed into the kernel as CAN_RAW_FILTER, so socket
+ * receives only frames, which are used by some CANopen object. If 0, all frames from the bus are received.
+ */
+#ifndef CO_DRIVER_RX_KERNEL_FILTER
+#define CO_DRIVER_RX_KERNEL_FILTER 1
+#endif
+
+/**
+ * Maximum number of receive buffers with mask other than 0x7FF (EMCY consumer, node guarding master, ...). They are
+ * searched sequentially after lookup in the direct COB-ID table. If more are registered, driver falls back to the
+ * linear search through the whole rxArray.
+ */
+#ifndef CO_DRIVER_RX_MASKED_SIZE
+#define CO_DRIVER_RX_MASKED_SIZE 8U
+#endif
+
+/**
+ * Multi-threaded receive. If 1, CO_CANinterrupt() is called from separate receive thread, started with
+ * CO_CANrxThreadStart() (by CO_epoll_initCANopenMain()). It only pushes received frames into lock-free
+ * single-producer/single-consumer ring of @ref CO_DRIVER_RX_RING_SIZE frames and wakes the mainline. Mainline thread
+ * then drains the ring with CO_CANrxRingProcess() and calls CANrx_callback() functions, so all CANopen objects are
+ * accessed from the processing threads only and receive path takes no lock. If 0, CO_CANinterrupt() calls
+ * CANrx_callback() functions directly.
+ */
+#ifndef CO_DRIVER_MULTI_THREAD
+#define CO_DRIVER_MULTI_THREAD 0
+#endif
+
+/** Number of frames in receive ring, must be power of two. Used if @ref CO_DRIVER_MULTI_THREAD is 1. */
+#ifndef CO_DRIVER_RX_RING_SIZE
+#define CO_DRIVER_RX_RING_SIZE 256U
+#endif
+
+/**
+ * Traffic statistics. If 1 and CO_CANptrSocketCan_t::stats is set, frames received and sent by the CANopen socket,
+ * transmit overflows, late synchronous TPDOs, dropped frames and error frames are counted, see @ref CO_CANstats.
+ */
+#ifndef CO_DRIVER_STATS
+#define CO_DRIVER_STATS 1
+#endif
+
+/**
+ * Record and replay. If 1 and CO_CANptrSocketCan_t::log is set, frames received and sent by the CANopen socket are
+ * recorded into memory mapped log, see @ref CO_CANlog. CO_CANrxInject() is available in any case.
+ */
+#ifndef CO_DRIVER_LOG
+#define CO_DRIVER_LOG 1
+#endif
+
+/* Basic definitions. If big endian, CO_SWAP_xx macros must swap bytes. */
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+#define CO_LITTLE_ENDIAN
+#define CO_SWAP_16(x) x
+#define CO_SWAP_32(x) x
+#define CO_SWAP_64(x) x
+#else
+#define CO_BIG_ENDIAN
+#include <byteswap.h>
+#define CO_SWAP_16(x) bswap_16(x)
+#define CO_SWAP_32(x) bswap_32(x)
+#define CO_SWAP_64(x) bswap_64(x)
+#endif
+/* NULL is defined in stddef.h */
+/* true and false are defined in stdbool.h */
+/* int8_t to uint64_t are defined in stdint.h */
+typedef uint_fast8_t bool_t;
+typedef float float32_t;
+typedef double float64_t;
+
+/** Kernel CAN frame, as read by recvmmsg(): struct canfd_frame (if @ref CO_DRIVER_CAN_FD) or struct can_frame. */
+#if CO_DRIVER_CAN_FD
+typedef struct canfd_frame CO_CANframe_t;
+#else
+typedef struct can_frame CO_CANframe_t;
+#endif
+
+/** CAN receive message structure. Kernel frame is received directly into it and the same memory is passed to
+ * CANrx_callback, so there is no copy between the socket and the CANopen objects. */
+typedef struct {
+    CO_CANframe_t frame;   /**< Kernel CAN frame, first member, its address is passed to recvmmsg() */
+    uint64_t timestamp_us; /**< Receive timestamp in the time base of CO_CANtimestampNow(), 0 if not available */
+} CO_CANrxMsg_t;
+
+/* Access to received CAN message */
+static inline uint16_t
+CO_CANrxMsg_readIdent(void* rxMsg) {
+    CO_CANrxMsg_t* rxMsgCasted = (CO_CANrxMsg_t*)rxMsg;
+    return (uint16_t)(rxMsgCasted->frame.can_id & CAN_SFF_MASK);
+}
+
+static inline uint8_t
+CO_CANrxMsg_readDLC(void* rxMsg) {
+    CO_CANrxMsg_t* rxMsgCasted = (CO_CANrxMsg_t*)rxMsg;
+    return (uint8_t)(rxMsgCasted->frame.len);
+}
+
+static inline const uint8_t*
+CO_CANrxMsg_readData(void* rxMsg) {
+    CO_CANrxMsg_t* rxMsgCasted = (CO_CANrxMsg_t*)rxMsg;
+    return rxMsgCasted->frame.data;
+}
+
+#if CO_DRIVER_CAN_FD
+/** Convert CAN FD DLC code (0 to 15) to number of data bytes, as can_fd_dlc2len() in the kernel. */
+static inline uint8_t
+CO_CANfd_dlcToLength(uint8_t dlc) {
+    static const uint8_t dlcToLength[16] = {0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
+    return dlcToLength[dlc & 0x0FU];
+}
+
+/** Convert number of data bytes to the smallest CAN FD DLC code, which can carry them, as can_fd_len2dlc(). */
+static inline uint8_t
+CO_CANfd_lengthToDlc(uint8_t length) {
+    uint8_t dlc = (length <= 8U) ? length : 9U;
+    while ((dlc < 15U) && (CO_CANfd_dlcToLength(dlc) < length)) {
+        dlc++;
+    }
+    return dlc;
+}
+
+/** Length of CAN FD frame, which carries length data bytes. Frames with more than 8 bytes are padded with zeros. */
+static inline uint8_t
+CO_CANfd_paddedLength(uint8_t length) {
+    return CO_CANfd_dlcToLength(CO_CANfd_lengthToDlc(length));
+}
+#endif
+
+static inline uint64_t
+CO_CANrxMsg_readTimestamp(void* rxMsg) {
+    CO_CANrxMsg_t* rxMsgCasted = (CO_CANrxMsg_t*)rxMsg;
+    return rxMsgCasted->timestamp_us;
+}
+
+/* CLOCK_MONOTONIC in microseconds, base for receive timestamps, SYNC, RPDO and SRDO timeouts. Unlike CLOCK_REALTIME it
+ * does not step, when system time is set. */
+static inline uint64_t
+CO_CANtimestampNow(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+}
+
+/* Offset of CLOCK_REALTIME against CO_CANtimestampNow(), microseconds, sampled now */
+static inline int64_t
+CO_CANtimestampRealtimeOffset_us(void) {
+    struct timespec mono;
+    struct timespec real;
+    (void)clock_gettime(CLOCK_MONOTONIC, &mono);
+    (void)clock_gettime(CLOCK_REALTIME, &real);
+    return (((int64_t)real.tv_sec - (int64_t)mono.tv_sec) * 1000000) + (((int64_t)real.tv_nsec - mono.tv_nsec) / 1000);
+}
+
+static inline uint64_t
+CO_CANtimestampToUnix_us(uint64_t timestamp_us) {
+    return (timestamp_us != 0U) ? (uint64_t)((int64_t)timestamp_us + CO_CANtimestampRealtimeOffset_us()) : 0U;
+}
+
+/* Convert CLOCK_REALTIME timestamp from SO_TIMESTAMPING into the time base of CO_CANtimestampNow(), 0 if not set */
+static inline uint64_t
+CO_CANtimestampFromRealtime(const struct timespec* ts, int64_t realtimeOffset_us) {
+    int64_t t_us = (((int64_t)ts->tv_sec * 1000000) + (ts->tv_nsec / 1000)) - realtimeOffset_us;
+    return ((ts->tv_sec == 0) && (ts->tv_nsec == 0)) || (t_us <= 0) ? 0U : (uint64_t)t_us;
+}
+
+/* Free running clock for CO_prof_lap(), nanoseconds, wraps around */
+static inline uint32_t
+CO_prof_timeNow_ns(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint32_t)ts.tv_sec * 1000000000U) + (uint32_t)ts.tv_nsec;
+}
+#define CO_PROF_TIME_NS() CO_prof_timeNow_ns()
+
+/** Received message object */
+typedef struct {
+    uint32_t ident; /**< CAN identifier with CAN_RTR_FLAG, as in can_frame.can_id */
+    uint32_t mask;  /**< Mask for ident, same alignment */
+    void* object;   /**< From CO_CANrxBufferInit() */
+    void (*CANrx_callback)(void* object, void* message); /**< From CO_CANrxBufferInit() */
+} CO_CANrx_t;
+
+/** Transmit message object, same alignment as struct can_frame or struct canfd_frame in socketCAN. */
+typedef struct {
+    uint32_t ident;                /**< CAN identifier, as in can_frame.can_id */
+    uint8_t DLC;                   /**< Data length in bytes, as in can_frame.len */
+    uint8_t flags;                 /**< CAN FD flags, as in canfd_frame.flags */
+    uint8_t padding[2];            /**< Ensure alignment with can_frame */
+    uint8_t data[CO_CAN_DATA_MAX]; /**< Data bytes */
+    volatile bool_t bufferFull; /**< True, if message is waiting in the queue for CO_CANtxFlush() */
+    volatile bool_t syncFlag;   /**< Synchronous PDO message */
+} CO_CANtx_t;
+
+/**
+ * CAN interface object, passed to CO_CANinit() as CANptr.
+ *
+ * Application specifies interface index, for example with if_nametoindex("can0").
+ */
+typedef struct {
+    int can_ifindex;           /**< CAN network interface index */
+    struct CO_CANstats* stats; /**< Traffic statistics from CO_CANstats.h or NULL, see @ref CO_DRIVER_STATS */
+    struct CO_CANlog* log;     /**< Log for recording from CO_CANlog.h or NULL, see @ref CO_DRIVER_LOG */
+} CO_CANptrSocketCan_t;
+
+/** CAN module object */
+typedef struct {
+    void* CANptr;                    /**< From CO_CANmodule_init(), pointer to CO_CANptrSocketCan_t */
+    CO_CANrx_t* rxArray;             /**< From CO_CANmodule_init() */
+    uint16_t rxSize;                 /**< From CO_CANmodule_init() */
+    CO_CANtx_t* txArray;             /**< From CO_CANmodule_init() */
+    uint16_t txSize;                 /**< From CO_CANmodule_init() */
+    uint16_t CANerrorStatus;         /**< CAN error status bitfield, see @ref CO_CAN_ERR_status_t */
+    volatile bool_t CANnormal;       /**< CAN module is in normal mode */
+    volatile bool_t useCANrxFilters; /**< True, if registered COB-IDs are installed as CAN_RAW_FILTER */
+    volatile bool_t bufferInhibitFlag; /**< Not used, frames already passed to the kernel can not be aborted */
+    volatile bool_t firstCANtxMessage; /**< Equal to 1, until the first message (bootup) is passed to the socket */
+    volatile uint16_t CANtxCount;      /**< Number of messages in txArray, waiting for CO_CANtxFlush() */
+    volatile uint32_t txPrioGeneration; /**< Odd while CO_CANtxBufferInit() rebuilds priority slots */
+    uint32_t errOld;                   /**< Previous state of CAN errors */
+    int fd;                            /**< socketCAN file descriptor, -1 if not opened */
+    uint32_t rxDropCount;              /**< Frames dropped by the kernel because of full socket receive queue */
+    uint8_t txErrors;                  /**< Transmit error counter from the last CAN error frame */
+    uint8_t rxErrors;                  /**< Receive error counter from the last CAN error frame */
+    bool_t busOff;                     /**< Bus off reported by the last CAN error frame */
+    bool_t locksInitialized;           /**< Mutexes below are initialized */
+    pthread_mutex_t sendMutex;         /**< Serializes CO_CANtxFlush() and transmit buffer configuration */
+    pthread_mutex_t emcyMutex;         /**< CO_LOCK_EMCY() */
+    pthread_mutex_t odMutex;           /**< CO_LOCK_OD() */
+    /** Receive batch, frames are read here by recvmmsg() and passed to callbacks from here. */
+    CO_CANrxMsg_t rxBatch[CO_DRIVER_RX_BATCH_SIZE];
+    struct iovec rxIov[CO_DRIVER_RX_BATCH_SIZE];                          /**< Receive batch io vectors */
+    struct mmsghdr rxMsgHdr[CO_DRIVER_RX_BATCH_SIZE];                     /**< Receive batch message headers */
+    /** Ancillary data: kernel drop counter and receive timestamps (struct scm_timestamping) */
+    uint64_t rxCtrl[CO_DRIVER_RX_BATCH_SIZE]
+                   [(CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(3U * sizeof(struct timespec))) / sizeof(uint64_t)];
+    struct iovec txIov[CO_DRIVER_TX_BATCH_SIZE];      /**< Transmit batch io vectors, point into txArray */
+    struct mmsghdr txMsgHdr[CO_DRIVER_TX_BATCH_SIZE]; /**< Transmit batch message headers */
+    CO_CANtx_t* txBatch[CO_DRIVER_TX_BATCH_SIZE];     /**< Buffers, passed to the last sendmmsg() */
+    /** Pending transmit buffers, bit position is priority slot. Lowest set bit is the highest priority CAN-ID. */
+    uint64_t txPending[CO_DRIVER_TX_WORDS];
+    uint64_t txSyncSlots[CO_DRIVER_TX_WORDS];          /**< Priority slots of buffers with syncFlag set */
+    uint16_t txSlotToIndex[CO_DRIVER_TX_SIZE_MAX];     /**< txArray index for each priority slot, sorted by CAN-ID */
+    uint16_t txIndexToSlot[CO_DRIVER_TX_SIZE_MAX];     /**< Priority slot for each txArray index */
+    /** Direct receive dispatch table, indexed by 11-bit COB-ID. Value is (rxArray index + 1) of the lowest registered
+     * buffer with exact mask for that COB-ID or 0 if none. Maintained by CO_CANrxBufferInit(). */
+    uint16_t rxIdentTable[CAN_SFF_MASK + 1U];
+    uint16_t rxMasked[CO_DRIVER_RX_MASKED_SIZE]; /**< rxArray indexes of buffers with partial mask, ascending */
+    uint16_t rxMaskedCount;                      /**< Number of used entries in rxMasked */
+    bool_t rxMaskedOverflow;                     /**< More than CO_DRIVER_RX_MASKED_SIZE masked buffers, search all */
+#if CO_DRIVER_MULTI_THREAD
+    /** Receive ring, written by recvmmsg() in the receive thread, read by CO_CANrxRingProcess() in the mainline. */
+    CO_CANrxMsg_t rxRing[CO_DRIVER_RX_RING_SIZE];
+    atomic_uint_fast32_t rxRingHead;      /**< Next slot to write, modified only by the receive thread */
+    atomic_uint_fast32_t rxRingTail;      /**< Next slot to read, modified only by the mainline thread */
+    atomic_uint_fast32_t rxRingDropCount; /**< Frames dropped by the kernel, counted in the receive thread */
+    uint32_t rxRingDropCountOld;          /**< rxRingDropCount, last seen by the mainline thread */
+    pthread_t rxThread;                   /**< Receive thread, see CO_CANrxThreadStart() */
+    bool_t rxThreadStarted;               /**< True, if receive thread is running */
+    int rxThreadWakeFd;                   /**< eventfd, which ends the receive thread, -1 if not opened */
+    void (*rxNotify)(void* object);       /**< From CO_CANrxThreadStart() */
+    void* rxNotifyObject;                 /**< From CO_CANrxThreadStart() */
+#endif
+#if CO_DRIVER_STATS
+    struct CO_CANstats* stats; /**< From CO_CANptrSocketCan_t, NULL if statistics are not used */
+#endif
+#if CO_DRIVER_LOG
+    struct CO_CANlog* log; /**< From CO_CANptrSocketCan_t, NULL if frames are not recorded */
+#endif
+} CO_CANmodule_t;
+
+/** Data storage object for one entry */
+typedef struct {
+    void* addr;
+    size_t len;
+    uint8_t subIndexOD;
+    uint8_t attr;
+    /* Additional variables (target specific) */
+    void* storageModule;
+    uint16_t crc;
+    size_t eepromAddrSignature;
+    size_t eepromAddr;
+    size_t offset;
+    void* addrShadow;
+    void* addrSnapshot;
+    size_t storeOffset;
+    bool_t storePending;
+    void* additionalParameters;
+    void* addrNV;
+} CO_storage_entry_t;
+
+/* (un)lock CO_CANtxFlush() and transmit buffer configuration. CO_CANsend() itself is lock-free, it claims the buffer
+ * with atomic bufferFull and marks its priority slot pending. Mutex uses priority inheritance, because SYNC producer
+ * thread may flush concurrently with the mainline. */
+#define CO_LOCK_CAN_SEND(CAN_MODULE)   (void)pthread_mutex_lock(&(CAN_MODULE)->sendMutex)
+#define CO_UNLOCK_CAN_SEND(CAN_MODULE) (void)pthread_mutex_unlock(&(CAN_MODULE)->sendMutex)
+
+/* (un)lock critical section in CO_errorReport() or CO_errorReset() */
+#define CO_LOCK_EMCY(CAN_MODULE)       (void)pthread_mutex_lock(&(CAN_MODULE)->emcyMutex)
+#define CO_UNLOCK_EMCY(CAN_MODULE)     (void)pthread_mutex_unlock(&(CAN_MODULE)->emcyMutex)
+
+/* (un)lock critical section when accessing Object Dictionary. With CO_DRIVER_MULTI_THREAD receive callbacks run in the
+ * processing thread, so this and CO_LOCK_EMCY() only serialize processing and application threads, the receive thread
+ * never takes them. */
+#define CO_LOCK_OD(CAN_MODULE)         (void)pthread_mutex_lock(&(CAN_MODULE)->odMutex)
+#define CO_UNLOCK_OD(CAN_MODULE)       (void)pthread_mutex_unlock(&(CAN_MODULE)->odMutex)
+
+/* Synchronization between CAN receive and message processing threads. Flag is set after the received data are
+ * copied (release) and data are read after flag is seen (acquire), which is required on multi-core ARM. Plain
+ * volatile pointer is used for the flag, because its type is defined in the stack modules. */
+#define CO_MemoryBarrier()             atomic_thread_fence(memory_order_seq_cst)
+#define CO_FLAG_READ(rxNew)            CO_FLAG_readAcquire((volatile void* volatile*)&(rxNew))
+#define CO_FLAG_SET(rxNew)                                                                                             \
+    {                                                                                                                  \
+        atomic_thread_fence(memory_order_release);                                                                     \
+        *(volatile void* volatile*)&(rxNew) = (void*)1L;                                                               \
+    }
+#define CO_FLAG_CLEAR(rxNew)                                                                                           \
+    {                                                                                                                  \
+        atomic_thread_fence(memory_order_release);                                                                     \
+        *(volatile void* volatile*)&(rxNew) = NULL;                                                                    \
+    }
+
+static inline bool_t
+CO_FLAG_readAcquire(volatile void* volatile* flag) {
+    bool_t isSet = *flag != NULL;
+    atomic_thread_fence(memory_order_acquire);
+    return isSet;
+}
+
+/* Bitmaps of received objects, set by CAN receive and taken as a whole by processing, see CO_RPDO_ready_t */
+#define CO_FLAG_BITS_SET(bits, mask)   (void)__atomic_fetch_or(&(bits), (mask), __ATOMIC_RELEASE)
+#define CO_FLAG_BITS_TAKE(bits)        __atomic_exchange_n(&(bits), 0U, __ATOMIC_ACQUIRE)
+
+/**
+ * Receive and process CAN messages from socketCAN.
+ *
+ * Function reads all frames currently waiting in the socket receive queue, up to @ref CO_DRIVER_RX_BATCH_SIZE of them
+ * with each recvmmsg() call, and passes each frame to its CANrx_callback(). Function does not block. It should be
+ * called, when CANmodule->fd is readable, for example after poll() or epoll_wait().
+ *
+ * If @ref CO_DRIVER_MULTI_THREAD is 1, function is called from the receive thread and frames are only pushed into the
+ * receive ring. If ring is full, remaining frames stay in the socket receive queue. Frames dropped by the kernel are
+ * reported with CO_CAN_ERRRX_OVERFLOW.
+ *
+ * @param CANmodule CAN module object.
+ *
+ * @return Number of received frames or -1 on socket error.
+ */
+int32_t CO_CANinterrupt(CO_CANmodule_t* CANmodule);
+
+/**
+ * Pass all pending CAN messages from txArray to socketCAN.
+ *
+ * Between CO_CANtxDeferBegin() and CO_CANtxDeferEnd() CO_CANsend() only queues the message in its CO_CANtx_t buffer.
+ * This function passes all queued messages to the kernel with a single sendmmsg() call per
+ * @ref CO_DRIVER_TX_BATCH_SIZE messages, in the order of CAN-ID (highest priority first). Messages, which the kernel
+ * did not accept (full transmit queue), stay queued for the next call. It is called from CO_CANsend() outside of
+ * deferred section and from CO_CANmodule_process(). Application, which defers transmission, calls it after the
+ * processing pass, for example after CO_process() and after CO_process_TPDO().
+ *
+ * @param CANmodule CAN module object.
+ */
+void CO_CANtxFlush(CO_CANmodule_t* CANmodule);
+
+/**
+ * Start deferred transmission in the calling thread.
+ *
+ * Until the matching CO_CANtxDeferEnd(), CO_CANsend() called from this thread only queues the message, so all messages
+ * of a processing pass leave together with the following CO_CANtxFlush() or CO_CANtxFlushSync(). Outside of deferred
+ * section CO_CANsend() itself calls CO_CANtxFlush(), so messages sent from application threads, for example by
+ * blocking SDO client or NMT master helpers, are not delayed. Processing functions of @ref CO_epoll_interface defer
+ * their passes. Calls may be nested.
+ */
+void CO_CANtxDeferBegin(void);
+
+/**
+ * End deferred transmission in the calling thread, see CO_CANtxDeferBegin().
+ *
+ * Queued messages are not passed to the kernel, call CO_CANtxFlush() after this function.
+ */
+void CO_CANtxDeferEnd(void);
+
+/**
+ * Pass pending synchronous TPDOs to socketCAN.
+ *
+ * Same as CO_CANtxFlush(), but only buffers with syncFlag are passed to the kernel, together and in CAN-ID priority
+ * order. Function may be called by the real-time thread directly after CO_process_TPDO(), so all synchronous TPDOs
+ * after SYNC leave with single sendmmsg() call.
+ *
+ * @param CANmodule CAN module object.
+ */
+void CO_CANtxFlushSync(CO_CANmodule_t* CANmodule);
+
+/**
+ * Pass frame to CANrx_callback() function, as if it was received from the socket.
+ *
+ * Used for replay of recorded frames, see CO_CANreplay_process(). Frame is not recorded and not counted in the
+ * statistics. Error frames are processed as received error frames. Function must be called from the thread, which
+ * calls CANrx_callback() functions: the thread of CO_CANinterrupt() or the mainline thread, if
+ * @ref CO_DRIVER_MULTI_THREAD is enabled.
+ *
+ * @param CANmodule CAN module object.
+ * @param rcvMsg Frame with timestamp.
+ */
+void CO_CANrxInject(CO_CANmodule_t* CANmodule, CO_CANrxMsg_t* rcvMsg);
+
+#if CO_DRIVER_MULTI_THREAD
+/**
+ * Pass frames from the receive ring to CANrx_callback() functions.
+ *
+ * Function is called from the mainline thread, for example before CO_process(). It is also called from
+ * CO_CANmodule_process(). It must not be called concurrently from different threads.
+ *
+ * @param CANmodule CAN module object.
+ *
+ * @return Number of processed frames.
+ */
+int32_t CO_CANrxRingProcess(CO_CANmodule_t* CANmodule);
+
+/**
+ * Start receive thread.
+ *
+ * Thread waits for the CAN socket with poll(), reads all received frames into the receive ring with CO_CANinterrupt()
+ * and then calls notify, which wakes the mainline, for example CO_epoll_signal(). Thread inherits scheduling policy and
+ * priority of the calling thread. Running thread is stopped first. Thread is stopped by CO_CANmodule_disable() and by
+ * CO_CANmodule_init(), before the socket is closed.
+ *
+ * @param CANmodule CAN module object, initialized by CO_CANmodule_init().
+ * @param notify Function, called from the receive thread after new frames were pushed into the ring. May be NULL.
+ * @param object Object for notify.
+ *
+ * @return true, if thread was started, false if socket is not opened or thread could not be created.
+ */
+bool_t CO_CANrxThreadStart(CO_CANmodule_t* CANmodule, void (*notify)(void* object), void* object);
+
+/**
+ * Stop receive thread and wait for it.
+ *
+ * @param CANmodule CAN module object.
+ */
+void CO_CANrxThreadStop(CO_CANmodule_t* CANmodule);
+#endif
+
+/** @} */ /* CO_socketCAN_driver_target */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CO_DRIVER_TARGET_H */
@@ -0,0 +1,896 @@
+/*
+ * Helper functions for Linux epoll interface to CANopenNode.
+ *
+ * @file        CO_epoll_interface.c
+ * @ingroup     CO_epoll_interface
+ * @author      Janez Paternoster
+ * @copyright   2021 Janez Paternoster
+ *
+ * This file is part of <https://github.com/CANopenNode/CANopenNode>, a CANopen Stack.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "CO_epoll_interface.h"
+
+/* Get current time in microseconds, CLOCK_MONOTONIC */
+static inline uint64_t
+CO_epoll_time_us(void) {
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+CO_ReturnError_t
+CO_epoll_create(CO_epoll_t* ep, uint32_t timerInterval_us) {
+    struct epoll_event ev = {0};
+
+    if (ep == NULL || timerInterval_us == 0U) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    memset(ep, 0, sizeof(*ep));
+    ep->epoll_fd = -1;
+    ep->event_fd = -1;
+    ep->timer_fd = -1;
+
+    ep->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (ep->epoll_fd < 0) {
+        CO_epoll_close(ep);
+        return CO_ERROR_SYSCALL;
+    }
+
+    /* Notification from other threads */
+    ep->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ev.events = EPOLLIN;
+    ev.data.fd = ep->event_fd;
+    if (ep->event_fd < 0 || epoll_ctl(ep->epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev) < 0) {
+        CO_epoll_close(ep);
+        return CO_ERROR_SYSCALL;
+    }
+
+    /* One-shot timer, it is re-armed from timerNext_us in CO_epoll_processLast() */
+    ep->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    ev.events = EPOLLIN;
+    ev.data.fd = ep->timer_fd;
+    if (ep->timer_fd < 0 || epoll_ctl(ep->epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev) < 0) {
+        CO_epoll_close(ep);
+        return CO_ERROR_SYSCALL;
+    }
+
+    ep->timerInterval_us = timerInterval_us;
+    ep->timerNext_us = timerInterval_us;
+    ep->tm.it_value.tv_sec = timerInterval_us / 1000000U;
+    ep->tm.it_value.tv_nsec = (long)(timerInterval_us % 1000000U) * 1000L;
+    if (timerfd_settime(ep->timer_fd, 0, &ep->tm, NULL) < 0) {
+        CO_epoll_close(ep);
+        return CO_ERROR_SYSCALL;
+    }
+
+    ep->previousTime_us = CO_epoll_time_us();
+    return CO_ERROR_NO;
+}
+
+void
+CO_epoll_close(CO_epoll_t* ep) {
+    if (ep == NULL) {
+        return;
+    }
+
+    if (ep->epoll_fd >= 0) {
+        (void)close(ep->epoll_fd);
+        ep->epoll_fd = -1;
+    }
+    if (ep->event_fd >= 0) {
+        (void)close(ep->event_fd);
+        ep->event_fd = -1;
+    }
+    if (ep->timer_fd >= 0) {
+        (void)close(ep->timer_fd);
+        ep->timer_fd = -1;
+    }
+}
+
+void
+CO_epoll_signal(CO_epoll_t* ep) {
+    uint64_t u = 1;
+
+    if (ep != NULL && ep->event_fd >= 0) {
+        /* write() is async-signal-safe, result is ignored, counter is already nonzero in that case */
+        ssize_t s = write(ep->event_fd, &u, sizeof(u));
+        (void)s;
+    }
+}
+
+void
+CO_epoll_wait(CO_epoll_t* ep) {
+    uint64_t now_us;
+    int ready;
+
+    if (ep == NULL) {
+        return;
+    }
+
+    ready = epoll_wait(ep->epoll_fd, &ep->ev, 1, -1);
+
+    now_us = CO_epoll_time_us();
+    ep->timeDifference_us = (uint32_t)(now_us - ep->previousTime_us);
+    ep->previousTime_us = now_us;
+    /* processing functions will lower this value, if necessary */
+    ep->timerNext_us = ep->timerInterval_us;
+    ep->timerEvent = false;
+    ep->epoll_new = false;
+
+    if (ready != 1) {
+        /* EINTR, signal handler may want to end the program */
+        return;
+    }
+
+    if (ep->ev.data.fd == ep->event_fd) {
+        uint64_t val;
+        ssize_t s = read(ep->event_fd, &val, sizeof(val));
+        (void)s;
+    } else if (ep->ev.data.fd == ep->timer_fd) {
+        uint64_t val;
+        ssize_t s = read(ep->timer_fd, &val, sizeof(val));
+        (void)s;
+        ep->timerEvent = true;
+    } else {
+        ep->epoll_new = true;
+    }
+}
+
+#if CO_DRIVER_MULTI_THREAD
+/* Called from the receive thread after frames were pushed into the ring */
+static void
+CO_epoll_rxNotify(void* object) {
+    CO_epoll_signal((CO_epoll_t*)object);
+}
+#endif
+
+CO_ReturnError_t
+CO_epoll_initCANopenMain(CO_epoll_t* ep, CO_t* co) {
+    struct epoll_event ev = {0};
+
+    if (ep == NULL || co == NULL || co->CANmodule->fd < 0) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+#if CO_DRIVER_MULTI_THREAD
+    /* Socket is read by the receive thread, which wakes this epoll with CO_epoll_signal(). Thread of the old socket
+     * was stopped, when it was closed. */
+    (void)ev;
+    return CO_CANrxThreadStart(co->CANmodule, CO_epoll_rxNotify, ep) ? CO_ERROR_NO : CO_ERROR_SYSCALL;
+#else
+    /* Socket was newly created by CO_CANinit(), old one was removed from epoll when it was closed. */
+    ev.events = EPOLLIN;
+    ev.data.fd = co->CANmodule->fd;
+    if (epoll_ctl(ep->epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev) < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+
+    return CO_ERROR_NO;
+#endif
+}
+
+void
+CO_epoll_initCallbackSync(CO_epoll_t* ep, void* object, void (*pFunctSync)(void* object, CO_t* co)) {
+    if (ep != NULL) {
+        ep->functSyncObject = object;
+        ep->pFunctSync = pFunctSync;
+    }
+}
+
+void
+CO_epoll_initSnapshot(CO_epoll_t* ep, CO_ODsnapshot_t* snapshot) {
+    if (ep != NULL) {
+        ep->snapshot = snapshot;
+    }
+}
+
+void
+CO_epoll_processRT(CO_epoll_t* ep, CO_t* co, bool_t realtime) {
+    if (ep == NULL || co == NULL) {
+        return;
+    }
+
+#if CO_DRIVER_MULTI_THREAD
+    /* Process frames, pushed into the ring by the receive thread */
+    (void)CO_CANrxRingProcess(co->CANmodule);
+#else
+    /* Read all received CAN frames */
+    if (ep->epoll_new && ep->ev.data.fd == co->CANmodule->fd) {
+        ep->epoll_new = false;
+        (void)CO_CANinterrupt(co->CANmodule);
+    }
+#endif
+
+    bool_t syncPending = false;
+#if (CO_CONFIG_SYNC) & CO_CONFIG_SYNC_ENABLE
+    /* SYNC from the receive thread or from CO_syncProducer is processed without waiting for the timer */
+    syncPending = co->SYNC != NULL && CO_FLAG_READ(co->SYNC->CANrxNew);
+#endif
+
+    if (!realtime || ep->timerEvent || syncPending) {
+        uint32_t* pTimerNext_us = realtime ? NULL : &ep->timerNext_us;
+
+        CO_CANtxDeferBegin();
+        CO_LOCK_OD(co->CANmodule);
+        if (!co->nodeIdUnconfigured && co->CANmodule->CANnormal) {
+            bool_t syncWas = false;
+
+#if (CO_CONFIG_SYNC) & CO_CONFIG_SYNC_ENABLE
+            syncWas = CO_process_SYNC(co, ep->timeDifference_us, pTimerNext_us);
+#endif
+#if (CO_CONFIG_PDO) & CO_CONFIG_RPDO_ENABLE
+            CO_process_RPDO(co, syncWas, ep->timeDifference_us, pTimerNext_us);
+#endif
+            if (syncWas && ep->pFunctSync != NULL) {
+                ep->pFunctSync(ep->functSyncObject, co);
+            }
+            /* consistent copy for mainline readers, TPDOs of attached entries read it too */
+            CO_ODsnapshot_publish(ep->snapshot);
+#if (CO_CONFIG_PDO) & CO_CONFIG_TPDO_ENABLE
+            CO_process_TPDO(co, syncWas, ep->timeDifference_us, pTimerNext_us);
+#endif
+#if (CO_CONFIG_SRDO) & CO_CONFIG_SRDO_ENABLE
+            ep->SRDOstate = CO_process_SRDO(co, ep->timeDifference_us, pTimerNext_us);
+#endif
+            (void)syncWas;
+            (void)pTimerNext_us;
+        }
+        CO_UNLOCK_OD(co->CANmodule);
+        CO_CANtxDeferEnd();
+
+        /* All synchronous TPDOs leave together */
+        CO_CANtxFlushSync(co->CANmodule);
+    }
+}
+
+void
+CO_epoll_processMain(CO_epoll_t* ep, CO_t* co, bool_t enableGateway, CO_NMT_reset_cmd_t* reset) {
+    if (ep == NULL || co == NULL || reset == NULL) {
+        return;
+    }
+
+    CO_CANtxDeferBegin();
+    *reset = CO_process(co, enableGateway, ep->timeDifference_us, &ep->timerNext_us);
+    CO_CANtxDeferEnd();
+
+    /* Messages produced by CO_process() leave together */
+    CO_CANtxFlush(co->CANmodule);
+}
+
+void
+CO_epoll_processLast(CO_epoll_t* ep) {
+    if (ep == NULL) {
+        return;
+    }
+
+    /* Re-arm the timer. Zero value would disarm it, so use the shortest interval. */
+    if (ep->timerNext_us == 0U) {
+        ep->timerNext_us = 1U;
+    }
+    ep->tm.it_value.tv_sec = ep->timerNext_us / 1000000U;
+    ep->tm.it_value.tv_nsec = (long)(ep->timerNext_us % 1000000U) * 1000L;
+    (void)timerfd_settime(ep->timer_fd, 0, &ep->tm, NULL);
+}
+
+#if (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII
+
+/* Write gateway response to standard output. */
+static size_t
+gtwa_write_response(void* object, const char* buf, size_t count, uint8_t* connectionOK) {
+    CO_epoll_gtw_t* epGtw = (CO_epoll_gtw_t*)object;
+    size_t written = 0;
+
+    if ((epGtw->commandInterface == CO_COMMAND_IF_STDIO) || (epGtw->commandInterface == CO_COMMAND_IF_STDIO_BIN)) {
+        while (written < count) {
+            ssize_t n = write(STDOUT_FILENO, buf + written, count - written);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                *connectionOK = 0;
+                break;
+            }
+            written += (size_t)n;
+        }
+    } else {
+        /* no output interface, purge data */
+        written = count;
+    }
+
+    return written;
+}
+
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+/* Socket command interface: multiple clients, each sends binary gateway frames. Tag of the request in the gateway is
+ * the index of the pending entry, which keeps the tag of the client. */
+
+static inline uint16_t
+gtw_getU16(const uint8_t* buf) {
+    return (uint16_t)buf[0] | (uint16_t)((uint16_t)buf[1] << 8);
+}
+
+static inline bool_t
+gtw_isSocket(int32_t commandInterface) {
+    return (commandInterface == CO_COMMAND_IF_LOCAL_SOCKET)
+           || ((commandInterface >= CO_COMMAND_IF_TCP_SOCKET_MIN)
+               && (commandInterface <= CO_COMMAND_IF_TCP_SOCKET_MAX));
+}
+
+/* Register events of the client: input, if there is space for it, and output, if responses are waiting */
+static void
+gtw_clientEvents(CO_epoll_gtw_t* epGtw, CO_epoll_gtwClient_t* cl) {
+    uint32_t events = 0;
+
+    if (cl->rxCount < sizeof(cl->rxBuf)) {
+        events |= EPOLLIN;
+    }
+    if (cl->txCount > 0U) {
+        events |= EPOLLOUT;
+    }
+    if (events != cl->events) {
+        struct epoll_event ev = {0};
+        ev.events = events;
+        ev.data.fd = cl->fd;
+        (void)epoll_ctl(epGtw->epoll_fd, EPOLL_CTL_MOD, cl->fd, &ev);
+        cl->events = events;
+    }
+}
+
+static void
+gtw_clientClose(CO_epoll_gtw_t* epGtw, uint8_t index) {
+    CO_epoll_gtwClient_t* cl = &epGtw->clients[index];
+
+    (void)epoll_ctl(epGtw->epoll_fd, EPOLL_CTL_DEL, cl->fd, NULL);
+    (void)close(cl->fd);
+    cl->fd = -1;
+    epGtw->clientCount--;
+
+    /* responses to its requests, which are still in the gateway, will be discarded */
+    for (uint8_t i = 0; i < CO_CONFIG_GTWB_SLOTS; i++) {
+        if (epGtw->pending[i].used && (epGtw->pending[i].client == (int8_t)index)) {
+            epGtw->pending[i].client = -1;
+        }
+    }
+}
+
+/* Write responses to the socket without blocking. Returns false, if client was closed. */
+static bool_t
+gtw_clientFlush(CO_epoll_gtw_t* epGtw, uint8_t index) {
+    CO_epoll_gtwClient_t* cl = &epGtw->clients[index];
+    size_t sent = 0;
+
+    while (sent < cl->txCount) {
+        ssize_t n = send(cl->fd, &cl->txBuf[sent], cl->txCount - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += (size_t)n;
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            /* socket is full, EPOLLOUT will continue */
+            break;
+        } else {
+            gtw_clientClose(epGtw, index);
+            return false;
+        }
+    }
+    if (sent > 0U) {
+        cl->txCount -= sent;
+        (void)memmove(&cl->txBuf[0], &cl->txBuf[sent], cl->txCount);
+    }
+    gtw_clientEvents(epGtw, cl);
+    return true;
+}
+
+/* Respond to the frame, which was not passed to the gateway. Space for responses to requests in the gateway is kept,
+ * so the error response is dropped, if client does not read its responses. */
+static void
+gtw_clientReject(CO_epoll_gtwClient_t* cl, uint8_t command, uint16_t tag) {
+    uint8_t frame[CO_GTWB_HEADER_SIZE] = {4U,
+                                          0U,
+                                          (uint8_t)(command | (uint8_t)CO_GTWB_CMD_RESPONSE),
+                                          (uint8_t)CO_GTWB_ST_MALFORMED,
+                                          (uint8_t)tag,
+                                          (uint8_t)(tag >> 8)};
+
+    if ((sizeof(cl->txBuf) - cl->txCount) >= (((size_t)cl->inFlight * CO_GTWB_RESP_MAX) + sizeof(frame))) {
+        (void)memcpy(&cl->txBuf[cl->txCount], frame, sizeof(frame));
+        cl->txCount += sizeof(frame);
+    }
+}
+
+/* Remove frames from the start of the receive buffer, which can not be passed to the gateway: frames without tag and
+ * too long frames. */
+static void
+gtw_clientParse(CO_epoll_gtwClient_t* cl) {
+    for (;;) {
+        size_t remove;
+
+        if (cl->rxSkip > 0U) {
+            remove = (cl->rxCount < cl->rxSkip) ? cl->rxCount : cl->rxSkip;
+            cl->rxSkip -= (uint16_t)remove;
+        } else {
+            uint32_t frameSize;
+
+            if (cl->rxCount < 2U) {
+                return;
+            }
+            frameSize = (uint32_t)gtw_getU16(&cl->rxBuf[0]) + 2U;
+            if (frameSize < CO_GTWB_HEADER_SIZE) {
+                if (cl->rxCount < frameSize) {
+                    return;
+                }
+                gtw_clientReject(cl, 0, 0);
+                remove = frameSize;
+            } else if (frameSize > CO_GTWB_FRAME_MAX) {
+                if (cl->rxCount < CO_GTWB_HEADER_SIZE) {
+                    return;
+                }
+                gtw_clientReject(cl, cl->rxBuf[2], gtw_getU16(&cl->rxBuf[4]));
+                cl->rxSkip = (uint16_t)(frameSize - cl->rxCount);
+                remove = cl->rxCount;
+            } else {
+                /* valid frame, complete or not */
+                return;
+            }
+        }
+        if (remove == 0U) {
+            return;
+        }
+        cl->rxCount -= (uint16_t)remove;
+        (void)memmove(&cl->rxBuf[0], &cl->rxBuf[remove], cl->rxCount);
+    }
+}
+
+/* Pass the first frame of the client to the gateway, if it is complete and within client's share. */
+static bool_t
+gtw_clientSubmit(CO_epoll_gtw_t* epGtw, uint8_t index, uint8_t share) {
+    CO_epoll_gtwClient_t* cl = &epGtw->clients[index];
+    uint16_t frameSize;
+    uint8_t p = 0;
+
+    if ((cl->fd < 0) || (cl->inFlight >= share) || (cl->rxCount < 2U)) {
+        return false;
+    }
+    frameSize = gtw_getU16(&cl->rxBuf[0]) + 2U;
+    if ((cl->rxCount < frameSize)
+        || ((sizeof(cl->txBuf) - cl->txCount) < (((size_t)cl->inFlight + 1U) * CO_GTWB_RESP_MAX))
+        || (CO_GTWB_write_getSpace(epGtw->gtwb) < frameSize)) {
+        return false;
+    }
+
+    while (epGtw->pending[p].used) {
+        p++;
+    }
+    epGtw->pending[p].used = true;
+    epGtw->pending[p].client = (int8_t)index;
+    epGtw->pending[p].command = cl->rxBuf[2];
+    epGtw->pending[p].tag = gtw_getU16(&cl->rxBuf[4]);
+    epGtw->pendingCount++;
+    cl->inFlight++;
+
+    cl->rxBuf[4] = p;
+    cl->rxBuf[5] = 0;
+    (void)CO_GTWB_write(epGtw->gtwb, (const char*)cl->rxBuf, frameSize);
+
+    cl->rxCount -= frameSize;
+    (void)memmove(&cl->rxBuf[0], &cl->rxBuf[frameSize], cl->rxCount);
+    gtw_clientParse(cl);
+    gtw_clientEvents(epGtw, cl);
+    return true;
+}
+
+/* Pass frames of the clients to the gateway in round-robin order, while there are free slots */
+static void
+gtw_feed(CO_epoll_gtw_t* epGtw) {
+    uint8_t share;
+    uint8_t idle = 0;
+
+    if ((epGtw->gtwb == NULL) || (epGtw->clientCount == 0U)) {
+        return;
+    }
+    share = (uint8_t)(CO_CONFIG_GTWB_SLOTS / epGtw->clientCount);
+    if (share == 0U) {
+        share = 1;
+    }
+
+    while ((epGtw->pendingCount < CO_CONFIG_GTWB_SLOTS) && (idle < CO_EPOLL_GTW_CLIENTS)) {
+        uint8_t index = epGtw->clientNext;
+        epGtw->clientNext = (uint8_t)((index + 1U) % CO_EPOLL_GTW_CLIENTS);
+        if (gtw_clientSubmit(epGtw, index, share)) {
+            idle = 0;
+        } else {
+            idle++;
+        }
+    }
+}
+
+/* Complete response from the gateway is in respBuf, pass it to the client */
+static void
+gtw_route(CO_epoll_gtw_t* epGtw) {
+    uint16_t tag = gtw_getU16(&epGtw->respBuf[4]);
+    CO_epoll_gtwPending_t* p;
+
+    if ((tag >= CO_CONFIG_GTWB_SLOTS) || !epGtw->pending[tag].used) {
+        return;
+    }
+    p = &epGtw->pending[tag];
+    p->used = false;
+    epGtw->pendingCount--;
+
+    if (p->client >= 0) {
+        uint8_t index = (uint8_t)p->client;
+        CO_epoll_gtwClient_t* cl = &epGtw->clients[index];
+
+        cl->inFlight--;
+        epGtw->respBuf[4] = (uint8_t)p->tag;
+        epGtw->respBuf[5] = (uint8_t)(p->tag >> 8);
+        /* space is reserved in gtw_clientSubmit() */
+        (void)memcpy(&cl->txBuf[cl->txCount], epGtw->respBuf, epGtw->respCount);
+        cl->txCount += epGtw->respCount;
+        (void)gtw_clientFlush(epGtw, index);
+    }
+
+    /* slot is free, next request may enter the gateway */
+    gtw_feed(epGtw);
+}
+
+/* Read callback of the binary gateway, assembles response frames and routes them to the clients. */
+static size_t
+gtw_socket_response(void* object, const char* buf, size_t count, uint8_t* connectionOK) {
+    CO_epoll_gtw_t* epGtw = (CO_epoll_gtw_t*)object;
+    size_t n = 0;
+
+    (void)connectionOK;
+    while (n < count) {
+        size_t frameSize = (epGtw->respCount < 2U) ? 2U : ((size_t)gtw_getU16(&epGtw->respBuf[0]) + 2U);
+        size_t copy;
+
+        if (frameSize > sizeof(epGtw->respBuf)) {
+            /* not possible with responses from CO_GTWB */
+            epGtw->respCount = 0;
+            return count;
+        }
+        copy = frameSize - epGtw->respCount;
+        if (copy > (count - n)) {
+            copy = count - n;
+        }
+        (void)memcpy(&epGtw->respBuf[epGtw->respCount], &buf[n], copy);
+        epGtw->respCount += (uint16_t)copy;
+        n += copy;
+
+        if ((epGtw->respCount >= CO_GTWB_HEADER_SIZE) && (epGtw->respCount == frameSize)) {
+            gtw_route(epGtw);
+            epGtw->respCount = 0;
+        }
+    }
+
+    return count;
+}
+
+static void
+gtw_accept(CO_epoll_gtw_t* epGtw) {
+    for (;;) {
+        int fd = accept4(epGtw->gtwa_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        CO_epoll_gtwClient_t* cl = NULL;
+        struct epoll_event ev = {0};
+
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        for (uint8_t i = 0; i < CO_EPOLL_GTW_CLIENTS; i++) {
+            if (epGtw->clients[i].fd < 0) {
+                cl = &epGtw->clients[i];
+                break;
+            }
+        }
+        if (epGtw->commandInterface != CO_COMMAND_IF_LOCAL_SOCKET) {
+            int flag = 1;
+            (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+        }
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if ((cl == NULL) || (epoll_ctl(epGtw->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)) {
+            /* too many clients */
+            (void)close(fd);
+            continue;
+        }
+        cl->fd = fd;
+        cl->events = EPOLLIN;
+        cl->inFlight = 0;
+        cl->rxSkip = 0;
+        cl->rxCount = 0;
+        cl->txCount = 0;
+        epGtw->clientCount++;
+    }
+}
+
+static void
+gtw_clientRead(CO_epoll_gtw_t* epGtw, uint8_t index) {
+    CO_epoll_gtwClient_t* cl = &epGtw->clients[index];
+    size_t space = sizeof(cl->rxBuf) - cl->rxCount;
+    ssize_t n;
+
+    if (space == 0U) {
+        return;
+    }
+    n = recv(cl->fd, &cl->rxBuf[cl->rxCount], space, MSG_DONTWAIT);
+    if (n > 0) {
+        cl->rxCount += (uint16_t)n;
+        gtw_clientParse(cl);
+        (void)gtw_clientFlush(epGtw, index);
+    } else if ((n == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))) {
+        /* connection closed by the client */
+        gtw_clientClose(epGtw, index);
+    } else { /* MISRA C 2004 14.10 */
+    }
+}
+
+static CO_ReturnError_t
+gtw_listen(CO_epoll_gtw_t* epGtw, int32_t commandInterface, const char* localSocketPath) {
+    struct epoll_event ev = {0};
+    int fd;
+
+    if (commandInterface == CO_COMMAND_IF_LOCAL_SOCKET) {
+        struct sockaddr_un addr = {0};
+        size_t len = (localSocketPath != NULL) ? strlen(localSocketPath) : 0U;
+
+        if ((len == 0U) || (len >= sizeof(addr.sun_path)) || (len >= sizeof(epGtw->localSocketPath))) {
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return CO_ERROR_SYSCALL;
+        }
+        addr.sun_family = AF_UNIX;
+        (void)memcpy(addr.sun_path, localSocketPath, len + 1U);
+        /* socket file may remain from previous run */
+        (void)unlink(localSocketPath);
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            (void)close(fd);
+            return CO_ERROR_SYSCALL;
+        }
+        (void)memcpy(epGtw->localSocketPath, localSocketPath, len + 1U);
+    } else {
+        struct sockaddr_in addr = {0};
+        int flag = 1;
+
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return CO_ERROR_SYSCALL;
+        }
+        (void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons((uint16_t)commandInterface);
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            (void)close(fd);
+            return CO_ERROR_SYSCALL;
+        }
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if ((listen(fd, CO_EPOLL_GTW_CLIENTS) < 0) || (epoll_ctl(epGtw->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)) {
+        (void)close(fd);
+        if (epGtw->localSocketPath[0] != '\0') {
+            (void)unlink(epGtw->localSocketPath);
+            epGtw->localSocketPath[0] = '\0';
+        }
+        return CO_ERROR_SYSCALL;
+    }
+    epGtw->gtwa_fd = fd;
+
+    return CO_ERROR_NO;
+}
+#endif /* (CO_CONFIG_GTW) & CO_CONFIG_GTW_BINARY */
+
+CO_ReturnError_t
+CO_epoll_createGtw(CO_epoll_gtw_t* epGtw, int epoll_fd, int32_t commandInterface, const char* localSocketPath) {
+    struct epoll_event ev = {0};
+
+    if (epGtw == NULL || epoll_fd < 0) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    epGtw->epoll_fd = epoll_fd;
+    epGtw->commandInterface = commandInterface;
+    epGtw->gtwa_fd = -1;
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+    epGtw->localSocketPath[0] = '\0';
+    epGtw->gtwb = NULL;
+    epGtw->clientCount = 0;
+    epGtw->clientNext = 0;
+    epGtw->pendingCount = 0;
+    epGtw->respCount = 0;
+    for (uint8_t i = 0; i < CO_EPOLL_GTW_CLIENTS; i++) {
+        epGtw->clients[i].fd = -1;
+    }
+    (void)memset(epGtw->pending, 0, sizeof(epGtw->pending));
+
+    if (gtw_isSocket(commandInterface)) {
+        return gtw_listen(epGtw, commandInterface, localSocketPath);
+    }
+#else
+    (void)localSocketPath;
+#endif
+
+    if ((commandInterface == CO_COMMAND_IF_STDIO) || (commandInterface == CO_COMMAND_IF_STDIO_BIN)) {
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) == 0
+        if (commandInterface == CO_COMMAND_IF_STDIO_BIN) {
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+#endif
+        epGtw->gtwa_fd = STDIN_FILENO;
+        ev.events = EPOLLIN;
+        ev.data.fd = epGtw->gtwa_fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev) < 0) {
+            epGtw->gtwa_fd = -1;
+            return CO_ERROR_SYSCALL;
+        }
+    } else if (commandInterface != CO_COMMAND_IF_DISABLED) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    return CO_ERROR_NO;
+}
+
+void
+CO_epoll_closeGtw(CO_epoll_gtw_t* epGtw) {
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+    if (epGtw != NULL && gtw_isSocket(epGtw->commandInterface)) {
+        for (uint8_t i = 0; i < CO_EPOLL_GTW_CLIENTS; i++) {
+            if (epGtw->clients[i].fd >= 0) {
+                gtw_clientClose(epGtw, i);
+            }
+        }
+        if (epGtw->gtwa_fd >= 0) {
+            (void)epoll_ctl(epGtw->epoll_fd, EPOLL_CTL_DEL, epGtw->gtwa_fd, NULL);
+            (void)close(epGtw->gtwa_fd);
+            epGtw->gtwa_fd = -1;
+        }
+        if (epGtw->localSocketPath[0] != '\0') {
+            (void)unlink(epGtw->localSocketPath);
+            epGtw->localSocketPath[0] = '\0';
+        }
+        return;
+    }
+#endif
+    if (epGtw != NULL && epGtw->gtwa_fd >= 0) {
+        /* standard input is not closed */
+        (void)epoll_ctl(epGtw->epoll_fd, EPOLL_CTL_DEL, epGtw->gtwa_fd, NULL);
+        epGtw->gtwa_fd = -1;
+    }
+}
+
+void
+CO_epoll_initCANopenGtw(CO_epoll_gtw_t* epGtw, CO_t* co) {
+    if (epGtw == NULL || co == NULL) {
+        return;
+    }
+
+    CO_GTWA_initRead(co->gtwa, gtwa_write_response, (void*)epGtw);
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+    if (epGtw->commandInterface == CO_COMMAND_IF_STDIO_BIN) {
+        CO_GTWB_initRead(co->gtwb, gtwa_write_response, (void*)epGtw);
+    } else if (gtw_isSocket(epGtw->commandInterface)) {
+        /* gateway was reinitialized, requests in it are lost */
+        for (uint8_t i = 0; i < CO_CONFIG_GTWB_SLOTS; i++) {
+            CO_epoll_gtwPending_t* p = &epGtw->pending[i];
+            if (p->used && (p->client >= 0)) {
+                CO_epoll_gtwClient_t* cl = &epGtw->clients[p->client];
+                cl->inFlight--;
+                gtw_clientReject(cl, p->command, p->tag);
+                (void)gtw_clientFlush(epGtw, (uint8_t)p->client);
+            }
+            p->used = false;
+        }
+        epGtw->pendingCount = 0;
+        epGtw->respCount = 0;
+        epGtw->gtwb = co->gtwb;
+        CO_GTWB_initRead(co->gtwb, gtw_socket_response, (void*)epGtw);
+    } else { /* MISRA C 2004 14.10 */
+    }
+#endif
+}
+
+void
+CO_epoll_processGtw(CO_epoll_gtw_t* epGtw, CO_t* co, CO_epoll_t* ep) {
+    if (epGtw == NULL || co == NULL || ep == NULL) {
+        return;
+    }
+
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+    if (gtw_isSocket(epGtw->commandInterface)) {
+        if (ep->epoll_new && epGtw->gtwa_fd >= 0) {
+            if (ep->ev.data.fd == epGtw->gtwa_fd) {
+                ep->epoll_new = false;
+                gtw_accept(epGtw);
+            } else {
+                for (uint8_t i = 0; i < CO_EPOLL_GTW_CLIENTS; i++) {
+                    CO_epoll_gtwClient_t* cl = &epGtw->clients[i];
+                    if ((cl->fd < 0) || (ep->ev.data.fd != cl->fd)) {
+                        continue;
+                    }
+                    ep->epoll_new = false;
+                    if ((ep->ev.events & EPOLLOUT) != 0U) {
+                        if (!gtw_clientFlush(epGtw, i)) {
+                            break;
+                        }
+                    }
+                    if ((ep->ev.events & EPOLLIN) != 0U) {
+                        gtw_clientRead(epGtw, i);
+                    } else if ((ep->ev.events & (EPOLLHUP | EPOLLERR)) != 0U) {
+                        gtw_clientClose(epGtw, i);
+                    } else { /* MISRA C 2004 14.10 */
+                    }
+                    break;
+                }
+            }
+        }
+        gtw_feed(epGtw);
+        return;
+    }
+#endif
+
+    if (ep->epoll_new && epGtw->gtwa_fd >= 0 && ep->ev.data.fd == epGtw->gtwa_fd) {
+        char buf[CO_CONFIG_GTWA_COMM_BUF_SIZE];
+        size_t space;
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+        bool_t binary = epGtw->commandInterface == CO_COMMAND_IF_STDIO_BIN;
+        space = binary ? CO_GTWB_write_getSpace(co->gtwb) : CO_GTWA_write_getSpace(co->gtwa);
+#else
+        space = CO_GTWA_write_getSpace(co->gtwa);
+#endif
+
+        if (space > sizeof(buf)) {
+            space = sizeof(buf);
+        }
+
+        ep->epoll_new = false;
+        if (space > 0U) {
+            ssize_t n = read(epGtw->gtwa_fd, buf, space);
+            if (n > 0) {
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) != 0
+                if (binary) {
+                    (void)CO_GTWB_write(co->gtwb, buf, (size_t)n);
+                } else {
+                    (void)CO_GTWA_write(co->gtwa, buf, (size_t)n);
+                }
+#else
+                (void)CO_GTWA_write(co->gtwa, buf, (size_t)n);
+#endif
+            } else if (n == 0) {
+                /* end of input, stop waiting for it */
+                CO_epoll_closeGtw(epGtw);
+            }
+        }
+        /* If there is no space, data stay in the input and epoll_wait() will report them again. */
+    }
+}
+
+#endif /* (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII */
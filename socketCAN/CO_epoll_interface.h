@@ -0,0 +1,301 @@
+/*
+ * Helper functions for Linux epoll interface to CANopenNode.
+ *
+ * @file        CO_epoll_interface.h
+ * @ingroup     CO_epoll_interface
+ * @author      Janez Paternoster
+ * @copyright   2021 Janez Paternoster
+ *
+ * This file is part of <https://github.com/CANopenNode/CANopenNode>, a CANopen Stack.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_EPOLL_INTERFACE_H
+#define CO_EPOLL_INTERFACE_H
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#include "CANopen.h"
+#include "extra/CO_ODsnapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_epoll_interface Epoll interface
+ * Linux epoll interface to CANopenNode.
+ *
+ * @ingroup CO_socketCAN
+ * @{
+ *
+ * Application waits in single epoll_wait() for CAN socket, timerfd and gateway file descriptor. Timerfd is armed from
+ * timerNext_us, calculated by CO_process() and CO_process_*() functions, so the stack wakes only when CAN frame is
+ * received, gateway command arrives or some internal timer actually expires. Typical mainline:
+ *
+ * @code{.c}
+ * CO_epoll_create(&ep, MAIN_THREAD_INTERVAL_US);
+ * // communication reset, CO_CANinit(), CO_CANopenInit(), ...
+ * CO_epoll_initCANopenMain(&ep, CO);
+ * while (reset == CO_RESET_NOT) {
+ *     CO_epoll_wait(&ep);
+ *     CO_epoll_processRT(&ep, CO, false);
+ *     CO_epoll_processGtw(&epGtw, CO, &ep);
+ *     CO_epoll_processMain(&ep, CO, true, &reset);
+ *     CO_epoll_processLast(&ep);
+ * }
+ * @endcode
+ */
+
+/** Object for epoll, timerfd and eventfd */
+typedef struct {
+    int epoll_fd;               /**< Epoll file descriptor */
+    int event_fd;               /**< Notification event file descriptor, see CO_epoll_signal() */
+    int timer_fd;               /**< Interval timer file descriptor */
+    uint32_t timerInterval_us;  /**< Maximum interval between two wakeups, from CO_epoll_create() */
+    uint32_t timeDifference_us; /**< Time difference since previous CO_epoll_wait() */
+    uint32_t timerNext_us;      /**< Time to the next timer event, lowered by processing functions */
+    bool_t timerEvent;          /**< True if timer expired since previous CO_epoll_wait() */
+    uint64_t previousTime_us;   /**< Time of previous CO_epoll_wait(), CLOCK_MONOTONIC */
+    struct itimerspec tm;       /**< Structure for timerfd */
+    struct epoll_event ev;      /**< Event from the last epoll_wait() */
+    bool_t epoll_new;           /**< True, if ev is not yet processed by any processing function */
+    void (*pFunctSync)(void* object, CO_t* co); /**< From CO_epoll_initCallbackSync() or NULL */
+    void* functSyncObject;                      /**< From CO_epoll_initCallbackSync() */
+    CO_ODsnapshot_t* snapshot;                  /**< From CO_epoll_initSnapshot() or NULL */
+#if (((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_ENABLE) != 0) || defined CO_DOXYGEN
+    CO_SRDO_state_t SRDOstate; /**< Lowest state of the SRDO objects from the last CO_process_SRDO() */
+#endif
+} CO_epoll_t;
+
+/**
+ * Create Linux epoll, timerfd and eventfd
+ *
+ * @param ep This object
+ * @param timerInterval_us Maximum interval of function CO_epoll_wait() in microseconds. Processing functions may set
+ * shorter interval with timerNext_us.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_SYSCALL.
+ */
+CO_ReturnError_t CO_epoll_create(CO_epoll_t* ep, uint32_t timerInterval_us);
+
+/**
+ * Close epoll, timerfd and eventfd
+ *
+ * @param ep This object
+ */
+void CO_epoll_close(CO_epoll_t* ep);
+
+/**
+ * Wake up CO_epoll_wait() from other thread or signal handler.
+ *
+ * @param ep This object
+ */
+void CO_epoll_signal(CO_epoll_t* ep);
+
+/**
+ * Wait for an event
+ *
+ * Function blocks until CAN frame, timer or other event. It then calculates timeDifference_us and resets timerNext_us
+ * to timerInterval_us. Event is stored in ep->ev and must be processed by one of the processing functions.
+ *
+ * @param ep This object
+ */
+void CO_epoll_wait(CO_epoll_t* ep);
+
+/**
+ * Register CAN socket in epoll after communication reset.
+ *
+ * Function must be called after CO_CANinit(), because it creates new socket. With @ref CO_DRIVER_MULTI_THREAD socket
+ * is not registered, function starts the receive thread instead, see CO_CANrxThreadStart(), which wakes this epoll
+ * object after received frames are pushed into the ring.
+ *
+ * @param ep This object
+ * @param co CANopen object
+ *
+ * @return CO_ERROR_NO or CO_ERROR_SYSCALL.
+ */
+CO_ReturnError_t CO_epoll_initCANopenMain(CO_epoll_t* ep, CO_t* co);
+
+/**
+ * Initialize SYNC callback
+ *
+ * Function is called from CO_epoll_processRT() after each SYNC message was received or transmitted. It is called
+ * inside CO_LOCK_OD(), after RPDOs and before TPDOs are processed, so OD variables, written by the callback, are sent
+ * with synchronous TPDOs of the same SYNC cycle. Callback must be short and nonblocking.
+ *
+ * @param ep This object
+ * @param object Pointer to object, which will be passed to pFunctSync(). Can be NULL.
+ * @param pFunctSync Pointer to the callback function. Can be NULL to disable callback.
+ */
+void CO_epoll_initCallbackSync(CO_epoll_t* ep, void* object, void (*pFunctSync)(void* object, CO_t* co));
+
+/**
+ * Initialize OD snapshot, published by CO_epoll_processRT()
+ *
+ * Snapshot is published on each processing of real-time objects, after RPDOs and SYNC callback and before TPDOs.
+ * Mainline threads then read PDO mapped variables from the snapshot, see @ref CO_ODsnapshot.
+ *
+ * @param ep This object
+ * @param snapshot Initialized snapshot with regions or NULL to disable publishing.
+ */
+void CO_epoll_initSnapshot(CO_epoll_t* ep, CO_ODsnapshot_t* snapshot);
+
+/**
+ * Process CAN reception and real-time CANopen objects
+ *
+ * Function reads received CAN frames, if epoll event is from CAN socket. Then it processes SYNC, RPDO, TPDO and SRDO
+ * under CO_LOCK_OD() and passes synchronous TPDOs to the kernel together. SRDO state is stored in ep->SRDOstate. If
+ * realtime is true, objects are processed only on timer event or pending SYNC, otherwise they are processed on each
+ * call.
+ *
+ * @param ep This object
+ * @param co CANopen object
+ * @param realtime True, if function is called from separate real-time thread with its own epoll object.
+ */
+void CO_epoll_processRT(CO_epoll_t* ep, CO_t* co, bool_t realtime);
+
+/**
+ * Process CANopen mainline
+ *
+ * Function calls CO_process() and passes produced CAN frames to the kernel together, see CO_CANtxDeferBegin().
+ *
+ * @param ep This object
+ * @param co CANopen object
+ * @param enableGateway If true, gateway to external world will be enabled.
+ * @param [out] reset Return from CO_process().
+ */
+void CO_epoll_processMain(CO_epoll_t* ep, CO_t* co, bool_t enableGateway, CO_NMT_reset_cmd_t* reset);
+
+/**
+ * Finish processing of epoll event
+ *
+ * Function arms the timerfd for the next wakeup from timerNext_us.
+ *
+ * @param ep This object
+ */
+void CO_epoll_processLast(CO_epoll_t* ep);
+
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII) || defined CO_DOXYGEN
+/** Command interface type for gateway-ascii */
+typedef enum {
+    CO_COMMAND_IF_DISABLED = -100,        /**< Gateway is disabled */
+    CO_COMMAND_IF_STDIO = -2,             /**< Commands from standard input, responses to standard output */
+    CO_COMMAND_IF_STDIO_BIN = -3,         /**< Binary gateway frames on standard input and output */
+    CO_COMMAND_IF_LOCAL_SOCKET = -1,      /**< Binary gateway frames from multiple clients on local (Unix) socket */
+    CO_COMMAND_IF_TCP_SOCKET_MIN = 0,     /**< Binary gateway frames from multiple clients on TCP port, minimum */
+    CO_COMMAND_IF_TCP_SOCKET_MAX = 0xFFFF /**< Binary gateway frames from multiple clients on TCP port, maximum */
+} CO_commandInterface_t;
+
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) || defined CO_DOXYGEN
+/** Maximum number of simultaneously connected socket clients */
+#ifndef CO_EPOLL_GTW_CLIENTS
+#define CO_EPOLL_GTW_CLIENTS 8
+#endif
+
+/** Size of the transmit buffer of the socket client, holds responses to all its requests in the gateway and errors */
+#define CO_EPOLL_GTW_CLIENT_TX_SIZE ((CO_CONFIG_GTWB_SLOTS + 1U) * CO_GTWB_RESP_MAX)
+
+/** Socket client of the binary gateway */
+typedef struct {
+    int fd;                                     /**< Connected socket or -1 */
+    uint32_t events;                            /**< Events currently registered in epoll */
+    uint8_t inFlight;                           /**< Requests of this client in the gateway */
+    uint16_t rxSkip;                            /**< Bytes of too long frame, still to be discarded */
+    uint16_t rxCount;                           /**< Bytes in rxBuf */
+    uint8_t rxBuf[CO_GTWB_FRAME_MAX];           /**< Received, not yet submitted frames */
+    size_t txCount;                             /**< Bytes in txBuf */
+    uint8_t txBuf[CO_EPOLL_GTW_CLIENT_TX_SIZE]; /**< Responses, not yet written to the socket */
+} CO_epoll_gtwClient_t;
+
+/** Request of the socket client in the binary gateway, tag in the gateway is the index of this entry */
+typedef struct {
+    bool_t used;     /**< True, if request is in the gateway */
+    int8_t client;   /**< Index of the client or -1, if client disconnected */
+    uint8_t command; /**< Command of the request */
+    uint16_t tag;    /**< Tag from the client, restored in the response */
+} CO_epoll_gtwPending_t;
+#endif
+
+/** Object for gateway */
+typedef struct {
+    int epoll_fd;             /**< Epoll file descriptor, from CO_epoll_createGtw() */
+    int32_t commandInterface; /**< Command interface type, see CO_commandInterface_t */
+    int gtwa_fd;              /**< Gateway command input or listening socket file descriptor, -1 if disabled */
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_BINARY) || defined CO_DOXYGEN
+    char localSocketPath[108];                           /**< Path of the local socket, removed on close */
+    CO_GTWB_t* gtwb;                                     /**< From CO_epoll_initCANopenGtw() */
+    uint8_t clientCount;                                 /**< Number of connected clients */
+    uint8_t clientNext;                                  /**< Client, which submits the next request */
+    uint8_t pendingCount;                                /**< Number of used pending entries */
+    CO_epoll_gtwClient_t clients[CO_EPOLL_GTW_CLIENTS];  /**< Socket clients */
+    CO_epoll_gtwPending_t pending[CO_CONFIG_GTWB_SLOTS]; /**< Requests in the gateway */
+    uint16_t respCount;                                  /**< Bytes in respBuf */
+    uint8_t respBuf[CO_GTWB_RESP_MAX];                   /**< Response from the gateway, being assembled */
+#endif
+} CO_epoll_gtw_t;
+
+/**
+ * Create gateway
+ *
+ * With socket command interface the binary gateway accepts up to @ref CO_EPOLL_GTW_CLIENTS connections. Each client
+ * sends binary gateway frames (see @ref CO_CANopen_309_bin_Syntax) and uses the tag as its own sequence number,
+ * responses carry the same tag. Requests of all clients are fed into the single gateway in round-robin order and run
+ * concurrently on its SDO channels, so requests to different nodes do not wait for each other. Each client may have
+ * at most its share of @ref CO_CONFIG_GTWB_SLOTS requests in the gateway, and requests of a client, which does not
+ * read its responses, are not taken. So fast polling client does not delay the other clients.
+ *
+ * @param epGtw This object
+ * @param epoll_fd Already configured epoll file descriptor
+ * @param commandInterface Command interface type from CO_commandInterface_t
+ * @param localSocketPath Path of the local socket for CO_COMMAND_IF_LOCAL_SOCKET, may be NULL otherwise.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_SYSCALL.
+ */
+CO_ReturnError_t CO_epoll_createGtw(CO_epoll_gtw_t* epGtw, int epoll_fd, int32_t commandInterface,
+                                    const char* localSocketPath);
+
+/**
+ * Close gateway
+ *
+ * @param epGtw This object
+ */
+void CO_epoll_closeGtw(CO_epoll_gtw_t* epGtw);
+
+/**
+ * Initialize gateway after communication reset
+ *
+ * @param epGtw This object
+ * @param co CANopen object
+ */
+void CO_epoll_initCANopenGtw(CO_epoll_gtw_t* epGtw, CO_t* co);
+
+/**
+ * Process gateway
+ *
+ * Function reads command, if epoll event is from the gateway file descriptor. With socket command interface it also
+ * accepts connections and writes pending responses. Gateway object itself is processed inside CO_process().
+ *
+ * @param epGtw This object
+ * @param co CANopen object
+ * @param ep Epoll object
+ */
+void CO_epoll_processGtw(CO_epoll_gtw_t* epGtw, CO_t* co, CO_epoll_t* ep);
+#endif /* (CO_CONFIG_GTW) & CO_CONFIG_GTW_ASCII */
+
+/** @} */ /* CO_epoll_interface */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CO_EPOLL_INTERFACE_H */
@@ -0,0 +1,648 @@
+/*
+ * Multiple CANopen networks in one Linux process.
+ *
+ * @file        CO_network.c
+ * @ingroup     CO_network
+ * @author      Janez Paternoster
+ * @copyright   2021 Janez Paternoster
+ *
+ * This file is part of <https://github.com/CANopenNode/CANopenNode>, a CANopen Stack.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* pthread_attr_setaffinity_np() */
+#endif
+
+/* OD_obj_xxx_t definitions are used by CO_network_cloneOD() */
+#define OD_DEFINITION
+
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <net/if.h>
+
+#include "CO_network.h"
+
+/* default values for CO_CANopenInit() */
+#define NMT_CONTROL                                                                                                    \
+    CO_NMT_STARTUP_TO_OPERATIONAL                                                                                      \
+    | CO_NMT_ERR_ON_ERR_REG | CO_ERR_REG_GENERIC_ERR | CO_ERR_REG_COMMUNICATION
+#define FIRST_HB_TIME        500
+#define SDO_SRV_TIMEOUT_TIME 1000
+#define SDO_CLI_TIMEOUT_TIME 500
+#define SDO_CLI_BLOCK        false
+
+/* Number of ready networks, processed by shared thread after one epoll_wait() */
+#define CO_NETWORK_SCHED_EVENTS 16
+
+static uint64_t
+CO_network_time_us(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+}
+
+#ifdef CO_MULTIPLE_OD
+/* Number of consecutive OD objects, starting at index. */
+static uint16_t
+CO_network_countOD(OD_t* od, uint16_t index, uint16_t max) {
+    uint16_t count = 0;
+    while (count < max && OD_find(od, index + count) != NULL) {
+        count++;
+    }
+    return count;
+}
+
+/* Number of array elements in OD object or 0, if object does not exist. */
+static uint8_t
+CO_network_countArray(const OD_entry_t* entry) {
+    return (entry != NULL && entry->subEntriesCount > 0U) ? (uint8_t)(entry->subEntriesCount - 1U) : 0U;
+}
+
+/* Configuration for CO_new() from the Object Dictionary, same as the defaults, which CANopen.c takes from OD.h. */
+static void
+CO_network_initConfig(CO_config_t* config, OD_t* od) {
+    memset(config, 0, sizeof(*config));
+
+    config->CNT_NMT = 1;
+    config->ENTRY_H1017 = OD_find(od, OD_H1017_PRODUCER_HB_TIME);
+    config->ENTRY_H1016 = OD_find(od, OD_H1016_CONSUMER_HB_TIME);
+    config->CNT_ARR_1016 = CO_network_countArray(config->ENTRY_H1016);
+    config->CNT_HB_CONS = config->CNT_ARR_1016 > 0U ? 1U : 0U;
+    config->ENTRY_H100C = OD_find(od, OD_H100C_GUARD_TIME);
+    config->ENTRY_H100D = OD_find(od, OD_H100D_LIFETIME_FACTOR);
+    config->CNT_EM = 1;
+    config->ENTRY_H1001 = OD_find(od, OD_H1001_ERR_REG);
+    config->ENTRY_H1014 = OD_find(od, OD_H1014_COBID_EMERGENCY);
+    config->ENTRY_H1015 = OD_find(od, OD_H1015_INHIBIT_TIME_EMCY);
+    config->ENTRY_H1003 = OD_find(od, OD_H1003_PREDEF_ERR_FIELD);
+    config->CNT_ARR_1003 = (config->ENTRY_H1003 != NULL) ? CO_network_countArray(config->ENTRY_H1003) : 8U;
+    config->ENTRY_H1200 = OD_find(od, OD_H1200_SDO_SERVER_1_PARAM);
+    config->CNT_SDO_SRV = (uint8_t)CO_network_countOD(od, OD_H1200_SDO_SERVER_1_PARAM, 128);
+    if (config->CNT_SDO_SRV == 0U) {
+        config->CNT_SDO_SRV = 1; /* default SDO server without OD object */
+    }
+    config->ENTRY_H1280 = OD_find(od, OD_H1280_SDO_CLIENT_1_PARAM);
+    config->CNT_SDO_CLI = (uint8_t)CO_network_countOD(od, OD_H1280_SDO_CLIENT_1_PARAM, 128);
+    config->ENTRY_H1012 = OD_find(od, OD_H1012_COBID_TIME);
+    config->CNT_TIME = config->ENTRY_H1012 != NULL ? 1U : 0U;
+    config->ENTRY_H1005 = OD_find(od, OD_H1005_COBID_SYNC);
+    config->ENTRY_H1006 = OD_find(od, OD_H1006_COMM_CYCL_PERIOD);
+    config->ENTRY_H1007 = OD_find(od, OD_H1007_SYNC_WINDOW_LEN);
+    config->ENTRY_H1019 = OD_find(od, OD_H1019_SYNC_CNT_OVERFLOW);
+    config->CNT_SYNC = config->ENTRY_H1005 != NULL ? 1U : 0U;
+    config->ENTRY_H1400 = OD_find(od, OD_H1400_RXPDO_1_PARAM);
+    config->ENTRY_H1600 = OD_find(od, OD_H1600_RXPDO_1_MAPPING);
+    config->CNT_RPDO = CO_network_countOD(od, OD_H1400_RXPDO_1_PARAM, 512);
+    config->ENTRY_H1800 = OD_find(od, OD_H1800_TXPDO_1_PARAM);
+    config->ENTRY_H1A00 = OD_find(od, OD_H1A00_TXPDO_1_MAPPING);
+    config->CNT_TPDO = CO_network_countOD(od, OD_H1800_TXPDO_1_PARAM, 512);
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_ENABLE) != 0
+    config->ENTRY_H1301 = OD_find(od, OD_H1301_SRDO_1_PARAM);
+    config->ENTRY_H1381 = OD_find(od, OD_H1381_SRDO_1_MAPPING);
+    config->ENTRY_H13FE = OD_find(od, OD_H13FE_SRDO_VALID);
+    config->ENTRY_H13FF = OD_find(od, OD_H13FF_SRDO_CHECKSUM);
+    config->CNT_SRDO = (uint8_t)CO_network_countOD(od, OD_H1301_SRDO_1_PARAM, 64);
+#endif
+    config->CNT_LEDS = 1;
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_SLAVE) != 0
+    config->CNT_LSS_SLV = 1;
+#endif
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_MASTER) != 0
+    config->CNT_LSS_MST = 1;
+#endif
+#if ((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII) != 0
+    /* gateway with SDO commands needs SDO client, CO_GTWA_init() fails without it */
+    config->CNT_GTWA = (((CO_CONFIG_GTW)&CO_CONFIG_GTW_ASCII_SDO) == 0 || config->CNT_SDO_CLI > 0U) ? 1U : 0U;
+#endif
+}
+#endif /* CO_MULTIPLE_OD */
+
+/* Set error status and stop the network thread. */
+static void
+CO_network_error(CO_network_t* network, CO_ReturnError_t err, uint32_t errInfo) {
+    (void)pthread_mutex_lock(&network->statusMutex);
+    network->status.state = CO_NETWORK_ERROR;
+    network->status.lastError = err;
+    network->status.errInfo = errInfo;
+    (void)pthread_mutex_unlock(&network->statusMutex);
+}
+
+/* CANopen communication reset, return CO_ERROR_NO on success. */
+static CO_ReturnError_t
+CO_network_resetCommunication(CO_network_t* network, uint32_t* errInfo) {
+    CO_t* co = network->co;
+    OD_t* od = network->config.od;
+    CO_ReturnError_t err;
+
+    /* Enter CAN configuration. */
+    co->CANmodule->CANnormal = false;
+    CO_CANsetConfigurationMode((void*)&network->CANptr);
+    CO_CANmodule_disable(co->CANmodule);
+
+    err = CO_CANinit(co, (void*)&network->CANptr, network->pendingBitRate);
+    if (err != CO_ERROR_NO) {
+        return err;
+    }
+
+#if ((CO_CONFIG_LSS)&CO_CONFIG_LSS_SLAVE) != 0
+    /* LSS address is read from this network's Object Dictionary, object 0x1018 */
+    CO_LSS_address_t lssAddress = {0};
+    OD_entry_t* entry1018 = OD_find(od, OD_H1018_IDENTITY_OBJECT);
+    (void)OD_get_u32(entry1018, 1, &lssAddress.identity.vendorID, true);
+    (void)OD_get_u32(entry1018, 2, &lssAddress.identity.productCode, true);
+    (void)OD_get_u32(entry1018, 3, &lssAddress.identity.revisionNumber, true);
+    (void)OD_get_u32(entry1018, 4, &lssAddress.identity.serialNumber, true);
+    err = CO_LSSinit(co, &lssAddress, &network->pendingNodeId, &network->pendingBitRate);
+    if (err != CO_ERROR_NO) {
+        return err;
+    }
+#endif
+
+    err = CO_CANopenInit(co, NULL, NULL, od, NULL, NMT_CONTROL, FIRST_HB_TIME, SDO_SRV_TIMEOUT_TIME,
+                         SDO_CLI_TIMEOUT_TIME, SDO_CLI_BLOCK, network->pendingNodeId, errInfo);
+    if (err != CO_ERROR_NO && err != CO_ERROR_NODE_ID_UNCONFIGURED_LSS) {
+        return err;
+    }
+
+    err = CO_CANopenInitPDO(co, co->em, od, network->pendingNodeId, errInfo);
+    if (err != CO_ERROR_NO && err != CO_ERROR_NODE_ID_UNCONFIGURED_LSS) {
+        return err;
+    }
+
+    err = CO_epoll_initCANopenMain(&network->ep, co);
+    if (err != CO_ERROR_NO) {
+        return err;
+    }
+
+    if (network->config.appInit != NULL) {
+        network->config.appInit(network);
+    }
+
+#if ((CO_CONFIG_SRDO)&CO_CONFIG_SRDO_ENABLE) != 0
+    /* after application initialization, see CO_CANopenInitSRDO() */
+    err = CO_CANopenInitSRDO(co, co->em, od, network->pendingNodeId, errInfo);
+    if (err != CO_ERROR_NO && err != CO_ERROR_NODE_ID_UNCONFIGURED_LSS) {
+        return err;
+    }
+#endif
+
+    CO_CANsetNormalMode(co->CANmodule);
+
+    (void)pthread_mutex_lock(&network->statusMutex);
+    network->status.resetCount++;
+    (void)pthread_mutex_unlock(&network->statusMutex);
+
+    return CO_ERROR_NO;
+}
+
+/* Processing pass after CO_epoll_wait(). */
+static void
+CO_network_process(CO_network_t* network, CO_NMT_reset_cmd_t* reset) {
+    uint64_t start_us = CO_network_time_us();
+
+    CO_epoll_processRT(&network->ep, network->co, false);
+    CO_epoll_processMain(&network->ep, network->co, false, reset);
+    if (network->config.appProcess != NULL) {
+        network->config.appProcess(network);
+    }
+    CO_epoll_processLast(&network->ep);
+
+    uint32_t loop_us = (uint32_t)(CO_network_time_us() - start_us);
+    (void)pthread_mutex_lock(&network->statusMutex);
+    network->status.loopCount++;
+    if (loop_us > network->status.loopMax_us) {
+        network->status.loopMax_us = loop_us;
+    }
+    (void)pthread_mutex_unlock(&network->statusMutex);
+}
+
+static void
+CO_network_stopped(CO_network_t* network) {
+    (void)pthread_mutex_lock(&network->statusMutex);
+    network->status.state = CO_NETWORK_STOPPED;
+    (void)pthread_mutex_unlock(&network->statusMutex);
+}
+
+/* Network thread, runs until CO_network_stop() or NMT reset application command. */
+static void*
+CO_network_thread(void* arg) {
+    CO_network_t* network = arg;
+    CO_NMT_reset_cmd_t reset = CO_RESET_NOT;
+
+    while (reset != CO_RESET_APP && reset != CO_RESET_QUIT && !network->stop) {
+        uint32_t errInfo = 0;
+        CO_ReturnError_t err = CO_network_resetCommunication(network, &errInfo);
+        if (err != CO_ERROR_NO) {
+            CO_network_error(network, err, errInfo);
+            return NULL;
+        }
+
+        reset = CO_RESET_NOT;
+        while (reset == CO_RESET_NOT && !network->stop) {
+            CO_epoll_wait(&network->ep);
+            CO_network_process(network, &reset);
+        }
+    }
+
+    CO_network_stopped(network);
+
+    return NULL;
+}
+
+/* Communication reset of the network in the shared thread, return false, if network is finished. */
+static bool_t
+CO_network_sharedReset(CO_network_t* network) {
+    uint32_t errInfo = 0;
+    CO_ReturnError_t err = CO_network_resetCommunication(network, &errInfo);
+
+    network->schedReset = CO_RESET_NOT;
+    if (err != CO_ERROR_NO) {
+        CO_network_error(network, err, errInfo);
+        return false;
+    }
+    return true;
+}
+
+/* Shared thread, processes ready networks of the list, which starts with its own network. */
+static void*
+CO_network_sharedThread(void* arg) {
+    CO_network_t* owner = arg;
+    CO_network_t* network;
+    struct epoll_event events[CO_NETWORK_SCHED_EVENTS];
+    uint32_t active = 0;
+
+    for (network = owner; network != NULL; network = network->schedNext) {
+        struct epoll_event ev = {.events = EPOLLIN, .data.ptr = network};
+
+        network->schedDone = !CO_network_sharedReset(network)
+                             || epoll_ctl(owner->schedFd, EPOLL_CTL_ADD, network->ep.epoll_fd, &ev) < 0;
+        if (!network->schedDone) {
+            active++;
+        } else if (network->status.state == CO_NETWORK_RUNNING) {
+            CO_network_error(network, CO_ERROR_SYSCALL, 0);
+        } else { /* MISRA C 2004 14.10 */
+        }
+    }
+
+    while (active > 0U) {
+        int ready = epoll_wait(owner->schedFd, events, CO_NETWORK_SCHED_EVENTS, -1);
+
+        for (int i = 0; i < ready; i++) {
+            network = events[i].data.ptr;
+            if (network->schedDone) {
+                continue;
+            }
+
+            /* epoll of the network is readable, so this does not block */
+            CO_epoll_wait(&network->ep);
+            CO_network_process(network, &network->schedReset);
+
+            if (network->schedReset == CO_RESET_NOT && !network->stop) {
+                continue;
+            }
+            if (network->schedReset == CO_RESET_COMM && !network->stop && CO_network_sharedReset(network)) {
+                continue;
+            }
+            /* stop, reset application, quit or failed communication reset */
+            (void)epoll_ctl(owner->schedFd, EPOLL_CTL_DEL, network->ep.epoll_fd, NULL);
+            if (network->status.state == CO_NETWORK_RUNNING) {
+                CO_network_stopped(network);
+            }
+            network->schedDone = true;
+            active--;
+        }
+    }
+
+    return NULL;
+}
+
+/* Create network thread with CPU affinity and scheduling from configuration. */
+static CO_ReturnError_t
+CO_network_createThread(CO_network_t* network, void* (*threadFunct)(void* arg)) {
+    pthread_attr_t attr;
+    CO_ReturnError_t err = CO_ERROR_NO;
+
+    if (pthread_attr_init(&attr) != 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    if (network->config.cpu >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET((unsigned int)network->config.cpu, &cpuset);
+        if (pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset) != 0) {
+            err = CO_ERROR_SYSCALL;
+        }
+    }
+    if (network->config.priority > 0) {
+        struct sched_param param = {.sched_priority = network->config.priority};
+        if (pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED) != 0
+            || pthread_attr_setschedpolicy(&attr, SCHED_FIFO) != 0 || pthread_attr_setschedparam(&attr, &param) != 0) {
+            err = CO_ERROR_SYSCALL;
+        }
+    }
+
+    network->status.state = CO_NETWORK_RUNNING;
+    if (err == CO_ERROR_NO && pthread_create(&network->thread, &attr, threadFunct, network) != 0) {
+        /* EPERM, if SCHED_FIFO is not permitted, EINVAL, if CPU does not exist */
+        network->status.state = CO_NETWORK_STOPPED;
+        err = CO_ERROR_SYSCALL;
+    }
+    network->threadStarted = err == CO_ERROR_NO;
+
+    (void)pthread_attr_destroy(&attr);
+    return err;
+}
+
+/* Start networks, each in its own thread, if threadCount is 0, or in threadCount shared threads. */
+static CO_ReturnError_t
+CO_network_startThreads(CO_network_t* networks, const CO_networkConfig_t* configs, uint8_t count,
+                        uint8_t threadCount) {
+    CO_ReturnError_t err = CO_ERROR_NO;
+    uint8_t i;
+
+    if (networks == NULL || configs == NULL || count == 0U) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+#ifndef CO_MULTIPLE_OD
+    if (count > 1U) {
+        /* CANopen.c would use communication objects from the global OD for all networks */
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+#endif
+
+    memset(networks, 0, sizeof(CO_network_t) * count);
+    for (i = 0; i < count; i++) {
+        (void)pthread_mutex_init(&networks[i].statusMutex, NULL);
+        networks[i].ep.epoll_fd = -1;
+        networks[i].schedFd = -1;
+    }
+
+    for (i = 0; i < count && err == CO_ERROR_NO; i++) {
+        CO_network_t* network = &networks[i];
+        const CO_networkConfig_t* config = &configs[i];
+        uint32_t heapMemoryUsed;
+        uint8_t j;
+
+        network->config = *config;
+        network->pendingNodeId = config->nodeId;
+        network->pendingBitRate = 125; /* bitrate is configured by the system */
+
+        if (config->ifName == NULL || config->od == NULL || config->interval_us == 0U
+            || (config->nodeId != CO_LSS_NODE_ID_ASSIGNMENT && (config->nodeId < 1U || config->nodeId > 127U))) {
+            err = CO_ERROR_ILLEGAL_ARGUMENT;
+            break;
+        }
+        for (j = 0; j < i; j++) {
+            if (configs[j].od == config->od
+                || (strcmp(configs[j].ifName, config->ifName) == 0 && configs[j].nodeId == config->nodeId)) {
+                /* Object Dictionary can not be shared, CAN interface only by nodes with different node-id */
+                err = CO_ERROR_ILLEGAL_ARGUMENT;
+            }
+        }
+        network->CANptr.can_ifindex = (int)if_nametoindex(config->ifName);
+        network->CANptr.stats = config->stats;
+        network->CANptr.log = config->log;
+        if (err != CO_ERROR_NO || network->CANptr.can_ifindex == 0) {
+            err = CO_ERROR_ILLEGAL_ARGUMENT;
+            break;
+        }
+
+#ifdef CO_MULTIPLE_OD
+        CO_network_initConfig(&network->coConfig, config->od);
+        network->co = CO_new(&network->coConfig, &heapMemoryUsed);
+#else
+        network->co = CO_new(NULL, &heapMemoryUsed);
+#endif
+        if (network->co == NULL) {
+            err = CO_ERROR_OUT_OF_MEMORY;
+            break;
+        }
+        err = CO_epoll_create(&network->ep, config->interval_us);
+        if (err != CO_ERROR_NO) {
+            break;
+        }
+        if (threadCount == 0U) {
+            err = CO_network_createThread(network, CO_network_thread);
+        }
+    }
+
+    /* network i is in the list of the shared thread in network i % threadCount, after network i - threadCount */
+    for (i = threadCount; i < count && err == CO_ERROR_NO; i++) {
+        networks[i - threadCount].schedNext = &networks[i];
+    }
+    for (i = 0; i < threadCount && err == CO_ERROR_NO; i++) {
+        CO_network_t* network;
+
+        networks[i].schedFd = epoll_create(1);
+        if (networks[i].schedFd < 0) {
+            err = CO_ERROR_SYSCALL;
+            break;
+        }
+        for (network = networks[i].schedNext; network != NULL; network = network->schedNext) {
+            network->status.state = CO_NETWORK_RUNNING;
+        }
+        err = CO_network_createThread(&networks[i], CO_network_sharedThread);
+        for (network = networks[i].schedNext; network != NULL && err != CO_ERROR_NO; network = network->schedNext) {
+            network->status.state = CO_NETWORK_STOPPED;
+        }
+    }
+
+    if (err != CO_ERROR_NO) {
+        CO_network_stop(networks, count);
+    }
+    return err;
+}
+
+CO_ReturnError_t
+CO_network_start(CO_network_t* networks, const CO_networkConfig_t* configs, uint8_t count) {
+    return CO_network_startThreads(networks, configs, count, 0);
+}
+
+CO_ReturnError_t
+CO_network_startShared(CO_network_t* networks, const CO_networkConfig_t* configs, uint8_t count,
+                       uint8_t threadCount) {
+    if (threadCount == 0U) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    return CO_network_startThreads(networks, configs, count, (threadCount < count) ? threadCount : count);
+}
+
+void
+CO_network_stop(CO_network_t* networks, uint8_t count) {
+    uint8_t i;
+
+    if (networks == NULL) {
+        return;
+    }
+
+    /* signal all threads first, so they finish in parallel */
+    for (i = 0; i < count; i++) {
+        networks[i].stop = true;
+        if (networks[i].threadStarted) {
+            CO_epoll_signal(&networks[i].ep);
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        CO_network_t* network = &networks[i];
+
+        if (network->threadStarted) {
+            (void)pthread_join(network->thread, NULL);
+            network->threadStarted = false;
+        }
+        if (network->schedFd >= 0) {
+            (void)close(network->schedFd);
+            network->schedFd = -1;
+        }
+        if (network->ep.epoll_fd >= 0) {
+            CO_epoll_close(&network->ep);
+            network->ep.epoll_fd = -1;
+        }
+        if (network->co != NULL) {
+            CO_CANsetConfigurationMode((void*)&network->CANptr);
+            CO_delete(network->co);
+            network->co = NULL;
+        }
+    }
+}
+
+void
+CO_network_getStatus(CO_network_t* network, CO_networkStatus_t* status) {
+    if (network == NULL || status == NULL) {
+        return;
+    }
+
+    (void)pthread_mutex_lock(&network->statusMutex);
+    if (network->status.state == CO_NETWORK_RUNNING && network->co != NULL) {
+        /* informative, read without CANopen locks */
+        network->status.NMTstate = CO_NMT_getInternalState(network->co->NMT);
+        network->status.CANerrorStatus = network->co->CANmodule->CANerrorStatus;
+    }
+    *status = network->status;
+    (void)pthread_mutex_unlock(&network->statusMutex);
+}
+
+/* Sizes of the copied parts of the Object Dictionary, aligned to 8 bytes. */
+#define CO_NETWORK_ALIGN(size) (((size) + 7U) & ~(size_t)7U)
+
+static size_t
+CO_network_odObjectSize(const OD_entry_t* entry) {
+    switch (entry->odObjectType & (uint8_t)ODT_TYPE_MASK) {
+        case ODT_VAR: return sizeof(OD_obj_var_t);
+        case ODT_ARR: return sizeof(OD_obj_array_t);
+        case ODT_REC: return sizeof(OD_obj_record_t) * entry->subEntriesCount;
+        default: return 0;
+    }
+}
+
+/* Return pointer relocated into copy of the region or original pointer, if it points outside all regions. */
+static void*
+CO_network_relocate(void* ptr, const CO_network_ODregion_t* regions, uint8_t regionCount, uint8_t* const* copies) {
+    uint8_t i;
+
+    for (i = 0; i < regionCount; i++) {
+        uint8_t* start = (uint8_t*)regions[i].addr;
+        if ((uint8_t*)ptr >= start && (uint8_t*)ptr < (start + regions[i].len)) {
+            return copies[i] + ((uint8_t*)ptr - start);
+        }
+    }
+    return ptr;
+}
+
+OD_t*
+CO_network_cloneOD(const OD_t* od, const CO_network_ODregion_t* regions, uint8_t regionCount) {
+    uint8_t* copies[UINT8_MAX];
+    uint16_t i;
+
+    if (od == NULL || (regionCount > 0U && regions == NULL)) {
+        return NULL;
+    }
+
+    size_t size = CO_NETWORK_ALIGN(sizeof(OD_t)) + CO_NETWORK_ALIGN(sizeof(OD_entry_t) * (od->size + 1U));
+
+    for (i = 0; i < od->size; i++) {
+        size += CO_NETWORK_ALIGN(CO_network_odObjectSize(&od->list[i]));
+    }
+    for (i = 0; i < regionCount; i++) {
+        size += CO_NETWORK_ALIGN(regions[i].len);
+    }
+
+    /* Single allocation, freed by CO_network_deleteOD() */
+    uint8_t* mem = calloc(1, size);
+    if (mem == NULL) {
+        return NULL;
+    }
+    OD_t* odCopy = (OD_t*)mem;
+    mem += CO_NETWORK_ALIGN(sizeof(OD_t));
+    odCopy->size = od->size;
+    odCopy->list = (OD_entry_t*)mem;
+#if OD_HASH > 0
+    /* entries are on the same positions, hash index is shared */
+    odCopy->hash = od->hash;
+#endif
+    mem += CO_NETWORK_ALIGN(sizeof(OD_entry_t) * (od->size + 1U));
+
+    for (i = 0; i < regionCount; i++) {
+        copies[i] = mem;
+        memcpy(copies[i], regions[i].addr, regions[i].len);
+        mem += CO_NETWORK_ALIGN(regions[i].len);
+    }
+
+    for (i = 0; i < od->size; i++) {
+        const OD_entry_t* entry = &od->list[i];
+        OD_entry_t* entryCopy = &odCopy->list[i];
+        size_t objectSize = CO_network_odObjectSize(entry);
+
+        entryCopy->index = entry->index;
+        entryCopy->subEntriesCount = entry->subEntriesCount;
+        entryCopy->odObjectType = entry->odObjectType;
+        entryCopy->extension = NULL;
+        entryCopy->odObject = mem;
+        memcpy(mem, entry->odObject, objectSize);
+
+        switch (entry->odObjectType & (uint8_t)ODT_TYPE_MASK) {
+            case ODT_VAR: {
+                OD_obj_var_t* odo = (OD_obj_var_t*)mem;
+                odo->dataOrig = CO_network_relocate(odo->dataOrig, regions, regionCount, copies);
+                break;
+            }
+            case ODT_ARR: {
+                OD_obj_array_t* odo = (OD_obj_array_t*)mem;
+                odo->dataOrig0 = CO_network_relocate(odo->dataOrig0, regions, regionCount, copies);
+                odo->dataOrig = CO_network_relocate(odo->dataOrig, regions, regionCount, copies);
+                break;
+            }
+            case ODT_REC: {
+                OD_obj_record_t* odo = (OD_obj_record_t*)mem;
+                uint8_t sub;
+                for (sub = 0; sub < entry->subEntriesCount; sub++) {
+                    odo[sub].dataOrig = CO_network_relocate(odo[sub].dataOrig, regions, regionCount, copies);
+                }
+                break;
+            }
+            default: break;
+        }
+        mem += CO_NETWORK_ALIGN(objectSize);
+    }
+    /* last element of the list stays blank */
+
+    return odCopy;
+}
+
+void
+CO_network_deleteOD(OD_t* od) {
+    free(od);
+}
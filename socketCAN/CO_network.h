@@ -0,0 +1,230 @@
+/*
+ * Multiple CANopen networks in one Linux process.
+ *
+ * @file        CO_network.h
+ * @ingroup     CO_network
+ * @author      Janez Paternoster
+ * @copyright   2021 Janez Paternoster
+ *
+ * This file is part of <https://github.com/CANopenNode/CANopenNode>, a CANopen Stack.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_NETWORK_H
+#define CO_NETWORK_H
+
+#include <pthread.h>
+
+#include "CANopen.h"
+#include "CO_epoll_interface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_network Multiple networks
+ * Several independent CANopen networks in one process, each one in its own thread.
+ *
+ * @ingroup CO_socketCAN
+ * @{
+ *
+ * Each network has its own CO_t object from CO_new(), its own CAN interface, Object Dictionary and epoll object. It is
+ * processed by its own thread, which may be pinned to a CPU core and may run with SCHED_FIFO priority, so SDO traffic
+ * on one bus does not delay SYNC and PDO processing on another bus. Threads share no CANopen data, each CO_t has its
+ * own CO_LOCK_OD() mutex.
+ *
+ * Several networks may also use the same CAN interface, if their node-ids differ. Each has its own CAN socket and
+ * Linux loops the transmitted frames back to the other sockets, so a master and simulated slaves run in one process on
+ * vcan, see example/canopen_bench.c.
+ *
+ * Object Dictionary generated by CANopenEditor is a single set of global variables, so it can be used by one network
+ * only. Other networks may use their own generated Object Dictionary or a copy made by CO_network_cloneOD().
+ *
+ * CANopen.c finds communication objects through the global OD pointer, unless @ref CO_MULTIPLE_OD is defined. With
+ * more than one network, CANopen.c, CO_network.c and the application must be compiled with CO_MULTIPLE_OD. Then
+ * CO_network_start() prepares CO_config_t for each network from its own Object Dictionary. CO_network.c depends on
+ * the CO_t layout, so it is compiled with the application, like CANopen.c.
+ *
+ * @code{.c}
+ * CO_network_ODregion_t regions[] = {{&OD_RAM, sizeof(OD_RAM)}, {&OD_PERSIST_COMM, sizeof(OD_PERSIST_COMM)}};
+ * CO_networkConfig_t config[2] = {
+ *     {.ifName = "can0", .nodeId = 1, .od = OD, .cpu = 1, .priority = 80, .interval_us = 100000},
+ *     {.ifName = "can1", .nodeId = 1, .od = CO_network_cloneOD(OD, regions, 2), .cpu = 2, .priority = 80,
+ *      .interval_us = 100000}};
+ * CO_network_t networks[2];
+ *
+ * CO_network_start(networks, config, 2);
+ * // ... CO_network_getStatus(&networks[i], &status) ...
+ * CO_network_stop(networks, 2);
+ * @endcode
+ */
+
+struct CO_network;
+
+/** Configuration of one network, see CO_network_start(). Copied into CO_network_t. */
+typedef struct {
+    const char* ifName;   /**< CAN interface name, for example "can0", shared only by different node-ids */
+    uint8_t nodeId;       /**< CANopen Node-id (1..127) or 0xFF for unconfigured LSS slave */
+    OD_t* od;             /**< Object Dictionary, must not be shared with other networks */
+    int cpu;              /**< CPU core for the network thread or -1 for no affinity */
+    int priority;         /**< SCHED_FIFO priority (1..99) or 0 for default scheduling */
+    uint32_t interval_us; /**< Maximum interval between two wakeups, if no CANopen timer is running */
+    /** Optional callback, called from the network thread after each communication reset, before CAN is set to
+     * normal mode. Application may configure CANopen callbacks here. */
+    void (*appInit)(struct CO_network* network);
+    /** Optional nonblocking callback, called from the network thread after each processing pass. It may lower
+     * network->ep.timerNext_us. */
+    void (*appProcess)(struct CO_network* network);
+    void* appObject;           /**< Object for the application callbacks */
+    struct CO_CANstats* stats; /**< Optional traffic statistics of the node (CO_CANstats.h), NULL if not used */
+    struct CO_CANlog* log;     /**< Optional log, which records frames of the node (CO_CANlog.h), NULL if not used */
+} CO_networkConfig_t;
+
+/** State of the network thread */
+typedef enum {
+    CO_NETWORK_STOPPED = 0, /**< Thread is not running */
+    CO_NETWORK_RUNNING = 1, /**< Thread is running CANopen */
+    CO_NETWORK_ERROR = 2    /**< Thread stopped because of error, see CO_networkStatus_t.lastError */
+} CO_networkState_t;
+
+/** Status of one network, see CO_network_getStatus() */
+typedef struct {
+    CO_networkState_t state;         /**< State of the network thread */
+    CO_NMT_internalState_t NMTstate; /**< NMT state of this node */
+    uint16_t CANerrorStatus;         /**< CAN module error status, see @ref CO_CAN_ERR_status_t */
+    CO_ReturnError_t lastError;      /**< Last initialization error */
+    uint32_t errInfo;                /**< Additional information for lastError (OD index) */
+    uint32_t resetCount;             /**< Number of communication resets */
+    uint64_t loopCount;              /**< Number of processing passes */
+    uint32_t loopMax_us;             /**< Longest processing pass since start */
+} CO_networkStatus_t;
+
+/** Object for one network */
+typedef struct CO_network {
+    CO_networkConfig_t config;     /**< From CO_network_start() */
+    CO_CANptrSocketCan_t CANptr;   /**< CAN interface of this network */
+    CO_t* co;                      /**< CANopen object */
+    CO_epoll_t ep;                 /**< Epoll object of the network thread */
+    uint8_t pendingNodeId;         /**< Node-id, configurable by LSS slave */
+    uint16_t pendingBitRate;       /**< Bitrate, configurable by LSS slave, informative */
+    pthread_t thread;              /**< Network thread */
+    bool_t threadStarted;          /**< True, if thread was created */
+    volatile bool_t stop;          /**< Request from CO_network_stop() */
+    pthread_mutex_t statusMutex;   /**< Protects status */
+    CO_networkStatus_t status;     /**< Updated by the network thread */
+    int schedFd;                   /**< Epoll of the shared thread, in the first network of the thread, or -1 */
+    struct CO_network* schedNext;  /**< Next network of the same shared thread, see CO_network_startShared() */
+    CO_NMT_reset_cmd_t schedReset; /**< Reset command of the network in the shared thread */
+    bool_t schedDone;              /**< Network is finished in the shared thread */
+#if defined CO_MULTIPLE_OD || defined CO_DOXYGEN
+    CO_config_t coConfig; /**< Configuration for CO_new(), from config.od */
+#endif
+} CO_network_t;
+
+/** Memory region with Object Dictionary variables, which is copied by CO_network_cloneOD() */
+typedef struct {
+    void* addr; /**< Start of the region, for example &OD_RAM */
+    size_t len; /**< Size of the region, for example sizeof(OD_RAM) */
+} CO_network_ODregion_t;
+
+/**
+ * Start networks
+ *
+ * For each network function allocates CANopen object with CO_new() and starts the network thread. Thread runs
+ * communication reset and then processes CANopen until stopped or until NMT reset application command.
+ *
+ * @param networks Array of count network objects, will be initialized.
+ * @param configs Array of count configurations.
+ * @param count Number of networks.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT (wrong configuration, unknown interface or more than one network
+ * without CO_MULTIPLE_OD), CO_ERROR_OUT_OF_MEMORY or
+ * CO_ERROR_SYSCALL (thread creation, CPU affinity or SCHED_FIFO not permitted). On error, already started networks
+ * are stopped.
+ */
+CO_ReturnError_t CO_network_start(CO_network_t* networks, const CO_networkConfig_t* configs, uint8_t count);
+
+/**
+ * Start networks, processed by a few shared threads
+ *
+ * Same as CO_network_start(), but instead of one thread per network, threadCount threads process all networks, for
+ * example many simulated nodes on one vcan interface. Network i is processed by thread i % threadCount, which also
+ * uses CPU core and priority from configuration of network i < threadCount.
+ *
+ * Each network keeps its own epoll object with its own CAN socket and timer. Epoll objects of all networks of the
+ * thread are registered in one more epoll object, which becomes readable, when one of them has an event. Thread
+ * waits for it and processes only ready networks, each after its own CO_epoll_wait(), which then does not block.
+ * Idle networks cost nothing, each network is woken by its own timer, as with its own thread.
+ *
+ * Callbacks of networks of the same thread are called from that thread, so they may share data without locking.
+ * Networks are stopped with CO_network_stop().
+ *
+ * @param networks Array of count network objects, will be initialized.
+ * @param configs Array of count configurations.
+ * @param count Number of networks.
+ * @param threadCount Number of threads, 1 to count. Larger value is limited to count.
+ *
+ * @return Same as CO_network_start().
+ */
+CO_ReturnError_t CO_network_startShared(CO_network_t* networks, const CO_networkConfig_t* configs, uint8_t count,
+                                        uint8_t threadCount);
+
+/**
+ * Stop networks
+ *
+ * Function signals all network threads to finish, waits for them and deletes CANopen objects. Networks from
+ * CO_network_start() and from CO_network_startShared() are stopped the same way.
+ *
+ * @param networks Array of network objects.
+ * @param count Number of networks.
+ */
+void CO_network_stop(CO_network_t* networks, uint8_t count);
+
+/**
+ * Get status of the network
+ *
+ * Function may be called from any thread.
+ *
+ * @param network Network object.
+ * @param [out] status Copy of the current status.
+ */
+void CO_network_getStatus(CO_network_t* network, CO_networkStatus_t* status);
+
+/**
+ * Copy Object Dictionary
+ *
+ * Function copies OD table of contents, OD object descriptions and given data regions. Pointers to variables inside
+ * the regions are relocated into copied regions, other pointers (constant data) stay shared. Copy has no OD
+ * extensions, they are added by CANopen objects of the network.
+ *
+ * @param od Original Object Dictionary.
+ * @param regions Regions with OD variables, which must be private for the copy.
+ * @param regionCount Number of regions.
+ *
+ * @return Copy of the Object Dictionary, free it with CO_network_deleteOD(), or NULL if out of memory.
+ */
+OD_t* CO_network_cloneOD(const OD_t* od, const CO_network_ODregion_t* regions, uint8_t regionCount);
+
+/**
+ * Delete Object Dictionary copy, made by CO_network_cloneOD().
+ *
+ * @param od Object Dictionary copy.
+ */
+void CO_network_deleteOD(OD_t* od);
+
+/** @} */ /* CO_network */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CO_NETWORK_H */
@@ -0,0 +1,351 @@
+/*
+ * SYNC producer thread with absolute deadlines for Linux socketCAN.
+ *
+ * @file        CO_syncProducer.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* pthread_attr_setaffinity_np() */
+#endif
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#include "CO_syncProducer.h"
+
+#if ((CO_CONFIG_SYNC)&CO_CONFIG_SYNC_PRODUCER) != 0
+
+/* Sleep interval of the thread, while SYNC is not produced */
+#define CO_SYNC_PRODUCER_IDLE_NS 10000000
+
+#define CO_NS_PER_S 1000000000LL
+
+static int64_t
+CO_syncProducer_ns(const struct timespec* ts) {
+    return ((int64_t)ts->tv_sec * CO_NS_PER_S) + ts->tv_nsec;
+}
+
+static void
+CO_syncProducer_timespec(int64_t ns, struct timespec* ts) {
+    ts->tv_sec = (time_t)(ns / CO_NS_PER_S);
+    ts->tv_nsec = (long)(ns % CO_NS_PER_S);
+}
+
+/* Period in nanoseconds, if SYNC has to be produced now, otherwise 0. Called with runMutex. Values are written by the
+ * processing threads, they are read with atomic loads, so the check after wakeup does not wait for CO_LOCK_OD. */
+static int64_t
+CO_syncProducer_period(const CO_syncProducer_t* sp) {
+    const CO_t* co = sp->co;
+
+    if (!sp->running || !__atomic_load_n(&co->CANmodule->CANnormal, __ATOMIC_RELAXED) || (co->SYNC == NULL)
+        || !__atomic_load_n(&co->SYNC->isProducer, __ATOMIC_RELAXED) || !co->SYNC->isExternal
+        || (co->SYNC->OD_1006_period == NULL) || (co->NMT == NULL)) {
+        return 0;
+    }
+    CO_NMT_internalState_t NMTstate = __atomic_load_n(&co->NMT->operatingState, __ATOMIC_RELAXED);
+    if ((NMTstate != CO_NMT_PRE_OPERATIONAL) && (NMTstate != CO_NMT_OPERATIONAL)) {
+        return 0;
+    }
+    return (int64_t)__atomic_load_n(co->SYNC->OD_1006_period, __ATOMIC_RELAXED) * 1000;
+}
+
+/* Record one transmission: wakeup latency and measured period */
+static void
+CO_syncProducer_record(CO_syncProducer_t* sp, int64_t latency_ns, int64_t interval_ns, int64_t period_ns,
+                       bool_t sent) {
+    CO_syncProducerStats_t* st = &sp->stats;
+
+    (void)pthread_mutex_lock(&sp->statsMutex);
+    if (!sent) {
+        st->sendErrors++;
+    } else {
+        st->cycles++;
+    }
+    if (latency_ns > (int64_t)st->latencyMax_ns) {
+        st->latencyMax_ns = (latency_ns < (int64_t)UINT32_MAX) ? (uint32_t)latency_ns : UINT32_MAX;
+    }
+    if (interval_ns > 0) {
+        int64_t jitter = interval_ns - period_ns;
+        int32_t j32 = (jitter > INT32_MAX) ? INT32_MAX : ((jitter < INT32_MIN) ? INT32_MIN : (int32_t)jitter);
+
+        if ((st->jitterCount == 0U) || (j32 < st->jitterMin_ns)) {
+            st->jitterMin_ns = j32;
+        }
+        if ((st->jitterCount == 0U) || (j32 > st->jitterMax_ns)) {
+            st->jitterMax_ns = j32;
+        }
+        st->jitterSum_ns += j32;
+        st->jitterCount++;
+        st->jitterMean_ns = (int32_t)(st->jitterSum_ns / (int64_t)st->jitterCount);
+    }
+    (void)pthread_mutex_unlock(&sp->statsMutex);
+}
+
+static void*
+CO_syncProducer_thread(void* arg) {
+    CO_syncProducer_t* sp = (CO_syncProducer_t*)arg;
+    uint32_t generation = 0;
+    int64_t deadline_ns = 0;
+    int64_t lastSent_ns = 0;
+    uint8_t counter = 0;
+
+    while (!sp->stop) {
+        struct timespec ts;
+        int64_t period_ns;
+
+        /* prepare the SYNC counter for the next deadline, configuration is consistent under CO_LOCK_OD */
+        (void)pthread_mutex_lock(&sp->runMutex);
+        CO_LOCK_OD(sp->co->CANmodule);
+        period_ns = CO_syncProducer_period(sp);
+        if (period_ns > 0) {
+            counter = CO_SYNC_nextCounter(sp->co->SYNC);
+        }
+        CO_UNLOCK_OD(sp->co->CANmodule);
+        if (period_ns > 0) {
+            (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+            if (generation != sp->generation || deadline_ns == 0) {
+                /* schedule starts one period after resume or after production was disabled */
+                generation = sp->generation;
+                deadline_ns = CO_syncProducer_ns(&ts);
+                lastSent_ns = 0;
+            }
+            deadline_ns += period_ns;
+        } else {
+            deadline_ns = 0;
+        }
+        (void)pthread_mutex_unlock(&sp->runMutex);
+
+        if (period_ns == 0) {
+            CO_syncProducer_timespec(CO_SYNC_PRODUCER_IDLE_NS, &ts);
+            (void)clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+            continue;
+        }
+
+        CO_syncProducer_timespec(deadline_ns, &ts);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+
+        /* transmit immediately, unless paused or reconfigured while sleeping */
+        (void)pthread_mutex_lock(&sp->runMutex);
+        bool_t valid = (generation == sp->generation) && (CO_syncProducer_period(sp) == period_ns);
+        bool_t sent = false;
+        if (valid) {
+            CO_CANtx_t* txBuff = sp->co->SYNC->CANtxBuff;
+
+            /* Thread does not defer transmission, so CO_CANsend() passes the frame to the socket immediately, in
+             * priority order with pending messages. Data is written under the lock, previous SYNC may still wait in
+             * the transmit queue. */
+            CO_LOCK_CAN_SEND(sp->co->CANmodule);
+            if (txBuff->DLC > 0U) {
+                txBuff->data[0] = counter;
+            }
+            CO_UNLOCK_CAN_SEND(sp->co->CANmodule);
+            sent = CO_CANsend(sp->co->CANmodule, txBuff) == CO_ERROR_NO;
+            if (sent) {
+                CO_SYNC_signalExternal(sp->co->SYNC, counter);
+            }
+        }
+        (void)pthread_mutex_unlock(&sp->runMutex);
+        if (!valid) {
+            deadline_ns = 0;
+            continue;
+        }
+        CO_epoll_signal(sp->ep);
+
+        (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+        int64_t now_ns = CO_syncProducer_ns(&ts);
+        int64_t latency_ns = now_ns - deadline_ns;
+        CO_syncProducer_record(sp, latency_ns, (lastSent_ns != 0) ? (now_ns - lastSent_ns) : 0, period_ns, sent);
+        lastSent_ns = sent ? now_ns : 0;
+
+        /* skip deadlines, which have already passed */
+        if (latency_ns >= period_ns) {
+            int64_t missed = latency_ns / period_ns;
+            deadline_ns += missed * period_ns;
+            lastSent_ns = 0;
+            (void)pthread_mutex_lock(&sp->statsMutex);
+            sp->stats.missed += (uint32_t)missed;
+            (void)pthread_mutex_unlock(&sp->statsMutex);
+        }
+    }
+
+    return NULL;
+}
+
+CO_ReturnError_t
+CO_syncProducer_start(CO_syncProducer_t* sp, CO_t* co, CO_epoll_t* ep, int cpu, int priority) {
+    pthread_attr_t attr;
+    CO_ReturnError_t err = CO_ERROR_NO;
+
+    if (sp == NULL || co == NULL || co->SYNC == NULL) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    memset(sp, 0, sizeof(CO_syncProducer_t));
+    sp->co = co;
+    sp->ep = ep;
+    (void)pthread_mutex_init(&sp->runMutex, NULL);
+    (void)pthread_mutex_init(&sp->statsMutex, NULL);
+
+    if (pthread_attr_init(&attr) != 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    if (cpu >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET((unsigned int)cpu, &cpuset);
+        if (pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset) != 0) {
+            err = CO_ERROR_SYSCALL;
+        }
+    }
+    if (priority > 0) {
+        struct sched_param param = {.sched_priority = priority};
+        if (pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED) != 0
+            || pthread_attr_setschedpolicy(&attr, SCHED_FIFO) != 0 || pthread_attr_setschedparam(&attr, &param) != 0) {
+            err = CO_ERROR_SYSCALL;
+        }
+    }
+    if (err == CO_ERROR_NO && pthread_create(&sp->thread, &attr, CO_syncProducer_thread, sp) != 0) {
+        /* EPERM, if SCHED_FIFO is not permitted, EINVAL, if CPU does not exist */
+        err = CO_ERROR_SYSCALL;
+    }
+    sp->threadStarted = err == CO_ERROR_NO;
+
+    (void)pthread_attr_destroy(&attr);
+    return err;
+}
+
+void
+CO_syncProducer_stop(CO_syncProducer_t* sp) {
+    if (sp == NULL || !sp->threadStarted) {
+        return;
+    }
+    CO_syncProducer_pause(sp);
+    sp->stop = true;
+    (void)pthread_join(sp->thread, NULL);
+    sp->threadStarted = false;
+    (void)pthread_mutex_destroy(&sp->runMutex);
+    (void)pthread_mutex_destroy(&sp->statsMutex);
+}
+
+void
+CO_syncProducer_pause(CO_syncProducer_t* sp) {
+    if (sp == NULL || !sp->threadStarted) {
+        return;
+    }
+    (void)pthread_mutex_lock(&sp->runMutex);
+    sp->running = false;
+    (void)pthread_mutex_unlock(&sp->runMutex);
+}
+
+void
+CO_syncProducer_resume(CO_syncProducer_t* sp) {
+    if (sp == NULL || !sp->threadStarted) {
+        return;
+    }
+    (void)pthread_mutex_lock(&sp->runMutex);
+    CO_SYNC_setExternal(sp->co->SYNC, true);
+    sp->generation++;
+    sp->running = true;
+    (void)pthread_mutex_unlock(&sp->runMutex);
+}
+
+void
+CO_syncProducer_getStats(CO_syncProducer_t* sp, CO_syncProducerStats_t* stats) {
+    if (sp == NULL || stats == NULL) {
+        return;
+    }
+    (void)pthread_mutex_lock(&sp->statsMutex);
+    *stats = sp->stats;
+    (void)pthread_mutex_unlock(&sp->statsMutex);
+}
+
+void
+CO_syncProducer_resetStats(CO_syncProducer_t* sp) {
+    if (sp == NULL) {
+        return;
+    }
+    (void)pthread_mutex_lock(&sp->statsMutex);
+    memset(&sp->stats, 0, sizeof(sp->stats));
+    (void)pthread_mutex_unlock(&sp->statsMutex);
+}
+
+/*
+ * Custom function for reading OD object with statistics
+ *
+ * For more information see file CO_ODinterface.h, OD_IO_t.
+ */
+static ODR_t
+OD_read_syncStats(OD_stream_t* stream, void* buf, OD_size_t count, OD_size_t* countRead) {
+    if ((stream == NULL) || (buf == NULL) || (countRead == NULL) || (count < sizeof(uint32_t))) {
+        return ODR_DEV_INCOMPAT;
+    }
+
+    CO_syncProducerStats_t st = {0};
+    uint32_t value;
+
+    CO_syncProducer_getStats((CO_syncProducer_t*)stream->object, &st);
+    switch (stream->subIndex) {
+        case 0:
+            (void)CO_setUint8(buf, 7);
+            *countRead = sizeof(uint8_t);
+            return ODR_OK;
+        case 1: value = st.cycles; break;
+        case 2: value = st.missed; break;
+        case 3: value = st.sendErrors; break;
+        case 4: value = (uint32_t)st.jitterMin_ns; break;
+        case 5: value = (uint32_t)st.jitterMax_ns; break;
+        case 6: value = (uint32_t)st.jitterMean_ns; break;
+        case 7: value = st.latencyMax_ns; break;
+        default: return ODR_SUB_NOT_EXIST;
+    }
+    (void)CO_setUint32(buf, value);
+    *countRead = sizeof(uint32_t);
+    return ODR_OK;
+}
+
+/*
+ * Custom function for writing OD object with statistics, 0 to sub-index 1 resets statistics
+ *
+ * For more information see file CO_ODinterface.h, OD_IO_t.
+ */
+static ODR_t
+OD_write_syncStats(OD_stream_t* stream, const void* buf, OD_size_t count, OD_size_t* countWritten) {
+    if ((stream == NULL) || (buf == NULL) || (countWritten == NULL) || (count != sizeof(uint32_t))) {
+        return ODR_DEV_INCOMPAT;
+    }
+    if (stream->subIndex != 1U) {
+        return ODR_READONLY;
+    }
+    if (CO_getUint32(buf) != 0U) {
+        return ODR_INVALID_VALUE;
+    }
+
+    CO_syncProducer_resetStats((CO_syncProducer_t*)stream->object);
+    *countWritten = sizeof(uint32_t);
+    return ODR_OK;
+}
+
+CO_ReturnError_t
+CO_syncProducer_initOD(CO_syncProducer_t* sp, OD_entry_t* OD_stats) {
+    if (sp == NULL || OD_stats == NULL) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    sp->OD_stats_extension.object = sp;
+    sp->OD_stats_extension.read = OD_read_syncStats;
+    sp->OD_stats_extension.write = OD_write_syncStats;
+    return (OD_extension_init(OD_stats, &sp->OD_stats_extension) == ODR_OK) ? CO_ERROR_NO : CO_ERROR_ILLEGAL_ARGUMENT;
+}
+
+#endif /* (CO_CONFIG_SYNC) & CO_CONFIG_SYNC_PRODUCER */
@@ -0,0 +1,173 @@
+/*
+ * SYNC producer thread with absolute deadlines for Linux socketCAN.
+ *
+ * @file        CO_syncProducer.h
+ * @ingroup     CO_syncProducer
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_SYNC_PRODUCER_H
+#define CO_SYNC_PRODUCER_H
+
+#include <pthread.h>
+
+#include "CANopen.h"
+#include "CO_epoll_interface.h"
+
+#if (((CO_CONFIG_SYNC)&CO_CONFIG_SYNC_PRODUCER) != 0) || defined CO_DOXYGEN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_syncProducer SYNC producer thread
+ * SYNC messages from a dedicated thread, scheduled with absolute deadlines.
+ *
+ * @ingroup CO_socketCAN
+ * @{
+ *
+ * CO_SYNC_process() transmits SYNC, when accumulated timeDifference_us reaches the period, so scheduling delay of each
+ * processing pass is added to the SYNC period. SYNC producer thread instead sleeps with
+ * clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME) until deadline n * period from 0x1006, so delays don't accumulate.
+ * SYNC counter for the next deadline is prepared before sleeping, configuration (0x1005, 0x1006, 0x1019 and NMT state)
+ * is read under CO_LOCK_OD. On wakeup it is checked again with atomic loads and SYNC is sent with CO_CANsend(), which
+ * passes it to the socket immediately, because the thread is outside of a processing pass. So it is counted in
+ * traffic statistics and in the frame log like any other message. Transmission is then reported with
+ * CO_SYNC_signalExternal() and the epoll object is woken, so synchronous PDOs are processed immediately by
+ * CO_epoll_processRT().
+ *
+ * If the thread wakes after the next deadline, the missed cycles are skipped and counted. Jitter of the period
+ * between two transmitted SYNC messages and wakeup latency are collected in @ref CO_syncProducerStats_t, which is
+ * available with CO_syncProducer_getStats() and optionally as OD entry, see CO_syncProducer_initOD().
+ *
+ * @code{.c}
+ * CO_syncProducer_start(&sp, CO, &epMain, 1, 80);
+ * while (reset != CO_RESET_APP) {
+ *     CO_syncProducer_pause(&sp);
+ *     // communication reset, CO_CANinit(), CO_CANopenInit(), ...
+ *     CO_syncProducer_resume(&sp);
+ *     // ... processing loop ...
+ * }
+ * CO_syncProducer_stop(&sp);
+ * @endcode
+ */
+
+/** Statistics of the SYNC producer thread */
+typedef struct {
+    uint32_t cycles;        /**< Number of transmitted SYNC messages */
+    uint32_t missed;        /**< Number of deadlines skipped, because thread woke too late */
+    uint32_t sendErrors;    /**< Number of SYNC messages not accepted by CO_CANsend() */
+    int32_t jitterMin_ns;   /**< Minimum difference between measured and configured period */
+    int32_t jitterMax_ns;   /**< Maximum difference between measured and configured period */
+    int32_t jitterMean_ns;  /**< Mean difference between measured and configured period */
+    uint32_t latencyMax_ns; /**< Maximum delay between deadline and wakeup */
+    int64_t jitterSum_ns;   /**< Sum of differences, for jitterMean_ns */
+    uint32_t jitterCount;   /**< Number of measured periods */
+} CO_syncProducerStats_t;
+
+/** SYNC producer thread object */
+typedef struct {
+    CO_t* co;                          /**< From CO_syncProducer_start() */
+    CO_epoll_t* ep;                    /**< From CO_syncProducer_start(), may be NULL */
+    pthread_t thread;                  /**< SYNC producer thread */
+    bool_t threadStarted;              /**< True, if thread was created */
+    volatile bool_t stop;              /**< Request from CO_syncProducer_stop() */
+    bool_t running;                    /**< True between CO_syncProducer_resume() and CO_syncProducer_pause() */
+    uint32_t generation;               /**< Incremented by CO_syncProducer_resume(), restarts the schedule */
+    pthread_mutex_t runMutex;          /**< Held by the thread during transmission, protects running */
+    pthread_mutex_t statsMutex;        /**< Protects stats */
+    CO_syncProducerStats_t stats;      /**< Updated by the thread */
+    OD_extension_t OD_stats_extension; /**< Extension for OD object, see CO_syncProducer_initOD() */
+} CO_syncProducer_t;
+
+/**
+ * Start SYNC producer thread
+ *
+ * Thread starts paused, SYNC messages are produced after CO_syncProducer_resume().
+ *
+ * @param sp This object will be initialized.
+ * @param co CANopen object.
+ * @param ep Epoll object, which processes CO_epoll_processRT(), woken after each SYNC. May be NULL.
+ * @param cpu CPU core for the thread or -1 for no affinity.
+ * @param priority SCHED_FIFO priority (1..99) or 0 for default scheduling.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_SYSCALL (thread creation, CPU affinity or SCHED_FIFO
+ * not permitted).
+ */
+CO_ReturnError_t CO_syncProducer_start(CO_syncProducer_t* sp, CO_t* co, CO_epoll_t* ep, int cpu, int priority);
+
+/**
+ * Stop SYNC producer thread and wait for it
+ *
+ * @param sp This object.
+ */
+void CO_syncProducer_stop(CO_syncProducer_t* sp);
+
+/**
+ * Pause SYNC production, before communication reset
+ *
+ * When function returns, thread does not access CANopen object until CO_syncProducer_resume().
+ *
+ * @param sp This object.
+ */
+void CO_syncProducer_pause(CO_syncProducer_t* sp);
+
+/**
+ * Resume SYNC production, after CO_CANopenInit()
+ *
+ * Function configures SYNC object for external producer with CO_SYNC_setExternal() and restarts the schedule from the
+ * current time. SYNC is transmitted only if this node is SYNC producer (0x1005), period (0x1006) is nonzero and NMT
+ * state is pre-operational or operational.
+ *
+ * @param sp This object.
+ */
+void CO_syncProducer_resume(CO_syncProducer_t* sp);
+
+/**
+ * Get statistics
+ *
+ * @param sp This object.
+ * @param [out] stats Copy of the current statistics.
+ */
+void CO_syncProducer_getStats(CO_syncProducer_t* sp, CO_syncProducerStats_t* stats);
+
+/**
+ * Reset statistics
+ *
+ * @param sp This object.
+ */
+void CO_syncProducer_resetStats(CO_syncProducer_t* sp);
+
+/**
+ * Make statistics accessible from OD entry
+ *
+ * Entry is an ARRAY or RECORD with 7 UINT32 sub-entries: 1 - cycles, 2 - missed, 3 - send errors, 4 - minimum jitter,
+ * 5 - maximum jitter, 6 - mean jitter (signed, in nanoseconds) and 7 - maximum latency in nanoseconds. Writing 0 to
+ * sub-index 1 resets statistics.
+ *
+ * @param sp This object.
+ * @param OD_stats OD entry, for example from manufacturer specific area.
+ *
+ * @return CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_syncProducer_initOD(CO_syncProducer_t* sp, OD_entry_t* OD_stats);
+
+/** @} */ /* CO_syncProducer */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* (CO_CONFIG_SYNC) & CO_CONFIG_SYNC_PRODUCER */
+
+#endif /* CO_SYNC_PRODUCER_H */
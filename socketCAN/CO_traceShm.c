@@ -0,0 +1,187 @@
+/*
+ * Trace sink into shared memory ring for Linux.
+ *
+ * @file        CO_traceShm.c
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "CO_traceShm.h"
+
+CO_ReturnError_t
+CO_traceShm_create(CO_traceShm_t* ts, const char* name, uint32_t capacity, const CO_traceMulti_t* tr) {
+    if ((ts == NULL) || (name == NULL) || (tr == NULL) || (strlen(name) >= sizeof(ts->name)) || (capacity == 0U)
+        || ((capacity & (capacity - 1U)) != 0U)) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    (void)memset(ts, 0, sizeof(CO_traceShm_t));
+
+    uint32_t slotWords = (uint32_t)tr->recordWords + 1U;
+    size_t size = sizeof(CO_traceShm_header_t) + ((size_t)capacity * slotWords * sizeof(int32_t));
+
+    (void)shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+        (void)close(fd);
+        (void)shm_unlink(name);
+        return CO_ERROR_SYSCALL;
+    }
+    void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    (void)close(fd);
+    if (mem == MAP_FAILED) {
+        (void)shm_unlink(name);
+        return CO_ERROR_SYSCALL;
+    }
+    /* no page faults in the real-time thread, mlock may be refused without privileges */
+    (void)mlock(mem, size);
+
+    CO_traceShm_header_t* h = (CO_traceShm_header_t*)mem;
+    h->version = CO_TRACE_SHM_VERSION;
+    h->recordWords = tr->recordWords;
+    h->slotWords = slotWords;
+    h->capacity = capacity;
+    h->period_us = tr->period_us;
+    h->headerSize = (uint32_t)sizeof(CO_traceShm_header_t);
+    for (uint8_t i = 0; i < tr->channelCount; i++) {
+        h->channelMap[i] = tr->channels[i].map;
+        h->channelType[i] = tr->channels[i].type;
+    }
+    atomic_init(&h->head, 0U);
+    atomic_init(&h->sequence, 0U);
+    atomic_init(&h->dropped, 0U);
+    atomic_init(&h->tail, 0U);
+    atomic_thread_fence(memory_order_release);
+    h->magic = CO_TRACE_SHM_MAGIC;
+
+    ts->header = h;
+    ts->slots = (int32_t*)((uint8_t*)mem + sizeof(CO_traceShm_header_t));
+    ts->size = size;
+    (void)strcpy(ts->name, name);
+    ts->owner = true;
+
+    return CO_ERROR_NO;
+}
+
+CO_ReturnError_t
+CO_traceShm_attach(CO_traceShm_t* ts, const char* name) {
+    struct stat st;
+
+    if ((ts == NULL) || (name == NULL) || (strlen(name) >= sizeof(ts->name))) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    (void)memset(ts, 0, sizeof(CO_traceShm_t));
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(CO_traceShm_header_t))) {
+        (void)close(fd);
+        return CO_ERROR_SYSCALL;
+    }
+    size_t size = (size_t)st.st_size;
+    void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (mem == MAP_FAILED) {
+        return CO_ERROR_SYSCALL;
+    }
+
+    CO_traceShm_header_t* h = (CO_traceShm_header_t*)mem;
+    if ((h->magic != CO_TRACE_SHM_MAGIC) || (h->version != CO_TRACE_SHM_VERSION)
+        || (h->headerSize != sizeof(CO_traceShm_header_t))
+        || (size < (h->headerSize + ((size_t)h->capacity * h->slotWords * sizeof(int32_t))))) {
+        (void)munmap(mem, size);
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    ts->header = h;
+    ts->slots = (int32_t*)((uint8_t*)mem + h->headerSize);
+    ts->size = size;
+    (void)strcpy(ts->name, name);
+    ts->owner = false;
+
+    return CO_ERROR_NO;
+}
+
+void
+CO_traceShm_close(CO_traceShm_t* ts) {
+    if ((ts == NULL) || (ts->header == NULL)) {
+        return;
+    }
+    (void)munmap(ts->header, ts->size);
+    if (ts->owner) {
+        (void)shm_unlink(ts->name);
+    }
+    ts->header = NULL;
+    ts->slots = NULL;
+}
+
+void
+CO_traceShm_sample(void* object, const int32_t* record, uint16_t words) {
+    CO_traceShm_t* ts = (CO_traceShm_t*)object;
+
+    if ((ts == NULL) || (ts->header == NULL) || (record == NULL)) {
+        return;
+    }
+
+    CO_traceShm_header_t* h = ts->header;
+    uint_least32_t head = atomic_load_explicit(&h->head, memory_order_relaxed);
+    uint_least32_t tail = atomic_load_explicit(&h->tail, memory_order_acquire);
+    uint_least32_t sequence = atomic_load_explicit(&h->sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&h->sequence, sequence + 1U, memory_order_relaxed);
+    if ((uint32_t)(head - tail) >= h->capacity) {
+        (void)atomic_fetch_add_explicit(&h->dropped, 1U, memory_order_relaxed);
+        return;
+    }
+
+    int32_t* slot = &ts->slots[(head & (h->capacity - 1U)) * h->slotWords];
+    if (words > h->recordWords) {
+        words = h->recordWords;
+    }
+    slot[0] = (int32_t)sequence;
+    (void)memcpy(&slot[1], record, (size_t)words * sizeof(int32_t));
+    atomic_store_explicit(&h->head, head + 1U, memory_order_release);
+}
+
+bool_t
+CO_traceShm_read(CO_traceShm_t* ts, uint32_t* sequence, int32_t* record) {
+    if ((ts == NULL) || (ts->header == NULL) || (record == NULL)) {
+        return false;
+    }
+
+    CO_traceShm_header_t* h = ts->header;
+    uint_least32_t tail = atomic_load_explicit(&h->tail, memory_order_relaxed);
+    uint_least32_t head = atomic_load_explicit(&h->head, memory_order_acquire);
+
+    if (tail == head) {
+        return false;
+    }
+
+    const int32_t* slot = &ts->slots[(tail & (h->capacity - 1U)) * h->slotWords];
+    if (sequence != NULL) {
+        *sequence = (uint32_t)slot[0];
+    }
+    (void)memcpy(record, &slot[1], (size_t)h->recordWords * sizeof(int32_t));
+    atomic_store_explicit(&h->tail, tail + 1U, memory_order_release);
+
+    return true;
+}
@@ -0,0 +1,159 @@
+/*
+ * Trace sink into shared memory ring for Linux.
+ *
+ * @file        CO_traceShm.h
+ * @ingroup     CO_traceShm
+ * @author      ZeroErr Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef CO_TRACE_SHM_H
+#define CO_TRACE_SHM_H
+
+#include <stdatomic.h>
+
+#include "CO_traceMulti.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_traceShm Trace into shared memory
+ * Live samples of @ref CO_traceMulti in a single producer, single consumer ring in POSIX shared memory.
+ *
+ * @ingroup CO_socketCAN
+ * @{
+ *
+ * Frozen @ref CO_traceMulti capture is read by SDO upload, which competes with control traffic and is available only
+ * after the capture. Trace sink instead publishes every sample from the real-time thread into a ring in /dev/shm, so
+ * external plotter or recorder reads it live. CO_traceShm_sample() is the sample callback of the trace, see
+ * CO_traceMulti_initCallbackSample(): it copies the record into the next slot and advances the head index with
+ * release store. No system call and no lock is made by the producer, memory is mapped, locked and prefaulted by
+ * CO_traceShm_create().
+ *
+ * Consumer process opens the same name with CO_traceShm_attach() (or maps the file directly, layout is
+ * @ref CO_traceShm_header_t followed by the slots) and reads with CO_traceShm_read(), which advances the tail index.
+ * If ring is full, producer does not wait: the sample is dropped and counted in CO_traceShm_header_t::dropped. Each
+ * slot carries the sequence number of the sample, so consumer also detects the gap in the sequence.
+ *
+ * Trace must be initialized with the live record in CO_traceMulti_init(), so samples are published also while
+ * capture is not armed. Example consumer, which prints CSV, is example/trace_shm_dump.c.
+ *
+ * @code{.c}
+ * CO_traceMulti_init(&trace, buf, sizeof(buf) / sizeof(buf[0]), live, 1000);
+ * // ... CO_traceMulti_addChannelOD() ...
+ * CO_traceShm_create(&shm, "/canopen_trace", 4096, &trace);
+ * CO_traceMulti_initCallbackSample(&trace, &shm, CO_traceShm_sample);
+ * @endcode
+ */
+
+/** Magic number at the start of the shared memory, "COTS" */
+#define CO_TRACE_SHM_MAGIC 0x53544F43U
+
+/** Version of the shared memory layout */
+#define CO_TRACE_SHM_VERSION 1U
+
+/**
+ * Header at the start of the shared memory
+ *
+ * Header is 64-byte aligned and head, tail are in separate cache lines. Slots follow the header, each has
+ * sequence number (uint32_t) and then recordWords int32_t words of the record: timestamp in microseconds and the
+ * value of each channel.
+ */
+typedef struct {
+    uint32_t magic;                               /**< CO_TRACE_SHM_MAGIC, written last by the producer */
+    uint16_t version;                             /**< CO_TRACE_SHM_VERSION */
+    uint16_t recordWords;                         /**< Words in the record, timestamp and channels */
+    uint32_t slotWords;                           /**< Words in one slot, sequence number and record */
+    uint32_t capacity;                            /**< Number of slots, power of 2 */
+    uint32_t period_us;                           /**< Sample period or 0 for sampling on SYNC */
+    uint32_t headerSize;                          /**< Size of this header, offset of the first slot in bytes */
+    uint32_t channelMap[CO_TRACE_MULTI_CHANNELS]; /**< Mapping of each channel, as in PDO */
+    uint8_t channelType[CO_TRACE_MULTI_CHANNELS]; /**< See @ref CO_TRACE_MULTI_TYPE */
+    /** Next slot to write, modified only by the producer */
+    _Alignas(64) atomic_uint_least32_t head;
+    atomic_uint_least32_t sequence;               /**< Sequence number of the next sample, including dropped */
+    atomic_uint_least32_t dropped;                /**< Samples dropped, because ring was full */
+    /** Next slot to read, modified only by the consumer */
+    _Alignas(64) atomic_uint_least32_t tail;
+} CO_traceShm_header_t;
+
+/** Trace shared memory object */
+typedef struct {
+    CO_traceShm_header_t* header; /**< Mapped shared memory or NULL */
+    int32_t* slots;               /**< First slot, after the header */
+    size_t size;                  /**< Size of the mapped memory */
+    char name[64];                /**< Name of the shared memory object, for shm_unlink() */
+    bool_t owner;                 /**< True, if created with CO_traceShm_create() */
+} CO_traceShm_t;
+
+/**
+ * Create shared memory ring for the trace, producer side
+ *
+ * Called after channels are added to the trace. Existing shared memory with the same name is replaced.
+ *
+ * @param ts This object will be initialized.
+ * @param name Name of the shared memory object, for example "/canopen_trace", appears in /dev/shm.
+ * @param capacity Number of slots, must be power of 2.
+ * @param tr Trace object, source of the channel configuration.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_SYSCALL (shm_open, ftruncate or mmap failed).
+ */
+CO_ReturnError_t CO_traceShm_create(CO_traceShm_t* ts, const char* name, uint32_t capacity, const CO_traceMulti_t* tr);
+
+/**
+ * Attach to existing shared memory ring, consumer side
+ *
+ * @param ts This object will be initialized.
+ * @param name Name of the shared memory object.
+ *
+ * @return CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT (not a trace ring) or CO_ERROR_SYSCALL.
+ */
+CO_ReturnError_t CO_traceShm_attach(CO_traceShm_t* ts, const char* name);
+
+/**
+ * Unmap shared memory, remove it, if it was created by this object
+ *
+ * @param ts This object.
+ */
+void CO_traceShm_close(CO_traceShm_t* ts);
+
+/**
+ * Publish one sample, producer side
+ *
+ * Function signature matches the sample callback of CO_traceMulti_initCallbackSample(). Called from the real-time
+ * thread, never blocks.
+ *
+ * @param object CO_traceShm_t object.
+ * @param record Timestamp and channel values.
+ * @param words Words in the record, truncated to CO_traceShm_header_t::recordWords.
+ */
+void CO_traceShm_sample(void* object, const int32_t* record, uint16_t words);
+
+/**
+ * Read next sample, consumer side
+ *
+ * @param ts This object.
+ * @param [out] sequence Sequence number of the sample. Gap to the previous sample is the number of dropped samples.
+ * @param [out] record Buffer for CO_traceShm_header_t::recordWords words.
+ *
+ * @return True, if sample was read, false if ring is empty.
+ */
+bool_t CO_traceShm_read(CO_traceShm_t* ts, uint32_t* sequence, int32_t* record);
+
+/** @} */ /* CO_traceShm */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CO_TRACE_SHM_H */
@@ -152,11 +152,17 @@ CO_storage_init(CO_storage_t* storage, CO_CANmodule_t* CANmodule, OD_entry_t* OD
     storage->OD_1010_extension.object = storage;
     storage->OD_1010_extension.read = OD_readOriginal;
     storage->OD_1010_extension.write = OD_write_1010;
+#if OD_IO_VIEW > 0
+    storage->OD_1010_extension.view = NULL;
+#endif
     (void)OD_extension_init(OD_1010_StoreParameters, &storage->OD_1010_extension);
 
     storage->OD_1011_extension.object = storage;
     storage->OD_1011_extension.read = OD_readOriginal;
     storage->OD_1011_extension.write = OD_write_1011;
+#if OD_IO_VIEW > 0
+    storage->OD_1011_extension.view = NULL;
+#endif
     (void)OD_extension_init(OD_1011_RestoreDefaultParameters, &storage->OD_1011_extension);
 
     return CO_ERROR_NO;
@@ -17,12 +17,99 @@
  * See the License for the specific language governing permissions and limitations under the License.
  */
 
+#include <string.h>
+
 #include "storage/CO_storageEeprom.h"
 #include "storage/CO_eeprom.h"
 #include "301/crc16-ccitt.h"
 
 #if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_ENABLE) != 0
 
+#if ((CO_CONFIG_STORAGE) & (CO_CONFIG_STORAGE_EEPROM_PAGES | CO_CONFIG_STORAGE_EEPROM_ASYNC)) != 0
+/* Write and verify block of data (entry data or its snapshot), then update the shadow */
+static bool_t
+storeEepromRun(CO_storage_entry_t* entry, uint8_t* data, size_t offset, size_t len) {
+    bool_t writeOk = CO_eeprom_writeBlock(entry->storageModule, &data[offset], entry->eepromAddr + offset, len);
+    uint16_t crc = crc16_ccitt(&data[offset], len, 0);
+    uint16_t crc_read = CO_eeprom_getCrcBlock(entry->storageModule, entry->eepromAddr + offset, len);
+    if ((crc != crc_read) || !writeOk) {
+        return false;
+    }
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_PAGES) != 0
+    if (entry->addrShadow != NULL) {
+        (void)memcpy(&((uint8_t*)entry->addrShadow)[offset], &data[offset], len);
+    }
+#endif
+    return true;
+}
+#endif
+
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_PAGES) != 0
+/* Write pages, which differ from the shadow, and calculate CRC of the entry on the way */
+static bool_t
+storeEepromPages(CO_storage_entry_t* entry) {
+    uint8_t* data = (uint8_t*)entry->addr;
+    const uint8_t* shadow = (const uint8_t*)entry->addrShadow;
+    size_t runOffset = 0;
+    size_t runLen = 0;
+    uint16_t crc = 0;
+
+    for (size_t offset = 0; offset < entry->len; offset += CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE) {
+        size_t len = entry->len - offset;
+        if (len > CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE) {
+            len = CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE;
+        }
+        crc = crc16_ccitt(&data[offset], len, crc);
+
+        if (memcmp(&data[offset], &shadow[offset], len) != 0) {
+            /* changed page, join with previous changed pages */
+            if (runLen == 0U) {
+                runOffset = offset;
+            }
+            runLen += len;
+        } else if (runLen > 0U) {
+            if (!storeEepromRun(entry, data, runOffset, runLen)) {
+                return false;
+            }
+            runLen = 0;
+        } else { /* MISRA C 2004 14.10 */
+        }
+    }
+    if ((runLen > 0U) && !storeEepromRun(entry, data, runOffset, runLen)) {
+        return false;
+    }
+
+    entry->crc = crc;
+    return true;
+}
+#endif
+
+/* Write and verify signature of the entry (see CO_storageEeprom_init() for info). If onlyChanged, signature is first
+ * read and written only, if it differs. */
+static bool_t
+storeEepromSignature(CO_storage_entry_t* entry, bool_t onlyChanged) {
+    uint16_t signatureOfEntry = (uint16_t)entry->len;
+    uint32_t signature = (((uint32_t)entry->crc) << 16) | signatureOfEntry;
+    uint32_t signatureRead;
+    bool_t writeOk;
+
+    if (onlyChanged) {
+        CO_eeprom_readBlock(entry->storageModule, (uint8_t*)&signatureRead, entry->eepromAddrSignature,
+                            sizeof(signatureRead));
+        if (signature == signatureRead) {
+            return true;
+        }
+    }
+
+    writeOk = CO_eeprom_writeBlock(entry->storageModule, (uint8_t*)&signature, entry->eepromAddrSignature,
+                                   sizeof(signature));
+
+    /* verify signature and write */
+    CO_eeprom_readBlock(entry->storageModule, (uint8_t*)&signatureRead, entry->eepromAddrSignature,
+                        sizeof(signatureRead));
+    return (signature == signatureRead) && writeOk;
+}
+
 /*
  * Function for writing data on "Store parameters" command - OD object 1010
  *
@@ -31,10 +118,31 @@
 static ODR_t
 storeEeprom(CO_storage_entry_t* entry, CO_CANmodule_t* CANmodule) {
     (void)CANmodule;
-    bool_t writeOk;
+
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_ASYNC) != 0
+    if (entry->addrSnapshot != NULL) {
+        /* Called from SDO server with CO_LOCK_OD, so snapshot is consistent. Previous pending store is restarted,
+         * pages already written are skipped, if entry has shadow. */
+        (void)memcpy(entry->addrSnapshot, entry->addr, entry->len);
+        entry->storeOffset = 0;
+        entry->storePending = true;
+        return ODR_OK;
+    }
+#endif
+
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_PAGES) != 0
+    if ((entry->addrShadow != NULL) && ((entry->attr & (uint8_t)CO_storage_auto) == 0U)) {
+        if (!storeEepromPages(entry)) {
+            return ODR_HW;
+        }
+
+        /* Write signature only if it changed, for example after restore or after change of data */
+        return storeEepromSignature(entry, true) ? ODR_OK : ODR_HW;
+    }
+#endif
 
     /* save data to the eeprom */
-    writeOk = CO_eeprom_writeBlock(entry->storageModule, entry->addr, entry->eepromAddr, entry->len);
+    bool_t writeOk = CO_eeprom_writeBlock(entry->storageModule, entry->addr, entry->eepromAddr, entry->len);
     entry->crc = crc16_ccitt(entry->addr, entry->len, 0);
 
     /* Verify, if data in eeprom are equal */
@@ -43,21 +151,7 @@ storeEeprom(CO_storage_entry_t* entry, CO_CANmodule_t* CANmodule) {
         return ODR_HW;
     }
 
-    /* Write signature (see CO_storageEeprom_init() for info) */
-    uint16_t signatureOfEntry = (uint16_t)entry->len;
-    uint32_t signature = (((uint32_t)entry->crc) << 16) | signatureOfEntry;
-    writeOk = CO_eeprom_writeBlock(entry->storageModule, (uint8_t*)&signature, entry->eepromAddrSignature,
-                                   sizeof(signature));
-
-    /* verify signature and write */
-    uint32_t signatureRead;
-    CO_eeprom_readBlock(entry->storageModule, (uint8_t*)&signatureRead, entry->eepromAddrSignature,
-                        sizeof(signatureRead));
-    if ((signature != signatureRead) || !writeOk) {
-        return ODR_HW;
-    }
-
-    return ODR_OK;
+    return storeEepromSignature(entry, false) ? ODR_OK : ODR_HW;
 }
 
 /*
@@ -70,6 +164,11 @@ restoreEeprom(CO_storage_entry_t* entry, CO_CANmodule_t* CANmodule) {
     (void)CANmodule;
     bool_t writeOk;
 
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_ASYNC) != 0
+    /* pending store would write valid signature again */
+    entry->storePending = false;
+#endif
+
     /* Write empty signature */
     uint32_t signature = 0xFFFFFFFFU;
     writeOk = CO_eeprom_writeBlock(entry->storageModule, (uint8_t*)&signature, entry->eepromAddrSignature,
@@ -131,6 +230,11 @@ CO_storageEeprom_init(CO_storage_t* storage, CO_CANmodule_t* CANmodule, void* st
             return CO_ERROR_ILLEGAL_ARGUMENT;
         }
 
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_ASYNC) != 0
+        entry->storeOffset = 0;
+        entry->storePending = false;
+#endif
+
         /* calculate addresses inside eeprom */
         entry->eepromAddrSignature = signaturesAddress + (sizeof(uint32_t) * i);
         entry->eepromAddr = CO_eeprom_getAddr(storageModule, isAuto, entry->len, &eepromOvf);
@@ -167,6 +271,20 @@ CO_storageEeprom_init(CO_storage_t* storage, CO_CANmodule_t* CANmodule, void* st
             }
         }
 
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_PAGES) != 0
+        /* Shadow mirrors eeprom content. If it is unknown, make all bytes differ, so first store writes all pages. */
+        if ((entry->addrShadow != NULL) && !isAuto) {
+            uint8_t* shadow = (uint8_t*)entry->addrShadow;
+            if (dataCorrupt) {
+                for (size_t j = 0; j < entry->len; j++) {
+                    shadow[j] = (uint8_t)~((uint8_t*)entry->addr)[j];
+                }
+            } else {
+                (void)memcpy(shadow, entry->addr, entry->len);
+            }
+        }
+#endif
+
         /* additional info in case of error */
         if (dataCorrupt) {
             uint32_t errorBit = entry->subIndexOD;
@@ -219,4 +337,70 @@ CO_storageEeprom_auto_process(CO_storage_t* storage, bool_t saveAll) {
     }
 }
 
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_ASYNC) != 0
+ODR_t
+CO_storageEeprom_async_process(CO_storage_t* storage) {
+    bool_t pending = false;
+    bool_t stepDone = false;
+    ODR_t ret = ODR_OK;
+
+    /* verify arguments */
+    if ((storage == NULL) || !storage->enabled) {
+        return ODR_OK;
+    }
+
+    for (uint8_t n = 0; n < storage->entriesCount; n++) {
+        CO_storage_entry_t* entry = &storage->entries[n];
+
+        if (!entry->storePending) {
+            continue;
+        }
+        if (stepDone) {
+            pending = true;
+            break;
+        }
+        stepDone = true;
+
+        uint8_t* snapshot = (uint8_t*)entry->addrSnapshot;
+        size_t offset = entry->storeOffset;
+        size_t len = 0;
+        while (offset < entry->len) {
+            len = entry->len - offset;
+            if (len > CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE) {
+                len = CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE;
+            }
+#if ((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_PAGES) != 0
+            /* unchanged pages need no eeprom access */
+            if ((entry->addrShadow != NULL) && ((entry->attr & (uint8_t)CO_storage_auto) == 0U)
+                && (memcmp(&snapshot[offset], &((uint8_t*)entry->addrShadow)[offset], len) == 0)) {
+                offset += len;
+                continue;
+            }
+#endif
+            break;
+        }
+
+        if (offset < entry->len) {
+            /* one page per call */
+            entry->storeOffset = offset + len;
+            if (!storeEepromRun(entry, snapshot, offset, len)) {
+                entry->storePending = false;
+                ret = ODR_HW;
+            } else {
+                pending = true;
+            }
+        } else {
+            /* all data written, CRC is from the snapshot, which is now in eeprom */
+            entry->crc = crc16_ccitt(snapshot, entry->len, 0);
+            entry->storePending = false;
+            if (!storeEepromSignature(entry, true)) {
+                ret = ODR_HW;
+            }
+        }
+    }
+
+    return ((ret == ODR_OK) && pending) ? ODR_PARTIAL : ret;
+}
+#endif
+
 #endif /* (CO_CONFIG_STORAGE) & CO_CONFIG_STORAGE_ENABLE */
@@ -27,6 +27,10 @@
 #define CO_CONFIG_STORAGE_MAX_ENTRIES_COUNT 5U
 #endif
 
+#ifndef CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE
+#define CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE 64U
+#endif
+
 #if (((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_ENABLE) != 0) || defined CO_DOXYGEN
 
 #ifdef __cplusplus
@@ -60,6 +64,21 @@ extern "C" {
  * If entry attribute has CO_storage_auto set, then data block is stored autonomously, byte by byte, on change, during
  * program run. Those data blocks are stored into write unprotected location. For auto storage to work, its signature in
  * eeprom must be correct. CRC checksum for the data is not used.
+ *
+ * With @ref CO_CONFIG_STORAGE_EEPROM_PAGES and addrShadow set in the entry, store writes only pages of
+ * @ref CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE bytes, which differ from the shadow copy of the eeprom content. Consecutive
+ * changed pages are written and verified as one block, and signature is written only, if it changed. CRC of the
+ * entry is calculated from RAM while pages are compared, so eeprom is read back only for the written pages. Store
+ * time and wear then depend on the size of the change, not on the size of the entry. Shadow costs len bytes of RAM,
+ * it is filled by CO_storageEeprom_init(). Shadow is not used for entries with CO_storage_auto.
+ *
+ * Store of a large entry into slow eeprom may take longer than SYNC period or heartbeat time, while SDO server waits
+ * in CO_process(). With @ref CO_CONFIG_STORAGE_EEPROM_ASYNC and addrSnapshot set in the entry, store command only
+ * copies the data into the snapshot and SDO write is confirmed immediately. Application then calls
+ * CO_storageEeprom_async_process() cyclically, which writes and verifies one page per call and finally the
+ * signature. Restore command cancels pending store of the entry. Data, changed after the store command, are not
+ * stored. After power loss before the end of the store, data in eeprom do not match the signature, so entry is
+ * indicated as corrupt on the next startup, same as with interrupted synchronous store.
  */
 
 /**
@@ -98,6 +117,22 @@ CO_ReturnError_t CO_storageEeprom_init(CO_storage_t* storage, CO_CANmodule_t* CA
  */
 void CO_storageEeprom_auto_process(CO_storage_t* storage, bool_t saveAll);
 
+#if (((CO_CONFIG_STORAGE)&CO_CONFIG_STORAGE_EEPROM_ASYNC) != 0) || defined CO_DOXYGEN
+/**
+ * Write pending snapshots into eeprom.
+ *
+ * Should be called cyclically by program, from the same thread as CO_process(), until it returns ODR_OK. Each call
+ * writes and verifies one page of @ref CO_CONFIG_STORAGE_EEPROM_PAGE_SIZE bytes or the signature. With
+ * CO_CONFIG_STORAGE_EEPROM_PAGES unchanged pages are skipped.
+ *
+ * @param storage This object
+ *
+ * @return ODR_PARTIAL, if store is still pending, ODR_OK, if nothing is pending, or ODR_HW, if write or verification
+ * failed. In case of error the store of that entry is abandoned, application may report emergency.
+ */
+ODR_t CO_storageEeprom_async_process(CO_storage_t* storage);
+#endif
+
 /** @} */ /* CO_storage_eeprom */
 
 #ifdef __cplusplus